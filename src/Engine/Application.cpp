@@ -1,5 +1,12 @@
 #include <Engine/Application.hpp>
+#include <Engine/DebugMessageFilter.hpp>
+#include <Engine/DebugOverlay.hpp>
 #include <Engine/Device.hpp>
+#include <Engine/DynamicResolution.hpp>
+#include <Engine/GpuTimer.hpp>
+#include <Engine/RenderGraph.hpp>
+#include <Engine/RenderStatistics.hpp>
+#include <Engine/ResourceLoader.hpp>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -7,8 +14,91 @@
 
 #include <debugbreak.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <format>
 
+namespace
+{
+    constexpr size_t FrameArenaCapacity = 1024 * 1024;
+
+    std::string_view GetDebugSourceName(GLenum source)
+    {
+        switch (source)
+        {
+            case GL_DEBUG_SOURCE_API: return "API";
+            case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "Window Manager";
+            case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler";
+            case GL_DEBUG_SOURCE_THIRD_PARTY: return "Third Party";
+            case GL_DEBUG_SOURCE_APPLICATION: return "Application";
+            case GL_DEBUG_SOURCE_OTHER: return "Other";
+            default: return "Unknown";
+        }
+    }
+
+    std::string_view GetDebugTypeName(GLenum type)
+    {
+        switch (type)
+        {
+            case GL_DEBUG_TYPE_ERROR: return "Error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated Behaviour";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "Undefined Behaviour";
+            case GL_DEBUG_TYPE_PORTABILITY: return "Portability";
+            case GL_DEBUG_TYPE_PERFORMANCE: return "Performance";
+            case GL_DEBUG_TYPE_MARKER: return "Marker";
+            case GL_DEBUG_TYPE_PUSH_GROUP: return "Push Group";
+            case GL_DEBUG_TYPE_POP_GROUP: return "Pop Group";
+            case GL_DEBUG_TYPE_OTHER: return "Other";
+            default: return "Unknown";
+        }
+    }
+
+    std::string_view GetDebugSeverityName(GLenum severity)
+    {
+        switch (severity)
+        {
+            case GL_DEBUG_SEVERITY_HIGH: return "high";
+            case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+            case GL_DEBUG_SEVERITY_LOW: return "low";
+            case GL_DEBUG_SEVERITY_NOTIFICATION: return "notification";
+            default: return "unknown";
+        }
+    }
+
+    spdlog::level::level_enum GetDebugLogLevel(GLenum type, GLenum severity)
+    {
+        if (type == GL_DEBUG_TYPE_ERROR)
+        {
+            return spdlog::level::err;
+        }
+
+        switch (severity)
+        {
+            case GL_DEBUG_SEVERITY_HIGH: return spdlog::level::err;
+            case GL_DEBUG_SEVERITY_MEDIUM: return spdlog::level::warn;
+            case GL_DEBUG_SEVERITY_LOW: return spdlog::level::info;
+            default: return spdlog::level::debug;
+        }
+    }
+}
+
+std::optional<DiagnosticsLevel> ParseDiagnosticsLevel(std::string_view name) noexcept
+{
+    if (name == "production")
+    {
+        return DiagnosticsLevel::Production;
+    }
+    if (name == "development")
+    {
+        return DiagnosticsLevel::Development;
+    }
+    if (name == "validation")
+    {
+        return DiagnosticsLevel::Validation;
+    }
+    return std::nullopt;
+}
 
 class ApplicationAccess final
 {
@@ -78,59 +168,62 @@ public:
         )
         return;
 
-        std::stringstream debugMessageStream;
-        debugMessageStream << message << '\n';
-
-        switch (source)
+        if (userParam == nullptr)
         {
-            case GL_DEBUG_SOURCE_API: debugMessageStream << "Source: API"; break;
-            case GL_DEBUG_SOURCE_WINDOW_SYSTEM: debugMessageStream << "Source: Window Manager"; break;
-            case GL_DEBUG_SOURCE_SHADER_COMPILER: debugMessageStream << "Source: Shader Compiler"; break;
-            case GL_DEBUG_SOURCE_THIRD_PARTY: debugMessageStream << "Source: Third Party"; break;
-            case GL_DEBUG_SOURCE_APPLICATION: debugMessageStream << "Source: Application"; break;
-            case GL_DEBUG_SOURCE_OTHER: debugMessageStream << "Source: Other"; break;
-        }
-
-        debugMessageStream << '\n';
-
-        switch (type)
-        {
-            case GL_DEBUG_TYPE_ERROR: debugMessageStream << "Type: Error"; break;
-            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: debugMessageStream << "Type: Deprecated Behaviour"; break;
-            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: debugMessageStream << "Type: Undefined Behaviour"; break;
-            case GL_DEBUG_TYPE_PORTABILITY: debugMessageStream << "Type: Portability"; break;
-            case GL_DEBUG_TYPE_PERFORMANCE: debugMessageStream << "Type: Performance"; break;
-            case GL_DEBUG_TYPE_MARKER: debugMessageStream << "Type: Marker"; break;
-            case GL_DEBUG_TYPE_PUSH_GROUP: debugMessageStream << "Type: Push Group"; break;
-            case GL_DEBUG_TYPE_POP_GROUP: debugMessageStream << "Type: Pop Group"; break;
-            case GL_DEBUG_TYPE_OTHER: debugMessageStream << "Type: Other"; break;
+            return;
         }
 
-        debugMessageStream << '\n';
-
-        switch (severity)
+        auto windowHandle = (GLFWwindow*)userParam;
+        auto application = static_cast<Application*>(glfwGetWindowUserPointer(windowHandle));
+        if (application == nullptr)
         {
-            case GL_DEBUG_SEVERITY_HIGH: debugMessageStream << "Severity: high"; break;
-            case GL_DEBUG_SEVERITY_MEDIUM: debugMessageStream << "Severity: medium"; break;
-            case GL_DEBUG_SEVERITY_LOW: debugMessageStream << "Severity: low"; break;
-            case GL_DEBUG_SEVERITY_NOTIFICATION: debugMessageStream << "Severity: notification"; break;
+            spdlog::error("App: You forgot to call glfwSetWindowUserPointer in Application::Initialize");
+            return;
         }
 
-        if (userParam != nullptr)
+        // Rejected before formatting, a driver repeating one warning every draw should cost next to nothing
+        uint32_t occurrence = 1;
+        if (application->_debugMessageFilter != nullptr)
         {
-            auto windowHandle = (GLFWwindow*)userParam;
-            auto application = static_cast<Application*>(glfwGetWindowUserPointer(windowHandle));
-            if (application == nullptr)
+            occurrence = application->_debugMessageFilter->Accept(source, type, id);
+            if (occurrence == 0)
             {
-                spdlog::error("App: You forgot to call glfwSetWindowUserPointer in Application::Initialize");
                 return;
             }
-
-            application->OnOpenGLDebugMessage(type, debugMessageStream.str());
         }
+
+        // Formatted on the stack, drivers can send these at a rate where heap allocations show
+        std::array<char, 4096> debugMessageBuffer;
+        auto formatResult = occurrence > 1
+            ? std::format_to_n(
+                debugMessageBuffer.begin(),
+                debugMessageBuffer.size(),
+                "{}\nSource: {}\nType: {}\nSeverity: {}\nSeen {} times",
+                message,
+                GetDebugSourceName(source),
+                GetDebugTypeName(type),
+                GetDebugSeverityName(severity),
+                occurrence)
+            : std::format_to_n(
+                debugMessageBuffer.begin(),
+                debugMessageBuffer.size(),
+                "{}\nSource: {}\nType: {}\nSeverity: {}",
+                message,
+                GetDebugSourceName(source),
+                GetDebugTypeName(type),
+                GetDebugSeverityName(severity));
+        auto debugMessage = std::string_view(debugMessageBuffer.data(), std::min(static_cast<size_t>(formatResult.size), debugMessageBuffer.size()));
+
+        application->OnOpenGLDebugMessage(type, severity, debugMessage);
     }
 };
 
+Application::Application(const ApplicationSettings& settings)
+    : _settings(settings),
+      _frameArena(FrameArenaCapacity)
+{
+}
+
 Application::~Application()
 {
 
@@ -152,15 +245,60 @@ void Application::Run()
 
     spdlog::info("App: Loaded");
 
+    auto previousFrameStartTime = std::chrono::steady_clock::now();
     while (!glfwWindowShouldClose(_windowHandle))
     {
+        auto heapAllocationCount = GetHeapAllocationCount();
+        auto frameStartTime = std::chrono::steady_clock::now();
+        _frameDeltaSeconds = std::chrono::duration<float>(frameStartTime - previousFrameStartTime).count();
+        previousFrameStartTime = frameStartTime;
+        GetRenderStatistics() = {};
+
         glfwPollEvents();
 
+        _resourceLoader->Publish();
+        if (_dynamicResolution->Update(_frameGpuTimer->GetMilliseconds()))
+        {
+            spdlog::info("App: Render scale {:.0f}% at {:.2f} ms GPU for a {:.2f} ms budget",
+                _dynamicResolution->GetScale() * 100.0f,
+                _dynamicResolution->GetMilliseconds(),
+                _dynamicResolution->GetBudgetMilliseconds());
+        }
+        _renderGraph->SetRenderScale(_dynamicResolution->GetScale());
+        _isFrameGpuTimed = true;
         Update();
 
-        Render();
+        {
+            MemoryTagScope memoryTagScope(MemoryTag::Rendering);
+            if (_isFrameGpuTimed)
+            {
+                _frameGpuTimer->Begin();
+                Render();
+                _frameGpuTimer->End();
+            }
+            else
+            {
+                Render();
+            }
+        }
+
+        // Recorded before the overlay draws, so it shows the frame without itself
+        _debugOverlay->RecordFrame(DebugOverlayFrame
+        {
+            .CpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count(),
+            .GpuMilliseconds = _frameGpuTimer->GetMilliseconds(),
+            .Render = GetRenderStatistics(),
+            .RenderScale = _dynamicResolution->GetScale(),
+            .BudgetMilliseconds = _dynamicResolution->GetBudgetMilliseconds(),
+            .HeapAllocationCount = _frameHeapAllocationCount,
+            .FrameArenaPeakByteCount = _frameArena.GetPeakByteCount()
+        });
+        _debugOverlay->Render();
 
         glfwSwapBuffers(_windowHandle);
+
+        _frameArena.Reset();
+        _frameHeapAllocationCount = GetHeapAllocationCount() - heapAllocationCount;
     }
 
     spdlog::info("App: Unloading");
@@ -182,6 +320,7 @@ bool Application::Initialize()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, _settings.Diagnostics != DiagnosticsLevel::Production ? GLFW_TRUE : GLFW_FALSE);
 
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
     glfwWindowHint(GLFW_DECORATED, GLFW_TRUE);
@@ -223,11 +362,26 @@ bool Application::Initialize()
     glfwMakeContextCurrent(_windowHandle);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
-    glDebugMessageCallback(ApplicationAccess::DebugMessageCallback, _windowHandle);
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    InitializeDebugOutput();
+
+    // The resize callback only fires on changes, so the first size is queried here
+    glfwGetFramebufferSize(_windowHandle, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
 
     _device = std::make_unique<Device>();
+    _frameGpuTimer = std::make_unique<GpuTimer>();
+    _debugOverlay = std::make_unique<DebugOverlay>(_windowHandle);
+    _resourceLoader = std::make_unique<ResourceLoader>(_windowHandle, ResourceLoaderSettings
+    {
+        .UseSharedContext = _settings.UseResourceLoaderContext
+    });
+    _renderGraph = std::make_unique<RenderGraph>();
+    _renderGraph->SetFramebufferSize(framebufferWidth, framebufferHeight);
+    _dynamicResolution = std::make_unique<DynamicResolution>(DynamicResolutionSettings
+    {
+        .BudgetMilliseconds = _settings.FrameBudgetMilliseconds
+    });
+    _dynamicResolution->SetEnabled(_settings.UseDynamicResolution);
 
     return true;
 }
@@ -239,6 +393,23 @@ bool Application::Load()
 
 void Application::Unload()
 {
+    _renderGraph.reset();
+    _resourceLoader.reset();
+    _debugOverlay.reset();
+    _frameGpuTimer.reset();
+
+    if (_settings.Diagnostics != DiagnosticsLevel::Production)
+    {
+        // Asynchronous messages must stop arriving before the window and the filter go away
+        glDisable(GL_DEBUG_OUTPUT);
+        glDebugMessageCallback(nullptr, nullptr);
+    }
+
+    if (_debugMessageFilter != nullptr && _debugMessageFilter->GetSuppressedCount() > 0)
+    {
+        spdlog::info("App: {} repeated OpenGL debug messages were not logged", _debugMessageFilter->GetSuppressedCount());
+    }
+
     if (_windowHandle != nullptr)
     {
         glfwDestroyWindow(_windowHandle);
@@ -261,6 +432,7 @@ void Application::OnFramebufferResized()
     spdlog::info("Framebuffer resized to {}_{}", framebufferWidth, framebufferHeight);
 
     glViewport(0, 0, framebufferWidth, framebufferHeight);
+    _renderGraph->SetFramebufferSize(framebufferWidth, framebufferHeight);
 }
 
 void Application::OnKeyDown(
@@ -277,6 +449,11 @@ void Application::OnKeyDown(
     {
         ToggleFullscreen();
     }
+
+    if (key == GLFW_KEY_F3 && _debugOverlay != nullptr)
+    {
+        _debugOverlay->ToggleVisible();
+    }
 }
 
 void Application::OnKeyUp(
@@ -286,15 +463,42 @@ void Application::OnKeyUp(
 {
 }
 
-void Application::OnOpenGLDebugMessage(uint32_t messageType, std::string_view debugMessage)
+void Application::OnOpenGLDebugMessage(uint32_t messageType, uint32_t severity, std::string_view debugMessage)
 {
-    spdlog::error(debugMessage);
-    if (messageType == GL_DEBUG_TYPE_ERROR)
+    spdlog::log(GetDebugLogLevel(messageType, severity), debugMessage);
+
+    // Only synchronous output breaks on the call that caused it
+    if (messageType == GL_DEBUG_TYPE_ERROR && _settings.Diagnostics == DiagnosticsLevel::Validation)
     {
         debug_break();
     }
 }
 
+void Application::InitializeDebugOutput()
+{
+    switch (_settings.Diagnostics)
+    {
+        case DiagnosticsLevel::Production:
+            spdlog::info("App: Diagnostics level production, OpenGL debug output is off");
+            return;
+        case DiagnosticsLevel::Development:
+            spdlog::info("App: Diagnostics level development, OpenGL debug output is asynchronous");
+            _debugMessageFilter = std::make_unique<DebugMessageFilter>();
+            glEnable(GL_DEBUG_OUTPUT);
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            // Notifications are dropped in the driver, they would only be filtered out later anyway
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+            break;
+        case DiagnosticsLevel::Validation:
+            spdlog::info("App: Diagnostics level validation, OpenGL debug output is synchronous");
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            break;
+    }
+
+    glDebugMessageCallback(ApplicationAccess::DebugMessageCallback, _windowHandle);
+}
+
 void Application::ToggleFullscreen()
 {
     _isFullscreen = !_isFullscreen;
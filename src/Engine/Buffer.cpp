@@ -1,4 +1,5 @@
 #include <Engine/Buffer.hpp>
+#include <Engine/GpuMemory.hpp>
 
 #include <glad/glad.h>
 
@@ -9,17 +10,23 @@ Buffer Buffer::Create(
     uint32_t size,
     uint32_t type,
     uint32_t storage,
-    bool isMapped) noexcept
+    bool isMapped,
+    const void* data) noexcept
 {
     auto buffer = Buffer();
     glCreateBuffers(1, &buffer._id);
-    glNamedBufferStorage(buffer._id, size, nullptr, storage);
+    glNamedBufferStorage(buffer._id, size, data, storage);
 
     glObjectLabel(GL_BUFFER, buffer._id, label.size(), label.data());
+    GpuMemory::Track(GpuResourceType::Buffer, buffer._id, size, storage, label);
 
     if (isMapped)
     {
-        buffer._mappedMemory = glMapNamedBuffer(buffer._id, GL_READ_WRITE);
+        // Map with the access bits the storage was created with, so persistent storage stays mapped while drawing
+        auto mapAccess = storage & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        assert((mapAccess & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT)) != 0 && "Buffer: mapped buffers need storage with GL_MAP_READ_BIT or GL_MAP_WRITE_BIT");
+        buffer._mappedMemory = glMapNamedBufferRange(buffer._id, 0, size, mapAccess);
+        assert(buffer._mappedMemory != nullptr && "Buffer: mapping failed");
     }
 
     buffer._type = type;
@@ -35,6 +42,7 @@ Buffer::~Buffer()
     }
     if (_id)
     {
+        GpuMemory::Untrack(GpuResourceType::Buffer, _id);
         glDeleteBuffers(1, &_id);
     }
 }
@@ -66,4 +74,14 @@ void Buffer::Write(const void* data, uint64_t size, uint64_t offset) const noexc
         return;
     }
     glNamedBufferSubData(_id, offset, size, data);
+}
+
+void Buffer::CopyTo(const Buffer& destination, uint64_t size, uint64_t sourceOffset, uint64_t destinationOffset) const noexcept
+{
+    assert(sourceOffset + size <= _size && destinationOffset + size <= destination._size && "overflow");
+    if (size == 0)
+    {
+        return;
+    }
+    glCopyNamedBufferSubData(_id, destination._id, sourceOffset, destinationOffset, size);
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include <Engine/ClusteredLighting.hpp>
+#include <Engine/ComputePipeline.hpp>
+#include <Engine/ComputePipelineBuilder.hpp>
+#include <Engine/Device.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <glad/glad.h>
+
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+
+namespace
+{
+    // Only the binning shader reads the froxel bounds
+    constexpr uint32_t BinningBufferBinding = 7;
+    // The index allocator sits in front of the bounds, padded to their alignment
+    constexpr uint32_t ClusterBoundsOffset = 16;
+
+    bool IsSphereInBox(const glm::vec4& sphere, const glm::vec4& boxMin, const glm::vec4& boxMax) noexcept
+    {
+        auto center = glm::vec3(sphere);
+        auto closest = glm::clamp(center, glm::vec3(boxMin), glm::vec3(boxMax));
+        auto offset = center - closest;
+        return glm::dot(offset, offset) <= sphere.w * sphere.w;
+    }
+}
+
+std::expected<ClusteredLighting, std::string> ClusteredLighting::Create(
+    Device& device,
+    std::string_view binningShaderFilePath,
+    const ClusteredLightingSettings& settings,
+    TaskScheduler* taskScheduler)
+{
+    auto lighting = ClusteredLighting();
+    if (settings.UseGpuBinning)
+    {
+        auto binningPipelineResult = device.CreateComputePipelineBuilder("LightBinning")
+            .WithShader(binningShaderFilePath)
+            .Build();
+        if (!binningPipelineResult)
+        {
+            return std::unexpected(std::format("Unable to create clustered lighting. Details: {}", binningPipelineResult.error()));
+        }
+        lighting._binningPipeline = std::move(binningPipelineResult.value());
+    }
+
+    lighting._taskScheduler = taskScheduler;
+    lighting._settings = settings;
+    lighting._uniformBuffer = Buffer::Create("Buffer_Uniforms_Clusters", sizeof(ClusterUniforms), GL_UNIFORM_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    lighting._lightBuffer = Buffer::Create("Buffer_Lights", sizeof(PointLight) * settings.MaxLightCount, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    lighting._clusterBuffer = Buffer::Create("Buffer_Clusters", sizeof(glm::uvec2) * ClusterCount, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    lighting._lightIndexBuffer = Buffer::Create("Buffer_ClusterLightIndices", sizeof(uint32_t) * settings.MaxLightIndexCount, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    lighting._binningBuffer = Buffer::Create(
+        "Buffer_ClusterBinning",
+        ClusterBoundsOffset + sizeof(ClusterBounds) * ClusterCount,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_DYNAMIC_STORAGE_BIT);
+
+    lighting._uniforms.GridSize = glm::uvec4(ClusterCountX, ClusterCountY, ClusterCountZ, 0);
+    lighting._uniforms.Capacities = glm::uvec4(settings.MaxLightIndexCount, MaxClusterLightCount, 0, 0);
+    lighting._clusterBounds.resize(ClusterCount);
+    if (!settings.UseGpuBinning)
+    {
+        lighting._clusterLightLists.resize(ClusterCount);
+        lighting._clusterRanges.resize(ClusterCount);
+    }
+    return lighting;
+}
+
+ClusteredLighting::ClusteredLighting() noexcept = default;
+ClusteredLighting::~ClusteredLighting() = default;
+ClusteredLighting::ClusteredLighting(ClusteredLighting&& other) noexcept = default;
+ClusteredLighting& ClusteredLighting::operator =(ClusteredLighting&& other) noexcept = default;
+
+void ClusteredLighting::SetView(
+    const glm::mat4& view,
+    const glm::mat4& projection,
+    float nearPlane,
+    float farPlane,
+    uint32_t viewportWidth,
+    uint32_t viewportHeight)
+{
+    _uniforms.View = view;
+
+    auto tileSize = glm::vec4(
+        static_cast<float>((viewportWidth + ClusterCountX - 1) / ClusterCountX),
+        static_cast<float>((viewportHeight + ClusterCountY - 1) / ClusterCountY),
+        static_cast<float>(viewportWidth),
+        static_cast<float>(viewportHeight));
+    if (projection == _projection && tileSize == _uniforms.TileSize)
+    {
+        return;
+    }
+
+    _projection = projection;
+    _uniforms.TileSize = tileSize;
+    auto logDepthRange = std::log(farPlane / nearPlane);
+    _uniforms.DepthSlicing = glm::vec4(
+        static_cast<float>(ClusterCountZ) / logDepthRange,
+        -static_cast<float>(ClusterCountZ) * std::log(nearPlane) / logDepthRange,
+        nearPlane,
+        farPlane);
+
+    ComputeClusterBounds(projection, nearPlane, farPlane);
+    _binningBuffer.Write(_clusterBounds.data(), sizeof(ClusterBounds) * _clusterBounds.size(), ClusterBoundsOffset);
+}
+
+void ClusteredLighting::Update(std::span<const PointLight> lights)
+{
+    auto lightCount = std::min<uint32_t>(static_cast<uint32_t>(lights.size()), _settings.MaxLightCount);
+    _lightBuffer.Write(lights.data(), sizeof(PointLight) * lightCount, 0);
+    _uniforms.GridSize.w = lightCount;
+    _uniformBuffer.Write(&_uniforms, sizeof(ClusterUniforms), 0);
+    _statistics = { .LightCount = lightCount, .LightIndexCount = 0, .MaxClusterLightCount = 0 };
+
+    if (_binningPipeline == nullptr)
+    {
+        BinOnCpu(lights.first(lightCount));
+        return;
+    }
+
+    // One group per froxel, each allocating its slice of the index list from the counter
+    constexpr auto ZeroLightIndexCount = 0u;
+    _binningBuffer.Write(&ZeroLightIndexCount, sizeof(uint32_t), 0);
+    _binningPipeline->Use();
+    Bind(*_binningPipeline);
+    _binningPipeline->BindAsShaderStorageBuffer(_binningBuffer, BinningBufferBinding, 0, _binningBuffer.GetSize());
+    _binningPipeline->Dispatch(ClusterCount);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ClusteredLighting::Bind(Pipeline& pipeline) const
+{
+    pipeline.BindAsUniformBuffer(_uniformBuffer, ClusteredLightingUniformBinding, 0, sizeof(ClusterUniforms));
+    pipeline.BindAsShaderStorageBuffer(_lightBuffer, ClusteredLightingLightBufferBinding, 0, _lightBuffer.GetSize());
+    pipeline.BindAsShaderStorageBuffer(_clusterBuffer, ClusteredLightingClusterBufferBinding, 0, _clusterBuffer.GetSize());
+    pipeline.BindAsShaderStorageBuffer(_lightIndexBuffer, ClusteredLightingLightIndexBufferBinding, 0, _lightIndexBuffer.GetSize());
+}
+
+void ClusteredLighting::ComputeClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane)
+{
+    // Corners of each tile on the near plane, pushed out along their rays to the slice's depths
+    auto inverseProjection = glm::inverse(projection);
+    auto unproject = [&inverseProjection](float x, float y)
+    {
+        auto point = inverseProjection * glm::vec4(x, y, -1.0f, 1.0f);
+        return glm::vec3(point) / point.w;
+    };
+
+    for (auto z = 0u; z < ClusterCountZ; z++)
+    {
+        auto sliceNear = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / ClusterCountZ);
+        auto sliceFar = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z + 1) / ClusterCountZ);
+        for (auto y = 0u; y < ClusterCountY; y++)
+        {
+            for (auto x = 0u; x < ClusterCountX; x++)
+            {
+                auto minNdc = glm::vec2(x * _uniforms.TileSize.x, y * _uniforms.TileSize.y) / glm::vec2(_uniforms.TileSize.z, _uniforms.TileSize.w) * 2.0f - 1.0f;
+                auto maxNdc = glm::vec2((x + 1) * _uniforms.TileSize.x, (y + 1) * _uniforms.TileSize.y) / glm::vec2(_uniforms.TileSize.z, _uniforms.TileSize.w) * 2.0f - 1.0f;
+
+                auto boundsMin = glm::vec3(std::numeric_limits<float>::max());
+                auto boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+                for (auto corner = 0u; corner < 4; corner++)
+                {
+                    auto nearPoint = unproject((corner & 1) != 0 ? maxNdc.x : minNdc.x, (corner & 2) != 0 ? maxNdc.y : minNdc.y);
+                    for (auto depth : { sliceNear, sliceFar })
+                    {
+                        auto point = nearPoint * (depth / -nearPoint.z);
+                        boundsMin = glm::min(boundsMin, point);
+                        boundsMax = glm::max(boundsMax, point);
+                    }
+                }
+
+                _clusterBounds[x + ClusterCountX * (y + ClusterCountY * z)] = ClusterBounds
+                {
+                    .Min = glm::vec4(boundsMin, 0.0f),
+                    .Max = glm::vec4(boundsMax, 0.0f)
+                };
+            }
+        }
+    }
+}
+
+void ClusteredLighting::BinOnCpu(std::span<const PointLight> lights)
+{
+    _viewLights.resize(lights.size());
+    for (auto i = 0u; i < lights.size(); i++)
+    {
+        _viewLights[i] = glm::vec4(glm::vec3(_uniforms.View * glm::vec4(lights[i].Position, 1.0f)), lights[i].Radius);
+    }
+
+    // Slices are independent, lights outside a slice's depth range are rejected before any froxel is tested
+    auto binSlices = [this](uint32_t begin, uint32_t end)
+    {
+        constexpr auto SliceClusterCount = ClusterCountX * ClusterCountY;
+        for (auto z = begin; z < end; z++)
+        {
+            auto sliceClusters = z * SliceClusterCount;
+            auto sliceNear = -_clusterBounds[sliceClusters].Max.z;
+            auto sliceFar = -_clusterBounds[sliceClusters].Min.z;
+            for (auto cluster = sliceClusters; cluster < sliceClusters + SliceClusterCount; cluster++)
+            {
+                _clusterLightLists[cluster].clear();
+            }
+
+            for (auto light = 0u; light < _viewLights.size(); light++)
+            {
+                auto& viewLight = _viewLights[light];
+                if (-viewLight.z + viewLight.w < sliceNear || -viewLight.z - viewLight.w > sliceFar)
+                {
+                    continue;
+                }
+
+                for (auto cluster = sliceClusters; cluster < sliceClusters + SliceClusterCount; cluster++)
+                {
+                    auto& clusterLights = _clusterLightLists[cluster];
+                    if (clusterLights.size() < MaxClusterLightCount && IsSphereInBox(viewLight, _clusterBounds[cluster].Min, _clusterBounds[cluster].Max))
+                    {
+                        clusterLights.push_back(light);
+                    }
+                }
+            }
+        }
+    };
+
+    if (_taskScheduler != nullptr)
+    {
+        _taskScheduler->ParallelFor(ClusterCountZ, 1, binSlices);
+    }
+    else
+    {
+        binSlices(0, ClusterCountZ);
+    }
+
+    _lightIndices.clear();
+    for (auto cluster = 0u; cluster < ClusterCount; cluster++)
+    {
+        auto& clusterLights = _clusterLightLists[cluster];
+        auto lightCount = std::min<uint32_t>(static_cast<uint32_t>(clusterLights.size()), _settings.MaxLightIndexCount - static_cast<uint32_t>(_lightIndices.size()));
+        _clusterRanges[cluster] = glm::uvec2(static_cast<uint32_t>(_lightIndices.size()), lightCount);
+        _lightIndices.insert(_lightIndices.end(), clusterLights.begin(), clusterLights.begin() + lightCount);
+        _statistics.MaxClusterLightCount = std::max(_statistics.MaxClusterLightCount, lightCount);
+    }
+    _statistics.LightIndexCount = static_cast<uint32_t>(_lightIndices.size());
+
+    _clusterBuffer.Write(_clusterRanges.data(), sizeof(glm::uvec2) * _clusterRanges.size(), 0);
+    _lightIndexBuffer.Write(_lightIndices.data(), sizeof(uint32_t) * _lightIndices.size(), 0);
+}
@@ -0,0 +1,27 @@
+#include <Engine/ComputePipeline.hpp>
+#include <Engine/RenderStatistics.hpp>
+
+#include <glad/glad.h>
+
+ComputePipeline::~ComputePipeline()
+{
+    if (_computeShader != 0u)
+    {
+        glDeleteProgram(_computeShader);
+        _computeShader = 0u;
+    }
+}
+
+void ComputePipeline::SetUniform(int32_t location, uint32_t value)
+{
+    glProgramUniform1ui(_computeShader, location, value);
+}
+
+void ComputePipeline::Dispatch(
+    uint32_t groupCountX,
+    uint32_t groupCountY,
+    uint32_t groupCountZ)
+{
+    GetRenderStatistics().DispatchCount++;
+    glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+}
@@ -0,0 +1,55 @@
+#include <Engine/ComputePipelineBuilder.hpp>
+#include <Engine/ComputePipeline.hpp>
+#include <Engine/ShaderProgram.hpp>
+#include <EngineCore/Io.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <glad/glad.h>
+
+#include <format>
+#include <iterator>
+
+ComputePipelineBuilder::ComputePipelineBuilder(std::string_view label)
+    : _label(label)
+{
+}
+
+ComputePipelineBuilder& ComputePipelineBuilder::WithShader(std::string_view computeShaderFilePath)
+{
+    _computeShaderFilePath = computeShaderFilePath;
+    return *this;
+}
+
+std::expected<std::unique_ptr<ComputePipeline>, std::string> ComputePipelineBuilder::Build()
+{
+    auto& arena = GetThreadArena();
+    ArenaScope arenaScope(arena);
+
+    auto computeShaderFileResult = Io::ReadTextFromFile(_computeShaderFilePath, &arena);
+    if (!computeShaderFileResult)
+    {
+        return std::unexpected(std::format("Unable to build compute pipeline {}. Details: {} ",
+            _label,
+            computeShaderFileResult.error()));
+    }
+
+    std::pmr::string label(&arena);
+    std::format_to(std::back_inserter(label), "Program-{}", _label);
+
+    std::pmr::string shaderLabel(&arena);
+    std::format_to(std::back_inserter(shaderLabel), "{}-CS", label);
+
+    auto computeShaderProgram = CreateShaderProgram(shaderLabel, GL_COMPUTE_SHADER, computeShaderFileResult.value());
+    if (!computeShaderProgram)
+    {
+        return std::unexpected(computeShaderProgram.error());
+    }
+
+    auto computePipeline = std::make_unique<ComputePipeline>();
+    computePipeline->_computeShader = computeShaderProgram.value();
+    glCreateProgramPipelines(1, &computePipeline->Program);
+    glObjectLabel(GL_PROGRAM_PIPELINE, computePipeline->Program, label.size(), label.data());
+    glUseProgramStages(computePipeline->Program, GL_COMPUTE_SHADER_BIT, computePipeline->_computeShader);
+
+    return computePipeline;
+}
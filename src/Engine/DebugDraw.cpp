@@ -0,0 +1,272 @@
+#include <Engine/DebugDraw.hpp>
+
+#ifndef ENGINE_SHIPPING
+
+#include <Engine/Device.hpp>
+#include <Engine/GraphicsPipeline.hpp>
+#include <Engine/GraphicsPipelineBuilder.hpp>
+#include <Engine/PrimitiveTopology.hpp>
+#include <Engine/VertexPulling.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <glad/glad.h>
+
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SphereSegmentCount = 24;
+    constexpr uint32_t ModeCount = 2;
+
+    // Matches struct Vertex in the debug draw shaders (std430)
+    struct DebugVertex
+    {
+        glm::vec3 Position;
+        // RGBA8, sRGB
+        uint32_t Color;
+    };
+
+    // Only the owning thread appends and only the renderer drains, so the lock is all but uncontended
+    struct ThreadLines
+    {
+        std::mutex Mutex;
+        std::array<std::vector<DebugVertex>, ModeCount> Vertices;
+    };
+
+    // Threads register on their first line and stay registered, like thread arenas
+    struct ThreadLinesRegistry
+    {
+        std::mutex Mutex;
+        std::vector<std::unique_ptr<ThreadLines>> Threads;
+    };
+
+    ThreadLinesRegistry& GetThreadLinesRegistry()
+    {
+        static ThreadLinesRegistry registry;
+        return registry;
+    }
+
+    ThreadLines& GetThreadLines()
+    {
+        thread_local ThreadLines* threadLines = nullptr;
+        if (threadLines == nullptr)
+        {
+            auto& registry = GetThreadLinesRegistry();
+            std::scoped_lock lock(registry.Mutex);
+            threadLines = registry.Threads.emplace_back(std::make_unique<ThreadLines>()).get();
+        }
+        return *threadLines;
+    }
+
+    uint32_t PackColor(const glm::vec4& color) noexcept
+    {
+        auto pack = [](float channel, uint32_t shift)
+        {
+            return static_cast<uint32_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f) << shift;
+        };
+        return pack(color.x, 0) | pack(color.y, 8) | pack(color.z, 16) | pack(color.w, 24);
+    }
+
+    // Pairs of points, one line each
+    void AddLines(std::span<const glm::vec3> points, const glm::vec4& color, DebugDrawMode mode)
+    {
+        MemoryTagScope memoryTagScope(MemoryTag::Debug);
+        auto packedColor = PackColor(color);
+        auto& threadLines = GetThreadLines();
+        std::scoped_lock lock(threadLines.Mutex);
+        auto& vertices = threadLines.Vertices[static_cast<uint32_t>(mode)];
+        for (auto& point : points)
+        {
+            vertices.push_back(DebugVertex{ .Position = point, .Color = packedColor });
+        }
+    }
+
+    void AddBox(const std::array<glm::vec3, 8>& corners, const glm::vec4& color, DebugDrawMode mode)
+    {
+        // Corner bits are x, y and z from the lowest, the edges connect corners one bit apart
+        constexpr std::array<uint8_t, 24> EdgeCorners =
+        {
+            0, 1, 2, 3, 4, 5, 6, 7,
+            0, 2, 1, 3, 4, 6, 5, 7,
+            0, 4, 1, 5, 2, 6, 3, 7
+        };
+        std::array<glm::vec3, EdgeCorners.size()> points;
+        for (auto i = 0u; i < EdgeCorners.size(); i++)
+        {
+            points[i] = corners[EdgeCorners[i]];
+        }
+        AddLines(points, color, mode);
+    }
+}
+
+namespace DebugDraw
+{
+    void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, DebugDrawMode mode)
+    {
+        std::array<glm::vec3, 2> points = { from, to };
+        AddLines(points, color, mode);
+    }
+
+    void Box(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color, DebugDrawMode mode)
+    {
+        std::array<glm::vec3, 8> corners;
+        for (auto i = 0u; i < corners.size(); i++)
+        {
+            corners[i] = glm::vec3(
+                (i & 1) != 0 ? max.x : min.x,
+                (i & 2) != 0 ? max.y : min.y,
+                (i & 4) != 0 ? max.z : min.z);
+        }
+        AddBox(corners, color, mode);
+    }
+
+    void Box(const glm::mat4& transform, const glm::vec4& color, DebugDrawMode mode)
+    {
+        std::array<glm::vec3, 8> corners;
+        for (auto i = 0u; i < corners.size(); i++)
+        {
+            auto corner = transform * glm::vec4(
+                (i & 1) != 0 ? 1.0f : -1.0f,
+                (i & 2) != 0 ? 1.0f : -1.0f,
+                (i & 4) != 0 ? 1.0f : -1.0f,
+                1.0f);
+            corners[i] = glm::vec3(corner.x, corner.y, corner.z) / corner.w;
+        }
+        AddBox(corners, color, mode);
+    }
+
+    void Sphere(const glm::vec3& center, float radius, const glm::vec4& color, DebugDrawMode mode)
+    {
+        std::array<glm::vec3, 3 * SphereSegmentCount * 2> points;
+        auto point = 0u;
+        for (auto segment = 0u; segment < SphereSegmentCount; segment++)
+        {
+            for (auto end = 0u; end < 2; end++)
+            {
+                auto angle = static_cast<float>(segment + end) / static_cast<float>(SphereSegmentCount) * 2.0f * std::numbers::pi_v<float>;
+                auto c = std::cos(angle) * radius;
+                auto s = std::sin(angle) * radius;
+                points[point] = center + glm::vec3(c, s, 0.0f);
+                points[point + 2 * SphereSegmentCount] = center + glm::vec3(c, 0.0f, s);
+                points[point + 4 * SphereSegmentCount] = center + glm::vec3(0.0f, c, s);
+                point++;
+            }
+        }
+        AddLines(points, color, mode);
+    }
+
+    void Frustum(const glm::mat4& viewProjection, const glm::vec4& color, DebugDrawMode mode)
+    {
+        // The clip space cube taken back out
+        Box(glm::inverse(viewProjection), color, mode);
+    }
+}
+
+std::expected<DebugDrawRenderer, std::string> DebugDrawRenderer::Create(
+    Device& device,
+    std::string_view vertexShaderFilePath,
+    std::string_view fragmentShaderFilePath,
+    const DebugDrawSettings& settings)
+{
+    auto pipelineResult = device.CreateGraphicsPipelineBuilder("DebugDraw")
+        .WithShaders(vertexShaderFilePath, fragmentShaderFilePath)
+        .WithPrimitiveTopology(PrimitiveTopology::Lines)
+        .Build();
+    if (!pipelineResult)
+    {
+        return std::unexpected(std::format("Unable to create debug draw renderer. Details: {}", pipelineResult.error()));
+    }
+
+    auto renderer = DebugDrawRenderer();
+    renderer._pipeline = std::move(pipelineResult.value());
+    renderer._settings = settings;
+    renderer._vertexBuffer = Buffer::Create(
+        "Buffer_DebugDrawVertices",
+        sizeof(DebugVertex) * settings.MaxVertexCount * settings.FrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true);
+    renderer._uniformBuffer = Buffer::Create("Buffer_Uniforms_DebugDraw", sizeof(DebugDrawUniforms), GL_UNIFORM_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    return renderer;
+}
+
+DebugDrawRenderer::DebugDrawRenderer() noexcept = default;
+DebugDrawRenderer::~DebugDrawRenderer() = default;
+DebugDrawRenderer::DebugDrawRenderer(DebugDrawRenderer&& other) noexcept = default;
+DebugDrawRenderer& DebugDrawRenderer::operator =(DebugDrawRenderer&& other) noexcept = default;
+
+void DebugDrawRenderer::Draw(uint32_t frame, const glm::mat4& viewProjection)
+{
+    // Depth tested lines first and overlay lines after, the shader tells them apart by vertex index
+    auto firstVertex = (frame % _settings.FrameCount) * _settings.MaxVertexCount;
+    auto vertices = static_cast<DebugVertex*>(_vertexBuffer.GetMappedMemory()) + firstVertex;
+    auto vertexCount = 0u;
+    auto overlayFirstVertex = 0u;
+
+    _statistics = {};
+    auto& registry = GetThreadLinesRegistry();
+    std::scoped_lock registryLock(registry.Mutex);
+    for (auto mode = 0u; mode < ModeCount; mode++)
+    {
+        overlayFirstVertex = vertexCount;
+        for (auto& threadLines : registry.Threads)
+        {
+            std::scoped_lock lock(threadLines->Mutex);
+            auto& threadVertices = threadLines->Vertices[mode];
+            auto copyCount = std::min<uint32_t>(static_cast<uint32_t>(threadVertices.size()), _settings.MaxVertexCount - vertexCount);
+            std::copy_n(threadVertices.data(), copyCount, vertices + vertexCount);
+            vertexCount += copyCount;
+            _statistics.DroppedLineCount += static_cast<uint32_t>(threadVertices.size() - copyCount) / 2;
+            // Keeps its capacity, a steady amount of lines stops allocating after the first frames
+            threadVertices.clear();
+        }
+    }
+    _statistics.LineCount = vertexCount / 2;
+    _statistics.OverlayLineCount = (vertexCount - overlayFirstVertex) / 2;
+    _statistics.ThreadCount = static_cast<uint32_t>(registry.Threads.size());
+    if (vertexCount == 0)
+    {
+        return;
+    }
+
+    DebugDrawUniforms uniforms =
+    {
+        .ViewProjection = viewProjection,
+        .OverlayFirstVertex = glm::uvec4(firstVertex + overlayFirstVertex, 0, 0, 0)
+    };
+    _uniformBuffer.Write(&uniforms, sizeof(DebugDrawUniforms), 0);
+
+    // Tested against the scene's depth without writing any, lines must not hide each other
+    glDepthMask(GL_FALSE);
+    _pipeline->Use();
+    _pipeline->BindAsUniformBuffer(_uniformBuffer, DebugDrawUniformBinding, 0, sizeof(DebugDrawUniforms));
+    _pipeline->BindAsShaderStorageBuffer(_vertexBuffer, VertexPullingVertexBufferBinding, 0, _vertexBuffer.GetSize());
+    _pipeline->DrawArrays(vertexCount, firstVertex);
+    glDepthMask(GL_TRUE);
+}
+
+void DebugDrawRenderer::Discard()
+{
+    auto& registry = GetThreadLinesRegistry();
+    std::scoped_lock registryLock(registry.Mutex);
+    for (auto& threadLines : registry.Threads)
+    {
+        std::scoped_lock lock(threadLines->Mutex);
+        for (auto& threadVertices : threadLines->Vertices)
+        {
+            threadVertices.clear();
+        }
+    }
+    _statistics = {};
+}
+
+#endif
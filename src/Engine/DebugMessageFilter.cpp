@@ -0,0 +1,56 @@
+#include <Engine/DebugMessageFilter.hpp>
+
+#include <bit>
+#include <chrono>
+
+uint32_t DebugMessageFilter::Accept(uint32_t source, uint32_t type, uint32_t id) noexcept
+{
+    // GL source and type enums fit in 16 bits and are never 0, so neither is the key
+    auto key = (static_cast<uint64_t>(source & 0xFFFF) << 48) | (static_cast<uint64_t>(type & 0xFFFF) << 32) | id;
+    auto count = FindCount(key);
+
+    // A full table treats everything new as a repeat
+    auto occurrence = count != nullptr ? count->fetch_add(1, std::memory_order_relaxed) + 1 : 0;
+    if (!std::has_single_bit(occurrence))
+    {
+        _suppressedCount.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    auto second = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto rateSecond = _rateSecond.load(std::memory_order_relaxed);
+    if (rateSecond != second && _rateSecond.compare_exchange_strong(rateSecond, second, std::memory_order_relaxed))
+    {
+        _rateSecondCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (_rateSecondCount.fetch_add(1, std::memory_order_relaxed) >= MaxMessagesPerSecond)
+    {
+        _suppressedCount.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    return occurrence;
+}
+
+std::atomic<uint32_t>* DebugMessageFilter::FindCount(uint64_t key) noexcept
+{
+    // Linear probing from a Fibonacci hash, slots are claimed once and never freed
+    auto slotIndex = static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - SlotCountLog2));
+    for (size_t probe = 0; probe < _slots.size(); probe++)
+    {
+        auto& slot = _slots[(slotIndex + probe) % _slots.size()];
+        auto slotKey = slot.Key.load(std::memory_order_acquire);
+        if (slotKey == 0 && slot.Key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel))
+        {
+            return &slot.Count;
+        }
+
+        if (slotKey == key)
+        {
+            return &slot.Count;
+        }
+    }
+
+    return nullptr;
+}
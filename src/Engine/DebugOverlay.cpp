@@ -0,0 +1,226 @@
+#include <Engine/DebugOverlay.hpp>
+#include <Engine/GpuMemory.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <glad/glad.h>
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_opengl3.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    constexpr double OverlayBudgetMilliseconds = 0.2;
+
+    float ToKibibytes(uint64_t byteCount) noexcept
+    {
+        return static_cast<float>(byteCount) / 1024.0f;
+    }
+
+    const char* GetBufferUsageName(uint32_t storage) noexcept
+    {
+        if ((storage & GL_MAP_PERSISTENT_BIT) != 0)
+        {
+            return (storage & GL_MAP_COHERENT_BIT) != 0 ? "Persistent Coherent" : "Persistent";
+        }
+        if ((storage & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT)) != 0)
+        {
+            return "Mappable";
+        }
+        return (storage & GL_DYNAMIC_STORAGE_BIT) != 0 ? "Dynamic" : "Static";
+    }
+}
+
+DebugOverlay::DebugOverlay(GLFWwindow* windowHandle)
+{
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = nullptr;
+    ImGui::StyleColorsDark();
+
+    // Chains to the callbacks the application installed before
+    ImGui_ImplGlfw_InitForOpenGL(windowHandle, true);
+    ImGui_ImplOpenGL3_Init("#version 460");
+}
+
+DebugOverlay::~DebugOverlay()
+{
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+}
+
+void DebugOverlay::RecordFrame(const DebugOverlayFrame& frame) noexcept
+{
+    _frame = frame;
+    _cpuFrameMilliseconds[_nextFrame] = static_cast<float>(frame.CpuMilliseconds);
+    _gpuFrameMilliseconds[_nextFrame] = static_cast<float>(frame.GpuMilliseconds.value_or(0.0));
+    _nextFrame = (_nextFrame + 1) % FrameHistoryCount;
+}
+
+void DebugOverlay::Render()
+{
+    if (!_isVisible)
+    {
+        return;
+    }
+
+    MemoryTagScope memoryTagScope(MemoryTag::Debug);
+    auto startTime = std::chrono::steady_clock::now();
+    _overlayGpuTimer.Begin();
+
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    ImGui::SetNextWindowPos(ImVec2(8.0f, 8.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    if (ImGui::Begin("Statistics", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        DrawStatistics();
+        DrawMemory();
+    }
+    ImGui::End();
+    ImGui::Render();
+
+    // The backend writes ImGui's colors as they are, they must not be encoded again
+    glDisable(GL_FRAMEBUFFER_SRGB);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    glEnable(GL_FRAMEBUFFER_SRGB);
+
+    _overlayGpuTimer.End();
+    _overlayCpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void DebugOverlay::DrawStatistics()
+{
+    auto gpuMilliseconds = _frame.GpuMilliseconds.value_or(0.0);
+    ImGui::Text("Frame %.2f ms CPU, %.2f ms GPU", _frame.CpuMilliseconds, gpuMilliseconds);
+
+    auto maxMilliseconds = std::max(
+        *std::max_element(_cpuFrameMilliseconds.begin(), _cpuFrameMilliseconds.end()),
+        *std::max_element(_gpuFrameMilliseconds.begin(), _gpuFrameMilliseconds.end()));
+    auto graphScale = std::max(maxMilliseconds, 16.7f);
+    ImGui::PlotLines("CPU", _cpuFrameMilliseconds.data(), FrameHistoryCount, static_cast<int>(_nextFrame), nullptr, 0.0f, graphScale, ImVec2(240.0f, 48.0f));
+    ImGui::PlotLines("GPU", _gpuFrameMilliseconds.data(), FrameHistoryCount, static_cast<int>(_nextFrame), nullptr, 0.0f, graphScale, ImVec2(240.0f, 48.0f));
+    ImGui::Text("Render scale %.0f%%, GPU budget %.2f ms", _frame.RenderScale * 100.0f, _frame.BudgetMilliseconds);
+
+    ImGui::Text("%u draw calls, %llu instances, %u dispatches, %u barriers",
+        _frame.Render.DrawCallCount,
+        static_cast<unsigned long long>(_frame.Render.InstanceCount),
+        _frame.Render.DispatchCount,
+        _frame.Render.BarrierCount);
+    ImGui::Text("%u pipeline changes, %u binding changes",
+        _frame.Render.PipelineChangeCount,
+        _frame.Render.BindingChangeCount);
+    ImGui::Text("%u queued draws, %u state changes unsorted, %u sorted",
+        _frame.Render.QueuedDrawCount,
+        _frame.Render.UnsortedStateChangeCount,
+        _frame.Render.SortedStateChangeCount);
+    ImGui::Text("%llu heap allocations, frame arena peak %.1f KiB",
+        static_cast<unsigned long long>(_frame.HeapAllocationCount),
+        ToKibibytes(_frame.FrameArenaPeakByteCount));
+
+    auto overlayGpuMilliseconds = _overlayGpuTimer.GetMilliseconds().value_or(0.0);
+    auto isOverBudget = _overlayCpuMilliseconds + overlayGpuMilliseconds > OverlayBudgetMilliseconds;
+    ImGui::TextColored(
+        isOverBudget ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+        "Overlay %.3f ms CPU, %.3f ms GPU",
+        _overlayCpuMilliseconds,
+        overlayGpuMilliseconds);
+}
+
+void DebugOverlay::DrawMemory()
+{
+    if (ImGui::CollapsingHeader("CPU memory", ImGuiTreeNodeFlags_DefaultOpen) &&
+        ImGui::BeginTable("CpuMemory", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+    {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Live KiB");
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableHeadersRow();
+        for (auto tag = 0u; tag < static_cast<uint32_t>(MemoryTag::Count); tag++)
+        {
+            auto memoryTag = static_cast<MemoryTag>(tag);
+            auto statistics = GetMemoryTagStatistics(memoryTag);
+            auto name = GetMemoryTagName(memoryTag);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name.data(), name.data() + name.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", ToKibibytes(statistics.LiveByteCount));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(statistics.LiveAllocationCount));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(statistics.AllocationCount));
+        }
+        ImGui::EndTable();
+    }
+
+    if (!ImGui::CollapsingHeader("GPU memory", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        return;
+    }
+
+    auto totals = GpuMemory::GetTotals();
+    ImGui::Text("%llu buffers, %.1f KiB",
+        static_cast<unsigned long long>(totals.BufferCount),
+        ToKibibytes(totals.BufferByteCount));
+    ImGui::Text("%llu textures, %.1f KiB",
+        static_cast<unsigned long long>(totals.TextureCount),
+        ToKibibytes(totals.TextureByteCount));
+
+    // Only sorted while the list is open, and the clipper keeps long lists cheap to draw
+    if (!ImGui::TreeNode("Allocations"))
+    {
+        return;
+    }
+
+    auto& arena = GetThreadArena();
+    ArenaScope arenaScope(arena);
+    std::pmr::vector<GpuAllocation> allocations(&arena);
+    GpuMemory::CopyAllocations(allocations);
+    std::sort(allocations.begin(), allocations.end(), [](const GpuAllocation& lhs, const GpuAllocation& rhs)
+    {
+        return lhs.ByteCount > rhs.ByteCount;
+    });
+
+    if (ImGui::BeginTable("GpuAllocations", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit, ImVec2(0.0f, 240.0f)))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Label");
+        ImGui::TableSetupColumn("KiB");
+        ImGui::TableSetupColumn("Usage");
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(allocations.size()));
+        while (clipper.Step())
+        {
+            for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+            {
+                auto& allocation = allocations[static_cast<size_t>(i)];
+                auto label = allocation.GetLabel();
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(label.data(), label.data() + label.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", ToKibibytes(allocation.ByteCount));
+                ImGui::TableNextColumn();
+                if (allocation.ResourceType == GpuResourceType::Buffer)
+                {
+                    ImGui::TextUnformatted(GetBufferUsageName(allocation.Usage));
+                }
+                else
+                {
+                    ImGui::Text("Texture 0x%04X", allocation.Usage);
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::TreePop();
+}
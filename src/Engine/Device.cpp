@@ -1,4 +1,5 @@
 #include <Engine/Device.hpp>
+#include <Engine/ComputePipelineBuilder.hpp>
 #include <Engine/GraphicsPipelineBuilder.hpp>
 
 #include <glad/glad.h>
@@ -19,4 +20,9 @@ Device::Device()
 GraphicsPipelineBuilder Device::CreateGraphicsPipelineBuilder(std::string_view label)
 {
     return GraphicsPipelineBuilder(label);
+}
+
+ComputePipelineBuilder Device::CreateComputePipelineBuilder(std::string_view label)
+{
+    return ComputePipelineBuilder(label);
 }
\ No newline at end of file
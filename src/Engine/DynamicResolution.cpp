@@ -0,0 +1,71 @@
+#include <Engine/DynamicResolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Weight of a new timing in the smoothed one
+    constexpr double SmoothingFactor = 0.1;
+    // Only grows when the smoothed time is below this much of the budget, so the scale does not oscillate
+    constexpr double GrowthThreshold = 0.85;
+}
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings) noexcept
+    : _settings(settings),
+      _scale(settings.MaxScale)
+{
+}
+
+bool DynamicResolution::Update(std::optional<double> gpuMilliseconds) noexcept
+{
+    _framesSinceChange++;
+    if (!_isEnabled || !gpuMilliseconds)
+    {
+        return false;
+    }
+
+    _milliseconds = _hasMilliseconds ? std::lerp(_milliseconds, *gpuMilliseconds, SmoothingFactor) : *gpuMilliseconds;
+    _hasMilliseconds = true;
+    if (_framesSinceChange < _settings.CooldownFrameCount || _milliseconds <= 0.0)
+    {
+        return false;
+    }
+
+    // Snapped down to the step, with some slack so a scale that is a multiple already is not missed by rounding
+    auto step = _settings.ScaleStep;
+    auto fittingScale = _scale * static_cast<float>(std::sqrt(_settings.BudgetMilliseconds / _milliseconds));
+    fittingScale = std::floor(fittingScale / step + 0.001f) * step;
+    auto scale = _scale;
+    if (_milliseconds > _settings.BudgetMilliseconds)
+    {
+        scale = std::min(fittingScale, _scale - step);
+    }
+    else if (_milliseconds < _settings.BudgetMilliseconds * GrowthThreshold)
+    {
+        scale = std::min(fittingScale, _scale + step);
+    }
+
+    scale = std::clamp(scale, _settings.MinScale, _settings.MaxScale);
+    if (std::abs(scale - _scale) < step * 0.5f)
+    {
+        return false;
+    }
+
+    _scale = scale;
+    _framesSinceChange = 0;
+    return true;
+}
+
+void DynamicResolution::SetEnabled(bool isEnabled) noexcept
+{
+    _isEnabled = isEnabled;
+    _scale = isEnabled ? _scale : _settings.MaxScale;
+    _hasMilliseconds = false;
+}
+
+void DynamicResolution::SetBudgetMilliseconds(double budgetMilliseconds) noexcept
+{
+    _settings.BudgetMilliseconds = budgetMilliseconds;
+    _framesSinceChange = _settings.CooldownFrameCount;
+}
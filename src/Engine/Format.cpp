@@ -0,0 +1,139 @@
+#include <Engine/Format.hpp>
+
+#include <glad/glad.h>
+
+#include <array>
+
+namespace
+{
+    // GL_EXT_texture_compression_s3tc and its sRGB variants, the core profile loader does not define them
+    constexpr uint32_t CompressedRgbS3tcDxt1 = 0x83F0;
+    constexpr uint32_t CompressedRgbaS3tcDxt1 = 0x83F1;
+    constexpr uint32_t CompressedRgbaS3tcDxt3 = 0x83F2;
+    constexpr uint32_t CompressedRgbaS3tcDxt5 = 0x83F3;
+    constexpr uint32_t CompressedSrgbS3tcDxt1 = 0x8C4C;
+    constexpr uint32_t CompressedSrgbAlphaS3tcDxt1 = 0x8C4D;
+    constexpr uint32_t CompressedSrgbAlphaS3tcDxt3 = 0x8C4E;
+    constexpr uint32_t CompressedSrgbAlphaS3tcDxt5 = 0x8C4F;
+
+    constexpr std::array<FormatGLTraits, FormatCount> FormatGLTraitsTable =
+    {{
+        { Format::R8_UNORM, GL_R8, GL_RED, GL_UNSIGNED_BYTE },
+        { Format::R8_SNORM, GL_R8_SNORM, GL_RED, GL_BYTE },
+        { Format::R16_UNORM, GL_R16, GL_RED, GL_UNSIGNED_SHORT },
+        { Format::R16_SNORM, GL_R16_SNORM, GL_RED, GL_SHORT },
+        { Format::R8G8_UNORM, GL_RG8, GL_RG, GL_UNSIGNED_BYTE },
+        { Format::R8G8_SNORM, GL_RG8_SNORM, GL_RG, GL_BYTE },
+        { Format::R16G16_UNORM, GL_RG16, GL_RG, GL_UNSIGNED_SHORT },
+        { Format::R16G16_SNORM, GL_RG16_SNORM, GL_RG, GL_SHORT },
+        { Format::R3G3B2_UNORM, GL_R3_G3_B2, GL_RGB, GL_UNSIGNED_BYTE_3_3_2 },
+        { Format::R4G4B4_UNORM, GL_RGB4, GL_RGB, GL_UNSIGNED_BYTE },
+        { Format::R5G5B5_UNORM, GL_RGB5, GL_RGB, GL_UNSIGNED_BYTE },
+        { Format::R8G8B8_UNORM, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE },
+        { Format::R8G8B8_SNORM, GL_RGB8_SNORM, GL_RGB, GL_BYTE },
+        { Format::R10G10B10_UNORM, GL_RGB10, GL_RGB, GL_UNSIGNED_SHORT },
+        { Format::R12G12B12_UNORM, GL_RGB12, GL_RGB, GL_UNSIGNED_SHORT },
+        { Format::R16G16B16_SNORM, GL_RGB16_SNORM, GL_RGB, GL_SHORT },
+        { Format::R2G2B2A2_UNORM, GL_RGBA2, GL_RGBA, GL_UNSIGNED_BYTE },
+        { Format::R4G4B4A4_UNORM, GL_RGBA4, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4 },
+        { Format::R5G5B5A1_UNORM, GL_RGB5_A1, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1 },
+        { Format::R8G8B8A8_UNORM, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE },
+        { Format::R8G8B8A8_SNORM, GL_RGBA8_SNORM, GL_RGBA, GL_BYTE },
+        { Format::R10G10B10A2_UNORM, GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV },
+        { Format::R10G10B10A2_UINT, GL_RGB10_A2UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT_2_10_10_10_REV },
+        { Format::R12G12B12A12_UNORM, GL_RGBA12, GL_RGBA, GL_UNSIGNED_SHORT },
+        { Format::R16G16B16A16_UNORM, GL_RGBA16, GL_RGBA, GL_UNSIGNED_SHORT },
+        { Format::R16G16B16A16_SNORM, GL_RGBA16_SNORM, GL_RGBA, GL_SHORT },
+        { Format::R8G8B8_SRGB, GL_SRGB8, GL_RGB, GL_UNSIGNED_BYTE },
+        { Format::R8G8B8A8_SRGB, GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE },
+        { Format::R16_FLOAT, GL_R16F, GL_RED, GL_HALF_FLOAT },
+        { Format::R16G16_FLOAT, GL_RG16F, GL_RG, GL_HALF_FLOAT },
+        { Format::R16G16B16_FLOAT, GL_RGB16F, GL_RGB, GL_HALF_FLOAT },
+        { Format::R16G16B16A16_FLOAT, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT },
+        { Format::R32_FLOAT, GL_R32F, GL_RED, GL_FLOAT },
+        { Format::R32G32_FLOAT, GL_RG32F, GL_RG, GL_FLOAT },
+        { Format::R32G32B32_FLOAT, GL_RGB32F, GL_RGB, GL_FLOAT },
+        { Format::R32G32B32A32_FLOAT, GL_RGBA32F, GL_RGBA, GL_FLOAT },
+        { Format::R11G11B10_FLOAT, GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV },
+        { Format::R9G9B9_E5, GL_RGB9_E5, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV },
+        { Format::R8_SINT, GL_R8I, GL_RED_INTEGER, GL_BYTE },
+        { Format::R8_UINT, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE },
+        { Format::R16_SINT, GL_R16I, GL_RED_INTEGER, GL_SHORT },
+        { Format::R16_UINT, GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT },
+        { Format::R32_SINT, GL_R32I, GL_RED_INTEGER, GL_INT },
+        { Format::R32_UINT, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT },
+        { Format::R8G8_SINT, GL_RG8I, GL_RG_INTEGER, GL_BYTE },
+        { Format::R8G8_UINT, GL_RG8UI, GL_RG_INTEGER, GL_UNSIGNED_BYTE },
+        { Format::R16G16_SINT, GL_RG16I, GL_RG_INTEGER, GL_SHORT },
+        { Format::R16G16_UINT, GL_RG16UI, GL_RG_INTEGER, GL_UNSIGNED_SHORT },
+        { Format::R32G32_SINT, GL_RG32I, GL_RG_INTEGER, GL_INT },
+        { Format::R32G32_UINT, GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT },
+        { Format::R8G8B8_SINT, GL_RGB8I, GL_RGB_INTEGER, GL_BYTE },
+        { Format::R8G8B8_UINT, GL_RGB8UI, GL_RGB_INTEGER, GL_UNSIGNED_BYTE },
+        { Format::R16G16B16_SINT, GL_RGB16I, GL_RGB_INTEGER, GL_SHORT },
+        { Format::R16G16B16_UINT, GL_RGB16UI, GL_RGB_INTEGER, GL_UNSIGNED_SHORT },
+        { Format::R32G32B32_SINT, GL_RGB32I, GL_RGB_INTEGER, GL_INT },
+        { Format::R32G32B32_UINT, GL_RGB32UI, GL_RGB_INTEGER, GL_UNSIGNED_INT },
+        { Format::R8G8B8A8_SINT, GL_RGBA8I, GL_RGBA_INTEGER, GL_BYTE },
+        { Format::R8G8B8A8_UINT, GL_RGBA8UI, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE },
+        { Format::R16G16B16A16_SINT, GL_RGBA16I, GL_RGBA_INTEGER, GL_SHORT },
+        { Format::R16G16B16A16_UINT, GL_RGBA16UI, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT },
+        { Format::R32G32B32A32_SINT, GL_RGBA32I, GL_RGBA_INTEGER, GL_INT },
+        { Format::R32G32B32A32_UINT, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT },
+
+        { Format::D32_FLOAT, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT },
+        { Format::D32_UNORM, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT },
+        { Format::D24_UNORM, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT },
+        { Format::D16_UNORM, GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT },
+        { Format::D32_FLOAT_S8_UINT, GL_DEPTH32F_STENCIL8, GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV },
+        { Format::D24_UNORM_S8_UINT, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8 },
+
+        { Format::BC1_RGB_UNORM, CompressedRgbS3tcDxt1, GL_RGB, 0 },
+        { Format::BC1_RGB_SRGB, CompressedSrgbS3tcDxt1, GL_RGB, 0 },
+        { Format::BC1_RGBA_UNORM, CompressedRgbaS3tcDxt1, GL_RGBA, 0 },
+        { Format::BC1_RGBA_SRGB, CompressedSrgbAlphaS3tcDxt1, GL_RGBA, 0 },
+        { Format::BC2_RGBA_UNORM, CompressedRgbaS3tcDxt3, GL_RGBA, 0 },
+        { Format::BC2_RGBA_SRGB, CompressedSrgbAlphaS3tcDxt3, GL_RGBA, 0 },
+        { Format::BC3_RGBA_UNORM, CompressedRgbaS3tcDxt5, GL_RGBA, 0 },
+        { Format::BC3_RGBA_SRGB, CompressedSrgbAlphaS3tcDxt5, GL_RGBA, 0 },
+        { Format::BC4_R_UNORM, GL_COMPRESSED_RED_RGTC1, GL_RED, 0 },
+        { Format::BC4_R_SNORM, GL_COMPRESSED_SIGNED_RED_RGTC1, GL_RED, 0 },
+        { Format::BC5_RG_UNORM, GL_COMPRESSED_RG_RGTC2, GL_RG, 0 },
+        { Format::BC5_RG_SNORM, GL_COMPRESSED_SIGNED_RG_RGTC2, GL_RG, 0 },
+        { Format::BC6H_RGB_UFLOAT, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, GL_RGB, 0 },
+        { Format::BC6H_RGB_SFLOAT, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, GL_RGB, 0 },
+        { Format::BC7_RGBA_UNORM, GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, 0 },
+        { Format::BC7_RGBA_SRGB, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, GL_RGBA, 0 },
+    }};
+
+    constexpr bool IsFormatGLTraitsTableOrdered() noexcept
+    {
+        for (auto i = 0u; i < FormatCount; i++)
+        {
+            if (static_cast<size_t>(FormatGLTraitsTable[i].Value) != i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(IsFormatGLTraitsTableOrdered(), "FormatGLTraitsTable has to list the formats in the order of Format");
+}
+
+const FormatGLTraits& GetFormatGLTraits(Format format) noexcept
+{
+    return FormatGLTraitsTable[static_cast<size_t>(format)];
+}
+
+std::optional<Format> FindFormat(uint32_t internalFormat) noexcept
+{
+    for (auto& traits : FormatGLTraitsTable)
+    {
+        if (traits.InternalFormat == internalFormat)
+        {
+            return traits.Value;
+        }
+    }
+    return std::nullopt;
+}
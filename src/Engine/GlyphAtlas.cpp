@@ -0,0 +1,412 @@
+#include <Engine/GlyphAtlas.hpp>
+#include <EngineCore/Io.hpp>
+
+#include <glad/glad.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    struct BuiltInGlyph
+    {
+        char Character;
+        // Five pixels per row, the highest bit is the leftmost
+        std::array<uint8_t, 7> Rows;
+    };
+
+    constexpr BuiltInGlyph BuiltInGlyphs[] =
+    {
+        { '0', { 0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110 } },
+        { '1', { 0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+        { '2', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111 } },
+        { '3', { 0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110 } },
+        { '4', { 0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010 } },
+        { '5', { 0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110 } },
+        { '6', { 0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110 } },
+        { '7', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000 } },
+        { '8', { 0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110 } },
+        { '9', { 0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100 } },
+        { 'A', { 0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+        { 'B', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110 } },
+        { 'C', { 0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110 } },
+        { 'D', { 0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100 } },
+        { 'E', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111 } },
+        { 'F', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000 } },
+        { 'G', { 0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111 } },
+        { 'H', { 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+        { 'I', { 0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+        { 'J', { 0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100 } },
+        { 'K', { 0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001 } },
+        { 'L', { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111 } },
+        { 'M', { 0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001 } },
+        { 'N', { 0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001 } },
+        { 'O', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+        { 'P', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000 } },
+        { 'Q', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101 } },
+        { 'R', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001 } },
+        { 'S', { 0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110 } },
+        { 'T', { 0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100 } },
+        { 'U', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+        { 'V', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100 } },
+        { 'W', { 0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010 } },
+        { 'X', { 0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001 } },
+        { 'Y', { 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100, 0b00100 } },
+        { 'Z', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111 } },
+        { '.', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100 } },
+        { ',', { 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b00100, 0b01000 } },
+        { ':', { 0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000 } },
+        { '-', { 0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000 } },
+        { '+', { 0b00000, 0b00100, 0b00100, 0b11111, 0b00100, 0b00100, 0b00000 } },
+        { '/', { 0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000 } },
+        { '%', { 0b11000, 0b11001, 0b00010, 0b00100, 0b01000, 0b10011, 0b00011 } },
+        { '(', { 0b00010, 0b00100, 0b01000, 0b01000, 0b01000, 0b00100, 0b00010 } },
+        { ')', { 0b01000, 0b00100, 0b00010, 0b00010, 0b00010, 0b00100, 0b01000 } },
+        { '[', { 0b01110, 0b01000, 0b01000, 0b01000, 0b01000, 0b01000, 0b01110 } },
+        { ']', { 0b01110, 0b00010, 0b00010, 0b00010, 0b00010, 0b00010, 0b01110 } },
+        { '<', { 0b00010, 0b00100, 0b01000, 0b10000, 0b01000, 0b00100, 0b00010 } },
+        { '>', { 0b01000, 0b00100, 0b00010, 0b00001, 0b00010, 0b00100, 0b01000 } },
+        { '=', { 0b00000, 0b00000, 0b11111, 0b00000, 0b11111, 0b00000, 0b00000 } },
+        { '!', { 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00000, 0b00100 } },
+        { '?', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b00000, 0b00100 } },
+        { '_', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111 } },
+        { '*', { 0b00000, 0b00100, 0b10101, 0b01110, 0b10101, 0b00100, 0b00000 } },
+        { '#', { 0b01010, 0b01010, 0b11111, 0b01010, 0b11111, 0b01010, 0b01010 } },
+        { '\'', { 0b00100, 0b00100, 0b01000, 0b00000, 0b00000, 0b00000, 0b00000 } },
+        { '"', { 0b01010, 0b01010, 0b01010, 0b00000, 0b00000, 0b00000, 0b00000 } },
+        { '|', { 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100 } },
+    };
+
+    // Built in glyphs sit on a grid of font units, 5x7 of them drawn, 6 wide with the gap
+    constexpr uint32_t BuiltInGlyphWidth = 5;
+    constexpr uint32_t BuiltInGlyphHeight = 7;
+    constexpr float BuiltInAdvance = 6.0f;
+    constexpr float BuiltInAscent = 8.0f;
+    constexpr float BuiltInLineHeight = 10.0f;
+
+    // Stands in for infinity in the distance transforms, where infinities would turn into NaNs
+    constexpr float FarDistance = 1e20f;
+
+    // Lower envelope of the parabolas (q - p)^2 + f[p] along one row or column, Felzenszwalb and Huttenlocher
+    void TransformDistances1D(std::span<float> f, std::span<float> d, std::span<int32_t> v, std::span<float> z)
+    {
+        auto n = static_cast<int32_t>(f.size());
+        auto k = 0;
+        v[0] = 0;
+        z[0] = -std::numeric_limits<float>::infinity();
+        z[1] = std::numeric_limits<float>::infinity();
+        for (auto q = 1; q < n; q++)
+        {
+            auto intersect = [&](int32_t p)
+            {
+                return ((f[q] + static_cast<float>(q * q)) - (f[p] + static_cast<float>(p * p))) / static_cast<float>(2 * q - 2 * p);
+            };
+            auto s = intersect(v[k]);
+            while (s <= z[k])
+            {
+                k--;
+                s = intersect(v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = std::numeric_limits<float>::infinity();
+        }
+
+        k = 0;
+        for (auto q = 0; q < n; q++)
+        {
+            while (z[k + 1] < static_cast<float>(q))
+            {
+                k++;
+            }
+            auto offset = static_cast<float>(q - v[k]);
+            d[q] = offset * offset + f[v[k]];
+        }
+    }
+
+    // Squared Euclidean distance from every pixel to the nearest zero in the grid, in place
+    void TransformDistances2D(std::span<float> grid, uint32_t width, uint32_t height)
+    {
+        auto length = std::max(width, height);
+        std::vector<float> f(length);
+        std::vector<float> d(length);
+        std::vector<int32_t> v(length);
+        std::vector<float> z(length + 1);
+
+        for (auto x = 0u; x < width; x++)
+        {
+            for (auto y = 0u; y < height; y++)
+            {
+                f[y] = grid[y * width + x];
+            }
+            TransformDistances1D({ f.data(), height }, { d.data(), height }, v, z);
+            for (auto y = 0u; y < height; y++)
+            {
+                grid[y * width + x] = d[y];
+            }
+        }
+        for (auto y = 0u; y < height; y++)
+        {
+            std::copy_n(&grid[y * width], width, f.data());
+            TransformDistances1D({ f.data(), width }, { d.data(), width }, v, z);
+            std::copy_n(d.data(), width, &grid[y * width]);
+        }
+    }
+}
+
+struct GlyphAtlas::GlyphBitmap
+{
+    char Character = 0;
+    // Inside where it is at least half covered
+    std::vector<uint8_t> Coverage = {};
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    // Top left corner relative to the pen on the baseline, y pointing down
+    int32_t OffsetX = 0;
+    int32_t OffsetY = 0;
+    float Advance = 0.0f;
+};
+
+std::expected<GlyphAtlas, std::string> GlyphAtlas::CreateFromFont(std::string_view fontFilePath, const GlyphAtlasSettings& settings)
+{
+    auto fileResult = Io::MappedFile::Open(fontFilePath);
+    if (!fileResult)
+    {
+        return std::unexpected(std::format("Unable to load font {}. Details: {}", fontFilePath, fileResult.error()));
+    }
+
+    auto fontData = reinterpret_cast<const unsigned char*>(fileResult->GetData().data());
+    stbtt_fontinfo font;
+    if (stbtt_InitFont(&font, fontData, stbtt_GetFontOffsetForIndex(fontData, 0)) == 0)
+    {
+        return std::unexpected(std::format("Unable to load font {}. Details: Not a TrueType font", fontFilePath));
+    }
+
+    // Ascent to descent spans the line
+    auto lineHeightPixels = static_cast<float>(settings.LineHeightPixels);
+    auto scale = stbtt_ScaleForPixelHeight(&font, lineHeightPixels);
+    int32_t ascent;
+    int32_t descent;
+    int32_t lineGap;
+    stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
+
+    std::vector<GlyphBitmap> glyphBitmaps;
+    for (auto character = ' '; character <= '~'; character++)
+    {
+        auto glyphIndex = stbtt_FindGlyphIndex(&font, character);
+        if (glyphIndex == 0)
+        {
+            continue;
+        }
+
+        int32_t advance;
+        int32_t leftSideBearing;
+        stbtt_GetGlyphHMetrics(&font, glyphIndex, &advance, &leftSideBearing);
+        int32_t x0;
+        int32_t y0;
+        int32_t x1;
+        int32_t y1;
+        stbtt_GetGlyphBitmapBox(&font, glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+        auto& glyphBitmap = glyphBitmaps.emplace_back(GlyphBitmap
+        {
+            .Character = character,
+            .Width = static_cast<uint32_t>(std::max(x1 - x0, 0)),
+            .Height = static_cast<uint32_t>(std::max(y1 - y0, 0)),
+            .OffsetX = x0,
+            .OffsetY = y0,
+            .Advance = static_cast<float>(advance) * scale
+        });
+        glyphBitmap.Coverage.resize(glyphBitmap.Width * glyphBitmap.Height);
+        if (!glyphBitmap.Coverage.empty())
+        {
+            stbtt_MakeGlyphBitmap(
+                &font,
+                glyphBitmap.Coverage.data(),
+                static_cast<int32_t>(glyphBitmap.Width),
+                static_cast<int32_t>(glyphBitmap.Height),
+                static_cast<int32_t>(glyphBitmap.Width),
+                scale,
+                scale,
+                glyphIndex);
+        }
+    }
+
+    return Build(glyphBitmaps, lineHeightPixels, static_cast<float>(ascent) * scale, settings);
+}
+
+GlyphAtlas GlyphAtlas::CreateBuiltIn(const GlyphAtlasSettings& settings)
+{
+    // Each font pixel becomes a block of atlas pixels, enough of them for the distance field to round nothing off
+    auto unitPixels = std::max(settings.LineHeightPixels / static_cast<uint32_t>(BuiltInLineHeight), 1u);
+    auto width = BuiltInGlyphWidth * unitPixels;
+    auto height = BuiltInGlyphHeight * unitPixels;
+
+    std::vector<GlyphBitmap> glyphBitmaps;
+    glyphBitmaps.push_back(GlyphBitmap{ .Character = ' ', .Advance = BuiltInAdvance * static_cast<float>(unitPixels) });
+    for (auto& builtInGlyph : BuiltInGlyphs)
+    {
+        auto& glyphBitmap = glyphBitmaps.emplace_back(GlyphBitmap
+        {
+            .Character = builtInGlyph.Character,
+            .Coverage = std::vector<uint8_t>(width * height),
+            .Width = width,
+            .Height = height,
+            .OffsetX = 0,
+            .OffsetY = -static_cast<int32_t>(height),
+            .Advance = BuiltInAdvance * static_cast<float>(unitPixels)
+        });
+        for (auto y = 0u; y < height; y++)
+        {
+            auto row = builtInGlyph.Rows[y / unitPixels];
+            for (auto x = 0u; x < width; x++)
+            {
+                auto isSet = (row >> (BuiltInGlyphWidth - 1 - x / unitPixels)) & 1u;
+                glyphBitmap.Coverage[y * width + x] = isSet != 0 ? 255 : 0;
+            }
+        }
+    }
+
+    auto atlas = Build(
+        glyphBitmaps,
+        BuiltInLineHeight * static_cast<float>(unitPixels),
+        BuiltInAscent * static_cast<float>(unitPixels),
+        settings);
+    for (auto character = 'a'; character <= 'z'; character++)
+    {
+        atlas._glyphs[static_cast<uint8_t>(character)] = atlas._glyphs[static_cast<uint8_t>(character - 'a' + 'A')];
+    }
+    return atlas;
+}
+
+GlyphAtlas::GlyphAtlas() noexcept = default;
+GlyphAtlas::~GlyphAtlas() = default;
+GlyphAtlas::GlyphAtlas(GlyphAtlas&& other) noexcept = default;
+GlyphAtlas& GlyphAtlas::operator =(GlyphAtlas&& other) noexcept = default;
+
+GlyphAtlas GlyphAtlas::Build(
+    std::span<const GlyphBitmap> glyphBitmaps,
+    float lineHeightPixels,
+    float ascentPixels,
+    const GlyphAtlasSettings& settings)
+{
+    auto spread = settings.SpreadPixels;
+    auto atlasWidth = settings.AtlasWidth;
+
+    // Shelves filled tallest glyph first, every glyph padded by the spread its distance field reaches out
+    std::vector<uint32_t> order(glyphBitmaps.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::ranges::stable_sort(order, std::greater(), [&](uint32_t index) { return glyphBitmaps[index].Height; });
+
+    std::vector<glm::uvec2> cellPositions(glyphBitmaps.size());
+    auto shelfX = 0u;
+    auto shelfY = 0u;
+    auto shelfHeight = 0u;
+    for (auto index : order)
+    {
+        auto& glyphBitmap = glyphBitmaps[index];
+        if (glyphBitmap.Coverage.empty())
+        {
+            continue;
+        }
+
+        auto cellWidth = glyphBitmap.Width + 2 * spread;
+        auto cellHeight = glyphBitmap.Height + 2 * spread;
+        if (shelfX + cellWidth > atlasWidth)
+        {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        cellPositions[index] = glm::uvec2(shelfX, shelfY);
+        shelfX += cellWidth;
+        shelfHeight = std::max(shelfHeight, cellHeight);
+    }
+    auto atlasHeight = std::bit_ceil(std::max(shelfY + shelfHeight, 1u));
+
+    // Far outside everywhere nothing is drawn
+    std::vector<uint8_t> pixels(atlasWidth * atlasHeight, 0);
+    std::vector<float> outsideDistances;
+    std::vector<float> insideDistances;
+    auto atlas = GlyphAtlas();
+    for (auto index = 0u; index < glyphBitmaps.size(); index++)
+    {
+        auto& glyphBitmap = glyphBitmaps[index];
+        auto& glyph = atlas._glyphs[static_cast<uint8_t>(glyphBitmap.Character)];
+        glyph.Advance = glyphBitmap.Advance / lineHeightPixels;
+        if (glyphBitmap.Coverage.empty())
+        {
+            continue;
+        }
+
+        auto cellWidth = glyphBitmap.Width + 2 * spread;
+        auto cellHeight = glyphBitmap.Height + 2 * spread;
+        outsideDistances.assign(cellWidth * cellHeight, 0.0f);
+        insideDistances.assign(cellWidth * cellHeight, FarDistance);
+        for (auto y = 0u; y < glyphBitmap.Height; y++)
+        {
+            for (auto x = 0u; x < glyphBitmap.Width; x++)
+            {
+                if (glyphBitmap.Coverage[y * glyphBitmap.Width + x] >= 128)
+                {
+                    auto cell = (y + spread) * cellWidth + x + spread;
+                    outsideDistances[cell] = FarDistance;
+                    insideDistances[cell] = 0.0f;
+                }
+            }
+        }
+        // Distance to the nearest inside pixel minus the distance to the nearest outside one, which puts the
+        // outline halfway between the two pixels on either side of it
+        TransformDistances2D(insideDistances, cellWidth, cellHeight);
+        TransformDistances2D(outsideDistances, cellWidth, cellHeight);
+
+        auto cellPosition = cellPositions[index];
+        for (auto y = 0u; y < cellHeight; y++)
+        {
+            for (auto x = 0u; x < cellWidth; x++)
+            {
+                auto cell = y * cellWidth + x;
+                auto distance = std::sqrt(insideDistances[cell]) - std::sqrt(outsideDistances[cell]);
+                auto value = std::clamp(0.5f - distance / static_cast<float>(2 * spread), 0.0f, 1.0f);
+                pixels[(cellPosition.y + y) * atlasWidth + cellPosition.x + x] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+        }
+
+        auto atlasSize = glm::vec2(static_cast<float>(atlasWidth), static_cast<float>(atlasHeight));
+        auto cellSize = glm::vec2(static_cast<float>(cellWidth), static_cast<float>(cellHeight));
+        auto cellOffset = glm::vec2(
+            static_cast<float>(glyphBitmap.OffsetX) - static_cast<float>(spread),
+            static_cast<float>(glyphBitmap.OffsetY) - static_cast<float>(spread));
+        glyph.PlaneMin = cellOffset / lineHeightPixels;
+        glyph.PlaneMax = (cellOffset + cellSize) / lineHeightPixels;
+        glyph.UvMin = glm::vec2(cellPosition) / atlasSize;
+        glyph.UvMax = (glm::vec2(cellPosition) + cellSize) / atlasSize;
+    }
+
+    auto fallbackGlyph = atlas._glyphs['?'];
+    for (auto character = 0u; character < atlas._glyphs.size(); character++)
+    {
+        auto isPresent = std::ranges::any_of(glyphBitmaps, [&](const GlyphBitmap& glyphBitmap)
+        {
+            return static_cast<uint8_t>(glyphBitmap.Character) == character;
+        });
+        if (!isPresent)
+        {
+            atlas._glyphs[character] = fallbackGlyph;
+        }
+    }
+
+    atlas._ascent = ascentPixels / lineHeightPixels;
+    atlas._texture = Texture::Create2D("Texture_GlyphAtlas", atlasWidth, atlasHeight, GL_R8);
+    atlas._texture.Write(0, 0, 0, atlasWidth, atlasHeight, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    return atlas;
+}
@@ -0,0 +1,106 @@
+#include <Engine/GpuMemory.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct GpuMemoryRegistry
+    {
+        std::mutex Mutex;
+        std::vector<GpuAllocation> Allocations;
+        // Keyed by resource type and id, values index Allocations
+        std::unordered_map<uint64_t, size_t> AllocationIndices;
+        GpuMemoryTotals Totals;
+    };
+
+    GpuMemoryRegistry& GetGpuMemoryRegistry()
+    {
+        static GpuMemoryRegistry registry;
+        return registry;
+    }
+
+    uint64_t GetAllocationKey(GpuResourceType resourceType, uint32_t id) noexcept
+    {
+        return static_cast<uint64_t>(resourceType) << 32 | id;
+    }
+
+    void AddToTotals(GpuMemoryTotals& totals, const GpuAllocation& allocation, int64_t sign) noexcept
+    {
+        auto byteCount = static_cast<uint64_t>(sign * static_cast<int64_t>(allocation.ByteCount));
+        auto count = static_cast<uint64_t>(sign);
+        if (allocation.ResourceType == GpuResourceType::Buffer)
+        {
+            totals.BufferCount += count;
+            totals.BufferByteCount += byteCount;
+        }
+        else
+        {
+            totals.TextureCount += count;
+            totals.TextureByteCount += byteCount;
+        }
+    }
+}
+
+namespace GpuMemory
+{
+
+void Track(GpuResourceType resourceType, uint32_t id, uint64_t byteCount, uint32_t usage, std::string_view label)
+{
+    GpuAllocation allocation =
+    {
+        .ResourceType = resourceType,
+        .Id = id,
+        .ByteCount = byteCount,
+        .Usage = usage,
+        .LabelLength = static_cast<uint32_t>(std::min(label.size(), GpuAllocation::LabelCapacity)),
+        .Label = {}
+    };
+    std::copy_n(label.begin(), allocation.LabelLength, allocation.Label.begin());
+
+    auto& registry = GetGpuMemoryRegistry();
+    std::scoped_lock lock(registry.Mutex);
+    registry.AllocationIndices[GetAllocationKey(resourceType, id)] = registry.Allocations.size();
+    registry.Allocations.push_back(allocation);
+    AddToTotals(registry.Totals, allocation, 1);
+}
+
+void Untrack(GpuResourceType resourceType, uint32_t id)
+{
+    auto& registry = GetGpuMemoryRegistry();
+    std::scoped_lock lock(registry.Mutex);
+    auto allocationIndex = registry.AllocationIndices.find(GetAllocationKey(resourceType, id));
+    if (allocationIndex == registry.AllocationIndices.end())
+    {
+        return;
+    }
+
+    auto index = allocationIndex->second;
+    registry.AllocationIndices.erase(allocationIndex);
+    AddToTotals(registry.Totals, registry.Allocations[index], -1);
+
+    registry.Allocations[index] = registry.Allocations.back();
+    registry.Allocations.pop_back();
+    if (index < registry.Allocations.size())
+    {
+        auto& moved = registry.Allocations[index];
+        registry.AllocationIndices[GetAllocationKey(moved.ResourceType, moved.Id)] = index;
+    }
+}
+
+GpuMemoryTotals GetTotals()
+{
+    auto& registry = GetGpuMemoryRegistry();
+    std::scoped_lock lock(registry.Mutex);
+    return registry.Totals;
+}
+
+void CopyAllocations(std::pmr::vector<GpuAllocation>& allocations)
+{
+    auto& registry = GetGpuMemoryRegistry();
+    std::scoped_lock lock(registry.Mutex);
+    allocations.assign(registry.Allocations.begin(), registry.Allocations.end());
+}
+
+}
@@ -0,0 +1,49 @@
+#include <Engine/GpuTimer.hpp>
+
+#include <glad/glad.h>
+
+GpuTimer::GpuTimer()
+{
+    glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(_queries.size()), _queries.data());
+}
+
+GpuTimer::~GpuTimer()
+{
+    glDeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+}
+
+void GpuTimer::Begin()
+{
+    // Only waits when the GPU is more than LatencyFrameCount measurements behind
+    CollectResults(_pendingMeasurementCount == LatencyFrameCount);
+    glQueryCounter(_queries[_nextMeasurement * 2], GL_TIMESTAMP);
+}
+
+void GpuTimer::End()
+{
+    glQueryCounter(_queries[_nextMeasurement * 2 + 1], GL_TIMESTAMP);
+    _nextMeasurement = (_nextMeasurement + 1) % LatencyFrameCount;
+    _pendingMeasurementCount++;
+}
+
+void GpuTimer::CollectResults(bool isWaiting)
+{
+    while (_pendingMeasurementCount > 0)
+    {
+        auto measurement = (_nextMeasurement + LatencyFrameCount - _pendingMeasurementCount) % LatencyFrameCount;
+        auto isAvailable = GLint(GL_FALSE);
+        glGetQueryObjectiv(_queries[measurement * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_FALSE && !isWaiting)
+        {
+            return;
+        }
+
+        auto beginTime = GLuint64(0);
+        auto endTime = GLuint64(0);
+        glGetQueryObjectui64v(_queries[measurement * 2], GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(_queries[measurement * 2 + 1], GL_QUERY_RESULT, &endTime);
+        _milliseconds = static_cast<double>(endTime - beginTime) / 1.0e6;
+        _pendingMeasurementCount--;
+        isWaiting = false;
+    }
+}
@@ -1,8 +1,19 @@
 #include <Engine/GraphicsPipeline.hpp>
 #include <Engine/Buffer.hpp>
+#include <Engine/RenderStatistics.hpp>
 
 #include <glad/glad.h>
 
+namespace
+{
+    void CountDraw(uint32_t instanceCount) noexcept
+    {
+        auto& renderStatistics = GetRenderStatistics();
+        renderStatistics.DrawCallCount++;
+        renderStatistics.InstanceCount += instanceCount;
+    }
+}
+
 GraphicsPipeline::~GraphicsPipeline()
 {
     if (_vertexShader != 0u)
@@ -24,11 +35,13 @@ void GraphicsPipeline::UseVertexBufferBinding(
     uint32_t offset,
     uint32_t stride)
 {
+    GetRenderStatistics().BindingChangeCount++;
     glVertexArrayVertexBuffer(_inputLayout, bindingIndex, vertexBuffer->_id, offset, stride);
 }
 
 void GraphicsPipeline::UseIndexBufferBinding(const Buffer* indexBuffer)
 {
+    GetRenderStatistics().BindingChangeCount++;
     glVertexArrayElementBuffer(_inputLayout, indexBuffer->_id);
 }
 
@@ -38,10 +51,16 @@ void GraphicsPipeline::Use()
     glBindVertexArray(_inputLayout);
 }
 
+void GraphicsPipeline::SetFragmentUniform(int32_t location, float value)
+{
+    glProgramUniform1f(_fragmentShader, location, value);
+}
+
 void GraphicsPipeline::DrawArrays(
     uint32_t elementCount,
     uint32_t elementOffset)
 {
+    CountDraw(1);
     glDrawArrays(_primitiveTopology, elementOffset, elementCount);
 }
 
@@ -49,5 +68,54 @@ void GraphicsPipeline::DrawElements(
     uint32_t elementCount,
     uint32_t offsetInBytes)
 {
+    CountDraw(1);
     glDrawElements(_primitiveTopology, elementCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(offsetInBytes));
 }
+
+void GraphicsPipeline::DrawArraysInstanced(
+    uint32_t elementCount,
+    uint32_t instanceCount,
+    uint32_t elementOffset,
+    uint32_t baseInstance)
+{
+    CountDraw(instanceCount);
+    glDrawArraysInstancedBaseInstance(_primitiveTopology, elementOffset, elementCount, instanceCount, baseInstance);
+}
+
+void GraphicsPipeline::DrawElementsInstancedBaseVertexBaseInstance(
+    uint32_t elementCount,
+    uint32_t instanceCount,
+    uint32_t offsetInBytes,
+    int32_t baseVertex,
+    uint32_t baseInstance)
+{
+    CountDraw(instanceCount);
+    glDrawElementsInstancedBaseVertexBaseInstance(
+        _primitiveTopology,
+        elementCount,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<void*>(static_cast<uintptr_t>(offsetInBytes)),
+        instanceCount,
+        baseVertex,
+        baseInstance);
+}
+
+void GraphicsPipeline::DrawArraysIndirect(
+    const Buffer& indirectBuffer,
+    uint64_t offsetInBytes)
+{
+    // The instance count is only known to the GPU
+    CountDraw(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer._id);
+    glDrawArraysIndirect(_primitiveTopology, reinterpret_cast<void*>(static_cast<uintptr_t>(offsetInBytes)));
+}
+
+void GraphicsPipeline::MultiDrawArraysIndirect(
+    const Buffer& indirectBuffer,
+    uint32_t drawCount,
+    uint64_t offsetInBytes)
+{
+    CountDraw(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer._id);
+    glMultiDrawArraysIndirect(_primitiveTopology, reinterpret_cast<void*>(static_cast<uintptr_t>(offsetInBytes)), static_cast<GLsizei>(drawCount), 0);
+}
@@ -0,0 +1,66 @@
+#include <Engine/HiZPyramid.hpp>
+#include <Engine/ComputePipeline.hpp>
+#include <Engine/ComputePipelineBuilder.hpp>
+#include <Engine/Device.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <bit>
+#include <format>
+
+namespace
+{
+    // Uniform locations in the build shader
+    constexpr int32_t SourceLevelLocation = 0;
+    constexpr int32_t IsCopyLocation = 1;
+}
+
+std::expected<HiZPyramid, std::string> HiZPyramid::Create(Device& device, std::string_view buildShaderFilePath)
+{
+    auto buildPipelineResult = device.CreateComputePipelineBuilder("HiZBuild")
+        .WithShader(buildShaderFilePath)
+        .Build();
+    if (!buildPipelineResult)
+    {
+        return std::unexpected(std::format("Unable to create depth pyramid. Details: {}", buildPipelineResult.error()));
+    }
+
+    auto pyramid = HiZPyramid();
+    pyramid._buildPipeline = std::move(buildPipelineResult.value());
+    return pyramid;
+}
+
+HiZPyramid::HiZPyramid() noexcept = default;
+HiZPyramid::~HiZPyramid() = default;
+HiZPyramid::HiZPyramid(HiZPyramid&& other) noexcept = default;
+HiZPyramid& HiZPyramid::operator =(HiZPyramid&& other) noexcept = default;
+
+void HiZPyramid::Build(const Texture& depth)
+{
+    if (_texture.GetWidth() != depth.GetWidth() || _texture.GetHeight() != depth.GetHeight())
+    {
+        _levelCount = std::bit_width(std::max(depth.GetWidth(), depth.GetHeight()));
+        _texture = Texture::Create2D("Texture_HiZPyramid", depth.GetWidth(), depth.GetHeight(), GL_R32F, _levelCount);
+        _texture.SetFilter(GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST);
+    }
+
+    // Level 0 copies the depth, every further level reduces the one above it, which sampling reads while
+    // the image writes, legal as long as they are different levels
+    _buildPipeline->Use();
+    for (auto level = 0u; level < _levelCount; level++)
+    {
+        auto isCopy = level == 0;
+        _buildPipeline->BindTexture(isCopy ? depth : _texture, 0);
+        _buildPipeline->BindImage(_texture, 0, level, GL_WRITE_ONLY, GL_R32F);
+        _buildPipeline->SetUniform(SourceLevelLocation, isCopy ? 0u : level - 1);
+        _buildPipeline->SetUniform(IsCopyLocation, isCopy ? 1u : 0u);
+
+        auto levelWidth = std::max(depth.GetWidth() >> level, 1u);
+        auto levelHeight = std::max(depth.GetHeight() >> level, 1u);
+        _buildPipeline->Dispatch((levelWidth + GroupSize - 1) / GroupSize, (levelHeight + GroupSize - 1) / GroupSize);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    _isValid = true;
+}
@@ -0,0 +1,186 @@
+#include <Engine/HudRenderer.hpp>
+#include <Engine/Device.hpp>
+#include <Engine/GraphicsPipeline.hpp>
+#include <Engine/GraphicsPipelineBuilder.hpp>
+#include <Engine/PrimitiveTopology.hpp>
+#include <Engine/VertexPulling.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace
+{
+    // The glyph atlas is sampled from this texture unit
+    constexpr uint32_t GlyphAtlasUnit = 0;
+
+    uint32_t PackColor(const glm::vec4& color) noexcept
+    {
+        auto pack = [](float channel, uint32_t shift)
+        {
+            return static_cast<uint32_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f) << shift;
+        };
+        return pack(color.x, 0) | pack(color.y, 8) | pack(color.z, 16) | pack(color.w, 24);
+    }
+}
+
+std::expected<HudRenderer, std::string> HudRenderer::Create(
+    Device& device,
+    std::string_view vertexShaderFilePath,
+    std::string_view fragmentShaderFilePath,
+    GlyphAtlas&& glyphAtlas,
+    const HudRendererSettings& settings)
+{
+    auto pipelineResult = device.CreateGraphicsPipelineBuilder("Hud")
+        .WithShaders(vertexShaderFilePath, fragmentShaderFilePath)
+        .WithPrimitiveTopology(PrimitiveTopology::Triangles)
+        .Build();
+    if (!pipelineResult)
+    {
+        return std::unexpected(std::format("Unable to create HUD renderer. Details: {}", pipelineResult.error()));
+    }
+
+    auto hudRenderer = HudRenderer();
+    hudRenderer._pipeline = std::move(pipelineResult.value());
+    hudRenderer._glyphAtlas = std::move(glyphAtlas);
+    hudRenderer._settings = settings;
+    hudRenderer._quadBuffer = Buffer::Create(
+        "Buffer_HudQuads",
+        sizeof(Quad) * settings.MaxQuadCount * settings.FrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true);
+    hudRenderer._uniformBuffer = Buffer::Create("Buffer_Uniforms_Hud", sizeof(HudUniforms), GL_UNIFORM_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    return hudRenderer;
+}
+
+HudRenderer::HudRenderer() noexcept = default;
+HudRenderer::~HudRenderer() = default;
+HudRenderer::HudRenderer(HudRenderer&& other) noexcept = default;
+HudRenderer& HudRenderer::operator =(HudRenderer&& other) noexcept = default;
+
+void HudRenderer::Begin(uint32_t frame, uint32_t viewportWidth, uint32_t viewportHeight)
+{
+    _frame = frame % _settings.FrameCount;
+    _quads = static_cast<Quad*>(_quadBuffer.GetMappedMemory()) + _frame * _settings.MaxQuadCount;
+    _viewportSize = glm::vec2(static_cast<float>(std::max(viewportWidth, 1u)), static_cast<float>(std::max(viewportHeight, 1u)));
+    _statistics = {};
+}
+
+void HudRenderer::AddRectangle(glm::vec2 position, glm::vec2 size, const glm::vec4& color)
+{
+    AddQuad(Quad
+    {
+        .Position = position,
+        .Size = size,
+        .Color = PackColor(color),
+        .Kind = QuadKind::Rectangle
+    });
+}
+
+void HudRenderer::AddRing(glm::vec2 center, float radius, float thickness, const glm::vec4& color)
+{
+    // One pixel of margin keeps the antialiased edge inside the quad
+    auto extent = radius + 1.0f;
+    AddQuad(Quad
+    {
+        .Position = center - glm::vec2(extent),
+        .Size = glm::vec2(2.0f * extent),
+        .Color = PackColor(color),
+        .Kind = QuadKind::Ring,
+        .InnerRadius = std::max(radius - thickness, 0.0f) / extent,
+        .OuterRadius = radius / extent
+    });
+}
+
+float HudRenderer::AddText(std::string_view text, glm::vec2 position, float size, const glm::vec4& color)
+{
+    auto packedColor = PackColor(color);
+    auto baseline = position + glm::vec2(0.0f, _glyphAtlas.GetAscent() * size);
+    auto pen = baseline;
+    auto width = 0.0f;
+    for (auto character : text)
+    {
+        if (character == '\n')
+        {
+            pen = glm::vec2(baseline.x, pen.y + size);
+            continue;
+        }
+
+        auto& glyph = _glyphAtlas.GetGlyph(character);
+        if (glyph.PlaneMax.x > glyph.PlaneMin.x)
+        {
+            auto isAdded = AddQuad(Quad
+            {
+                .Position = pen + glyph.PlaneMin * size,
+                .Size = (glyph.PlaneMax - glyph.PlaneMin) * size,
+                .UvMin = glyph.UvMin,
+                .UvMax = glyph.UvMax,
+                .Color = packedColor,
+                .Kind = QuadKind::Glyph
+            });
+            _statistics.GlyphCount += isAdded ? 1 : 0;
+        }
+        pen.x += glyph.Advance * size;
+        width = std::max(width, pen.x - baseline.x);
+    }
+    return width;
+}
+
+float HudRenderer::MeasureText(std::string_view text, float size) const noexcept
+{
+    auto lineWidth = 0.0f;
+    auto width = 0.0f;
+    for (auto character : text)
+    {
+        lineWidth = character == '\n' ? 0.0f : lineWidth + _glyphAtlas.GetGlyph(character).Advance * size;
+        width = std::max(width, lineWidth);
+    }
+    return width;
+}
+
+void HudRenderer::Draw()
+{
+    if (_statistics.QuadCount == 0)
+    {
+        return;
+    }
+
+    HudUniforms uniforms =
+    {
+        .ViewportSize = glm::vec4(_viewportSize.x, _viewportSize.y, 1.0f / _viewportSize.x, 1.0f / _viewportSize.y)
+    };
+    _uniformBuffer.Write(&uniforms, sizeof(HudUniforms), 0);
+
+    // Quads are drawn in the order they were added, premultiplied over the scene
+    auto isDepthTestEnabled = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    _pipeline->Use();
+    _pipeline->BindAsUniformBuffer(_uniformBuffer, HudUniformBinding, 0, sizeof(HudUniforms));
+    _pipeline->BindAsShaderStorageBuffer(_quadBuffer, VertexPullingVertexBufferBinding, 0, _quadBuffer.GetSize());
+    _pipeline->BindTexture(_glyphAtlas.GetTexture(), GlyphAtlasUnit);
+    // Six vertices per quad, the shaders find the quad through gl_BaseInstance
+    _pipeline->DrawArraysInstanced(6, _statistics.QuadCount, 0, _frame * _settings.MaxQuadCount);
+
+    glDisable(GL_BLEND);
+    if (isDepthTestEnabled)
+    {
+        glEnable(GL_DEPTH_TEST);
+    }
+}
+
+bool HudRenderer::AddQuad(const Quad& quad)
+{
+    if (_statistics.QuadCount == _settings.MaxQuadCount)
+    {
+        _statistics.DroppedQuadCount++;
+        return false;
+    }
+    _quads[_statistics.QuadCount++] = quad;
+    return true;
+}
@@ -1,16 +1,67 @@
 #pragma once
 
+#include <EngineCore/Memory.hpp>
+
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <expected>
 
 struct GLFWwindow;
+class DebugMessageFilter;
+class DebugOverlay;
 class Device;
+class DynamicResolution;
+class GpuTimer;
+class RenderGraph;
+class ResourceLoader;
+
+// How much the GL driver is asked to check and report
+enum class DiagnosticsLevel
+{
+    // No debug context, the driver validates nothing beyond what it must
+    Production,
+    // Debug context with asynchronous output, repeated messages are deduplicated and rate limited
+    Development,
+    // Synchronous output reporting every message on the offending call, breaks into the debugger on errors
+    Validation
+};
+
+#ifdef NDEBUG
+constexpr DiagnosticsLevel DefaultDiagnosticsLevel = DiagnosticsLevel::Production;
+#else
+constexpr DiagnosticsLevel DefaultDiagnosticsLevel = DiagnosticsLevel::Development;
+#endif
+
+// "production", "development" or "validation"
+std::optional<DiagnosticsLevel> ParseDiagnosticsLevel(std::string_view name) noexcept;
+
+struct ApplicationSettings
+{
+    DiagnosticsLevel Diagnostics = DefaultDiagnosticsLevel;
+    // Create and fill GPU resources on a loader thread with a shared context, off where that is slow
+    bool UseResourceLoaderContext = true;
+    // Bin dynamic lights into clusters with a compute pass, or on the CPU where that is missing or broken
+    bool UseGpuLightBinning = true;
+    // Scale the 3D scene's resolution to keep GPU frame times within the budget
+    bool UseDynamicResolution = true;
+    double FrameBudgetMilliseconds = 14.0;
+    // Renders a frame without occlusion culling now and then to log what culling saves, off as it is a GPU spike
+    bool UseOcclusionReferenceFrames = false;
+    // Fills the HUD with this many extra glyphs every frame to measure what text costs, none when zero
+    uint32_t HudBenchmarkGlyphCount = 0;
+    // Packed catalog written by --convert-star-catalog, no stars are drawn when it is missing
+    std::string StarCatalogFilePath = "Data/Stars.bin";
+    // Writes and loads a synthetic catalog of this many stars instead, to measure load and frame times
+    uint64_t StarBenchmarkCount = 0;
+};
 
 class Application
 {
 public:
+    explicit Application(const ApplicationSettings& settings = {});
     virtual ~Application();
 
     void Run();
@@ -33,7 +84,61 @@ protected:
         int32_t modifiers,
         int32_t scancode);
 
-    virtual void OnOpenGLDebugMessage(uint32_t messageType, std::string_view debugMessage);
+    // Called on a driver thread under DiagnosticsLevel::Development, so overrides have to be thread safe
+    virtual void OnOpenGLDebugMessage(uint32_t messageType, uint32_t severity, std::string_view debugMessage);
+
+    DiagnosticsLevel GetDiagnosticsLevel() const noexcept
+    {
+        return _settings.Diagnostics;
+    }
+
+    const ApplicationSettings& GetSettings() const noexcept
+    {
+        return _settings;
+    }
+
+    // Completions of background uploads run at the start of every frame, before Update
+    ResourceLoader& GetResourceLoader() noexcept
+    {
+        return *_resourceLoader;
+    }
+
+    // Follows the framebuffer size, its framebuffer relative textures are reallocated by the first frame after a resize
+    RenderGraph& GetRenderGraph() noexcept
+    {
+        return *_renderGraph;
+    }
+
+    // Picks the render graph's render scale before every frame, its scale and budget can be read and changed
+    DynamicResolution& GetDynamicResolution() noexcept
+    {
+        return *_dynamicResolution;
+    }
+
+    // Memory for whatever lives no longer than the current frame, reset after the buffers are swapped
+    LinearArena& GetFrameArena() noexcept
+    {
+        return _frameArena;
+    }
+
+    // Called from Update, leaves the current frame out of the GPU frame time dynamic resolution follows.
+    // For frames that are deliberately not representative.
+    void SkipFrameGpuTiming() noexcept
+    {
+        _isFrameGpuTimed = false;
+    }
+
+    // Wall clock seconds since the previous frame started, zero for the first
+    float GetFrameDeltaSeconds() const noexcept
+    {
+        return _frameDeltaSeconds;
+    }
+
+    // Heap allocations made during the last completed frame
+    uint64_t GetFrameHeapAllocationCount() const noexcept
+    {
+        return _frameHeapAllocationCount;
+    }
 
     int32_t framebufferWidth = 0;
     int32_t framebufferHeight = 0;
@@ -45,6 +150,20 @@ private:
 
     GLFWwindow* _windowHandle = nullptr;
     bool _isFullscreen = false;
+    ApplicationSettings _settings;
+    // Only under DiagnosticsLevel::Development
+    std::unique_ptr<DebugMessageFilter> _debugMessageFilter;
+    LinearArena _frameArena;
+    uint64_t _frameHeapAllocationCount = 0;
+    float _frameDeltaSeconds = 0.0f;
+    std::unique_ptr<GpuTimer> _frameGpuTimer;
+    bool _isFrameGpuTimed = true;
+    // Toggled with F3
+    std::unique_ptr<DebugOverlay> _debugOverlay;
+    std::unique_ptr<ResourceLoader> _resourceLoader;
+    std::unique_ptr<RenderGraph> _renderGraph;
+    std::unique_ptr<DynamicResolution> _dynamicResolution;
 
+    void InitializeDebugOutput();
     void ToggleFullscreen();
 };
\ No newline at end of file
@@ -9,12 +9,15 @@ class Pipeline;
 class Buffer
 {
 public:
+    // Starts out as data when given, which the driver reads straight from wherever it lives, mappings included.
+    // Mapped buffers need storage with GL_MAP_READ_BIT or GL_MAP_WRITE_BIT, they map with the storage's map bits
     static Buffer Create(
         std::string_view label,
         uint32_t size,
         uint32_t type,
         uint32_t storage,
-        bool isMapped = false) noexcept;
+        bool isMapped = false,
+        const void* data = nullptr) noexcept;
 
     Buffer() noexcept = default;
     ~Buffer();
@@ -27,10 +30,23 @@ public:
     void Swap(Buffer& other) noexcept;
 
     void Write(const void* data, uint64_t size, uint64_t offset) const noexcept;
+    // Copies on the GPU, ordered with the draws and dispatches around it
+    void CopyTo(const Buffer& destination, uint64_t size, uint64_t sourceOffset, uint64_t destinationOffset) const noexcept;
+
+    void* GetMappedMemory() const noexcept
+    {
+        return _mappedMemory;
+    }
+
+    uint32_t GetSize() const noexcept
+    {
+        return _size;
+    }
 
 private:
     friend class Pipeline;
     friend class GraphicsPipeline;
+    friend class StagingUploader;
 
     uint32_t _id = 0;
     uint32_t _size = 0;
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ComputePipeline;
+class Device;
+class Pipeline;
+class TaskScheduler;
+
+// Binding points the lit shaders read clusters and lights from
+constexpr uint32_t ClusteredLightingUniformBinding = 2;
+constexpr uint32_t ClusteredLightingLightBufferBinding = 4;
+constexpr uint32_t ClusteredLightingClusterBufferBinding = 5;
+constexpr uint32_t ClusteredLightingLightIndexBufferBinding = 6;
+
+// Matches struct PointLight in the lit shaders (std430). Positioned relative to the camera like
+// everything else rendered, the color is premultiplied by the intensity
+struct PointLight
+{
+    glm::vec3 Position;
+    float Radius;
+    glm::vec3 Color;
+    float Padding;
+};
+
+struct ClusteredLightingSettings
+{
+    uint32_t MaxLightCount = 4096;
+    // Light indices across all clusters, clusters past it go without lights for the frame
+    uint32_t MaxLightIndexCount = 1u << 20;
+    // Bins on the CPU when false, for drivers where the compute pass misbehaves and for comparing both
+    bool UseGpuBinning = true;
+};
+
+struct ClusteredLightingStatistics
+{
+    uint32_t LightCount = 0;
+    // Only known when binning on the CPU
+    uint32_t LightIndexCount = 0;
+    uint32_t MaxClusterLightCount = 0;
+};
+
+// Clustered forward shading. The view frustum is cut into tiles on screen and exponential slices in depth,
+// each froxel gets the compact list of lights whose sphere touches it, and fragment shaders loop over
+// their froxel's list only, which keeps shading cost bound by local light density instead of light count.
+class ClusteredLighting
+{
+public:
+    static constexpr uint32_t ClusterCountX = 16;
+    static constexpr uint32_t ClusterCountY = 9;
+    static constexpr uint32_t ClusterCountZ = 24;
+    static constexpr uint32_t ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+    // A froxel's list is gathered in shared memory by the binning shader, lights past it are dropped
+    static constexpr uint32_t MaxClusterLightCount = 256;
+
+    static std::expected<ClusteredLighting, std::string> Create(
+        Device& device,
+        std::string_view binningShaderFilePath,
+        const ClusteredLightingSettings& settings,
+        TaskScheduler* taskScheduler = nullptr);
+
+    ClusteredLighting() noexcept;
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) noexcept = delete;
+    ClusteredLighting& operator =(const ClusteredLighting&) noexcept = delete;
+    ClusteredLighting(ClusteredLighting&& other) noexcept;
+    ClusteredLighting& operator =(ClusteredLighting&& other) noexcept;
+
+    // Froxel bounds only change with the projection and viewport, they are rebuilt when either did
+    void SetView(
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        float nearPlane,
+        float farPlane,
+        uint32_t viewportWidth,
+        uint32_t viewportHeight);
+    // Uploads the lights and bins them, lights past MaxLightCount are ignored
+    void Update(std::span<const PointLight> lights);
+    // Binds what the lit shaders read, the binding points above
+    void Bind(Pipeline& pipeline) const;
+
+    const ClusteredLightingStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+private:
+    static constexpr uint32_t BinningGroupSize = 64;
+
+    // Matches the ClusterUniforms block in the lit and binning shaders (std140)
+    struct ClusterUniforms
+    {
+        glm::mat4 View;
+        // x, y and z cluster counts, light count
+        glm::uvec4 GridSize;
+        // Slice = log(depth) * x + y
+        glm::vec4 DepthSlicing;
+        // Pixels per tile in xy
+        glm::vec4 TileSize;
+        // Light index capacity, per cluster capacity
+        glm::uvec4 Capacities;
+    };
+
+    // View space box of a froxel (std430)
+    struct ClusterBounds
+    {
+        glm::vec4 Min;
+        glm::vec4 Max;
+    };
+
+    void ComputeClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane);
+    void BinOnCpu(std::span<const PointLight> lights);
+
+    std::unique_ptr<ComputePipeline> _binningPipeline;
+    TaskScheduler* _taskScheduler = nullptr;
+    ClusteredLightingSettings _settings = {};
+    ClusteredLightingStatistics _statistics;
+
+    ClusterUniforms _uniforms = {};
+    glm::mat4 _projection = {};
+    std::vector<ClusterBounds> _clusterBounds;
+
+    Buffer _uniformBuffer;
+    Buffer _lightBuffer;
+    // Offset and count into the light indices per cluster
+    Buffer _clusterBuffer;
+    Buffer _lightIndexBuffer;
+    // The binning shader's index allocator followed by the cluster bounds
+    Buffer _binningBuffer;
+
+    // CPU binning, per cluster lists keep their capacity from frame to frame
+    std::vector<glm::vec4> _viewLights;
+    std::vector<std::vector<uint32_t>> _clusterLightLists;
+    std::vector<glm::uvec2> _clusterRanges;
+    std::vector<uint32_t> _lightIndices;
+};
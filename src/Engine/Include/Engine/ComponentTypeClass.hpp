@@ -1,8 +0,0 @@
-#pragma once
-
-enum class ComponentTypeClass
-{
-    Integer,
-    Long,
-    Float
-};
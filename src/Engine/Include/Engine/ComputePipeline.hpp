@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Engine/Pipeline.hpp>
+
+class ComputePipeline : public Pipeline
+{
+public:
+    ComputePipeline() : Pipeline()
+    {
+    }
+
+    ~ComputePipeline() override;
+
+    ComputePipeline(ComputePipeline&& other) noexcept
+        : Pipeline()
+    {
+        swap(*this, other);
+    }
+
+    ComputePipeline& operator=(ComputePipeline other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(ComputePipeline& lhs, ComputePipeline& rhs) noexcept
+    {
+        using std::swap;
+        swap(static_cast<Pipeline&>(lhs), static_cast<Pipeline&>(rhs));
+        swap(lhs._computeShader, rhs._computeShader);
+    }
+
+    void SetUniform(int32_t location, uint32_t value);
+
+    void Dispatch(
+        uint32_t groupCountX,
+        uint32_t groupCountY = 1,
+        uint32_t groupCountZ = 1);
+
+private:
+    friend class ComputePipelineBuilder;
+
+    uint32_t _computeShader = {};
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class ComputePipeline;
+
+class ComputePipelineBuilder
+{
+public:
+    ComputePipelineBuilder(std::string_view label);
+
+    ComputePipelineBuilder& WithShader(std::string_view computeShaderFilePath);
+
+    std::expected<std::unique_ptr<ComputePipeline>, std::string> Build();
+
+private:
+    std::string_view _label;
+    std::string_view _computeShaderFilePath;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Lines, boxes, spheres and frustums from anywhere in the code, any thread included. Positions are in the
+// space the scene is rendered in, colors are sRGB. Every thread appends to a buffer of its own, once per
+// frame DebugDrawRenderer gathers them all and draws them with one call. Shipping builds (ENGINE_SHIPPING)
+// compile every call into nothing.
+enum class DebugDrawMode : uint8_t
+{
+    DepthTested,
+    // Over everything, for what must not get lost behind geometry
+    Overlay
+};
+
+#ifdef ENGINE_SHIPPING
+
+namespace DebugDraw
+{
+    inline void Line(const glm::vec3&, const glm::vec3&, const glm::vec4&, DebugDrawMode = DebugDrawMode::DepthTested) noexcept {}
+    inline void Box(const glm::vec3&, const glm::vec3&, const glm::vec4&, DebugDrawMode = DebugDrawMode::DepthTested) noexcept {}
+    inline void Box(const glm::mat4&, const glm::vec4&, DebugDrawMode = DebugDrawMode::DepthTested) noexcept {}
+    inline void Sphere(const glm::vec3&, float, const glm::vec4&, DebugDrawMode = DebugDrawMode::DepthTested) noexcept {}
+    inline void Frustum(const glm::mat4&, const glm::vec4&, DebugDrawMode = DebugDrawMode::DepthTested) noexcept {}
+}
+
+#else
+
+#include <Engine/Buffer.hpp>
+
+class Device;
+class GraphicsPipeline;
+
+// Binding point of the DebugDrawUniforms block, the vertices are pulled from VertexPullingVertexBufferBinding
+constexpr uint32_t DebugDrawUniformBinding = 4;
+
+namespace DebugDraw
+{
+    void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+    // Axis aligned
+    void Box(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+    // The cube from -1 to 1 through transform, divided by w, so projective transforms work too
+    void Box(const glm::mat4& transform, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+    // Three great circles
+    void Sphere(const glm::vec3& center, float radius, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+    // Of the camera with this view projection
+    void Frustum(const glm::mat4& viewProjection, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+}
+
+struct DebugDrawSettings
+{
+    // Vertices per frame, lines past it are dropped and counted
+    uint32_t MaxVertexCount = 1u << 18;
+    // The caller's fences must keep the GPU FrameCount - 1 frames behind at most
+    uint32_t FrameCount = 3;
+};
+
+struct DebugDrawStatistics
+{
+    uint32_t LineCount = 0;
+    uint32_t OverlayLineCount = 0;
+    uint32_t DroppedLineCount = 0;
+    uint32_t ThreadCount = 0;
+};
+
+// Draws what every thread added since the last Draw, into the bound framebuffer and against its depth
+class DebugDrawRenderer
+{
+public:
+    static std::expected<DebugDrawRenderer, std::string> Create(
+        Device& device,
+        std::string_view vertexShaderFilePath,
+        std::string_view fragmentShaderFilePath,
+        const DebugDrawSettings& settings = {});
+
+    DebugDrawRenderer() noexcept;
+    ~DebugDrawRenderer();
+
+    DebugDrawRenderer(const DebugDrawRenderer&) noexcept = delete;
+    DebugDrawRenderer& operator =(const DebugDrawRenderer&) noexcept = delete;
+    DebugDrawRenderer(DebugDrawRenderer&& other) noexcept;
+    DebugDrawRenderer& operator =(DebugDrawRenderer&& other) noexcept;
+
+    // The GPU must be done with the frame's previous use. Lines added while this runs go into the next frame
+    void Draw(uint32_t frame, const glm::mat4& viewProjection);
+    // Throws away what was added, for frames that do not draw it
+    void Discard();
+
+    const DebugDrawStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+private:
+    // Matches the DebugDrawUniforms block in the debug draw shaders (std140)
+    struct DebugDrawUniforms
+    {
+        glm::mat4 ViewProjection;
+        // First overlay vertex, relative to the frame's first vertex
+        glm::uvec4 OverlayFirstVertex;
+    };
+
+    std::unique_ptr<GraphicsPipeline> _pipeline;
+    DebugDrawSettings _settings = {};
+    DebugDrawStatistics _statistics;
+
+    Buffer _vertexBuffer;
+    Buffer _uniformBuffer;
+};
+
+#endif
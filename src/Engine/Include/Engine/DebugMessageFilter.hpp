@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Decides which GL debug messages are worth logging. A message id is logged the first time it shows
+// up and again whenever its repeat count reaches a power of two, and no more than MaxMessagesPerSecond
+// get through in total. Lock free, asynchronous debug output calls it from the driver's own threads.
+class DebugMessageFilter
+{
+public:
+    static constexpr uint32_t MaxMessagesPerSecond = 32;
+
+    // How often this message was seen including now, 0 when it should not be logged
+    uint32_t Accept(uint32_t source, uint32_t type, uint32_t id) noexcept;
+
+    // Messages held back so far, by either the deduplication or the rate limit
+    uint64_t GetSuppressedCount() const noexcept
+    {
+        return _suppressedCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t SlotCountLog2 = 10;
+
+    struct Slot
+    {
+        // Source, type and id packed together, 0 while the slot is free
+        std::atomic<uint64_t> Key = 0;
+        std::atomic<uint32_t> Count = 0;
+    };
+
+    std::atomic<uint32_t>* FindCount(uint64_t key) noexcept;
+
+    std::array<Slot, 1u << SlotCountLog2> _slots;
+    std::atomic<int64_t> _rateSecond = -1;
+    std::atomic<uint32_t> _rateSecondCount = 0;
+    std::atomic<uint64_t> _suppressedCount = 0;
+};
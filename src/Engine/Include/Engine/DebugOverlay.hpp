@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Engine/GpuTimer.hpp>
+#include <Engine/RenderStatistics.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+struct GLFWwindow;
+
+struct DebugOverlayFrame
+{
+    double CpuMilliseconds = 0.0;
+    std::optional<double> GpuMilliseconds;
+    RenderStatistics Render;
+    float RenderScale = 1.0f;
+    double BudgetMilliseconds = 0.0;
+    uint64_t HeapAllocationCount = 0;
+    uint64_t FrameArenaPeakByteCount = 0;
+};
+
+// Frame times, draw and state change counts, CPU memory by tag and GPU memory by resource, drawn
+// with Dear ImGui. Frames are recorded while hidden too, so the graphs are filled when it opens.
+class DebugOverlay
+{
+public:
+    explicit DebugOverlay(GLFWwindow* windowHandle);
+    ~DebugOverlay();
+
+    DebugOverlay(const DebugOverlay&) = delete;
+    DebugOverlay& operator=(const DebugOverlay&) = delete;
+
+    void ToggleVisible() noexcept
+    {
+        _isVisible = !_isVisible;
+    }
+
+    bool IsVisible() const noexcept
+    {
+        return _isVisible;
+    }
+
+    void RecordFrame(const DebugOverlayFrame& frame) noexcept;
+    // Draws into the bound framebuffer, only while visible
+    void Render();
+
+private:
+    static constexpr uint32_t FrameHistoryCount = 240;
+
+    void DrawStatistics();
+    void DrawMemory();
+
+    bool _isVisible = false;
+    DebugOverlayFrame _frame;
+    std::array<float, FrameHistoryCount> _cpuFrameMilliseconds = {};
+    std::array<float, FrameHistoryCount> _gpuFrameMilliseconds = {};
+    uint32_t _nextFrame = 0;
+
+    // What the overlay costs itself, shown in the overlay
+    GpuTimer _overlayGpuTimer;
+    double _overlayCpuMilliseconds = 0.0;
+};
@@ -6,6 +6,7 @@
 #include <string>
 #include <string_view>
 
+class ComputePipelineBuilder;
 class GraphicsPipelineBuilder;
 
 class Device
@@ -14,6 +15,7 @@ public:
     Device();
 
     GraphicsPipelineBuilder CreateGraphicsPipelineBuilder(std::string_view label);
+    ComputePipelineBuilder CreateComputePipelineBuilder(std::string_view label);
 
 private:
     friend class GraphicsPipelineBuilder;
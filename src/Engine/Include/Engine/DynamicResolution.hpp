@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+struct DynamicResolutionSettings
+{
+    // GPU time a frame should take, below the refresh interval to leave room for spikes
+    double BudgetMilliseconds = 14.0;
+    float MinScale = 0.5f;
+    float MaxScale = 1.0f;
+    // Scales are multiples of it, so small fluctuations do not reallocate the scene's render targets
+    float ScaleStep = 0.05f;
+    // Timings arrive a few frames late, changes wait until they reflect the previous one
+    uint32_t CooldownFrameCount = 30;
+};
+
+// Picks the scale the 3D scene renders at from measured GPU frame times. Pixel cost grows with the
+// square of the scale, so over budget it drops to what should fit right away, under it climbs a step at a time.
+class DynamicResolution
+{
+public:
+    explicit DynamicResolution(const DynamicResolutionSettings& settings = {}) noexcept;
+
+    // Returns whether the scale changed, frames without a new timing pass none
+    bool Update(std::optional<double> gpuMilliseconds) noexcept;
+
+    // Disabled, the scale stays at the maximum
+    void SetEnabled(bool isEnabled) noexcept;
+    void SetBudgetMilliseconds(double budgetMilliseconds) noexcept;
+
+    bool IsEnabled() const noexcept
+    {
+        return _isEnabled;
+    }
+
+    float GetScale() const noexcept
+    {
+        return _scale;
+    }
+
+    double GetBudgetMilliseconds() const noexcept
+    {
+        return _settings.BudgetMilliseconds;
+    }
+
+    // Smoothed GPU frame time the scale follows
+    double GetMilliseconds() const noexcept
+    {
+        return _milliseconds;
+    }
+
+private:
+    DynamicResolutionSettings _settings;
+    bool _isEnabled = true;
+    float _scale = 1.0f;
+    double _milliseconds = 0.0;
+    bool _hasMilliseconds = false;
+    uint32_t _framesSinceChange = 0;
+};
@@ -1,96 +1,21 @@
 #pragma once
 
-enum class Format
-{
-    R8_UNORM,
-    R8_SNORM,
-    R16_UNORM,
-    R16_SNORM,
-    R8G8_UNORM,
-    R8G8_SNORM,
-    R16G16_UNORM,
-    R16G16_SNORM,
-    R3G3B2_UNORM,
-    R4G4B4_UNORM,
-    R5G5B5_UNORM,
-    R8G8B8_UNORM,
-    R8G8B8_SNORM,
-    R10G10B10_UNORM,
-    R12G12B12_UNORM,
-    R16G16B16_SNORM,
-    R2G2B2A2_UNORM,
-    R4G4B4A4_UNORM,
-    R5G5B5A1_UNORM,
-    R8G8B8A8_UNORM,
-    R8G8B8A8_SNORM,
-    R10G10B10A2_UNORM,
-    R10G10B10A2_UINT,
-    R12G12B12A12_UNORM,
-    R16G16B16A16_UNORM,
-    R16G16B16A16_SNORM,
-    R8G8B8_SRGB,
-    R8G8B8A8_SRGB,
-    R16_FLOAT,
-    R16G16_FLOAT,
-    R16G16B16_FLOAT,
-    R16G16B16A16_FLOAT,
-    R32_FLOAT,
-    R32G32_FLOAT,
-    R32G32B32_FLOAT,
-    R32G32B32A32_FLOAT,
-    R11G11B10_FLOAT,
-    R9G9B9_E5,
-    R8_SINT,
-    R8_UINT,
-    R16_SINT,
-    R16_UINT,
-    R32_SINT,
-    R32_UINT,
-    R8G8_SINT,
-    R8G8_UINT,
-    R16G16_SINT,
-    R16G16_UINT,
-    R32G32_SINT,
-    R32G32_UINT,
-    R8G8B8_SINT,
-    R8G8B8_UINT,
-    R16G16B16_SINT,
-    R16G16B16_UINT,
-    R32G32B32_SINT,
-    R32G32B32_UINT,
-    R8G8B8A8_SINT,
-    R8G8B8A8_UINT,
-    R16G16B16A16_SINT,
-    R16G16B16A16_UINT,
-    R32G32B32A32_SINT,
-    R32G32B32A32_UINT,
+#include <EngineCore/Format.hpp>
+
+#include <cstdint>
+#include <optional>
 
-    // Depth & stencil formats
-    D32_FLOAT,
-    D32_UNORM,
-    D24_UNORM,
-    D16_UNORM,
-    D32_FLOAT_S8_UINT,
-    D24_UNORM_S8_UINT,
+// GL enums of a format, kept apart from FormatTraits so code without a GL context needs no GL headers
+struct FormatGLTraits
+{
+    Format Value;
+    uint32_t InternalFormat;
+    // Pixel transfer format and type, also the vertex attribute type. Compressed formats have no type,
+    // packed formats GL has no matching transfer type for upload through the next wider plain type
+    uint32_t PixelFormat;
+    uint32_t ComponentType;
+};
 
-    // Compressed formats
-    // DXT
-    BC1_RGB_UNORM,
-    BC1_RGB_SRGB,
-    BC1_RGBA_UNORM,
-    BC1_RGBA_SRGB,
-    BC2_RGBA_UNORM,
-    BC2_RGBA_SRGB,
-    BC3_RGBA_UNORM,
-    BC3_RGBA_SRGB,
-    // RGTC
-    BC4_R_UNORM,
-    BC4_R_SNORM,
-    BC5_RG_UNORM,
-    BC5_RG_SNORM,
-    // BPTC
-    BC6H_RGB_UFLOAT,
-    BC6H_RGB_SFLOAT,
-    BC7_RGBA_UNORM,
-    BC7_RGBA_SRGB,
-};
\ No newline at end of file
+const FormatGLTraits& GetFormatGLTraits(Format format) noexcept;
+// The format GL creates for an internal format, none for formats the table does not list
+std::optional<Format> FindFormat(uint32_t internalFormat) noexcept;
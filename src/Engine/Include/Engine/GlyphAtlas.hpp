@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Engine/Texture.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+
+struct Glyph
+{
+    // Quad corners relative to the pen on the baseline, in line heights with y pointing down, equal for blanks
+    glm::vec2 PlaneMin = {};
+    glm::vec2 PlaneMax = {};
+    glm::vec2 UvMin = {};
+    glm::vec2 UvMax = {};
+    float Advance = 0.0f;
+};
+
+struct GlyphAtlasSettings
+{
+    // Glyphs are rasterized at this many pixels per line before their distance fields are generated
+    uint32_t LineHeightPixels = 64;
+    // How far the distance fields reach beyond the glyph outlines, in atlas pixels
+    uint32_t SpreadPixels = 6;
+    uint32_t AtlasWidth = 512;
+};
+
+// Signed distance fields of the printable ASCII glyphs packed into one R8 texture. Distances are exact
+// Euclidean transforms of the rasterized glyphs, 0.5 on the outline, so text stays sharp at any size.
+class GlyphAtlas
+{
+public:
+    // Any TrueType font
+    static std::expected<GlyphAtlas, std::string> CreateFromFont(std::string_view fontFilePath, const GlyphAtlasSettings& settings = {});
+    // Blocky 5x7 capitals compiled in, lowercase maps onto them, for when there is no font file around
+    static GlyphAtlas CreateBuiltIn(const GlyphAtlasSettings& settings = {});
+
+    GlyphAtlas() noexcept;
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) noexcept = delete;
+    GlyphAtlas& operator =(const GlyphAtlas&) noexcept = delete;
+    GlyphAtlas(GlyphAtlas&& other) noexcept;
+    GlyphAtlas& operator =(GlyphAtlas&& other) noexcept;
+
+    // Characters the atlas lacks come back as '?'
+    const Glyph& GetGlyph(char character) const noexcept
+    {
+        auto index = static_cast<uint8_t>(character);
+        return _glyphs[index < _glyphs.size() ? index : '?'];
+    }
+
+    // From the top of a line to its baseline, in line heights
+    float GetAscent() const noexcept
+    {
+        return _ascent;
+    }
+
+    const Texture& GetTexture() const noexcept
+    {
+        return _texture;
+    }
+
+private:
+    struct GlyphBitmap;
+
+    static GlyphAtlas Build(
+        std::span<const GlyphBitmap> glyphBitmaps,
+        float lineHeightPixels,
+        float ascentPixels,
+        const GlyphAtlasSettings& settings);
+
+    std::array<Glyph, 128> _glyphs = {};
+    float _ascent = 0.0f;
+    Texture _texture;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+enum class GpuResourceType : uint8_t
+{
+    Buffer,
+    Texture
+};
+
+// Trivially copyable so snapshots of all allocations can go into an arena
+struct GpuAllocation
+{
+    static constexpr size_t LabelCapacity = 64;
+
+    GpuResourceType ResourceType;
+    uint32_t Id;
+    uint64_t ByteCount;
+    // Storage flags for buffers, the internal format for textures
+    uint32_t Usage;
+    uint32_t LabelLength;
+    std::array<char, LabelCapacity> Label;
+
+    std::string_view GetLabel() const noexcept
+    {
+        return { Label.data(), LabelLength };
+    }
+};
+
+struct GpuMemoryTotals
+{
+    uint64_t BufferCount = 0;
+    uint64_t BufferByteCount = 0;
+    uint64_t TextureCount = 0;
+    uint64_t TextureByteCount = 0;
+};
+
+// Every allocation Buffer and Texture make, thread safe for uploads from a shared context.
+// Texture sizes are estimated from format and extent, drivers may pad them.
+namespace GpuMemory
+{
+    void Track(GpuResourceType resourceType, uint32_t id, uint64_t byteCount, uint32_t usage, std::string_view label);
+    void Untrack(GpuResourceType resourceType, uint32_t id);
+
+    GpuMemoryTotals GetTotals();
+    void CopyAllocations(std::pmr::vector<GpuAllocation>& allocations);
+}
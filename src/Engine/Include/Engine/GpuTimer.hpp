@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// GPU time between Begin and End from timestamp queries, which unlike GL_TIME_ELAPSED may nest.
+// Results are read a few frames later so measuring never stalls the CPU.
+class GpuTimer
+{
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+
+    // Most recent completed measurement, none until the first one arrived
+    std::optional<double> GetMilliseconds() const noexcept
+    {
+        return _milliseconds;
+    }
+
+private:
+    static constexpr uint32_t LatencyFrameCount = 4;
+
+    void CollectResults(bool isWaiting);
+
+    std::array<uint32_t, LatencyFrameCount * 2> _queries = {};
+    uint32_t _nextMeasurement = 0;
+    uint32_t _pendingMeasurementCount = 0;
+    std::optional<double> _milliseconds;
+};
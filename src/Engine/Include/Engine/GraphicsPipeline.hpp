@@ -48,6 +48,7 @@ public:
         uint32_t stride);
     void UseIndexBufferBinding(const Buffer* indexBuffer);
     void Use() override;
+    void SetFragmentUniform(int32_t location, float value);
 
     void DrawArrays(
         uint32_t elementCount,
@@ -55,6 +56,26 @@ public:
     void DrawElements(
         uint32_t elementCount,
         uint32_t offsetInBytes = 0);
+    void DrawArraysInstanced(
+        uint32_t elementCount,
+        uint32_t instanceCount,
+        uint32_t elementOffset = 0,
+        uint32_t baseInstance = 0);
+    void DrawElementsInstancedBaseVertexBaseInstance(
+        uint32_t elementCount,
+        uint32_t instanceCount,
+        uint32_t offsetInBytes = 0,
+        int32_t baseVertex = 0,
+        uint32_t baseInstance = 0);
+    // Takes count, instance count, first and base instance from a DrawArraysIndirectCommand the GPU may have written
+    void DrawArraysIndirect(
+        const Buffer& indirectBuffer,
+        uint64_t offsetInBytes = 0);
+    // Tightly packed DrawArraysIndirectCommands, one draw call however many there are
+    void MultiDrawArraysIndirect(
+        const Buffer& indirectBuffer,
+        uint32_t drawCount,
+        uint64_t offsetInBytes = 0);
 
 private:
     friend class GraphicsPipelineBuilder;
@@ -8,8 +8,6 @@
 #include <string_view>
 #include <tuple>
 
-enum class ComponentTypeClass;
-enum class Format;
 enum class PrimitiveTopology;
 struct InputLayoutElement;
 
@@ -51,19 +49,10 @@ private:
         std::string_view label,
         std::string_view vertexShaderSource,
         std::string_view fragmentShaderSource);
-    std::expected<uint32_t, std::string> CreateShaderProgram(
-        std::string_view label,
-        uint32_t shaderType,
-        std::string_view shaderSource);
     uint32_t CreateInputLayout(
         std::string_view label,
         std::span<const InputLayoutElement> elements);
-        
-    uint32_t FormatToComponentCount(Format format);
-    ComponentTypeClass FormatToComponentTypeClass(Format format);
-    bool IsNormalizedFormat(Format format);
 
-    uint32_t ToGL(Format format);
     uint32_t ToGL(PrimitiveTopology PrimitiveTopology);
 
     GraphicsPipelineDescriptor _graphicsPipelineDescriptor;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Engine/Texture.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class ComputePipeline;
+class Device;
+
+// Full mip chain of a depth buffer where every texel keeps the farthest depth of the texels it covers,
+// so anything nearer than the pyramid's value over its footprint may be visible
+class HiZPyramid
+{
+public:
+    static std::expected<HiZPyramid, std::string> Create(Device& device, std::string_view buildShaderFilePath);
+
+    HiZPyramid() noexcept;
+    ~HiZPyramid();
+
+    HiZPyramid(const HiZPyramid&) noexcept = delete;
+    HiZPyramid& operator =(const HiZPyramid&) noexcept = delete;
+    HiZPyramid(HiZPyramid&& other) noexcept;
+    HiZPyramid& operator =(HiZPyramid&& other) noexcept;
+
+    // Downsamples the depth, recreating the levels when its size changed
+    void Build(const Texture& depth);
+    // Until the next Build nothing should be tested against the pyramid, as after a resize or a cut
+    void Invalidate() noexcept
+    {
+        _isValid = false;
+    }
+
+    bool IsValid() const noexcept
+    {
+        return _isValid;
+    }
+
+    const Texture& GetTexture() const noexcept
+    {
+        return _texture;
+    }
+
+    uint32_t GetLevelCount() const noexcept
+    {
+        return _levelCount;
+    }
+
+private:
+    static constexpr uint32_t GroupSize = 8;
+
+    std::unique_ptr<ComputePipeline> _buildPipeline;
+    Texture _texture;
+    uint32_t _levelCount = 0;
+    bool _isValid = false;
+};
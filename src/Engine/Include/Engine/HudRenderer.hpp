@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+#include <Engine/GlyphAtlas.hpp>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class Device;
+class GraphicsPipeline;
+
+// Binding point of the HudUniforms block, the quads are pulled from VertexPullingVertexBufferBinding
+constexpr uint32_t HudUniformBinding = 3;
+
+struct HudRendererSettings
+{
+    // Quads per frame, whatever is added past it is dropped and counted
+    uint32_t MaxQuadCount = 65536;
+    // The caller's fences must keep the GPU FrameCount - 1 frames behind at most
+    uint32_t FrameCount = 3;
+};
+
+struct HudStatistics
+{
+    uint32_t QuadCount = 0;
+    uint32_t GlyphCount = 0;
+    uint32_t DroppedQuadCount = 0;
+};
+
+// Screen space text and shapes batched into one instanced draw. Everything added between Begin and Draw
+// goes straight into the frame's region of a persistently mapped ring, one quad per glyph, rectangle or
+// ring, and the shaders tell the kinds apart, so the whole HUD costs one draw call however much is on it.
+// Positions and sizes are in pixels from the top left corner, colors are sRGB with straight alpha.
+class HudRenderer
+{
+public:
+    static std::expected<HudRenderer, std::string> Create(
+        Device& device,
+        std::string_view vertexShaderFilePath,
+        std::string_view fragmentShaderFilePath,
+        GlyphAtlas&& glyphAtlas,
+        const HudRendererSettings& settings = {});
+
+    HudRenderer() noexcept;
+    ~HudRenderer();
+
+    HudRenderer(const HudRenderer&) noexcept = delete;
+    HudRenderer& operator =(const HudRenderer&) noexcept = delete;
+    HudRenderer(HudRenderer&& other) noexcept;
+    HudRenderer& operator =(HudRenderer&& other) noexcept;
+
+    // The GPU must be done with the frame's previous use
+    void Begin(uint32_t frame, uint32_t viewportWidth, uint32_t viewportHeight);
+    void AddRectangle(glm::vec2 position, glm::vec2 size, const glm::vec4& color);
+    // Filled when the thickness reaches the radius
+    void AddRing(glm::vec2 center, float radius, float thickness, const glm::vec4& color);
+    // Position is the top left of the first line, size the line height. Returns the width of the widest line
+    float AddText(std::string_view text, glm::vec2 position, float size, const glm::vec4& color);
+    float MeasureText(std::string_view text, float size) const noexcept;
+    // Into whatever framebuffer is bound, over what is there
+    void Draw();
+
+    const HudStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+    const GlyphAtlas& GetGlyphAtlas() const noexcept
+    {
+        return _glyphAtlas;
+    }
+
+private:
+    enum class QuadKind : uint32_t
+    {
+        Rectangle = 0,
+        Glyph = 1,
+        Ring = 2
+    };
+
+    // Matches struct Quad in the HUD shaders (std430)
+    struct Quad
+    {
+        glm::vec2 Position = {};
+        glm::vec2 Size = {};
+        glm::vec2 UvMin = {};
+        glm::vec2 UvMax = {};
+        // RGBA8, sRGB
+        uint32_t Color = 0;
+        QuadKind Kind = QuadKind::Rectangle;
+        // Ring edges relative to half the quad size
+        float InnerRadius = 0.0f;
+        float OuterRadius = 0.0f;
+    };
+
+    // Matches the HudUniforms block in the HUD shaders (std140)
+    struct HudUniforms
+    {
+        // Width, height and their reciprocals
+        glm::vec4 ViewportSize;
+    };
+
+    bool AddQuad(const Quad& quad);
+
+    std::unique_ptr<GraphicsPipeline> _pipeline;
+    GlyphAtlas _glyphAtlas;
+    HudRendererSettings _settings = {};
+    HudStatistics _statistics;
+
+    Buffer _quadBuffer;
+    Buffer _uniformBuffer;
+    Quad* _quads = nullptr;
+    uint32_t _frame = 0;
+    glm::vec2 _viewportSize = {};
+};
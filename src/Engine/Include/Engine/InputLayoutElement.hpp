@@ -11,4 +11,6 @@ struct InputLayoutElement
     uint32_t BindingIndex;    
     Format AttributeFormat;
     uint32_t Offset;
+    // 0 advances per vertex, n advances every n instances. Applies to the whole BindingIndex.
+    uint32_t Divisor = 0;
 };
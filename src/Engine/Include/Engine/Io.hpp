@@ -1,9 +0,0 @@
-#pragma once
-
-#include <expected>
-#include <string_view>
-
-namespace Io
-{
-    std::expected<std::string, std::string> ReadTextFromFile(std::string_view filePath);
-}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ComputePipeline;
+class Device;
+class HiZPyramid;
+
+struct OcclusionCullerSettings
+{
+    uint32_t MaxDrawCount = 0;
+    // Instances per frame, the caller's instance index buffer holds FrameCount regions of this many
+    uint32_t MaxSlotCount = 0;
+    uint32_t FrameCount = 0;
+};
+
+// The early pass draws what was visible against the previous frame's depth, the late pass whatever
+// the early pass rejected but the depth the early pass left behind does not hide
+enum class OcclusionCullPass : uint32_t
+{
+    Early = 0,
+    Late = 1
+};
+
+struct OcclusionCullView
+{
+    // Camera relative, as the instances' model matrices are
+    glm::mat4 ViewProjection;
+    // Takes this frame's camera relative positions into the frame the pyramid was rendered in
+    glm::mat4 PyramidViewProjection;
+};
+
+struct OcclusionCullStatistics
+{
+    uint32_t TestedInstanceCount = 0;
+    uint32_t EarlyInstanceCount = 0;
+    uint32_t LateInstanceCount = 0;
+
+    uint32_t GetCulledInstanceCount() const noexcept
+    {
+        return TestedInstanceCount - EarlyInstanceCount - LateInstanceCount;
+    }
+};
+
+// Frustum and Hi-Z occlusion culling of vertex pulled instances on the GPU. Every draw covers a range of
+// slots of the caller's instance index buffer, the surviving instances of each are compacted into the
+// culled index buffer and counted into a DrawArraysIndirectCommand, so nothing goes back to the CPU.
+class OcclusionCuller
+{
+public:
+    static std::expected<OcclusionCuller, std::string> Create(
+        Device& device,
+        std::string_view cullShaderFilePath,
+        const OcclusionCullerSettings& settings);
+
+    OcclusionCuller() noexcept;
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) noexcept = delete;
+    OcclusionCuller& operator =(const OcclusionCuller&) noexcept = delete;
+    OcclusionCuller(OcclusionCuller&& other) noexcept;
+    OcclusionCuller& operator =(OcclusionCuller&& other) noexcept;
+
+    // The GPU must be done with the frame's previous use, its results become the statistics
+    void BeginFrame(uint32_t frame);
+    // Returns the draw's index for GetCommandOffset. The bounding sphere is in object space. Every slot
+    // below the highest one added has to belong to some draw
+    uint32_t AddDraw(
+        uint32_t firstSlot,
+        uint32_t slotCount,
+        uint32_t vertexCount,
+        uint32_t firstVertex,
+        const glm::vec4& boundingSphere);
+    void Cull(
+        OcclusionCullPass pass,
+        const OcclusionCullView& view,
+        const Buffer& instanceBuffer,
+        const Buffer& instanceIndexBuffer,
+        const HiZPyramid& pyramid);
+
+    // Disabled, every instance survives the early pass, for measuring what culling saves
+    void SetEnabled(bool isEnabled) noexcept
+    {
+        _isEnabled = isEnabled;
+    }
+
+    const Buffer& GetCommandBuffer() const noexcept
+    {
+        return _commandBuffer;
+    }
+
+    uint64_t GetCommandOffset(OcclusionCullPass pass, uint32_t draw) const noexcept
+    {
+        return (static_cast<uint64_t>(pass) * _settings.MaxDrawCount + draw) * sizeof(DrawCommand);
+    }
+
+    // Bind in place of the instance index buffer, each command's base instance points into it
+    const Buffer& GetCulledIndexBuffer() const noexcept
+    {
+        return _culledIndexBuffer;
+    }
+
+    // Of the last frame the GPU finished
+    const OcclusionCullStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+private:
+    static constexpr uint32_t GroupSize = 64;
+    static constexpr uint32_t PassCount = 2;
+
+    // Matches DrawArraysIndirectCommand
+    struct DrawCommand
+    {
+        uint32_t Count;
+        uint32_t InstanceCount;
+        uint32_t First;
+        uint32_t BaseInstance;
+    };
+
+    // Matches struct Draw in the cull shader (std430)
+    struct CullDraw
+    {
+        glm::vec4 BoundingSphere;
+        uint32_t FirstSlot;
+        uint32_t Padding[3];
+    };
+
+    std::unique_ptr<ComputePipeline> _cullPipeline;
+    OcclusionCullerSettings _settings = {};
+
+    Buffer _uniformBuffer;
+    // Rings of FrameCount regions written by the CPU
+    Buffer _drawBuffer;
+    Buffer _slotDrawBuffer;
+    Buffer _readbackBuffer;
+    // GPU only, one region per pass
+    Buffer _commandBuffer;
+    Buffer _culledIndexBuffer;
+    Buffer _visibilityBuffer;
+
+    std::vector<DrawCommand> _commands;
+    std::vector<uint32_t> _frameSlotCounts;
+    std::vector<uint32_t> _frameDrawCounts;
+    uint32_t _frame = 0;
+    uint32_t _drawCount = 0;
+    uint32_t _slotCount = 0;
+    bool _isEnabled = true;
+    OcclusionCullStatistics _statistics;
+};
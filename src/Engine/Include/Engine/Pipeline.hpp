@@ -5,6 +5,7 @@
 #include <utility>
 
 struct Buffer;
+class Texture;
 
 class Pipeline
 {
@@ -31,8 +32,10 @@ public:
 
     virtual void Use();
 
-    void BindAsUniformBuffer(const std::unique_ptr<Buffer>& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size);
-    void BindAsShaderStorageBuffer(const std::unique_ptr<Buffer>& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size);
+    void BindAsUniformBuffer(const Buffer& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size);
+    void BindAsShaderStorageBuffer(const Buffer& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size);
+    void BindTexture(const Texture& texture, uint32_t unit);
+    void BindImage(const Texture& texture, uint32_t unit, uint32_t level, uint32_t access, uint32_t format);
     
 protected:
     uint32_t Program = {};
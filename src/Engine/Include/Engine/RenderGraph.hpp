@@ -0,0 +1,287 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+#include <Engine/Texture.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class RenderGraph;
+
+constexpr uint32_t InvalidRenderGraphResource = UINT32_MAX;
+
+struct RenderGraphTexture
+{
+    uint32_t Index = InvalidRenderGraphResource;
+};
+
+struct RenderGraphBuffer
+{
+    uint32_t Index = InvalidRenderGraphResource;
+};
+
+struct RenderGraphTextureDescription
+{
+    uint32_t Format = 0;
+    // Fixed size, or zero to follow the framebuffer scaled by Scale
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    float Scale = 1.0f;
+    // Framebuffer relative and scaled by the render scale on top, for what dynamic resolution renders into
+    bool FollowsRenderScale = false;
+    uint32_t LevelCount = 1;
+    // Color attachments cleared by a pass start out as this, depth always clears to 1
+    glm::vec4 ClearColor = {};
+};
+
+struct RenderGraphBufferDescription
+{
+    uint32_t Size = 0;
+};
+
+// How a pass touches a resource, decides the barriers in front of it
+enum class RenderGraphAccess : uint8_t
+{
+    ColorAttachment,
+    DepthAttachment,
+    Sampled,
+    Image,
+    ShaderStorage,
+    Uniform,
+    Indirect,
+    // Blits through RenderGraphContext::Blit
+    Copy
+};
+
+enum class RenderGraphLoad : uint8_t
+{
+    Load,
+    Clear
+};
+
+// Transient resources against what one allocation per resource would have taken
+struct RenderGraphMemoryReport
+{
+    uint32_t TransientTextureCount = 0;
+    uint32_t TextureCount = 0;
+    uint32_t TransientBufferCount = 0;
+    uint32_t BufferCount = 0;
+    uint64_t NaiveByteCount = 0;
+    uint64_t ByteCount = 0;
+    uint32_t PassCount = 0;
+    uint32_t CulledPassCount = 0;
+
+    uint64_t GetSavedByteCount() const noexcept
+    {
+        return NaiveByteCount - ByteCount;
+    }
+};
+
+// Handed to a pass while it executes, resolves the pass's resources to what backs them this frame
+class RenderGraphContext
+{
+public:
+    const Texture& GetTexture(RenderGraphTexture texture) const noexcept;
+    const Buffer& GetBuffer(RenderGraphBuffer buffer) const noexcept;
+    // Copies color, stretched when the sizes differ. Both have to be declared with RenderGraphAccess::Copy
+    void Blit(RenderGraphTexture source, RenderGraphTexture destination) const noexcept;
+
+private:
+    friend class RenderGraph;
+
+    explicit RenderGraphContext(const RenderGraph& renderGraph) noexcept
+        : _renderGraph(renderGraph)
+    {
+    }
+
+    const RenderGraph& _renderGraph;
+};
+
+using RenderGraphExecute = std::function<void(const RenderGraphContext& context)>;
+
+// Declares what a pass reads and writes, returned by RenderGraph::AddPass
+class RenderGraphPassBuilder
+{
+public:
+    RenderGraphPassBuilder& Read(RenderGraphTexture texture, RenderGraphAccess access = RenderGraphAccess::Sampled);
+    RenderGraphPassBuilder& Read(RenderGraphBuffer buffer, RenderGraphAccess access = RenderGraphAccess::ShaderStorage);
+    RenderGraphPassBuilder& Write(RenderGraphTexture texture, RenderGraphAccess access = RenderGraphAccess::Image);
+    RenderGraphPassBuilder& Write(RenderGraphBuffer buffer, RenderGraphAccess access = RenderGraphAccess::ShaderStorage);
+    // Attachments of the framebuffer bound while the pass executes, loading keeps what earlier passes drew
+    RenderGraphPassBuilder& WriteColor(RenderGraphTexture texture, RenderGraphLoad load = RenderGraphLoad::Load);
+    RenderGraphPassBuilder& WriteDepth(RenderGraphTexture texture, RenderGraphLoad load = RenderGraphLoad::Load);
+    // Kept even when nothing reads what it writes, for timers, readbacks and the like
+    RenderGraphPassBuilder& SetSideEffect() noexcept;
+
+private:
+    friend class RenderGraph;
+
+    RenderGraphPassBuilder(RenderGraph& renderGraph, uint32_t pass) noexcept
+        : _renderGraph(renderGraph),
+          _pass(pass)
+    {
+    }
+
+    RenderGraphPassBuilder& AddAccess(uint32_t resource, RenderGraphAccess access, bool isWrite, RenderGraphLoad load = RenderGraphLoad::Load);
+
+    RenderGraph& _renderGraph;
+    uint32_t _pass;
+};
+
+// Passes in the order they run, each declaring the resources it reads and writes. Compiling culls passes
+// nothing depends on, gives every transient resource the span of passes it lives for and lets resources
+// whose spans do not overlap share one allocation. GL cannot alias memory between textures, so only
+// transient textures of the same format and size share, buffers share whenever the larger one fits both.
+// Executing binds each pass's attachments and issues the memory barriers shader writes need.
+class RenderGraph
+{
+public:
+    RenderGraph() noexcept;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator =(const RenderGraph&) = delete;
+
+    RenderGraphTexture CreateTexture(std::string_view name, const RenderGraphTextureDescription& description);
+    RenderGraphBuffer CreateBuffer(std::string_view name, const RenderGraphBufferDescription& description);
+    // Owned by the caller and outliving the graph, passes writing one are never culled. Imported textures
+    // may be recreated between frames unless a pass draws into them, framebuffers only follow a compile
+    RenderGraphTexture ImportTexture(std::string_view name, const Texture& texture);
+    RenderGraphBuffer ImportBuffer(std::string_view name, const Buffer& buffer);
+    // The default framebuffer, only as a color attachment or a blit destination
+    RenderGraphTexture ImportBackbuffer();
+
+    RenderGraphPassBuilder AddPass(std::string_view name, RenderGraphExecute execute);
+
+    // Passes and resources go, the allocations stay pooled for the next graph
+    void Reset();
+    // Framebuffer relative textures are only reallocated by the next Execute, and only if the size really changed
+    void SetFramebufferSize(uint32_t width, uint32_t height) noexcept;
+    void SetRenderScale(float renderScale) noexcept;
+
+    float GetRenderScale() const noexcept
+    {
+        return _renderScale;
+    }
+
+    // Size of the texture as the next Execute allocates it
+    uint32_t GetWidth(RenderGraphTexture texture) const noexcept;
+    uint32_t GetHeight(RenderGraphTexture texture) const noexcept;
+
+    // Execute compiles when needed, calling it up front reports errors before the first frame
+    std::expected<void, std::string> Compile();
+    void Execute();
+
+    const RenderGraphMemoryReport& GetMemoryReport() const noexcept
+    {
+        return _memoryReport;
+    }
+
+private:
+    friend class RenderGraphContext;
+    friend class RenderGraphPassBuilder;
+
+    enum class ResourceType : uint8_t
+    {
+        Texture,
+        Buffer
+    };
+
+    struct Resource
+    {
+        std::string Name;
+        ResourceType Type = ResourceType::Texture;
+        RenderGraphTextureDescription TextureDescription = {};
+        uint32_t BufferSize = 0;
+        const Texture* ImportedTexture = nullptr;
+        const Buffer* ImportedBuffer = nullptr;
+        bool IsImported = false;
+        bool IsBackbuffer = false;
+
+        // Compiled
+        uint32_t FirstPass = InvalidRenderGraphResource;
+        uint32_t LastPass = 0;
+        uint32_t Allocation = InvalidRenderGraphResource;
+
+        // Executed, imported resources carry it over from frame to frame
+        bool HasIncoherentWrite = false;
+        uint32_t IssuedBarrierBits = 0;
+    };
+
+    struct Access
+    {
+        uint32_t Resource;
+        RenderGraphAccess Type;
+        bool IsWrite;
+        RenderGraphLoad Load;
+    };
+
+    struct Pass
+    {
+        std::string Name;
+        RenderGraphExecute Execute;
+        std::vector<Access> Accesses = {};
+        bool HasSideEffect = false;
+
+        // Compiled
+        bool IsCulled = false;
+        uint32_t Framebuffer = 0;
+        bool HasAttachments = false;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    struct TextureAllocation
+    {
+        Texture Storage;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Format = 0;
+        uint32_t LevelCount = 0;
+        uint32_t LastPass = 0;
+        bool IsUsed = false;
+    };
+
+    struct BufferAllocation
+    {
+        Buffer Storage;
+        uint32_t Size = 0;
+        uint32_t LastPass = 0;
+        bool IsUsed = false;
+    };
+
+    uint32_t AddResource(Resource&& resource);
+    void CullPasses();
+    std::expected<void, std::string> ComputeLifetimes();
+    void AllocateTextures();
+    void AllocateBuffers();
+    std::expected<void, std::string> CreateFramebuffers();
+    void DeleteFramebuffers() noexcept;
+    void IssueBarriers(const Pass& pass);
+    void BeginPass(const Pass& pass) const;
+
+    const Texture& GetTexture(uint32_t resource) const noexcept;
+    const Buffer& GetBuffer(uint32_t resource) const noexcept;
+    void Blit(uint32_t source, uint32_t destination) const noexcept;
+    uint32_t GetTextureWidth(const Resource& resource) const noexcept;
+    uint32_t GetTextureHeight(const Resource& resource) const noexcept;
+
+    std::vector<Resource> _resources;
+    std::vector<Pass> _passes;
+    std::vector<TextureAllocation> _textureAllocations;
+    std::vector<BufferAllocation> _bufferAllocations;
+    // Read and draw framebuffers for Blit
+    uint32_t _blitFramebuffers[2] = {};
+
+    uint32_t _framebufferWidth = 0;
+    uint32_t _framebufferHeight = 0;
+    float _renderScale = 1.0f;
+    bool _isCompiled = false;
+    RenderGraphMemoryReport _memoryReport;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class Buffer;
+class GraphicsPipeline;
+class TaskScheduler;
+class Texture;
+
+// Sort key fields from the most significant bits down. Ids are whatever the caller assigns, equal ids
+// end up next to each other, and depth orders draws that share everything else.
+struct RenderKeyFields
+{
+    static constexpr uint32_t PassBitCount = 4;
+    static constexpr uint32_t PipelineBitCount = 8;
+    // With vertex pulling the geometry buffers take the place of the input layout
+    static constexpr uint32_t GeometryBitCount = 12;
+    static constexpr uint32_t MaterialBitCount = 16;
+    static constexpr uint32_t DepthBitCount = 24;
+
+    uint32_t Pass = 0;
+    uint32_t Pipeline = 0;
+    uint32_t Geometry = 0;
+    uint32_t Material = 0;
+    uint32_t Depth = 0;
+};
+
+constexpr uint64_t MakeRenderKey(const RenderKeyFields& fields) noexcept
+{
+    auto key = static_cast<uint64_t>(fields.Pass & ((1u << RenderKeyFields::PassBitCount) - 1));
+    key = (key << RenderKeyFields::PipelineBitCount) | (fields.Pipeline & ((1u << RenderKeyFields::PipelineBitCount) - 1));
+    key = (key << RenderKeyFields::GeometryBitCount) | (fields.Geometry & ((1u << RenderKeyFields::GeometryBitCount) - 1));
+    key = (key << RenderKeyFields::MaterialBitCount) | (fields.Material & ((1u << RenderKeyFields::MaterialBitCount) - 1));
+    key = (key << RenderKeyFields::DepthBitCount) | (fields.Depth & ((1u << RenderKeyFields::DepthBitCount) - 1));
+    return key;
+}
+
+// Depth in [0, farDepth] to key bits, front to back unless isBackToFront, as blended passes want
+uint32_t QuantizeRenderDepth(float depth, float farDepth, bool isBackToFront = false) noexcept;
+
+enum class RenderBindingType
+{
+    UniformBuffer,
+    ShaderStorageBuffer,
+    Texture
+};
+
+struct RenderBinding
+{
+    RenderBindingType Type = RenderBindingType::UniformBuffer;
+    // Binding index or texture unit, buffers are bound whole
+    uint32_t Index = 0;
+    const Buffer* BoundBuffer = nullptr;
+    const Texture* BoundTexture = nullptr;
+};
+
+// What a draw binds besides its pipeline. Draws pointing at the same set are bound once
+struct RenderBindingSet
+{
+    static constexpr uint32_t MaxBindingCount = 4;
+
+    std::array<RenderBinding, MaxBindingCount> Bindings = {};
+    uint32_t BindingCount = 0;
+
+    void Add(const RenderBinding& binding) noexcept
+    {
+        Bindings[BindingCount++] = binding;
+    }
+};
+
+// An instanced, vertex pulled draw. With an indirect buffer the counts come from the command at
+// IndirectOffset instead, for draws the GPU culled itself
+struct RenderItem
+{
+    GraphicsPipeline* Pipeline = nullptr;
+    const RenderBindingSet* Geometry = nullptr;
+    const RenderBindingSet* Material = nullptr;
+    uint32_t ElementCount = 0;
+    uint32_t InstanceCount = 0;
+    uint32_t ElementOffset = 0;
+    uint32_t BaseInstance = 0;
+    const Buffer* IndirectBuffer = nullptr;
+    uint64_t IndirectOffset = 0;
+};
+
+// Draws are added in any order during the frame, radix sorted by key and submitted binding only what
+// differs from the previous draw. Everything the items point to has to live until Submit.
+// State changes are counted both in the order items were added and as submitted, into RenderStatistics.
+class RenderQueue
+{
+public:
+    // Below this the sort stays on the calling thread
+    static constexpr uint32_t ParallelSortThreshold = 16384;
+
+    void Clear() noexcept;
+    void Add(uint64_t key, const RenderItem& item);
+
+    // Spreads large sorts across the scheduler's workers when there is one
+    void Sort(TaskScheduler* taskScheduler = nullptr);
+    void Submit();
+    // Only the sorted draws of one pass, for frames that do other work in between passes
+    void Submit(uint32_t pass);
+
+    uint32_t GetCount() const noexcept
+    {
+        return static_cast<uint32_t>(_items.size());
+    }
+
+private:
+    static constexpr uint32_t RadixBitCount = 8;
+    static constexpr uint32_t RadixBucketCount = 1u << RadixBitCount;
+    static constexpr uint32_t RadixPassCount = 64 / RadixBitCount;
+
+    struct SortEntry
+    {
+        uint64_t Key;
+        uint32_t Item;
+    };
+
+    using Histogram = std::array<uint32_t, RadixBucketCount>;
+
+    uint32_t CountStateChanges() const noexcept;
+    void SubmitEntries(std::span<const SortEntry> entries);
+
+    std::vector<RenderItem> _items;
+    std::vector<SortEntry> _entries;
+    std::vector<SortEntry> _sortScratch;
+    // One per chunk and radix pass, kept so sorting does not allocate once warmed up
+    std::vector<Histogram> _histograms;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+struct RenderStatistics
+{
+    uint32_t DrawCallCount = 0;
+    uint32_t DispatchCount = 0;
+    // Memory barriers the render graph issued
+    uint32_t BarrierCount = 0;
+    uint64_t InstanceCount = 0;
+    // Program pipeline and input layout switches
+    uint32_t PipelineChangeCount = 0;
+    // Buffers and textures bound to the pipeline
+    uint32_t BindingChangeCount = 0;
+    // Draws through a RenderQueue, and their pipeline, geometry and material switches in the order
+    // they were added compared to the sorted order they were submitted in
+    uint32_t QueuedDrawCount = 0;
+    uint32_t UnsortedStateChangeCount = 0;
+    uint32_t SortedStateChangeCount = 0;
+};
+
+// Counted by the pipelines on the GL thread, Application starts it over every frame
+inline RenderStatistics& GetRenderStatistics() noexcept
+{
+    static RenderStatistics renderStatistics;
+    return renderStatistics;
+}
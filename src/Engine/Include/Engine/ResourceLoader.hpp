@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Engine/StagingUploader.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+struct __GLsync;
+
+struct ResourceLoaderSettings
+{
+    // Off for drivers where a second context is slow or serializes with the render thread
+    bool UseSharedContext = true;
+    // Jobs beyond it wait for later frames, a larger job still runs on its own
+    uint64_t ByteBudgetPerFrame = 1 << 20;
+    uint32_t StagingCapacity = StagingUploader::DefaultCapacity;
+};
+
+// Creates and fills buffers and textures on a thread owning a context shared with the window's, so
+// large uploads never stall rendering. Jobs write through a StagingUploader, which lets their
+// buffers be immutable. Each batch of jobs is fenced, completions run on the render thread in Publish
+// once the fence signalled, and only then is what the jobs made safe to use.
+// Without a shared context jobs run inside Publish instead.
+class ResourceLoader
+{
+public:
+    // Runs with a GL context current, on the loader thread or inside Publish
+    using Job = std::move_only_function<void(StagingUploader&)>;
+    // Runs on the render thread after the GPU finished the job
+    using Completion = std::move_only_function<void()>;
+
+    // Creates the shared context, on the main thread like any GLFW window
+    ResourceLoader(GLFWwindow* window, const ResourceLoaderSettings& settings);
+    ~ResourceLoader();
+
+    ResourceLoader(const ResourceLoader&) = delete;
+    ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+    // byteCount is what the job uploads, it counts against the per frame budget
+    void Enqueue(uint64_t byteCount, Job job, Completion completion);
+
+    // Render thread, once a frame. Runs completions of finished jobs, never waits for the GPU
+    void Publish();
+
+    bool IsAsynchronous() const noexcept
+    {
+        return _sharedContext != nullptr;
+    }
+
+private:
+    struct Upload
+    {
+        uint64_t ByteCount = 0;
+        Job Work;
+        Completion OnCompleted;
+    };
+
+    struct Batch
+    {
+        __GLsync* Fence = nullptr;
+        std::vector<Completion> Completions;
+    };
+
+    void LoaderLoop(std::stop_token stopToken);
+    // Takes queued jobs until the frame's budget is spent, so the first one of a frame may exceed it
+    void TakeJobs(std::vector<Upload>& jobs, uint64_t& frameByteCount);
+    void RunSynchronous();
+
+    ResourceLoaderSettings _settings;
+    GLFWwindow* _sharedContext = nullptr;
+    // Lives in whichever context runs the jobs
+    std::unique_ptr<StagingUploader> _stagingUploader;
+
+    std::mutex _mutex;
+    std::condition_variable_any _jobQueued;
+    std::deque<Upload> _jobs;
+    // Counts Publish calls, the loader thread starts a new budget when it changes
+    uint64_t _frameIndex = 0;
+    // Fenced in submission order, so they signal in that order too
+    std::deque<Batch> _fencedBatches;
+    std::vector<Completion> _publishedCompletions;
+    std::vector<Upload> _synchronousJobs;
+    std::jthread _loader;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+
+// Separable program of a single stage, as used in program pipelines
+std::expected<uint32_t, std::string> CreateShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::string_view shaderSource);
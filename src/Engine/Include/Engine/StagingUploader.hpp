@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+class Texture;
+struct __GLsync;
+
+// Writes buffers and textures through a persistently mapped staging ring, so destinations can be
+// immutable storage created without any flags. Data is copied into the ring right away, Flush issues
+// the GPU copies as one batch and fences it, and the batch's part of the ring is reused only after
+// that fence signalled. A write continuing where the previous one ended is merged into its copy.
+// Use from the one context that created it.
+class StagingUploader
+{
+public:
+    static constexpr uint32_t DefaultCapacity = 16 * 1024 * 1024;
+
+    explicit StagingUploader(uint32_t capacity = DefaultCapacity);
+    ~StagingUploader();
+
+    StagingUploader(const StagingUploader&) = delete;
+    StagingUploader& operator=(const StagingUploader&) = delete;
+
+    void Write(const Buffer& destination, uint64_t destinationOffset, std::span<const std::byte> data);
+    // Rows are tightly packed, larger images than the ring go through it a few rows at a time
+    void Write(
+        const Texture& destination,
+        uint32_t level,
+        uint32_t x,
+        uint32_t y,
+        uint32_t width,
+        uint32_t height,
+        uint32_t format,
+        uint32_t type,
+        std::span<const std::byte> data);
+
+    void Flush();
+
+private:
+    struct BufferCopy
+    {
+        uint32_t Destination;
+        uint64_t DestinationOffset;
+        uint64_t SourceOffset;
+        uint64_t Size;
+    };
+
+    struct TextureCopy
+    {
+        uint32_t Destination;
+        uint32_t Level;
+        uint32_t X;
+        uint32_t Y;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Format;
+        uint32_t Type;
+        uint64_t SourceOffset;
+    };
+
+    struct Batch
+    {
+        __GLsync* Fence;
+        // Ring position the batch's data ends at
+        uint64_t End;
+    };
+
+    // Up to size bytes in whole granules, contiguous in the ring. Offset into the staging buffer and size
+    std::pair<uint64_t, uint64_t> Allocate(uint64_t size, uint64_t granularity, uint64_t alignment);
+    void RetireBatches(bool isWaiting);
+
+    Buffer _stagingBuffer;
+    // Both only grow, the ring offset is taken modulo the capacity
+    uint64_t _head = 0;
+    uint64_t _tail = 0;
+    std::vector<BufferCopy> _bufferCopies;
+    std::vector<TextureCopy> _textureCopies;
+    std::deque<Batch> _batches;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+#include <EngineCore/StarCatalog.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Device;
+class GraphicsPipeline;
+
+// Binding point of the StarUniforms block, the stars are pulled from VertexPullingVertexBufferBinding
+constexpr uint32_t StarFieldUniformBinding = 5;
+
+struct StarFieldSettings
+{
+    // Nothing fainter is drawn anywhere
+    float LimitingMagnitude = 14.0f;
+    // A cell draws at most this many stars per pixel it covers, so dense regions lose their faint stars first
+    float MaxStarsPerPixel = 0.25f;
+    // Magnitude drawn as a single pixel at full brightness, brighter stars grow, fainter ones dim
+    float ReferenceMagnitude = 5.0f;
+    uint32_t FrameCount = 3;
+};
+
+struct StarFieldStatistics
+{
+    uint32_t VisibleCellCount = 0;
+    uint64_t DrawnStarCount = 0;
+    // In visible cells, fainter than the limiting magnitude or past the cell's density cap
+    uint64_t SkippedStarCount = 0;
+};
+
+// The sky as points, one per star of a catalog, infinitely far away. The catalog goes from its mapping into
+// immutable buffers with no copy of our own, then every frame each cell inside the view cone draws the
+// brightest prefix of its stars that its limiting magnitude and screen area allow, one indirect call per buffer.
+// Buffers are split at cell boundaries to stay within the largest storage block the driver allows.
+class StarField
+{
+public:
+    static std::expected<StarField, std::string> Create(
+        Device& device,
+        const StarCatalog& catalog,
+        std::string_view vertexShaderFilePath,
+        std::string_view fragmentShaderFilePath,
+        const StarFieldSettings& settings = {});
+
+    StarField() noexcept;
+    ~StarField();
+
+    StarField(const StarField&) noexcept = delete;
+    StarField& operator =(const StarField&) noexcept = delete;
+    StarField(StarField&& other) noexcept;
+    StarField& operator =(StarField&& other) noexcept;
+
+    // The GPU must be done with the frame's previous use. Only the view's rotation matters, draws behind
+    // the scene into the bound framebuffer
+    void Draw(
+        uint32_t frame,
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        float fieldOfView,
+        uint32_t viewportWidth,
+        uint32_t viewportHeight);
+
+    uint64_t GetStarCount() const noexcept
+    {
+        return _starCount;
+    }
+
+    const StarFieldStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+private:
+    // Matches the StarUniforms block in the star shaders (std140)
+    struct StarUniforms
+    {
+        glm::mat4 ViewProjection;
+        // Reference magnitude, limiting magnitude
+        glm::vec4 Parameters;
+    };
+
+    // Matches DrawArraysIndirectCommand
+    struct DrawCommand
+    {
+        uint32_t Count;
+        uint32_t InstanceCount;
+        uint32_t First;
+        uint32_t BaseInstance;
+    };
+
+    // Consecutive cells whose stars share one buffer
+    struct StarPage
+    {
+        Buffer StarBuffer;
+        uint32_t FirstStar = 0;
+        uint32_t FirstCell = 0;
+        uint32_t CellCount = 0;
+        // Of the current frame
+        uint32_t FirstCommand = 0;
+        uint32_t CommandCount = 0;
+    };
+
+    std::unique_ptr<GraphicsPipeline> _pipeline;
+    StarFieldSettings _settings = {};
+    StarFieldStatistics _statistics;
+    uint64_t _starCount = 0;
+    // Only a few hundred KiB, kept so culling never touches the catalog's mapping again
+    std::vector<StarCell> _cells;
+
+    std::vector<StarPage> _starPages;
+    Buffer _commandBuffer;
+    Buffer _uniformBuffer;
+};
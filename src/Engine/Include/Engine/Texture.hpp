@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+class Pipeline;
+
+class Texture
+{
+public:
+    // Immutable 2D storage, sampled with linear filtering and clamped to the edge by default
+    static Texture Create2D(
+        std::string_view label,
+        uint32_t width,
+        uint32_t height,
+        uint32_t internalFormat,
+        uint32_t levelCount = 1) noexcept;
+
+    // Estimated from format and extent, drivers may pad
+    static uint64_t GetByteCount(
+        uint32_t width,
+        uint32_t height,
+        uint32_t internalFormat,
+        uint32_t levelCount = 1) noexcept;
+
+    Texture() noexcept = default;
+    ~Texture();
+
+    Texture(const Texture&) noexcept = delete;
+    Texture& operator =(const Texture&) noexcept = delete;
+    Texture(Texture&& other) noexcept;
+    Texture& operator =(Texture&& other) noexcept;
+
+    void Swap(Texture& other) noexcept;
+
+    void Write(
+        uint32_t level,
+        uint32_t x,
+        uint32_t y,
+        uint32_t width,
+        uint32_t height,
+        uint32_t format,
+        uint32_t type,
+        const void* data) const noexcept;
+
+    void SetFilter(uint32_t minFilter, uint32_t magFilter) const noexcept;
+
+    uint32_t GetWidth() const noexcept
+    {
+        return _width;
+    }
+
+    uint32_t GetHeight() const noexcept
+    {
+        return _height;
+    }
+
+private:
+    friend class Pipeline;
+    friend class RenderGraph;
+    friend class StagingUploader;
+
+    uint32_t _id = 0;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+};
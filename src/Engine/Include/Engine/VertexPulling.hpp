@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+
+// Shader storage buffer binding points used by the vertex pulling shaders.
+// Instance data is indexed with gl_InstanceID + gl_BaseInstance, so one instance buffer can
+// serve several instanced draws by passing each draw's first instance as baseInstance.
+constexpr uint32_t VertexPullingVertexBufferBinding = 0;
+constexpr uint32_t VertexPullingIndexBufferBinding = 1;
+constexpr uint32_t VertexPullingInstanceBufferBinding = 2;
+// Optional indirection, instance = Instances[InstanceIndices[gl_InstanceID + gl_BaseInstance]],
+// lets draws pick arbitrary subsets of the instance buffer without moving matrices around
+constexpr uint32_t VertexPullingInstanceIndexBufferBinding = 3;
+
+// Matches struct Instance in the instanced vertex pulling shaders (std430)
+struct InstanceData
+{
+    glm::mat4 ModelViewProjection;
+    glm::mat4 Model;
+};
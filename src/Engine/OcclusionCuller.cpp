@@ -0,0 +1,263 @@
+#include <Engine/OcclusionCuller.hpp>
+#include <Engine/ComputePipeline.hpp>
+#include <Engine/ComputePipelineBuilder.hpp>
+#include <Engine/Device.hpp>
+#include <Engine/HiZPyramid.hpp>
+
+#include <glad/glad.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <format>
+#include <utility>
+
+namespace
+{
+    // Binding points in the cull shader, above the ones the vertex pulling shaders use so culling
+    // leaves the frame's draw bindings alone
+    constexpr uint32_t CullUniformBinding = 8;
+    constexpr uint32_t CullInstanceBufferBinding = 8;
+    constexpr uint32_t CullInstanceIndexBufferBinding = 9;
+    constexpr uint32_t CullDrawBufferBinding = 10;
+    constexpr uint32_t CullSlotDrawBufferBinding = 11;
+    constexpr uint32_t CullCommandBufferBinding = 12;
+    constexpr uint32_t CullCulledIndexBufferBinding = 13;
+    constexpr uint32_t CullVisibilityBufferBinding = 14;
+    constexpr uint32_t CullPyramidUnit = 8;
+
+    constexpr uint32_t CullFlagEnabled = 1u << 0;
+    constexpr uint32_t CullFlagOcclusion = 1u << 1;
+
+    // Each pass gets its own uniforms, at the largest offset alignment drivers ask for
+    constexpr uint32_t UniformStride = 256;
+
+    // Matches the CullUniforms block in the cull shader (std140)
+    struct CullUniforms
+    {
+        glm::mat4 PyramidViewProjection;
+        std::array<glm::vec4, 6> FrustumPlanes;
+        glm::vec4 PyramidSize;
+        uint32_t Pass;
+        uint32_t Flags;
+        uint32_t SlotOffset;
+        uint32_t SlotCount;
+        uint32_t DrawOffset;
+        uint32_t CommandOffset;
+        uint32_t Padding[2];
+    };
+    static_assert(sizeof(CullUniforms) <= UniformStride);
+
+    // Normalized planes facing inwards, from the rows of the view projection
+    std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProjection) noexcept
+    {
+        auto row = [&viewProjection](int32_t index)
+        {
+            return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]);
+        };
+
+        std::array<glm::vec4, 6> planes =
+        {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(3) + row(2),
+            row(3) - row(2)
+        };
+        for (auto& plane : planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return planes;
+    }
+}
+
+std::expected<OcclusionCuller, std::string> OcclusionCuller::Create(
+    Device& device,
+    std::string_view cullShaderFilePath,
+    const OcclusionCullerSettings& settings)
+{
+    auto cullPipelineResult = device.CreateComputePipelineBuilder("OcclusionCull")
+        .WithShader(cullShaderFilePath)
+        .Build();
+    if (!cullPipelineResult)
+    {
+        return std::unexpected(std::format("Unable to create occlusion culler. Details: {}", cullPipelineResult.error()));
+    }
+
+    auto culler = OcclusionCuller();
+    culler._cullPipeline = std::move(cullPipelineResult.value());
+    culler._settings = settings;
+
+    auto persistentWrite = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    auto commandByteCount = sizeof(DrawCommand) * settings.MaxDrawCount * PassCount;
+    culler._uniformBuffer = Buffer::Create("Buffer_Uniforms_OcclusionCull", UniformStride * PassCount, GL_UNIFORM_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    culler._drawBuffer = Buffer::Create(
+        "Buffer_OcclusionCull_Draws",
+        sizeof(CullDraw) * settings.MaxDrawCount * settings.FrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        persistentWrite,
+        true);
+    culler._slotDrawBuffer = Buffer::Create(
+        "Buffer_OcclusionCull_SlotDraws",
+        sizeof(uint32_t) * settings.MaxSlotCount * settings.FrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        persistentWrite,
+        true);
+    culler._readbackBuffer = Buffer::Create(
+        "Buffer_OcclusionCull_Readback",
+        commandByteCount * settings.FrameCount,
+        GL_COPY_WRITE_BUFFER,
+        GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true);
+    culler._commandBuffer = Buffer::Create("Buffer_OcclusionCull_Commands", commandByteCount, GL_DRAW_INDIRECT_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    culler._culledIndexBuffer = Buffer::Create(
+        "Buffer_OcclusionCull_CulledIndices",
+        sizeof(uint32_t) * settings.MaxSlotCount * PassCount,
+        GL_SHADER_STORAGE_BUFFER,
+        0);
+    culler._visibilityBuffer = Buffer::Create(
+        "Buffer_OcclusionCull_Visibility",
+        sizeof(uint32_t) * settings.MaxSlotCount,
+        GL_SHADER_STORAGE_BUFFER,
+        0);
+
+    culler._commands.resize(static_cast<size_t>(settings.MaxDrawCount) * PassCount);
+    culler._frameSlotCounts.resize(settings.FrameCount);
+    culler._frameDrawCounts.resize(settings.FrameCount);
+    return culler;
+}
+
+OcclusionCuller::OcclusionCuller() noexcept = default;
+OcclusionCuller::~OcclusionCuller() = default;
+OcclusionCuller::OcclusionCuller(OcclusionCuller&& other) noexcept = default;
+OcclusionCuller& OcclusionCuller::operator =(OcclusionCuller&& other) noexcept = default;
+
+void OcclusionCuller::BeginFrame(uint32_t frame)
+{
+    _frame = frame;
+    _drawCount = 0;
+    _slotCount = 0;
+
+    auto drawCount = std::exchange(_frameDrawCounts[frame], 0u);
+    if (drawCount == 0)
+    {
+        return;
+    }
+
+    auto commands = static_cast<const DrawCommand*>(_readbackBuffer.GetMappedMemory()) + static_cast<size_t>(frame) * _settings.MaxDrawCount * PassCount;
+    _statistics = {};
+    _statistics.TestedInstanceCount = _frameSlotCounts[frame];
+    for (auto draw = 0u; draw < drawCount; draw++)
+    {
+        _statistics.EarlyInstanceCount += commands[draw].InstanceCount;
+        _statistics.LateInstanceCount += commands[_settings.MaxDrawCount + draw].InstanceCount;
+    }
+}
+
+uint32_t OcclusionCuller::AddDraw(
+    uint32_t firstSlot,
+    uint32_t slotCount,
+    uint32_t vertexCount,
+    uint32_t firstVertex,
+    const glm::vec4& boundingSphere)
+{
+    assert(_drawCount < _settings.MaxDrawCount && firstSlot + slotCount <= _settings.MaxSlotCount && "overflow");
+
+    auto draw = _drawCount++;
+    auto draws = static_cast<CullDraw*>(_drawBuffer.GetMappedMemory()) + static_cast<size_t>(_frame) * _settings.MaxDrawCount;
+    draws[draw] = CullDraw{ .BoundingSphere = boundingSphere, .FirstSlot = firstSlot, .Padding = {} };
+
+    auto slotDraws = static_cast<uint32_t*>(_slotDrawBuffer.GetMappedMemory()) + static_cast<size_t>(_frame) * _settings.MaxSlotCount;
+    std::fill_n(slotDraws + firstSlot, slotCount, draw);
+    _slotCount = std::max(_slotCount, firstSlot + slotCount);
+
+    // Instance counts start at zero, the cull shader appends the survivors into each pass's region
+    for (auto pass = 0u; pass < PassCount; pass++)
+    {
+        _commands[pass * _settings.MaxDrawCount + draw] = DrawCommand
+        {
+            .Count = vertexCount,
+            .InstanceCount = 0,
+            .First = firstVertex,
+            .BaseInstance = pass * _settings.MaxSlotCount + firstSlot
+        };
+    }
+    return draw;
+}
+
+void OcclusionCuller::Cull(
+    OcclusionCullPass pass,
+    const OcclusionCullView& view,
+    const Buffer& instanceBuffer,
+    const Buffer& instanceIndexBuffer,
+    const HiZPyramid& pyramid)
+{
+    if (_drawCount == 0)
+    {
+        return;
+    }
+
+    auto passIndex = static_cast<uint32_t>(pass);
+    if (pass == OcclusionCullPass::Early)
+    {
+        for (auto commandPass = 0u; commandPass < PassCount; commandPass++)
+        {
+            auto commandOffset = GetCommandOffset(static_cast<OcclusionCullPass>(commandPass), 0);
+            _commandBuffer.Write(&_commands[commandPass * _settings.MaxDrawCount], sizeof(DrawCommand) * _drawCount, commandOffset);
+        }
+    }
+
+    auto flags = _isEnabled ? CullFlagEnabled : 0u;
+    flags |= pyramid.IsValid() ? CullFlagOcclusion : 0u;
+    CullUniforms cullUniforms =
+    {
+        .PyramidViewProjection = view.PyramidViewProjection,
+        .FrustumPlanes = ExtractFrustumPlanes(view.ViewProjection),
+        .PyramidSize = glm::vec4(
+            static_cast<float>(pyramid.GetTexture().GetWidth()),
+            static_cast<float>(pyramid.GetTexture().GetHeight()),
+            static_cast<float>(pyramid.GetLevelCount()),
+            0.0f),
+        .Pass = passIndex,
+        .Flags = flags,
+        .SlotOffset = _frame * _settings.MaxSlotCount,
+        .SlotCount = _slotCount,
+        .DrawOffset = _frame * _settings.MaxDrawCount,
+        .CommandOffset = passIndex * _settings.MaxDrawCount,
+        .Padding = {}
+    };
+    _uniformBuffer.Write(&cullUniforms, sizeof(CullUniforms), passIndex * UniformStride);
+
+    _cullPipeline->Use();
+    _cullPipeline->BindAsUniformBuffer(_uniformBuffer, CullUniformBinding, passIndex * UniformStride, sizeof(CullUniforms));
+    _cullPipeline->BindAsShaderStorageBuffer(instanceBuffer, CullInstanceBufferBinding, 0, instanceBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(instanceIndexBuffer, CullInstanceIndexBufferBinding, 0, instanceIndexBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(_drawBuffer, CullDrawBufferBinding, 0, _drawBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(_slotDrawBuffer, CullSlotDrawBufferBinding, 0, _slotDrawBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(_commandBuffer, CullCommandBufferBinding, 0, _commandBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(_culledIndexBuffer, CullCulledIndexBufferBinding, 0, _culledIndexBuffer.GetSize());
+    _cullPipeline->BindAsShaderStorageBuffer(_visibilityBuffer, CullVisibilityBufferBinding, 0, _visibilityBuffer.GetSize());
+    if (pyramid.IsValid())
+    {
+        _cullPipeline->BindTexture(pyramid.GetTexture(), CullPyramidUnit);
+    }
+    _cullPipeline->Dispatch((_slotCount + GroupSize - 1) / GroupSize);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if (pass == OcclusionCullPass::Late)
+    {
+        // Both passes' final instance counts, read in BeginFrame once this frame's fence passed
+        auto readbackOffset = static_cast<uint64_t>(_frame) * _settings.MaxDrawCount * PassCount * sizeof(DrawCommand);
+        for (auto commandPass = 0u; commandPass < PassCount; commandPass++)
+        {
+            auto commandOffset = GetCommandOffset(static_cast<OcclusionCullPass>(commandPass), 0);
+            _commandBuffer.CopyTo(_readbackBuffer, sizeof(DrawCommand) * _drawCount, commandOffset, readbackOffset + commandOffset);
+        }
+        _frameDrawCounts[_frame] = _drawCount;
+        _frameSlotCounts[_frame] = _slotCount;
+    }
+}
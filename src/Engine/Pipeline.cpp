@@ -1,5 +1,7 @@
 #include <Engine/Pipeline.hpp>
 #include <Engine/Buffer.hpp>
+#include <Engine/RenderStatistics.hpp>
+#include <Engine/Texture.hpp>
 
 #include <glad/glad.h>
 
@@ -18,15 +20,30 @@ Pipeline::~Pipeline()
 
 void Pipeline::Use()
 {
+    GetRenderStatistics().PipelineChangeCount++;
     glBindProgramPipeline(Program);
 }
 
-void Pipeline::BindAsUniformBuffer(const std::unique_ptr<Buffer>& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size)
+void Pipeline::BindAsUniformBuffer(const Buffer& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size)
 {
-    glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, buffer->_id, offset, size);
+    GetRenderStatistics().BindingChangeCount++;
+    glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, buffer._id, offset, size);
 }
 
-void Pipeline::BindAsShaderStorageBuffer(const std::unique_ptr<Buffer>& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size)
+void Pipeline::BindAsShaderStorageBuffer(const Buffer& buffer, uint32_t bindingIndex, uint32_t offset, uint32_t size)
 {
-    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer->_id, offset, size);
+    GetRenderStatistics().BindingChangeCount++;
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer._id, offset, size);
+}
+
+void Pipeline::BindTexture(const Texture& texture, uint32_t unit)
+{
+    GetRenderStatistics().BindingChangeCount++;
+    glBindTextureUnit(unit, texture._id);
+}
+
+void Pipeline::BindImage(const Texture& texture, uint32_t unit, uint32_t level, uint32_t access, uint32_t format)
+{
+    GetRenderStatistics().BindingChangeCount++;
+    glBindImageTexture(unit, texture._id, level, GL_FALSE, 0, access, format);
 }
\ No newline at end of file
@@ -0,0 +1,785 @@
+#include <Engine/RenderGraph.hpp>
+#include <Engine/RenderStatistics.hpp>
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <format>
+
+namespace
+{
+    constexpr uint32_t MaxColorAttachmentCount = 8;
+
+    // The bit making incoherent shader writes visible to the given kind of access
+    uint32_t GetBarrierBit(RenderGraphAccess access) noexcept
+    {
+        switch (access)
+        {
+            case RenderGraphAccess::ColorAttachment:
+            case RenderGraphAccess::DepthAttachment:
+            case RenderGraphAccess::Copy: return GL_FRAMEBUFFER_BARRIER_BIT;
+            case RenderGraphAccess::Sampled: return GL_TEXTURE_FETCH_BARRIER_BIT;
+            case RenderGraphAccess::Image: return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+            case RenderGraphAccess::ShaderStorage: return GL_SHADER_STORAGE_BARRIER_BIT;
+            case RenderGraphAccess::Uniform: return GL_UNIFORM_BARRIER_BIT;
+            case RenderGraphAccess::Indirect: return GL_COMMAND_BARRIER_BIT;
+            default: return 0;
+        }
+    }
+
+    // Image stores and storage buffer writes are the ones GL does not order with what follows
+    bool IsIncoherentWrite(RenderGraphAccess access) noexcept
+    {
+        return access == RenderGraphAccess::Image || access == RenderGraphAccess::ShaderStorage;
+    }
+
+    bool IsAttachment(RenderGraphAccess access) noexcept
+    {
+        return access == RenderGraphAccess::ColorAttachment || access == RenderGraphAccess::DepthAttachment;
+    }
+
+    bool IsDepthFormat(uint32_t format) noexcept
+    {
+        switch (format)
+        {
+            case GL_DEPTH_COMPONENT16:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32F:
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH32F_STENCIL8: return true;
+            default: return false;
+        }
+    }
+
+    double ToMebibytes(uint64_t byteCount) noexcept
+    {
+        return static_cast<double>(byteCount) / (1024.0 * 1024.0);
+    }
+}
+
+const Texture& RenderGraphContext::GetTexture(RenderGraphTexture texture) const noexcept
+{
+    return _renderGraph.GetTexture(texture.Index);
+}
+
+const Buffer& RenderGraphContext::GetBuffer(RenderGraphBuffer buffer) const noexcept
+{
+    return _renderGraph.GetBuffer(buffer.Index);
+}
+
+void RenderGraphContext::Blit(RenderGraphTexture source, RenderGraphTexture destination) const noexcept
+{
+    _renderGraph.Blit(source.Index, destination.Index);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphTexture texture, RenderGraphAccess access)
+{
+    return AddAccess(texture.Index, access, false);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphBuffer buffer, RenderGraphAccess access)
+{
+    return AddAccess(buffer.Index, access, false);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphTexture texture, RenderGraphAccess access)
+{
+    return AddAccess(texture.Index, access, true);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphBuffer buffer, RenderGraphAccess access)
+{
+    return AddAccess(buffer.Index, access, true);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::WriteColor(RenderGraphTexture texture, RenderGraphLoad load)
+{
+    return AddAccess(texture.Index, RenderGraphAccess::ColorAttachment, true, load);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::WriteDepth(RenderGraphTexture texture, RenderGraphLoad load)
+{
+    return AddAccess(texture.Index, RenderGraphAccess::DepthAttachment, true, load);
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::SetSideEffect() noexcept
+{
+    _renderGraph._passes[_pass].HasSideEffect = true;
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::AddAccess(uint32_t resource, RenderGraphAccess access, bool isWrite, RenderGraphLoad load)
+{
+    assert(resource < _renderGraph._resources.size() && "unknown resource");
+    _renderGraph._passes[_pass].Accesses.push_back(RenderGraph::Access
+    {
+        .Resource = resource,
+        .Type = access,
+        .IsWrite = isWrite,
+        .Load = load
+    });
+    _renderGraph._isCompiled = false;
+    return *this;
+}
+
+RenderGraph::RenderGraph() noexcept = default;
+
+RenderGraph::~RenderGraph()
+{
+    DeleteFramebuffers();
+    if (_blitFramebuffers[0] != 0)
+    {
+        glDeleteFramebuffers(2, _blitFramebuffers);
+    }
+}
+
+RenderGraphTexture RenderGraph::CreateTexture(std::string_view name, const RenderGraphTextureDescription& description)
+{
+    return { AddResource(Resource{ .Name = std::string(name), .Type = ResourceType::Texture, .TextureDescription = description }) };
+}
+
+RenderGraphBuffer RenderGraph::CreateBuffer(std::string_view name, const RenderGraphBufferDescription& description)
+{
+    return { AddResource(Resource{ .Name = std::string(name), .Type = ResourceType::Buffer, .BufferSize = description.Size }) };
+}
+
+RenderGraphTexture RenderGraph::ImportTexture(std::string_view name, const Texture& texture)
+{
+    return { AddResource(Resource{ .Name = std::string(name), .Type = ResourceType::Texture, .ImportedTexture = &texture, .IsImported = true }) };
+}
+
+RenderGraphBuffer RenderGraph::ImportBuffer(std::string_view name, const Buffer& buffer)
+{
+    return { AddResource(Resource{ .Name = std::string(name), .Type = ResourceType::Buffer, .ImportedBuffer = &buffer, .IsImported = true }) };
+}
+
+RenderGraphTexture RenderGraph::ImportBackbuffer()
+{
+    return { AddResource(Resource{ .Name = "Backbuffer", .Type = ResourceType::Texture, .IsImported = true, .IsBackbuffer = true }) };
+}
+
+RenderGraphPassBuilder RenderGraph::AddPass(std::string_view name, RenderGraphExecute execute)
+{
+    _passes.push_back(Pass{ .Name = std::string(name), .Execute = std::move(execute) });
+    _isCompiled = false;
+    return RenderGraphPassBuilder(*this, static_cast<uint32_t>(_passes.size() - 1));
+}
+
+void RenderGraph::Reset()
+{
+    DeleteFramebuffers();
+    _passes.clear();
+    _resources.clear();
+    _isCompiled = false;
+}
+
+void RenderGraph::SetFramebufferSize(uint32_t width, uint32_t height) noexcept
+{
+    if (width == _framebufferWidth && height == _framebufferHeight)
+    {
+        return;
+    }
+
+    _framebufferWidth = width;
+    _framebufferHeight = height;
+    _isCompiled = false;
+}
+
+void RenderGraph::SetRenderScale(float renderScale) noexcept
+{
+    if (renderScale == _renderScale)
+    {
+        return;
+    }
+
+    _renderScale = renderScale;
+    _isCompiled = false;
+}
+
+uint32_t RenderGraph::GetWidth(RenderGraphTexture texture) const noexcept
+{
+    return GetTextureWidth(_resources[texture.Index]);
+}
+
+uint32_t RenderGraph::GetHeight(RenderGraphTexture texture) const noexcept
+{
+    return GetTextureHeight(_resources[texture.Index]);
+}
+
+std::expected<void, std::string> RenderGraph::Compile()
+{
+    DeleteFramebuffers();
+    _memoryReport = {};
+
+    CullPasses();
+    if (auto lifetimesResult = ComputeLifetimes(); !lifetimesResult)
+    {
+        return lifetimesResult;
+    }
+    AllocateTextures();
+    AllocateBuffers();
+    if (auto framebuffersResult = CreateFramebuffers(); !framebuffersResult)
+    {
+        return framebuffersResult;
+    }
+
+    if (_blitFramebuffers[0] == 0)
+    {
+        glCreateFramebuffers(2, _blitFramebuffers);
+    }
+
+    spdlog::info("RenderGraph: {} of {} passes culled, {} transient textures in {}, {} transient buffers in {}, {:.1f} MiB instead of {:.1f} MiB",
+        _memoryReport.CulledPassCount,
+        _memoryReport.PassCount,
+        _memoryReport.TransientTextureCount,
+        _memoryReport.TextureCount,
+        _memoryReport.TransientBufferCount,
+        _memoryReport.BufferCount,
+        ToMebibytes(_memoryReport.ByteCount),
+        ToMebibytes(_memoryReport.NaiveByteCount));
+
+    _isCompiled = true;
+    return {};
+}
+
+void RenderGraph::Execute()
+{
+    if (!_isCompiled)
+    {
+        if (auto compileResult = Compile(); !compileResult)
+        {
+            spdlog::error("RenderGraph: {}", compileResult.error());
+            return;
+        }
+    }
+
+    // Transient contents do not outlive the frame, neither do their pending writes
+    for (auto& resource : _resources)
+    {
+        if (!resource.IsImported)
+        {
+            resource.HasIncoherentWrite = false;
+            resource.IssuedBarrierBits = 0;
+        }
+    }
+
+    auto context = RenderGraphContext(*this);
+    for (auto& pass : _passes)
+    {
+        if (pass.IsCulled)
+        {
+            continue;
+        }
+
+        IssueBarriers(pass);
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, static_cast<GLsizei>(pass.Name.size()), pass.Name.data());
+        BeginPass(pass);
+        pass.Execute(context);
+        glPopDebugGroup();
+    }
+
+    // Whatever draws after the graph, the debug overlay for one, expects the default framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, _framebufferWidth, _framebufferHeight);
+}
+
+uint32_t RenderGraph::AddResource(Resource&& resource)
+{
+    _resources.push_back(std::move(resource));
+    _isCompiled = false;
+    return static_cast<uint32_t>(_resources.size() - 1);
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walking backwards, a pass lives if it has side effects, writes an imported resource or writes what
+    // a living pass after it still needs. Writes that replace a resource entirely end the need for it
+    std::vector<bool> isNeeded(_resources.size(), false);
+    _memoryReport.PassCount = static_cast<uint32_t>(_passes.size());
+    for (auto passIndex = _passes.size(); passIndex-- > 0;)
+    {
+        auto& pass = _passes[passIndex];
+        pass.IsCulled = !pass.HasSideEffect;
+        for (auto& access : pass.Accesses)
+        {
+            if (access.IsWrite && (_resources[access.Resource].IsImported || isNeeded[access.Resource]))
+            {
+                pass.IsCulled = false;
+            }
+        }
+
+        if (pass.IsCulled)
+        {
+            _memoryReport.CulledPassCount++;
+            continue;
+        }
+
+        for (auto& access : pass.Accesses)
+        {
+            auto isReplaced = access.IsWrite && (access.Load == RenderGraphLoad::Clear || !IsAttachment(access.Type));
+            if (isReplaced)
+            {
+                isNeeded[access.Resource] = false;
+            }
+        }
+        for (auto& access : pass.Accesses)
+        {
+            auto isLoaded = access.IsWrite && IsAttachment(access.Type) && access.Load == RenderGraphLoad::Load;
+            if (!access.IsWrite || isLoaded)
+            {
+                isNeeded[access.Resource] = true;
+            }
+        }
+    }
+}
+
+std::expected<void, std::string> RenderGraph::ComputeLifetimes()
+{
+    for (auto& resource : _resources)
+    {
+        resource.FirstPass = InvalidRenderGraphResource;
+        resource.LastPass = 0;
+        resource.Allocation = InvalidRenderGraphResource;
+    }
+
+    for (auto passIndex = 0u; passIndex < _passes.size(); passIndex++)
+    {
+        auto& pass = _passes[passIndex];
+        if (pass.IsCulled)
+        {
+            continue;
+        }
+
+        for (auto& access : pass.Accesses)
+        {
+            auto& resource = _resources[access.Resource];
+            if (resource.IsBackbuffer && access.Type != RenderGraphAccess::ColorAttachment && access.Type != RenderGraphAccess::Copy)
+            {
+                return std::unexpected(std::format("Pass {} can only draw or blit into the backbuffer", pass.Name));
+            }
+
+            auto isFirstAccess = resource.FirstPass == InvalidRenderGraphResource;
+            auto isLoaded = !access.IsWrite || (IsAttachment(access.Type) && access.Load == RenderGraphLoad::Load);
+            if (isFirstAccess && isLoaded && !resource.IsImported)
+            {
+                return std::unexpected(std::format("Pass {} reads {} before any pass wrote it", pass.Name, resource.Name));
+            }
+
+            resource.FirstPass = std::min(resource.FirstPass, passIndex);
+            resource.LastPass = passIndex;
+        }
+    }
+    return {};
+}
+
+void RenderGraph::AllocateTextures()
+{
+    for (auto& allocation : _textureAllocations)
+    {
+        allocation.IsUsed = false;
+    }
+
+    std::vector<uint32_t> textures;
+    for (auto resourceIndex = 0u; resourceIndex < _resources.size(); resourceIndex++)
+    {
+        auto& resource = _resources[resourceIndex];
+        if (resource.Type == ResourceType::Texture && !resource.IsImported && resource.FirstPass != InvalidRenderGraphResource)
+        {
+            textures.push_back(resourceIndex);
+        }
+    }
+    std::ranges::sort(textures, {}, [&](uint32_t resource) { return _resources[resource].FirstPass; });
+
+    // A texture takes over an allocation of the same format and size whose last user ran before its first,
+    // allocations of a previous compile are reused the same way before anything new is created
+    for (auto resourceIndex : textures)
+    {
+        auto& resource = _resources[resourceIndex];
+        auto& description = resource.TextureDescription;
+        auto width = GetTextureWidth(resource);
+        auto height = GetTextureHeight(resource);
+
+        auto allocation = std::ranges::find_if(_textureAllocations, [&](const TextureAllocation& textureAllocation)
+        {
+            return (!textureAllocation.IsUsed || textureAllocation.LastPass < resource.FirstPass) &&
+                textureAllocation.Width == width &&
+                textureAllocation.Height == height &&
+                textureAllocation.Format == description.Format &&
+                textureAllocation.LevelCount == description.LevelCount;
+        });
+        if (allocation == _textureAllocations.end())
+        {
+            auto& newAllocation = _textureAllocations.emplace_back();
+            newAllocation.Storage = Texture::Create2D(std::format("Texture_RenderGraph_{}", resource.Name), width, height, description.Format, description.LevelCount);
+            if (IsDepthFormat(description.Format))
+            {
+                // Depth is read with texelFetch, filtering would only get in the way
+                newAllocation.Storage.SetFilter(GL_NEAREST, GL_NEAREST);
+            }
+            newAllocation.Width = width;
+            newAllocation.Height = height;
+            newAllocation.Format = description.Format;
+            newAllocation.LevelCount = description.LevelCount;
+            allocation = _textureAllocations.end() - 1;
+        }
+
+        allocation->IsUsed = true;
+        allocation->LastPass = resource.LastPass;
+        resource.Allocation = static_cast<uint32_t>(allocation - _textureAllocations.begin());
+
+        _memoryReport.TransientTextureCount++;
+        _memoryReport.NaiveByteCount += Texture::GetByteCount(width, height, description.Format, description.LevelCount);
+    }
+
+    // Whatever no texture took, sized for a framebuffer that is gone, goes
+    std::vector<uint32_t> remap(_textureAllocations.size(), InvalidRenderGraphResource);
+    auto keptCount = 0u;
+    for (auto allocationIndex = 0u; allocationIndex < _textureAllocations.size(); allocationIndex++)
+    {
+        if (_textureAllocations[allocationIndex].IsUsed)
+        {
+            remap[allocationIndex] = keptCount;
+            if (keptCount != allocationIndex)
+            {
+                _textureAllocations[keptCount] = std::move(_textureAllocations[allocationIndex]);
+            }
+            keptCount++;
+        }
+    }
+    _textureAllocations.resize(keptCount);
+    for (auto resourceIndex : textures)
+    {
+        _resources[resourceIndex].Allocation = remap[_resources[resourceIndex].Allocation];
+    }
+
+    for (auto& allocation : _textureAllocations)
+    {
+        _memoryReport.TextureCount++;
+        _memoryReport.ByteCount += Texture::GetByteCount(allocation.Width, allocation.Height, allocation.Format, allocation.LevelCount);
+    }
+}
+
+void RenderGraph::AllocateBuffers()
+{
+    for (auto& allocation : _bufferAllocations)
+    {
+        allocation.IsUsed = false;
+        allocation.Size = 0;
+    }
+
+    std::vector<uint32_t> buffers;
+    for (auto resourceIndex = 0u; resourceIndex < _resources.size(); resourceIndex++)
+    {
+        auto& resource = _resources[resourceIndex];
+        if (resource.Type == ResourceType::Buffer && !resource.IsImported && resource.FirstPass != InvalidRenderGraphResource)
+        {
+            buffers.push_back(resourceIndex);
+        }
+    }
+    std::ranges::sort(buffers, {}, [&](uint32_t resource) { return _resources[resource].FirstPass; });
+
+    // Any free allocation will do, growing to the largest buffer it holds, the best fit grows the least
+    for (auto resourceIndex : buffers)
+    {
+        auto& resource = _resources[resourceIndex];
+        auto bestAllocation = InvalidRenderGraphResource;
+        auto bestGrowth = UINT32_MAX;
+        for (auto allocationIndex = 0u; allocationIndex < _bufferAllocations.size(); allocationIndex++)
+        {
+            auto& allocation = _bufferAllocations[allocationIndex];
+            if (allocation.IsUsed && allocation.LastPass >= resource.FirstPass)
+            {
+                continue;
+            }
+
+            auto growth = resource.BufferSize > allocation.Storage.GetSize() ? resource.BufferSize - allocation.Storage.GetSize() : 0u;
+            if (growth < bestGrowth)
+            {
+                bestAllocation = allocationIndex;
+                bestGrowth = growth;
+            }
+        }
+        if (bestAllocation == InvalidRenderGraphResource)
+        {
+            bestAllocation = static_cast<uint32_t>(_bufferAllocations.size());
+            _bufferAllocations.emplace_back();
+        }
+
+        auto& allocation = _bufferAllocations[bestAllocation];
+        allocation.IsUsed = true;
+        allocation.LastPass = resource.LastPass;
+        allocation.Size = std::max(allocation.Size, resource.BufferSize);
+        resource.Allocation = bestAllocation;
+
+        _memoryReport.TransientBufferCount++;
+        _memoryReport.NaiveByteCount += resource.BufferSize;
+    }
+
+    // Only unused buffers are dropped and only those that have to grow are created again
+    std::vector<uint32_t> remap(_bufferAllocations.size(), InvalidRenderGraphResource);
+    auto keptCount = 0u;
+    for (auto allocationIndex = 0u; allocationIndex < _bufferAllocations.size(); allocationIndex++)
+    {
+        auto& allocation = _bufferAllocations[allocationIndex];
+        if (!allocation.IsUsed)
+        {
+            continue;
+        }
+
+        if (allocation.Storage.GetSize() < allocation.Size)
+        {
+            allocation.Storage = Buffer::Create(std::format("Buffer_RenderGraph_{}", allocationIndex), allocation.Size, GL_SHADER_STORAGE_BUFFER, 0);
+        }
+        remap[allocationIndex] = keptCount;
+        if (keptCount != allocationIndex)
+        {
+            _bufferAllocations[keptCount] = std::move(allocation);
+        }
+        keptCount++;
+    }
+    _bufferAllocations.resize(keptCount);
+    for (auto resourceIndex : buffers)
+    {
+        _resources[resourceIndex].Allocation = remap[_resources[resourceIndex].Allocation];
+    }
+
+    for (auto& allocation : _bufferAllocations)
+    {
+        _memoryReport.BufferCount++;
+        _memoryReport.ByteCount += allocation.Storage.GetSize();
+    }
+}
+
+std::expected<void, std::string> RenderGraph::CreateFramebuffers()
+{
+    for (auto& pass : _passes)
+    {
+        pass.Framebuffer = 0;
+        pass.HasAttachments = false;
+        if (pass.IsCulled)
+        {
+            continue;
+        }
+
+        std::array<uint32_t, MaxColorAttachmentCount> drawBuffers = {};
+        auto colorAttachmentCount = 0u;
+        auto drawsIntoBackbuffer = false;
+        for (auto& access : pass.Accesses)
+        {
+            if (!IsAttachment(access.Type))
+            {
+                continue;
+            }
+
+            auto& resource = _resources[access.Resource];
+            pass.HasAttachments = true;
+            pass.Width = GetTextureWidth(resource);
+            pass.Height = GetTextureHeight(resource);
+            if (resource.IsBackbuffer)
+            {
+                drawsIntoBackbuffer = true;
+                continue;
+            }
+
+            if (pass.Framebuffer == 0)
+            {
+                glCreateFramebuffers(1, &pass.Framebuffer);
+                glObjectLabel(GL_FRAMEBUFFER, pass.Framebuffer, static_cast<GLsizei>(pass.Name.size()), pass.Name.data());
+            }
+
+            auto& texture = GetTexture(access.Resource);
+            if (access.Type == RenderGraphAccess::DepthAttachment)
+            {
+                glNamedFramebufferTexture(pass.Framebuffer, GL_DEPTH_ATTACHMENT, texture._id, 0);
+            }
+            else
+            {
+                if (colorAttachmentCount == MaxColorAttachmentCount)
+                {
+                    return std::unexpected(std::format("Pass {} has more than {} color attachments", pass.Name, MaxColorAttachmentCount));
+                }
+                drawBuffers[colorAttachmentCount] = GL_COLOR_ATTACHMENT0 + colorAttachmentCount;
+                glNamedFramebufferTexture(pass.Framebuffer, drawBuffers[colorAttachmentCount], texture._id, 0);
+                colorAttachmentCount++;
+            }
+        }
+
+        if (drawsIntoBackbuffer && pass.Framebuffer != 0)
+        {
+            return std::unexpected(std::format("Pass {} mixes the backbuffer with other attachments", pass.Name));
+        }
+        if (pass.Framebuffer != 0)
+        {
+            glNamedFramebufferDrawBuffers(pass.Framebuffer, static_cast<GLsizei>(colorAttachmentCount), drawBuffers.data());
+            if (auto status = glCheckNamedFramebufferStatus(pass.Framebuffer, GL_FRAMEBUFFER); status != GL_FRAMEBUFFER_COMPLETE)
+            {
+                return std::unexpected(std::format("Framebuffer of pass {} is incomplete, status {:#x}", pass.Name, status));
+            }
+        }
+    }
+    return {};
+}
+
+void RenderGraph::DeleteFramebuffers() noexcept
+{
+    for (auto& pass : _passes)
+    {
+        if (pass.Framebuffer != 0)
+        {
+            glDeleteFramebuffers(1, &pass.Framebuffer);
+            pass.Framebuffer = 0;
+        }
+    }
+}
+
+void RenderGraph::IssueBarriers(const Pass& pass)
+{
+    auto barrierBits = 0u;
+    for (auto& access : pass.Accesses)
+    {
+        auto& resource = _resources[access.Resource];
+        auto barrierBit = GetBarrierBit(access.Type);
+        if (resource.HasIncoherentWrite && (resource.IssuedBarrierBits & barrierBit) == 0)
+        {
+            barrierBits |= barrierBit;
+        }
+    }
+
+    if (barrierBits != 0)
+    {
+        glMemoryBarrier(barrierBits);
+        GetRenderStatistics().BarrierCount++;
+    }
+
+    for (auto& access : pass.Accesses)
+    {
+        auto& resource = _resources[access.Resource];
+        resource.IssuedBarrierBits |= barrierBits;
+        if (access.IsWrite && IsIncoherentWrite(access.Type))
+        {
+            resource.HasIncoherentWrite = true;
+            resource.IssuedBarrierBits = 0;
+        }
+    }
+}
+
+void RenderGraph::BeginPass(const Pass& pass) const
+{
+    if (!pass.HasAttachments)
+    {
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, pass.Framebuffer);
+    glViewport(0, 0, pass.Width, pass.Height);
+
+    auto colorAttachment = 0;
+    for (auto& access : pass.Accesses)
+    {
+        if (!IsAttachment(access.Type))
+        {
+            continue;
+        }
+
+        auto isColor = access.Type == RenderGraphAccess::ColorAttachment;
+        if (access.Load == RenderGraphLoad::Clear)
+        {
+            if (isColor)
+            {
+                auto& clearColor = _resources[access.Resource].TextureDescription.ClearColor;
+                glClearNamedFramebufferfv(pass.Framebuffer, GL_COLOR, colorAttachment, &clearColor.x);
+            }
+            else
+            {
+                auto clearDepth = 1.0f;
+                glClearNamedFramebufferfv(pass.Framebuffer, GL_DEPTH, 0, &clearDepth);
+            }
+        }
+        colorAttachment += isColor ? 1 : 0;
+    }
+}
+
+const Texture& RenderGraph::GetTexture(uint32_t resource) const noexcept
+{
+    auto& graphResource = _resources[resource];
+    assert(graphResource.Type == ResourceType::Texture && !graphResource.IsBackbuffer && "not a texture");
+    return graphResource.IsImported
+        ? *graphResource.ImportedTexture
+        : _textureAllocations[graphResource.Allocation].Storage;
+}
+
+const Buffer& RenderGraph::GetBuffer(uint32_t resource) const noexcept
+{
+    auto& graphResource = _resources[resource];
+    assert(graphResource.Type == ResourceType::Buffer && "not a buffer");
+    return graphResource.IsImported
+        ? *graphResource.ImportedBuffer
+        : _bufferAllocations[graphResource.Allocation].Storage;
+}
+
+void RenderGraph::Blit(uint32_t source, uint32_t destination) const noexcept
+{
+    auto& sourceTexture = GetTexture(source);
+    glNamedFramebufferTexture(_blitFramebuffers[0], GL_COLOR_ATTACHMENT0, sourceTexture._id, 0);
+
+    auto& destinationResource = _resources[destination];
+    auto destinationFramebuffer = 0u;
+    if (!destinationResource.IsBackbuffer)
+    {
+        destinationFramebuffer = _blitFramebuffers[1];
+        glNamedFramebufferTexture(destinationFramebuffer, GL_COLOR_ATTACHMENT0, GetTexture(destination)._id, 0);
+    }
+
+    glBlitNamedFramebuffer(
+        _blitFramebuffers[0],
+        destinationFramebuffer,
+        0,
+        0,
+        sourceTexture.GetWidth(),
+        sourceTexture.GetHeight(),
+        0,
+        0,
+        GetTextureWidth(destinationResource),
+        GetTextureHeight(destinationResource),
+        GL_COLOR_BUFFER_BIT,
+        GL_LINEAR);
+}
+
+uint32_t RenderGraph::GetTextureWidth(const Resource& resource) const noexcept
+{
+    if (resource.IsBackbuffer)
+    {
+        return _framebufferWidth;
+    }
+    if (resource.IsImported)
+    {
+        return resource.ImportedTexture->GetWidth();
+    }
+
+    auto& description = resource.TextureDescription;
+    auto scale = description.FollowsRenderScale ? description.Scale * _renderScale : description.Scale;
+    return description.Width != 0
+        ? description.Width
+        : std::max(static_cast<uint32_t>(static_cast<float>(_framebufferWidth) * scale), 1u);
+}
+
+uint32_t RenderGraph::GetTextureHeight(const Resource& resource) const noexcept
+{
+    if (resource.IsBackbuffer)
+    {
+        return _framebufferHeight;
+    }
+    if (resource.IsImported)
+    {
+        return resource.ImportedTexture->GetHeight();
+    }
+
+    auto& description = resource.TextureDescription;
+    auto scale = description.FollowsRenderScale ? description.Scale * _renderScale : description.Scale;
+    return description.Height != 0
+        ? description.Height
+        : std::max(static_cast<uint32_t>(static_cast<float>(_framebufferHeight) * scale), 1u);
+}
@@ -0,0 +1,249 @@
+#include <Engine/RenderQueue.hpp>
+#include <Engine/Buffer.hpp>
+#include <Engine/GraphicsPipeline.hpp>
+#include <Engine/RenderStatistics.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    // Chunks below this many entries are not worth a worker
+    constexpr uint32_t MinParallelChunkSize = 4096;
+
+    void ApplyBindings(GraphicsPipeline& pipeline, const RenderBindingSet& bindings)
+    {
+        for (auto i = 0u; i < bindings.BindingCount; i++)
+        {
+            auto& binding = bindings.Bindings[i];
+            switch (binding.Type)
+            {
+                case RenderBindingType::UniformBuffer:
+                    pipeline.BindAsUniformBuffer(*binding.BoundBuffer, binding.Index, 0, binding.BoundBuffer->GetSize());
+                    break;
+                case RenderBindingType::ShaderStorageBuffer:
+                    pipeline.BindAsShaderStorageBuffer(*binding.BoundBuffer, binding.Index, 0, binding.BoundBuffer->GetSize());
+                    break;
+                case RenderBindingType::Texture:
+                    pipeline.BindTexture(*binding.BoundTexture, binding.Index);
+                    break;
+            }
+        }
+    }
+
+    // Pipeline, geometry and material switches between neighbouring items
+    struct StateTracker
+    {
+        const GraphicsPipeline* Pipeline = nullptr;
+        const RenderBindingSet* Geometry = nullptr;
+        const RenderBindingSet* Material = nullptr;
+        uint32_t ChangeCount = 0;
+
+        void Track(const RenderItem& item, bool& isPipelineChanged, bool& isGeometryChanged, bool& isMaterialChanged) noexcept
+        {
+            isPipelineChanged = item.Pipeline != Pipeline;
+            isGeometryChanged = item.Geometry != Geometry;
+            isMaterialChanged = item.Material != Material;
+            ChangeCount += (isPipelineChanged ? 1 : 0) + (isGeometryChanged ? 1 : 0) + (isMaterialChanged ? 1 : 0);
+            Pipeline = item.Pipeline;
+            Geometry = item.Geometry;
+            Material = item.Material;
+        }
+    };
+}
+
+uint32_t QuantizeRenderDepth(float depth, float farDepth, bool isBackToFront) noexcept
+{
+    constexpr auto MaxDepth = (1u << RenderKeyFields::DepthBitCount) - 1;
+    auto normalizedDepth = std::clamp(depth / farDepth, 0.0f, 1.0f);
+    auto quantizedDepth = static_cast<uint32_t>(std::lround(normalizedDepth * static_cast<float>(MaxDepth)));
+    return isBackToFront ? MaxDepth - quantizedDepth : quantizedDepth;
+}
+
+void RenderQueue::Clear() noexcept
+{
+    _items.clear();
+    _entries.clear();
+}
+
+void RenderQueue::Add(uint64_t key, const RenderItem& item)
+{
+    _entries.push_back(SortEntry{ key, static_cast<uint32_t>(_items.size()) });
+    _items.push_back(item);
+}
+
+void RenderQueue::Sort(TaskScheduler* taskScheduler)
+{
+    auto& renderStatistics = GetRenderStatistics();
+    renderStatistics.QueuedDrawCount += GetCount();
+    renderStatistics.UnsortedStateChangeCount += CountStateChanges();
+
+    auto count = static_cast<uint32_t>(_entries.size());
+    if (count < 2)
+    {
+        return;
+    }
+
+    auto chunkCount = 1u;
+    if (taskScheduler != nullptr && count >= ParallelSortThreshold)
+    {
+        chunkCount = std::clamp(count / MinParallelChunkSize, 1u, taskScheduler->GetWorkerCount() + 1);
+    }
+    auto chunkSize = (count + chunkCount - 1) / chunkCount;
+    auto forEachChunk = [&](auto&& body)
+    {
+        if (chunkCount == 1)
+        {
+            body(0u, 0u, count);
+            return;
+        }
+
+        taskScheduler->ParallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for (auto chunk = begin; chunk < end; chunk++)
+            {
+                body(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+            }
+        });
+    };
+
+    // Histograms of every digit in one read, digits all keys share need no pass at all
+    _histograms.assign(static_cast<size_t>(chunkCount) * RadixPassCount, Histogram{});
+    forEachChunk([this](uint32_t chunk, uint32_t begin, uint32_t end)
+    {
+        auto histograms = &_histograms[static_cast<size_t>(chunk) * RadixPassCount];
+        for (auto i = begin; i < end; i++)
+        {
+            auto key = _entries[i].Key;
+            for (auto pass = 0u; pass < RadixPassCount; pass++)
+            {
+                histograms[pass][(key >> (pass * RadixBitCount)) & (RadixBucketCount - 1)]++;
+            }
+        }
+    });
+
+    _sortScratch.resize(count);
+    auto isFirstPass = true;
+    for (auto pass = 0u; pass < RadixPassCount; pass++)
+    {
+        auto shift = pass * RadixBitCount;
+        auto firstDigit = (_entries[0].Key >> shift) & (RadixBucketCount - 1);
+        auto firstDigitCount = 0u;
+        for (auto chunk = 0u; chunk < chunkCount; chunk++)
+        {
+            firstDigitCount += _histograms[chunk * RadixPassCount + pass][firstDigit];
+        }
+        if (firstDigitCount == count)
+        {
+            continue;
+        }
+
+        // Earlier passes reordered the entries, so the chunks' histograms of this digit are stale
+        if (!isFirstPass)
+        {
+            forEachChunk([this, pass, shift](uint32_t chunk, uint32_t begin, uint32_t end)
+            {
+                auto& histogram = _histograms[chunk * RadixPassCount + pass];
+                histogram.fill(0);
+                for (auto i = begin; i < end; i++)
+                {
+                    histogram[(_entries[i].Key >> shift) & (RadixBucketCount - 1)]++;
+                }
+            });
+        }
+        isFirstPass = false;
+
+        // Counts become scatter offsets, bucket major so chunks keep their order within a bucket
+        auto offset = 0u;
+        for (auto bucket = 0u; bucket < RadixBucketCount; bucket++)
+        {
+            for (auto chunk = 0u; chunk < chunkCount; chunk++)
+            {
+                auto& histogramCount = _histograms[chunk * RadixPassCount + pass][bucket];
+                offset += std::exchange(histogramCount, offset);
+            }
+        }
+
+        forEachChunk([this, pass, shift](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            auto& offsets = _histograms[chunk * RadixPassCount + pass];
+            for (auto i = begin; i < end; i++)
+            {
+                auto& entry = _entries[i];
+                _sortScratch[offsets[(entry.Key >> shift) & (RadixBucketCount - 1)]++] = entry;
+            }
+        });
+        std::swap(_entries, _sortScratch);
+    }
+}
+
+void RenderQueue::Submit()
+{
+    SubmitEntries(_entries);
+}
+
+void RenderQueue::Submit(uint32_t pass)
+{
+    constexpr auto PassShift = 64 - RenderKeyFields::PassBitCount;
+    auto first = std::ranges::partition_point(_entries, [pass](const SortEntry& entry)
+    {
+        return (entry.Key >> PassShift) < pass;
+    });
+    auto last = std::ranges::partition_point(first, _entries.end(), [pass](const SortEntry& entry)
+    {
+        return (entry.Key >> PassShift) <= pass;
+    });
+    SubmitEntries(std::span(first, last));
+}
+
+void RenderQueue::SubmitEntries(std::span<const SortEntry> entries)
+{
+    StateTracker state;
+    for (auto& entry : entries)
+    {
+        auto& item = _items[entry.Item];
+        auto isPipelineChanged = false;
+        auto isGeometryChanged = false;
+        auto isMaterialChanged = false;
+        state.Track(item, isPipelineChanged, isGeometryChanged, isMaterialChanged);
+
+        if (isPipelineChanged)
+        {
+            item.Pipeline->Use();
+        }
+        if (isGeometryChanged && item.Geometry != nullptr)
+        {
+            ApplyBindings(*item.Pipeline, *item.Geometry);
+        }
+        if (isMaterialChanged && item.Material != nullptr)
+        {
+            ApplyBindings(*item.Pipeline, *item.Material);
+        }
+
+        if (item.IndirectBuffer != nullptr)
+        {
+            item.Pipeline->DrawArraysIndirect(*item.IndirectBuffer, item.IndirectOffset);
+        }
+        else
+        {
+            item.Pipeline->DrawArraysInstanced(item.ElementCount, item.InstanceCount, item.ElementOffset, item.BaseInstance);
+        }
+    }
+
+    GetRenderStatistics().SortedStateChangeCount += state.ChangeCount;
+}
+
+uint32_t RenderQueue::CountStateChanges() const noexcept
+{
+    StateTracker state;
+    for (auto& item : _items)
+    {
+        auto isPipelineChanged = false;
+        auto isGeometryChanged = false;
+        auto isMaterialChanged = false;
+        state.Track(item, isPipelineChanged, isGeometryChanged, isMaterialChanged);
+    }
+    return state.ChangeCount;
+}
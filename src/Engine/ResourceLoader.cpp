@@ -0,0 +1,190 @@
+#include <Engine/ResourceLoader.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+
+ResourceLoader::ResourceLoader(GLFWwindow* window, const ResourceLoaderSettings& settings)
+    : _settings(settings)
+{
+    if (settings.UseSharedContext)
+    {
+        // Every other hint is still what the window was created with, so the contexts match
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        _sharedContext = glfwCreateWindow(1, 1, "ResourceLoader", nullptr, window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    }
+
+    if (_sharedContext == nullptr)
+    {
+        if (settings.UseSharedContext)
+        {
+            spdlog::warn("ResourceLoader: Unable to create a shared context");
+        }
+        spdlog::info("ResourceLoader: Uploading synchronously on the render thread");
+        _stagingUploader = std::make_unique<StagingUploader>(settings.StagingCapacity);
+        return;
+    }
+
+    _loader = std::jthread([this](std::stop_token stopToken)
+    {
+        LoaderLoop(stopToken);
+    });
+}
+
+ResourceLoader::~ResourceLoader()
+{
+    if (_loader.joinable())
+    {
+        _loader.request_stop();
+        _loader.join();
+    }
+
+    // Whatever the unpublished jobs made dies with them, on the render thread's context
+    for (auto& batch : _fencedBatches)
+    {
+        glDeleteSync(batch.Fence);
+    }
+    _fencedBatches.clear();
+    _jobs.clear();
+    _stagingUploader.reset();
+
+    if (_sharedContext != nullptr)
+    {
+        glfwDestroyWindow(_sharedContext);
+    }
+}
+
+void ResourceLoader::Enqueue(uint64_t byteCount, Job job, Completion completion)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.push_back(Upload{ .ByteCount = byteCount, .Work = std::move(job), .OnCompleted = std::move(completion) });
+    }
+    _jobQueued.notify_one();
+}
+
+void ResourceLoader::Publish()
+{
+    if (!IsAsynchronous())
+    {
+        RunSynchronous();
+        return;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _frameIndex++;
+
+        while (!_fencedBatches.empty())
+        {
+            auto& batch = _fencedBatches.front();
+            auto waitResult = glClientWaitSync(batch.Fence, 0, 0);
+            if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+            {
+                break;
+            }
+
+            glDeleteSync(batch.Fence);
+            for (auto& completion : batch.Completions)
+            {
+                _publishedCompletions.push_back(std::move(completion));
+            }
+            _fencedBatches.pop_front();
+        }
+    }
+    _jobQueued.notify_one();
+
+    // Outside the lock, completions may well enqueue more work
+    for (auto& completion : _publishedCompletions)
+    {
+        completion();
+    }
+    _publishedCompletions.clear();
+}
+
+void ResourceLoader::LoaderLoop(std::stop_token stopToken)
+{
+    glfwMakeContextCurrent(_sharedContext);
+    _stagingUploader = std::make_unique<StagingUploader>(_settings.StagingCapacity);
+
+    std::vector<Upload> jobs;
+    auto frameIndex = uint64_t(0);
+    auto frameByteCount = uint64_t(0);
+    while (true)
+    {
+        {
+            std::unique_lock lock(_mutex);
+            auto hasWork = _jobQueued.wait(lock, stopToken, [&]
+            {
+                return !_jobs.empty() && (frameByteCount < _settings.ByteBudgetPerFrame || _frameIndex != frameIndex);
+            });
+            if (!hasWork)
+            {
+                break;
+            }
+
+            if (_frameIndex != frameIndex)
+            {
+                frameIndex = _frameIndex;
+                frameByteCount = 0;
+            }
+            TakeJobs(jobs, frameByteCount);
+        }
+
+        Batch batch;
+        for (auto& job : jobs)
+        {
+            job.Work(*_stagingUploader);
+            batch.Completions.push_back(std::move(job.OnCompleted));
+        }
+        jobs.clear();
+
+        // Flushed so the render thread's context can see the fence signal at all
+        _stagingUploader->Flush();
+        batch.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard lock(_mutex);
+        _fencedBatches.push_back(std::move(batch));
+    }
+
+    // The staging ring's fences belong to this context
+    _stagingUploader.reset();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void ResourceLoader::TakeJobs(std::vector<Upload>& jobs, uint64_t& frameByteCount)
+{
+    while (!_jobs.empty() && frameByteCount < _settings.ByteBudgetPerFrame)
+    {
+        frameByteCount += _jobs.front().ByteCount;
+        jobs.push_back(std::move(_jobs.front()));
+        _jobs.pop_front();
+    }
+}
+
+void ResourceLoader::RunSynchronous()
+{
+    {
+        std::lock_guard lock(_mutex);
+        auto frameByteCount = uint64_t(0);
+        TakeJobs(_synchronousJobs, frameByteCount);
+    }
+
+    for (auto& job : _synchronousJobs)
+    {
+        job.Work(*_stagingUploader);
+    }
+
+    // Same context, the copies are ordered before anything the completions go on to draw
+    _stagingUploader->Flush();
+    for (auto& job : _synchronousJobs)
+    {
+        job.OnCompleted();
+    }
+    _synchronousJobs.clear();
+}
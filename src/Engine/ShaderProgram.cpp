@@ -0,0 +1,30 @@
+#include <Engine/ShaderProgram.hpp>
+
+#include <glad/glad.h>
+
+#include <format>
+
+std::expected<uint32_t, std::string> CreateShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::string_view shaderSource)
+{
+    auto shaderContent = shaderSource.data();
+    auto program = glCreateShaderProgramv(shaderType, 1, &shaderContent);
+    auto linkStatus = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+    if (linkStatus == GL_FALSE)
+    {
+        auto infoLogLength = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+        auto infoLog = std::string(infoLogLength + 1, '\0');
+        glGetProgramInfoLog(program, infoLogLength, nullptr, infoLog.data());
+
+        return std::unexpected(std::format("Unable to link \"{}\". Details: {}", label, infoLog));
+    }
+
+    glObjectLabel(GL_PROGRAM, program, label.size(), label.data());
+
+    return program;
+}
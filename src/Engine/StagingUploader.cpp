@@ -0,0 +1,207 @@
+#include <Engine/StagingUploader.hpp>
+#include <Engine/Texture.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    constexpr uint64_t BufferAlignment = 4;
+    // Pixel unpack offsets have to be a multiple of the texel size
+    constexpr uint64_t TextureAlignment = 16;
+    constexpr uint64_t FenceWaitNanoseconds = 1'000'000'000;
+}
+
+StagingUploader::StagingUploader(uint32_t capacity)
+    : _stagingBuffer(Buffer::Create(
+        "Buffer_Staging",
+        capacity,
+        GL_COPY_READ_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true))
+{
+    // The ring restarts at its beginning once drained, which has to be aligned for any write
+    assert(capacity % TextureAlignment == 0 && "StagingUploader: capacity must be a multiple of the texture alignment");
+    // Rows are tightly packed in the ring, the default of 4 would read past odd sized rows
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+}
+
+StagingUploader::~StagingUploader()
+{
+    for (auto& batch : _batches)
+    {
+        glDeleteSync(batch.Fence);
+    }
+}
+
+void StagingUploader::Write(const Buffer& destination, uint64_t destinationOffset, std::span<const std::byte> data)
+{
+    assert(destinationOffset + data.size() <= destination.GetSize() && "overflow");
+
+    auto stagingMemory = static_cast<std::byte*>(_stagingBuffer.GetMappedMemory());
+    while (!data.empty())
+    {
+        auto [sourceOffset, size] = Allocate(data.size(), 1, BufferAlignment);
+        std::memcpy(stagingMemory + sourceOffset, data.data(), size);
+
+        auto continuesLastCopy = !_bufferCopies.empty() &&
+            _bufferCopies.back().Destination == destination._id &&
+            _bufferCopies.back().DestinationOffset + _bufferCopies.back().Size == destinationOffset &&
+            _bufferCopies.back().SourceOffset + _bufferCopies.back().Size == sourceOffset;
+        if (continuesLastCopy)
+        {
+            _bufferCopies.back().Size += size;
+        }
+        else
+        {
+            _bufferCopies.push_back(BufferCopy
+            {
+                .Destination = destination._id,
+                .DestinationOffset = destinationOffset,
+                .SourceOffset = sourceOffset,
+                .Size = size
+            });
+        }
+
+        destinationOffset += size;
+        data = data.subspan(size);
+    }
+}
+
+void StagingUploader::Write(
+    const Texture& destination,
+    uint32_t level,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format,
+    uint32_t type,
+    std::span<const std::byte> data)
+{
+    assert(height > 0 && data.size() % height == 0 && "rows must be tightly packed");
+
+    auto stagingMemory = static_cast<std::byte*>(_stagingBuffer.GetMappedMemory());
+    auto rowByteCount = data.size() / height;
+
+    while (!data.empty())
+    {
+        auto [sourceOffset, size] = Allocate(data.size(), rowByteCount, TextureAlignment);
+        std::memcpy(stagingMemory + sourceOffset, data.data(), size);
+
+        auto rowCount = static_cast<uint32_t>(size / rowByteCount);
+        _textureCopies.push_back(TextureCopy
+        {
+            .Destination = destination._id,
+            .Level = level,
+            .X = x,
+            .Y = y,
+            .Width = width,
+            .Height = rowCount,
+            .Format = format,
+            .Type = type,
+            .SourceOffset = sourceOffset
+        });
+
+        y += rowCount;
+        data = data.subspan(size);
+    }
+}
+
+void StagingUploader::Flush()
+{
+    if (_bufferCopies.empty() && _textureCopies.empty())
+    {
+        return;
+    }
+
+    for (auto& copy : _bufferCopies)
+    {
+        glCopyNamedBufferSubData(_stagingBuffer._id, copy.Destination, copy.SourceOffset, copy.DestinationOffset, copy.Size);
+    }
+
+    if (!_textureCopies.empty())
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer._id);
+        for (auto& copy : _textureCopies)
+        {
+            glTextureSubImage2D(
+                copy.Destination,
+                copy.Level,
+                copy.X,
+                copy.Y,
+                copy.Width,
+                copy.Height,
+                copy.Format,
+                copy.Type,
+                reinterpret_cast<const void*>(copy.SourceOffset));
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    _batches.push_back(Batch{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), _head });
+    _bufferCopies.clear();
+    _textureCopies.clear();
+}
+
+std::pair<uint64_t, uint64_t> StagingUploader::Allocate(uint64_t size, uint64_t granularity, uint64_t alignment)
+{
+    auto capacity = static_cast<uint64_t>(_stagingBuffer.GetSize());
+    // A granule has to fit after the worst case alignment padding, or waiting never makes room for it
+    assert(granularity + alignment - 1 <= capacity && "StagingUploader: granule does not fit the staging ring");
+    while (true)
+    {
+        RetireBatches(false);
+        if (_tail == _head)
+        {
+            // Nothing in flight, start over at the beginning so the whole ring is contiguous again
+            _head = (_head + capacity - 1) / capacity * capacity;
+            _tail = _head;
+        }
+
+        auto position = (_head + alignment - 1) / alignment * alignment;
+        auto contiguousSize = capacity - position % capacity;
+        if (contiguousSize < granularity)
+        {
+            // Not even one granule fits before the end, start over at the beginning of the ring
+            position += contiguousSize;
+            contiguousSize = capacity;
+        }
+
+        auto freeSize = position - _tail < capacity ? _tail + capacity - position : 0;
+        auto allocatedSize = std::min({ size, contiguousSize, freeSize });
+        allocatedSize -= allocatedSize % granularity;
+        if (allocatedSize > 0)
+        {
+            _head = position + allocatedSize;
+            return { position % capacity, allocatedSize };
+        }
+
+        // The ring is full of data the GPU has not copied yet
+        Flush();
+        RetireBatches(true);
+    }
+}
+
+void StagingUploader::RetireBatches(bool isWaiting)
+{
+    while (!_batches.empty())
+    {
+        auto& batch = _batches.front();
+        auto waitResult = isWaiting
+            ? glClientWaitSync(batch.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceWaitNanoseconds)
+            : glClientWaitSync(batch.Fence, 0, 0);
+        if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+        {
+            return;
+        }
+
+        glDeleteSync(batch.Fence);
+        _tail = batch.End;
+        _batches.pop_front();
+        isWaiting = false;
+    }
+}
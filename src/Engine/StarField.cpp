@@ -0,0 +1,199 @@
+#include <Engine/StarField.hpp>
+#include <Engine/Device.hpp>
+#include <Engine/GraphicsPipeline.hpp>
+#include <Engine/GraphicsPipelineBuilder.hpp>
+#include <Engine/PrimitiveTopology.hpp>
+#include <Engine/VertexPulling.hpp>
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numbers>
+
+std::expected<StarField, std::string> StarField::Create(
+    Device& device,
+    const StarCatalog& catalog,
+    std::string_view vertexShaderFilePath,
+    std::string_view fragmentShaderFilePath,
+    const StarFieldSettings& settings)
+{
+    auto stars = catalog.GetStars();
+
+    auto pipelineResult = device.CreateGraphicsPipelineBuilder("Stars")
+        .WithShaders(vertexShaderFilePath, fragmentShaderFilePath)
+        .WithPrimitiveTopology(PrimitiveTopology::Points)
+        .Build();
+    if (!pipelineResult)
+    {
+        return std::unexpected(std::format("Unable to create star field. Details: {}", pipelineResult.error()));
+    }
+
+    auto starField = StarField();
+    starField._pipeline = std::move(pipelineResult.value());
+    starField._settings = settings;
+    starField._starCount = stars.size();
+    starField._cells.assign(catalog.GetCells().begin(), catalog.GetCells().end());
+
+    // Common drivers stop at 128 MiB or 2 GiB per storage block, far below a catalog of a hundred million stars
+    auto maxBlockSize = GLint64(0);
+    glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxBlockSize);
+    auto maxPageStarCount = static_cast<uint32_t>(std::clamp<GLint64>(maxBlockSize, sizeof(PackedStar), UINT32_MAX) / sizeof(PackedStar));
+
+    // The driver pages the stars in from the mapping itself, they never pass through a buffer of ours
+    auto addPage = [&](uint32_t firstStar, uint32_t endStar, uint32_t firstCell, uint32_t endCell)
+    {
+        auto& page = starField._starPages.emplace_back();
+        page.StarBuffer = Buffer::Create(
+            "Buffer_Stars",
+            std::max<uint32_t>((endStar - firstStar) * sizeof(PackedStar), sizeof(PackedStar)),
+            GL_SHADER_STORAGE_BUFFER,
+            0,
+            false,
+            endStar > firstStar ? stars.data() + firstStar : nullptr);
+        page.FirstStar = firstStar;
+        page.FirstCell = firstCell;
+        page.CellCount = endCell - firstCell;
+    };
+
+    // Cells are laid out in order, a page ends before the cell that would take it past the limit. A cell
+    // that alone exceeds it keeps its brightest stars
+    auto droppedStarCount = uint64_t(0);
+    auto pageFirstStar = 0u;
+    auto pageEndStar = 0u;
+    auto pageFirstCell = 0u;
+    for (auto cellIndex = 0u; cellIndex < starField._cells.size(); cellIndex++)
+    {
+        auto& cell = starField._cells[cellIndex];
+        if (cell.StarCount > maxPageStarCount)
+        {
+            droppedStarCount += cell.StarCount - maxPageStarCount;
+            cell.StarCount = maxPageStarCount;
+            for (auto& brighterStarCount : cell.BrighterStarCounts)
+            {
+                brighterStarCount = std::min(brighterStarCount, maxPageStarCount);
+            }
+        }
+        if (cell.StarCount == 0)
+        {
+            continue;
+        }
+
+        if (pageEndStar > pageFirstStar && cell.FirstStar + cell.StarCount - pageFirstStar > maxPageStarCount)
+        {
+            addPage(pageFirstStar, pageEndStar, pageFirstCell, cellIndex);
+            pageFirstStar = cell.FirstStar;
+            pageFirstCell = cellIndex;
+        }
+        pageEndStar = cell.FirstStar + cell.StarCount;
+    }
+    addPage(pageFirstStar, std::max(pageEndStar, pageFirstStar), pageFirstCell, static_cast<uint32_t>(starField._cells.size()));
+
+    if (droppedStarCount > 0)
+    {
+        spdlog::warn("StarField: Storage blocks are limited to {} MiB, the {} faintest stars of cells larger than that are dropped",
+            maxBlockSize / (1024 * 1024),
+            droppedStarCount);
+    }
+
+    starField._commandBuffer = Buffer::Create(
+        "Buffer_StarCommands",
+        sizeof(DrawCommand) * StarCatalogCellCount * settings.FrameCount,
+        GL_DRAW_INDIRECT_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true);
+    starField._uniformBuffer = Buffer::Create("Buffer_Uniforms_Stars", sizeof(StarUniforms), GL_UNIFORM_BUFFER, GL_DYNAMIC_STORAGE_BIT);
+    return starField;
+}
+
+StarField::StarField() noexcept = default;
+StarField::~StarField() = default;
+StarField::StarField(StarField&& other) noexcept = default;
+StarField& StarField::operator =(StarField&& other) noexcept = default;
+
+void StarField::Draw(
+    uint32_t frame,
+    const glm::mat4& view,
+    const glm::mat4& projection,
+    float fieldOfView,
+    uint32_t viewportWidth,
+    uint32_t viewportHeight)
+{
+    _statistics = {};
+
+    // A cone around the view direction reaching the viewport's corners
+    auto forward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+    auto tanHalfFieldOfView = std::tan(fieldOfView * 0.5f);
+    auto aspectRatio = static_cast<float>(std::max(viewportWidth, 1u)) / static_cast<float>(std::max(viewportHeight, 1u));
+    auto coneAngle = std::atan(tanHalfFieldOfView * std::sqrt(1.0f + aspectRatio * aspectRatio));
+    auto pixelsPerRadian = static_cast<float>(std::max(viewportHeight, 1u)) / (2.0f * tanHalfFieldOfView);
+
+    auto firstCommand = (frame % _settings.FrameCount) * StarCatalogCellCount;
+    auto commands = static_cast<DrawCommand*>(_commandBuffer.GetMappedMemory()) + firstCommand;
+    auto commandCount = 0u;
+    for (auto& page : _starPages)
+    {
+        page.FirstCommand = commandCount;
+        for (auto cellIndex = page.FirstCell; cellIndex < page.FirstCell + page.CellCount; cellIndex++)
+        {
+            auto& cell = _cells[cellIndex];
+            auto angle = coneAngle + cell.Radius;
+            if (cell.StarCount == 0 || (angle < std::numbers::pi_v<float> && glm::dot(cell.Center, forward) < std::cos(angle)))
+            {
+                continue;
+            }
+
+            // Screen area of the cell's bounding cone, an overestimate near the edges where it is partly outside
+            auto cellPixelRadius = std::max(cell.Radius, 1e-3f) * pixelsPerRadian;
+            auto maxStarCount = std::numbers::pi_v<float> * cellPixelRadius * cellPixelRadius * _settings.MaxStarsPerPixel;
+            auto starCount = std::min(cell.GetStarCount(_settings.LimitingMagnitude), static_cast<uint32_t>(std::min(maxStarCount, 4e9f)));
+            _statistics.VisibleCellCount++;
+            _statistics.DrawnStarCount += starCount;
+            _statistics.SkippedStarCount += cell.StarCount - starCount;
+            if (starCount > 0)
+            {
+                commands[commandCount++] = DrawCommand{ .Count = starCount, .InstanceCount = 1, .First = cell.FirstStar - page.FirstStar, .BaseInstance = 0 };
+            }
+        }
+        page.CommandCount = commandCount - page.FirstCommand;
+    }
+    if (commandCount == 0)
+    {
+        return;
+    }
+
+    // Stars are directions, the camera's position plays no part
+    auto viewRotation = view;
+    viewRotation[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    StarUniforms uniforms =
+    {
+        .ViewProjection = projection * viewRotation,
+        .Parameters = glm::vec4(_settings.ReferenceMagnitude, _settings.LimitingMagnitude, 0.0f, 0.0f)
+    };
+    _uniformBuffer.Write(&uniforms, sizeof(StarUniforms), 0);
+
+    // Added up, behind whatever depth the scene left, without writing depth of their own
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDepthMask(GL_FALSE);
+
+    _pipeline->Use();
+    _pipeline->BindAsUniformBuffer(_uniformBuffer, StarFieldUniformBinding, 0, sizeof(StarUniforms));
+    for (auto& page : _starPages)
+    {
+        if (page.CommandCount > 0)
+        {
+            _pipeline->BindAsShaderStorageBuffer(page.StarBuffer, VertexPullingVertexBufferBinding, 0, page.StarBuffer.GetSize());
+            _pipeline->MultiDrawArraysIndirect(_commandBuffer, page.CommandCount, sizeof(DrawCommand) * (firstCommand + page.FirstCommand));
+        }
+    }
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
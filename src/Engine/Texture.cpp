@@ -0,0 +1,97 @@
+#include <Engine/Texture.hpp>
+#include <Engine/Format.hpp>
+#include <Engine/GpuMemory.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cassert>
+
+Texture Texture::Create2D(
+    std::string_view label,
+    uint32_t width,
+    uint32_t height,
+    uint32_t internalFormat,
+    uint32_t levelCount) noexcept
+{
+    auto texture = Texture();
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture._id);
+    glTextureStorage2D(texture._id, levelCount, internalFormat, width, height);
+
+    glObjectLabel(GL_TEXTURE, texture._id, label.size(), label.data());
+
+    GpuMemory::Track(GpuResourceType::Texture, texture._id, GetByteCount(width, height, internalFormat, levelCount), internalFormat, label);
+
+    glTextureParameteri(texture._id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture._id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture._id, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(texture._id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    texture._width = width;
+    texture._height = height;
+    return texture;
+}
+
+uint64_t Texture::GetByteCount(
+    uint32_t width,
+    uint32_t height,
+    uint32_t internalFormat,
+    uint32_t levelCount) noexcept
+{
+    // Internal formats the table does not know are estimated at four bytes per texel
+    auto& traits = GetFormatTraits(FindFormat(internalFormat).value_or(Format::R8G8B8A8_UNORM));
+    auto byteCount = uint64_t(0);
+    for (auto level = 0u; level < levelCount; level++)
+    {
+        byteCount += traits.GetByteCount(std::max(width >> level, 1u), std::max(height >> level, 1u));
+    }
+    return byteCount;
+}
+
+Texture::~Texture()
+{
+    if (_id)
+    {
+        GpuMemory::Untrack(GpuResourceType::Texture, _id);
+        glDeleteTextures(1, &_id);
+    }
+}
+
+Texture::Texture(Texture&& other) noexcept
+{
+    Swap(other);
+}
+
+Texture& Texture::operator =(Texture&& other) noexcept
+{
+    Texture(std::move(other)).Swap(*this);
+    return *this;
+}
+
+void Texture::Swap(Texture& other) noexcept
+{
+    using std::swap;
+    swap(_id, other._id);
+    swap(_width, other._width);
+    swap(_height, other._height);
+}
+
+void Texture::Write(
+    uint32_t level,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format,
+    uint32_t type,
+    const void* data) const noexcept
+{
+    assert(x + width <= _width && y + height <= _height && "overflow");
+    glTextureSubImage2D(_id, level, x, y, width, height, format, type, data);
+}
+
+void Texture::SetFilter(uint32_t minFilter, uint32_t magFilter) const noexcept
+{
+    glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, magFilter);
+}
@@ -0,0 +1,141 @@
+#include <EngineCore/Archetype.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace
+{
+    std::byte* AllocateChunk()
+    {
+        return static_cast<std::byte*>(::operator new(ArchetypeChunkSize, std::align_val_t{ArchetypeChunkAlignment}));
+    }
+
+    void DeallocateChunk(std::byte* chunk)
+    {
+        ::operator delete(chunk, std::align_val_t{ArchetypeChunkAlignment});
+    }
+
+    uint32_t AlignUp(uint32_t value, uint32_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+Archetype::Archetype(const ComponentMask& componentMask)
+    : _componentMask(componentMask)
+{
+    _componentColumns.fill(-1);
+
+    auto rowSize = static_cast<uint32_t>(sizeof(Entity));
+    auto alignmentSlack = 0u;
+    for (auto componentId = 0u; componentId < MaxComponentTypes; componentId++)
+    {
+        if (!componentMask.test(componentId))
+        {
+            continue;
+        }
+
+        const auto& componentInfo = GetComponentInfo(componentId);
+        _componentColumns[componentId] = static_cast<int16_t>(_componentIds.size());
+        _componentIds.push_back(componentId);
+        _columnSizes.push_back(componentInfo.Size);
+        rowSize += componentInfo.Size;
+        alignmentSlack += componentInfo.Alignment;
+    }
+
+    _chunkCapacity = (ArchetypeChunkSize - alignmentSlack) / rowSize;
+    assert(_chunkCapacity > 0 && "Archetype: components do not fit into a single chunk");
+
+    auto offset = _chunkCapacity * static_cast<uint32_t>(sizeof(Entity));
+    for (auto componentId : _componentIds)
+    {
+        const auto& componentInfo = GetComponentInfo(componentId);
+        offset = AlignUp(offset, componentInfo.Alignment);
+        _columnOffsets.push_back(offset);
+        offset += _chunkCapacity * componentInfo.Size;
+    }
+
+    assert(offset <= ArchetypeChunkSize);
+}
+
+Archetype::~Archetype()
+{
+    for (auto& chunk : _chunks)
+    {
+        DeallocateChunk(chunk.Data);
+    }
+
+    if (_spareChunk != nullptr)
+    {
+        DeallocateChunk(_spareChunk);
+    }
+}
+
+Archetype::Location Archetype::AllocateRow(Entity entity)
+{
+    if (_chunks.empty() || _chunks.back().Count == _chunkCapacity)
+    {
+        auto chunkData = _spareChunk != nullptr
+            ? std::exchange(_spareChunk, nullptr)
+            : AllocateChunk();
+        _chunks.push_back(ArchetypeChunk{ .Data = chunkData, .Count = 0 });
+    }
+
+    auto& chunk = _chunks.back();
+    auto location = Location{
+        .ChunkIndex = static_cast<uint32_t>(_chunks.size() - 1),
+        .Row = chunk.Count
+    };
+
+    GetEntities(chunk)[chunk.Count] = entity;
+    chunk.Count++;
+    _entityCount++;
+
+    return location;
+}
+
+Entity Archetype::FreeRow(Location location)
+{
+    auto& lastChunk = _chunks.back();
+    auto lastLocation = Location{
+        .ChunkIndex = static_cast<uint32_t>(_chunks.size() - 1),
+        .Row = lastChunk.Count - 1
+    };
+
+    auto movedEntity = Entity();
+    if (location.ChunkIndex != lastLocation.ChunkIndex || location.Row != lastLocation.Row)
+    {
+        auto& chunk = _chunks[location.ChunkIndex];
+        movedEntity = GetEntities(lastChunk)[lastLocation.Row];
+        GetEntities(chunk)[location.Row] = movedEntity;
+
+        for (auto column = 0u; column < _componentIds.size(); column++)
+        {
+            std::memcpy(
+                GetComponentPointer(location, column),
+                GetComponentPointer(lastLocation, column),
+                _columnSizes[column]);
+        }
+    }
+
+    lastChunk.Count--;
+    _entityCount--;
+
+    if (lastChunk.Count == 0)
+    {
+        // Keep one chunk around so entities oscillating across a chunk boundary don't hammer the allocator
+        if (_spareChunk == nullptr)
+        {
+            _spareChunk = lastChunk.Data;
+        }
+        else
+        {
+            DeallocateChunk(lastChunk.Data);
+        }
+        _chunks.pop_back();
+    }
+
+    return movedEntity;
+}
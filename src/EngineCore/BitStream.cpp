@@ -0,0 +1,128 @@
+#include <EngineCore/BitStream.hpp>
+
+#include <array>
+
+namespace
+{
+    // Bit counts selected by the 2 bit prefix of variable length integers
+    constexpr std::array<uint32_t, 4> VariableBitCounts = { 4, 8, 16, 32 };
+
+    uint32_t ZigZagEncode(int32_t value) noexcept
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t ZigZagDecode(uint32_t value) noexcept
+    {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+}
+
+void BitWriter::WriteBits(uint32_t value, uint32_t bitCount) noexcept
+{
+    if (_isOverflowed || _bitCount + bitCount > _buffer.size() * 8)
+    {
+        _isOverflowed = true;
+        return;
+    }
+
+    auto mask = bitCount == 32 ? UINT32_MAX : (1u << bitCount) - 1;
+    _scratch |= static_cast<uint64_t>(value & mask) << _scratchBitCount;
+    _scratchBitCount += bitCount;
+    _bitCount += bitCount;
+
+    while (_scratchBitCount >= 8)
+    {
+        _buffer[_byteIndex++] = static_cast<std::byte>(_scratch & 0xFF);
+        _scratch >>= 8;
+        _scratchBitCount -= 8;
+    }
+}
+
+void BitWriter::WriteBool(bool value) noexcept
+{
+    WriteBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::WriteBytes(std::span<const std::byte> bytes) noexcept
+{
+    for (auto byte : bytes)
+    {
+        WriteBits(static_cast<uint32_t>(byte), 8);
+    }
+}
+
+void BitWriter::WriteVariableUnsigned(uint32_t value) noexcept
+{
+    for (auto prefix = 0u; prefix < VariableBitCounts.size(); prefix++)
+    {
+        auto bitCount = VariableBitCounts[prefix];
+        if (bitCount == 32 || value < (1u << bitCount))
+        {
+            WriteBits(prefix, 2);
+            WriteBits(value, bitCount);
+            return;
+        }
+    }
+}
+
+void BitWriter::WriteVariableSigned(int32_t value) noexcept
+{
+    WriteVariableUnsigned(ZigZagEncode(value));
+}
+
+void BitWriter::Flush() noexcept
+{
+    if (_scratchBitCount > 0)
+    {
+        _buffer[_byteIndex++] = static_cast<std::byte>(_scratch & 0xFF);
+        _scratch = 0;
+        _scratchBitCount = 0;
+    }
+}
+
+uint32_t BitReader::ReadBits(uint32_t bitCount) noexcept
+{
+    if (_isOverflowed || _bitCount + bitCount > _buffer.size() * 8)
+    {
+        _isOverflowed = true;
+        return 0;
+    }
+
+    while (_scratchBitCount < bitCount)
+    {
+        _scratch |= static_cast<uint64_t>(_buffer[_byteIndex++]) << _scratchBitCount;
+        _scratchBitCount += 8;
+    }
+
+    auto mask = bitCount == 32 ? UINT32_MAX : (1u << bitCount) - 1;
+    auto value = static_cast<uint32_t>(_scratch) & mask;
+    _scratch >>= bitCount;
+    _scratchBitCount -= bitCount;
+    _bitCount += bitCount;
+    return value;
+}
+
+bool BitReader::ReadBool() noexcept
+{
+    return ReadBits(1) != 0;
+}
+
+void BitReader::ReadBytes(std::span<std::byte> bytes) noexcept
+{
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<std::byte>(ReadBits(8));
+    }
+}
+
+uint32_t BitReader::ReadVariableUnsigned() noexcept
+{
+    auto prefix = ReadBits(2);
+    return ReadBits(VariableBitCounts[prefix]);
+}
+
+int32_t BitReader::ReadVariableSigned() noexcept
+{
+    return ZigZagDecode(ReadVariableUnsigned());
+}
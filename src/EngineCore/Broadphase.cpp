@@ -0,0 +1,39 @@
+#include <EngineCore/Broadphase.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+BroadphasePairBuffer::BroadphasePairBuffer(uint32_t capacity)
+    : _pairs(capacity)
+{
+}
+
+void BroadphasePairBuffer::Resize(uint32_t capacity)
+{
+    _pairs.resize(capacity);
+    Clear();
+}
+
+std::span<const BroadphasePair> BroadphasePairBuffer::GetPairs() const noexcept
+{
+    auto count = std::min<size_t>(_count.load(std::memory_order_acquire), _pairs.size());
+    return std::span(_pairs.data(), count);
+}
+
+void BroadphasePairBuffer::Append(std::span<const BroadphasePair> pairs) noexcept
+{
+    if (pairs.empty())
+    {
+        return;
+    }
+
+    auto pairCount = static_cast<uint32_t>(pairs.size());
+    auto offset = _count.fetch_add(pairCount, std::memory_order_acq_rel);
+    if (offset >= _pairs.size())
+    {
+        return;
+    }
+
+    auto writableCount = std::min<size_t>(pairCount, _pairs.size() - offset);
+    std::memcpy(_pairs.data() + offset, pairs.data(), writableCount * sizeof(BroadphasePair));
+}
@@ -0,0 +1,43 @@
+#include <EngineCore/Component.hpp>
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+
+namespace
+{
+    // deque keeps references returned by GetComponentInfo stable while new types register
+    std::deque<ComponentInfo>& GetComponentInfos()
+    {
+        static std::deque<ComponentInfo> componentInfos;
+        return componentInfos;
+    }
+
+    std::mutex gComponentInfoMutex;
+}
+
+ComponentId RegisterComponentType(
+    uint32_t size,
+    uint32_t alignment,
+    std::string_view name)
+{
+    std::scoped_lock lock(gComponentInfoMutex);
+
+    auto& componentInfos = GetComponentInfos();
+    assert(componentInfos.size() < MaxComponentTypes && "Component: too many component types, raise MaxComponentTypes");
+    assert(alignment <= MaxComponentAlignment && "Component: alignment exceeds what archetype chunks provide");
+
+    componentInfos.push_back(ComponentInfo{
+        .Size = size,
+        .Alignment = alignment,
+        .Name = name
+    });
+
+    return static_cast<ComponentId>(componentInfos.size() - 1);
+}
+
+const ComponentInfo& GetComponentInfo(ComponentId componentId)
+{
+    std::scoped_lock lock(gComponentInfoMutex);
+    return GetComponentInfos()[componentId];
+}
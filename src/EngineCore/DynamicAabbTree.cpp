@@ -0,0 +1,636 @@
+#include <EngineCore/DynamicAabbTree.hpp>
+#include <EngineCore/Memory.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <memory_resource>
+
+namespace
+{
+    constexpr uint32_t MaxQueryStackSize = 256;
+    constexpr uint32_t ParallelBuildMinLeaves = 8192;
+    constexpr uint32_t ParallelRefitMinHeight = 12;
+    constexpr uint32_t ParallelMaxDepth = 8;
+}
+
+DynamicAabbTree::DynamicAabbTree(
+    float fatMargin,
+    float reinsertFraction)
+    : _fatMargin(fatMargin),
+      _reinsertFraction(reinsertFraction)
+{
+}
+
+void DynamicAabbTree::CreateProxies(
+    std::span<const Aabb> aabbs,
+    std::span<const uint32_t> userData,
+    std::span<int32_t> proxyIds,
+    TaskScheduler& taskScheduler)
+{
+    assert(aabbs.size() == userData.size() && aabbs.size() == proxyIds.size());
+
+    // Inserting one by one is O(n log n) with poor cache behaviour, for big batches
+    // it is much cheaper to rebuild the whole tree top-down in parallel
+    auto rebuild = aabbs.size() > _proxyCount;
+    for (auto i = 0u; i < aabbs.size(); i++)
+    {
+        auto leafId = AllocateNode();
+        auto& leaf = _nodes[leafId];
+        leaf.Bounds = aabbs[i].Expanded(_fatMargin);
+        leaf.UserData = userData[i];
+        leaf.Height = 0;
+        _tightBounds[leafId] = aabbs[i];
+
+        if (!rebuild)
+        {
+            InsertLeaf(leafId);
+        }
+
+        proxyIds[i] = leafId;
+    }
+
+    _proxyCount += static_cast<uint32_t>(aabbs.size());
+    _leavesDirty = true;
+
+    if (rebuild)
+    {
+        Rebuild(taskScheduler);
+    }
+}
+
+void DynamicAabbTree::DestroyProxies(std::span<const int32_t> proxyIds)
+{
+    for (auto proxyId : proxyIds)
+    {
+        assert(_nodes[proxyId].IsLeaf() && _nodes[proxyId].Height == 0);
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+    }
+
+    _proxyCount -= static_cast<uint32_t>(proxyIds.size());
+    _leavesDirty = true;
+}
+
+void DynamicAabbTree::UpdateProxies(
+    std::span<const int32_t> proxyIds,
+    std::span<const Aabb> aabbs,
+    TaskScheduler& taskScheduler)
+{
+    assert(proxyIds.size() == aabbs.size());
+
+    auto proxyCount = static_cast<uint32_t>(proxyIds.size());
+    std::atomic<uint32_t> escapedCount = 0;
+    _escaped.resize(proxyCount);
+
+    taskScheduler.ParallelFor(proxyCount, 1024, [&](uint32_t begin, uint32_t end)
+    {
+        auto localEscapedCount = 0u;
+        for (auto i = begin; i < end; i++)
+        {
+            auto proxyId = proxyIds[i];
+            _tightBounds[proxyId] = aabbs[i];
+
+            auto escaped = !_nodes[proxyId].Bounds.Contains(aabbs[i]);
+            _escaped[i] = escaped ? 1 : 0;
+            localEscapedCount += escaped ? 1 : 0;
+        }
+        escapedCount.fetch_add(localEscapedCount, std::memory_order_relaxed);
+    });
+
+    if (escapedCount == 0)
+    {
+        return;
+    }
+
+    if (escapedCount <= static_cast<uint32_t>(_reinsertFraction * static_cast<float>(_proxyCount)))
+    {
+        for (auto i = 0u; i < proxyCount; i++)
+        {
+            if (_escaped[i] == 0)
+            {
+                continue;
+            }
+
+            auto proxyId = proxyIds[i];
+            RemoveLeaf(proxyId);
+            _nodes[proxyId].Bounds = aabbs[i].Expanded(_fatMargin);
+            InsertLeaf(proxyId);
+        }
+        return;
+    }
+
+    taskScheduler.ParallelFor(proxyCount, 1024, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            if (_escaped[i] != 0)
+            {
+                _nodes[proxyIds[i]].Bounds = aabbs[i].Expanded(_fatMargin);
+            }
+        }
+    });
+
+    if (_root != NullNode)
+    {
+        RefitRecursive(_root, 0, taskScheduler);
+    }
+}
+
+void DynamicAabbTree::FindPairs(
+    BroadphasePairBuffer& pairBuffer,
+    TaskScheduler& taskScheduler)
+{
+    pairBuffer.Clear();
+    if (_root == NullNode)
+    {
+        return;
+    }
+
+    GatherLeaves();
+
+    taskScheduler.ParallelFor(static_cast<uint32_t>(_leaves.size()), 256, [&](uint32_t begin, uint32_t end)
+    {
+        BroadphasePairWriter pairWriter(pairBuffer);
+        auto& arena = GetThreadArena();
+        ArenaScope arenaScope(arena);
+        // Balanced trees stay well within the inline stack, degenerate ones continue on the arena
+        int32_t inlineStack[MaxQueryStackSize];
+        std::pmr::vector<int32_t> grownStack(&arena);
+        auto stack = std::span<int32_t>(inlineStack);
+
+        for (auto i = begin; i < end; i++)
+        {
+            auto leafId = _leaves[i];
+            const auto& queryBounds = _tightBounds[leafId];
+            const auto queryUserData = _nodes[leafId].UserData;
+
+            auto stackSize = 0u;
+            stack[stackSize++] = _root;
+            while (stackSize > 0)
+            {
+                auto nodeId = stack[--stackSize];
+                const auto& node = _nodes[nodeId];
+                if (!node.Bounds.Overlaps(queryBounds))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    // every pair is visited from both sides, only report it from the lower id
+                    if (nodeId > leafId && _tightBounds[nodeId].Overlaps(queryBounds))
+                    {
+                        pairWriter.Add(queryUserData, node.UserData);
+                    }
+                    continue;
+                }
+
+                if (stackSize + 2 > stack.size())
+                {
+                    if (grownStack.empty())
+                    {
+                        grownStack.assign(stack.begin(), stack.end());
+                    }
+                    grownStack.resize(2 * stack.size());
+                    stack = grownStack;
+                }
+                stack[stackSize++] = node.Child1;
+                stack[stackSize++] = node.Child2;
+            }
+        }
+    });
+}
+
+void DynamicAabbTree::Rebuild(TaskScheduler& taskScheduler)
+{
+    GatherLeaves();
+
+    for (auto nodeId = 0; nodeId < static_cast<int32_t>(_nodes.size()); nodeId++)
+    {
+        if (_nodes[nodeId].Height > 0)
+        {
+            FreeNode(nodeId);
+        }
+    }
+
+    auto leafCount = static_cast<uint32_t>(_leaves.size());
+    if (leafCount == 0)
+    {
+        _root = NullNode;
+        return;
+    }
+
+    // Allocate all internal nodes upfront so workers never touch the node allocator
+    _buildSlots.resize(leafCount - 1);
+    for (auto& buildSlot : _buildSlots)
+    {
+        buildSlot = AllocateNode();
+    }
+
+    _root = BuildRecursive(0, leafCount, 0, NullNode, 0, taskScheduler);
+}
+
+uint32_t DynamicAabbTree::GetHeight() const noexcept
+{
+    return _root == NullNode ? 0 : static_cast<uint32_t>(_nodes[_root].Height);
+}
+
+int32_t DynamicAabbTree::AllocateNode()
+{
+    if (_freeList == NullNode)
+    {
+        auto nodeId = static_cast<int32_t>(_nodes.size());
+        _nodes.emplace_back();
+        _tightBounds.emplace_back();
+        return nodeId;
+    }
+
+    auto nodeId = _freeList;
+    _freeList = _nodes[nodeId].Parent;
+    _nodes[nodeId] = Node();
+    return nodeId;
+}
+
+void DynamicAabbTree::FreeNode(int32_t nodeId)
+{
+    auto& node = _nodes[nodeId];
+    node.Parent = _freeList;
+    node.Child1 = NullNode;
+    node.Child2 = NullNode;
+    node.Height = -1;
+    _freeList = nodeId;
+}
+
+void DynamicAabbTree::InsertLeaf(int32_t leafId)
+{
+    if (_root == NullNode)
+    {
+        _root = leafId;
+        _nodes[_root].Parent = NullNode;
+        return;
+    }
+
+    // Descend along the cheapest path according to the surface area heuristic
+    auto leafBounds = _nodes[leafId].Bounds;
+    auto index = _root;
+    while (!_nodes[index].IsLeaf())
+    {
+        const auto& node = _nodes[index];
+        auto area = node.Bounds.GetSurfaceArea();
+        auto combinedArea = Aabb::Union(node.Bounds, leafBounds).GetSurfaceArea();
+
+        auto cost = 2.0f * combinedArea;
+        auto inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t childId)
+        {
+            const auto& child = _nodes[childId];
+            auto unionArea = Aabb::Union(child.Bounds, leafBounds).GetSurfaceArea();
+            return child.IsLeaf()
+                ? unionArea + inheritanceCost
+                : unionArea - child.Bounds.GetSurfaceArea() + inheritanceCost;
+        };
+
+        auto cost1 = childCost(node.Child1);
+        auto cost2 = childCost(node.Child2);
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+
+        index = cost1 < cost2 ? node.Child1 : node.Child2;
+    }
+
+    auto siblingId = index;
+    auto oldParentId = _nodes[siblingId].Parent;
+    auto newParentId = AllocateNode();
+
+    auto& newParent = _nodes[newParentId];
+    newParent.Parent = oldParentId;
+    newParent.Bounds = Aabb::Union(leafBounds, _nodes[siblingId].Bounds);
+    newParent.Height = _nodes[siblingId].Height + 1;
+    newParent.Child1 = siblingId;
+    newParent.Child2 = leafId;
+    _nodes[siblingId].Parent = newParentId;
+    _nodes[leafId].Parent = newParentId;
+
+    if (oldParentId != NullNode)
+    {
+        auto& oldParent = _nodes[oldParentId];
+        if (oldParent.Child1 == siblingId)
+        {
+            oldParent.Child1 = newParentId;
+        }
+        else
+        {
+            oldParent.Child2 = newParentId;
+        }
+    }
+    else
+    {
+        _root = newParentId;
+    }
+
+    index = _nodes[leafId].Parent;
+    while (index != NullNode)
+    {
+        index = Balance(index);
+
+        auto& node = _nodes[index];
+        const auto& child1 = _nodes[node.Child1];
+        const auto& child2 = _nodes[node.Child2];
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Bounds = Aabb::Union(child1.Bounds, child2.Bounds);
+
+        index = node.Parent;
+    }
+}
+
+void DynamicAabbTree::RemoveLeaf(int32_t leafId)
+{
+    if (leafId == _root)
+    {
+        _root = NullNode;
+        return;
+    }
+
+    auto parentId = _nodes[leafId].Parent;
+    auto grandParentId = _nodes[parentId].Parent;
+    auto siblingId = _nodes[parentId].Child1 == leafId
+        ? _nodes[parentId].Child2
+        : _nodes[parentId].Child1;
+
+    FreeNode(parentId);
+
+    if (grandParentId == NullNode)
+    {
+        _root = siblingId;
+        _nodes[siblingId].Parent = NullNode;
+        return;
+    }
+
+    auto& grandParent = _nodes[grandParentId];
+    if (grandParent.Child1 == parentId)
+    {
+        grandParent.Child1 = siblingId;
+    }
+    else
+    {
+        grandParent.Child2 = siblingId;
+    }
+    _nodes[siblingId].Parent = grandParentId;
+
+    auto index = grandParentId;
+    while (index != NullNode)
+    {
+        index = Balance(index);
+
+        auto& node = _nodes[index];
+        const auto& child1 = _nodes[node.Child1];
+        const auto& child2 = _nodes[node.Child2];
+        node.Bounds = Aabb::Union(child1.Bounds, child2.Bounds);
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+
+        index = node.Parent;
+    }
+}
+
+// Rotates the taller child up if the subtree at nodeId is imbalanced, returns the new subtree root
+int32_t DynamicAabbTree::Balance(int32_t nodeId)
+{
+    auto iA = nodeId;
+    auto& A = _nodes[iA];
+    if (A.IsLeaf() || A.Height < 2)
+    {
+        return iA;
+    }
+
+    auto iB = A.Child1;
+    auto iC = A.Child2;
+    auto& B = _nodes[iB];
+    auto& C = _nodes[iC];
+
+    auto replaceInParent = [&](int32_t parentId, int32_t newChildId)
+    {
+        if (parentId == NullNode)
+        {
+            _root = newChildId;
+            return;
+        }
+
+        auto& parent = _nodes[parentId];
+        if (parent.Child1 == iA)
+        {
+            parent.Child1 = newChildId;
+        }
+        else
+        {
+            parent.Child2 = newChildId;
+        }
+    };
+
+    auto balance = C.Height - B.Height;
+    if (balance > 1)
+    {
+        auto iF = C.Child1;
+        auto iG = C.Child2;
+        auto& F = _nodes[iF];
+        auto& G = _nodes[iG];
+
+        C.Child1 = iA;
+        C.Parent = A.Parent;
+        A.Parent = iC;
+        replaceInParent(C.Parent, iC);
+
+        if (F.Height > G.Height)
+        {
+            C.Child2 = iF;
+            A.Child2 = iG;
+            G.Parent = iA;
+            A.Bounds = Aabb::Union(B.Bounds, G.Bounds);
+            C.Bounds = Aabb::Union(A.Bounds, F.Bounds);
+            A.Height = 1 + std::max(B.Height, G.Height);
+            C.Height = 1 + std::max(A.Height, F.Height);
+        }
+        else
+        {
+            C.Child2 = iG;
+            A.Child2 = iF;
+            F.Parent = iA;
+            A.Bounds = Aabb::Union(B.Bounds, F.Bounds);
+            C.Bounds = Aabb::Union(A.Bounds, G.Bounds);
+            A.Height = 1 + std::max(B.Height, F.Height);
+            C.Height = 1 + std::max(A.Height, G.Height);
+        }
+
+        return iC;
+    }
+
+    if (balance < -1)
+    {
+        auto iD = B.Child1;
+        auto iE = B.Child2;
+        auto& D = _nodes[iD];
+        auto& E = _nodes[iE];
+
+        B.Child1 = iA;
+        B.Parent = A.Parent;
+        A.Parent = iB;
+        replaceInParent(B.Parent, iB);
+
+        if (D.Height > E.Height)
+        {
+            B.Child2 = iD;
+            A.Child1 = iE;
+            E.Parent = iA;
+            A.Bounds = Aabb::Union(C.Bounds, E.Bounds);
+            B.Bounds = Aabb::Union(A.Bounds, D.Bounds);
+            A.Height = 1 + std::max(C.Height, E.Height);
+            B.Height = 1 + std::max(A.Height, D.Height);
+        }
+        else
+        {
+            B.Child2 = iE;
+            A.Child1 = iD;
+            D.Parent = iA;
+            A.Bounds = Aabb::Union(C.Bounds, D.Bounds);
+            B.Bounds = Aabb::Union(A.Bounds, E.Bounds);
+            A.Height = 1 + std::max(C.Height, D.Height);
+            B.Height = 1 + std::max(A.Height, E.Height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicAabbTree::GatherLeaves()
+{
+    if (!_leavesDirty)
+    {
+        return;
+    }
+
+    _leaves.clear();
+    for (auto nodeId = 0; nodeId < static_cast<int32_t>(_nodes.size()); nodeId++)
+    {
+        if (_nodes[nodeId].Height == 0)
+        {
+            _leaves.push_back(nodeId);
+        }
+    }
+
+    _leavesDirty = false;
+}
+
+int32_t DynamicAabbTree::BuildRecursive(
+    uint32_t begin,
+    uint32_t end,
+    uint32_t slotOffset,
+    int32_t parentId,
+    uint32_t depth,
+    TaskScheduler& taskScheduler)
+{
+    if (end - begin == 1)
+    {
+        auto leafId = _leaves[begin];
+        _nodes[leafId].Parent = parentId;
+        return leafId;
+    }
+
+    auto centerBounds = Aabb{ .Min = glm::vec3(std::numeric_limits<float>::max()), .Max = glm::vec3(std::numeric_limits<float>::lowest()) };
+    for (auto i = begin; i < end; i++)
+    {
+        auto center = _nodes[_leaves[i]].Bounds.GetCenter();
+        centerBounds.Min = glm::min(centerBounds.Min, center);
+        centerBounds.Max = glm::max(centerBounds.Max, center);
+    }
+
+    auto extent = centerBounds.Max - centerBounds.Min;
+    auto axis = extent.x > extent.y
+        ? (extent.x > extent.z ? 0 : 2)
+        : (extent.y > extent.z ? 1 : 2);
+
+    // Median split, subtrees own disjoint ranges of _leaves and _buildSlots which makes them safe to build concurrently
+    auto middle = begin + (end - begin) / 2;
+    std::nth_element(
+        _leaves.begin() + begin,
+        _leaves.begin() + middle,
+        _leaves.begin() + end,
+        [&](int32_t lhs, int32_t rhs)
+    {
+        return _nodes[lhs].Bounds.GetCenter()[axis] < _nodes[rhs].Bounds.GetCenter()[axis];
+    });
+
+    auto nodeId = _buildSlots[slotOffset];
+    auto leftSlotOffset = slotOffset + 1;
+    auto rightSlotOffset = slotOffset + (middle - begin);
+
+    int32_t childIds[2] = { NullNode, NullNode };
+    auto buildChild = [&](uint32_t child)
+    {
+        childIds[child] = child == 0
+            ? BuildRecursive(begin, middle, leftSlotOffset, nodeId, depth + 1, taskScheduler)
+            : BuildRecursive(middle, end, rightSlotOffset, nodeId, depth + 1, taskScheduler);
+    };
+
+    if (depth < ParallelMaxDepth && end - begin >= ParallelBuildMinLeaves)
+    {
+        taskScheduler.ParallelFor(2, 1, [&](uint32_t childBegin, uint32_t childEnd)
+        {
+            for (auto child = childBegin; child < childEnd; child++)
+            {
+                buildChild(child);
+            }
+        });
+    }
+    else
+    {
+        buildChild(0);
+        buildChild(1);
+    }
+
+    auto& node = _nodes[nodeId];
+    const auto& child1 = _nodes[childIds[0]];
+    const auto& child2 = _nodes[childIds[1]];
+    node.Parent = parentId;
+    node.Child1 = childIds[0];
+    node.Child2 = childIds[1];
+    node.Bounds = Aabb::Union(child1.Bounds, child2.Bounds);
+    node.Height = 1 + std::max(child1.Height, child2.Height);
+    return nodeId;
+}
+
+void DynamicAabbTree::RefitRecursive(
+    int32_t nodeId,
+    uint32_t depth,
+    TaskScheduler& taskScheduler)
+{
+    auto& node = _nodes[nodeId];
+    if (node.IsLeaf())
+    {
+        return;
+    }
+
+    if (depth < ParallelMaxDepth && static_cast<uint32_t>(node.Height) >= ParallelRefitMinHeight)
+    {
+        taskScheduler.ParallelFor(2, 1, [&](uint32_t childBegin, uint32_t childEnd)
+        {
+            for (auto child = childBegin; child < childEnd; child++)
+            {
+                RefitRecursive(child == 0 ? node.Child1 : node.Child2, depth + 1, taskScheduler);
+            }
+        });
+    }
+    else
+    {
+        RefitRecursive(node.Child1, depth + 1, taskScheduler);
+        RefitRecursive(node.Child2, depth + 1, taskScheduler);
+    }
+
+    node.Bounds = Aabb::Union(_nodes[node.Child1].Bounds, _nodes[node.Child2].Bounds);
+}
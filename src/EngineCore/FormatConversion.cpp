@@ -0,0 +1,674 @@
+#include <EngineCore/FormatConversion.hpp>
+#include <EngineCore/OctahedralImpostor.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FORMAT_CONVERSION_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_F16C
+#else
+#define TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FORMAT_CONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Half the way from float to half, used to round subnormal halves with a float addition
+    constexpr uint32_t HalfSubnormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+    // Rebiases the exponent from float to half and adds just below half an ulp for rounding
+    constexpr uint32_t HalfRebiasAndRound = 0xC8000FFFu;
+    constexpr uint32_t HalfShiftedExponent = 0x7C00u << 13;
+    constexpr uint32_t HalfExponentRebias = (127 - 15) << 23;
+    constexpr uint32_t HalfFromSubnormalMagic = 113u << 23;
+
+    constexpr float Snorm16Scale = 32767.0f;
+
+    // Below 2^-13 sRGB codes round to zero, lines through every eighth of an octave above that
+    constexpr uint32_t LinearToSrgbMinBits = 0x39000000u;
+    constexpr uint32_t LinearToSrgbMaxBits = 0x3F7FFFFFu;
+    constexpr uint32_t LinearToSrgbBucketShift = 20;
+    constexpr uint32_t LinearToSrgbBucketCount = (0x3F800000u - LinearToSrgbMinBits) >> LinearToSrgbBucketShift;
+    constexpr uint32_t LinearToSrgbFractionMask = (1u << LinearToSrgbBucketShift) - 1;
+    constexpr float LinearToSrgbFractionScale = 1.0f / static_cast<float>(1u << LinearToSrgbBucketShift);
+
+    struct SrgbTables
+    {
+        std::array<float, 256> ToLinear;
+        std::array<float, LinearToSrgbBucketCount> Base;
+        std::array<float, LinearToSrgbBucketCount> Slope;
+    };
+
+    double EncodeSrgb(double value) noexcept
+    {
+        return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    double DecodeSrgb(double value) noexcept
+    {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    SrgbTables CreateSrgbTables() noexcept
+    {
+        constexpr uint32_t SagSampleCount = 16;
+
+        SrgbTables tables = {};
+        for (auto i = 0u; i < 256u; i++)
+        {
+            tables.ToLinear[i] = static_cast<float>(DecodeSrgb(i / 255.0));
+        }
+        for (auto i = 0u; i < LinearToSrgbBucketCount; i++)
+        {
+            auto x0 = static_cast<double>(std::bit_cast<float>(LinearToSrgbMinBits + (i << LinearToSrgbBucketShift)));
+            auto x1 = static_cast<double>(std::bit_cast<float>(LinearToSrgbMinBits + ((i + 1) << LinearToSrgbBucketShift)));
+            auto y0 = EncodeSrgb(x0) * 255.0;
+            auto y1 = EncodeSrgb(x1) * 255.0;
+
+            // The curve bows above the line, which is raised by half of that to split the error
+            auto sag = 0.0;
+            for (auto sample = 1u; sample < SagSampleCount; sample++)
+            {
+                auto t = static_cast<double>(sample) / SagSampleCount;
+                sag = std::max(sag, EncodeSrgb(x0 + t * (x1 - x0)) * 255.0 - (y0 + t * (y1 - y0)));
+            }
+            tables.Base[i] = static_cast<float>(y0 + sag * 0.5);
+            tables.Slope[i] = static_cast<float>(y1 - y0);
+        }
+        return tables;
+    }
+
+    const SrgbTables& GetSrgbTables() noexcept
+    {
+        static const auto tables = CreateSrgbTables();
+        return tables;
+    }
+
+    uint16_t FloatToHalf(float value) noexcept
+    {
+        auto bits = std::bit_cast<uint32_t>(value);
+        auto sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint32_t half;
+        if (bits >= 0x47800000u)
+        {
+            half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+        }
+        else if (bits < 0x38800000u)
+        {
+            half = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(HalfSubnormalMagic)) - HalfSubnormalMagic;
+        }
+        else
+        {
+            auto isMantissaOdd = (bits >> 13) & 1u;
+            half = (bits + HalfRebiasAndRound + isMantissaOdd) >> 13;
+        }
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    float HalfToFloat(uint16_t half) noexcept
+    {
+        auto bits = static_cast<uint32_t>(half & 0x7FFFu) << 13;
+        auto exponent = bits & HalfShiftedExponent;
+        bits += HalfExponentRebias;
+        if (exponent == HalfShiftedExponent)
+        {
+            bits += HalfExponentRebias;
+        }
+        else if (exponent == 0)
+        {
+            bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits + (1u << 23)) - std::bit_cast<float>(HalfFromSubnormalMagic));
+        }
+        return std::bit_cast<float>(bits | (static_cast<uint32_t>(half & 0x8000u) << 16));
+    }
+
+    // Comparisons written like the SIMD min and max so NaNs end up the same
+    float ClampSigned(float value) noexcept
+    {
+        auto clamped = value > -1.0f ? value : -1.0f;
+        return clamped < 1.0f ? clamped : 1.0f;
+    }
+
+    int16_t FloatToSnorm16(float value) noexcept
+    {
+        return static_cast<int16_t>(std::lrint(ClampSigned(value) * Snorm16Scale));
+    }
+
+    uint32_t Rgba8ToRgb10A2(uint32_t pixel) noexcept
+    {
+        auto r = pixel & 0xFFu;
+        auto g = (pixel >> 8) & 0xFFu;
+        auto b = (pixel >> 16) & 0xFFu;
+        auto a = pixel >> 24;
+        return ((r * 1023 + 127) / 255)
+            | (((g * 1023 + 127) / 255) << 10)
+            | (((b * 1023 + 127) / 255) << 20)
+            | (((a * 3 + 127) / 255) << 30);
+    }
+
+    uint32_t Rgb10A2ToRgba8(uint32_t pixel) noexcept
+    {
+        auto r = pixel & 0x3FFu;
+        auto g = (pixel >> 10) & 0x3FFu;
+        auto b = (pixel >> 20) & 0x3FFu;
+        auto a = pixel >> 30;
+        return ((r * 255 + 511) / 1023)
+            | (((g * 255 + 511) / 1023) << 8)
+            | (((b * 255 + 511) / 1023) << 16)
+            | ((a * 85) << 24);
+    }
+
+    uint8_t LinearToSrgb(float value, const SrgbTables& tables) noexcept
+    {
+        auto minValue = std::bit_cast<float>(LinearToSrgbMinBits);
+        auto maxValue = std::bit_cast<float>(LinearToSrgbMaxBits);
+        auto clamped = value > minValue ? value : minValue;
+        clamped = clamped < maxValue ? clamped : maxValue;
+
+        auto bits = std::bit_cast<uint32_t>(clamped);
+        auto bucket = (bits - LinearToSrgbMinBits) >> LinearToSrgbBucketShift;
+        auto fraction = static_cast<float>(bits & LinearToSrgbFractionMask) * LinearToSrgbFractionScale;
+        return static_cast<uint8_t>(std::lrint(tables.Base[bucket] + tables.Slope[bucket] * fraction));
+    }
+
+    uint32_t EncodeOctahedralNormal(const glm::vec3& normal) noexcept
+    {
+        auto encoded = OctahedralEncode(normal);
+        return static_cast<uint16_t>(FloatToSnorm16(encoded.x)) | (static_cast<uint32_t>(static_cast<uint16_t>(FloatToSnorm16(encoded.y))) << 16);
+    }
+
+#if defined(FORMAT_CONVERSION_X86)
+
+    __m128i Select(__m128i mask, __m128i ifSet, __m128i ifClear) noexcept
+    {
+        return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifClear));
+    }
+
+    __m128 Select(__m128 mask, __m128 ifSet, __m128 ifClear) noexcept
+    {
+        return _mm_or_ps(_mm_and_ps(mask, ifSet), _mm_andnot_ps(mask, ifClear));
+    }
+
+    // Four 16-bit results in 32-bit lanes to eight, packs_epi32 saturates so they are sign extended first
+    __m128i PackLow16(__m128i low, __m128i high) noexcept
+    {
+        return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+    }
+
+    __m128i FloatToHalfSse2(__m128 value) noexcept
+    {
+        auto bits = _mm_castps_si128(value);
+        auto sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(0x80000000u)));
+        bits = _mm_xor_si128(bits, sign);
+
+        auto isInfinityOrNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x477FFFFF));
+        auto isNan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7F800000));
+        auto infinityOrNan = Select(isNan, _mm_set1_epi32(0x7E00), _mm_set1_epi32(0x7C00));
+
+        auto isSubnormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(0x38800000));
+        auto magic = _mm_set1_epi32(static_cast<int32_t>(HalfSubnormalMagic));
+        auto subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(magic))), magic);
+
+        auto isMantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+        auto normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(static_cast<int32_t>(HalfRebiasAndRound))), isMantissaOdd), 13);
+
+        auto half = Select(isInfinityOrNan, infinityOrNan, Select(isSubnormal, subnormal, normal));
+        return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+    }
+
+    __m128 HalfToFloatSse2(__m128i half) noexcept
+    {
+        auto bits = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x7FFF)), 13);
+        auto exponent = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(HalfShiftedExponent)));
+        auto rebias = _mm_set1_epi32(static_cast<int32_t>(HalfExponentRebias));
+        bits = _mm_add_epi32(bits, rebias);
+
+        auto isInfinityOrNan = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(static_cast<int32_t>(HalfShiftedExponent)));
+        auto isSubnormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+        auto infinityOrNan = _mm_add_epi32(bits, rebias);
+        auto subnormal = _mm_castps_si128(_mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))),
+            _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(HalfFromSubnormalMagic)))));
+
+        bits = Select(isInfinityOrNan, infinityOrNan, Select(isSubnormal, subnormal, bits));
+        return _mm_castsi128_ps(_mm_or_si128(bits, _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x8000)), 16)));
+    }
+
+    __m128i FloatToSnorm16Sse2(__m128 value) noexcept
+    {
+        auto clamped = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+        return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(Snorm16Scale)));
+    }
+
+    void ConvertFloatToHalfSse2(const float* source, uint16_t* destination, size_t count) noexcept
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            auto low = FloatToHalfSse2(_mm_loadu_ps(source + i));
+            auto high = FloatToHalfSse2(_mm_loadu_ps(source + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), PackLow16(low, high));
+        }
+        for (; i < count; i++)
+        {
+            destination[i] = FloatToHalf(source[i]);
+        }
+    }
+
+    void ConvertHalfToFloatSse2(const uint16_t* source, float* destination, size_t count) noexcept
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            auto halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            _mm_storeu_ps(destination + i, HalfToFloatSse2(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+            _mm_storeu_ps(destination + i + 4, HalfToFloatSse2(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+        }
+        for (; i < count; i++)
+        {
+            destination[i] = HalfToFloat(source[i]);
+        }
+    }
+
+    TARGET_F16C void ConvertFloatToHalfF16c(const float* source, uint16_t* destination, size_t count) noexcept
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            auto halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), halves);
+        }
+        for (; i < count; i++)
+        {
+            destination[i] = FloatToHalf(source[i]);
+        }
+    }
+
+    TARGET_F16C void ConvertHalfToFloatF16c(const uint16_t* source, float* destination, size_t count) noexcept
+    {
+        auto i = size_t(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))));
+        }
+        for (; i < count; i++)
+        {
+            destination[i] = HalfToFloat(source[i]);
+        }
+    }
+
+    bool IsF16cSupported() noexcept
+    {
+#if defined(_MSC_VER)
+        int32_t cpuInfo[4] = {};
+        __cpuid(cpuInfo, 1);
+        auto hasAvx = (cpuInfo[2] & (1 << 28)) != 0;
+        auto hasF16c = (cpuInfo[2] & (1 << 29)) != 0;
+        auto hasOsxsave = (cpuInfo[2] & (1 << 27)) != 0;
+        return hasAvx && hasF16c && hasOsxsave && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+    }
+
+    using ConvertFloatToHalfFunction = void (*)(const float* source, uint16_t* destination, size_t count) noexcept;
+    using ConvertHalfToFloatFunction = void (*)(const uint16_t* source, float* destination, size_t count) noexcept;
+
+#elif defined(FORMAT_CONVERSION_NEON)
+
+    int32x4_t FloatToSnorm16Neon(float32x4_t value) noexcept
+    {
+        auto minValue = vdupq_n_f32(-1.0f);
+        auto maxValue = vdupq_n_f32(1.0f);
+        auto clamped = vbslq_f32(vcgtq_f32(value, minValue), value, minValue);
+        clamped = vbslq_f32(vcltq_f32(clamped, maxValue), clamped, maxValue);
+        return vcvtnq_s32_f32(vmulq_f32(clamped, vdupq_n_f32(Snorm16Scale)));
+    }
+
+#endif
+}
+
+void ConvertFloatToHalf(std::span<const float> source, std::span<uint16_t> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+#if defined(FORMAT_CONVERSION_X86)
+    static const auto convert = IsF16cSupported() ? ConvertFloatToHalfFunction(ConvertFloatToHalfF16c) : ConvertFloatToHalfSse2;
+    convert(source.data(), destination.data(), source.size());
+#else
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_NEON)
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        vst1_u16(destination.data() + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(source.data() + i))));
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = FloatToHalf(source[i]);
+    }
+#endif
+}
+
+void ConvertHalfToFloat(std::span<const uint16_t> source, std::span<float> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+#if defined(FORMAT_CONVERSION_X86)
+    static const auto convert = IsF16cSupported() ? ConvertHalfToFloatFunction(ConvertHalfToFloatF16c) : ConvertHalfToFloatSse2;
+    convert(source.data(), destination.data(), source.size());
+#else
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_NEON)
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        vst1q_f32(destination.data() + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(source.data() + i))));
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = HalfToFloat(source[i]);
+    }
+#endif
+}
+
+void ConvertFloatToSnorm16(std::span<const float> source, std::span<int16_t> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_X86)
+    for (; i + 8 <= source.size(); i += 8)
+    {
+        auto low = FloatToSnorm16Sse2(_mm_loadu_ps(source.data() + i));
+        auto high = FloatToSnorm16Sse2(_mm_loadu_ps(source.data() + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination.data() + i), _mm_packs_epi32(low, high));
+    }
+#elif defined(FORMAT_CONVERSION_NEON)
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        vst1_s16(destination.data() + i, vqmovn_s32(FloatToSnorm16Neon(vld1q_f32(source.data() + i))));
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = FloatToSnorm16(source[i]);
+    }
+}
+
+void ConvertRgba8ToRgb10A2(std::span<const uint32_t> source, std::span<uint32_t> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_X86)
+    // No product lands near half a step, so rounding the float product gives what the integer division does
+    auto byteMask = _mm_set1_epi32(0xFF);
+    auto colorScale = _mm_set1_ps(1023.0f / 255.0f);
+    auto alphaScale = _mm_set1_ps(3.0f / 255.0f);
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + i));
+        auto r = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pixels, byteMask)), colorScale));
+        auto g = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask)), colorScale));
+        auto b = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask)), colorScale));
+        auto a = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(pixels, 24)), alphaScale));
+        auto packed = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 10)), _mm_or_si128(_mm_slli_epi32(b, 20), _mm_slli_epi32(a, 30)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination.data() + i), packed);
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = Rgba8ToRgb10A2(source[i]);
+    }
+}
+
+void ConvertRgb10A2ToRgba8(std::span<const uint32_t> source, std::span<uint32_t> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_X86)
+    auto colorMask = _mm_set1_epi32(0x3FF);
+    auto colorScale = _mm_set1_ps(255.0f / 1023.0f);
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + i));
+        auto r = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pixels, colorMask)), colorScale));
+        auto g = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 10), colorMask)), colorScale));
+        auto b = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 20), colorMask)), colorScale));
+        // 85 repeats the two bits across the byte
+        auto a = _mm_mullo_epi16(_mm_srli_epi32(pixels, 30), _mm_set1_epi32(85));
+        auto packed = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination.data() + i), packed);
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = Rgb10A2ToRgba8(source[i]);
+    }
+}
+
+void ConvertSrgbToLinear(std::span<const uint8_t> source, std::span<float> destination) noexcept
+{
+    // 256 entries beat any arithmetic
+    assert(destination.size() >= source.size());
+    auto& toLinear = GetSrgbTables().ToLinear;
+    for (auto i = size_t(0); i < source.size(); i++)
+    {
+        destination[i] = toLinear[source[i]];
+    }
+}
+
+void ConvertLinearToSrgb(std::span<const float> source, std::span<uint8_t> destination) noexcept
+{
+    assert(destination.size() >= source.size());
+    auto& tables = GetSrgbTables();
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_X86)
+    // SSE2 has no gather, the four lines are looked up one by one and everything else runs four wide
+    auto minValue = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(LinearToSrgbMinBits)));
+    auto maxValue = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(LinearToSrgbMaxBits)));
+    auto fractionMask = _mm_set1_epi32(static_cast<int32_t>(LinearToSrgbFractionMask));
+    auto fractionScale = _mm_set1_ps(LinearToSrgbFractionScale);
+    for (; i + 4 <= source.size(); i += 4)
+    {
+        auto clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source.data() + i), minValue), maxValue);
+        auto bits = _mm_castps_si128(clamped);
+        alignas(16) uint32_t buckets[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(buckets), _mm_srli_epi32(_mm_sub_epi32(bits, _mm_castps_si128(minValue)), LinearToSrgbBucketShift));
+        auto base = _mm_setr_ps(tables.Base[buckets[0]], tables.Base[buckets[1]], tables.Base[buckets[2]], tables.Base[buckets[3]]);
+        auto slope = _mm_setr_ps(tables.Slope[buckets[0]], tables.Slope[buckets[1]], tables.Slope[buckets[2]], tables.Slope[buckets[3]]);
+        auto fraction = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(bits, fractionMask)), fractionScale);
+        auto codes = _mm_cvtps_epi32(_mm_add_ps(base, _mm_mul_ps(slope, fraction)));
+        auto bytes = _mm_packus_epi16(_mm_packs_epi32(codes, codes), _mm_setzero_si128());
+        auto packed = static_cast<uint32_t>(_mm_cvtsi128_si32(bytes));
+        for (auto lane = 0u; lane < 4u; lane++)
+        {
+            destination[i + lane] = static_cast<uint8_t>(packed >> (lane * 8));
+        }
+    }
+#endif
+    for (; i < source.size(); i++)
+    {
+        destination[i] = LinearToSrgb(source[i], tables);
+    }
+}
+
+void EncodeOctahedralNormals(std::span<const glm::vec3> normals, std::span<uint32_t> destination) noexcept
+{
+    assert(destination.size() >= normals.size());
+    auto i = size_t(0);
+#if defined(FORMAT_CONVERSION_X86)
+    auto signMask = _mm_set1_ps(-0.0f);
+    auto zero = _mm_setzero_ps();
+    auto one = _mm_set1_ps(1.0f);
+    auto minusOne = _mm_set1_ps(-1.0f);
+    for (; i + 4 <= normals.size(); i += 4)
+    {
+        auto* n = normals.data() + i;
+        auto x = _mm_setr_ps(n[0].x, n[1].x, n[2].x, n[3].x);
+        auto y = _mm_setr_ps(n[0].y, n[1].y, n[2].y, n[3].y);
+        auto z = _mm_setr_ps(n[0].z, n[1].z, n[2].z, n[3].z);
+
+        // The same operations as OctahedralEncode, lane by lane
+        auto sum = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+        x = _mm_div_ps(x, sum);
+        y = _mm_div_ps(y, sum);
+        z = _mm_div_ps(z, sum);
+        auto foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, y)), Select(_mm_cmpge_ps(x, zero), one, minusOne));
+        auto foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), Select(_mm_cmpge_ps(y, zero), one, minusOne));
+        auto isUpper = _mm_cmpge_ps(z, zero);
+        x = Select(isUpper, x, foldedX);
+        y = Select(isUpper, y, foldedY);
+
+        auto packed = _mm_or_si128(
+            _mm_and_si128(FloatToSnorm16Sse2(x), _mm_set1_epi32(0xFFFF)),
+            _mm_slli_epi32(FloatToSnorm16Sse2(y), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination.data() + i), packed);
+    }
+#endif
+    for (; i < normals.size(); i++)
+    {
+        destination[i] = EncodeOctahedralNormal(normals[i]);
+    }
+}
+
+namespace
+{
+    template <size_t ComponentCount>
+    void ConvertFloatToHalfElements(const void* source, void* destination, size_t elementCount)
+    {
+        ConvertFloatToHalf(
+            std::span(static_cast<const float*>(source), elementCount * ComponentCount),
+            std::span(static_cast<uint16_t*>(destination), elementCount * ComponentCount));
+    }
+
+    template <size_t ComponentCount>
+    void ConvertHalfToFloatElements(const void* source, void* destination, size_t elementCount)
+    {
+        ConvertHalfToFloat(
+            std::span(static_cast<const uint16_t*>(source), elementCount * ComponentCount),
+            std::span(static_cast<float*>(destination), elementCount * ComponentCount));
+    }
+
+    template <size_t ComponentCount>
+    void ConvertFloatToSnorm16Elements(const void* source, void* destination, size_t elementCount)
+    {
+        ConvertFloatToSnorm16(
+            std::span(static_cast<const float*>(source), elementCount * ComponentCount),
+            std::span(static_cast<int16_t*>(destination), elementCount * ComponentCount));
+    }
+
+    template <size_t ComponentCount>
+    void ConvertSrgbToLinearElements(const void* source, void* destination, size_t elementCount)
+    {
+        auto sourceComponents = std::span(static_cast<const uint8_t*>(source), elementCount * ComponentCount);
+        auto destinationComponents = std::span(static_cast<float*>(destination), elementCount * ComponentCount);
+        ConvertSrgbToLinear(sourceComponents, destinationComponents);
+        if constexpr (ComponentCount == 4)
+        {
+            for (auto i = size_t(3); i < sourceComponents.size(); i += 4)
+            {
+                destinationComponents[i] = static_cast<float>(sourceComponents[i]) / 255.0f;
+            }
+        }
+    }
+
+    template <size_t ComponentCount>
+    void ConvertLinearToSrgbElements(const void* source, void* destination, size_t elementCount)
+    {
+        auto sourceComponents = std::span(static_cast<const float*>(source), elementCount * ComponentCount);
+        auto destinationComponents = std::span(static_cast<uint8_t*>(destination), elementCount * ComponentCount);
+        ConvertLinearToSrgb(sourceComponents, destinationComponents);
+        if constexpr (ComponentCount == 4)
+        {
+            for (auto i = size_t(3); i < sourceComponents.size(); i += 4)
+            {
+                auto alpha = sourceComponents[i] > 0.0f ? sourceComponents[i] : 0.0f;
+                destinationComponents[i] = static_cast<uint8_t>(std::lrint((alpha < 1.0f ? alpha : 1.0f) * 255.0f));
+            }
+        }
+    }
+
+    void ConvertRgba8ToRgb10A2Elements(const void* source, void* destination, size_t elementCount)
+    {
+        ConvertRgba8ToRgb10A2(
+            std::span(static_cast<const uint32_t*>(source), elementCount),
+            std::span(static_cast<uint32_t*>(destination), elementCount));
+    }
+
+    void ConvertRgb10A2ToRgba8Elements(const void* source, void* destination, size_t elementCount)
+    {
+        ConvertRgb10A2ToRgba8(
+            std::span(static_cast<const uint32_t*>(source), elementCount),
+            std::span(static_cast<uint32_t*>(destination), elementCount));
+    }
+
+    // By component count, 1 to 4
+    constexpr std::array<FormatConversionFunction, 4> FloatToHalfFunctions = { ConvertFloatToHalfElements<1>, ConvertFloatToHalfElements<2>, ConvertFloatToHalfElements<3>, ConvertFloatToHalfElements<4> };
+    constexpr std::array<FormatConversionFunction, 4> HalfToFloatFunctions = { ConvertHalfToFloatElements<1>, ConvertHalfToFloatElements<2>, ConvertHalfToFloatElements<3>, ConvertHalfToFloatElements<4> };
+    constexpr std::array<FormatConversionFunction, 4> FloatToSnorm16Functions = { ConvertFloatToSnorm16Elements<1>, ConvertFloatToSnorm16Elements<2>, ConvertFloatToSnorm16Elements<3>, ConvertFloatToSnorm16Elements<4> };
+    constexpr std::array<FormatConversionFunction, 4> SrgbToLinearFunctions = { ConvertSrgbToLinearElements<1>, ConvertSrgbToLinearElements<2>, ConvertSrgbToLinearElements<3>, ConvertSrgbToLinearElements<4> };
+    constexpr std::array<FormatConversionFunction, 4> LinearToSrgbFunctions = { ConvertLinearToSrgbElements<1>, ConvertLinearToSrgbElements<2>, ConvertLinearToSrgbElements<3>, ConvertLinearToSrgbElements<4> };
+
+    // Bytes per component of formats with one plain component per byte, short or int, zero otherwise
+    uint32_t GetComponentSize(const FormatTraits& traits) noexcept
+    {
+        return traits.Layout == FormatLayout::Components ? traits.BytesPerBlock / traits.ComponentCount : 0;
+    }
+}
+
+FormatConversionFunction GetFormatConversionFunction(Format sourceFormat, Format destinationFormat) noexcept
+{
+    if (sourceFormat == Format::R8G8B8A8_UNORM && destinationFormat == Format::R10G10B10A2_UNORM)
+    {
+        return ConvertRgba8ToRgb10A2Elements;
+    }
+    if (sourceFormat == Format::R10G10B10A2_UNORM && destinationFormat == Format::R8G8B8A8_UNORM)
+    {
+        return ConvertRgb10A2ToRgba8Elements;
+    }
+
+    auto& source = GetFormatTraits(sourceFormat);
+    auto& destination = GetFormatTraits(destinationFormat);
+    auto sourceComponentSize = GetComponentSize(source);
+    auto destinationComponentSize = GetComponentSize(destination);
+    if (source.ComponentCount != destination.ComponentCount || sourceComponentSize == 0 || destinationComponentSize == 0)
+    {
+        return nullptr;
+    }
+
+    auto functionIndex = source.ComponentCount - 1u;
+    auto isSourceFloat32 = source.NumericType == FormatNumericType::Float && sourceComponentSize == 4;
+    auto isDestinationFloat32 = destination.NumericType == FormatNumericType::Float && destinationComponentSize == 4;
+    if (isSourceFloat32 && destination.NumericType == FormatNumericType::Float && destinationComponentSize == 2)
+    {
+        return FloatToHalfFunctions[functionIndex];
+    }
+    if (source.NumericType == FormatNumericType::Float && sourceComponentSize == 2 && isDestinationFloat32)
+    {
+        return HalfToFloatFunctions[functionIndex];
+    }
+    if (isSourceFloat32 && destination.NumericType == FormatNumericType::Snorm && destinationComponentSize == 2)
+    {
+        return FloatToSnorm16Functions[functionIndex];
+    }
+    if (source.NumericType == FormatNumericType::Srgb && isDestinationFloat32)
+    {
+        return SrgbToLinearFunctions[functionIndex];
+    }
+    if (isSourceFloat32 && destination.NumericType == FormatNumericType::Srgb)
+    {
+        return LinearToSrgbFunctions[functionIndex];
+    }
+    return nullptr;
+}
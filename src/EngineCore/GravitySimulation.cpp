@@ -0,0 +1,1034 @@
+#include <EngineCore/GravitySimulation.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GRAVITY_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// 32 bit NEON has no double lanes, it takes the scalar kernel
+#define GRAVITY_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t InvalidIndex = UINT32_MAX;
+    constexpr uint32_t BodiesPerTask = 8192;
+    constexpr uint32_t LeavesPerTask = 16;
+    // Ranges up to this many bodies become one subtree task
+    constexpr uint32_t SubtreeBodyCount = 4096;
+    // 21 bits per axis, the Morton code takes the low 63 bits
+    constexpr uint32_t MortonAxisBitCount = 21;
+    constexpr double MortonAxisMaximum = static_cast<double>((1u << MortonAxisBitCount) - 1);
+    constexpr uint32_t RadixBitCount = 11;
+    constexpr uint32_t RadixBucketCount = 1u << RadixBitCount;
+    constexpr uint32_t RadixPassCount = (3 * MortonAxisBitCount + RadixBitCount - 1) / RadixBitCount;
+    // Bodies sharing one tree walk, leaves holding more than that walk once per group
+    constexpr uint32_t MaxGroupSize = 64;
+    constexpr uint32_t InteractionBatchSize = 256;
+    // A walk pops one node per level and pushes at most eight, over at most 22 levels
+    constexpr uint32_t TraversalStackSize = 8 * 24;
+
+    struct InteractionBatch
+    {
+        double X[InteractionBatchSize];
+        double Y[InteractionBatchSize];
+        double Z[InteractionBatchSize];
+        double Mass[InteractionBatchSize];
+        uint32_t Count = 0;
+    };
+
+    uint64_t SpreadMortonBits(uint64_t value) noexcept
+    {
+        value &= 0x1fffff;
+        value = (value | value << 32) & 0x1f00000000ffff;
+        value = (value | value << 16) & 0x1f0000ff0000ff;
+        value = (value | value << 8) & 0x100f00f00f00f00f;
+        value = (value | value << 4) & 0x10c30c30c30c30c3;
+        value = (value | value << 2) & 0x1249249249249249;
+        return value;
+    }
+
+    double GetMilliseconds(std::chrono::steady_clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Calls function once per chunk of BodiesPerTask bodies, for passes that keep results per chunk.
+    // ParallelFor ranges start on chunks, but a scheduler without workers hands out all of them at once
+    template <typename TFunction>
+    void ParallelForChunks(TaskScheduler& taskScheduler, uint32_t count, TFunction&& function)
+    {
+        taskScheduler.ParallelFor(count, BodiesPerTask, [&](uint32_t begin, uint32_t end)
+        {
+            for (auto chunkBegin = begin; chunkBegin < end; chunkBegin += BodiesPerTask)
+            {
+                function(chunkBegin / BodiesPerTask, chunkBegin, std::min(chunkBegin + BodiesPerTask, end));
+            }
+        });
+    }
+
+    template <typename T>
+    void SwapRemove(std::vector<T>& values, uint32_t index)
+    {
+        values[index] = values.back();
+        values.pop_back();
+    }
+
+    // Coincident bodies, a body and itself included, do not pull on each other
+    void AccumulateGravityRange(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceBegin,
+        uint32_t sourceEnd,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential)
+    {
+        for (uint32_t target = 0; target < targetCount; target++)
+        {
+            auto ax = 0.0;
+            auto ay = 0.0;
+            auto az = 0.0;
+            auto phi = 0.0;
+            for (auto source = sourceBegin; source < sourceEnd; source++)
+            {
+                auto dx = sourceX[source] - targetX[target];
+                auto dy = sourceY[source] - targetY[target];
+                auto dz = sourceZ[source] - targetZ[target];
+                auto distanceSquared = dx * dx + dy * dy + dz * dz;
+                if (distanceSquared > 0.0)
+                {
+                    auto inverseDistance = 1.0 / std::sqrt(distanceSquared + softeningSquared);
+                    auto massOverDistance = sourceMass[source] * inverseDistance;
+                    auto massOverDistanceCubed = massOverDistance * inverseDistance * inverseDistance;
+                    ax += dx * massOverDistanceCubed;
+                    ay += dy * massOverDistanceCubed;
+                    az += dz * massOverDistanceCubed;
+                    phi -= massOverDistance;
+                }
+            }
+            accelerationX[target] += ax;
+            accelerationY[target] += ay;
+            accelerationZ[target] += az;
+            potential[target] += phi;
+        }
+    }
+
+    void AccumulateGravityScalar(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceCount,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential)
+    {
+        AccumulateGravityRange(
+            sourceX, sourceY, sourceZ, sourceMass, 0, sourceCount,
+            targetX, targetY, targetZ, targetCount, softeningSquared,
+            accelerationX, accelerationY, accelerationZ, potential);
+    }
+
+#if defined(GRAVITY_KERNELS_X86)
+
+    double HorizontalSum(__m128d value)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+    }
+
+    void AccumulateGravitySse2(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceCount,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential)
+    {
+        const auto softening = _mm_set1_pd(softeningSquared);
+        const auto one = _mm_set1_pd(1.0);
+        const auto zero = _mm_setzero_pd();
+        auto vectorEnd = sourceCount & ~1u;
+
+        for (uint32_t target = 0; target < targetCount; target++)
+        {
+            auto tx = _mm_set1_pd(targetX[target]);
+            auto ty = _mm_set1_pd(targetY[target]);
+            auto tz = _mm_set1_pd(targetZ[target]);
+            auto ax = zero;
+            auto ay = zero;
+            auto az = zero;
+            auto phi = zero;
+            for (uint32_t source = 0; source < vectorEnd; source += 2)
+            {
+                auto dx = _mm_sub_pd(_mm_loadu_pd(sourceX + source), tx);
+                auto dy = _mm_sub_pd(_mm_loadu_pd(sourceY + source), ty);
+                auto dz = _mm_sub_pd(_mm_loadu_pd(sourceZ + source), tz);
+                auto distanceSquared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+                auto isApart = _mm_cmpgt_pd(distanceSquared, zero);
+                // Masked before use, without softening the self pair's infinity would turn into NaN below
+                auto inverseDistance = _mm_and_pd(_mm_div_pd(one, _mm_sqrt_pd(_mm_add_pd(distanceSquared, softening))), isApart);
+                auto massOverDistance = _mm_mul_pd(_mm_loadu_pd(sourceMass + source), inverseDistance);
+                auto massOverDistanceCubed = _mm_mul_pd(massOverDistance, _mm_mul_pd(inverseDistance, inverseDistance));
+                ax = _mm_add_pd(ax, _mm_mul_pd(dx, massOverDistanceCubed));
+                ay = _mm_add_pd(ay, _mm_mul_pd(dy, massOverDistanceCubed));
+                az = _mm_add_pd(az, _mm_mul_pd(dz, massOverDistanceCubed));
+                phi = _mm_sub_pd(phi, massOverDistance);
+            }
+            accelerationX[target] += HorizontalSum(ax);
+            accelerationY[target] += HorizontalSum(ay);
+            accelerationZ[target] += HorizontalSum(az);
+            potential[target] += HorizontalSum(phi);
+        }
+
+        AccumulateGravityRange(
+            sourceX, sourceY, sourceZ, sourceMass, vectorEnd, sourceCount,
+            targetX, targetY, targetZ, targetCount, softeningSquared,
+            accelerationX, accelerationY, accelerationZ, potential);
+    }
+
+    TARGET_AVX2 double HorizontalSumAvx2(__m256d value)
+    {
+        auto sum = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    TARGET_AVX2 void AccumulateGravityAvx2(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceCount,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential)
+    {
+        const auto softening = _mm256_set1_pd(softeningSquared);
+        const auto one = _mm256_set1_pd(1.0);
+        const auto zero = _mm256_setzero_pd();
+        auto vectorEnd = sourceCount & ~3u;
+
+        for (uint32_t target = 0; target < targetCount; target++)
+        {
+            auto tx = _mm256_set1_pd(targetX[target]);
+            auto ty = _mm256_set1_pd(targetY[target]);
+            auto tz = _mm256_set1_pd(targetZ[target]);
+            auto ax = zero;
+            auto ay = zero;
+            auto az = zero;
+            auto phi = zero;
+            for (uint32_t source = 0; source < vectorEnd; source += 4)
+            {
+                auto dx = _mm256_sub_pd(_mm256_loadu_pd(sourceX + source), tx);
+                auto dy = _mm256_sub_pd(_mm256_loadu_pd(sourceY + source), ty);
+                auto dz = _mm256_sub_pd(_mm256_loadu_pd(sourceZ + source), tz);
+                auto distanceSquared = _mm256_fmadd_pd(dz, dz, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dx, dx)));
+                auto isApart = _mm256_cmp_pd(distanceSquared, zero, _CMP_GT_OQ);
+                auto inverseDistance = _mm256_and_pd(_mm256_div_pd(one, _mm256_sqrt_pd(_mm256_add_pd(distanceSquared, softening))), isApart);
+                auto massOverDistance = _mm256_mul_pd(_mm256_loadu_pd(sourceMass + source), inverseDistance);
+                auto massOverDistanceCubed = _mm256_mul_pd(massOverDistance, _mm256_mul_pd(inverseDistance, inverseDistance));
+                ax = _mm256_fmadd_pd(dx, massOverDistanceCubed, ax);
+                ay = _mm256_fmadd_pd(dy, massOverDistanceCubed, ay);
+                az = _mm256_fmadd_pd(dz, massOverDistanceCubed, az);
+                phi = _mm256_sub_pd(phi, massOverDistance);
+            }
+            accelerationX[target] += HorizontalSumAvx2(ax);
+            accelerationY[target] += HorizontalSumAvx2(ay);
+            accelerationZ[target] += HorizontalSumAvx2(az);
+            potential[target] += HorizontalSumAvx2(phi);
+        }
+
+        AccumulateGravityRange(
+            sourceX, sourceY, sourceZ, sourceMass, vectorEnd, sourceCount,
+            targetX, targetY, targetZ, targetCount, softeningSquared,
+            accelerationX, accelerationY, accelerationZ, potential);
+    }
+
+#elif defined(GRAVITY_KERNELS_NEON)
+
+    void AccumulateGravityNeon(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceCount,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential)
+    {
+        const auto softening = vdupq_n_f64(softeningSquared);
+        const auto one = vdupq_n_f64(1.0);
+        const auto zero = vdupq_n_f64(0.0);
+        auto vectorEnd = sourceCount & ~1u;
+
+        for (uint32_t target = 0; target < targetCount; target++)
+        {
+            auto tx = vdupq_n_f64(targetX[target]);
+            auto ty = vdupq_n_f64(targetY[target]);
+            auto tz = vdupq_n_f64(targetZ[target]);
+            auto ax = zero;
+            auto ay = zero;
+            auto az = zero;
+            auto phi = zero;
+            for (uint32_t source = 0; source < vectorEnd; source += 2)
+            {
+                auto dx = vsubq_f64(vld1q_f64(sourceX + source), tx);
+                auto dy = vsubq_f64(vld1q_f64(sourceY + source), ty);
+                auto dz = vsubq_f64(vld1q_f64(sourceZ + source), tz);
+                auto distanceSquared = vfmaq_f64(vfmaq_f64(vmulq_f64(dx, dx), dy, dy), dz, dz);
+                auto isApart = vcgtq_f64(distanceSquared, zero);
+                auto inverseDistance = vreinterpretq_f64_u64(vandq_u64(
+                    vreinterpretq_u64_f64(vdivq_f64(one, vsqrtq_f64(vaddq_f64(distanceSquared, softening)))),
+                    isApart));
+                auto massOverDistance = vmulq_f64(vld1q_f64(sourceMass + source), inverseDistance);
+                auto massOverDistanceCubed = vmulq_f64(massOverDistance, vmulq_f64(inverseDistance, inverseDistance));
+                ax = vfmaq_f64(ax, dx, massOverDistanceCubed);
+                ay = vfmaq_f64(ay, dy, massOverDistanceCubed);
+                az = vfmaq_f64(az, dz, massOverDistanceCubed);
+                phi = vsubq_f64(phi, massOverDistance);
+            }
+            accelerationX[target] += vaddvq_f64(ax);
+            accelerationY[target] += vaddvq_f64(ay);
+            accelerationZ[target] += vaddvq_f64(az);
+            potential[target] += vaddvq_f64(phi);
+        }
+
+        AccumulateGravityRange(
+            sourceX, sourceY, sourceZ, sourceMass, vectorEnd, sourceCount,
+            targetX, targetY, targetZ, targetCount, softeningSquared,
+            accelerationX, accelerationY, accelerationZ, potential);
+    }
+
+#endif
+}
+
+GravitySimulation::GravitySimulation(const GravitySimulationSettings& settings)
+    : _settings(settings)
+{
+    _settings.LeafSize = std::clamp(_settings.LeafSize, 1u, MaxGroupSize);
+    _settings.OpeningAngle = std::clamp(_settings.OpeningAngle, 0.0, 0.99);
+    SetKernelLevel(GetSupportedTransformKernelLevel());
+}
+
+uint32_t GravitySimulation::Add(const glm::dvec3& position, const glm::dvec3& velocity, double mass)
+{
+    uint32_t id;
+    if (_freeIds.empty())
+    {
+        id = static_cast<uint32_t>(_indexById.size());
+        _indexById.push_back(InvalidIndex);
+    }
+    else
+    {
+        id = _freeIds.back();
+        _freeIds.pop_back();
+    }
+
+    _indexById[id] = GetCount();
+    _positionX.push_back(position.x);
+    _positionY.push_back(position.y);
+    _positionZ.push_back(position.z);
+    _velocityX.push_back(velocity.x);
+    _velocityY.push_back(velocity.y);
+    _velocityZ.push_back(velocity.z);
+    _accelerationX.push_back(0.0);
+    _accelerationY.push_back(0.0);
+    _accelerationZ.push_back(0.0);
+    _mass.push_back(mass);
+    _ids.push_back(id);
+
+    _hasAccelerations = false;
+    _isTreeCurrent = false;
+    return id;
+}
+
+void GravitySimulation::Remove(uint32_t id)
+{
+    auto index = _indexById[id];
+    assert(index != InvalidIndex);
+
+    SwapRemove(_positionX, index);
+    SwapRemove(_positionY, index);
+    SwapRemove(_positionZ, index);
+    SwapRemove(_velocityX, index);
+    SwapRemove(_velocityY, index);
+    SwapRemove(_velocityZ, index);
+    SwapRemove(_accelerationX, index);
+    SwapRemove(_accelerationY, index);
+    SwapRemove(_accelerationZ, index);
+    SwapRemove(_mass, index);
+    SwapRemove(_ids, index);
+    if (index < GetCount())
+    {
+        _indexById[_ids[index]] = index;
+    }
+
+    // What is left keeps its accelerations, they are off by the pull of the removed body for half a step
+    _indexById[id] = InvalidIndex;
+    _freeIds.push_back(id);
+    _isTreeCurrent = false;
+}
+
+void GravitySimulation::Clear()
+{
+    for (auto* values : { &_positionX, &_positionY, &_positionZ, &_velocityX, &_velocityY, &_velocityZ,
+                          &_accelerationX, &_accelerationY, &_accelerationZ, &_potential, &_mass })
+    {
+        values->clear();
+    }
+    _ids.clear();
+    _indexById.clear();
+    _freeIds.clear();
+    _hasAccelerations = false;
+    _isTreeCurrent = false;
+}
+
+void GravitySimulation::Reserve(uint32_t capacity)
+{
+    for (auto* values : { &_positionX, &_positionY, &_positionZ, &_velocityX, &_velocityY, &_velocityZ,
+                          &_accelerationX, &_accelerationY, &_accelerationZ, &_mass })
+    {
+        values->reserve(capacity);
+    }
+    _ids.reserve(capacity);
+    _indexById.reserve(capacity);
+}
+
+glm::dvec3 GravitySimulation::GetPosition(uint32_t id) const noexcept
+{
+    auto index = _indexById[id];
+    return glm::dvec3(_positionX[index], _positionY[index], _positionZ[index]);
+}
+
+glm::dvec3 GravitySimulation::GetVelocity(uint32_t id) const noexcept
+{
+    auto index = _indexById[id];
+    return glm::dvec3(_velocityX[index], _velocityY[index], _velocityZ[index]);
+}
+
+double GravitySimulation::GetMass(uint32_t id) const noexcept
+{
+    return _mass[_indexById[id]];
+}
+
+void GravitySimulation::SetVelocity(uint32_t id, const glm::dvec3& velocity) noexcept
+{
+    auto index = _indexById[id];
+    _velocityX[index] = velocity.x;
+    _velocityY[index] = velocity.y;
+    _velocityZ[index] = velocity.z;
+}
+
+void GravitySimulation::SetKernelLevel(TransformKernelLevel kernelLevel)
+{
+    auto supportedLevel = GetSupportedTransformKernelLevel();
+    _kernelLevel = TransformKernelLevel::Scalar;
+    _accumulateGravity = AccumulateGravityScalar;
+
+#if defined(GRAVITY_KERNELS_X86)
+    if (kernelLevel == TransformKernelLevel::Avx2 && supportedLevel == TransformKernelLevel::Avx2)
+    {
+        _kernelLevel = TransformKernelLevel::Avx2;
+        _accumulateGravity = AccumulateGravityAvx2;
+    }
+    else if (kernelLevel == TransformKernelLevel::Avx2 || kernelLevel == TransformKernelLevel::Sse2)
+    {
+        _kernelLevel = TransformKernelLevel::Sse2;
+        _accumulateGravity = AccumulateGravitySse2;
+    }
+#elif defined(GRAVITY_KERNELS_NEON)
+    if (kernelLevel == TransformKernelLevel::Neon && supportedLevel == TransformKernelLevel::Neon)
+    {
+        _kernelLevel = TransformKernelLevel::Neon;
+        _accumulateGravity = AccumulateGravityNeon;
+    }
+#endif
+
+    (void)kernelLevel;
+    (void)supportedLevel;
+}
+
+void GravitySimulation::Step(double deltaTime, TaskScheduler& taskScheduler, std::span<const GravityAttractor> attractors)
+{
+    _statistics = {};
+    _interactionCount.store(0, std::memory_order_relaxed);
+    if (GetCount() == 0)
+    {
+        return;
+    }
+
+    if (!_hasAccelerations)
+    {
+        BuildTree(taskScheduler);
+        ComputeAccelerations(taskScheduler, attractors, false);
+        _hasAccelerations = true;
+    }
+
+    KickDrift(taskScheduler, deltaTime * 0.5, deltaTime);
+    BuildTree(taskScheduler);
+    ComputeAccelerations(taskScheduler, attractors, false);
+    KickDrift(taskScheduler, deltaTime * 0.5, 0.0);
+
+    _statistics.NodeCount = _nodeCount.load(std::memory_order_relaxed);
+    _statistics.LeafCount = _leafCount.load(std::memory_order_relaxed);
+    _statistics.InteractionCount = _interactionCount.load(std::memory_order_relaxed);
+}
+
+double GravitySimulation::ComputeEnergy(TaskScheduler& taskScheduler)
+{
+    auto count = GetCount();
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // The statistics stay those of the last step
+    auto statistics = _statistics;
+    if (!_isTreeCurrent)
+    {
+        BuildTree(taskScheduler);
+    }
+    _potential.resize(count);
+    ComputeAccelerations(taskScheduler, {}, true);
+    _statistics = statistics;
+
+    // Summed per chunk and then in chunk order, so the total does not depend on the threads either
+    auto chunkCount = (count + BodiesPerTask - 1) / BodiesPerTask;
+    _chunkValues.assign(chunkCount, 0.0);
+    ParallelForChunks(taskScheduler, count, [&](uint32_t chunk, uint32_t begin, uint32_t end)
+    {
+        auto energy = 0.0;
+        for (auto i = begin; i < end; i++)
+        {
+            auto speedSquared = _velocityX[i] * _velocityX[i] + _velocityY[i] * _velocityY[i] + _velocityZ[i] * _velocityZ[i];
+            // Every pair shows up in the potential of both bodies
+            energy += 0.5 * _mass[i] * (speedSquared + _potential[i]);
+        }
+        _chunkValues[chunk] = energy;
+    });
+
+    auto energy = 0.0;
+    for (auto chunkEnergy : _chunkValues)
+    {
+        energy += chunkEnergy;
+    }
+    return energy;
+}
+
+void GravitySimulation::BuildTree(TaskScheduler& taskScheduler)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto count = GetCount();
+
+    ComputeMortonCodes(taskScheduler);
+    SortBodies(taskScheduler);
+
+    // Every inner node has two children at least, which caps the tree at 2n - 1 nodes
+    if (_nodes.size() < 2 * static_cast<size_t>(count))
+    {
+        _nodes.resize(2 * static_cast<size_t>(count));
+    }
+    _leaves.resize(count);
+    _nodeCount.store(1, std::memory_order_relaxed);
+    _leafCount.store(0, std::memory_order_relaxed);
+    _subtrees.clear();
+    _topNodes.clear();
+
+    // The top of the tree is split here until the ranges are small enough to be a task each
+    SplitTopNode(0, 0, count);
+    taskScheduler.ParallelFor(static_cast<uint32_t>(_subtrees.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            BuildSubtree(_subtrees[i].Node, _subtrees[i].First, _subtrees[i].Last);
+        }
+    });
+
+    // Children were split off after their parents, merging backwards sees them finished
+    for (auto topNode = _topNodes.rbegin(); topNode != _topNodes.rend(); ++topNode)
+    {
+        MergeChildren(*topNode);
+    }
+
+    _isTreeCurrent = true;
+    _statistics.TreeMilliseconds += GetMilliseconds(start);
+}
+
+void GravitySimulation::ComputeMortonCodes(TaskScheduler& taskScheduler)
+{
+    auto count = GetCount();
+    auto chunkCount = (count + BodiesPerTask - 1) / BodiesPerTask;
+    _chunkValues.resize(static_cast<size_t>(chunkCount) * 6);
+    ParallelForChunks(taskScheduler, count, [&](uint32_t chunk, uint32_t begin, uint32_t end)
+    {
+        auto* bounds = &_chunkValues[static_cast<size_t>(chunk) * 6];
+        bounds[0] = bounds[3] = _positionX[begin];
+        bounds[1] = bounds[4] = _positionY[begin];
+        bounds[2] = bounds[5] = _positionZ[begin];
+        for (auto i = begin + 1; i < end; i++)
+        {
+            bounds[0] = std::min(bounds[0], _positionX[i]);
+            bounds[1] = std::min(bounds[1], _positionY[i]);
+            bounds[2] = std::min(bounds[2], _positionZ[i]);
+            bounds[3] = std::max(bounds[3], _positionX[i]);
+            bounds[4] = std::max(bounds[4], _positionY[i]);
+            bounds[5] = std::max(bounds[5], _positionZ[i]);
+        }
+    });
+
+    glm::dvec3 minimum(std::numeric_limits<double>::max());
+    glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+    for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        auto* bounds = &_chunkValues[static_cast<size_t>(chunk) * 6];
+        for (auto axis = 0; axis < 3; axis++)
+        {
+            minimum[axis] = std::min(minimum[axis], bounds[axis]);
+            maximum[axis] = std::max(maximum[axis], bounds[axis + 3]);
+        }
+    }
+
+    // One cube for all axes, so octants stay cubes and the opening test sees their true size
+    auto extent = std::max({ maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z });
+    auto scale = extent > 0.0 ? MortonAxisMaximum / extent : 0.0;
+
+    _mortonCodes.resize(count);
+    _mortonCodesScratch.resize(count);
+    _order.resize(count);
+    _orderScratch.resize(count);
+    taskScheduler.ParallelFor(count, BodiesPerTask, [&](uint32_t begin, uint32_t end)
+    {
+        auto quantize = [&](double value, double axisMinimum)
+        {
+            return static_cast<uint64_t>(std::clamp((value - axisMinimum) * scale, 0.0, MortonAxisMaximum));
+        };
+
+        for (auto i = begin; i < end; i++)
+        {
+            _mortonCodes[i] =
+                SpreadMortonBits(quantize(_positionX[i], minimum.x)) |
+                SpreadMortonBits(quantize(_positionY[i], minimum.y)) << 1 |
+                SpreadMortonBits(quantize(_positionZ[i], minimum.z)) << 2;
+            _order[i] = i;
+        }
+    });
+}
+
+void GravitySimulation::SortBodies(TaskScheduler& taskScheduler)
+{
+    auto count = GetCount();
+    auto chunkCount = (count + BodiesPerTask - 1) / BodiesPerTask;
+    _radixHistograms.resize(static_cast<size_t>(chunkCount) * RadixBucketCount);
+
+    // Least significant digit first, each pass is stable, so equal codes keep last step's order
+    for (uint32_t pass = 0; pass < RadixPassCount; pass++)
+    {
+        auto shift = pass * RadixBitCount;
+        ParallelForChunks(taskScheduler, count, [&](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            auto* histogram = &_radixHistograms[static_cast<size_t>(chunk) * RadixBucketCount];
+            std::fill_n(histogram, RadixBucketCount, 0u);
+            for (auto i = begin; i < end; i++)
+            {
+                histogram[(_mortonCodes[i] >> shift) & (RadixBucketCount - 1)]++;
+            }
+        });
+
+        // Histograms become where each chunk writes its first body of each bucket
+        uint32_t offset = 0;
+        auto isSingleBucket = false;
+        for (uint32_t bucket = 0; bucket < RadixBucketCount; bucket++)
+        {
+            auto bucketBegin = offset;
+            for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+            {
+                auto& histogram = _radixHistograms[static_cast<size_t>(chunk) * RadixBucketCount + bucket];
+                auto bucketCount = histogram;
+                histogram = offset;
+                offset += bucketCount;
+            }
+            isSingleBucket |= offset - bucketBegin == count;
+        }
+        if (isSingleBucket)
+        {
+            continue;
+        }
+
+        ParallelForChunks(taskScheduler, count, [&](uint32_t chunk, uint32_t begin, uint32_t end)
+        {
+            auto* offsets = &_radixHistograms[static_cast<size_t>(chunk) * RadixBucketCount];
+            for (auto i = begin; i < end; i++)
+            {
+                auto destination = offsets[(_mortonCodes[i] >> shift) & (RadixBucketCount - 1)]++;
+                _mortonCodesScratch[destination] = _mortonCodes[i];
+                _orderScratch[destination] = _order[i];
+            }
+        });
+        std::swap(_mortonCodes, _mortonCodesScratch);
+        std::swap(_order, _orderScratch);
+    }
+
+    // Gathers the bodies into Morton order, one array at a time
+    _bodyScratch.resize(count);
+    for (auto* values : { &_positionX, &_positionY, &_positionZ, &_velocityX, &_velocityY, &_velocityZ,
+                          &_accelerationX, &_accelerationY, &_accelerationZ, &_mass })
+    {
+        taskScheduler.ParallelFor(count, BodiesPerTask, [&](uint32_t begin, uint32_t end)
+        {
+            for (auto i = begin; i < end; i++)
+            {
+                _bodyScratch[i] = (*values)[_order[i]];
+            }
+        });
+        std::swap(*values, _bodyScratch);
+    }
+
+    _idScratch.resize(count);
+    taskScheduler.ParallelFor(count, BodiesPerTask, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            _idScratch[i] = _ids[_order[i]];
+            _indexById[_idScratch[i]] = i;
+        }
+    });
+    std::swap(_ids, _idScratch);
+}
+
+bool GravitySimulation::IsLeaf(uint32_t first, uint32_t last) const noexcept
+{
+    // Bodies sharing one code cannot be told apart any further
+    return last - first <= _settings.LeafSize || _mortonCodes[first] == _mortonCodes[last - 1];
+}
+
+uint32_t GravitySimulation::SplitNode(uint32_t nodeIndex, uint32_t first, uint32_t last, std::span<BodyRange, 8> children)
+{
+    // Levels the bodies all share no node, the split happens at the first octant digit they differ in
+    const auto* codes = _mortonCodes.data();
+    auto highestBit = 63 - static_cast<uint32_t>(std::countl_zero(codes[first] ^ codes[last - 1]));
+    auto shift = highestBit / 3 * 3;
+
+    uint32_t childCount = 0;
+    for (auto begin = first; begin < last;)
+    {
+        auto octant = (codes[begin] >> shift) & 7;
+        auto end = static_cast<uint32_t>(std::partition_point(codes + begin, codes + last, [&](uint64_t code)
+        {
+            return ((code >> shift) & 7) == octant;
+        }) - codes);
+        children[childCount++] = BodyRange{ .Node = 0, .First = begin, .Last = end };
+        begin = end;
+    }
+
+    auto firstChild = _nodeCount.fetch_add(childCount, std::memory_order_relaxed);
+    for (uint32_t child = 0; child < childCount; child++)
+    {
+        children[child].Node = firstChild + child;
+    }
+
+    auto& node = _nodes[nodeIndex];
+    node.FirstChild = firstChild;
+    node.ChildCount = childCount;
+    node.FirstBody = first;
+    node.BodyCount = last - first;
+    return childCount;
+}
+
+void GravitySimulation::SplitTopNode(uint32_t nodeIndex, uint32_t first, uint32_t last)
+{
+    if (last - first <= SubtreeBodyCount || IsLeaf(first, last))
+    {
+        _subtrees.push_back(BodyRange{ .Node = nodeIndex, .First = first, .Last = last });
+        return;
+    }
+
+    BodyRange children[8];
+    auto childCount = SplitNode(nodeIndex, first, last, children);
+    _topNodes.push_back(nodeIndex);
+    for (uint32_t child = 0; child < childCount; child++)
+    {
+        SplitTopNode(children[child].Node, children[child].First, children[child].Last);
+    }
+}
+
+void GravitySimulation::BuildSubtree(uint32_t nodeIndex, uint32_t first, uint32_t last)
+{
+    if (IsLeaf(first, last))
+    {
+        BuildLeaf(nodeIndex, first, last);
+        return;
+    }
+
+    BodyRange children[8];
+    auto childCount = SplitNode(nodeIndex, first, last, children);
+    for (uint32_t child = 0; child < childCount; child++)
+    {
+        BuildSubtree(children[child].Node, children[child].First, children[child].Last);
+    }
+    MergeChildren(nodeIndex);
+}
+
+void GravitySimulation::BuildLeaf(uint32_t nodeIndex, uint32_t first, uint32_t last)
+{
+    auto mass = 0.0;
+    glm::dvec3 weightedPosition(0.0);
+    for (auto i = first; i < last; i++)
+    {
+        mass += _mass[i];
+        weightedPosition += glm::dvec3(_positionX[i], _positionY[i], _positionZ[i]) * _mass[i];
+    }
+
+    // Massless bodies still need a center for the opening test
+    auto centerOfMass = mass > 0.0
+        ? weightedPosition / mass
+        : glm::dvec3(_positionX[first], _positionY[first], _positionZ[first]);
+    auto radiusSquared = 0.0;
+    for (auto i = first; i < last; i++)
+    {
+        auto offset = glm::dvec3(_positionX[i], _positionY[i], _positionZ[i]) - centerOfMass;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+
+    _nodes[nodeIndex] = Node
+    {
+        .CenterOfMassX = centerOfMass.x,
+        .CenterOfMassY = centerOfMass.y,
+        .CenterOfMassZ = centerOfMass.z,
+        .Mass = mass,
+        .Radius = std::sqrt(radiusSquared),
+        .FirstChild = 0,
+        .ChildCount = 0,
+        .FirstBody = first,
+        .BodyCount = last - first
+    };
+    _leaves[_leafCount.fetch_add(1, std::memory_order_relaxed)] = nodeIndex;
+}
+
+void GravitySimulation::MergeChildren(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    auto mass = 0.0;
+    glm::dvec3 weightedPosition(0.0);
+    for (auto child = node.FirstChild; child < node.FirstChild + node.ChildCount; child++)
+    {
+        auto& childNode = _nodes[child];
+        mass += childNode.Mass;
+        weightedPosition += glm::dvec3(childNode.CenterOfMassX, childNode.CenterOfMassY, childNode.CenterOfMassZ) * childNode.Mass;
+    }
+
+    auto& firstChild = _nodes[node.FirstChild];
+    auto centerOfMass = mass > 0.0
+        ? weightedPosition / mass
+        : glm::dvec3(firstChild.CenterOfMassX, firstChild.CenterOfMassY, firstChild.CenterOfMassZ);
+    auto radius = 0.0;
+    for (auto child = node.FirstChild; child < node.FirstChild + node.ChildCount; child++)
+    {
+        auto& childNode = _nodes[child];
+        auto childCenter = glm::dvec3(childNode.CenterOfMassX, childNode.CenterOfMassY, childNode.CenterOfMassZ);
+        radius = std::max(radius, childNode.Radius + glm::length(childCenter - centerOfMass));
+    }
+
+    node.CenterOfMassX = centerOfMass.x;
+    node.CenterOfMassY = centerOfMass.y;
+    node.CenterOfMassZ = centerOfMass.z;
+    node.Mass = mass;
+    node.Radius = radius;
+}
+
+void GravitySimulation::ComputeAccelerations(TaskScheduler& taskScheduler, std::span<const GravityAttractor> attractors, bool writePotential)
+{
+    auto start = std::chrono::steady_clock::now();
+    taskScheduler.ParallelFor(_leafCount.load(std::memory_order_relaxed), LeavesPerTask, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            ComputeLeafAccelerations(_leaves[i], attractors, writePotential);
+        }
+    });
+    _statistics.ForceMilliseconds += GetMilliseconds(start);
+}
+
+void GravitySimulation::ComputeLeafAccelerations(uint32_t leafNode, std::span<const GravityAttractor> attractors, bool writePotential)
+{
+    const auto& leaf = _nodes[leafNode];
+    auto openingAngleSquared = _settings.OpeningAngle * _settings.OpeningAngle;
+    auto softeningSquared = _settings.Softening * _settings.Softening;
+    auto gravitationalConstant = _settings.GravitationalConstant;
+    uint64_t interactionCount = 0;
+
+    for (auto groupFirst = leaf.FirstBody; groupFirst < leaf.FirstBody + leaf.BodyCount; groupFirst += MaxGroupSize)
+    {
+        auto groupCount = std::min(MaxGroupSize, leaf.FirstBody + leaf.BodyCount - groupFirst);
+        glm::dvec3 minimum(_positionX[groupFirst], _positionY[groupFirst], _positionZ[groupFirst]);
+        auto maximum = minimum;
+        for (auto i = groupFirst + 1; i < groupFirst + groupCount; i++)
+        {
+            minimum = glm::min(minimum, glm::dvec3(_positionX[i], _positionY[i], _positionZ[i]));
+            maximum = glm::max(maximum, glm::dvec3(_positionX[i], _positionY[i], _positionZ[i]));
+        }
+
+        double accelerationX[MaxGroupSize] = {};
+        double accelerationY[MaxGroupSize] = {};
+        double accelerationZ[MaxGroupSize] = {};
+        double potential[MaxGroupSize] = {};
+        InteractionBatch batch;
+
+        auto flush = [&]()
+        {
+            _accumulateGravity(
+                batch.X, batch.Y, batch.Z, batch.Mass, batch.Count,
+                &_positionX[groupFirst], &_positionY[groupFirst], &_positionZ[groupFirst], groupCount,
+                softeningSquared,
+                accelerationX, accelerationY, accelerationZ, potential);
+            interactionCount += static_cast<uint64_t>(batch.Count) * groupCount;
+            batch.Count = 0;
+        };
+
+        auto add = [&](double x, double y, double z, double mass)
+        {
+            if (batch.Count == InteractionBatchSize)
+            {
+                flush();
+            }
+            batch.X[batch.Count] = x;
+            batch.Y[batch.Count] = y;
+            batch.Z[batch.Count] = z;
+            batch.Mass[batch.Count] = mass;
+            batch.Count++;
+        };
+
+        // The whole group takes a node as one point mass only when all of it is far enough away,
+        // which the node's own bodies never are
+        uint32_t stack[TraversalStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const auto& node = _nodes[stack[--stackSize]];
+            auto centerOfMass = glm::dvec3(node.CenterOfMassX, node.CenterOfMassY, node.CenterOfMassZ);
+            auto offset = glm::clamp(centerOfMass, minimum, maximum) - centerOfMass;
+            if (glm::dot(offset, offset) * openingAngleSquared > node.Radius * node.Radius)
+            {
+                add(node.CenterOfMassX, node.CenterOfMassY, node.CenterOfMassZ, node.Mass);
+            }
+            else if (node.ChildCount == 0)
+            {
+                for (auto i = node.FirstBody; i < node.FirstBody + node.BodyCount; i++)
+                {
+                    add(_positionX[i], _positionY[i], _positionZ[i], _mass[i]);
+                }
+            }
+            else
+            {
+                assert(stackSize + node.ChildCount <= TraversalStackSize);
+                for (auto child = node.ChildCount; child-- > 0;)
+                {
+                    stack[stackSize++] = node.FirstChild + child;
+                }
+            }
+        }
+
+        for (auto& attractor : attractors)
+        {
+            add(attractor.Position.x, attractor.Position.y, attractor.Position.z, attractor.Mass);
+        }
+        if (batch.Count > 0)
+        {
+            flush();
+        }
+
+        for (uint32_t i = 0; i < groupCount; i++)
+        {
+            if (writePotential)
+            {
+                _potential[groupFirst + i] = gravitationalConstant * potential[i];
+            }
+            else
+            {
+                _accelerationX[groupFirst + i] = gravitationalConstant * accelerationX[i];
+                _accelerationY[groupFirst + i] = gravitationalConstant * accelerationY[i];
+                _accelerationZ[groupFirst + i] = gravitationalConstant * accelerationZ[i];
+            }
+        }
+    }
+
+    _interactionCount.fetch_add(interactionCount, std::memory_order_relaxed);
+}
+
+void GravitySimulation::KickDrift(TaskScheduler& taskScheduler, double kickTime, double driftTime)
+{
+    auto start = std::chrono::steady_clock::now();
+    taskScheduler.ParallelFor(GetCount(), BodiesPerTask, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            _velocityX[i] += _accelerationX[i] * kickTime;
+            _velocityY[i] += _accelerationY[i] * kickTime;
+            _velocityZ[i] += _accelerationZ[i] * kickTime;
+        }
+
+        if (driftTime != 0.0)
+        {
+            for (auto i = begin; i < end; i++)
+            {
+                _positionX[i] += _velocityX[i] * driftTime;
+                _positionY[i] += _velocityY[i] * driftTime;
+                _positionZ[i] += _velocityZ[i] * driftTime;
+            }
+        }
+    });
+
+    if (driftTime != 0.0)
+    {
+        _isTreeCurrent = false;
+    }
+    _statistics.IntegrateMilliseconds += GetMilliseconds(start);
+}
@@ -0,0 +1,159 @@
+#include <EngineCore/Memory.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of every program linking EngineCore to count them.
+// Each allocation carries a small header with its size and tag, so frees are accounted to the
+// subsystem which allocated, whichever thread they happen on.
+
+namespace
+{
+    struct AllocationHeader
+    {
+        size_t Size;
+        MemoryTag Tag;
+    };
+
+    constexpr size_t AllocationHeaderSize = alignof(std::max_align_t);
+    static_assert(sizeof(AllocationHeader) <= AllocationHeaderSize);
+
+    struct MemoryTagCounters
+    {
+        std::atomic<uint64_t> AllocationCount = 0;
+        std::atomic<uint64_t> LiveAllocationCount = 0;
+        std::atomic<uint64_t> LiveByteCount = 0;
+    };
+
+    std::array<MemoryTagCounters, static_cast<size_t>(MemoryTag::Count)> gMemoryTagCounters;
+    thread_local MemoryTag gThreadMemoryTag = MemoryTag::General;
+
+    void* AllocateCounted(size_t size) noexcept
+    {
+        auto memory = static_cast<std::byte*>(std::malloc(AllocationHeaderSize + size));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto tag = gThreadMemoryTag;
+        ::new (static_cast<void*>(memory)) AllocationHeader{ size, tag };
+        auto& counters = gMemoryTagCounters[static_cast<size_t>(tag)];
+        counters.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+        counters.LiveAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        counters.LiveByteCount.fetch_add(size, std::memory_order_relaxed);
+        return memory + AllocationHeaderSize;
+    }
+
+    void FreeCounted(void* memory) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+
+        auto allocation = static_cast<std::byte*>(memory) - AllocationHeaderSize;
+        auto header = reinterpret_cast<AllocationHeader*>(allocation);
+        auto& counters = gMemoryTagCounters[static_cast<size_t>(header->Tag)];
+        counters.LiveAllocationCount.fetch_sub(1, std::memory_order_relaxed);
+        counters.LiveByteCount.fetch_sub(header->Size, std::memory_order_relaxed);
+        std::free(allocation);
+    }
+}
+
+uint64_t GetHeapAllocationCount() noexcept
+{
+    auto allocationCount = uint64_t(0);
+    for (auto& counters : gMemoryTagCounters)
+    {
+        allocationCount += counters.AllocationCount.load(std::memory_order_relaxed);
+    }
+    return allocationCount;
+}
+
+MemoryTag GetThreadMemoryTag() noexcept
+{
+    return gThreadMemoryTag;
+}
+
+MemoryTagStatistics GetMemoryTagStatistics(MemoryTag memoryTag) noexcept
+{
+    auto& counters = gMemoryTagCounters[static_cast<size_t>(memoryTag)];
+    return MemoryTagStatistics
+    {
+        .AllocationCount = counters.AllocationCount.load(std::memory_order_relaxed),
+        .LiveAllocationCount = counters.LiveAllocationCount.load(std::memory_order_relaxed),
+        .LiveByteCount = counters.LiveByteCount.load(std::memory_order_relaxed)
+    };
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag memoryTag) noexcept
+    : _previousMemoryTag(gThreadMemoryTag)
+{
+    gThreadMemoryTag = memoryTag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    gThreadMemoryTag = _previousMemoryTag;
+}
+
+void* operator new(size_t size)
+{
+    if (auto memory = AllocateCounted(size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (auto memory = AllocateCounted(size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocateCounted(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return AllocateCounted(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    FreeCounted(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    FreeCounted(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    FreeCounted(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    FreeCounted(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    FreeCounted(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    FreeCounted(memory);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/common.hpp>
+
+struct Aabb
+{
+    glm::vec3 Min;
+    glm::vec3 Max;
+
+    bool Overlaps(const Aabb& other) const noexcept
+    {
+        return Min.x <= other.Max.x && Max.x >= other.Min.x &&
+               Min.y <= other.Max.y && Max.y >= other.Min.y &&
+               Min.z <= other.Max.z && Max.z >= other.Min.z;
+    }
+
+    bool Contains(const Aabb& other) const noexcept
+    {
+        return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z &&
+               Max.x >= other.Max.x && Max.y >= other.Max.y && Max.z >= other.Max.z;
+    }
+
+    float GetSurfaceArea() const noexcept
+    {
+        auto extent = Max - Min;
+        return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+    }
+
+    glm::vec3 GetCenter() const noexcept
+    {
+        return (Min + Max) * 0.5f;
+    }
+
+    Aabb Expanded(float margin) const noexcept
+    {
+        return Aabb{ .Min = Min - glm::vec3(margin), .Max = Max + glm::vec3(margin) };
+    }
+
+    static Aabb Union(const Aabb& a, const Aabb& b) noexcept
+    {
+        return Aabb{ .Min = glm::min(a.Min, b.Min), .Max = glm::max(a.Max, b.Max) };
+    }
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <EngineCore/Component.hpp>
+#include <EngineCore/Entity.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+constexpr uint32_t ArchetypeChunkSize = 16 * 1024;
+constexpr uint32_t ArchetypeChunkAlignment = MaxComponentAlignment;
+
+// A chunk stores up to Archetype::GetChunkCapacity() entities as SoA:
+// the Entity array first, followed by one tightly packed array per component.
+struct ArchetypeChunk
+{
+    std::byte* Data = nullptr;
+    uint32_t Count = 0;
+};
+
+class Archetype
+{
+public:
+    Archetype(const ComponentMask& componentMask);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const ComponentMask& GetComponentMask() const noexcept
+    {
+        return _componentMask;
+    }
+
+    std::span<const ComponentId> GetComponentIds() const noexcept
+    {
+        return _componentIds;
+    }
+
+    uint32_t GetChunkCapacity() const noexcept
+    {
+        return _chunkCapacity;
+    }
+
+    uint64_t GetEntityCount() const noexcept
+    {
+        return _entityCount;
+    }
+
+    std::span<const ArchetypeChunk> GetChunks() const noexcept
+    {
+        return _chunks;
+    }
+
+    bool HasComponent(ComponentId componentId) const noexcept
+    {
+        return _componentColumns[componentId] >= 0;
+    }
+
+    int32_t GetComponentColumn(ComponentId componentId) const noexcept
+    {
+        return _componentColumns[componentId];
+    }
+
+    Entity* GetEntities(const ArchetypeChunk& chunk) const noexcept
+    {
+        return reinterpret_cast<Entity*>(chunk.Data);
+    }
+
+    uint32_t GetColumnSize(int32_t column) const noexcept
+    {
+        return _columnSizes[column];
+    }
+
+    std::byte* GetColumn(const ArchetypeChunk& chunk, int32_t column) const noexcept
+    {
+        return chunk.Data + _columnOffsets[column];
+    }
+
+    template <typename T>
+    T* GetComponents(const ArchetypeChunk& chunk, int32_t column) const noexcept
+    {
+        return reinterpret_cast<T*>(GetColumn(chunk, column));
+    }
+
+private:
+    friend class World;
+
+    struct Location
+    {
+        uint32_t ChunkIndex;
+        uint32_t Row;
+    };
+
+    Location AllocateRow(Entity entity);
+    // Moves the last row of the archetype into the freed slot to keep chunks dense.
+    // Returns the entity that now occupies the slot, or an invalid entity if nothing moved.
+    Entity FreeRow(Location location);
+
+    std::byte* GetComponentPointer(Location location, int32_t column) const noexcept
+    {
+        return GetColumn(_chunks[location.ChunkIndex], column) + static_cast<size_t>(location.Row) * _columnSizes[column];
+    }
+
+    ComponentMask _componentMask;
+    std::vector<ComponentId> _componentIds;
+    std::vector<uint32_t> _columnOffsets;
+    std::vector<uint32_t> _columnSizes;
+    std::array<int16_t, MaxComponentTypes> _componentColumns;
+
+    std::vector<ArchetypeChunk> _chunks;
+    std::byte* _spareChunk = nullptr;
+    uint32_t _chunkCapacity = 0;
+    uint64_t _entityCount = 0;
+
+    std::unordered_map<ComponentId, Archetype*> _addEdges;
+    std::unordered_map<ComponentId, Archetype*> _removeEdges;
+};
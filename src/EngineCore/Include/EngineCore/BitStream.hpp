@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Packs values with arbitrary bit counts, least significant bit first. Writing past the end of
+// the buffer does not write anything and marks the stream as overflowed instead.
+class BitWriter
+{
+public:
+    explicit BitWriter(std::span<std::byte> buffer) noexcept
+        : _buffer(buffer)
+    {
+    }
+
+    // bitCount from 1 to 32, value must fit
+    void WriteBits(uint32_t value, uint32_t bitCount) noexcept;
+    void WriteBool(bool value) noexcept;
+    void WriteBytes(std::span<const std::byte> bytes) noexcept;
+    // Small values take fewer bits, 6 bits up to 15, 34 bits worst case
+    void WriteVariableUnsigned(uint32_t value) noexcept;
+    void WriteVariableSigned(int32_t value) noexcept;
+
+    // Writes out the last partial byte, call once after everything was written
+    void Flush() noexcept;
+
+    uint32_t GetBitCount() const noexcept
+    {
+        return _bitCount;
+    }
+
+    uint32_t GetByteCount() const noexcept
+    {
+        return (_bitCount + 7) / 8;
+    }
+
+    uint32_t GetRemainingBitCount() const noexcept
+    {
+        return static_cast<uint32_t>(_buffer.size() * 8) - _bitCount;
+    }
+
+    bool IsOverflowed() const noexcept
+    {
+        return _isOverflowed;
+    }
+
+private:
+    std::span<std::byte> _buffer;
+    uint64_t _scratch = 0;
+    uint32_t _scratchBitCount = 0;
+    uint32_t _byteIndex = 0;
+    uint32_t _bitCount = 0;
+    bool _isOverflowed = false;
+};
+
+// Reads what BitWriter wrote. Reading past the end returns zeros and marks the stream as
+// overflowed, callers check IsOverflowed once they are done instead of after every read.
+class BitReader
+{
+public:
+    explicit BitReader(std::span<const std::byte> buffer) noexcept
+        : _buffer(buffer)
+    {
+    }
+
+    uint32_t ReadBits(uint32_t bitCount) noexcept;
+    bool ReadBool() noexcept;
+    void ReadBytes(std::span<std::byte> bytes) noexcept;
+    uint32_t ReadVariableUnsigned() noexcept;
+    int32_t ReadVariableSigned() noexcept;
+
+    uint32_t GetRemainingBitCount() const noexcept
+    {
+        return static_cast<uint32_t>(_buffer.size() * 8) - _bitCount;
+    }
+
+    bool IsOverflowed() const noexcept
+    {
+        return _isOverflowed;
+    }
+
+private:
+    std::span<const std::byte> _buffer;
+    uint64_t _scratch = 0;
+    uint32_t _scratchBitCount = 0;
+    uint32_t _byteIndex = 0;
+    uint32_t _bitCount = 0;
+    bool _isOverflowed = false;
+};
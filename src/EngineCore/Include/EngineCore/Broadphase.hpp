@@ -0,0 +1,112 @@
+#pragma once
+
+#include <EngineCore/Aabb.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class TaskScheduler;
+
+struct BroadphasePair
+{
+    uint32_t UserDataA;
+    uint32_t UserDataB;
+};
+
+// Fixed capacity pair storage, filled concurrently by the broadphase.
+// Pairs beyond the capacity are dropped and HasOverflowed() reports it,
+// so the caller can grow the buffer outside of the hot path.
+class BroadphasePairBuffer
+{
+public:
+    explicit BroadphasePairBuffer(uint32_t capacity);
+
+    void Clear() noexcept
+    {
+        _count.store(0, std::memory_order_relaxed);
+    }
+
+    void Resize(uint32_t capacity);
+
+    uint32_t GetCapacity() const noexcept
+    {
+        return static_cast<uint32_t>(_pairs.size());
+    }
+
+    bool HasOverflowed() const noexcept
+    {
+        return _count.load(std::memory_order_relaxed) > _pairs.size();
+    }
+
+    // Pair order is unspecified when the pairs were found in parallel
+    std::span<const BroadphasePair> GetPairs() const noexcept;
+
+    void Append(std::span<const BroadphasePair> pairs) noexcept;
+
+private:
+    std::vector<BroadphasePair> _pairs;
+    std::atomic<uint32_t> _count = 0;
+};
+
+// Batches pairs on the stack of a worker and appends them to the shared buffer in bulk
+class BroadphasePairWriter
+{
+public:
+    explicit BroadphasePairWriter(BroadphasePairBuffer& pairBuffer) noexcept
+        : _pairBuffer(pairBuffer)
+    {
+    }
+
+    ~BroadphasePairWriter()
+    {
+        Flush();
+    }
+
+    void Add(uint32_t userDataA, uint32_t userDataB) noexcept
+    {
+        _pairs[_count++] = BroadphasePair{ .UserDataA = userDataA, .UserDataB = userDataB };
+        if (_count == BatchSize)
+        {
+            Flush();
+        }
+    }
+
+    void Flush() noexcept
+    {
+        _pairBuffer.Append(std::span(_pairs, _count));
+        _count = 0;
+    }
+
+private:
+    static constexpr uint32_t BatchSize = 128;
+
+    BroadphasePairBuffer& _pairBuffer;
+    BroadphasePair _pairs[BatchSize];
+    uint32_t _count = 0;
+};
+
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void CreateProxies(
+        std::span<const Aabb> aabbs,
+        std::span<const uint32_t> userData,
+        std::span<int32_t> proxyIds,
+        TaskScheduler& taskScheduler) = 0;
+    virtual void DestroyProxies(std::span<const int32_t> proxyIds) = 0;
+    virtual void UpdateProxies(
+        std::span<const int32_t> proxyIds,
+        std::span<const Aabb> aabbs,
+        TaskScheduler& taskScheduler) = 0;
+
+    virtual uint32_t GetProxyCount() const noexcept = 0;
+
+    // Clears pairBuffer and writes every overlapping pair exactly once
+    virtual void FindPairs(
+        BroadphasePairBuffer& pairBuffer,
+        TaskScheduler& taskScheduler) = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+
+constexpr uint32_t MaxComponentTypes = 128;
+// Chunks are aligned to this, columns within them only to their component's alignment
+constexpr uint32_t MaxComponentAlignment = 64;
+
+using ComponentId = uint32_t;
+using ComponentMask = std::bitset<MaxComponentTypes>;
+
+// Components are stored in raw chunk memory and moved around with memcpy
+// whenever an entity changes archetype, so they have to be plain data.
+template <typename T>
+concept IsComponent = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
+struct ComponentInfo
+{
+    uint32_t Size;
+    uint32_t Alignment;
+    std::string_view Name;
+};
+
+ComponentId RegisterComponentType(
+    uint32_t size,
+    uint32_t alignment,
+    std::string_view name);
+
+const ComponentInfo& GetComponentInfo(ComponentId componentId);
+
+template <typename T>
+    requires IsComponent<T>
+ComponentId RegisterComponentType()
+{
+    static_assert(alignof(T) <= MaxComponentAlignment, "Component: alignment exceeds what archetype chunks provide");
+    static const ComponentId componentId = RegisterComponentType(
+        static_cast<uint32_t>(sizeof(T)),
+        static_cast<uint32_t>(alignof(T)),
+        typeid(T).name());
+    return componentId;
+}
+
+// const qualified components (read-only query access) share the id of the underlying type
+template <typename T>
+    requires IsComponent<std::remove_const_t<T>>
+ComponentId GetComponentId()
+{
+    return RegisterComponentType<std::remove_const_t<T>>();
+}
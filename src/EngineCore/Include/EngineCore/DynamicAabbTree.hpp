@@ -0,0 +1,103 @@
+#pragma once
+
+#include <EngineCore/Broadphase.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Bounding volume hierarchy over fattened proxy bounds.
+// Proxies that stay inside their fat bounds cost nothing to update. When only a few escape they are
+// reinserted one by one, when many escape (dense belts moving as a whole) the leaves are refattened
+// and the tree is refit bottom-up in parallel instead, keeping the topology.
+// Traversal uses the fat bounds, reported pairs are filtered against the tight bounds.
+class DynamicAabbTree final : public Broadphase
+{
+public:
+    explicit DynamicAabbTree(
+        float fatMargin = 0.5f,
+        float reinsertFraction = 0.1f);
+
+    void CreateProxies(
+        std::span<const Aabb> aabbs,
+        std::span<const uint32_t> userData,
+        std::span<int32_t> proxyIds,
+        TaskScheduler& taskScheduler) override;
+    void DestroyProxies(std::span<const int32_t> proxyIds) override;
+    void UpdateProxies(
+        std::span<const int32_t> proxyIds,
+        std::span<const Aabb> aabbs,
+        TaskScheduler& taskScheduler) override;
+
+    uint32_t GetProxyCount() const noexcept override
+    {
+        return _proxyCount;
+    }
+
+    void FindPairs(
+        BroadphasePairBuffer& pairBuffer,
+        TaskScheduler& taskScheduler) override;
+
+    // Rebuilds the whole hierarchy top-down from the current leaves,
+    // use it after a long series of refits degraded the tree quality.
+    void Rebuild(TaskScheduler& taskScheduler);
+
+    const Aabb& GetFatAabb(int32_t proxyId) const noexcept
+    {
+        return _nodes[proxyId].Bounds;
+    }
+
+    uint32_t GetHeight() const noexcept;
+
+private:
+    static constexpr int32_t NullNode = -1;
+
+    struct Node
+    {
+        Aabb Bounds;
+        int32_t Parent = NullNode;
+        int32_t Child1 = NullNode;
+        int32_t Child2 = NullNode;
+        // leaf = 0, free node = -1
+        int32_t Height = -1;
+        uint32_t UserData = 0;
+
+        bool IsLeaf() const noexcept
+        {
+            return Child1 == NullNode;
+        }
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t nodeId);
+
+    void InsertLeaf(int32_t leafId);
+    void RemoveLeaf(int32_t leafId);
+    int32_t Balance(int32_t nodeId);
+
+    void GatherLeaves();
+    int32_t BuildRecursive(
+        uint32_t begin,
+        uint32_t end,
+        uint32_t slotOffset,
+        int32_t parentId,
+        uint32_t depth,
+        TaskScheduler& taskScheduler);
+    void RefitRecursive(
+        int32_t nodeId,
+        uint32_t depth,
+        TaskScheduler& taskScheduler);
+
+    std::vector<Node> _nodes;
+    std::vector<Aabb> _tightBounds;
+    std::vector<int32_t> _leaves;
+    std::vector<int32_t> _buildSlots;
+    std::vector<uint8_t> _escaped;
+    int32_t _root = NullNode;
+    int32_t _freeList = NullNode;
+    uint32_t _proxyCount = 0;
+    bool _leavesDirty = true;
+
+    float _fatMargin;
+    float _reinsertFraction;
+};
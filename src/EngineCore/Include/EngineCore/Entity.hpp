@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Generation 0 is never handed out, so a default constructed Entity is always invalid.
+struct Entity
+{
+    uint32_t Index = 0;
+    uint32_t Generation = 0;
+
+    constexpr bool IsValid() const noexcept
+    {
+        return Generation != 0;
+    }
+
+    constexpr bool operator==(const Entity&) const noexcept = default;
+};
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class Format
+{
+    R8_UNORM,
+    R8_SNORM,
+    R16_UNORM,
+    R16_SNORM,
+    R8G8_UNORM,
+    R8G8_SNORM,
+    R16G16_UNORM,
+    R16G16_SNORM,
+    R3G3B2_UNORM,
+    R4G4B4_UNORM,
+    R5G5B5_UNORM,
+    R8G8B8_UNORM,
+    R8G8B8_SNORM,
+    R10G10B10_UNORM,
+    R12G12B12_UNORM,
+    R16G16B16_SNORM,
+    R2G2B2A2_UNORM,
+    R4G4B4A4_UNORM,
+    R5G5B5A1_UNORM,
+    R8G8B8A8_UNORM,
+    R8G8B8A8_SNORM,
+    R10G10B10A2_UNORM,
+    R10G10B10A2_UINT,
+    R12G12B12A12_UNORM,
+    R16G16B16A16_UNORM,
+    R16G16B16A16_SNORM,
+    R8G8B8_SRGB,
+    R8G8B8A8_SRGB,
+    R16_FLOAT,
+    R16G16_FLOAT,
+    R16G16B16_FLOAT,
+    R16G16B16A16_FLOAT,
+    R32_FLOAT,
+    R32G32_FLOAT,
+    R32G32B32_FLOAT,
+    R32G32B32A32_FLOAT,
+    R11G11B10_FLOAT,
+    R9G9B9_E5,
+    R8_SINT,
+    R8_UINT,
+    R16_SINT,
+    R16_UINT,
+    R32_SINT,
+    R32_UINT,
+    R8G8_SINT,
+    R8G8_UINT,
+    R16G16_SINT,
+    R16G16_UINT,
+    R32G32_SINT,
+    R32G32_UINT,
+    R8G8B8_SINT,
+    R8G8B8_UINT,
+    R16G16B16_SINT,
+    R16G16B16_UINT,
+    R32G32B32_SINT,
+    R32G32B32_UINT,
+    R8G8B8A8_SINT,
+    R8G8B8A8_UINT,
+    R16G16B16A16_SINT,
+    R16G16B16A16_UINT,
+    R32G32B32A32_SINT,
+    R32G32B32A32_UINT,
+
+    // Depth & stencil formats
+    D32_FLOAT,
+    D32_UNORM,
+    D24_UNORM,
+    D16_UNORM,
+    D32_FLOAT_S8_UINT,
+    D24_UNORM_S8_UINT,
+
+    // Compressed formats
+    // DXT
+    BC1_RGB_UNORM,
+    BC1_RGB_SRGB,
+    BC1_RGBA_UNORM,
+    BC1_RGBA_SRGB,
+    BC2_RGBA_UNORM,
+    BC2_RGBA_SRGB,
+    BC3_RGBA_UNORM,
+    BC3_RGBA_SRGB,
+    // RGTC
+    BC4_R_UNORM,
+    BC4_R_SNORM,
+    BC5_RG_UNORM,
+    BC5_RG_SNORM,
+    // BPTC
+    BC6H_RGB_UFLOAT,
+    BC6H_RGB_SFLOAT,
+    BC7_RGBA_UNORM,
+    BC7_RGBA_SRGB,
+};
+
+constexpr size_t FormatCount = static_cast<size_t>(Format::BC7_RGBA_SRGB) + 1;
+
+// What a component reads as in a shader
+enum class FormatNumericType : uint8_t
+{
+    Unorm,
+    Snorm,
+    Uint,
+    Sint,
+    Float,
+    // Floats without a sign bit, R11G11B10, shared exponent and BC6H
+    UFloat,
+    // Unorm stored sRGB encoded, read back linear
+    Srgb
+};
+
+enum class FormatLayout : uint8_t
+{
+    // Each component its own byte, short or int
+    Components,
+    // Components share bits within one element
+    Packed,
+    Depth,
+    DepthStencil,
+    // Compressed 4x4 texel blocks
+    Block4x4
+};
+
+struct FormatTraits
+{
+    Format Value;
+    // Per texel, per 4x4 block for compressed formats
+    uint8_t BytesPerBlock;
+    uint8_t ComponentCount;
+    FormatNumericType NumericType;
+    FormatLayout Layout = FormatLayout::Components;
+
+    constexpr uint32_t GetBlockSize() const noexcept
+    {
+        return Layout == FormatLayout::Block4x4 ? 4 : 1;
+    }
+
+    constexpr bool IsCompressed() const noexcept
+    {
+        return Layout == FormatLayout::Block4x4;
+    }
+
+    constexpr bool IsDepth() const noexcept
+    {
+        return Layout == FormatLayout::Depth || Layout == FormatLayout::DepthStencil;
+    }
+
+    constexpr bool HasStencil() const noexcept
+    {
+        return Layout == FormatLayout::DepthStencil;
+    }
+
+    constexpr bool IsNormalized() const noexcept
+    {
+        return NumericType == FormatNumericType::Unorm || NumericType == FormatNumericType::Snorm || NumericType == FormatNumericType::Srgb;
+    }
+
+    constexpr bool IsInteger() const noexcept
+    {
+        return NumericType == FormatNumericType::Uint || NumericType == FormatNumericType::Sint;
+    }
+
+    // One mip level, partial blocks at the edges count whole
+    constexpr uint64_t GetByteCount(uint32_t width, uint32_t height) const noexcept
+    {
+        auto blockSize = GetBlockSize();
+        return static_cast<uint64_t>((width + blockSize - 1) / blockSize) * ((height + blockSize - 1) / blockSize) * BytesPerBlock;
+    }
+};
+
+// In the order of Format. Formats GL keeps fewer bits of than it stores, like RGB12 or D24, count what they are stored in
+inline constexpr std::array<FormatTraits, FormatCount> FormatTraitsTable =
+{{
+    { Format::R8_UNORM, 1, 1, FormatNumericType::Unorm },
+    { Format::R8_SNORM, 1, 1, FormatNumericType::Snorm },
+    { Format::R16_UNORM, 2, 1, FormatNumericType::Unorm },
+    { Format::R16_SNORM, 2, 1, FormatNumericType::Snorm },
+    { Format::R8G8_UNORM, 2, 2, FormatNumericType::Unorm },
+    { Format::R8G8_SNORM, 2, 2, FormatNumericType::Snorm },
+    { Format::R16G16_UNORM, 4, 2, FormatNumericType::Unorm },
+    { Format::R16G16_SNORM, 4, 2, FormatNumericType::Snorm },
+    { Format::R3G3B2_UNORM, 1, 3, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R4G4B4_UNORM, 2, 3, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R5G5B5_UNORM, 2, 3, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R8G8B8_UNORM, 3, 3, FormatNumericType::Unorm },
+    { Format::R8G8B8_SNORM, 3, 3, FormatNumericType::Snorm },
+    { Format::R10G10B10_UNORM, 4, 3, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R12G12B12_UNORM, 6, 3, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R16G16B16_SNORM, 6, 3, FormatNumericType::Snorm },
+    { Format::R2G2B2A2_UNORM, 1, 4, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R4G4B4A4_UNORM, 2, 4, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R5G5B5A1_UNORM, 2, 4, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R8G8B8A8_UNORM, 4, 4, FormatNumericType::Unorm },
+    { Format::R8G8B8A8_SNORM, 4, 4, FormatNumericType::Snorm },
+    { Format::R10G10B10A2_UNORM, 4, 4, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R10G10B10A2_UINT, 4, 4, FormatNumericType::Uint, FormatLayout::Packed },
+    { Format::R12G12B12A12_UNORM, 8, 4, FormatNumericType::Unorm, FormatLayout::Packed },
+    { Format::R16G16B16A16_UNORM, 8, 4, FormatNumericType::Unorm },
+    { Format::R16G16B16A16_SNORM, 8, 4, FormatNumericType::Snorm },
+    { Format::R8G8B8_SRGB, 3, 3, FormatNumericType::Srgb },
+    { Format::R8G8B8A8_SRGB, 4, 4, FormatNumericType::Srgb },
+    { Format::R16_FLOAT, 2, 1, FormatNumericType::Float },
+    { Format::R16G16_FLOAT, 4, 2, FormatNumericType::Float },
+    { Format::R16G16B16_FLOAT, 6, 3, FormatNumericType::Float },
+    { Format::R16G16B16A16_FLOAT, 8, 4, FormatNumericType::Float },
+    { Format::R32_FLOAT, 4, 1, FormatNumericType::Float },
+    { Format::R32G32_FLOAT, 8, 2, FormatNumericType::Float },
+    { Format::R32G32B32_FLOAT, 12, 3, FormatNumericType::Float },
+    { Format::R32G32B32A32_FLOAT, 16, 4, FormatNumericType::Float },
+    { Format::R11G11B10_FLOAT, 4, 3, FormatNumericType::UFloat, FormatLayout::Packed },
+    { Format::R9G9B9_E5, 4, 3, FormatNumericType::UFloat, FormatLayout::Packed },
+    { Format::R8_SINT, 1, 1, FormatNumericType::Sint },
+    { Format::R8_UINT, 1, 1, FormatNumericType::Uint },
+    { Format::R16_SINT, 2, 1, FormatNumericType::Sint },
+    { Format::R16_UINT, 2, 1, FormatNumericType::Uint },
+    { Format::R32_SINT, 4, 1, FormatNumericType::Sint },
+    { Format::R32_UINT, 4, 1, FormatNumericType::Uint },
+    { Format::R8G8_SINT, 2, 2, FormatNumericType::Sint },
+    { Format::R8G8_UINT, 2, 2, FormatNumericType::Uint },
+    { Format::R16G16_SINT, 4, 2, FormatNumericType::Sint },
+    { Format::R16G16_UINT, 4, 2, FormatNumericType::Uint },
+    { Format::R32G32_SINT, 8, 2, FormatNumericType::Sint },
+    { Format::R32G32_UINT, 8, 2, FormatNumericType::Uint },
+    { Format::R8G8B8_SINT, 3, 3, FormatNumericType::Sint },
+    { Format::R8G8B8_UINT, 3, 3, FormatNumericType::Uint },
+    { Format::R16G16B16_SINT, 6, 3, FormatNumericType::Sint },
+    { Format::R16G16B16_UINT, 6, 3, FormatNumericType::Uint },
+    { Format::R32G32B32_SINT, 12, 3, FormatNumericType::Sint },
+    { Format::R32G32B32_UINT, 12, 3, FormatNumericType::Uint },
+    { Format::R8G8B8A8_SINT, 4, 4, FormatNumericType::Sint },
+    { Format::R8G8B8A8_UINT, 4, 4, FormatNumericType::Uint },
+    { Format::R16G16B16A16_SINT, 8, 4, FormatNumericType::Sint },
+    { Format::R16G16B16A16_UINT, 8, 4, FormatNumericType::Uint },
+    { Format::R32G32B32A32_SINT, 16, 4, FormatNumericType::Sint },
+    { Format::R32G32B32A32_UINT, 16, 4, FormatNumericType::Uint },
+
+    { Format::D32_FLOAT, 4, 1, FormatNumericType::Float, FormatLayout::Depth },
+    { Format::D32_UNORM, 4, 1, FormatNumericType::Unorm, FormatLayout::Depth },
+    { Format::D24_UNORM, 4, 1, FormatNumericType::Unorm, FormatLayout::Depth },
+    { Format::D16_UNORM, 2, 1, FormatNumericType::Unorm, FormatLayout::Depth },
+    { Format::D32_FLOAT_S8_UINT, 8, 2, FormatNumericType::Float, FormatLayout::DepthStencil },
+    { Format::D24_UNORM_S8_UINT, 4, 2, FormatNumericType::Unorm, FormatLayout::DepthStencil },
+
+    { Format::BC1_RGB_UNORM, 8, 3, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC1_RGB_SRGB, 8, 3, FormatNumericType::Srgb, FormatLayout::Block4x4 },
+    { Format::BC1_RGBA_UNORM, 8, 4, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC1_RGBA_SRGB, 8, 4, FormatNumericType::Srgb, FormatLayout::Block4x4 },
+    { Format::BC2_RGBA_UNORM, 16, 4, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC2_RGBA_SRGB, 16, 4, FormatNumericType::Srgb, FormatLayout::Block4x4 },
+    { Format::BC3_RGBA_UNORM, 16, 4, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC3_RGBA_SRGB, 16, 4, FormatNumericType::Srgb, FormatLayout::Block4x4 },
+    { Format::BC4_R_UNORM, 8, 1, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC4_R_SNORM, 8, 1, FormatNumericType::Snorm, FormatLayout::Block4x4 },
+    { Format::BC5_RG_UNORM, 16, 2, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC5_RG_SNORM, 16, 2, FormatNumericType::Snorm, FormatLayout::Block4x4 },
+    { Format::BC6H_RGB_UFLOAT, 16, 3, FormatNumericType::UFloat, FormatLayout::Block4x4 },
+    { Format::BC6H_RGB_SFLOAT, 16, 3, FormatNumericType::Float, FormatLayout::Block4x4 },
+    { Format::BC7_RGBA_UNORM, 16, 4, FormatNumericType::Unorm, FormatLayout::Block4x4 },
+    { Format::BC7_RGBA_SRGB, 16, 4, FormatNumericType::Srgb, FormatLayout::Block4x4 },
+}};
+
+constexpr bool IsFormatTraitsTableOrdered() noexcept
+{
+    for (auto i = 0u; i < FormatCount; i++)
+    {
+        if (static_cast<size_t>(FormatTraitsTable[i].Value) != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(IsFormatTraitsTableOrdered(), "FormatTraitsTable has to list the formats in the order of Format");
+
+constexpr const FormatTraits& GetFormatTraits(Format format) noexcept
+{
+    return FormatTraitsTable[static_cast<size_t>(format)];
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <EngineCore/Format.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Bulk conversions for cookers and uploads. Each call picks its SSE2, F16C or NEON code once for the
+// whole span and finishes the tail with the scalar code, which gives the same bits, so results do not
+// depend on the CPU beyond NaN payloads. Destinations have to hold as many elements as the source has.
+
+// Rounds to nearest even, too large values become infinity and NaNs a quiet NaN
+void ConvertFloatToHalf(std::span<const float> source, std::span<uint16_t> destination) noexcept;
+void ConvertHalfToFloat(std::span<const uint16_t> source, std::span<float> destination) noexcept;
+// Clamped to [-1, 1]
+void ConvertFloatToSnorm16(std::span<const float> source, std::span<int16_t> destination) noexcept;
+
+// Whole pixels, RGBA8 with red in the lowest byte and RGB10A2 laid out as GL_UNSIGNED_INT_2_10_10_10_REV
+void ConvertRgba8ToRgb10A2(std::span<const uint32_t> source, std::span<uint32_t> destination) noexcept;
+void ConvertRgb10A2ToRgba8(std::span<const uint32_t> source, std::span<uint32_t> destination) noexcept;
+
+// Single channels, alpha is linear and stays out of these
+void ConvertSrgbToLinear(std::span<const uint8_t> source, std::span<float> destination) noexcept;
+// Within 0.05 of a code of the exact curve before rounding, clamped to [0, 1]
+void ConvertLinearToSrgb(std::span<const float> source, std::span<uint8_t> destination) noexcept;
+
+// Unit normals to OctahedralEncode's mapping as snorm16x2, x in the low half. unpackSnorm2x16 reads them back
+void EncodeOctahedralNormals(std::span<const glm::vec3> normals, std::span<uint32_t> destination) noexcept;
+
+// Converts elementCount texels or vertex attributes between tightly packed arrays
+using FormatConversionFunction = void (*)(const void* source, void* destination, size_t elementCount);
+
+// Float to half, snorm16 and sRGB, half and sRGB to float and RGBA8 to and from RGB10A2, for
+// formats with matching component counts. Null for pairs without a conversion
+FormatConversionFunction GetFormatConversionFunction(Format sourceFormat, Format destinationFormat) noexcept;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template <typename TSignature>
+class FunctionRef;
+
+// Non owning reference to a callable, which has to outlive it. Unlike std::function it never
+// allocates, whatever the callable captures.
+template <typename TResult, typename... TArguments>
+class FunctionRef<TResult(TArguments...)>
+{
+public:
+    template <typename TCallable>
+        requires (!std::is_same_v<std::remove_cvref_t<TCallable>, FunctionRef> &&
+                  std::is_invocable_r_v<TResult, TCallable&, TArguments...>)
+    FunctionRef(TCallable&& callable) noexcept
+        : _callable(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+          _invoke([](void* callable, TArguments... arguments) -> TResult
+          {
+              return (*static_cast<std::add_pointer_t<TCallable>>(callable))(std::forward<TArguments>(arguments)...);
+          })
+    {
+    }
+
+    TResult operator()(TArguments... arguments) const
+    {
+        return _invoke(_callable, std::forward<TArguments>(arguments)...);
+    }
+
+private:
+    void* _callable;
+    TResult (*_invoke)(void*, TArguments...);
+};
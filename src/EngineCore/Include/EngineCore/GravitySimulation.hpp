@@ -0,0 +1,211 @@
+#pragma once
+
+#include <EngineCore/TransformKernels.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class TaskScheduler;
+
+struct GravitySimulationSettings
+{
+    double GravitationalConstant = 1.0;
+    // Plummer softening length, keeps close encounters from blowing up the step. Zero is exact Newton
+    double Softening = 1.0e-3;
+    // Barnes-Hut opening angle below 1, zero sums every pair directly
+    double OpeningAngle = 0.6;
+    // Bodies per octree leaf at most, each leaf walks the tree once for all its bodies
+    uint32_t LeafSize = 32;
+};
+
+// Point mass outside the simulation pulling on every body, such as a planet on rails
+struct GravityAttractor
+{
+    glm::dvec3 Position;
+    double Mass;
+};
+
+struct GravityStepStatistics
+{
+    double TreeMilliseconds = 0.0;
+    double ForceMilliseconds = 0.0;
+    double IntegrateMilliseconds = 0.0;
+    uint32_t NodeCount = 0;
+    uint32_t LeafCount = 0;
+    uint64_t InteractionCount = 0;
+};
+
+// N-body gravity for the bodies that need it, planets, moons, asteroid swarms and debris. Bodies are
+// SoA, one array per scalar, and kept sorted by Morton code so every octree node covers a contiguous
+// range of them. Every step sorts them again, rebuilds the Barnes-Hut octree in parallel and integrates
+// kick, drift, kick, which is symplectic, so energy oscillates instead of drifting away. Results only
+// depend on the bodies and the kernel level, not on the thread count.
+class GravitySimulation
+{
+public:
+    explicit GravitySimulation(const GravitySimulationSettings& settings = {});
+
+    // Returns an id that stays with the body, indices change with every step
+    uint32_t Add(const glm::dvec3& position, const glm::dvec3& velocity, double mass);
+    void Remove(uint32_t id);
+    void Clear();
+    void Reserve(uint32_t capacity);
+
+    uint32_t GetCount() const noexcept
+    {
+        return static_cast<uint32_t>(_positionX.size());
+    }
+
+    uint32_t GetIndex(uint32_t id) const noexcept
+    {
+        return _indexById[id];
+    }
+
+    glm::dvec3 GetPosition(uint32_t id) const noexcept;
+    glm::dvec3 GetVelocity(uint32_t id) const noexcept;
+    double GetMass(uint32_t id) const noexcept;
+    void SetVelocity(uint32_t id, const glm::dvec3& velocity) noexcept;
+
+    // By index, for whoever draws or replicates all bodies at once
+    std::span<const double> GetPositionX() const noexcept
+    {
+        return _positionX;
+    }
+
+    std::span<const double> GetPositionY() const noexcept
+    {
+        return _positionY;
+    }
+
+    std::span<const double> GetPositionZ() const noexcept
+    {
+        return _positionZ;
+    }
+
+    std::span<const uint32_t> GetIds() const noexcept
+    {
+        return _ids;
+    }
+
+    void SetKernelLevel(TransformKernelLevel kernelLevel);
+
+    TransformKernelLevel GetKernelLevel() const noexcept
+    {
+        return _kernelLevel;
+    }
+
+    // Attractors are where they are at the end of the step, the step that follows adding a body
+    // evaluates them at its start as well
+    void Step(double deltaTime, TaskScheduler& taskScheduler, std::span<const GravityAttractor> attractors = {});
+
+    // Kinetic plus potential energy, the potential through the same tree as the forces. Attractors
+    // move, so they are left out
+    double ComputeEnergy(TaskScheduler& taskScheduler);
+
+    const GravityStepStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+private:
+    // Adds the pull of the sources to every target, G left out
+    using AccumulateGravityFunction = void (*)(
+        const double* sourceX,
+        const double* sourceY,
+        const double* sourceZ,
+        const double* sourceMass,
+        uint32_t sourceCount,
+        const double* targetX,
+        const double* targetY,
+        const double* targetZ,
+        uint32_t targetCount,
+        double softeningSquared,
+        double* accelerationX,
+        double* accelerationY,
+        double* accelerationZ,
+        double* potential);
+
+    struct Node
+    {
+        double CenterOfMassX;
+        double CenterOfMassY;
+        double CenterOfMassZ;
+        double Mass;
+        // Every body of the node lies within this of its center of mass
+        double Radius;
+        uint32_t FirstChild;
+        // Zero for leaves
+        uint32_t ChildCount;
+        uint32_t FirstBody;
+        uint32_t BodyCount;
+    };
+
+    struct BodyRange
+    {
+        uint32_t Node;
+        uint32_t First;
+        uint32_t Last;
+    };
+
+    void BuildTree(TaskScheduler& taskScheduler);
+    void ComputeMortonCodes(TaskScheduler& taskScheduler);
+    void SortBodies(TaskScheduler& taskScheduler);
+    bool IsLeaf(uint32_t first, uint32_t last) const noexcept;
+    // Splits the bodies by the first octant they differ in, returns how many children that made
+    uint32_t SplitNode(uint32_t nodeIndex, uint32_t first, uint32_t last, std::span<BodyRange, 8> children);
+    void SplitTopNode(uint32_t nodeIndex, uint32_t first, uint32_t last);
+    void BuildSubtree(uint32_t nodeIndex, uint32_t first, uint32_t last);
+    void BuildLeaf(uint32_t nodeIndex, uint32_t first, uint32_t last);
+    void MergeChildren(uint32_t nodeIndex);
+    // Writes either the accelerations or, for ComputeEnergy, only the potentials
+    void ComputeAccelerations(TaskScheduler& taskScheduler, std::span<const GravityAttractor> attractors, bool writePotential);
+    void ComputeLeafAccelerations(uint32_t leafNode, std::span<const GravityAttractor> attractors, bool writePotential);
+    void KickDrift(TaskScheduler& taskScheduler, double kickTime, double driftTime);
+
+    GravitySimulationSettings _settings;
+    TransformKernelLevel _kernelLevel;
+    AccumulateGravityFunction _accumulateGravity;
+
+    std::vector<double> _positionX;
+    std::vector<double> _positionY;
+    std::vector<double> _positionZ;
+    std::vector<double> _velocityX;
+    std::vector<double> _velocityY;
+    std::vector<double> _velocityZ;
+    std::vector<double> _accelerationX;
+    std::vector<double> _accelerationY;
+    std::vector<double> _accelerationZ;
+    // Per body potential, only written by ComputeEnergy
+    std::vector<double> _potential;
+    std::vector<double> _mass;
+    std::vector<uint32_t> _ids;
+    std::vector<uint32_t> _indexById;
+    std::vector<uint32_t> _freeIds;
+    bool _hasAccelerations = false;
+    bool _isTreeCurrent = false;
+
+    // Sorting, the scratch arrays swap with the body arrays they are gathered into
+    std::vector<uint64_t> _mortonCodes;
+    std::vector<uint64_t> _mortonCodesScratch;
+    std::vector<uint32_t> _order;
+    std::vector<uint32_t> _orderScratch;
+    std::vector<uint32_t> _radixHistograms;
+    std::vector<double> _chunkValues;
+    std::vector<double> _bodyScratch;
+    std::vector<uint32_t> _idScratch;
+
+    // Octree, the children of a node are adjacent and the bodies of a node contiguous
+    std::vector<Node> _nodes;
+    std::atomic<uint32_t> _nodeCount = 0;
+    std::vector<uint32_t> _leaves;
+    std::atomic<uint32_t> _leafCount = 0;
+    std::vector<BodyRange> _subtrees;
+    std::vector<uint32_t> _topNodes;
+
+    std::atomic<uint64_t> _interactionCount = 0;
+    GravityStepStatistics _statistics;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Io
+{
+    std::expected<std::string, std::string> ReadTextFromFile(std::string_view filePath);
+    // The text lives in memoryResource, for transient reads into an arena
+    std::expected<std::pmr::string, std::string> ReadTextFromFile(std::string_view filePath, std::pmr::memory_resource* memoryResource);
+
+    // Read only memory mapping of a whole file, the view stays valid until the mapping is destroyed
+    class MappedFile
+    {
+    public:
+        static std::expected<MappedFile, std::string> Open(std::string_view filePath);
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        std::span<const std::byte> GetData() const noexcept
+        {
+            return { _data, _size };
+        }
+
+    private:
+        void Swap(MappedFile& other) noexcept;
+
+        const std::byte* _data = nullptr;
+        size_t _size = 0;
+#ifdef _WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Routes spdlog's default logger, and with it every spdlog::info/warn/error in the engine, through a
+// background thread for as long as this lives. Callers only copy the message into a ring buffer, a
+// full buffer overwrites its oldest message instead of blocking the frame or the tick.
+// Create one at the top of main, it flushes whatever is still queued when destroyed.
+class AsyncLogging
+{
+public:
+    static constexpr size_t DefaultQueueCapacity = 8192;
+
+    explicit AsyncLogging(size_t queueCapacity = DefaultQueueCapacity);
+    ~AsyncLogging();
+
+    AsyncLogging(const AsyncLogging&) = delete;
+    AsyncLogging& operator=(const AsyncLogging&) = delete;
+
+    // Messages overwritten because the buffer was full
+    static uint64_t GetDroppedMessageCount() noexcept;
+};
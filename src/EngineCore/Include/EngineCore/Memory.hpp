@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Bump allocator over one block. Deallocation is a no-op, memory comes back all at once through
+// Reset or Rewind. Allocations that do not fit go to the upstream resource, and the next Reset
+// grows the block to the peak so a steady workload stops touching the upstream entirely.
+class LinearArena final : public std::pmr::memory_resource
+{
+public:
+    explicit LinearArena(size_t capacity, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~LinearArena() override;
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // Where the block and the overflow list ended, overflow blocks are only ever appended
+    struct Marker
+    {
+        size_t Offset = 0;
+        size_t OverflowCount = 0;
+    };
+
+    void Reset() noexcept;
+
+    Marker GetMarker() const noexcept
+    {
+        return Marker{ _offset, _overflows.size() };
+    }
+
+    // Frees everything allocated since marker, overflow included. Rewinding to an empty arena is a
+    // Reset, so only the outermost scope can grow the block.
+    void Rewind(Marker marker) noexcept;
+
+    size_t GetCapacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    // Bytes in use at most since the last Reset, overflow included
+    size_t GetPeakByteCount() const noexcept
+    {
+        return _peakByteCount;
+    }
+
+private:
+    struct Overflow
+    {
+        void* Memory;
+        size_t Size;
+        size_t Alignment;
+    };
+
+    void* do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void* memory, size_t size, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::pmr::memory_resource* _upstream;
+    std::byte* _block = nullptr;
+    size_t _capacity = 0;
+    size_t _offset = 0;
+    size_t _overflowByteCount = 0;
+    size_t _peakByteCount = 0;
+    std::vector<Overflow> _overflows;
+};
+
+// Rewinds the arena to where it was on construction, scopes nest like the stack
+class ArenaScope
+{
+public:
+    explicit ArenaScope(LinearArena& arena) noexcept
+        : _arena(arena),
+          _marker(arena.GetMarker())
+    {
+    }
+
+    ~ArenaScope()
+    {
+        _arena.Rewind(_marker);
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    LinearArena& _arena;
+    LinearArena::Marker _marker;
+};
+
+// Scratch memory of the calling thread, only to be used under an ArenaScope. Created on first use.
+LinearArena& GetThreadArena();
+
+// Process wide calls to the global operator new so far, aligned new is not counted
+uint64_t GetHeapAllocationCount() noexcept;
+
+// Subsystems heap allocations are accounted to
+enum class MemoryTag : uint8_t
+{
+    General,
+    Rendering,
+    Streaming,
+    Network,
+    Simulation,
+    Debug,
+    Count
+};
+
+std::string_view GetMemoryTagName(MemoryTag memoryTag) noexcept;
+
+// Accounts the calling thread's heap allocations to memoryTag until the scope ends, scopes nest
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(MemoryTag memoryTag) noexcept;
+    ~MemoryTagScope();
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag _previousMemoryTag;
+};
+
+struct MemoryTagStatistics
+{
+    uint64_t AllocationCount = 0;
+    uint64_t LiveAllocationCount = 0;
+    uint64_t LiveByteCount = 0;
+};
+
+MemoryTag GetThreadMemoryTag() noexcept;
+MemoryTagStatistics GetMemoryTagStatistics(MemoryTag memoryTag) noexcept;
+
+// Fixed size slots in blocks with an intrusive free list, for engine objects created and destroyed
+// often enough that going through the general heap each time shows. Not thread safe.
+template <typename T, size_t SlotsPerBlock = 64>
+class ObjectPool
+{
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... TArguments>
+    T* Create(TArguments&&... arguments)
+    {
+        if (_freeSlots == nullptr)
+        {
+            AddBlock();
+        }
+
+        auto slot = _freeSlots;
+        _freeSlots = slot->Next;
+        auto object = ::new (static_cast<void*>(slot->Storage)) T(std::forward<TArguments>(arguments)...);
+        _liveCount++;
+        return object;
+    }
+
+    void Destroy(T* object) noexcept
+    {
+        if (object == nullptr)
+        {
+            return;
+        }
+
+        object->~T();
+        auto slot = reinterpret_cast<Slot*>(object);
+        slot->Next = _freeSlots;
+        _freeSlots = slot;
+        _liveCount--;
+    }
+
+    size_t GetLiveCount() const noexcept
+    {
+        return _liveCount;
+    }
+
+private:
+    union Slot
+    {
+        Slot* Next;
+        alignas(T) std::byte Storage[sizeof(T)];
+    };
+
+    void AddBlock()
+    {
+        auto& block = _blocks.emplace_back(std::make_unique<Slot[]>(SlotsPerBlock));
+        for (auto i = SlotsPerBlock; i > 0; i--)
+        {
+            block[i - 1].Next = _freeSlots;
+            _freeSlots = &block[i - 1];
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> _blocks;
+    Slot* _freeSlots = nullptr;
+    size_t _liveCount = 0;
+};
+
+template <typename T>
+struct PoolDeleter
+{
+    ObjectPool<T>* Pool = nullptr;
+
+    void operator()(T* object) const noexcept
+    {
+        Pool->Destroy(object);
+    }
+};
+
+template <typename T>
+using PoolPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+template <typename T, typename... TArguments>
+PoolPtr<T> MakePooled(ObjectPool<T>& pool, TArguments&&... arguments)
+{
+    return PoolPtr<T>(pool.Create(std::forward<TArguments>(arguments)...), PoolDeleter<T>{ &pool });
+}
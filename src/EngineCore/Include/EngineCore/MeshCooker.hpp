@@ -0,0 +1,62 @@
+#pragma once
+
+#include <EngineCore/OctahedralImpostor.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+class TaskScheduler;
+
+constexpr uint32_t MaxMeshLodLevelCount = 8;
+
+struct MeshLodLevel
+{
+    uint32_t IndexOffset;
+    uint32_t IndexCount;
+    // Object space distance this level may deviate from level 0, monotonic along the chain
+    float GeometricError;
+
+    uint32_t GetTriangleCount() const noexcept
+    {
+        return IndexCount / 3;
+    }
+};
+
+struct MeshCookSettings
+{
+    uint32_t MaxLodLevelCount = 6;
+    // Each level targets this fraction of the previous level's triangles
+    float LodTriangleRatio = 0.5f;
+    uint32_t MinLodTriangleCount = 32;
+    // Collapses beyond this error, relative to the bounding radius, are never taken
+    float MaxRelativeError = 0.25f;
+    bool BakeImpostor = true;
+    OctahedralImpostorBakeSettings Impostor;
+};
+
+// All LOD levels index the same vertices, level 0 is the source mesh.
+struct CookedMesh
+{
+    std::vector<uint32_t> Indices;
+    std::vector<MeshLodLevel> LodLevels;
+    glm::vec3 BoundingSphereCenter = {};
+    float BoundingSphereRadius = 0.0f;
+    OctahedralImpostorAtlas Impostor;
+
+    // Stays true after the texels were uploaded and released
+    bool HasImpostor() const noexcept
+    {
+        return Impostor.FramesPerSide > 0;
+    }
+};
+
+std::expected<CookedMesh, std::string> CookMesh(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    const MeshCookSettings& settings,
+    TaskScheduler* taskScheduler = nullptr);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <EngineCore/MeshCooker.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+class TransformStore;
+
+// Selected level for objects drawn as octahedral impostor billboards
+constexpr uint8_t MeshLodImpostor = 0xFF;
+
+struct MeshLodSelectionSettings
+{
+    // Largest geometric error in pixels a level may show on screen
+    float MaxPixelError = 1.0f;
+    // Objects whose bounding sphere projects to a smaller radius in pixels become impostors, 0 disables impostors
+    float ImpostorPixelRadius = 24.0f;
+    // Fraction both thresholds are widened by against the current choice, so objects near a boundary do not pop back and forth
+    float Hysteresis = 0.2f;
+};
+
+struct MeshLodStatistics
+{
+    std::array<uint32_t, MaxMeshLodLevelCount> LevelInstanceCounts = {};
+    uint32_t ImpostorCount = 0;
+    uint64_t FullDetailTriangleCount = 0;
+    uint64_t RenderedTriangleCount = 0;
+
+    uint64_t GetSavedTriangleCount() const noexcept
+    {
+        return FullDetailTriangleCount - RenderedTriangleCount;
+    }
+};
+
+// Picks per object the coarsest level whose projected geometric error stays below MaxPixelError
+class MeshLodSelector
+{
+public:
+    void SetSettings(const MeshLodSelectionSettings& settings) noexcept
+    {
+        _settings = settings;
+    }
+
+    const MeshLodSelectionSettings& GetSettings() const noexcept
+    {
+        return _settings;
+    }
+
+    // verticalFieldOfView in radians, call again whenever the projection or the framebuffer changes
+    void SetProjection(float verticalFieldOfView, uint32_t viewportHeight) noexcept;
+
+    // lods holds every transform's level from the previous call, which the hysteresis is applied
+    // against, and receives the new levels. New objects can start at any level.
+    MeshLodStatistics Select(
+        const CookedMesh& mesh,
+        const TransformStore& transforms,
+        const glm::vec3& cameraPosition,
+        std::span<uint8_t> lods) const;
+
+private:
+    MeshLodSelectionSettings _settings;
+    // Pixels covered by one unit at distance one
+    float _projectionScale = 1.0f;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct MeshSimplifierResult
+{
+    std::vector<uint32_t> Indices;
+    // Largest quadric error of any collapse taken, roughly the distance in mesh units
+    // the simplified surface moved away from the original
+    float GeometricError = 0.0f;
+};
+
+// Quadric error metric edge collapse simplification (Garland and Heckbert).
+// Collapses always move a vertex onto one of its neighbours, so the result indexes
+// into the original vertices and every level of a LOD chain can share one vertex buffer.
+// Stops at targetIndexCount, or earlier once the next collapse would exceed maxError.
+MeshSimplifierResult SimplifyMesh(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    uint32_t targetIndexCount,
+    float maxError);
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <EngineCore/NetConnection.hpp>
+#include <EngineCore/Snapshot.hpp>
+#include <EngineCore/UdpSocket.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+
+// Snapshots both sides keep around as delta baselines. The server only encodes against
+// snapshots the client acked, which are always younger than this.
+constexpr uint32_t SnapshotHistorySize = 16;
+
+// First reliable message the server sends to every client it accepts
+struct NetServerInfo
+{
+    uint32_t ClientId = 0;
+    uint32_t TickRate = 0;
+};
+
+void WriteNetServerInfo(BitWriter& writer, const NetServerInfo& serverInfo) noexcept;
+NetServerInfo ReadNetServerInfo(BitReader& reader) noexcept;
+
+// Where the client looks from, the server replicates what is around it. Sent with every data
+// packet, quantized like snapshot positions.
+struct NetClientFocus
+{
+    glm::vec3 Position = glm::vec3(0.0f);
+    // The entity the client controls, UINT32_MAX for none
+    uint32_t EntityId = UINT32_MAX;
+};
+
+void WriteNetClientFocus(BitWriter& writer, const NetClientFocus& focus) noexcept;
+NetClientFocus ReadNetClientFocus(BitReader& reader) noexcept;
+
+enum class NetClientState
+{
+    Disconnected,
+    Connecting,
+    Connected
+};
+
+struct NetClientStatistics
+{
+    uint64_t SentByteCount = 0;
+    uint64_t ReceivedByteCount = 0;
+    uint64_t ReceivedSnapshotCount = 0;
+    // Snapshots whose baseline was already gone, or which arrived out of order
+    uint64_t DroppedSnapshotCount = 0;
+};
+
+class NetClient
+{
+public:
+    static std::expected<NetClient, std::string> Create();
+
+    void Connect(const NetAddress& serverAddress, double time);
+    void Disconnect();
+
+    void SetFocus(const NetClientFocus& focus) noexcept
+    {
+        _focus = focus;
+    }
+
+    // Receives everything waiting, decodes snapshots and answers with acks, call once per frame
+    void Update(double time);
+
+    NetClientState GetState() const noexcept
+    {
+        return _state;
+    }
+
+    const NetServerInfo& GetServerInfo() const noexcept
+    {
+        return _serverInfo;
+    }
+
+    // Newest snapshot received, entities ordered by id
+    const QuantizedSnapshot& GetSnapshot() const noexcept
+    {
+        return _snapshots[_latestSnapshotId % SnapshotHistorySize].Entities;
+    }
+
+    const NetClientStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+    const NetConnection& GetConnection() const noexcept
+    {
+        return _connection;
+    }
+
+private:
+    static constexpr double ConnectRetryInterval = 0.25;
+    // Acks go out with every reply, this only matters while the server sends nothing
+    static constexpr double KeepAliveInterval = 0.1;
+
+    struct ReceivedSnapshot
+    {
+        uint16_t Id = 0;
+        bool IsValid = false;
+        QuantizedSnapshot Entities;
+    };
+
+    void ProcessPacket(std::span<const std::byte> packet, double time);
+    void ReadSnapshot(BitReader& reader);
+    void SendPacket(NetPacketType packetType, double time);
+
+    UdpSocket _socket;
+    NetAddress _serverAddress;
+    NetClientState _state = NetClientState::Disconnected;
+    NetConnection _connection;
+    NetServerInfo _serverInfo;
+    NetClientFocus _focus;
+    double _lastSendTime = -1.0;
+
+    std::array<ReceivedSnapshot, SnapshotHistorySize> _snapshots = {};
+    QuantizedSnapshot _decodedSnapshot;
+    uint16_t _latestSnapshotId = 0;
+    bool _hasSnapshot = false;
+
+    NetClientStatistics _statistics;
+};
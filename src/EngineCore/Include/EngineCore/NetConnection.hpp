@@ -0,0 +1,135 @@
+#pragma once
+
+#include <EngineCore/BitStream.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+constexpr uint32_t NetProtocolId = 0x4F535050;
+// Stays below common path MTUs so datagrams are never fragmented
+constexpr uint32_t MaxNetPacketSize = 1200;
+
+enum class NetPacketType : uint32_t
+{
+    ConnectRequest,
+    ConnectAccept,
+    Data,
+    Disconnect
+};
+
+void WriteNetPacketPrefix(BitWriter& writer, NetPacketType packetType) noexcept;
+// Nothing for datagrams which are not ours
+std::optional<NetPacketType> ReadNetPacketPrefix(BitReader& reader) noexcept;
+
+// True when lhs was sent after rhs, treating 16 bit sequences as wrapping around
+constexpr bool IsSequenceNewer(uint16_t lhs, uint16_t rhs) noexcept
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(lhs - rhs)) > 0;
+}
+
+struct NetConnectionStatistics
+{
+    uint64_t SentPacketCount = 0;
+    uint64_t ReceivedPacketCount = 0;
+    uint64_t AckedPacketCount = 0;
+    uint64_t LostPacketCount = 0;
+    // Smoothed, in seconds
+    double RoundTripTime = 0.0;
+};
+
+// Sequencing, acks and a reliable ordered message channel on top of unreliable datagrams.
+// Every packet acks the last 33 packets received, so acks survive heavy loss without resends.
+// Reliable messages ride along in packet headers until a packet carrying them is acked, whatever
+// else the packet holds stays unreliable and is the caller's business.
+class NetConnection
+{
+public:
+    static constexpr uint32_t MaxReliableMessageSize = 256;
+
+    // Queued and sent with the next packets until acked, delivered once and in order
+    void SendReliable(std::span<const std::byte> message);
+    bool ReceiveReliable(std::vector<std::byte>& message);
+
+    // Writes sequence, acks and whichever reliable messages are due, the payload follows.
+    // Returns the packet's sequence, which shows up in GetAckedSequences once the peer got it.
+    uint16_t WritePacketHeader(BitWriter& writer, double time);
+    // False for malformed packets and duplicates, their payload must be ignored
+    bool ReadPacketHeader(BitReader& reader, double time);
+
+    // Sequences of sent packets acked since the last ClearAckedSequences
+    std::span<const uint16_t> GetAckedSequences() const noexcept
+    {
+        return _ackedSequences;
+    }
+
+    void ClearAckedSequences() noexcept
+    {
+        _ackedSequences.clear();
+    }
+
+    const NetConnectionStatistics& GetStatistics() const noexcept
+    {
+        return _statistics;
+    }
+
+    double GetLastReceiveTime() const noexcept
+    {
+        return _lastReceiveTime;
+    }
+
+private:
+    static constexpr uint32_t SequenceBufferSize = 1024;
+    static constexpr uint32_t MaxMessagesPerPacket = 8;
+    static constexpr uint32_t MaxReliableBytesPerPacket = 512;
+    // Message ids further ahead than this are not sent, so the receive buffer never overflows
+    static constexpr uint32_t MessageWindowSize = 256;
+    static constexpr double MinResendInterval = 0.05;
+
+    struct SentPacket
+    {
+        uint16_t Sequence = 0;
+        bool IsValid = false;
+        bool IsAcked = false;
+        double SendTime = 0.0;
+        uint32_t MessageCount = 0;
+        std::array<uint16_t, MaxMessagesPerPacket> MessageIds = {};
+    };
+
+    struct ReliableMessage
+    {
+        uint16_t Id = 0;
+        std::vector<std::byte> Data;
+        double LastSendTime = -1.0;
+    };
+
+    struct ReceivedMessage
+    {
+        uint16_t Id = 0;
+        bool IsValid = false;
+        std::vector<std::byte> Data;
+    };
+
+    void OnPacketAcked(uint16_t sequence, double time);
+
+    uint16_t _nextSequence = 0;
+    uint16_t _remoteSequence = 0;
+    bool _hasReceivedPacket = false;
+    double _lastReceiveTime = 0.0;
+    std::array<SentPacket, SequenceBufferSize> _sentPackets = {};
+    // Holds sequence + 1 of the packet received into each slot, 0 for none
+    std::array<uint32_t, SequenceBufferSize> _receivedSequences = {};
+    std::vector<uint16_t> _ackedSequences;
+    uint16_t _nextLossCheckSequence = 0;
+
+    std::deque<ReliableMessage> _sendMessages;
+    uint16_t _nextSendMessageId = 0;
+    std::array<ReceivedMessage, MessageWindowSize> _receivedMessages = {};
+    uint16_t _nextReceiveMessageId = 0;
+
+    NetConnectionStatistics _statistics;
+};
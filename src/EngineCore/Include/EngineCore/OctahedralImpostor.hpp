@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class TaskScheduler;
+
+// Maps a unit direction onto the [-1, 1] square by unfolding an octahedron, lower hemisphere on the corners
+glm::vec2 OctahedralEncode(const glm::vec3& direction) noexcept;
+glm::vec3 OctahedralDecode(const glm::vec2& encoded) noexcept;
+
+// Direction frame (x, y) of the atlas was captured from, pointing from the mesh towards the viewer
+glm::vec3 GetOctahedralImpostorFrameDirection(uint32_t frameX, uint32_t frameY, uint32_t framesPerSide) noexcept;
+
+struct OctahedralImpostorBakeSettings
+{
+    uint32_t FramesPerSide = 12;
+    uint32_t FrameResolution = 64;
+};
+
+// FramesPerSide x FramesPerSide orthographic views of a mesh, each FrameResolution texels square.
+// Texels are RGBA8: rg object space normal (octahedral, unorm), b depth along the view direction
+// (0 nearest) and a coverage. Rows start at the bottom like GL textures.
+// Each frame is looked at along -direction with right = normalize(cross(up, direction)), up being +y
+// or +z near the poles, and spans the bounding sphere, the impostor shaders rebuild the same basis.
+struct OctahedralImpostorAtlas
+{
+    uint32_t FramesPerSide = 0;
+    uint32_t FrameResolution = 0;
+    glm::vec3 Center = {};
+    float Radius = 0.0f;
+    std::vector<uint32_t> Texels;
+
+    uint32_t GetSize() const noexcept
+    {
+        return FramesPerSide * FrameResolution;
+    }
+};
+
+// Software rasterizes every frame on the CPU, meant to run in the mesh cooker rather than per frame
+OctahedralImpostorAtlas BakeOctahedralImpostor(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    const glm::vec3& center,
+    float radius,
+    const OctahedralImpostorBakeSettings& settings,
+    TaskScheduler* taskScheduler = nullptr);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <EngineCore/GravitySimulation.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class TaskScheduler;
+
+constexpr uint32_t InvalidPatchedConicBody = UINT32_MAX;
+
+// Two body orbit around a parent. The reference plane is xz with north along +y, angles are radians
+// and the semi-major axis is negative for hyperbolic orbits.
+struct KeplerOrbit
+{
+    double SemiMajorAxis = 1.0;
+    double Eccentricity = 0.0;
+    double Inclination = 0.0;
+    double LongitudeOfAscendingNode = 0.0;
+    double ArgumentOfPeriapsis = 0.0;
+    double MeanAnomalyAtEpoch = 0.0;
+    double Epoch = 0.0;
+};
+
+// Relative to the parent
+struct OrbitState
+{
+    glm::dvec3 Position;
+    glm::dvec3 Velocity;
+};
+
+// gravitationalParameter is G times the mass of the parent. Orbits close to parabolic lose precision
+OrbitState EvaluateKeplerOrbit(const KeplerOrbit& orbit, double gravitationalParameter, double time) noexcept;
+KeplerOrbit ComputeKeplerOrbit(const OrbitState& state, double gravitationalParameter, double time) noexcept;
+
+// Bodies on rails, for everything that does not need N-body gravity. Each body follows a Kepler orbit
+// around its parent, which costs the same at any time step and never drifts. Massive bodies, stars,
+// planets and moons, stay with their parent and have a sphere of influence. Massless bodies, ships
+// and debris, are handed to whichever sphere of influence they move into, the patched conic
+// approximation. Their orbits are recomputed on such a hand over, so Update wants steps short
+// against the time it takes to cross a sphere of influence.
+class PatchedConics
+{
+public:
+    explicit PatchedConics(double gravitationalConstant = 1.0);
+
+    // Fixed in place with an unbounded sphere of influence, like the star of a system
+    uint32_t AddRoot(const glm::dvec3& position, double mass);
+    // Parents have to be added before their children
+    uint32_t AddBody(uint32_t parent, const KeplerOrbit& orbit, double mass);
+    void Clear();
+
+    uint32_t GetCount() const noexcept
+    {
+        return static_cast<uint32_t>(_bodies.size());
+    }
+
+    // Moves every body to time, parents first, then hands massless bodies over between spheres of
+    // influence. Returns how many were handed over
+    uint32_t Update(double time, TaskScheduler& taskScheduler);
+
+    glm::dvec3 GetPosition(uint32_t body) const noexcept
+    {
+        return _bodies[body].Position;
+    }
+
+    glm::dvec3 GetVelocity(uint32_t body) const noexcept
+    {
+        return _bodies[body].Velocity;
+    }
+
+    uint32_t GetParent(uint32_t body) const noexcept
+    {
+        return _bodies[body].Parent;
+    }
+
+    const KeplerOrbit& GetOrbit(uint32_t body) const noexcept
+    {
+        return _bodies[body].Orbit;
+    }
+
+    double GetSphereOfInfluenceRadius(uint32_t body) const noexcept
+    {
+        return _bodies[body].SphereOfInfluenceRadius;
+    }
+
+    // The massive bodies where Update left them, to pull on a GravitySimulation
+    std::span<const GravityAttractor> GetAttractors() const noexcept
+    {
+        return _attractors;
+    }
+
+private:
+    struct Body
+    {
+        KeplerOrbit Orbit;
+        uint32_t Parent;
+        double Mass;
+        double SphereOfInfluenceRadius;
+        glm::dvec3 Position;
+        glm::dvec3 Velocity;
+        // Of the orbit, kept so updates skip the trigonometry of its orientation
+        glm::dvec3 PeriapsisDirection;
+        glm::dvec3 NormalDirection;
+    };
+
+    void UpdateBody(Body& body, double time) const noexcept;
+    bool HandOver(Body& body, double time) const noexcept;
+
+    double _gravitationalConstant;
+    std::vector<Body> _bodies;
+    // Massive ones, in the order they were added, so parents come first
+    std::vector<uint32_t> _massiveBodies;
+    std::vector<uint32_t> _masslessBodies;
+    std::vector<GravityAttractor> _attractors;
+};
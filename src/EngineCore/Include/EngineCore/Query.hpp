@@ -0,0 +1,150 @@
+#pragma once
+
+#include <EngineCore/Archetype.hpp>
+#include <EngineCore/Component.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/World.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Matches every archetype containing all of TComponents. The matched archetype list is cached
+// and only extended with archetypes created since the last iteration.
+// Structural changes (create/destroy, add/remove component) are not allowed while iterating.
+template <typename... TComponents>
+    requires (IsComponent<std::remove_const_t<TComponents>> && ...)
+class Query
+{
+public:
+    explicit Query(World& world)
+        : _world(world)
+    {
+        (_componentMask.set(GetComponentId<TComponents>()), ...);
+    }
+
+    uint64_t GetEntityCount()
+    {
+        Refresh();
+
+        auto entityCount = uint64_t(0);
+        for (const auto& match : _matches)
+        {
+            entityCount += match.MatchedArchetype->GetEntityCount();
+        }
+        return entityCount;
+    }
+
+    // func(Entity, TComponents&...)
+    template <typename TFunc>
+    void ForEach(TFunc&& func)
+    {
+        ForEachChunk([&func](std::span<const Entity> entities, std::span<TComponents>... components)
+        {
+            for (auto i = 0u; i < entities.size(); i++)
+            {
+                func(entities[i], components[i]...);
+            }
+        });
+    }
+
+    // func(std::span<const Entity>, std::span<TComponents>...), called once per chunk
+    template <typename TFunc>
+    void ForEachChunk(TFunc&& func)
+    {
+        Refresh();
+
+        for (const auto& match : _matches)
+        {
+            for (const auto& chunk : match.MatchedArchetype->GetChunks())
+            {
+                InvokeChunk(func, match, chunk, std::index_sequence_for<TComponents...>());
+            }
+        }
+    }
+
+    // Same as ForEachChunk but chunks are distributed over the scheduler's workers,
+    // func must therefore be safe to call concurrently for different chunks.
+    template <typename TFunc>
+    void ParallelForEachChunk(
+        TaskScheduler& taskScheduler,
+        TFunc&& func,
+        uint32_t chunksPerTask = 4)
+    {
+        Refresh();
+
+        _chunkReferences.clear();
+        for (auto matchIndex = 0u; matchIndex < _matches.size(); matchIndex++)
+        {
+            auto chunkCount = static_cast<uint32_t>(_matches[matchIndex].MatchedArchetype->GetChunks().size());
+            for (auto chunkIndex = 0u; chunkIndex < chunkCount; chunkIndex++)
+            {
+                _chunkReferences.push_back(ChunkReference{ .MatchIndex = matchIndex, .ChunkIndex = chunkIndex });
+            }
+        }
+
+        taskScheduler.ParallelFor(
+            static_cast<uint32_t>(_chunkReferences.size()),
+            chunksPerTask,
+            [&](uint32_t begin, uint32_t end)
+        {
+            for (auto i = begin; i < end; i++)
+            {
+                const auto& match = _matches[_chunkReferences[i].MatchIndex];
+                const auto& chunk = match.MatchedArchetype->GetChunks()[_chunkReferences[i].ChunkIndex];
+                InvokeChunk(func, match, chunk, std::index_sequence_for<TComponents...>());
+            }
+        });
+    }
+
+private:
+    struct Match
+    {
+        const Archetype* MatchedArchetype;
+        std::array<int32_t, sizeof...(TComponents)> Columns;
+    };
+
+    struct ChunkReference
+    {
+        uint32_t MatchIndex;
+        uint32_t ChunkIndex;
+    };
+
+    void Refresh()
+    {
+        auto archetypes = _world.GetArchetypes();
+        for (; _archetypeCursor < archetypes.size(); _archetypeCursor++)
+        {
+            const auto* archetype = archetypes[_archetypeCursor].get();
+            if ((archetype->GetComponentMask() & _componentMask) != _componentMask)
+            {
+                continue;
+            }
+
+            _matches.push_back(Match{
+                .MatchedArchetype = archetype,
+                .Columns = { archetype->GetComponentColumn(GetComponentId<TComponents>())... }
+            });
+        }
+    }
+
+    template <typename TFunc, size_t... Indices>
+    static void InvokeChunk(
+        TFunc& func,
+        const Match& match,
+        const ArchetypeChunk& chunk,
+        std::index_sequence<Indices...>)
+    {
+        func(
+            std::span<const Entity>(match.MatchedArchetype->GetEntities(chunk), chunk.Count),
+            std::span<TComponents>(match.MatchedArchetype->template GetComponents<std::remove_const_t<TComponents>>(chunk, match.Columns[Indices]), chunk.Count)...);
+    }
+
+    World& _world;
+    ComponentMask _componentMask;
+    size_t _archetypeCursor = 0;
+    std::vector<Match> _matches;
+    std::vector<ChunkReference> _chunkReferences;
+};
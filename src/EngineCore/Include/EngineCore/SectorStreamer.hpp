@@ -0,0 +1,156 @@
+#pragma once
+
+#include <EngineCore/WorldPosition.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Whatever a sector holds, owned by the streamer between load and unload
+struct SectorContent
+{
+    virtual ~SectorContent() = default;
+};
+
+struct SectorUploadResult
+{
+    uint64_t UploadedByteCount = 0;
+    bool IsComplete = false;
+    // The upload carries on elsewhere, the streamer moves on to the next sector instead of stopping here
+    bool IsWaiting = false;
+};
+
+class SectorStreamingHandler
+{
+public:
+    virtual ~SectorStreamingHandler() = default;
+
+    // Runs on a loader thread, builds the sector's CPU side content and must not touch GL
+    virtual std::expected<std::unique_ptr<SectorContent>, std::string> LoadSector(const SectorCoordinate& sector) = 0;
+
+    // Runs on the thread calling SectorStreamer::Update. Uploads at most byteBudget bytes, splitting
+    // large resources across frames, and reports completion once everything is on the GPU.
+    // Handlers uploading in the background report the bytes they queued, then wait until they landed.
+    virtual SectorUploadResult UploadSector(
+        const SectorCoordinate& sector,
+        SectorContent& content,
+        uint64_t byteBudget) = 0;
+
+    // Runs on the thread calling SectorStreamer::Update for sectors that started uploading, releases GPU resources
+    virtual void UnloadSector(const SectorCoordinate& sector, SectorContent& content) = 0;
+};
+
+struct SectorStreamerSettings
+{
+    float SectorSize = 64.0f;
+    // Radii are in sectors, measured from the camera to sector centers
+    float LoadRadius = 2.5f;
+    // Larger than LoadRadius so sectors at the edge do not load and unload every frame
+    float UnloadRadius = 3.5f;
+    // Sectors around where the camera will be this far ahead are requested as well
+    float PrefetchSeconds = 2.0f;
+    // Hard cap on sectors in any state, which bounds memory however large the system is
+    uint32_t MaxSectorCount = 128;
+    uint32_t MaxPendingLoadCount = 8;
+    uint64_t UploadByteBudgetPerFrame = 1 << 20;
+    uint32_t LoaderThreadCount = 1;
+};
+
+struct SectorStreamerStatistics
+{
+    uint32_t ResidentSectorCount = 0;
+    uint32_t PendingLoadCount = 0;
+    uint32_t PendingUploadCount = 0;
+    uint32_t LoadedSectorCount = 0;
+    uint32_t UnloadedSectorCount = 0;
+    uint64_t UploadedByteCount = 0;
+};
+
+// Keeps the sectors around the camera loaded. Loads run on background threads, uploads run
+// inside Update within a per frame byte budget, nearest sectors first.
+class SectorStreamer
+{
+public:
+    SectorStreamer(SectorStreamingHandler& handler, const SectorStreamerSettings& settings);
+    ~SectorStreamer();
+
+    SectorStreamer(const SectorStreamer&) = delete;
+    SectorStreamer& operator=(const SectorStreamer&) = delete;
+
+    // cameraVelocity is in units per second. Statistics cover this call only. Bookkeeping of the
+    // call comes from scratchMemory and does not outlive it, a frame arena fits.
+    SectorStreamerStatistics Update(
+        const WorldPosition& cameraPosition,
+        const glm::vec3& cameraVelocity,
+        std::pmr::memory_resource* scratchMemory = std::pmr::get_default_resource());
+
+    // Unloads every sector, call while the GPU resources can still be released
+    void UnloadAll();
+
+    template <typename TFunc>
+    void ForEachResidentSector(TFunc&& func)
+    {
+        for (auto& [sector, entry] : _sectors)
+        {
+            if (entry.State == SectorState::Resident)
+            {
+                func(sector, *entry.Content);
+            }
+        }
+    }
+
+    const SectorStreamerSettings& GetSettings() const noexcept
+    {
+        return _settings;
+    }
+
+private:
+    enum class SectorState
+    {
+        Requested,
+        Loaded,
+        Uploading,
+        Resident,
+        Failed
+    };
+
+    struct SectorEntry
+    {
+        SectorState State = SectorState::Requested;
+        std::unique_ptr<SectorContent> Content;
+        // Distance in sectors to the nearer of the camera and its predicted position
+        float Priority = 0.0f;
+    };
+
+    struct LoadResult
+    {
+        SectorCoordinate Sector;
+        std::expected<std::unique_ptr<SectorContent>, std::string> Content;
+    };
+
+    void CollectLoadResults();
+    void RequestLoad(const SectorCoordinate& sector, float priority);
+    void Unload(const SectorCoordinate& sector, SectorEntry& entry);
+    void LoaderLoop(std::stop_token stopToken);
+
+    SectorStreamingHandler& _handler;
+    SectorStreamerSettings _settings;
+    std::unordered_map<SectorCoordinate, SectorEntry, SectorCoordinateHasher> _sectors;
+
+    std::deque<SectorCoordinate> _loadRequests;
+    std::vector<LoadResult> _loadResults;
+    std::vector<LoadResult> _collectedLoadResults;
+    std::mutex _loadMutex;
+    std::condition_variable_any _loadRequested;
+    std::vector<std::jthread> _loaders;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class BitWriter;
+class BitReader;
+
+// What the server replicates per entity
+struct EntityState
+{
+    uint32_t Id;
+    glm::vec3 Position;
+    glm::vec3 Velocity;
+};
+
+// Positions cover +-8192 units at 1/32 unit steps in 19 bits, velocities +-512 units per second at 1/64 in 16 bits
+constexpr float SnapshotPositionRange = 8192.0f;
+constexpr uint32_t SnapshotPositionBitCount = 19;
+constexpr float SnapshotVelocityRange = 512.0f;
+constexpr uint32_t SnapshotVelocityBitCount = 16;
+
+// Smallest changed entity on the wire: continue bit, id delta, new bit and six deltas at their shortest
+constexpr uint32_t SnapshotMinEntityBitCount = 1 + 6 + 1 + 6 * 6;
+
+// Position xyz then velocity xyz, each as unsigned fixed point over its range
+struct QuantizedEntityState
+{
+    uint32_t Id;
+    std::array<uint32_t, 6> Values;
+};
+
+// Entities ordered by Id
+using QuantizedSnapshot = std::vector<QuantizedEntityState>;
+
+QuantizedEntityState QuantizeEntityState(const EntityState& entityState) noexcept;
+EntityState DequantizeEntityState(const QuantizedEntityState& quantizedEntityState) noexcept;
+
+struct SnapshotEncodeResult
+{
+    uint32_t WrittenEntityCount = 0;
+    // Changed entities which did not fit into maxBitCount, they stay at their baseline values
+    uint32_t SkippedEntityCount = 0;
+    uint32_t RemovedEntityCount = 0;
+    // Leading entries of priorityOrder the receiver holds at their current values afterwards
+    uint32_t UpToDateEntityCount = 0;
+};
+
+// Writes current as a delta against baseline, which the receiver must hold as well. Entities
+// that match the baseline cost nothing, changed ones send per field deltas and new ones their
+// full quantized values. Removals always go out, then entities follow priorityOrder, indices
+// into current without repeats, until the first one that does not fit into maxBitCount.
+// Entities of current missing from priorityOrder are not sent. reconstructed receives exactly
+// the snapshot the receiver ends up with, which is what later deltas have to be encoded against.
+SnapshotEncodeResult EncodeSnapshotDelta(
+    BitWriter& writer,
+    const QuantizedSnapshot& baseline,
+    const QuantizedSnapshot& current,
+    uint32_t maxBitCount,
+    std::span<const uint32_t> priorityOrder,
+    QuantizedSnapshot& reconstructed);
+
+// False for malformed data or entities missing from the baseline
+bool DecodeSnapshotDelta(
+    BitReader& reader,
+    const QuantizedSnapshot& baseline,
+    QuantizedSnapshot& snapshot);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <EngineCore/Broadphase.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Uniform grid broadphase, rebuilt from scratch every FindPairs.
+// Works best when proxies are roughly cellSize large, proxies covering more than
+// MaxCellsPerProxy cells are kept out of the grid and tested against everything.
+class SpatialHash final : public Broadphase
+{
+public:
+    explicit SpatialHash(float cellSize);
+
+    void CreateProxies(
+        std::span<const Aabb> aabbs,
+        std::span<const uint32_t> userData,
+        std::span<int32_t> proxyIds,
+        TaskScheduler& taskScheduler) override;
+    void DestroyProxies(std::span<const int32_t> proxyIds) override;
+    void UpdateProxies(
+        std::span<const int32_t> proxyIds,
+        std::span<const Aabb> aabbs,
+        TaskScheduler& taskScheduler) override;
+
+    uint32_t GetProxyCount() const noexcept override
+    {
+        return _proxyCount;
+    }
+
+    void FindPairs(
+        BroadphasePairBuffer& pairBuffer,
+        TaskScheduler& taskScheduler) override;
+
+    float GetCellSize() const noexcept
+    {
+        return _cellSize;
+    }
+
+private:
+    static constexpr uint32_t MaxCellsPerProxy = 64;
+
+    struct CellEntry
+    {
+        uint32_t CellHash;
+        uint32_t ProxyId;
+    };
+
+    glm::ivec3 GetCell(const glm::vec3& position) const noexcept;
+    static uint32_t HashCell(const glm::ivec3& cell) noexcept;
+
+    void SortEntries(TaskScheduler& taskScheduler);
+
+    std::vector<Aabb> _aabbs;
+    std::vector<uint32_t> _userData;
+    std::vector<uint8_t> _isAlive;
+    std::vector<int32_t> _freeProxyIds;
+    uint32_t _proxyCount = 0;
+
+    std::vector<uint32_t> _entryOffsets;
+    std::vector<CellEntry> _entries;
+    std::vector<CellEntry> _sortScratch;
+    std::vector<std::array<uint32_t, 256>> _sortHistograms;
+    std::vector<uint32_t> _cellRuns;
+    std::vector<int32_t> _oversizedProxyIds;
+
+    float _cellSize;
+    float _inverseCellSize;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <EngineCore/Io.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TaskScheduler;
+
+// Binary star catalog, made to be memory mapped and handed to the GPU as it is.
+//
+// File: StarCatalogHeader, CellCount StarCells, then StarCount PackedStars from StarOffset on, all little
+// endian as laid out in memory. The sky is an octahedral map cut into CellGridSize x CellGridSize cells,
+// stars are sorted by cell and brightest first within each, so any prefix of a cell is its brightest stars.
+constexpr uint32_t StarCatalogMagic = 0x4353534F;
+constexpr uint32_t StarCatalogVersion = 1;
+constexpr uint32_t StarCatalogCellGridSize = 64;
+constexpr uint32_t StarCatalogCellCount = StarCatalogCellGridSize * StarCatalogCellGridSize;
+
+// Quantization ranges, apparent magnitudes and B-V color indices outside are clamped
+constexpr float StarMinMagnitude = -2.0f;
+constexpr float StarMagnitudeRange = 32.0f;
+constexpr float StarMinColorIndex = -1.0f;
+constexpr float StarColorIndexRange = 4.0f;
+// Cells count their stars up to every whole magnitude
+constexpr uint32_t StarMagnitudeBinCount = 32;
+
+// Matches struct Star in the star shaders (std430)
+struct PackedStar
+{
+    // Octahedral encoded direction, unorm16 x in the low half and y in the high half
+    uint32_t Direction;
+    // Magnitude in the low half and color index in the high half, unorm16 over the ranges above
+    uint32_t MagnitudeAndColor;
+};
+
+PackedStar PackStar(const glm::vec3& direction, float magnitude, float colorIndex) noexcept;
+glm::vec3 GetStarDirection(const PackedStar& star) noexcept;
+float GetStarMagnitude(const PackedStar& star) noexcept;
+uint32_t GetStarCell(const PackedStar& star) noexcept;
+
+struct StarCell
+{
+    // Unit direction, the angular radius in radians reaches every star of the cell
+    glm::vec3 Center = {};
+    float Radius = 0.0f;
+    uint32_t FirstStar = 0;
+    uint32_t StarCount = 0;
+    // Stars brighter than StarMinMagnitude + 1 + i
+    std::array<uint32_t, StarMagnitudeBinCount> BrighterStarCounts = {};
+
+    // Rounds up to the next whole magnitude, LOD only needs to be that precise
+    uint32_t GetStarCount(float limitingMagnitude) const noexcept;
+};
+
+struct StarCatalogHeader
+{
+    uint32_t Magic = StarCatalogMagic;
+    uint32_t Version = StarCatalogVersion;
+    uint32_t CellGridSize = StarCatalogCellGridSize;
+    uint32_t CellCount = StarCatalogCellCount;
+    uint64_t StarCount = 0;
+    uint64_t StarOffset = 0;
+};
+
+// HYG style CSV, a header row naming the columns and one star per row. Needs x, y and z, the position in
+// any Cartesian frame, and mag, the apparent magnitude. ci, the B-V color index, is optional
+std::expected<std::vector<PackedStar>, std::string> ReadStarCatalogCsv(std::string_view csvFilePath);
+
+// A made up sky for benchmarks, crowding towards a galactic plane, faint stars outnumbering bright ones
+// as in the real one, down to whatever magnitude gives the asked for count
+std::vector<PackedStar> GenerateStars(uint64_t starCount, uint32_t seed, TaskScheduler* taskScheduler = nullptr);
+
+// Sorts the stars into cells, brightest first, and writes the catalog. Leaves the stars sorted
+std::expected<void, std::string> WriteStarCatalog(
+    std::string_view filePath,
+    std::vector<PackedStar>& stars,
+    TaskScheduler* taskScheduler = nullptr);
+
+// Reads a catalog straight from its memory mapping without copying
+class StarCatalog
+{
+public:
+    static std::expected<StarCatalog, std::string> Open(std::string_view filePath);
+
+    std::span<const StarCell> GetCells() const noexcept
+    {
+        return _cells;
+    }
+
+    std::span<const PackedStar> GetStars() const noexcept
+    {
+        return _stars;
+    }
+
+private:
+    Io::MappedFile _file;
+    std::span<const StarCell> _cells;
+    std::span<const PackedStar> _stars;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <EngineCore/FunctionRef.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskScheduler
+{
+public:
+    // workerCount 0 picks hardware_concurrency - 1, the calling thread always participates
+    explicit TaskScheduler(uint32_t workerCount = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    uint32_t GetWorkerCount() const noexcept
+    {
+        return static_cast<uint32_t>(_workers.size());
+    }
+
+    // Splits [0, count) into ranges of grainSize and runs body(begin, end) across all workers.
+    // Returns once every range has been processed, which is also why nothing here needs to own
+    // body and a call does not allocate.
+    void ParallelFor(
+        uint32_t count,
+        uint32_t grainSize,
+        FunctionRef<void(uint32_t begin, uint32_t end)> body);
+
+private:
+    void Enqueue(FunctionRef<void()> task);
+    bool TryRunTask();
+    FunctionRef<void()> PopTask();
+    void WorkerLoop(std::stop_token stopToken);
+
+    std::vector<std::jthread> _workers;
+    // Queued from _firstTask on, the vector keeps its capacity once drained
+    std::vector<FunctionRef<void()>> _tasks;
+    size_t _firstTask = 0;
+    std::mutex _tasksMutex;
+    std::condition_variable_any _tasksAvailable;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <EngineCore/Io.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Append only log of what went into every simulation tick, for replays and reproducible benchmarks.
+//
+// File: "OSTR", version and header size as little endian uint32, the session header, then frames.
+// Frame: tick index delta and input size as LEB128 varints, the input bytes, the state checksum
+// after the tick as little endian uint64. Frames are self delimiting, so a recording cut short by a
+// crash is still readable up to its last complete frame.
+constexpr uint32_t TickRecordingMagic = 0x5254534F;
+constexpr uint32_t TickRecordingVersion = 1;
+
+// LEB128, what tick inputs are built from
+void AppendVarint(std::vector<std::byte>& bytes, uint64_t value);
+void AppendSignedVarint(std::vector<std::byte>& bytes, int64_t value);
+// Advance offset past the varint, nullopt when it runs past the end
+std::optional<uint64_t> ReadVarint(std::span<const std::byte> bytes, size_t& offset) noexcept;
+std::optional<int64_t> ReadSignedVarint(std::span<const std::byte> bytes, size_t& offset) noexcept;
+
+// Frames are encoded on the recording thread into chunks, a writer thread appends full chunks to
+// the file so the tick never waits on the disk
+class TickRecorder
+{
+public:
+    static std::expected<std::unique_ptr<TickRecorder>, std::string> Create(
+        std::string_view filePath,
+        std::span<const std::byte> header);
+
+    TickRecorder(const TickRecorder&) = delete;
+    TickRecorder& operator=(const TickRecorder&) = delete;
+    // Finishes unless that happened already
+    ~TickRecorder();
+
+    void RecordTick(uint64_t tickIndex, std::span<const std::byte> input, uint64_t checksum);
+
+    // Hands the partial chunk to the writer, everything recorded so far reaches the file soon after
+    void Flush();
+
+    // Writes whatever is still pending and closes the file, nothing can be recorded after. Fails when
+    // any write did, the recording then ends early
+    std::expected<void, std::string> Finish();
+
+    // Set by the writer thread once a write failed, frames recorded after that never reach the file
+    bool HasFailed() const noexcept
+    {
+        return _hasFailed.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetFrameCount() const noexcept
+    {
+        return _frameCount;
+    }
+
+    uint64_t GetWrittenByteCount() const noexcept
+    {
+        return _writtenByteCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t ChunkSize = 64 * 1024;
+
+    TickRecorder(std::FILE* file, std::string filePath);
+
+    void WriteChunks(std::stop_token stopToken);
+
+    std::FILE* _file = nullptr;
+    std::string _filePath;
+    std::atomic<bool> _hasFailed = false;
+    std::vector<std::byte> _chunk;
+    uint64_t _previousTickIndex = 0;
+    uint64_t _frameCount = 0;
+    std::atomic<uint64_t> _writtenByteCount = 0;
+
+    std::mutex _chunksMutex;
+    std::condition_variable_any _chunksAvailable;
+    std::vector<std::vector<std::byte>> _pendingChunks;
+    // Written chunks come back here so steady state recording does not allocate
+    std::vector<std::vector<std::byte>> _freeChunks;
+    std::jthread _writer;
+};
+
+struct TickFrame
+{
+    uint64_t TickIndex = 0;
+    // Points into the mapped recording
+    std::span<const std::byte> Input;
+    uint64_t Checksum = 0;
+};
+
+// Reads a recording straight from its memory mapping without copying
+class TickRecordingReader
+{
+public:
+    static std::expected<TickRecordingReader, std::string> Open(std::string_view filePath);
+
+    std::span<const std::byte> GetHeader() const noexcept
+    {
+        return _header;
+    }
+
+    // nullopt at the end of the recording, including a truncated last frame
+    std::optional<TickFrame> ReadNextFrame() noexcept;
+
+private:
+    Io::MappedFile _file;
+    std::span<const std::byte> _header;
+    size_t _offset = 0;
+    uint64_t _tickIndex = 0;
+};
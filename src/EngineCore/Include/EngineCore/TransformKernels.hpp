@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+enum class TransformKernelLevel
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Neon
+};
+
+// Read-only SoA view over the transforms the kernels consume, rotations are unit quaternions
+struct TransformKernelInput
+{
+    const float* PositionX;
+    const float* PositionY;
+    const float* PositionZ;
+    const float* RotationX;
+    const float* RotationY;
+    const float* RotationZ;
+    const float* RotationW;
+    const float* ScaleX;
+    const float* ScaleY;
+    const float* ScaleZ;
+};
+
+// Composes translation * rotation * scale for [begin, end) and writes column-major 4x4 matrices.
+// modelDestination may be null. Strides are in bytes and must be multiples of 4.
+// viewProjection is a column-major 4x4 matrix (glm layout).
+using ComposeTransformsFunction = void (*)(
+    const TransformKernelInput& input,
+    uint32_t begin,
+    uint32_t end,
+    const float* viewProjection,
+    float* modelDestination,
+    uint32_t modelStride,
+    float* modelViewProjectionDestination,
+    uint32_t modelViewProjectionStride);
+
+// Best level the running CPU supports, detected once
+TransformKernelLevel GetSupportedTransformKernelLevel();
+
+// Whether the running CPU has the kernels of level, rather than falling back to a lower one
+bool IsTransformKernelLevelSupported(TransformKernelLevel level);
+
+// Returns the kernel for the requested level, falling back to the best supported level below it
+ComposeTransformsFunction GetComposeTransformsFunction(TransformKernelLevel level);
+
+std::string_view ToString(TransformKernelLevel level);
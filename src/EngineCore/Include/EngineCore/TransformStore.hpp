@@ -0,0 +1,83 @@
+#pragma once
+
+#include <EngineCore/TransformKernels.hpp>
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class TaskScheduler;
+
+// Transforms stored as SoA, one array per scalar, so the SIMD kernels can load
+// 4 or 8 instances per register without gathers.
+class TransformStore
+{
+public:
+    TransformStore();
+
+    uint32_t Add(
+        const glm::vec3& position,
+        const glm::quat& rotation,
+        const glm::vec3& scale);
+    // Swap-removes the transform, the former last transform now lives at index
+    void Remove(uint32_t index);
+    void Clear();
+    void Reserve(uint32_t capacity);
+
+    uint32_t GetCount() const noexcept
+    {
+        return static_cast<uint32_t>(_positionX.size());
+    }
+
+    void SetPosition(uint32_t index, const glm::vec3& position) noexcept;
+    void SetRotation(uint32_t index, const glm::quat& rotation) noexcept;
+    void SetScale(uint32_t index, const glm::vec3& scale) noexcept;
+
+    glm::vec3 GetPosition(uint32_t index) const noexcept;
+    glm::quat GetRotation(uint32_t index) const noexcept;
+    glm::vec3 GetScale(uint32_t index) const noexcept;
+
+    void SetKernelLevel(TransformKernelLevel kernelLevel);
+
+    TransformKernelLevel GetKernelLevel() const noexcept
+    {
+        return _kernelLevel;
+    }
+
+    // Writes one column-major model-view-projection matrix per transform to destination,
+    // typically a persistently mapped instance buffer. destinationStride is in bytes.
+    void ComputeMatrices(
+        const glm::mat4& viewProjection,
+        void* destination,
+        uint32_t destinationStride,
+        TaskScheduler* taskScheduler = nullptr) const;
+
+    // Same as above but also writes the model matrices, for shaders that need world space
+    void ComputeMatrices(
+        const glm::mat4& viewProjection,
+        void* modelDestination,
+        uint32_t modelStride,
+        void* modelViewProjectionDestination,
+        uint32_t modelViewProjectionStride,
+        TaskScheduler* taskScheduler = nullptr) const;
+
+private:
+    TransformKernelInput GetKernelInput() const noexcept;
+
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _positionZ;
+    std::vector<float> _rotationX;
+    std::vector<float> _rotationY;
+    std::vector<float> _rotationZ;
+    std::vector<float> _rotationW;
+    std::vector<float> _scaleX;
+    std::vector<float> _scaleY;
+    std::vector<float> _scaleZ;
+
+    TransformKernelLevel _kernelLevel;
+    ComposeTransformsFunction _composeTransforms;
+};
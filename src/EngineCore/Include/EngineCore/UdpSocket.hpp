@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+
+// IPv4 address and port, both in host byte order
+struct NetAddress
+{
+    uint32_t Address = 0;
+    uint16_t Port = 0;
+
+    static NetAddress Loopback(uint16_t port) noexcept
+    {
+        return NetAddress{ 0x7F000001, port };
+    }
+
+    bool operator==(const NetAddress&) const = default;
+};
+
+struct NetAddressHasher
+{
+    size_t operator()(const NetAddress& address) const noexcept
+    {
+        return std::hash<uint64_t>()((static_cast<uint64_t>(address.Address) << 16) | address.Port);
+    }
+};
+
+// Non blocking IPv4 UDP socket
+class UdpSocket
+{
+public:
+    // port 0 binds an ephemeral port, GetPort tells which one
+    static std::expected<UdpSocket, std::string> Create(uint16_t port);
+
+    UdpSocket() noexcept = default;
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) noexcept = delete;
+    UdpSocket& operator =(const UdpSocket&) noexcept = delete;
+    UdpSocket(UdpSocket&& other) noexcept;
+    UdpSocket& operator =(UdpSocket&& other) noexcept;
+
+    void Swap(UdpSocket& other) noexcept;
+
+    // Datagrams are fire and forget, a failed send looks the same as a lost packet to the peer
+    bool Send(const NetAddress& address, std::span<const std::byte> data) const noexcept;
+    // Returns the datagram size, or nothing once no datagram is waiting
+    std::optional<uint32_t> Receive(std::span<std::byte> buffer, NetAddress& address) const noexcept;
+
+    uint16_t GetPort() const noexcept
+    {
+        return _port;
+    }
+
+private:
+    intptr_t _handle = -1;
+    uint16_t _port = 0;
+};
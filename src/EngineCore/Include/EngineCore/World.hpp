@@ -0,0 +1,183 @@
+#pragma once
+
+#include <EngineCore/Archetype.hpp>
+#include <EngineCore/Component.hpp>
+#include <EngineCore/Entity.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class World
+{
+public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    Entity CreateEntity();
+
+    template <typename... TComponents>
+        requires (IsComponent<TComponents> && ...)
+    Entity CreateEntity(const TComponents&... components)
+    {
+        auto componentMask = ComponentMask();
+        (componentMask.set(GetComponentId<TComponents>()), ...);
+
+        auto archetype = GetOrCreateArchetype(componentMask);
+        auto entity = AllocateEntity(archetype);
+        auto location = GetLocation(entity);
+        (WriteComponent(archetype, location, components), ...);
+        return entity;
+    }
+
+    // Creates count entities sharing the same archetype, initialized with the given values.
+    // Cheaper than calling CreateEntity in a loop as the archetype lookup happens once.
+    template <typename... TComponents>
+        requires (IsComponent<TComponents> && ...)
+    void CreateEntities(
+        uint32_t count,
+        std::span<Entity> createdEntities,
+        const TComponents&... components)
+    {
+        auto componentMask = ComponentMask();
+        (componentMask.set(GetComponentId<TComponents>()), ...);
+
+        auto archetype = GetOrCreateArchetype(componentMask);
+        for (auto i = 0u; i < count; i++)
+        {
+            auto entity = AllocateEntity(archetype);
+            auto location = GetLocation(entity);
+            (WriteComponent(archetype, location, components), ...);
+            if (i < createdEntities.size())
+            {
+                createdEntities[i] = entity;
+            }
+        }
+    }
+
+    void DestroyEntity(Entity entity);
+    bool IsAlive(Entity entity) const noexcept;
+
+    template <typename T>
+        requires IsComponent<T>
+    void AddComponent(Entity entity, const T& component)
+    {
+        auto componentId = GetComponentId<T>();
+        if (!IsAlive(entity))
+        {
+            return;
+        }
+
+        auto& record = _entityRecords[entity.Index];
+        if (!record.CurrentArchetype->HasComponent(componentId))
+        {
+            MoveEntity(entity, GetAddEdge(record.CurrentArchetype, componentId));
+        }
+
+        WriteComponent(record.CurrentArchetype, GetLocation(entity), component);
+    }
+
+    template <typename T>
+        requires IsComponent<T>
+    void RemoveComponent(Entity entity)
+    {
+        auto componentId = GetComponentId<T>();
+        if (!IsAlive(entity))
+        {
+            return;
+        }
+
+        auto& record = _entityRecords[entity.Index];
+        if (record.CurrentArchetype->HasComponent(componentId))
+        {
+            MoveEntity(entity, GetRemoveEdge(record.CurrentArchetype, componentId));
+        }
+    }
+
+    template <typename T>
+        requires IsComponent<T>
+    bool HasComponent(Entity entity) const noexcept
+    {
+        return IsAlive(entity) && _entityRecords[entity.Index].CurrentArchetype->HasComponent(GetComponentId<T>());
+    }
+
+    template <typename T>
+        requires IsComponent<T>
+    T* GetComponent(Entity entity) const noexcept
+    {
+        if (!IsAlive(entity))
+        {
+            return nullptr;
+        }
+
+        const auto& record = _entityRecords[entity.Index];
+        auto column = record.CurrentArchetype->GetComponentColumn(GetComponentId<T>());
+        if (column < 0)
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<T*>(record.CurrentArchetype->GetComponentPointer(GetLocation(entity), column));
+    }
+
+    uint64_t GetEntityCount() const noexcept
+    {
+        return _entityCount;
+    }
+
+    // Archetypes are never destroyed and only ever appended, queries rely on this
+    // to pick up new archetypes incrementally.
+    std::span<const std::unique_ptr<Archetype>> GetArchetypes() const noexcept
+    {
+        return _archetypes;
+    }
+
+private:
+    struct EntityRecord
+    {
+        Archetype* CurrentArchetype = nullptr;
+        uint32_t ChunkIndex = 0;
+        uint32_t Row = 0;
+        uint32_t Generation = 1;
+    };
+
+    Entity AllocateEntity(Archetype* archetype);
+    void MoveEntity(Entity entity, Archetype* targetArchetype);
+
+    Archetype* GetOrCreateArchetype(const ComponentMask& componentMask);
+    Archetype* GetAddEdge(Archetype* archetype, ComponentId componentId);
+    Archetype* GetRemoveEdge(Archetype* archetype, ComponentId componentId);
+
+    Archetype::Location GetLocation(Entity entity) const noexcept
+    {
+        const auto& record = _entityRecords[entity.Index];
+        return Archetype::Location{
+            .ChunkIndex = record.ChunkIndex,
+            .Row = record.Row
+        };
+    }
+
+    template <typename T>
+    void WriteComponent(
+        Archetype* archetype,
+        Archetype::Location location,
+        const T& component)
+    {
+        auto column = archetype->GetComponentColumn(GetComponentId<T>());
+        std::memcpy(archetype->GetComponentPointer(location, column), &component, sizeof(T));
+    }
+
+    std::vector<EntityRecord> _entityRecords;
+    std::vector<uint32_t> _freeEntityIndices;
+    uint64_t _entityCount = 0;
+
+    std::vector<std::unique_ptr<Archetype>> _archetypes;
+    std::unordered_map<ComponentMask, Archetype*> _archetypeLookup;
+    Archetype* _emptyArchetype = nullptr;
+};
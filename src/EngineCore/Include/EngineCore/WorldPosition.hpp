@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+struct SectorCoordinate
+{
+    int64_t X = 0;
+    int64_t Y = 0;
+    int64_t Z = 0;
+
+    bool operator==(const SectorCoordinate& other) const noexcept = default;
+};
+
+struct SectorCoordinateHasher
+{
+    std::size_t operator()(const SectorCoordinate& sector) const noexcept;
+};
+
+// Position in the partitioned world, an integer sector plus a float offset from the sector's origin.
+// Floats never have to hold more than a few sectors worth of distance, so precision does not degrade
+// however far from the system's origin something is.
+struct WorldPosition
+{
+    SectorCoordinate Sector;
+    glm::vec3 Local = {};
+};
+
+// Moves whole sectors out of Local until it lies within [0, sectorSize) on every axis
+WorldPosition NormalizeWorldPosition(const WorldPosition& position, float sectorSize) noexcept;
+
+WorldPosition OffsetWorldPosition(const WorldPosition& position, const glm::vec3& offset, float sectorSize) noexcept;
+
+// Where position is as seen from origin, the camera usually, for camera relative float rendering.
+// The sector difference is resolved in integers first so nearby results stay exact.
+glm::vec3 GetRelativePosition(const WorldPosition& position, const WorldPosition& origin, float sectorSize) noexcept;
+
+// Offset of sector's origin from origin, add sector local positions to it
+glm::vec3 GetRelativeSectorOrigin(const SectorCoordinate& sector, const WorldPosition& origin, float sectorSize) noexcept;
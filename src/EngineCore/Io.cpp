@@ -0,0 +1,161 @@
+#include <EngineCore/Io.hpp>
+
+#include <cerrno>
+#include <format>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Io
+{
+
+namespace
+{
+    template <typename TString>
+    std::expected<TString, std::string> ReadTextInto(std::string_view filePath, TString result)
+    {
+        std::ifstream file(filePath.data(), std::ios::ate);
+        if (file.bad())
+        {
+            return std::unexpected(std::format("Io: File {} does not exist", filePath));
+        }
+        auto fileSize = file.tellg();
+        if (fileSize == 0)
+        {
+            return std::unexpected(std::format("Io: File {} is empty", filePath));
+        }
+
+        result.resize(fileSize, '\0');
+        file.seekg(0);
+        file.read((char*)result.data(), result.size());
+        return result;
+    }
+}
+
+std::expected<std::string, std::string> ReadTextFromFile(std::string_view filePath)
+{
+    return ReadTextInto(filePath, std::string());
+}
+
+std::expected<std::pmr::string, std::string> ReadTextFromFile(std::string_view filePath, std::pmr::memory_resource* memoryResource)
+{
+    return ReadTextInto(filePath, std::pmr::string(memoryResource));
+}
+
+std::expected<MappedFile, std::string> MappedFile::Open(std::string_view filePath)
+{
+    MappedFile mappedFile;
+    auto path = std::string(filePath);
+
+#ifdef _WIN32
+    mappedFile._fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mappedFile._fileHandle == INVALID_HANDLE_VALUE)
+    {
+        mappedFile._fileHandle = nullptr;
+        return std::unexpected(std::format("Io: Opening {} failed with error {}", filePath, GetLastError()));
+    }
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(mappedFile._fileHandle, &fileSize);
+    mappedFile._size = static_cast<size_t>(fileSize.QuadPart);
+    if (mappedFile._size == 0)
+    {
+        return mappedFile;
+    }
+
+    mappedFile._mappingHandle = CreateFileMappingA(mappedFile._fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    auto data = mappedFile._mappingHandle != nullptr ? MapViewOfFile(mappedFile._mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        return std::unexpected(std::format("Io: Mapping {} failed with error {}", filePath, GetLastError()));
+    }
+    mappedFile._data = static_cast<const std::byte*>(data);
+#else
+    auto fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return std::unexpected(std::format("Io: Opening {} failed with errno {}", filePath, errno));
+    }
+
+    struct stat fileStatus = {};
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        close(fileDescriptor);
+        return std::unexpected(std::format("Io: Reading the size of {} failed with errno {}", filePath, errno));
+    }
+
+    mappedFile._size = static_cast<size_t>(fileStatus.st_size);
+    if (mappedFile._size > 0)
+    {
+        auto data = mmap(nullptr, mappedFile._size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            mappedFile._size = 0;
+            return std::unexpected(std::format("Io: Mapping {} failed with errno {}", filePath, errno));
+        }
+        mappedFile._data = static_cast<const std::byte*>(data);
+    }
+
+    // The mapping keeps the file alive on its own
+    close(fileDescriptor);
+#endif
+
+    return mappedFile;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    Swap(other);
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle != nullptr)
+    {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle != nullptr)
+    {
+        CloseHandle(_fileHandle);
+    }
+#else
+    if (_data != nullptr)
+    {
+        munmap(const_cast<std::byte*>(_data), _size);
+    }
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    MappedFile(std::move(other)).Swap(*this);
+    return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept
+{
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+#ifdef _WIN32
+    std::swap(_fileHandle, other._fileHandle);
+    std::swap(_mappingHandle, other._mappingHandle);
+#endif
+}
+
+}
@@ -0,0 +1,40 @@
+#include <EngineCore/Logging.hpp>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <chrono>
+#include <memory>
+
+AsyncLogging::AsyncLogging(size_t queueCapacity)
+{
+    spdlog::init_thread_pool(queueCapacity, 1);
+
+    // Unnamed like the logger it replaces, so the output looks the same
+    auto logger = std::make_shared<spdlog::async_logger>(
+        "",
+        std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+        spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest);
+    logger->flush_on(spdlog::level::warn);
+    spdlog::set_default_logger(std::move(logger));
+    spdlog::flush_every(std::chrono::seconds(1));
+}
+
+AsyncLogging::~AsyncLogging()
+{
+    if (auto droppedMessageCount = GetDroppedMessageCount(); droppedMessageCount > 0)
+    {
+        spdlog::warn("Logging: {} messages were dropped because the queue was full", droppedMessageCount);
+    }
+
+    // Drains the queue before the worker thread is joined
+    spdlog::shutdown();
+}
+
+uint64_t AsyncLogging::GetDroppedMessageCount() noexcept
+{
+    auto threadPool = spdlog::thread_pool();
+    return threadPool != nullptr ? threadPool->overrun_counter() : 0;
+}
@@ -0,0 +1,136 @@
+#include <EngineCore/Memory.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+namespace
+{
+    constexpr size_t ThreadArenaCapacity = 256 * 1024;
+
+    // Arenas outlive their threads, worker threads come and go with schedulers but are few
+    struct ThreadArenaRegistry
+    {
+        std::mutex Mutex;
+        std::vector<std::unique_ptr<LinearArena>> Arenas;
+    };
+
+    ThreadArenaRegistry& GetThreadArenaRegistry()
+    {
+        static ThreadArenaRegistry registry;
+        return registry;
+    }
+}
+
+LinearArena::LinearArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : _upstream(upstream),
+      _capacity(capacity)
+{
+    _block = static_cast<std::byte*>(_upstream->allocate(_capacity, alignof(std::max_align_t)));
+}
+
+LinearArena::~LinearArena()
+{
+    for (auto& overflow : _overflows)
+    {
+        _upstream->deallocate(overflow.Memory, overflow.Size, overflow.Alignment);
+    }
+    _upstream->deallocate(_block, _capacity, alignof(std::max_align_t));
+}
+
+void LinearArena::Reset() noexcept
+{
+    for (auto& overflow : _overflows)
+    {
+        _upstream->deallocate(overflow.Memory, overflow.Size, overflow.Alignment);
+    }
+    _overflows.clear();
+
+    if (_peakByteCount > _capacity)
+    {
+        _upstream->deallocate(_block, _capacity, alignof(std::max_align_t));
+        _capacity = std::bit_ceil(_peakByteCount);
+        _block = static_cast<std::byte*>(_upstream->allocate(_capacity, alignof(std::max_align_t)));
+    }
+
+    _offset = 0;
+    _overflowByteCount = 0;
+    _peakByteCount = 0;
+}
+
+void LinearArena::Rewind(Marker marker) noexcept
+{
+    // Nested scopes can open at offset 0 while an outer one lives in overflow blocks, so the
+    // overflow count decides whether anything older than the marker is still in use
+    if (marker.Offset == 0 && marker.OverflowCount == 0)
+    {
+        Reset();
+        return;
+    }
+
+    while (_overflows.size() > marker.OverflowCount)
+    {
+        auto& overflow = _overflows.back();
+        _upstream->deallocate(overflow.Memory, overflow.Size, overflow.Alignment);
+        _overflowByteCount -= overflow.Size;
+        _overflows.pop_back();
+    }
+    _offset = std::min(marker.Offset, _offset);
+}
+
+void* LinearArena::do_allocate(size_t size, size_t alignment)
+{
+    auto address = reinterpret_cast<uintptr_t>(_block) + _offset;
+    auto padding = (alignment - address % alignment) % alignment;
+    if (_offset + padding + size <= _capacity)
+    {
+        auto memory = _block + _offset + padding;
+        _offset += padding + size;
+        _peakByteCount = std::max(_peakByteCount, _offset + _overflowByteCount);
+        return memory;
+    }
+
+    auto memory = _upstream->allocate(size, alignment);
+    _overflows.push_back(Overflow{ memory, size, alignment });
+    _overflowByteCount += size;
+    _peakByteCount = std::max(_peakByteCount, _offset + _overflowByteCount);
+    return memory;
+}
+
+void LinearArena::do_deallocate(
+    [[maybe_unused]] void* memory,
+    [[maybe_unused]] size_t size,
+    [[maybe_unused]] size_t alignment)
+{
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+LinearArena& GetThreadArena()
+{
+    thread_local LinearArena* threadArena = nullptr;
+    if (threadArena == nullptr)
+    {
+        auto& registry = GetThreadArenaRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        threadArena = registry.Arenas.emplace_back(std::make_unique<LinearArena>(ThreadArenaCapacity)).get();
+    }
+    return *threadArena;
+}
+
+std::string_view GetMemoryTagName(MemoryTag memoryTag) noexcept
+{
+    switch (memoryTag)
+    {
+        case MemoryTag::General: return "General";
+        case MemoryTag::Rendering: return "Rendering";
+        case MemoryTag::Streaming: return "Streaming";
+        case MemoryTag::Network: return "Network";
+        case MemoryTag::Simulation: return "Simulation";
+        case MemoryTag::Debug: return "Debug";
+        default: return "Unknown";
+    }
+}
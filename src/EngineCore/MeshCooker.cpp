@@ -0,0 +1,90 @@
+#include <EngineCore/MeshCooker.hpp>
+#include <EngineCore/MeshSimplifier.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <format>
+
+namespace
+{
+    // A level that removes fewer triangles than this is not worth its own draw
+    constexpr float MinLodReduction = 0.9f;
+}
+
+std::expected<CookedMesh, std::string> CookMesh(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    const MeshCookSettings& settings,
+    TaskScheduler* taskScheduler)
+{
+    if (positions.empty() || indices.size() < 3 || indices.size() % 3 != 0)
+    {
+        return std::unexpected(std::format("MeshCooker: Expected a triangle list, got {} vertices and {} indices", positions.size(), indices.size()));
+    }
+
+    auto vertexCount = static_cast<uint32_t>(positions.size());
+    if (std::any_of(indices.begin(), indices.end(), [&](uint32_t index) { return index >= vertexCount; }))
+    {
+        return std::unexpected(std::format("MeshCooker: Index out of range for {} vertices", vertexCount));
+    }
+
+    CookedMesh cookedMesh;
+
+    auto boundsMin = positions[0];
+    auto boundsMax = positions[0];
+    for (auto& position : positions)
+    {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+    cookedMesh.BoundingSphereCenter = (boundsMin + boundsMax) * 0.5f;
+    for (auto& position : positions)
+    {
+        cookedMesh.BoundingSphereRadius = std::max(cookedMesh.BoundingSphereRadius, glm::distance(position, cookedMesh.BoundingSphereCenter));
+    }
+
+    cookedMesh.Indices.assign(indices.begin(), indices.end());
+    cookedMesh.LodLevels.push_back(MeshLodLevel{ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+
+    auto maxLodLevelCount = std::min(settings.MaxLodLevelCount, MaxMeshLodLevelCount);
+    auto maxError = settings.MaxRelativeError * cookedMesh.BoundingSphereRadius;
+    auto targetTriangleCount = static_cast<float>(indices.size() / 3);
+    while (cookedMesh.LodLevels.size() < maxLodLevelCount)
+    {
+        auto previousLevel = cookedMesh.LodLevels.back();
+        targetTriangleCount *= settings.LodTriangleRatio;
+        if (targetTriangleCount < static_cast<float>(settings.MinLodTriangleCount))
+        {
+            break;
+        }
+
+        // Always simplify from the source mesh, so errors are measured against level 0
+        auto simplified = SimplifyMesh(positions, indices, static_cast<uint32_t>(targetTriangleCount) * 3, maxError);
+        if (static_cast<float>(simplified.Indices.size()) > static_cast<float>(previousLevel.IndexCount) * MinLodReduction)
+        {
+            break;
+        }
+
+        cookedMesh.LodLevels.push_back(MeshLodLevel{
+            .IndexOffset = static_cast<uint32_t>(cookedMesh.Indices.size()),
+            .IndexCount = static_cast<uint32_t>(simplified.Indices.size()),
+            .GeometricError = std::max(simplified.GeometricError, previousLevel.GeometricError)
+        });
+        cookedMesh.Indices.insert(cookedMesh.Indices.end(), simplified.Indices.begin(), simplified.Indices.end());
+    }
+
+    if (settings.BakeImpostor)
+    {
+        cookedMesh.Impostor = BakeOctahedralImpostor(
+            positions,
+            indices,
+            cookedMesh.BoundingSphereCenter,
+            cookedMesh.BoundingSphereRadius,
+            settings.Impostor,
+            taskScheduler);
+    }
+
+    return cookedMesh;
+}
@@ -0,0 +1,84 @@
+#include <EngineCore/MeshLodSelector.hpp>
+#include <EngineCore/TransformStore.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    constexpr uint64_t ImpostorTriangleCount = 2;
+    constexpr float MinDistance = 1e-3f;
+}
+
+void MeshLodSelector::SetProjection(float verticalFieldOfView, uint32_t viewportHeight) noexcept
+{
+    _projectionScale = static_cast<float>(viewportHeight) * 0.5f / std::tan(verticalFieldOfView * 0.5f);
+}
+
+MeshLodStatistics MeshLodSelector::Select(
+    const CookedMesh& mesh,
+    const TransformStore& transforms,
+    const glm::vec3& cameraPosition,
+    std::span<uint8_t> lods) const
+{
+    assert(lods.size() >= transforms.GetCount());
+    assert(!mesh.LodLevels.empty());
+
+    MeshLodStatistics statistics;
+
+    auto lodLevelCount = static_cast<uint32_t>(mesh.LodLevels.size());
+    auto coarsestLevel = lodLevelCount - 1;
+    auto fullDetailTriangleCount = mesh.LodLevels[0].GetTriangleCount();
+    auto useImpostors = mesh.HasImpostor() && _settings.ImpostorPixelRadius > 0.0f;
+
+    auto refineThreshold = _settings.MaxPixelError * (1.0f + _settings.Hysteresis);
+    auto coarsenThreshold = _settings.MaxPixelError * (1.0f - _settings.Hysteresis);
+    auto leaveImpostorRadius = _settings.ImpostorPixelRadius * (1.0f + _settings.Hysteresis);
+    auto enterImpostorRadius = _settings.ImpostorPixelRadius * (1.0f - _settings.Hysteresis);
+
+    for (auto i = 0u; i < transforms.GetCount(); i++)
+    {
+        auto scale = transforms.GetScale(i);
+        auto maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+        auto center = transforms.GetPosition(i) + transforms.GetRotation(i) * (scale * mesh.BoundingSphereCenter);
+        auto distance = std::max(glm::distance(center, cameraPosition), MinDistance);
+        auto pixelsPerUnit = _projectionScale * maxScale / distance;
+
+        auto level = static_cast<uint32_t>(lods[i]);
+        if (useImpostors)
+        {
+            auto projectedRadius = mesh.BoundingSphereRadius * pixelsPerUnit;
+            auto isImpostor = level == MeshLodImpostor
+                ? projectedRadius <= leaveImpostorRadius
+                : projectedRadius < enterImpostorRadius;
+            if (isImpostor)
+            {
+                lods[i] = MeshLodImpostor;
+                statistics.ImpostorCount++;
+                statistics.FullDetailTriangleCount += fullDetailTriangleCount;
+                statistics.RenderedTriangleCount += ImpostorTriangleCount;
+                continue;
+            }
+        }
+
+        level = std::min(level, coarsestLevel);
+        while (level > 0 && mesh.LodLevels[level].GeometricError * pixelsPerUnit > refineThreshold)
+        {
+            level--;
+        }
+        while (level < coarsestLevel && mesh.LodLevels[level + 1].GeometricError * pixelsPerUnit <= coarsenThreshold)
+        {
+            level++;
+        }
+
+        lods[i] = static_cast<uint8_t>(level);
+        statistics.LevelInstanceCounts[level]++;
+        statistics.FullDetailTriangleCount += fullDetailTriangleCount;
+        statistics.RenderedTriangleCount += mesh.LodLevels[level].GetTriangleCount();
+    }
+
+    return statistics;
+}
@@ -0,0 +1,301 @@
+#include <EngineCore/MeshSimplifier.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+    // Boundary edges get an extra plane perpendicular to their face so open borders do not shrink
+    constexpr double BoundaryPlaneWeight = 4.0;
+    // Reject collapses that rotate any remaining triangle's normal by more than ~78 degrees
+    constexpr double MinNormalDot = 0.2;
+
+    // Upper triangle of the symmetric 4x4 plane quadric
+    struct Quadric
+    {
+        std::array<double, 10> A = {};
+
+        void Add(const Quadric& other) noexcept
+        {
+            for (auto i = 0u; i < A.size(); i++)
+            {
+                A[i] += other.A[i];
+            }
+        }
+
+        double Evaluate(const glm::dvec3& p) const noexcept
+        {
+            return
+                A[0] * p.x * p.x + 2.0 * A[1] * p.x * p.y + 2.0 * A[2] * p.x * p.z + 2.0 * A[3] * p.x +
+                A[4] * p.y * p.y + 2.0 * A[5] * p.y * p.z + 2.0 * A[6] * p.y +
+                A[7] * p.z * p.z + 2.0 * A[8] * p.z +
+                A[9];
+        }
+
+        static Quadric FromPlane(const glm::dvec3& normal, double distance, double weight) noexcept
+        {
+            auto& n = normal;
+            auto d = distance;
+            return Quadric{{
+                weight * n.x * n.x, weight * n.x * n.y, weight * n.x * n.z, weight * n.x * d,
+                weight * n.y * n.y, weight * n.y * n.z, weight * n.y * d,
+                weight * n.z * n.z, weight * n.z * d,
+                weight * d * d
+            }};
+        }
+    };
+
+    struct Collapse
+    {
+        double Cost;
+        uint32_t From;
+        uint32_t To;
+        uint32_t FromVersion;
+        uint32_t ToVersion;
+
+        bool operator>(const Collapse& other) const noexcept
+        {
+            return Cost > other.Cost;
+        }
+    };
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b) noexcept
+    {
+        return a < b
+            ? (static_cast<uint64_t>(a) << 32) | b
+            : (static_cast<uint64_t>(b) << 32) | a;
+    }
+}
+
+MeshSimplifierResult SimplifyMesh(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    uint32_t targetIndexCount,
+    float maxError)
+{
+    auto vertexCount = static_cast<uint32_t>(positions.size());
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    triangles.reserve(indices.size() / 3);
+    for (auto i = 0u; i + 2 < indices.size(); i += 3)
+    {
+        assert(indices[i] < vertexCount && indices[i + 1] < vertexCount && indices[i + 2] < vertexCount);
+        if (indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i] != indices[i + 2])
+        {
+            triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+    std::unordered_map<uint64_t, uint32_t> edgeUseCounts;
+    edgeUseCounts.reserve(triangles.size() * 3);
+
+    for (auto t = 0u; t < triangles.size(); t++)
+    {
+        auto& triangle = triangles[t];
+        auto p0 = glm::dvec3(positions[triangle[0]]);
+        auto p1 = glm::dvec3(positions[triangle[1]]);
+        auto p2 = glm::dvec3(positions[triangle[2]]);
+        auto normal = glm::cross(p1 - p0, p2 - p0);
+        auto normalLength = glm::length(normal);
+        if (normalLength > 0.0)
+        {
+            normal /= normalLength;
+            auto quadric = Quadric::FromPlane(normal, -glm::dot(normal, p0), 1.0);
+            for (auto vertex : triangle)
+            {
+                quadrics[vertex].Add(quadric);
+            }
+        }
+
+        for (auto vertex : triangle)
+        {
+            vertexTriangles[vertex].push_back(t);
+        }
+        for (auto e = 0u; e < 3; e++)
+        {
+            edgeUseCounts[EdgeKey(triangle[e], triangle[(e + 1) % 3])]++;
+        }
+    }
+
+    for (auto& triangle : triangles)
+    {
+        auto p0 = glm::dvec3(positions[triangle[0]]);
+        auto p1 = glm::dvec3(positions[triangle[1]]);
+        auto p2 = glm::dvec3(positions[triangle[2]]);
+        auto faceNormal = glm::cross(p1 - p0, p2 - p0);
+        for (auto e = 0u; e < 3; e++)
+        {
+            auto a = triangle[e];
+            auto b = triangle[(e + 1) % 3];
+            if (edgeUseCounts[EdgeKey(a, b)] != 1)
+            {
+                continue;
+            }
+
+            auto pa = glm::dvec3(positions[a]);
+            auto pb = glm::dvec3(positions[b]);
+            auto boundaryNormal = glm::cross(pb - pa, faceNormal);
+            auto boundaryNormalLength = glm::length(boundaryNormal);
+            if (boundaryNormalLength > 0.0)
+            {
+                boundaryNormal /= boundaryNormalLength;
+                auto quadric = Quadric::FromPlane(boundaryNormal, -glm::dot(boundaryNormal, pa), BoundaryPlaneWeight);
+                quadrics[a].Add(quadric);
+                quadrics[b].Add(quadric);
+            }
+        }
+    }
+
+    std::vector<uint8_t> isTriangleAlive(triangles.size(), 1);
+    std::vector<uint8_t> isVertexRemoved(vertexCount, 0);
+    std::vector<uint32_t> vertexVersions(vertexCount, 0);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+
+    auto pushCollapse = [&](uint32_t a, uint32_t b)
+    {
+        auto quadric = quadrics[a];
+        quadric.Add(quadrics[b]);
+        auto costMovingAToB = std::max(quadric.Evaluate(glm::dvec3(positions[b])), 0.0);
+        auto costMovingBToA = std::max(quadric.Evaluate(glm::dvec3(positions[a])), 0.0);
+        if (costMovingAToB <= costMovingBToA)
+        {
+            collapses.push(Collapse{ costMovingAToB, a, b, vertexVersions[a], vertexVersions[b] });
+        }
+        else
+        {
+            collapses.push(Collapse{ costMovingBToA, b, a, vertexVersions[b], vertexVersions[a] });
+        }
+    };
+
+    for (auto& triangle : triangles)
+    {
+        for (auto e = 0u; e < 3; e++)
+        {
+            pushCollapse(triangle[e], triangle[(e + 1) % 3]);
+        }
+    }
+
+    auto isCollapseValid = [&](uint32_t from, uint32_t to)
+    {
+        auto target = glm::dvec3(positions[to]);
+        for (auto t : vertexTriangles[from])
+        {
+            auto& triangle = triangles[t];
+            if (!isTriangleAlive[t] || triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                continue;
+            }
+
+            std::array<glm::dvec3, 3> corners =
+            {
+                glm::dvec3(positions[triangle[0]]),
+                glm::dvec3(positions[triangle[1]]),
+                glm::dvec3(positions[triangle[2]])
+            };
+            auto oldNormal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            for (auto c = 0u; c < 3; c++)
+            {
+                if (triangle[c] == from)
+                {
+                    corners[c] = target;
+                }
+            }
+            auto newNormal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+            auto oldLength = glm::length(oldNormal);
+            auto newLength = glm::length(newNormal);
+            if (newLength <= 0.0 || (oldLength > 0.0 && glm::dot(oldNormal, newNormal) < MinNormalDot * oldLength * newLength))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto liveTriangleCount = static_cast<uint32_t>(triangles.size());
+    auto maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+    auto largestCost = 0.0;
+
+    while (!collapses.empty() && liveTriangleCount * 3 > targetIndexCount)
+    {
+        auto collapse = collapses.top();
+        collapses.pop();
+
+        if (collapse.Cost > maxCost)
+        {
+            break;
+        }
+
+        auto from = collapse.From;
+        auto to = collapse.To;
+        if (isVertexRemoved[from] || isVertexRemoved[to] ||
+            vertexVersions[from] != collapse.FromVersion ||
+            vertexVersions[to] != collapse.ToVersion)
+        {
+            continue;
+        }
+
+        if (!isCollapseValid(from, to))
+        {
+            continue;
+        }
+
+        for (auto t : vertexTriangles[from])
+        {
+            if (!isTriangleAlive[t])
+            {
+                continue;
+            }
+
+            auto& triangle = triangles[t];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                isTriangleAlive[t] = 0;
+                liveTriangleCount--;
+                continue;
+            }
+
+            std::replace(triangle.begin(), triangle.end(), from, to);
+            vertexTriangles[to].push_back(t);
+        }
+
+        quadrics[to].Add(quadrics[from]);
+        isVertexRemoved[from] = 1;
+        vertexTriangles[from].clear();
+        vertexVersions[to]++;
+        largestCost = std::max(largestCost, collapse.Cost);
+
+        auto& toTriangles = vertexTriangles[to];
+        std::erase_if(toTriangles, [&](uint32_t t) { return !isTriangleAlive[t]; });
+        for (auto t : toTriangles)
+        {
+            for (auto vertex : triangles[t])
+            {
+                if (vertex != to)
+                {
+                    pushCollapse(to, vertex);
+                }
+            }
+        }
+    }
+
+    MeshSimplifierResult result;
+    result.Indices.reserve(liveTriangleCount * 3);
+    for (auto t = 0u; t < triangles.size(); t++)
+    {
+        if (isTriangleAlive[t])
+        {
+            result.Indices.insert(result.Indices.end(), triangles[t].begin(), triangles[t].end());
+        }
+    }
+    result.GeometricError = static_cast<float>(std::sqrt(largestCost));
+    return result;
+}
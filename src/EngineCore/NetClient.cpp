@@ -0,0 +1,211 @@
+#include <EngineCore/NetClient.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <utility>
+
+void WriteNetServerInfo(BitWriter& writer, const NetServerInfo& serverInfo) noexcept
+{
+    writer.WriteVariableUnsigned(serverInfo.ClientId);
+    writer.WriteVariableUnsigned(serverInfo.TickRate);
+}
+
+NetServerInfo ReadNetServerInfo(BitReader& reader) noexcept
+{
+    NetServerInfo serverInfo;
+    serverInfo.ClientId = reader.ReadVariableUnsigned();
+    serverInfo.TickRate = reader.ReadVariableUnsigned();
+    return serverInfo;
+}
+
+void WriteNetClientFocus(BitWriter& writer, const NetClientFocus& focus) noexcept
+{
+    auto quantized = QuantizeEntityState(EntityState{ .Id = focus.EntityId, .Position = focus.Position, .Velocity = glm::vec3(0.0f) });
+    for (auto axis = 0u; axis < 3; axis++)
+    {
+        writer.WriteBits(quantized.Values[axis], SnapshotPositionBitCount);
+    }
+    writer.WriteVariableUnsigned(focus.EntityId + 1);
+}
+
+NetClientFocus ReadNetClientFocus(BitReader& reader) noexcept
+{
+    QuantizedEntityState quantized = { .Id = 0, .Values = {} };
+    for (auto axis = 0u; axis < 3; axis++)
+    {
+        quantized.Values[axis] = reader.ReadBits(SnapshotPositionBitCount);
+    }
+
+    NetClientFocus focus;
+    focus.Position = DequantizeEntityState(quantized).Position;
+    focus.EntityId = reader.ReadVariableUnsigned() - 1;
+    return focus;
+}
+
+std::expected<NetClient, std::string> NetClient::Create()
+{
+    auto socketResult = UdpSocket::Create(0);
+    if (!socketResult)
+    {
+        return std::unexpected(socketResult.error());
+    }
+
+    NetClient client;
+    client._socket = std::move(socketResult.value());
+    return client;
+}
+
+void NetClient::Connect(const NetAddress& serverAddress, double time)
+{
+    _serverAddress = serverAddress;
+    _state = NetClientState::Connecting;
+    _connection = NetConnection();
+    _hasSnapshot = false;
+    _snapshots = {};
+    SendPacket(NetPacketType::ConnectRequest, time);
+}
+
+void NetClient::Disconnect()
+{
+    if (_state != NetClientState::Disconnected)
+    {
+        SendPacket(NetPacketType::Disconnect, _lastSendTime);
+        _state = NetClientState::Disconnected;
+    }
+}
+
+void NetClient::Update(double time)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Network);
+
+    if (_state == NetClientState::Disconnected)
+    {
+        return;
+    }
+
+    std::array<std::byte, MaxNetPacketSize> packet;
+    NetAddress address;
+    auto hasReceivedData = false;
+    while (auto packetSize = _socket.Receive(packet, address))
+    {
+        if (address != _serverAddress)
+        {
+            continue;
+        }
+
+        _statistics.ReceivedByteCount += *packetSize;
+        ProcessPacket(std::span(packet.data(), *packetSize), time);
+        hasReceivedData = true;
+    }
+
+    if (_state == NetClientState::Connecting)
+    {
+        if (time - _lastSendTime >= ConnectRetryInterval)
+        {
+            SendPacket(NetPacketType::ConnectRequest, time);
+        }
+        return;
+    }
+
+    if (hasReceivedData || time - _lastSendTime >= KeepAliveInterval)
+    {
+        SendPacket(NetPacketType::Data, time);
+    }
+}
+
+void NetClient::ProcessPacket(std::span<const std::byte> packet, double time)
+{
+    BitReader reader(packet);
+    auto packetType = ReadNetPacketPrefix(reader);
+    if (!packetType)
+    {
+        return;
+    }
+
+    switch (*packetType)
+    {
+        case NetPacketType::ConnectAccept:
+            if (_state == NetClientState::Connecting)
+            {
+                _state = NetClientState::Connected;
+            }
+            break;
+        case NetPacketType::Disconnect:
+            _state = NetClientState::Disconnected;
+            break;
+        case NetPacketType::Data:
+            if (_state == NetClientState::Connecting)
+            {
+                // The accept got lost, data proves the server took us
+                _state = NetClientState::Connected;
+            }
+            if (_connection.ReadPacketHeader(reader, time))
+            {
+                if (reader.ReadBool())
+                {
+                    ReadSnapshot(reader);
+                }
+
+                std::vector<std::byte> message;
+                while (_connection.ReceiveReliable(message))
+                {
+                    BitReader messageReader(message);
+                    _serverInfo = ReadNetServerInfo(messageReader);
+                }
+            }
+            _connection.ClearAckedSequences();
+            break;
+        case NetPacketType::ConnectRequest:
+            break;
+    }
+}
+
+void NetClient::ReadSnapshot(BitReader& reader)
+{
+    auto snapshotId = static_cast<uint16_t>(reader.ReadBits(16));
+    auto hasBaseline = reader.ReadBool();
+    auto baselineId = static_cast<uint16_t>(hasBaseline ? reader.ReadBits(16) : 0);
+    if (reader.IsOverflowed() || (_hasSnapshot && !IsSequenceNewer(snapshotId, _latestSnapshotId)))
+    {
+        _statistics.DroppedSnapshotCount++;
+        return;
+    }
+
+    static const QuantizedSnapshot EmptyBaseline;
+    auto& baselineSnapshot = _snapshots[baselineId % SnapshotHistorySize];
+    if (hasBaseline && (!baselineSnapshot.IsValid || baselineSnapshot.Id != baselineId))
+    {
+        _statistics.DroppedSnapshotCount++;
+        return;
+    }
+
+    if (!DecodeSnapshotDelta(reader, hasBaseline ? baselineSnapshot.Entities : EmptyBaseline, _decodedSnapshot))
+    {
+        _statistics.DroppedSnapshotCount++;
+        return;
+    }
+
+    auto& snapshot = _snapshots[snapshotId % SnapshotHistorySize];
+    snapshot.Id = snapshotId;
+    snapshot.IsValid = true;
+    snapshot.Entities.swap(_decodedSnapshot);
+    _latestSnapshotId = snapshotId;
+    _hasSnapshot = true;
+    _statistics.ReceivedSnapshotCount++;
+}
+
+void NetClient::SendPacket(NetPacketType packetType, double time)
+{
+    std::array<std::byte, MaxNetPacketSize> packet;
+    BitWriter writer(packet);
+    WriteNetPacketPrefix(writer, packetType);
+    if (packetType == NetPacketType::Data)
+    {
+        _connection.WritePacketHeader(writer, time);
+        WriteNetClientFocus(writer, _focus);
+    }
+    writer.Flush();
+
+    _socket.Send(_serverAddress, std::span(packet.data(), writer.GetByteCount()));
+    _statistics.SentByteCount += writer.GetByteCount();
+    _lastSendTime = time;
+}
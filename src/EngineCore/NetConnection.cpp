@@ -0,0 +1,218 @@
+#include <EngineCore/NetConnection.hpp>
+
+#include <algorithm>
+
+void WriteNetPacketPrefix(BitWriter& writer, NetPacketType packetType) noexcept
+{
+    writer.WriteBits(NetProtocolId, 32);
+    writer.WriteBits(static_cast<uint32_t>(packetType), 2);
+}
+
+std::optional<NetPacketType> ReadNetPacketPrefix(BitReader& reader) noexcept
+{
+    auto protocolId = reader.ReadBits(32);
+    auto packetType = static_cast<NetPacketType>(reader.ReadBits(2));
+    if (reader.IsOverflowed() || protocolId != NetProtocolId)
+    {
+        return std::nullopt;
+    }
+
+    return packetType;
+}
+
+void NetConnection::SendReliable(std::span<const std::byte> message)
+{
+    auto messageSize = std::min<size_t>(message.size(), MaxReliableMessageSize);
+    _sendMessages.push_back(ReliableMessage
+    {
+        .Id = _nextSendMessageId++,
+        .Data = std::vector<std::byte>(message.begin(), message.begin() + messageSize)
+    });
+}
+
+bool NetConnection::ReceiveReliable(std::vector<std::byte>& message)
+{
+    auto& receivedMessage = _receivedMessages[_nextReceiveMessageId % MessageWindowSize];
+    if (!receivedMessage.IsValid || receivedMessage.Id != _nextReceiveMessageId)
+    {
+        return false;
+    }
+
+    message = std::move(receivedMessage.Data);
+    receivedMessage.IsValid = false;
+    _nextReceiveMessageId++;
+    return true;
+}
+
+uint16_t NetConnection::WritePacketHeader(BitWriter& writer, double time)
+{
+    auto sequence = _nextSequence++;
+
+    auto ackBits = uint32_t(0);
+    for (auto i = 0u; i < 32; i++)
+    {
+        auto ackedSequence = static_cast<uint16_t>(_remoteSequence - 1 - i);
+        if (_receivedSequences[ackedSequence % SequenceBufferSize] == ackedSequence + 1u)
+        {
+            ackBits |= 1u << i;
+        }
+    }
+
+    writer.WriteBits(sequence, 16);
+    writer.WriteBool(_hasReceivedPacket);
+    writer.WriteBits(_remoteSequence, 16);
+    writer.WriteBits(ackBits, 32);
+
+    auto& sentPacket = _sentPackets[sequence % SequenceBufferSize];
+    sentPacket = SentPacket{ .Sequence = sequence, .IsValid = true, .SendTime = time };
+
+    // Unacked messages go out again once they had time to be acked, oldest first
+    auto resendInterval = std::max(_statistics.RoundTripTime * 1.25, MinResendInterval);
+    std::array<ReliableMessage*, MaxMessagesPerPacket> dueMessages = {};
+    auto reliableByteCount = 0u;
+    for (auto& message : _sendMessages)
+    {
+        if (sentPacket.MessageCount == MaxMessagesPerPacket ||
+            static_cast<uint16_t>(message.Id - _sendMessages.front().Id) >= MessageWindowSize ||
+            reliableByteCount + message.Data.size() > MaxReliableBytesPerPacket)
+        {
+            break;
+        }
+
+        if (message.LastSendTime >= 0.0 && time - message.LastSendTime < resendInterval)
+        {
+            continue;
+        }
+
+        dueMessages[sentPacket.MessageCount] = &message;
+        sentPacket.MessageIds[sentPacket.MessageCount++] = message.Id;
+        reliableByteCount += static_cast<uint32_t>(message.Data.size());
+        message.LastSendTime = time;
+    }
+
+    writer.WriteBits(sentPacket.MessageCount, 4);
+    for (auto i = 0u; i < sentPacket.MessageCount; i++)
+    {
+        writer.WriteBits(dueMessages[i]->Id, 16);
+        writer.WriteVariableUnsigned(static_cast<uint32_t>(dueMessages[i]->Data.size()));
+        writer.WriteBytes(dueMessages[i]->Data);
+    }
+
+    _statistics.SentPacketCount++;
+    return sequence;
+}
+
+bool NetConnection::ReadPacketHeader(BitReader& reader, double time)
+{
+    auto sequence = static_cast<uint16_t>(reader.ReadBits(16));
+    auto hasAcks = reader.ReadBool();
+    auto ack = static_cast<uint16_t>(reader.ReadBits(16));
+    auto ackBits = reader.ReadBits(32);
+    auto messageCount = reader.ReadBits(4);
+    if (reader.IsOverflowed() || messageCount > MaxMessagesPerPacket)
+    {
+        return false;
+    }
+
+    // Duplicates and packets older than the received window are dropped as a whole
+    auto& receivedSequence = _receivedSequences[sequence % SequenceBufferSize];
+    if (receivedSequence == sequence + 1u ||
+        (_hasReceivedPacket && IsSequenceNewer(_remoteSequence, sequence) &&
+            static_cast<uint16_t>(_remoteSequence - sequence) >= SequenceBufferSize))
+    {
+        return false;
+    }
+
+    for (auto i = 0u; i < messageCount; i++)
+    {
+        auto messageId = static_cast<uint16_t>(reader.ReadBits(16));
+        auto messageSize = reader.ReadVariableUnsigned();
+        if (reader.IsOverflowed() || messageSize > MaxReliableMessageSize || messageSize * 8 > reader.GetRemainingBitCount())
+        {
+            return false;
+        }
+
+        std::vector<std::byte> messageData(messageSize);
+        reader.ReadBytes(messageData);
+
+        // Already delivered, or too far ahead for the window, it is sent again later either way
+        if (IsSequenceNewer(_nextReceiveMessageId, messageId) ||
+            static_cast<uint16_t>(messageId - _nextReceiveMessageId) >= MessageWindowSize)
+        {
+            continue;
+        }
+
+        auto& receivedMessage = _receivedMessages[messageId % MessageWindowSize];
+        if (!receivedMessage.IsValid)
+        {
+            receivedMessage = ReceivedMessage{ .Id = messageId, .IsValid = true, .Data = std::move(messageData) };
+        }
+    }
+
+    receivedSequence = sequence + 1u;
+    if (!_hasReceivedPacket || IsSequenceNewer(sequence, _remoteSequence))
+    {
+        // Slots skipped over belong to packets that never arrived, clear them so they are not acked
+        if (_hasReceivedPacket)
+        {
+            auto skippedCount = std::min<uint32_t>(static_cast<uint16_t>(sequence - _remoteSequence), SequenceBufferSize);
+            for (auto i = 1u; i < skippedCount; i++)
+            {
+                _receivedSequences[static_cast<uint16_t>(sequence - i) % SequenceBufferSize] = 0;
+            }
+        }
+        _remoteSequence = sequence;
+        _hasReceivedPacket = true;
+    }
+
+    // ack names the newest packet the peer got, ackBits the 32 before it
+    for (auto i = 0u; hasAcks && i <= 32; i++)
+    {
+        if (i == 0 || (ackBits & (1u << (i - 1))) != 0)
+        {
+            OnPacketAcked(static_cast<uint16_t>(ack - i), time);
+        }
+    }
+
+    // Packets that dropped out of the ack window unacked will never be acked
+    while (hasAcks && IsSequenceNewer(static_cast<uint16_t>(ack - 32), _nextLossCheckSequence))
+    {
+        auto& sentPacket = _sentPackets[_nextLossCheckSequence % SequenceBufferSize];
+        if (sentPacket.IsValid && sentPacket.Sequence == _nextLossCheckSequence && !sentPacket.IsAcked)
+        {
+            _statistics.LostPacketCount++;
+        }
+        _nextLossCheckSequence++;
+    }
+
+    _lastReceiveTime = time;
+    _statistics.ReceivedPacketCount++;
+    return true;
+}
+
+void NetConnection::OnPacketAcked(uint16_t sequence, double time)
+{
+    auto& sentPacket = _sentPackets[sequence % SequenceBufferSize];
+    if (!sentPacket.IsValid || sentPacket.Sequence != sequence || sentPacket.IsAcked)
+    {
+        return;
+    }
+
+    sentPacket.IsAcked = true;
+    _ackedSequences.push_back(sequence);
+    _statistics.AckedPacketCount++;
+
+    auto roundTripTime = time - sentPacket.SendTime;
+    _statistics.RoundTripTime = _statistics.AckedPacketCount == 1
+        ? roundTripTime
+        : _statistics.RoundTripTime + (roundTripTime - _statistics.RoundTripTime) * 0.1;
+
+    for (auto i = 0u; i < sentPacket.MessageCount; i++)
+    {
+        auto messageId = sentPacket.MessageIds[i];
+        std::erase_if(_sendMessages, [messageId](const ReliableMessage& message)
+        {
+            return message.Id == messageId;
+        });
+    }
+}
@@ -0,0 +1,214 @@
+#include <EngineCore/OctahedralImpostor.hpp>
+#include <EngineCore/FormatConversion.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    void GetFrameBasis(const glm::vec3& direction, glm::vec3& right, glm::vec3& up) noexcept
+    {
+        auto upHint = std::abs(direction.y) > 0.999f
+            ? glm::vec3(0.0f, 0.0f, 1.0f)
+            : glm::vec3(0.0f, 1.0f, 0.0f);
+        right = glm::normalize(glm::cross(upHint, direction));
+        up = glm::cross(direction, right);
+    }
+
+    uint32_t ToUnorm8(float value) noexcept
+    {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    uint32_t Snorm16ToUnorm8(uint32_t bits) noexcept
+    {
+        return ToUnorm8(static_cast<float>(static_cast<int16_t>(bits)) / 32767.0f * 0.5f + 0.5f);
+    }
+
+    // Twice the signed area of (a, b, p) in the xy plane, positive when counter clockwise
+    float EdgeFunction(const glm::vec3& a, const glm::vec3& b, float px, float py) noexcept
+    {
+        return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+    }
+
+    void BakeFrame(
+        OctahedralImpostorAtlas& atlas,
+        uint32_t frameX,
+        uint32_t frameY,
+        std::span<const glm::vec3> positions,
+        std::span<const uint32_t> indices,
+        std::span<const glm::vec3> faceNormals,
+        std::span<const uint32_t> faceNormalBits,
+        std::vector<glm::vec3>& projected,
+        std::vector<float>& depths)
+    {
+        auto resolution = atlas.FrameResolution;
+        auto direction = GetOctahedralImpostorFrameDirection(frameX, frameY, atlas.FramesPerSide);
+        glm::vec3 right;
+        glm::vec3 up;
+        GetFrameBasis(direction, right, up);
+
+        auto pixelsPerUnit = static_cast<float>(resolution) * 0.5f / atlas.Radius;
+        projected.resize(positions.size());
+        for (auto i = 0u; i < positions.size(); i++)
+        {
+            auto relative = positions[i] - atlas.Center;
+            projected[i] = glm::vec3(
+                (glm::dot(relative, right) + atlas.Radius) * pixelsPerUnit,
+                (glm::dot(relative, up) + atlas.Radius) * pixelsPerUnit,
+                (atlas.Radius - glm::dot(relative, direction)) / (2.0f * atlas.Radius));
+        }
+
+        depths.assign(resolution * resolution, std::numeric_limits<float>::max());
+        auto atlasSize = atlas.GetSize();
+        auto* frameTexels = atlas.Texels.data() + frameY * resolution * atlasSize + frameX * resolution;
+        auto maxPixel = static_cast<float>(resolution - 1);
+
+        for (auto i = 0u; i + 2 < indices.size(); i += 3)
+        {
+            if (glm::dot(faceNormals[i / 3], direction) <= 0.0f)
+            {
+                continue;
+            }
+
+            auto& v0 = projected[indices[i]];
+            auto& v1 = projected[indices[i + 1]];
+            auto& v2 = projected[indices[i + 2]];
+            auto area = EdgeFunction(v0, v1, v2.x, v2.y);
+            if (area <= 0.0f)
+            {
+                continue;
+            }
+
+            auto normalBits = faceNormalBits[i / 3];
+            auto minX = static_cast<uint32_t>(std::clamp(std::floor(std::min({ v0.x, v1.x, v2.x })), 0.0f, maxPixel));
+            auto maxX = static_cast<uint32_t>(std::clamp(std::ceil(std::max({ v0.x, v1.x, v2.x })), 0.0f, maxPixel));
+            auto minY = static_cast<uint32_t>(std::clamp(std::floor(std::min({ v0.y, v1.y, v2.y })), 0.0f, maxPixel));
+            auto maxY = static_cast<uint32_t>(std::clamp(std::ceil(std::max({ v0.y, v1.y, v2.y })), 0.0f, maxPixel));
+
+            for (auto y = minY; y <= maxY; y++)
+            {
+                for (auto x = minX; x <= maxX; x++)
+                {
+                    auto pixelX = static_cast<float>(x) + 0.5f;
+                    auto pixelY = static_cast<float>(y) + 0.5f;
+                    auto w0 = EdgeFunction(v1, v2, pixelX, pixelY);
+                    auto w1 = EdgeFunction(v2, v0, pixelX, pixelY);
+                    auto w2 = EdgeFunction(v0, v1, pixelX, pixelY);
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                    {
+                        continue;
+                    }
+
+                    auto depth = (w0 * v0.z + w1 * v1.z + w2 * v2.z) / area;
+                    auto& storedDepth = depths[y * resolution + x];
+                    if (depth >= storedDepth)
+                    {
+                        continue;
+                    }
+
+                    storedDepth = depth;
+                    frameTexels[y * atlasSize + x] = normalBits | (ToUnorm8(depth) << 16);
+                }
+            }
+        }
+    }
+}
+
+glm::vec2 OctahedralEncode(const glm::vec3& direction) noexcept
+{
+    auto n = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+    if (n.z >= 0.0f)
+    {
+        return glm::vec2(n.x, n.y);
+    }
+
+    return glm::vec2(
+        (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+glm::vec3 OctahedralDecode(const glm::vec2& encoded) noexcept
+{
+    auto n = glm::vec3(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    auto t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+glm::vec3 GetOctahedralImpostorFrameDirection(uint32_t frameX, uint32_t frameY, uint32_t framesPerSide) noexcept
+{
+    auto frameSize = 2.0f / static_cast<float>(framesPerSide);
+    return OctahedralDecode(glm::vec2(
+        (static_cast<float>(frameX) + 0.5f) * frameSize - 1.0f,
+        (static_cast<float>(frameY) + 0.5f) * frameSize - 1.0f));
+}
+
+OctahedralImpostorAtlas BakeOctahedralImpostor(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> indices,
+    const glm::vec3& center,
+    float radius,
+    const OctahedralImpostorBakeSettings& settings,
+    TaskScheduler* taskScheduler)
+{
+    OctahedralImpostorAtlas atlas;
+    atlas.FramesPerSide = settings.FramesPerSide;
+    atlas.FrameResolution = settings.FrameResolution;
+    atlas.Center = center;
+    atlas.Radius = radius;
+    atlas.Texels.assign(atlas.GetSize() * atlas.GetSize(), 0u);
+
+    // Face normals are the same in every frame, so they are encoded once in bulk. Degenerate faces
+    // encode to garbage but never face a frame's direction
+    auto triangleCount = indices.size() / 3;
+    std::vector<glm::vec3> faceNormals(triangleCount);
+    for (auto triangle = size_t(0); triangle < triangleCount; triangle++)
+    {
+        auto& p0 = positions[indices[triangle * 3]];
+        faceNormals[triangle] = glm::cross(positions[indices[triangle * 3 + 1]] - p0, positions[indices[triangle * 3 + 2]] - p0);
+    }
+    std::vector<uint32_t> faceNormalBits(triangleCount);
+    EncodeOctahedralNormals(faceNormals, faceNormalBits);
+    for (auto& normalBits : faceNormalBits)
+    {
+        normalBits = Snorm16ToUnorm8(normalBits & 0xFFFFu) | (Snorm16ToUnorm8(normalBits >> 16) << 8) | (255u << 24);
+    }
+
+    auto frameCount = atlas.FramesPerSide * atlas.FramesPerSide;
+    auto bakeFrames = [&](uint32_t begin, uint32_t end)
+    {
+        std::vector<glm::vec3> projected;
+        std::vector<float> depths;
+        for (auto frame = begin; frame < end; frame++)
+        {
+            BakeFrame(
+                atlas,
+                frame % atlas.FramesPerSide,
+                frame / atlas.FramesPerSide,
+                positions,
+                indices,
+                faceNormals,
+                faceNormalBits,
+                projected,
+                depths);
+        }
+    };
+
+    if (taskScheduler == nullptr)
+    {
+        bakeFrames(0, frameCount);
+    }
+    else
+    {
+        taskScheduler->ParallelFor(frameCount, 1, bakeFrames);
+    }
+
+    return atlas;
+}
@@ -0,0 +1,340 @@
+#include <EngineCore/PatchedConics.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace
+{
+    constexpr uint32_t BodiesPerTask = 1024;
+    // A body moving from a moon to the star crosses the planet's sphere on the way, all in one update
+    constexpr uint32_t MaxHandOverCount = 4;
+    constexpr uint32_t MaxKeplerIterationCount = 64;
+
+    // The orbital elements use the usual frame with north along z, the engine has y up
+    glm::dvec3 ToEngineFrame(const glm::dvec3& value) noexcept
+    {
+        return glm::dvec3(value.x, value.z, -value.y);
+    }
+
+    glm::dvec3 FromEngineFrame(const glm::dvec3& value) noexcept
+    {
+        return glm::dvec3(value.x, -value.z, value.y);
+    }
+
+    // Eccentric anomaly E of E - e sin E = M
+    double SolveEllipticKepler(double meanAnomaly, double eccentricity) noexcept
+    {
+        meanAnomaly = std::remainder(meanAnomaly, 2.0 * std::numbers::pi);
+        // Danby's start converges for every eccentricity below 1
+        auto anomaly = meanAnomaly + 0.85 * eccentricity * (std::sin(meanAnomaly) < 0.0 ? -1.0 : 1.0);
+        for (uint32_t i = 0; i < MaxKeplerIterationCount; i++)
+        {
+            auto delta = (anomaly - eccentricity * std::sin(anomaly) - meanAnomaly) / (1.0 - eccentricity * std::cos(anomaly));
+            anomaly -= delta;
+            if (std::abs(delta) < 1.0e-14)
+            {
+                break;
+            }
+        }
+        return anomaly;
+    }
+
+    // Hyperbolic anomaly H of e sinh H - H = M
+    double SolveHyperbolicKepler(double meanAnomaly, double eccentricity) noexcept
+    {
+        auto anomaly = std::copysign(std::log(2.0 * std::abs(meanAnomaly) / eccentricity + 1.8), meanAnomaly);
+        for (uint32_t i = 0; i < MaxKeplerIterationCount; i++)
+        {
+            auto delta = (eccentricity * std::sinh(anomaly) - anomaly - meanAnomaly) / (eccentricity * std::cosh(anomaly) - 1.0);
+            anomaly -= delta;
+            if (std::abs(delta) < 1.0e-14 * (1.0 + std::abs(anomaly)))
+            {
+                break;
+            }
+        }
+        return anomaly;
+    }
+
+    // Periapsis and the direction 90 degrees ahead of it in the engine frame, the part of evaluating
+    // an orbit that only changes with the orbit
+    struct OrbitBasis
+    {
+        glm::dvec3 Periapsis;
+        glm::dvec3 Normal;
+    };
+
+    OrbitBasis ComputeOrbitBasis(const KeplerOrbit& orbit) noexcept
+    {
+        auto cosNode = std::cos(orbit.LongitudeOfAscendingNode);
+        auto sinNode = std::sin(orbit.LongitudeOfAscendingNode);
+        auto cosPeriapsis = std::cos(orbit.ArgumentOfPeriapsis);
+        auto sinPeriapsis = std::sin(orbit.ArgumentOfPeriapsis);
+        auto cosInclination = std::cos(orbit.Inclination);
+        auto sinInclination = std::sin(orbit.Inclination);
+        glm::dvec3 periapsisDirection(
+            cosNode * cosPeriapsis - sinNode * sinPeriapsis * cosInclination,
+            sinNode * cosPeriapsis + cosNode * sinPeriapsis * cosInclination,
+            sinPeriapsis * sinInclination);
+        glm::dvec3 normalDirection(
+            -cosNode * sinPeriapsis - sinNode * cosPeriapsis * cosInclination,
+            -sinNode * sinPeriapsis + cosNode * cosPeriapsis * cosInclination,
+            cosPeriapsis * sinInclination);
+
+        return OrbitBasis
+        {
+            .Periapsis = ToEngineFrame(periapsisDirection),
+            .Normal = ToEngineFrame(normalDirection)
+        };
+    }
+
+    OrbitState EvaluateKeplerOrbit(const KeplerOrbit& orbit, const OrbitBasis& basis, double gravitationalParameter, double time) noexcept
+    {
+        auto eccentricity = orbit.Eccentricity;
+        auto elapsed = time - orbit.Epoch;
+
+        // In the orbital plane, x towards periapsis
+        double x;
+        double y;
+        double velocityX;
+        double velocityY;
+        if (eccentricity < 1.0)
+        {
+            auto a = orbit.SemiMajorAxis;
+            auto meanMotion = std::sqrt(gravitationalParameter / (a * a * a));
+            auto anomaly = SolveEllipticKepler(orbit.MeanAnomalyAtEpoch + meanMotion * elapsed, eccentricity);
+            auto cosine = std::cos(anomaly);
+            auto sine = std::sin(anomaly);
+            auto semiMinorFactor = std::sqrt(1.0 - eccentricity * eccentricity);
+            auto speedFactor = std::sqrt(gravitationalParameter * a) / (a * (1.0 - eccentricity * cosine));
+            x = a * (cosine - eccentricity);
+            y = a * semiMinorFactor * sine;
+            velocityX = -speedFactor * sine;
+            velocityY = speedFactor * semiMinorFactor * cosine;
+        }
+        else
+        {
+            auto a = -orbit.SemiMajorAxis;
+            auto meanMotion = std::sqrt(gravitationalParameter / (a * a * a));
+            auto anomaly = SolveHyperbolicKepler(orbit.MeanAnomalyAtEpoch + meanMotion * elapsed, eccentricity);
+            auto cosine = std::cosh(anomaly);
+            auto sine = std::sinh(anomaly);
+            auto semiMinorFactor = std::sqrt(eccentricity * eccentricity - 1.0);
+            auto speedFactor = std::sqrt(gravitationalParameter * a) / (a * (eccentricity * cosine - 1.0));
+            x = a * (eccentricity - cosine);
+            y = a * semiMinorFactor * sine;
+            velocityX = -speedFactor * sine;
+            velocityY = speedFactor * semiMinorFactor * cosine;
+        }
+
+        return OrbitState
+        {
+            .Position = basis.Periapsis * x + basis.Normal * y,
+            .Velocity = basis.Periapsis * velocityX + basis.Normal * velocityY
+        };
+    }
+}
+
+OrbitState EvaluateKeplerOrbit(const KeplerOrbit& orbit, double gravitationalParameter, double time) noexcept
+{
+    return EvaluateKeplerOrbit(orbit, ComputeOrbitBasis(orbit), gravitationalParameter, time);
+}
+
+KeplerOrbit ComputeKeplerOrbit(const OrbitState& state, double gravitationalParameter, double time) noexcept
+{
+    auto position = FromEngineFrame(state.Position);
+    auto velocity = FromEngineFrame(state.Velocity);
+    auto distance = glm::length(position);
+    auto speedSquared = glm::dot(velocity, velocity);
+
+    auto angularMomentum = glm::cross(position, velocity);
+    auto angularMomentumLength = glm::length(angularMomentum);
+    auto normal = angularMomentum / angularMomentumLength;
+    auto eccentricityVector = ((speedSquared - gravitationalParameter / distance) * position - glm::dot(position, velocity) * velocity) / gravitationalParameter;
+    auto eccentricity = glm::length(eccentricityVector);
+
+    // Equatorial orbits measure from x instead of the node, circular ones from the node instead of periapsis
+    glm::dvec3 node(-angularMomentum.y, angularMomentum.x, 0.0);
+    auto nodeLength = glm::length(node);
+    auto nodeDirection = nodeLength > 1.0e-12 * angularMomentumLength ? node / nodeLength : glm::dvec3(1.0, 0.0, 0.0);
+    auto periapsisDirection = eccentricity > 1.0e-12 ? eccentricityVector / eccentricity : nodeDirection;
+    auto trueAnomaly = std::atan2(glm::dot(glm::cross(periapsisDirection, position), normal), glm::dot(periapsisDirection, position));
+
+    double meanAnomaly;
+    if (eccentricity < 1.0)
+    {
+        auto anomaly = 2.0 * std::atan2(std::sqrt(1.0 - eccentricity) * std::sin(0.5 * trueAnomaly), std::sqrt(1.0 + eccentricity) * std::cos(0.5 * trueAnomaly));
+        meanAnomaly = anomaly - eccentricity * std::sin(anomaly);
+    }
+    else
+    {
+        auto anomaly = 2.0 * std::atanh(std::sqrt((eccentricity - 1.0) / (eccentricity + 1.0)) * std::tan(0.5 * trueAnomaly));
+        meanAnomaly = eccentricity * std::sinh(anomaly) - anomaly;
+    }
+
+    return KeplerOrbit
+    {
+        .SemiMajorAxis = -gravitationalParameter / (speedSquared - 2.0 * gravitationalParameter / distance),
+        .Eccentricity = eccentricity,
+        .Inclination = std::acos(std::clamp(normal.z, -1.0, 1.0)),
+        .LongitudeOfAscendingNode = std::atan2(nodeDirection.y, nodeDirection.x),
+        .ArgumentOfPeriapsis = std::atan2(glm::dot(glm::cross(nodeDirection, periapsisDirection), normal), glm::dot(nodeDirection, periapsisDirection)),
+        .MeanAnomalyAtEpoch = meanAnomaly,
+        .Epoch = time
+    };
+}
+
+PatchedConics::PatchedConics(double gravitationalConstant)
+    : _gravitationalConstant(gravitationalConstant)
+{
+}
+
+uint32_t PatchedConics::AddRoot(const glm::dvec3& position, double mass)
+{
+    auto body = GetCount();
+    _bodies.push_back(Body
+    {
+        .Orbit = {},
+        .Parent = InvalidPatchedConicBody,
+        .Mass = mass,
+        .SphereOfInfluenceRadius = std::numeric_limits<double>::infinity(),
+        .Position = position,
+        .Velocity = glm::dvec3(0.0),
+        .PeriapsisDirection = glm::dvec3(0.0),
+        .NormalDirection = glm::dvec3(0.0)
+    });
+    _massiveBodies.push_back(body);
+    return body;
+}
+
+uint32_t PatchedConics::AddBody(uint32_t parent, const KeplerOrbit& orbit, double mass)
+{
+    assert(parent < GetCount() && _bodies[parent].Mass > 0.0);
+
+    // Laplace's sphere of influence
+    auto sphereOfInfluenceRadius = mass > 0.0
+        ? std::abs(orbit.SemiMajorAxis) * std::pow(mass / _bodies[parent].Mass, 0.4)
+        : 0.0;
+
+    auto basis = ComputeOrbitBasis(orbit);
+    auto body = GetCount();
+    _bodies.push_back(Body
+    {
+        .Orbit = orbit,
+        .Parent = parent,
+        .Mass = mass,
+        .SphereOfInfluenceRadius = sphereOfInfluenceRadius,
+        .Position = glm::dvec3(0.0),
+        .Velocity = glm::dvec3(0.0),
+        .PeriapsisDirection = basis.Periapsis,
+        .NormalDirection = basis.Normal
+    });
+    if (mass > 0.0)
+    {
+        _massiveBodies.push_back(body);
+    }
+    else
+    {
+        _masslessBodies.push_back(body);
+    }
+    return body;
+}
+
+void PatchedConics::Clear()
+{
+    _bodies.clear();
+    _massiveBodies.clear();
+    _masslessBodies.clear();
+    _attractors.clear();
+}
+
+uint32_t PatchedConics::Update(double time, TaskScheduler& taskScheduler)
+{
+    // Few and in parent order, these go one after the other
+    _attractors.resize(_massiveBodies.size());
+    for (size_t i = 0; i < _massiveBodies.size(); i++)
+    {
+        auto& body = _bodies[_massiveBodies[i]];
+        if (body.Parent != InvalidPatchedConicBody)
+        {
+            UpdateBody(body, time);
+        }
+        _attractors[i] = GravityAttractor{ .Position = body.Position, .Mass = body.Mass };
+    }
+
+    std::atomic<uint32_t> handOverCount = 0;
+    taskScheduler.ParallelFor(static_cast<uint32_t>(_masslessBodies.size()), BodiesPerTask, [&](uint32_t begin, uint32_t end)
+    {
+        uint32_t rangeHandOverCount = 0;
+        for (auto i = begin; i < end; i++)
+        {
+            auto& body = _bodies[_masslessBodies[i]];
+            UpdateBody(body, time);
+            for (uint32_t handOver = 0; handOver < MaxHandOverCount && HandOver(body, time); handOver++)
+            {
+                rangeHandOverCount++;
+            }
+        }
+        handOverCount.fetch_add(rangeHandOverCount, std::memory_order_relaxed);
+    });
+    return handOverCount.load(std::memory_order_relaxed);
+}
+
+void PatchedConics::UpdateBody(Body& body, double time) const noexcept
+{
+    const auto& parent = _bodies[body.Parent];
+    auto state = EvaluateKeplerOrbit(
+        body.Orbit,
+        OrbitBasis{ .Periapsis = body.PeriapsisDirection, .Normal = body.NormalDirection },
+        _gravitationalConstant * parent.Mass,
+        time);
+    body.Position = parent.Position + state.Position;
+    body.Velocity = parent.Velocity + state.Velocity;
+}
+
+bool PatchedConics::HandOver(Body& body, double time) const noexcept
+{
+    const auto& parent = _bodies[body.Parent];
+    auto offset = body.Position - parent.Position;
+    auto newParent = InvalidPatchedConicBody;
+    if (glm::dot(offset, offset) > parent.SphereOfInfluenceRadius * parent.SphereOfInfluenceRadius)
+    {
+        newParent = parent.Parent;
+    }
+    else
+    {
+        for (auto massiveBody : _massiveBodies)
+        {
+            const auto& child = _bodies[massiveBody];
+            auto childOffset = body.Position - child.Position;
+            if (child.Parent == body.Parent &&
+                glm::dot(childOffset, childOffset) < child.SphereOfInfluenceRadius * child.SphereOfInfluenceRadius)
+            {
+                newParent = massiveBody;
+                break;
+            }
+        }
+    }
+
+    if (newParent == InvalidPatchedConicBody)
+    {
+        return false;
+    }
+
+    const auto& newParentBody = _bodies[newParent];
+    body.Orbit = ComputeKeplerOrbit(
+        OrbitState{ .Position = body.Position - newParentBody.Position, .Velocity = body.Velocity - newParentBody.Velocity },
+        _gravitationalConstant * newParentBody.Mass,
+        time);
+    auto basis = ComputeOrbitBasis(body.Orbit);
+    body.PeriapsisDirection = basis.Periapsis;
+    body.NormalDirection = basis.Normal;
+    body.Parent = newParent;
+    return true;
+}
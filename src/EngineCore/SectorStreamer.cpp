@@ -0,0 +1,310 @@
+#include <EngineCore/SectorStreamer.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <glm/geometric.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace
+{
+    float GetSectorDistance(const SectorCoordinate& sector, const WorldPosition& position, float sectorSize) noexcept
+    {
+        auto sectorCenter = GetRelativeSectorOrigin(sector, position, sectorSize) + glm::vec3(sectorSize * 0.5f);
+        return glm::length(sectorCenter) / sectorSize;
+    }
+}
+
+SectorStreamer::SectorStreamer(SectorStreamingHandler& handler, const SectorStreamerSettings& settings)
+    : _handler(handler),
+      _settings(settings)
+{
+    auto loaderThreadCount = std::max(settings.LoaderThreadCount, 1u);
+    _loaders.reserve(loaderThreadCount);
+    for (auto i = 0u; i < loaderThreadCount; i++)
+    {
+        _loaders.emplace_back([this](std::stop_token stopToken)
+        {
+            LoaderLoop(stopToken);
+        });
+    }
+}
+
+SectorStreamer::~SectorStreamer()
+{
+    for (auto& loader : _loaders)
+    {
+        loader.request_stop();
+    }
+    _loadRequested.notify_all();
+    _loaders.clear();
+
+    UnloadAll();
+}
+
+SectorStreamerStatistics SectorStreamer::Update(
+    const WorldPosition& cameraPosition,
+    const glm::vec3& cameraVelocity,
+    std::pmr::memory_resource* scratchMemory)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Streaming);
+
+    CollectLoadResults();
+
+    SectorStreamerStatistics statistics;
+
+    auto sectorSize = _settings.SectorSize;
+    auto predictedPosition = OffsetWorldPosition(cameraPosition, cameraVelocity * _settings.PrefetchSeconds, sectorSize);
+    auto getPriority = [&](const SectorCoordinate& sector)
+    {
+        return std::min(
+            GetSectorDistance(sector, cameraPosition, sectorSize),
+            GetSectorDistance(sector, predictedPosition, sectorSize));
+    };
+
+    std::pmr::vector<SectorCoordinate> sectorsToUnload(scratchMemory);
+    for (auto& [sector, entry] : _sectors)
+    {
+        entry.Priority = getPriority(sector);
+        if (entry.Priority > _settings.UnloadRadius)
+        {
+            sectorsToUnload.push_back(sector);
+        }
+    }
+    for (auto& sector : sectorsToUnload)
+    {
+        Unload(sector, _sectors[sector]);
+        _sectors.erase(sector);
+        statistics.UnloadedSectorCount++;
+    }
+
+    struct Candidate
+    {
+        float Priority;
+        SectorCoordinate Sector;
+    };
+
+    std::pmr::vector<Candidate> candidates(scratchMemory);
+    std::pmr::unordered_set<SectorCoordinate, SectorCoordinateHasher> candidateSectors(scratchMemory);
+    auto searchRadius = static_cast<int64_t>(std::ceil(_settings.LoadRadius));
+    for (auto& searchCenter : { cameraPosition.Sector, predictedPosition.Sector })
+    {
+        for (auto z = -searchRadius; z <= searchRadius; z++)
+        {
+            for (auto y = -searchRadius; y <= searchRadius; y++)
+            {
+                for (auto x = -searchRadius; x <= searchRadius; x++)
+                {
+                    auto sector = SectorCoordinate{ searchCenter.X + x, searchCenter.Y + y, searchCenter.Z + z };
+                    if (_sectors.contains(sector) || candidateSectors.contains(sector))
+                    {
+                        continue;
+                    }
+
+                    auto priority = getPriority(sector);
+                    if (priority <= _settings.LoadRadius)
+                    {
+                        candidates.push_back(Candidate{ priority, sector });
+                        candidateSectors.insert(sector);
+                    }
+                }
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs)
+    {
+        return lhs.Priority < rhs.Priority;
+    });
+
+    auto pendingLoadCount = static_cast<uint32_t>(std::count_if(_sectors.begin(), _sectors.end(), [](const auto& sector)
+    {
+        return sector.second.State == SectorState::Requested;
+    }));
+
+    for (auto& candidate : candidates)
+    {
+        if (pendingLoadCount >= _settings.MaxPendingLoadCount)
+        {
+            break;
+        }
+
+        if (_sectors.size() >= _settings.MaxSectorCount)
+        {
+            // Full, only make room when the candidate is nearer than the farthest sector we hold
+            auto farthest = std::max_element(_sectors.begin(), _sectors.end(), [](const auto& lhs, const auto& rhs)
+            {
+                return lhs.second.Priority < rhs.second.Priority;
+            });
+            if (farthest->second.Priority <= candidate.Priority)
+            {
+                break;
+            }
+
+            Unload(farthest->first, farthest->second);
+            _sectors.erase(farthest);
+            statistics.UnloadedSectorCount++;
+        }
+
+        RequestLoad(candidate.Sector, candidate.Priority);
+        pendingLoadCount++;
+    }
+
+    std::pmr::vector<Candidate> uploads(scratchMemory);
+    for (auto& [sector, entry] : _sectors)
+    {
+        if (entry.State == SectorState::Loaded || entry.State == SectorState::Uploading)
+        {
+            uploads.push_back(Candidate{ entry.Priority, sector });
+        }
+    }
+    std::sort(uploads.begin(), uploads.end(), [](const Candidate& lhs, const Candidate& rhs)
+    {
+        return lhs.Priority < rhs.Priority;
+    });
+
+    auto uploadByteBudget = _settings.UploadByteBudgetPerFrame;
+    for (auto& upload : uploads)
+    {
+        auto& entry = _sectors[upload.Sector];
+        auto uploadResult = _handler.UploadSector(upload.Sector, *entry.Content, uploadByteBudget);
+
+        auto uploadedByteCount = std::min(uploadResult.UploadedByteCount, uploadByteBudget);
+        uploadByteBudget -= uploadedByteCount;
+        statistics.UploadedByteCount += uploadedByteCount;
+
+        if (!uploadResult.IsComplete)
+        {
+            // The rest did not fit, carry on with this sector next frame
+            entry.State = SectorState::Uploading;
+            if (uploadResult.IsWaiting && uploadByteBudget > 0)
+            {
+                continue;
+            }
+            break;
+        }
+
+        entry.State = SectorState::Resident;
+        statistics.LoadedSectorCount++;
+        if (uploadByteBudget == 0)
+        {
+            break;
+        }
+    }
+
+    for (auto& [sector, entry] : _sectors)
+    {
+        switch (entry.State)
+        {
+            case SectorState::Requested: statistics.PendingLoadCount++; break;
+            case SectorState::Loaded:
+            case SectorState::Uploading: statistics.PendingUploadCount++; break;
+            case SectorState::Resident: statistics.ResidentSectorCount++; break;
+            case SectorState::Failed: break;
+        }
+    }
+
+    return statistics;
+}
+
+void SectorStreamer::UnloadAll()
+{
+    for (auto& [sector, entry] : _sectors)
+    {
+        Unload(sector, entry);
+    }
+    _sectors.clear();
+}
+
+void SectorStreamer::CollectLoadResults()
+{
+    // Swapping back and forth keeps both vectors' capacity, the loader thread appends without allocating
+    {
+        std::scoped_lock lock(_loadMutex);
+        _collectedLoadResults.swap(_loadResults);
+    }
+
+    for (auto& loadResult : _collectedLoadResults)
+    {
+        // Sectors unloaded while their load was running are dropped here, before anything reached the GPU
+        auto entry = _sectors.find(loadResult.Sector);
+        if (entry == _sectors.end() || entry->second.State != SectorState::Requested)
+        {
+            continue;
+        }
+
+        if (!loadResult.Content)
+        {
+            // Keep the entry so the sector is not retried every frame while it stays in range
+            spdlog::error("SectorStreamer: Loading sector {}_{}_{} failed. {}",
+                loadResult.Sector.X,
+                loadResult.Sector.Y,
+                loadResult.Sector.Z,
+                loadResult.Content.error());
+            entry->second.State = SectorState::Failed;
+            continue;
+        }
+
+        entry->second.Content = std::move(loadResult.Content.value());
+        entry->second.State = SectorState::Loaded;
+    }
+    _collectedLoadResults.clear();
+}
+
+void SectorStreamer::RequestLoad(const SectorCoordinate& sector, float priority)
+{
+    _sectors[sector] = SectorEntry{ SectorState::Requested, nullptr, priority };
+    {
+        std::scoped_lock lock(_loadMutex);
+        _loadRequests.push_back(sector);
+    }
+    _loadRequested.notify_one();
+}
+
+void SectorStreamer::Unload(const SectorCoordinate& sector, SectorEntry& entry)
+{
+    switch (entry.State)
+    {
+        case SectorState::Requested:
+        {
+            // Still queued is cheap to cancel, an in flight load gets dropped in CollectLoadResults
+            std::scoped_lock lock(_loadMutex);
+            std::erase(_loadRequests, sector);
+            break;
+        }
+        case SectorState::Uploading:
+        case SectorState::Resident:
+            _handler.UnloadSector(sector, *entry.Content);
+            break;
+        case SectorState::Loaded:
+        case SectorState::Failed:
+            break;
+    }
+    entry.Content.reset();
+}
+
+void SectorStreamer::LoaderLoop(std::stop_token stopToken)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Streaming);
+
+    while (!stopToken.stop_requested())
+    {
+        SectorCoordinate sector;
+        {
+            std::unique_lock lock(_loadMutex);
+            if (!_loadRequested.wait(lock, stopToken, [this]() { return !_loadRequests.empty(); }))
+            {
+                return;
+            }
+            sector = _loadRequests.front();
+            _loadRequests.pop_front();
+        }
+
+        auto content = _handler.LoadSector(sector);
+        {
+            std::scoped_lock lock(_loadMutex);
+            _loadResults.push_back(LoadResult{ sector, std::move(content) });
+        }
+    }
+}
@@ -0,0 +1,335 @@
+#include <EngineCore/Snapshot.hpp>
+#include <EngineCore/BitStream.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    constexpr std::array<uint32_t, 6> ValueBitCounts =
+    {
+        SnapshotPositionBitCount, SnapshotPositionBitCount, SnapshotPositionBitCount,
+        SnapshotVelocityBitCount, SnapshotVelocityBitCount, SnapshotVelocityBitCount
+    };
+
+    uint32_t Quantize(float value, float range, uint32_t bitCount) noexcept
+    {
+        auto maxValue = static_cast<float>((1u << bitCount) - 1);
+        auto normalized = std::clamp((value + range) / (2.0f * range), 0.0f, 1.0f);
+        return static_cast<uint32_t>(std::lround(normalized * maxValue));
+    }
+
+    float Dequantize(uint32_t value, float range, uint32_t bitCount) noexcept
+    {
+        auto maxValue = static_cast<float>((1u << bitCount) - 1);
+        return static_cast<float>(value) / maxValue * 2.0f * range - range;
+    }
+
+    // Mirrors BitWriter::WriteVariableUnsigned and WriteVariableSigned
+    uint32_t GetVariableSignedBitCount(int32_t value) noexcept
+    {
+        auto zigZag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        auto bitWidth = static_cast<uint32_t>(std::bit_width(zigZag));
+        return 2 + (bitWidth <= 4 ? 4 : bitWidth <= 8 ? 8 : bitWidth <= 16 ? 16 : 32);
+    }
+
+    // Binary search over the sorted range [first, last)
+    template <typename TIterator>
+    TIterator FindEntity(TIterator first, TIterator last, uint32_t id) noexcept
+    {
+        auto entity = std::lower_bound(first, last, id, [](const QuantizedEntityState& entityState, uint32_t entityId)
+        {
+            return entityState.Id < entityId;
+        });
+        return entity != last && entity->Id == id ? entity : last;
+    }
+
+    // Entities from sortedCount on were appended unordered, the few of them get sorted and merged in
+    // backwards from a scratch copy, which unlike std::inplace_merge needs no heap buffer
+    void SortAppendedById(QuantizedSnapshot& snapshot, size_t sortedCount)
+    {
+        auto isLess = [](const QuantizedEntityState& lhs, const QuantizedEntityState& rhs)
+        {
+            return lhs.Id < rhs.Id;
+        };
+
+        auto& arena = GetThreadArena();
+        ArenaScope arenaScope(arena);
+        std::pmr::vector<QuantizedEntityState> appended(snapshot.begin() + static_cast<std::ptrdiff_t>(sortedCount), snapshot.end(), &arena);
+        std::sort(appended.begin(), appended.end(), isLess);
+
+        auto target = snapshot.rbegin();
+        auto sorted = snapshot.rbegin() + static_cast<std::ptrdiff_t>(appended.size());
+        auto sortedEnd = snapshot.rend();
+        for (auto entity = appended.rbegin(); entity != appended.rend(); ++target)
+        {
+            *target = sorted != sortedEnd && isLess(*entity, *sorted) ? *sorted++ : *entity++;
+        }
+    }
+}
+
+QuantizedEntityState QuantizeEntityState(const EntityState& entityState) noexcept
+{
+    return QuantizedEntityState
+    {
+        .Id = entityState.Id,
+        .Values =
+        {
+            Quantize(entityState.Position.x, SnapshotPositionRange, SnapshotPositionBitCount),
+            Quantize(entityState.Position.y, SnapshotPositionRange, SnapshotPositionBitCount),
+            Quantize(entityState.Position.z, SnapshotPositionRange, SnapshotPositionBitCount),
+            Quantize(entityState.Velocity.x, SnapshotVelocityRange, SnapshotVelocityBitCount),
+            Quantize(entityState.Velocity.y, SnapshotVelocityRange, SnapshotVelocityBitCount),
+            Quantize(entityState.Velocity.z, SnapshotVelocityRange, SnapshotVelocityBitCount)
+        }
+    };
+}
+
+EntityState DequantizeEntityState(const QuantizedEntityState& quantizedEntityState) noexcept
+{
+    auto& values = quantizedEntityState.Values;
+    return EntityState
+    {
+        .Id = quantizedEntityState.Id,
+        .Position = glm::vec3(
+            Dequantize(values[0], SnapshotPositionRange, SnapshotPositionBitCount),
+            Dequantize(values[1], SnapshotPositionRange, SnapshotPositionBitCount),
+            Dequantize(values[2], SnapshotPositionRange, SnapshotPositionBitCount)),
+        .Velocity = glm::vec3(
+            Dequantize(values[3], SnapshotVelocityRange, SnapshotVelocityBitCount),
+            Dequantize(values[4], SnapshotVelocityRange, SnapshotVelocityBitCount),
+            Dequantize(values[5], SnapshotVelocityRange, SnapshotVelocityBitCount))
+    };
+}
+
+SnapshotEncodeResult EncodeSnapshotDelta(
+    BitWriter& writer,
+    const QuantizedSnapshot& baseline,
+    const QuantizedSnapshot& current,
+    uint32_t maxBitCount,
+    std::span<const uint32_t> priorityOrder,
+    QuantizedSnapshot& reconstructed)
+{
+    SnapshotEncodeResult result;
+    auto bitLimit = writer.GetBitCount() + std::min(maxBitCount, writer.GetRemainingBitCount());
+
+    // Removals are baseline entities missing from current, both are sorted so one merge pass finds
+    // them and also pairs every current entity with its kept baseline entity
+    auto& arena = GetThreadArena();
+    ArenaScope arenaScope(arena);
+    // Power of two capacities settle quickly, reconstructed cycles through the sender's history and
+    // exact sizes would keep reallocating as the entity counts wobble
+    reconstructed.clear();
+    reconstructed.reserve(std::bit_ceil(baseline.size() + current.size()));
+    std::pmr::vector<uint32_t> removedIds(&arena);
+    std::pmr::vector<int32_t> keptIndices(current.size(), -1, &arena);
+    auto currentIndex = 0u;
+    for (auto& baselineEntity : baseline)
+    {
+        while (currentIndex < current.size() && current[currentIndex].Id < baselineEntity.Id)
+        {
+            currentIndex++;
+        }
+
+        if (currentIndex == current.size() || current[currentIndex].Id != baselineEntity.Id)
+        {
+            removedIds.push_back(baselineEntity.Id);
+        }
+        else
+        {
+            keptIndices[currentIndex] = static_cast<int32_t>(reconstructed.size());
+            reconstructed.push_back(baselineEntity);
+        }
+    }
+
+    writer.WriteVariableUnsigned(static_cast<uint32_t>(removedIds.size()));
+    auto previousId = uint32_t(0);
+    for (auto removedId : removedIds)
+    {
+        writer.WriteVariableUnsigned(removedId - previousId);
+        previousId = removedId;
+    }
+    result.RemovedEntityCount = static_cast<uint32_t>(removedIds.size());
+
+    // New entities are appended behind the kept baseline entities and sorted in at the end
+    auto keptEntityCount = reconstructed.size();
+    auto isEntityChanged = [&](uint32_t entityIndex)
+    {
+        auto keptIndex = keptIndices[entityIndex];
+        return keptIndex < 0 || reconstructed[keptIndex].Values != current[entityIndex].Values;
+    };
+
+    previousId = 0;
+    auto orderIndex = 0u;
+    for (; orderIndex < priorityOrder.size(); orderIndex++)
+    {
+        auto entityIndex = priorityOrder[orderIndex];
+        if (!isEntityChanged(entityIndex))
+        {
+            continue;
+        }
+
+        // Once not even the smallest update fits the rest is only counted
+        if (writer.GetBitCount() + SnapshotMinEntityBitCount + 1 > bitLimit)
+        {
+            break;
+        }
+
+        auto& entity = current[entityIndex];
+        auto keptIndex = keptIndices[entityIndex];
+        auto isNew = keptIndex < 0;
+        auto idDelta = static_cast<int32_t>(entity.Id - previousId);
+        auto entityBitCount = 2 + GetVariableSignedBitCount(idDelta);
+        std::array<int32_t, 6> valueDeltas = {};
+        for (auto value = 0u; value < valueDeltas.size(); value++)
+        {
+            if (isNew)
+            {
+                entityBitCount += ValueBitCounts[value];
+            }
+            else
+            {
+                valueDeltas[value] = static_cast<int32_t>(entity.Values[value] - reconstructed[keptIndex].Values[value]);
+                entityBitCount += GetVariableSignedBitCount(valueDeltas[value]);
+            }
+        }
+
+        // One bit stays reserved for the terminator. Stopping here rather than trying smaller
+        // entities further down keeps the up to date entities a prefix of priorityOrder.
+        if (writer.GetBitCount() + entityBitCount + 1 > bitLimit)
+        {
+            break;
+        }
+
+        writer.WriteBool(true);
+        writer.WriteVariableSigned(idDelta);
+        writer.WriteBool(isNew);
+        if (isNew)
+        {
+            for (auto value = 0u; value < ValueBitCounts.size(); value++)
+            {
+                writer.WriteBits(entity.Values[value], ValueBitCounts[value]);
+            }
+            keptIndices[entityIndex] = static_cast<int32_t>(reconstructed.size());
+            reconstructed.push_back(entity);
+        }
+        else
+        {
+            for (auto valueDelta : valueDeltas)
+            {
+                writer.WriteVariableSigned(valueDelta);
+            }
+            reconstructed[keptIndex].Values = entity.Values;
+        }
+
+        previousId = entity.Id;
+        result.WrittenEntityCount++;
+    }
+
+    result.UpToDateEntityCount = orderIndex;
+    for (; orderIndex < priorityOrder.size(); orderIndex++)
+    {
+        result.SkippedEntityCount += isEntityChanged(priorityOrder[orderIndex]) ? 1 : 0;
+    }
+    writer.WriteBool(false);
+
+    if (keptEntityCount != reconstructed.size())
+    {
+        SortAppendedById(reconstructed, keptEntityCount);
+    }
+
+    return result;
+}
+
+bool DecodeSnapshotDelta(
+    BitReader& reader,
+    const QuantizedSnapshot& baseline,
+    QuantizedSnapshot& snapshot)
+{
+    snapshot.clear();
+
+    auto removedCount = reader.ReadVariableUnsigned();
+    if (reader.IsOverflowed() || removedCount > baseline.size())
+    {
+        return false;
+    }
+
+    auto removedId = uint32_t(0);
+    auto baselineEntity = baseline.begin();
+    for (auto i = 0u; i < removedCount; i++)
+    {
+        removedId += reader.ReadVariableUnsigned();
+        while (baselineEntity != baseline.end() && baselineEntity->Id < removedId)
+        {
+            snapshot.push_back(*baselineEntity++);
+        }
+
+        if (baselineEntity == baseline.end() || baselineEntity->Id != removedId)
+        {
+            return false;
+        }
+        ++baselineEntity;
+    }
+    snapshot.insert(snapshot.end(), baselineEntity, baseline.end());
+
+    auto baselineEntityCount = snapshot.size();
+    auto previousId = uint32_t(0);
+    while (reader.ReadBool())
+    {
+        auto id = previousId + static_cast<uint32_t>(reader.ReadVariableSigned());
+        auto isNew = reader.ReadBool();
+        if (isNew)
+        {
+            QuantizedEntityState entity = { .Id = id, .Values = {} };
+            for (auto value = 0u; value < ValueBitCounts.size(); value++)
+            {
+                entity.Values[value] = reader.ReadBits(ValueBitCounts[value]);
+            }
+            snapshot.push_back(entity);
+        }
+        else
+        {
+            auto baselineEnd = snapshot.begin() + static_cast<std::ptrdiff_t>(baselineEntityCount);
+            auto entity = FindEntity(snapshot.begin(), baselineEnd, id);
+            if (entity == baselineEnd)
+            {
+                return false;
+            }
+
+            for (auto& value : entity->Values)
+            {
+                value += static_cast<uint32_t>(reader.ReadVariableSigned());
+            }
+        }
+
+        previousId = id;
+        if (reader.IsOverflowed())
+        {
+            return false;
+        }
+    }
+
+    if (reader.IsOverflowed())
+    {
+        return false;
+    }
+
+    if (snapshot.size() != baselineEntityCount)
+    {
+        SortAppendedById(snapshot, baselineEntityCount);
+
+        // A new entity repeating another's id, new or from the baseline, is malformed as well
+        auto isSameId = [](const QuantizedEntityState& lhs, const QuantizedEntityState& rhs)
+        {
+            return lhs.Id == rhs.Id;
+        };
+        if (std::adjacent_find(snapshot.begin(), snapshot.end(), isSameId) != snapshot.end())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,331 @@
+#include <EngineCore/SpatialHash.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    constexpr uint32_t InvalidOffset = ~0u;
+    constexpr uint32_t RadixSortMinBlockSize = 16384;
+    constexpr uint32_t RadixSortMaxBlocks = 64;
+}
+
+SpatialHash::SpatialHash(float cellSize)
+    : _cellSize(cellSize),
+      _inverseCellSize(1.0f / cellSize)
+{
+}
+
+void SpatialHash::CreateProxies(
+    std::span<const Aabb> aabbs,
+    std::span<const uint32_t> userData,
+    std::span<int32_t> proxyIds,
+    [[maybe_unused]] TaskScheduler& taskScheduler)
+{
+    assert(aabbs.size() == userData.size() && aabbs.size() == proxyIds.size());
+
+    for (auto i = 0u; i < aabbs.size(); i++)
+    {
+        auto proxyId = 0;
+        if (!_freeProxyIds.empty())
+        {
+            proxyId = _freeProxyIds.back();
+            _freeProxyIds.pop_back();
+        }
+        else
+        {
+            proxyId = static_cast<int32_t>(_aabbs.size());
+            _aabbs.emplace_back();
+            _userData.emplace_back();
+            _isAlive.emplace_back();
+        }
+
+        _aabbs[proxyId] = aabbs[i];
+        _userData[proxyId] = userData[i];
+        _isAlive[proxyId] = 1;
+        proxyIds[i] = proxyId;
+    }
+
+    _proxyCount += static_cast<uint32_t>(aabbs.size());
+}
+
+void SpatialHash::DestroyProxies(std::span<const int32_t> proxyIds)
+{
+    for (auto proxyId : proxyIds)
+    {
+        assert(_isAlive[proxyId] != 0);
+        _isAlive[proxyId] = 0;
+        _freeProxyIds.push_back(proxyId);
+    }
+
+    _proxyCount -= static_cast<uint32_t>(proxyIds.size());
+}
+
+void SpatialHash::UpdateProxies(
+    std::span<const int32_t> proxyIds,
+    std::span<const Aabb> aabbs,
+    TaskScheduler& taskScheduler)
+{
+    assert(proxyIds.size() == aabbs.size());
+
+    taskScheduler.ParallelFor(static_cast<uint32_t>(proxyIds.size()), 4096, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            _aabbs[proxyIds[i]] = aabbs[i];
+        }
+    });
+}
+
+void SpatialHash::FindPairs(
+    BroadphasePairBuffer& pairBuffer,
+    TaskScheduler& taskScheduler)
+{
+    pairBuffer.Clear();
+
+    auto slotCount = static_cast<uint32_t>(_aabbs.size());
+    _entryOffsets.resize(slotCount);
+
+    auto getCellRange = [this](int32_t proxyId, glm::ivec3& minCell, glm::ivec3& maxCell)
+    {
+        minCell = GetCell(_aabbs[proxyId].Min);
+        maxCell = GetCell(_aabbs[proxyId].Max);
+        auto cellCount =
+            int64_t(maxCell.x - minCell.x + 1) *
+            int64_t(maxCell.y - minCell.y + 1) *
+            int64_t(maxCell.z - minCell.z + 1);
+        return cellCount;
+    };
+
+    // Count cells per proxy, the counts are turned into offsets below
+    taskScheduler.ParallelFor(slotCount, 4096, [&](uint32_t begin, uint32_t end)
+    {
+        glm::ivec3 minCell;
+        glm::ivec3 maxCell;
+        for (auto proxyId = begin; proxyId < end; proxyId++)
+        {
+            if (_isAlive[proxyId] == 0)
+            {
+                _entryOffsets[proxyId] = 0;
+                continue;
+            }
+
+            auto cellCount = getCellRange(proxyId, minCell, maxCell);
+            _entryOffsets[proxyId] = cellCount > MaxCellsPerProxy
+                ? InvalidOffset
+                : static_cast<uint32_t>(cellCount);
+        }
+    });
+
+    _oversizedProxyIds.clear();
+    auto entryCount = 0u;
+    for (auto proxyId = 0u; proxyId < slotCount; proxyId++)
+    {
+        auto cellCount = _entryOffsets[proxyId];
+        if (cellCount == InvalidOffset)
+        {
+            _oversizedProxyIds.push_back(static_cast<int32_t>(proxyId));
+            continue;
+        }
+
+        _entryOffsets[proxyId] = entryCount;
+        entryCount += cellCount;
+    }
+
+    _entries.resize(entryCount);
+
+    taskScheduler.ParallelFor(slotCount, 4096, [&](uint32_t begin, uint32_t end)
+    {
+        glm::ivec3 minCell;
+        glm::ivec3 maxCell;
+        for (auto proxyId = begin; proxyId < end; proxyId++)
+        {
+            if (_isAlive[proxyId] == 0 || _entryOffsets[proxyId] == InvalidOffset)
+            {
+                continue;
+            }
+
+            getCellRange(proxyId, minCell, maxCell);
+            auto entryIndex = _entryOffsets[proxyId];
+            for (auto z = minCell.z; z <= maxCell.z; z++)
+            {
+                for (auto y = minCell.y; y <= maxCell.y; y++)
+                {
+                    for (auto x = minCell.x; x <= maxCell.x; x++)
+                    {
+                        _entries[entryIndex++] = CellEntry{
+                            .CellHash = HashCell(glm::ivec3(x, y, z)),
+                            .ProxyId = proxyId
+                        };
+                    }
+                }
+            }
+        }
+    });
+
+    SortEntries(taskScheduler);
+
+    _cellRuns.clear();
+    for (auto i = 0u; i < entryCount; i++)
+    {
+        if (i == 0 || _entries[i].CellHash != _entries[i - 1].CellHash)
+        {
+            _cellRuns.push_back(i);
+        }
+    }
+    _cellRuns.push_back(entryCount);
+
+    auto runCount = static_cast<uint32_t>(_cellRuns.size() - 1);
+    taskScheduler.ParallelFor(runCount, 256, [&](uint32_t begin, uint32_t end)
+    {
+        BroadphasePairWriter pairWriter(pairBuffer);
+        for (auto run = begin; run < end; run++)
+        {
+            auto runBegin = _cellRuns[run];
+            auto runEnd = _cellRuns[run + 1];
+            auto runHash = _entries[runBegin].CellHash;
+
+            for (auto i = runBegin; i < runEnd; i++)
+            {
+                // A proxy can land in a run twice when two of its cells collide on the hash,
+                // the stable sort keeps those duplicates adjacent
+                auto proxyA = _entries[i].ProxyId;
+                if (i > runBegin && _entries[i - 1].ProxyId == proxyA)
+                {
+                    continue;
+                }
+
+                const auto& aabbA = _aabbs[proxyA];
+                for (auto j = i + 1; j < runEnd; j++)
+                {
+                    auto proxyB = _entries[j].ProxyId;
+                    if (proxyB == proxyA || _entries[j - 1].ProxyId == proxyB)
+                    {
+                        continue;
+                    }
+
+                    const auto& aabbB = _aabbs[proxyB];
+                    if (!aabbA.Overlaps(aabbB))
+                    {
+                        continue;
+                    }
+
+                    // Pairs sharing several cells are only reported from the cell holding the
+                    // minimum corner of their intersection
+                    auto referenceCell = GetCell(glm::max(aabbA.Min, aabbB.Min));
+                    if (HashCell(referenceCell) == runHash)
+                    {
+                        pairWriter.Add(_userData[proxyA], _userData[proxyB]);
+                    }
+                }
+            }
+        }
+    });
+
+    auto oversizedCount = static_cast<uint32_t>(_oversizedProxyIds.size());
+    taskScheduler.ParallelFor(oversizedCount, 1, [&](uint32_t begin, uint32_t end)
+    {
+        BroadphasePairWriter pairWriter(pairBuffer);
+        for (auto i = begin; i < end; i++)
+        {
+            auto proxyA = _oversizedProxyIds[i];
+            const auto& aabbA = _aabbs[proxyA];
+            for (auto proxyB = 0u; proxyB < slotCount; proxyB++)
+            {
+                if (_isAlive[proxyB] == 0 || static_cast<int32_t>(proxyB) == proxyA)
+                {
+                    continue;
+                }
+
+                // Two oversized proxies see each other, report only from the lower id
+                if (_entryOffsets[proxyB] == InvalidOffset && static_cast<int32_t>(proxyB) < proxyA)
+                {
+                    continue;
+                }
+
+                if (aabbA.Overlaps(_aabbs[proxyB]))
+                {
+                    pairWriter.Add(_userData[proxyA], _userData[proxyB]);
+                }
+            }
+        }
+    });
+}
+
+glm::ivec3 SpatialHash::GetCell(const glm::vec3& position) const noexcept
+{
+    return glm::ivec3(
+        static_cast<int32_t>(std::floor(position.x * _inverseCellSize)),
+        static_cast<int32_t>(std::floor(position.y * _inverseCellSize)),
+        static_cast<int32_t>(std::floor(position.z * _inverseCellSize)));
+}
+
+uint32_t SpatialHash::HashCell(const glm::ivec3& cell) noexcept
+{
+    return (static_cast<uint32_t>(cell.x) * 73856093u) ^
+           (static_cast<uint32_t>(cell.y) * 19349663u) ^
+           (static_cast<uint32_t>(cell.z) * 83492791u);
+}
+
+// Stable LSD radix sort on the cell hash, 4 passes of 8 bits.
+// Each pass histograms and scatters contiguous blocks in parallel, block order keeps it stable.
+void SpatialHash::SortEntries(TaskScheduler& taskScheduler)
+{
+    auto entryCount = static_cast<uint32_t>(_entries.size());
+    _sortScratch.resize(entryCount);
+
+    auto blockCount = std::clamp(entryCount / RadixSortMinBlockSize, 1u, RadixSortMaxBlocks);
+    auto blockSize = (entryCount + blockCount - 1) / blockCount;
+    _sortHistograms.resize(blockCount);
+
+    auto source = _entries.data();
+    auto destination = _sortScratch.data();
+    for (auto shift = 0u; shift < 32u; shift += 8u)
+    {
+        taskScheduler.ParallelFor(blockCount, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for (auto block = begin; block < end; block++)
+            {
+                auto& histogram = _sortHistograms[block];
+                histogram.fill(0);
+
+                auto blockEnd = std::min(entryCount, (block + 1) * blockSize);
+                for (auto i = block * blockSize; i < blockEnd; i++)
+                {
+                    histogram[(source[i].CellHash >> shift) & 0xFFu]++;
+                }
+            }
+        });
+
+        auto sum = 0u;
+        for (auto digit = 0u; digit < 256u; digit++)
+        {
+            for (auto& histogram : _sortHistograms)
+            {
+                auto count = histogram[digit];
+                histogram[digit] = sum;
+                sum += count;
+            }
+        }
+
+        taskScheduler.ParallelFor(blockCount, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for (auto block = begin; block < end; block++)
+            {
+                auto& offsets = _sortHistograms[block];
+                auto blockEnd = std::min(entryCount, (block + 1) * blockSize);
+                for (auto i = block * blockSize; i < blockEnd; i++)
+                {
+                    destination[offsets[(source[i].CellHash >> shift) & 0xFFu]++] = source[i];
+                }
+            }
+        });
+
+        std::swap(source, destination);
+    }
+
+    // Even number of passes, the sorted result ends up back in _entries
+}
@@ -0,0 +1,370 @@
+#include <EngineCore/StarCatalog.hpp>
+#include <EngineCore/OctahedralImpostor.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <numbers>
+
+namespace
+{
+    constexpr size_t StarAlignment = 64;
+    // Rows of CSV catalogs without a color index are taken to be Sun like
+    constexpr float DefaultColorIndex = 0.65f;
+
+    uint32_t ToUnorm16(float value) noexcept
+    {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+    }
+
+    float FromUnorm16(uint32_t value) noexcept
+    {
+        return static_cast<float>(value & 0xFFFFu) / 65535.0f;
+    }
+
+    float Random(uint32_t seed, uint32_t index, uint32_t channel)
+    {
+        auto value = seed + index * 0x9e3779b9u + channel * 0x85ebca6bu;
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return static_cast<float>(value) / static_cast<float>(UINT32_MAX);
+    }
+
+    void ParallelForOrInline(TaskScheduler* taskScheduler, uint32_t count, uint32_t grainSize, FunctionRef<void(uint32_t begin, uint32_t end)> body)
+    {
+        if (taskScheduler != nullptr)
+        {
+            taskScheduler->ParallelFor(count, grainSize, body);
+        }
+        else
+        {
+            body(0, count);
+        }
+    }
+
+    // Fields of one CSV row, quoted fields may contain commas
+    template <typename TFunc>
+    void ForEachCsvField(std::string_view row, TFunc&& func)
+    {
+        auto column = 0u;
+        auto offset = size_t(0);
+        while (offset <= row.size())
+        {
+            auto end = offset;
+            auto isQuoted = offset < row.size() && row[offset] == '"';
+            if (isQuoted)
+            {
+                end = row.find('"', offset + 1);
+                end = end == std::string_view::npos ? row.size() : end;
+                func(column++, row.substr(offset + 1, end - offset - 1));
+                end = row.find(',', end);
+            }
+            else
+            {
+                end = row.find(',', offset);
+                func(column++, row.substr(offset, (end == std::string_view::npos ? row.size() : end) - offset));
+            }
+            if (end == std::string_view::npos)
+            {
+                break;
+            }
+            offset = end + 1;
+        }
+    }
+
+    bool ParseFloat(std::string_view text, float& value) noexcept
+    {
+        return !text.empty() && std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+    }
+}
+
+// Not through EncodeOctahedralNormals, its snorm16 would be quantized again to the catalog's unorm16
+PackedStar PackStar(const glm::vec3& direction, float magnitude, float colorIndex) noexcept
+{
+    auto encoded = OctahedralEncode(glm::normalize(direction)) * 0.5f + 0.5f;
+    return PackedStar
+    {
+        .Direction = ToUnorm16(encoded.x) | (ToUnorm16(encoded.y) << 16),
+        .MagnitudeAndColor = ToUnorm16((magnitude - StarMinMagnitude) / StarMagnitudeRange)
+            | (ToUnorm16((colorIndex - StarMinColorIndex) / StarColorIndexRange) << 16)
+    };
+}
+
+glm::vec3 GetStarDirection(const PackedStar& star) noexcept
+{
+    return OctahedralDecode(glm::vec2(FromUnorm16(star.Direction), FromUnorm16(star.Direction >> 16)) * 2.0f - 1.0f);
+}
+
+float GetStarMagnitude(const PackedStar& star) noexcept
+{
+    return StarMinMagnitude + FromUnorm16(star.MagnitudeAndColor) * StarMagnitudeRange;
+}
+
+uint32_t GetStarCell(const PackedStar& star) noexcept
+{
+    auto x = ((star.Direction & 0xFFFFu) * StarCatalogCellGridSize) >> 16;
+    auto y = ((star.Direction >> 16) * StarCatalogCellGridSize) >> 16;
+    return y * StarCatalogCellGridSize + x;
+}
+
+uint32_t StarCell::GetStarCount(float limitingMagnitude) const noexcept
+{
+    auto bin = std::ceil(limitingMagnitude - StarMinMagnitude) - 1.0f;
+    if (bin < 0.0f)
+    {
+        return 0;
+    }
+    return bin >= static_cast<float>(StarMagnitudeBinCount) ? StarCount : BrighterStarCounts[static_cast<uint32_t>(bin)];
+}
+
+std::expected<std::vector<PackedStar>, std::string> ReadStarCatalogCsv(std::string_view csvFilePath)
+{
+    auto fileResult = Io::MappedFile::Open(csvFilePath);
+    if (!fileResult)
+    {
+        return std::unexpected(fileResult.error());
+    }
+
+    auto data = fileResult->GetData();
+    auto text = std::string_view(reinterpret_cast<const char*>(data.data()), data.size());
+    auto nextRow = [&text]()
+    {
+        auto end = text.find('\n');
+        auto row = text.substr(0, end);
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+        return row.ends_with('\r') ? row.substr(0, row.size() - 1) : row;
+    };
+
+    // x, y, z, mag, ci
+    constexpr uint32_t FieldCount = 5;
+    constexpr std::array<std::string_view, FieldCount> FieldNames = { "x", "y", "z", "mag", "ci" };
+    std::array<uint32_t, FieldCount> fieldColumns;
+    fieldColumns.fill(UINT32_MAX);
+    ForEachCsvField(nextRow(), [&](uint32_t column, std::string_view name)
+    {
+        for (auto field = 0u; field < FieldCount; field++)
+        {
+            if (name == FieldNames[field])
+            {
+                fieldColumns[field] = column;
+            }
+        }
+    });
+    for (auto field = 0u; field < FieldCount - 1; field++)
+    {
+        if (fieldColumns[field] == UINT32_MAX)
+        {
+            return std::unexpected(std::format("StarCatalog: {} has no \"{}\" column", csvFilePath, FieldNames[field]));
+        }
+    }
+
+    std::vector<PackedStar> stars;
+    auto skippedRowCount = 0u;
+    while (!text.empty())
+    {
+        auto row = nextRow();
+        if (row.empty())
+        {
+            continue;
+        }
+
+        std::array<float, FieldCount> values = { 0.0f, 0.0f, 0.0f, 0.0f, DefaultColorIndex };
+        std::array<bool, FieldCount> isParsed = {};
+        ForEachCsvField(row, [&](uint32_t column, std::string_view field)
+        {
+            for (auto i = 0u; i < FieldCount; i++)
+            {
+                if (fieldColumns[i] == column)
+                {
+                    isParsed[i] = ParseFloat(field, values[i]);
+                }
+            }
+        });
+
+        // The Sun sits at the origin and has no direction
+        auto position = glm::vec3(values[0], values[1], values[2]);
+        if (!isParsed[0] || !isParsed[1] || !isParsed[2] || !isParsed[3] || glm::dot(position, position) == 0.0f)
+        {
+            skippedRowCount++;
+            continue;
+        }
+        stars.push_back(PackStar(position, values[3], isParsed[4] ? values[4] : DefaultColorIndex));
+    }
+
+    if (stars.empty())
+    {
+        return std::unexpected(std::format("StarCatalog: {} has no stars, {} rows skipped", csvFilePath, skippedRowCount));
+    }
+    return stars;
+}
+
+std::vector<PackedStar> GenerateStars(uint64_t starCount, uint32_t seed, TaskScheduler* taskScheduler)
+{
+    // Stars per magnitude grow about fourfold, the sky has some 9000 down to 6.5
+    constexpr double MinMagnitude = -1.5;
+    constexpr double StarCountGrowth = 0.6;
+    auto maxMagnitude = std::max(6.5 + std::log10(static_cast<double>(starCount) / 9000.0) / StarCountGrowth, MinMagnitude + 1.0);
+    auto magnitudeSpan = std::pow(10.0, StarCountGrowth * (maxMagnitude - MinMagnitude)) - 1.0;
+
+    // The galactic plane is tilted by about 63 degrees against the equator
+    constexpr float GalacticTilt = 1.097f;
+    auto tiltCos = std::cos(GalacticTilt);
+    auto tiltSin = std::sin(GalacticTilt);
+
+    std::vector<PackedStar> stars(std::min<uint64_t>(starCount, UINT32_MAX));
+    ParallelForOrInline(taskScheduler, static_cast<uint32_t>(stars.size()), 65536, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            auto z = Random(seed, i, 0) * 2.0f - 1.0f;
+            auto phi = Random(seed, i, 1) * 2.0f * std::numbers::pi_v<float>;
+            auto r = std::sqrt(std::max(1.0f - z * z, 0.0f));
+            // Most stars squeezed towards the plane, the rest spread evenly
+            z *= Random(seed, i, 2) < 0.7f ? 0.12f : 1.0f;
+            auto galactic = glm::vec3(r * std::cos(phi), r * std::sin(phi), z);
+            auto direction = glm::vec3(galactic.x, galactic.y * tiltCos - galactic.z * tiltSin, galactic.y * tiltSin + galactic.z * tiltCos);
+
+            auto magnitude = MinMagnitude + std::log10(1.0 + static_cast<double>(Random(seed, i, 3)) * magnitudeSpan) / StarCountGrowth;
+            auto colorIndex = 0.6f + (Random(seed, i, 4) + Random(seed, i, 5) - 1.0f) * 0.9f;
+            stars[i] = PackStar(direction, static_cast<float>(magnitude), colorIndex);
+        }
+    });
+    return stars;
+}
+
+std::expected<void, std::string> WriteStarCatalog(
+    std::string_view filePath,
+    std::vector<PackedStar>& stars,
+    TaskScheduler* taskScheduler)
+{
+    if (stars.size() > UINT32_MAX)
+    {
+        return std::unexpected(std::format("StarCatalog: {} stars are more than a catalog can index", stars.size()));
+    }
+
+    // Counting sort into cells, then each cell brightest first
+    std::vector<StarCell> cells(StarCatalogCellCount);
+    for (auto& star : stars)
+    {
+        cells[GetStarCell(star)].StarCount++;
+    }
+    auto firstStar = 0u;
+    for (auto& cell : cells)
+    {
+        cell.FirstStar = firstStar;
+        firstStar += cell.StarCount;
+    }
+
+    std::vector<PackedStar> sortedStars(stars.size());
+    {
+        std::vector<uint32_t> cursors(StarCatalogCellCount);
+        for (auto& star : stars)
+        {
+            auto cell = GetStarCell(star);
+            sortedStars[cells[cell].FirstStar + cursors[cell]++] = star;
+        }
+    }
+    stars.swap(sortedStars);
+    sortedStars = {};
+
+    ParallelForOrInline(taskScheduler, StarCatalogCellCount, 16, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto cellIndex = begin; cellIndex < end; cellIndex++)
+        {
+            auto& cell = cells[cellIndex];
+            auto cellStars = std::span(stars).subspan(cell.FirstStar, cell.StarCount);
+            std::ranges::sort(cellStars, {}, [](const PackedStar& star) { return star.MagnitudeAndColor & 0xFFFFu; });
+
+            auto cellUv = glm::vec2(
+                (static_cast<float>(cellIndex % StarCatalogCellGridSize) + 0.5f) / static_cast<float>(StarCatalogCellGridSize),
+                (static_cast<float>(cellIndex / StarCatalogCellGridSize) + 0.5f) / static_cast<float>(StarCatalogCellGridSize));
+            cell.Center = OctahedralDecode(cellUv * 2.0f - 1.0f);
+            auto minCosine = 1.0f;
+            auto bin = 0u;
+            for (auto i = 0u; i < cellStars.size(); i++)
+            {
+                minCosine = std::min(minCosine, glm::dot(cell.Center, GetStarDirection(cellStars[i])));
+                auto magnitude = GetStarMagnitude(cellStars[i]);
+                for (; bin < StarMagnitudeBinCount && magnitude >= StarMinMagnitude + 1.0f + static_cast<float>(bin); bin++)
+                {
+                    cell.BrighterStarCounts[bin] = i;
+                }
+            }
+            for (; bin < StarMagnitudeBinCount; bin++)
+            {
+                cell.BrighterStarCounts[bin] = cell.StarCount;
+            }
+            cell.Radius = std::acos(std::clamp(minCosine, -1.0f, 1.0f));
+        }
+    });
+
+    StarCatalogHeader header;
+    header.StarCount = stars.size();
+    header.StarOffset = (sizeof(StarCatalogHeader) + sizeof(StarCell) * cells.size() + StarAlignment - 1) / StarAlignment * StarAlignment;
+
+    auto file = std::fopen(std::string(filePath).c_str(), "wb");
+    if (file == nullptr)
+    {
+        return std::unexpected(std::format("StarCatalog: Creating {} failed", filePath));
+    }
+    std::array<std::byte, StarAlignment> padding = {};
+    auto paddingSize = header.StarOffset - sizeof(StarCatalogHeader) - sizeof(StarCell) * cells.size();
+    auto isWritten = std::fwrite(&header, sizeof(StarCatalogHeader), 1, file) == 1
+        && std::fwrite(cells.data(), sizeof(StarCell), cells.size(), file) == cells.size()
+        && std::fwrite(padding.data(), 1, paddingSize, file) == paddingSize
+        && std::fwrite(stars.data(), sizeof(PackedStar), stars.size(), file) == stars.size();
+    auto isClosed = std::fclose(file) == 0;
+    if (!isWritten || !isClosed)
+    {
+        return std::unexpected(std::format("StarCatalog: Writing {} failed", filePath));
+    }
+    return {};
+}
+
+std::expected<StarCatalog, std::string> StarCatalog::Open(std::string_view filePath)
+{
+    auto fileResult = Io::MappedFile::Open(filePath);
+    if (!fileResult)
+    {
+        return std::unexpected(fileResult.error());
+    }
+
+    StarCatalog catalog;
+    catalog._file = std::move(fileResult.value());
+    auto data = catalog._file.GetData();
+    StarCatalogHeader header;
+    if (data.size() < sizeof(StarCatalogHeader))
+    {
+        return std::unexpected(std::format("StarCatalog: {} is not a star catalog", filePath));
+    }
+    std::memcpy(&header, data.data(), sizeof(StarCatalogHeader));
+    if (header.Magic != StarCatalogMagic)
+    {
+        return std::unexpected(std::format("StarCatalog: {} is not a star catalog", filePath));
+    }
+    if (header.Version != StarCatalogVersion || header.CellGridSize != StarCatalogCellGridSize || header.CellCount != StarCatalogCellCount)
+    {
+        return std::unexpected(std::format("StarCatalog: {} has version {}, expected {}", filePath, header.Version, StarCatalogVersion));
+    }
+    auto cellsEnd = sizeof(StarCatalogHeader) + sizeof(StarCell) * header.CellCount;
+    if (header.StarOffset < cellsEnd || header.StarOffset % alignof(PackedStar) != 0
+        || data.size() < header.StarOffset || (data.size() - header.StarOffset) / sizeof(PackedStar) < header.StarCount)
+    {
+        return std::unexpected(std::format("StarCatalog: {} is truncated", filePath));
+    }
+
+    // Mappings are page aligned and the writer aligned both arrays
+    catalog._cells = { reinterpret_cast<const StarCell*>(data.data() + sizeof(StarCatalogHeader)), header.CellCount };
+    catalog._stars = { reinterpret_cast<const PackedStar*>(data.data() + header.StarOffset), static_cast<size_t>(header.StarCount) };
+    return catalog;
+}
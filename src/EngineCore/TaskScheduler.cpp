@@ -0,0 +1,148 @@
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+TaskScheduler::TaskScheduler(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        auto hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    _workers.reserve(workerCount);
+    for (auto i = 0u; i < workerCount; i++)
+    {
+        _workers.emplace_back([this](std::stop_token stopToken)
+        {
+            WorkerLoop(stopToken);
+        });
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    for (auto& worker : _workers)
+    {
+        worker.request_stop();
+    }
+    _tasksAvailable.notify_all();
+    _workers.clear();
+}
+
+void TaskScheduler::ParallelFor(
+    uint32_t count,
+    uint32_t grainSize,
+    FunctionRef<void(uint32_t begin, uint32_t end)> body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, 1u);
+    auto rangeCount = (count + grainSize - 1) / grainSize;
+    if (_workers.empty() || rangeCount == 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    std::atomic<uint32_t> nextRange = 0;
+    std::atomic<uint32_t> finishedHelpers = 0;
+
+    auto processRanges = [&]()
+    {
+        for (;;)
+        {
+            auto range = nextRange.fetch_add(1, std::memory_order_relaxed);
+            if (range >= rangeCount)
+            {
+                break;
+            }
+
+            auto begin = range * grainSize;
+            auto end = std::min(begin + grainSize, count);
+            body(begin, end);
+        }
+    };
+
+    // Helpers allocate on behalf of the caller, so that is whom their allocations are accounted to
+    auto memoryTag = GetThreadMemoryTag();
+    auto helper = [&]()
+    {
+        MemoryTagScope memoryTagScope(memoryTag);
+        processRanges();
+        finishedHelpers.fetch_add(1, std::memory_order_release);
+    };
+
+    auto helperCount = std::min(GetWorkerCount(), rangeCount - 1);
+    for (auto i = 0u; i < helperCount; i++)
+    {
+        Enqueue(helper);
+    }
+
+    processRanges();
+
+    // Helpers reference this stack frame, so we can't leave before all of them are done.
+    // Run other queued work meanwhile, that also keeps nested ParallelFor calls from deadlocking.
+    while (finishedHelpers.load(std::memory_order_acquire) != helperCount)
+    {
+        if (!TryRunTask())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::Enqueue(FunctionRef<void()> task)
+{
+    {
+        std::scoped_lock lock(_tasksMutex);
+        _tasks.push_back(task);
+    }
+    _tasksAvailable.notify_one();
+}
+
+bool TaskScheduler::TryRunTask()
+{
+    std::unique_lock lock(_tasksMutex);
+    if (_firstTask == _tasks.size())
+    {
+        return false;
+    }
+
+    auto task = PopTask();
+    lock.unlock();
+    task();
+    return true;
+}
+
+FunctionRef<void()> TaskScheduler::PopTask()
+{
+    auto task = _tasks[_firstTask++];
+    if (_firstTask == _tasks.size())
+    {
+        _tasks.clear();
+        _firstTask = 0;
+    }
+    return task;
+}
+
+void TaskScheduler::WorkerLoop(std::stop_token stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        std::unique_lock lock(_tasksMutex);
+        if (!_tasksAvailable.wait(lock, stopToken, [this]() { return _firstTask != _tasks.size(); }))
+        {
+            return;
+        }
+
+        auto task = PopTask();
+        lock.unlock();
+        task();
+    }
+}
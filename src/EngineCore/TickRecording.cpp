@@ -0,0 +1,263 @@
+#include <EngineCore/TickRecording.hpp>
+
+#include <format>
+#include <utility>
+
+namespace
+{
+    void AppendUint32(std::vector<std::byte>& bytes, uint32_t value)
+    {
+        for (auto i = 0u; i < 4; i++)
+        {
+            bytes.push_back(static_cast<std::byte>(value >> (i * 8)));
+        }
+    }
+
+    uint64_t ReadLittleEndian(std::span<const std::byte> bytes, size_t offset, uint32_t byteCount) noexcept
+    {
+        auto value = uint64_t(0);
+        for (auto i = 0u; i < byteCount; i++)
+        {
+            value |= static_cast<uint64_t>(bytes[offset + i]) << (i * 8);
+        }
+        return value;
+    }
+}
+
+void AppendVarint(std::vector<std::byte>& bytes, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<std::byte>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<std::byte>(value));
+}
+
+void AppendSignedVarint(std::vector<std::byte>& bytes, int64_t value)
+{
+    AppendVarint(bytes, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+std::optional<uint64_t> ReadVarint(std::span<const std::byte> bytes, size_t& offset) noexcept
+{
+    auto value = uint64_t(0);
+    for (auto shift = 0u; shift < 64 && offset < bytes.size(); shift += 7)
+    {
+        auto byte = static_cast<uint64_t>(bytes[offset++]);
+        value |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<int64_t> ReadSignedVarint(std::span<const std::byte> bytes, size_t& offset) noexcept
+{
+    auto value = ReadVarint(bytes, offset);
+    if (!value)
+    {
+        return std::nullopt;
+    }
+    return static_cast<int64_t>((*value >> 1) ^ (~(*value & 1) + 1));
+}
+
+std::expected<std::unique_ptr<TickRecorder>, std::string> TickRecorder::Create(
+    std::string_view filePath,
+    std::span<const std::byte> header)
+{
+    auto file = std::fopen(std::string(filePath).c_str(), "wb");
+    if (file == nullptr)
+    {
+        return std::unexpected(std::format("TickRecorder: Creating {} failed", filePath));
+    }
+
+    auto recorder = std::unique_ptr<TickRecorder>(new TickRecorder(file, std::string(filePath)));
+    AppendUint32(recorder->_chunk, TickRecordingMagic);
+    AppendUint32(recorder->_chunk, TickRecordingVersion);
+    AppendUint32(recorder->_chunk, static_cast<uint32_t>(header.size()));
+    recorder->_chunk.insert(recorder->_chunk.end(), header.begin(), header.end());
+    recorder->Flush();
+    return recorder;
+}
+
+TickRecorder::TickRecorder(std::FILE* file, std::string filePath)
+    : _file(file),
+      _filePath(std::move(filePath))
+{
+    _chunk.reserve(ChunkSize);
+    _writer = std::jthread([this](std::stop_token stopToken)
+    {
+        WriteChunks(stopToken);
+    });
+}
+
+TickRecorder::~TickRecorder()
+{
+    if (_file != nullptr)
+    {
+        [[maybe_unused]] auto finishResult = Finish();
+    }
+}
+
+std::expected<void, std::string> TickRecorder::Finish()
+{
+    if (_file == nullptr)
+    {
+        return std::unexpected(std::format("TickRecorder: {} is already finished", _filePath));
+    }
+
+    Flush();
+    _writer.request_stop();
+    _writer.join();
+    if (std::fclose(_file) != 0)
+    {
+        _hasFailed.store(true, std::memory_order_relaxed);
+    }
+    _file = nullptr;
+
+    if (HasFailed())
+    {
+        return std::unexpected(std::format("TickRecorder: Writing {} failed, it ends before the last recorded tick", _filePath));
+    }
+    return {};
+}
+
+void TickRecorder::RecordTick(uint64_t tickIndex, std::span<const std::byte> input, uint64_t checksum)
+{
+    AppendVarint(_chunk, tickIndex - _previousTickIndex);
+    AppendVarint(_chunk, input.size());
+    _chunk.insert(_chunk.end(), input.begin(), input.end());
+    for (auto i = 0u; i < 8; i++)
+    {
+        _chunk.push_back(static_cast<std::byte>(checksum >> (i * 8)));
+    }
+
+    _previousTickIndex = tickIndex;
+    _frameCount++;
+    if (_chunk.size() >= ChunkSize)
+    {
+        Flush();
+    }
+}
+
+void TickRecorder::Flush()
+{
+    if (_chunk.empty())
+    {
+        return;
+    }
+
+    std::vector<std::byte> nextChunk;
+    {
+        std::lock_guard lock(_chunksMutex);
+        _pendingChunks.push_back(std::move(_chunk));
+        if (!_freeChunks.empty())
+        {
+            nextChunk = std::move(_freeChunks.back());
+            _freeChunks.pop_back();
+        }
+    }
+    _chunksAvailable.notify_one();
+
+    nextChunk.clear();
+    nextChunk.reserve(ChunkSize);
+    _chunk = std::move(nextChunk);
+}
+
+void TickRecorder::WriteChunks(std::stop_token stopToken)
+{
+    std::vector<std::vector<std::byte>> chunks;
+    while (true)
+    {
+        {
+            std::unique_lock lock(_chunksMutex);
+            _freeChunks.insert(_freeChunks.end(), std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()));
+            chunks.clear();
+
+            // Chunks queued before the stop request still get written
+            if (!_chunksAvailable.wait(lock, stopToken, [this] { return !_pendingChunks.empty(); }) && _pendingChunks.empty())
+            {
+                return;
+            }
+            chunks.swap(_pendingChunks);
+        }
+
+        // Once a write failed the file stops there, skipping a chunk would leave a gap in the frames
+        if (HasFailed())
+        {
+            continue;
+        }
+
+        for (auto& chunk : chunks)
+        {
+            if (std::fwrite(chunk.data(), 1, chunk.size(), _file) != chunk.size())
+            {
+                _hasFailed.store(true, std::memory_order_relaxed);
+                break;
+            }
+            _writtenByteCount.fetch_add(chunk.size(), std::memory_order_relaxed);
+        }
+        if (!HasFailed() && std::fflush(_file) != 0)
+        {
+            _hasFailed.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::expected<TickRecordingReader, std::string> TickRecordingReader::Open(std::string_view filePath)
+{
+    auto fileResult = Io::MappedFile::Open(filePath);
+    if (!fileResult)
+    {
+        return std::unexpected(fileResult.error());
+    }
+
+    TickRecordingReader reader;
+    reader._file = std::move(fileResult.value());
+    auto data = reader._file.GetData();
+    if (data.size() < 12 || ReadLittleEndian(data, 0, 4) != TickRecordingMagic)
+    {
+        return std::unexpected(std::format("TickRecordingReader: {} is not a tick recording", filePath));
+    }
+
+    auto version = ReadLittleEndian(data, 4, 4);
+    if (version != TickRecordingVersion)
+    {
+        return std::unexpected(std::format("TickRecordingReader: {} has version {}, expected {}", filePath, version, TickRecordingVersion));
+    }
+
+    auto headerSize = ReadLittleEndian(data, 8, 4);
+    if (data.size() < 12 + headerSize)
+    {
+        return std::unexpected(std::format("TickRecordingReader: {} is truncated", filePath));
+    }
+
+    reader._header = data.subspan(12, headerSize);
+    reader._offset = 12 + headerSize;
+    return reader;
+}
+
+std::optional<TickFrame> TickRecordingReader::ReadNextFrame() noexcept
+{
+    auto data = _file.GetData();
+    auto offset = _offset;
+    auto tickDelta = ReadVarint(data, offset);
+    auto inputSize = ReadVarint(data, offset);
+    // Written so that a corrupt input size close to UINT64_MAX cannot wrap around
+    if (!tickDelta || !inputSize || data.size() - offset < 8 || *inputSize > data.size() - offset - 8)
+    {
+        return std::nullopt;
+    }
+
+    TickFrame frame;
+    frame.TickIndex = _tickIndex + *tickDelta;
+    frame.Input = data.subspan(offset, *inputSize);
+    frame.Checksum = ReadLittleEndian(data, offset + *inputSize, 8);
+
+    _tickIndex = frame.TickIndex;
+    _offset = offset + *inputSize + 8;
+    return frame;
+}
@@ -0,0 +1,538 @@
+#include <EngineCore/TransformKernels.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRANSFORM_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TRANSFORM_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    float* DestinationAt(float* destination, uint32_t stride, uint32_t index)
+    {
+        return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(destination) + static_cast<size_t>(stride) * index);
+    }
+
+    void ComposeTransformsScalar(
+        const TransformKernelInput& input,
+        uint32_t begin,
+        uint32_t end,
+        const float* viewProjection,
+        float* modelDestination,
+        uint32_t modelStride,
+        float* modelViewProjectionDestination,
+        uint32_t modelViewProjectionStride)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            auto x = input.RotationX[i];
+            auto y = input.RotationY[i];
+            auto z = input.RotationZ[i];
+            auto w = input.RotationW[i];
+            auto sx = input.ScaleX[i];
+            auto sy = input.ScaleY[i];
+            auto sz = input.ScaleZ[i];
+
+            // model[column][row]
+            float model[4][4] =
+            {
+                { (1.0f - 2.0f * (y * y + z * z)) * sx, 2.0f * (x * y + w * z) * sx, 2.0f * (x * z - w * y) * sx, 0.0f },
+                { 2.0f * (x * y - w * z) * sy, (1.0f - 2.0f * (x * x + z * z)) * sy, 2.0f * (y * z + w * x) * sy, 0.0f },
+                { 2.0f * (x * z + w * y) * sz, 2.0f * (y * z - w * x) * sz, (1.0f - 2.0f * (x * x + y * y)) * sz, 0.0f },
+                { input.PositionX[i], input.PositionY[i], input.PositionZ[i], 1.0f }
+            };
+
+            if (modelDestination != nullptr)
+            {
+                auto destination = DestinationAt(modelDestination, modelStride, i);
+                for (auto column = 0; column < 4; column++)
+                {
+                    for (auto row = 0; row < 4; row++)
+                    {
+                        destination[column * 4 + row] = model[column][row];
+                    }
+                }
+            }
+
+            auto destination = DestinationAt(modelViewProjectionDestination, modelViewProjectionStride, i);
+            for (auto column = 0; column < 4; column++)
+            {
+                for (auto row = 0; row < 4; row++)
+                {
+                    destination[column * 4 + row] =
+                        viewProjection[0 * 4 + row] * model[column][0] +
+                        viewProjection[1 * 4 + row] * model[column][1] +
+                        viewProjection[2 * 4 + row] * model[column][2] +
+                        viewProjection[3 * 4 + row] * model[column][3];
+                }
+            }
+        }
+    }
+
+#if defined(TRANSFORM_KERNELS_X86)
+
+    // Transposes 4 row vectors (one lane per instance) and stores one matrix column for 4 consecutive instances
+    void StoreColumnSse2(
+        float* destination,
+        uint32_t stride,
+        uint32_t index,
+        uint32_t column,
+        __m128 row0,
+        __m128 row1,
+        __m128 row2,
+        __m128 row3)
+    {
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        _mm_storeu_ps(DestinationAt(destination, stride, index + 0) + column * 4, row0);
+        _mm_storeu_ps(DestinationAt(destination, stride, index + 1) + column * 4, row1);
+        _mm_storeu_ps(DestinationAt(destination, stride, index + 2) + column * 4, row2);
+        _mm_storeu_ps(DestinationAt(destination, stride, index + 3) + column * 4, row3);
+    }
+
+    void ComposeTransformsSse2(
+        const TransformKernelInput& input,
+        uint32_t begin,
+        uint32_t end,
+        const float* viewProjection,
+        float* modelDestination,
+        uint32_t modelStride,
+        float* modelViewProjectionDestination,
+        uint32_t modelViewProjectionStride)
+    {
+        __m128 vp[4][4];
+        for (auto column = 0; column < 4; column++)
+        {
+            for (auto row = 0; row < 4; row++)
+            {
+                vp[column][row] = _mm_set1_ps(viewProjection[column * 4 + row]);
+            }
+        }
+
+        const auto one = _mm_set1_ps(1.0f);
+        const auto two = _mm_set1_ps(2.0f);
+        const auto zero = _mm_setzero_ps();
+
+        auto i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            auto x = _mm_loadu_ps(input.RotationX + i);
+            auto y = _mm_loadu_ps(input.RotationY + i);
+            auto z = _mm_loadu_ps(input.RotationZ + i);
+            auto w = _mm_loadu_ps(input.RotationW + i);
+            auto sx = _mm_loadu_ps(input.ScaleX + i);
+            auto sy = _mm_loadu_ps(input.ScaleY + i);
+            auto sz = _mm_loadu_ps(input.ScaleZ + i);
+
+            auto xx = _mm_mul_ps(x, x);
+            auto yy = _mm_mul_ps(y, y);
+            auto zz = _mm_mul_ps(z, z);
+            auto xy = _mm_mul_ps(x, y);
+            auto xz = _mm_mul_ps(x, z);
+            auto yz = _mm_mul_ps(y, z);
+            auto wx = _mm_mul_ps(w, x);
+            auto wy = _mm_mul_ps(w, y);
+            auto wz = _mm_mul_ps(w, z);
+
+            // model[column][row], rows 0..2, row 3 is (0, 0, 0, 1)
+            __m128 model[4][3] =
+            {
+                {
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx)
+                },
+                {
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy)
+                },
+                {
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                    _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz)
+                },
+                {
+                    _mm_loadu_ps(input.PositionX + i),
+                    _mm_loadu_ps(input.PositionY + i),
+                    _mm_loadu_ps(input.PositionZ + i)
+                }
+            };
+
+            if (modelDestination != nullptr)
+            {
+                for (auto column = 0u; column < 4u; column++)
+                {
+                    StoreColumnSse2(modelDestination, modelStride, i, column,
+                        model[column][0], model[column][1], model[column][2], column == 3 ? one : zero);
+                }
+            }
+
+            for (auto column = 0u; column < 4u; column++)
+            {
+                __m128 result[4];
+                for (auto row = 0; row < 4; row++)
+                {
+                    result[row] = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(vp[0][row], model[column][0]), _mm_mul_ps(vp[1][row], model[column][1])),
+                        _mm_mul_ps(vp[2][row], model[column][2]));
+                    if (column == 3)
+                    {
+                        result[row] = _mm_add_ps(result[row], vp[3][row]);
+                    }
+                }
+
+                StoreColumnSse2(modelViewProjectionDestination, modelViewProjectionStride, i, column,
+                    result[0], result[1], result[2], result[3]);
+            }
+        }
+
+        ComposeTransformsScalar(input, i, end, viewProjection,
+            modelDestination, modelStride, modelViewProjectionDestination, modelViewProjectionStride);
+    }
+
+    // Same as StoreColumnSse2 for 8 instances, the in-lane transpose leaves instance n in the
+    // low half and instance n + 4 in the high half of each result
+    TARGET_AVX2 void StoreColumnAvx2(
+        float* destination,
+        uint32_t stride,
+        uint32_t index,
+        uint32_t column,
+        __m256 row0,
+        __m256 row1,
+        __m256 row2,
+        __m256 row3)
+    {
+        auto t0 = _mm256_unpacklo_ps(row0, row1);
+        auto t1 = _mm256_unpackhi_ps(row0, row1);
+        auto t2 = _mm256_unpacklo_ps(row2, row3);
+        auto t3 = _mm256_unpackhi_ps(row2, row3);
+
+        __m256 columns[4] =
+        {
+            _mm256_shuffle_ps(t0, t2, 0x44),
+            _mm256_shuffle_ps(t0, t2, 0xEE),
+            _mm256_shuffle_ps(t1, t3, 0x44),
+            _mm256_shuffle_ps(t1, t3, 0xEE)
+        };
+
+        for (auto lane = 0u; lane < 4u; lane++)
+        {
+            _mm_storeu_ps(DestinationAt(destination, stride, index + lane) + column * 4, _mm256_castps256_ps128(columns[lane]));
+            _mm_storeu_ps(DestinationAt(destination, stride, index + lane + 4) + column * 4, _mm256_extractf128_ps(columns[lane], 1));
+        }
+    }
+
+    TARGET_AVX2 void ComposeTransformsAvx2(
+        const TransformKernelInput& input,
+        uint32_t begin,
+        uint32_t end,
+        const float* viewProjection,
+        float* modelDestination,
+        uint32_t modelStride,
+        float* modelViewProjectionDestination,
+        uint32_t modelViewProjectionStride)
+    {
+        __m256 vp[4][4];
+        for (auto column = 0; column < 4; column++)
+        {
+            for (auto row = 0; row < 4; row++)
+            {
+                vp[column][row] = _mm256_set1_ps(viewProjection[column * 4 + row]);
+            }
+        }
+
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto two = _mm256_set1_ps(2.0f);
+        const auto zero = _mm256_setzero_ps();
+
+        auto i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            auto x = _mm256_loadu_ps(input.RotationX + i);
+            auto y = _mm256_loadu_ps(input.RotationY + i);
+            auto z = _mm256_loadu_ps(input.RotationZ + i);
+            auto w = _mm256_loadu_ps(input.RotationW + i);
+            auto sx = _mm256_loadu_ps(input.ScaleX + i);
+            auto sy = _mm256_loadu_ps(input.ScaleY + i);
+            auto sz = _mm256_loadu_ps(input.ScaleZ + i);
+
+            auto xx = _mm256_mul_ps(x, x);
+            auto yy = _mm256_mul_ps(y, y);
+            auto zz = _mm256_mul_ps(z, z);
+            auto xy = _mm256_mul_ps(x, y);
+            auto xz = _mm256_mul_ps(x, z);
+            auto yz = _mm256_mul_ps(y, z);
+            auto wx = _mm256_mul_ps(w, x);
+            auto wy = _mm256_mul_ps(w, y);
+            auto wz = _mm256_mul_ps(w, z);
+
+            __m256 model[4][3] =
+            {
+                {
+                    _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx)
+                },
+                {
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                    _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy)
+                },
+                {
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                    _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz)
+                },
+                {
+                    _mm256_loadu_ps(input.PositionX + i),
+                    _mm256_loadu_ps(input.PositionY + i),
+                    _mm256_loadu_ps(input.PositionZ + i)
+                }
+            };
+
+            if (modelDestination != nullptr)
+            {
+                for (auto column = 0u; column < 4u; column++)
+                {
+                    StoreColumnAvx2(modelDestination, modelStride, i, column,
+                        model[column][0], model[column][1], model[column][2], column == 3 ? one : zero);
+                }
+            }
+
+            for (auto column = 0u; column < 4u; column++)
+            {
+                __m256 result[4];
+                for (auto row = 0; row < 4; row++)
+                {
+                    auto base = column == 3 ? vp[3][row] : zero;
+                    result[row] = _mm256_fmadd_ps(vp[0][row], model[column][0],
+                        _mm256_fmadd_ps(vp[1][row], model[column][1],
+                        _mm256_fmadd_ps(vp[2][row], model[column][2], base)));
+                }
+
+                StoreColumnAvx2(modelViewProjectionDestination, modelViewProjectionStride, i, column,
+                    result[0], result[1], result[2], result[3]);
+            }
+        }
+
+        ComposeTransformsSse2(input, i, end, viewProjection,
+            modelDestination, modelStride, modelViewProjectionDestination, modelViewProjectionStride);
+    }
+
+    bool IsAvx2Supported()
+    {
+#if defined(_MSC_VER)
+        int32_t cpuInfo[4] = {};
+        __cpuid(cpuInfo, 1);
+        auto hasFma = (cpuInfo[2] & (1 << 12)) != 0;
+        auto hasOsxsave = (cpuInfo[2] & (1 << 27)) != 0;
+        if (!hasFma || !hasOsxsave || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+
+#elif defined(TRANSFORM_KERNELS_NEON)
+
+    void StoreColumnNeon(
+        float* destination,
+        uint32_t stride,
+        uint32_t index,
+        uint32_t column,
+        float32x4_t row0,
+        float32x4_t row1,
+        float32x4_t row2,
+        float32x4_t row3)
+    {
+        auto t0 = vzipq_f32(row0, row2);
+        auto t1 = vzipq_f32(row1, row3);
+        auto u0 = vzipq_f32(t0.val[0], t1.val[0]);
+        auto u1 = vzipq_f32(t0.val[1], t1.val[1]);
+        vst1q_f32(DestinationAt(destination, stride, index + 0) + column * 4, u0.val[0]);
+        vst1q_f32(DestinationAt(destination, stride, index + 1) + column * 4, u0.val[1]);
+        vst1q_f32(DestinationAt(destination, stride, index + 2) + column * 4, u1.val[0]);
+        vst1q_f32(DestinationAt(destination, stride, index + 3) + column * 4, u1.val[1]);
+    }
+
+    void ComposeTransformsNeon(
+        const TransformKernelInput& input,
+        uint32_t begin,
+        uint32_t end,
+        const float* viewProjection,
+        float* modelDestination,
+        uint32_t modelStride,
+        float* modelViewProjectionDestination,
+        uint32_t modelViewProjectionStride)
+    {
+        float32x4_t vp[4][4];
+        for (auto column = 0; column < 4; column++)
+        {
+            for (auto row = 0; row < 4; row++)
+            {
+                vp[column][row] = vdupq_n_f32(viewProjection[column * 4 + row]);
+            }
+        }
+
+        const auto one = vdupq_n_f32(1.0f);
+        const auto two = vdupq_n_f32(2.0f);
+        const auto zero = vdupq_n_f32(0.0f);
+
+        auto i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            auto x = vld1q_f32(input.RotationX + i);
+            auto y = vld1q_f32(input.RotationY + i);
+            auto z = vld1q_f32(input.RotationZ + i);
+            auto w = vld1q_f32(input.RotationW + i);
+            auto sx = vld1q_f32(input.ScaleX + i);
+            auto sy = vld1q_f32(input.ScaleY + i);
+            auto sz = vld1q_f32(input.ScaleZ + i);
+
+            auto xx = vmulq_f32(x, x);
+            auto yy = vmulq_f32(y, y);
+            auto zz = vmulq_f32(z, z);
+            auto xy = vmulq_f32(x, y);
+            auto xz = vmulq_f32(x, z);
+            auto yz = vmulq_f32(y, z);
+            auto wx = vmulq_f32(w, x);
+            auto wy = vmulq_f32(w, y);
+            auto wz = vmulq_f32(w, z);
+
+            float32x4_t model[4][3] =
+            {
+                {
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(yy, zz)), sx),
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(xy, wz)), sx),
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(xz, wy)), sx)
+                },
+                {
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(xy, wz)), sy),
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, zz)), sy),
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(yz, wx)), sy)
+                },
+                {
+                    vmulq_f32(vmulq_f32(two, vaddq_f32(xz, wy)), sz),
+                    vmulq_f32(vmulq_f32(two, vsubq_f32(yz, wx)), sz),
+                    vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, yy)), sz)
+                },
+                {
+                    vld1q_f32(input.PositionX + i),
+                    vld1q_f32(input.PositionY + i),
+                    vld1q_f32(input.PositionZ + i)
+                }
+            };
+
+            if (modelDestination != nullptr)
+            {
+                for (auto column = 0u; column < 4u; column++)
+                {
+                    StoreColumnNeon(modelDestination, modelStride, i, column,
+                        model[column][0], model[column][1], model[column][2], column == 3 ? one : zero);
+                }
+            }
+
+            for (auto column = 0u; column < 4u; column++)
+            {
+                float32x4_t result[4];
+                for (auto row = 0; row < 4; row++)
+                {
+                    auto base = column == 3 ? vp[3][row] : zero;
+                    result[row] = vmlaq_f32(vmlaq_f32(vmlaq_f32(base,
+                        vp[2][row], model[column][2]),
+                        vp[1][row], model[column][1]),
+                        vp[0][row], model[column][0]);
+                }
+
+                StoreColumnNeon(modelViewProjectionDestination, modelViewProjectionStride, i, column,
+                    result[0], result[1], result[2], result[3]);
+            }
+        }
+
+        ComposeTransformsScalar(input, i, end, viewProjection,
+            modelDestination, modelStride, modelViewProjectionDestination, modelViewProjectionStride);
+    }
+
+#endif
+
+    TransformKernelLevel DetectTransformKernelLevel()
+    {
+#if defined(TRANSFORM_KERNELS_X86)
+        return IsAvx2Supported()
+            ? TransformKernelLevel::Avx2
+            : TransformKernelLevel::Sse2;
+#elif defined(TRANSFORM_KERNELS_NEON)
+        return TransformKernelLevel::Neon;
+#else
+        return TransformKernelLevel::Scalar;
+#endif
+    }
+}
+
+TransformKernelLevel GetSupportedTransformKernelLevel()
+{
+    static const auto supportedLevel = DetectTransformKernelLevel();
+    return supportedLevel;
+}
+
+bool IsTransformKernelLevelSupported(TransformKernelLevel level)
+{
+    auto supportedLevel = GetSupportedTransformKernelLevel();
+    switch (level)
+    {
+        case TransformKernelLevel::Scalar: return true;
+        case TransformKernelLevel::Sse2: return supportedLevel == TransformKernelLevel::Sse2 || supportedLevel == TransformKernelLevel::Avx2;
+        default:
+            return level == supportedLevel;
+    }
+}
+
+ComposeTransformsFunction GetComposeTransformsFunction(TransformKernelLevel level)
+{
+    auto supportedLevel = GetSupportedTransformKernelLevel();
+
+#if defined(TRANSFORM_KERNELS_X86)
+    if (level == TransformKernelLevel::Avx2 && supportedLevel == TransformKernelLevel::Avx2)
+    {
+        return ComposeTransformsAvx2;
+    }
+    if (level == TransformKernelLevel::Avx2 || level == TransformKernelLevel::Sse2)
+    {
+        return ComposeTransformsSse2;
+    }
+#elif defined(TRANSFORM_KERNELS_NEON)
+    if (level == TransformKernelLevel::Neon && supportedLevel == TransformKernelLevel::Neon)
+    {
+        return ComposeTransformsNeon;
+    }
+#endif
+
+    (void)supportedLevel;
+    return ComposeTransformsScalar;
+}
+
+std::string_view ToString(TransformKernelLevel level)
+{
+    switch (level)
+    {
+        case TransformKernelLevel::Scalar: return "Scalar";
+        case TransformKernelLevel::Sse2: return "SSE2";
+        case TransformKernelLevel::Avx2: return "AVX2";
+        case TransformKernelLevel::Neon: return "NEON";
+        default:
+            return "Unknown";
+    }
+}
@@ -0,0 +1,173 @@
+#include <EngineCore/TransformStore.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+
+#include <cassert>
+#include <initializer_list>
+
+namespace
+{
+    // Multiple of 8 so every task but the last runs the full width AVX2 loop
+    constexpr uint32_t TransformsPerTask = 4096;
+
+    template <typename T>
+    void SwapRemove(std::vector<T>& values, uint32_t index)
+    {
+        values[index] = values.back();
+        values.pop_back();
+    }
+}
+
+TransformStore::TransformStore()
+{
+    SetKernelLevel(GetSupportedTransformKernelLevel());
+}
+
+uint32_t TransformStore::Add(
+    const glm::vec3& position,
+    const glm::quat& rotation,
+    const glm::vec3& scale)
+{
+    auto index = GetCount();
+    _positionX.push_back(position.x);
+    _positionY.push_back(position.y);
+    _positionZ.push_back(position.z);
+    _rotationX.push_back(rotation.x);
+    _rotationY.push_back(rotation.y);
+    _rotationZ.push_back(rotation.z);
+    _rotationW.push_back(rotation.w);
+    _scaleX.push_back(scale.x);
+    _scaleY.push_back(scale.y);
+    _scaleZ.push_back(scale.z);
+    return index;
+}
+
+void TransformStore::Remove(uint32_t index)
+{
+    assert(index < GetCount());
+    SwapRemove(_positionX, index);
+    SwapRemove(_positionY, index);
+    SwapRemove(_positionZ, index);
+    SwapRemove(_rotationX, index);
+    SwapRemove(_rotationY, index);
+    SwapRemove(_rotationZ, index);
+    SwapRemove(_rotationW, index);
+    SwapRemove(_scaleX, index);
+    SwapRemove(_scaleY, index);
+    SwapRemove(_scaleZ, index);
+}
+
+void TransformStore::Clear()
+{
+    for (auto values : { &_positionX, &_positionY, &_positionZ, &_rotationX, &_rotationY, &_rotationZ, &_rotationW, &_scaleX, &_scaleY, &_scaleZ })
+    {
+        values->clear();
+    }
+}
+
+void TransformStore::Reserve(uint32_t capacity)
+{
+    for (auto values : { &_positionX, &_positionY, &_positionZ, &_rotationX, &_rotationY, &_rotationZ, &_rotationW, &_scaleX, &_scaleY, &_scaleZ })
+    {
+        values->reserve(capacity);
+    }
+}
+
+void TransformStore::SetPosition(uint32_t index, const glm::vec3& position) noexcept
+{
+    _positionX[index] = position.x;
+    _positionY[index] = position.y;
+    _positionZ[index] = position.z;
+}
+
+void TransformStore::SetRotation(uint32_t index, const glm::quat& rotation) noexcept
+{
+    _rotationX[index] = rotation.x;
+    _rotationY[index] = rotation.y;
+    _rotationZ[index] = rotation.z;
+    _rotationW[index] = rotation.w;
+}
+
+void TransformStore::SetScale(uint32_t index, const glm::vec3& scale) noexcept
+{
+    _scaleX[index] = scale.x;
+    _scaleY[index] = scale.y;
+    _scaleZ[index] = scale.z;
+}
+
+glm::vec3 TransformStore::GetPosition(uint32_t index) const noexcept
+{
+    return glm::vec3(_positionX[index], _positionY[index], _positionZ[index]);
+}
+
+glm::quat TransformStore::GetRotation(uint32_t index) const noexcept
+{
+    return glm::quat(_rotationW[index], _rotationX[index], _rotationY[index], _rotationZ[index]);
+}
+
+glm::vec3 TransformStore::GetScale(uint32_t index) const noexcept
+{
+    return glm::vec3(_scaleX[index], _scaleY[index], _scaleZ[index]);
+}
+
+void TransformStore::SetKernelLevel(TransformKernelLevel kernelLevel)
+{
+    _kernelLevel = kernelLevel;
+    _composeTransforms = GetComposeTransformsFunction(kernelLevel);
+}
+
+void TransformStore::ComputeMatrices(
+    const glm::mat4& viewProjection,
+    void* destination,
+    uint32_t destinationStride,
+    TaskScheduler* taskScheduler) const
+{
+    ComputeMatrices(viewProjection, nullptr, 0, destination, destinationStride, taskScheduler);
+}
+
+void TransformStore::ComputeMatrices(
+    const glm::mat4& viewProjection,
+    void* modelDestination,
+    uint32_t modelStride,
+    void* modelViewProjectionDestination,
+    uint32_t modelViewProjectionStride,
+    TaskScheduler* taskScheduler) const
+{
+    auto input = GetKernelInput();
+    auto count = GetCount();
+    auto composeRange = [&](uint32_t begin, uint32_t end)
+    {
+        _composeTransforms(
+            input,
+            begin,
+            end,
+            &viewProjection[0][0],
+            static_cast<float*>(modelDestination),
+            modelStride,
+            static_cast<float*>(modelViewProjectionDestination),
+            modelViewProjectionStride);
+    };
+
+    if (taskScheduler == nullptr)
+    {
+        composeRange(0, count);
+        return;
+    }
+
+    taskScheduler->ParallelFor(count, TransformsPerTask, composeRange);
+}
+
+TransformKernelInput TransformStore::GetKernelInput() const noexcept
+{
+    return TransformKernelInput{
+        .PositionX = _positionX.data(),
+        .PositionY = _positionY.data(),
+        .PositionZ = _positionZ.data(),
+        .RotationX = _rotationX.data(),
+        .RotationY = _rotationY.data(),
+        .RotationZ = _rotationZ.data(),
+        .RotationW = _rotationW.data(),
+        .ScaleX = _scaleX.data(),
+        .ScaleY = _scaleY.data(),
+        .ScaleZ = _scaleZ.data()
+    };
+}
@@ -0,0 +1,193 @@
+#include <EngineCore/UdpSocket.hpp>
+
+#include <format>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+    using SocketHandle = SOCKET;
+    using SocketLength = int;
+
+    bool InitializeSockets()
+    {
+        // WSAStartup is reference counted, one lifetime long initialization is enough
+        static const bool isInitialized = []()
+        {
+            WSADATA data = {};
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return isInitialized;
+    }
+
+    std::string GetLastSocketError()
+    {
+        return std::format("WSA error {}", WSAGetLastError());
+    }
+
+    void CloseSocket(intptr_t handle)
+    {
+        closesocket(static_cast<SocketHandle>(handle));
+    }
+
+    bool SetNonBlocking(SocketHandle handle)
+    {
+        u_long isNonBlocking = 1;
+        return ioctlsocket(handle, FIONBIO, &isNonBlocking) == 0;
+    }
+#else
+    using SocketHandle = int;
+    using SocketLength = socklen_t;
+
+    bool InitializeSockets()
+    {
+        return true;
+    }
+
+    std::string GetLastSocketError()
+    {
+        return std::strerror(errno);
+    }
+
+    void CloseSocket(intptr_t handle)
+    {
+        close(static_cast<SocketHandle>(handle));
+    }
+
+    bool SetNonBlocking(SocketHandle handle)
+    {
+        return fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+    }
+#endif
+}
+
+std::expected<UdpSocket, std::string> UdpSocket::Create(uint16_t port)
+{
+    if (!InitializeSockets())
+    {
+        return std::unexpected(std::string("Initializing sockets failed"));
+    }
+
+    auto handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#if defined(_WIN32)
+    if (handle == INVALID_SOCKET)
+#else
+    if (handle < 0)
+#endif
+    {
+        return std::unexpected(std::format("Creating socket failed. {}", GetLastSocketError()));
+    }
+
+    UdpSocket udpSocket;
+    udpSocket._handle = static_cast<intptr_t>(handle);
+
+    // Many clients behind one socket burst a lot of datagrams per tick, the default buffers drop them
+    auto bufferSize = 4 * 1024 * 1024;
+    setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+    setsockopt(handle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        return std::unexpected(std::format("Binding socket to port {} failed. {}", port, GetLastSocketError()));
+    }
+
+    SocketLength addressLength = sizeof(address);
+    if (getsockname(handle, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+    {
+        return std::unexpected(std::format("Querying socket address failed. {}", GetLastSocketError()));
+    }
+    udpSocket._port = ntohs(address.sin_port);
+
+    if (!SetNonBlocking(handle))
+    {
+        return std::unexpected(std::format("Making socket non blocking failed. {}", GetLastSocketError()));
+    }
+
+    return udpSocket;
+}
+
+UdpSocket::~UdpSocket()
+{
+    if (_handle != -1)
+    {
+        CloseSocket(_handle);
+    }
+}
+
+UdpSocket::UdpSocket(UdpSocket&& other) noexcept
+{
+    Swap(other);
+}
+
+UdpSocket& UdpSocket::operator=(UdpSocket&& other) noexcept
+{
+    if (this != &other)
+    {
+        UdpSocket(std::move(other)).Swap(*this);
+    }
+
+    return *this;
+}
+
+void UdpSocket::Swap(UdpSocket& other) noexcept
+{
+    std::swap(_handle, other._handle);
+    std::swap(_port, other._port);
+}
+
+bool UdpSocket::Send(const NetAddress& address, std::span<const std::byte> data) const noexcept
+{
+    sockaddr_in destination = {};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = htonl(address.Address);
+    destination.sin_port = htons(address.Port);
+
+    auto sentByteCount = sendto(
+        static_cast<SocketHandle>(_handle),
+        reinterpret_cast<const char*>(data.data()),
+        static_cast<int>(data.size()),
+        0,
+        reinterpret_cast<const sockaddr*>(&destination),
+        sizeof(destination));
+    return sentByteCount == static_cast<decltype(sentByteCount)>(data.size());
+}
+
+std::optional<uint32_t> UdpSocket::Receive(std::span<std::byte> buffer, NetAddress& address) const noexcept
+{
+    sockaddr_in source = {};
+    SocketLength sourceLength = sizeof(source);
+    auto receivedByteCount = recvfrom(
+        static_cast<SocketHandle>(_handle),
+        reinterpret_cast<char*>(buffer.data()),
+        static_cast<int>(buffer.size()),
+        0,
+        reinterpret_cast<sockaddr*>(&source),
+        &sourceLength);
+    if (receivedByteCount < 0)
+    {
+        return std::nullopt;
+    }
+
+    address.Address = ntohl(source.sin_addr.s_addr);
+    address.Port = ntohs(source.sin_port);
+    return static_cast<uint32_t>(receivedByteCount);
+}
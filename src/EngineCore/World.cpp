@@ -0,0 +1,155 @@
+#include <EngineCore/World.hpp>
+
+#include <cassert>
+
+World::World()
+{
+    _emptyArchetype = GetOrCreateArchetype(ComponentMask());
+}
+
+World::~World() = default;
+
+Entity World::CreateEntity()
+{
+    return AllocateEntity(_emptyArchetype);
+}
+
+void World::DestroyEntity(Entity entity)
+{
+    if (!IsAlive(entity))
+    {
+        return;
+    }
+
+    auto& record = _entityRecords[entity.Index];
+    auto movedEntity = record.CurrentArchetype->FreeRow(GetLocation(entity));
+    if (movedEntity.IsValid())
+    {
+        auto& movedRecord = _entityRecords[movedEntity.Index];
+        movedRecord.ChunkIndex = record.ChunkIndex;
+        movedRecord.Row = record.Row;
+    }
+
+    record.CurrentArchetype = nullptr;
+    record.Generation++;
+    if (record.Generation == 0)
+    {
+        record.Generation = 1;
+    }
+
+    _freeEntityIndices.push_back(entity.Index);
+    _entityCount--;
+}
+
+bool World::IsAlive(Entity entity) const noexcept
+{
+    return entity.Index < _entityRecords.size() &&
+        _entityRecords[entity.Index].Generation == entity.Generation &&
+        _entityRecords[entity.Index].CurrentArchetype != nullptr;
+}
+
+Entity World::AllocateEntity(Archetype* archetype)
+{
+    auto index = 0u;
+    if (!_freeEntityIndices.empty())
+    {
+        index = _freeEntityIndices.back();
+        _freeEntityIndices.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(_entityRecords.size());
+        _entityRecords.emplace_back();
+    }
+
+    auto& record = _entityRecords[index];
+    auto entity = Entity{ .Index = index, .Generation = record.Generation };
+
+    auto location = archetype->AllocateRow(entity);
+    record.CurrentArchetype = archetype;
+    record.ChunkIndex = location.ChunkIndex;
+    record.Row = location.Row;
+
+    _entityCount++;
+    return entity;
+}
+
+void World::MoveEntity(Entity entity, Archetype* targetArchetype)
+{
+    auto& record = _entityRecords[entity.Index];
+    auto sourceArchetype = record.CurrentArchetype;
+    auto sourceLocation = GetLocation(entity);
+    auto targetLocation = targetArchetype->AllocateRow(entity);
+
+    // Sizes come from the archetype, GetComponentInfo takes a global lock on every call
+    auto componentIds = sourceArchetype->GetComponentIds();
+    for (auto sourceColumn = 0; sourceColumn < static_cast<int32_t>(componentIds.size()); sourceColumn++)
+    {
+        auto targetColumn = targetArchetype->GetComponentColumn(componentIds[sourceColumn]);
+        if (targetColumn < 0)
+        {
+            continue;
+        }
+
+        std::memcpy(
+            targetArchetype->GetComponentPointer(targetLocation, targetColumn),
+            sourceArchetype->GetComponentPointer(sourceLocation, sourceColumn),
+            sourceArchetype->GetColumnSize(sourceColumn));
+    }
+
+    auto movedEntity = sourceArchetype->FreeRow(sourceLocation);
+    if (movedEntity.IsValid())
+    {
+        auto& movedRecord = _entityRecords[movedEntity.Index];
+        movedRecord.ChunkIndex = sourceLocation.ChunkIndex;
+        movedRecord.Row = sourceLocation.Row;
+    }
+
+    record.CurrentArchetype = targetArchetype;
+    record.ChunkIndex = targetLocation.ChunkIndex;
+    record.Row = targetLocation.Row;
+}
+
+Archetype* World::GetOrCreateArchetype(const ComponentMask& componentMask)
+{
+    if (auto archetypeIterator = _archetypeLookup.find(componentMask); archetypeIterator != _archetypeLookup.end())
+    {
+        return archetypeIterator->second;
+    }
+
+    auto archetype = _archetypes.emplace_back(std::make_unique<Archetype>(componentMask)).get();
+    _archetypeLookup.emplace(componentMask, archetype);
+    return archetype;
+}
+
+Archetype* World::GetAddEdge(Archetype* archetype, ComponentId componentId)
+{
+    if (auto edgeIterator = archetype->_addEdges.find(componentId); edgeIterator != archetype->_addEdges.end())
+    {
+        return edgeIterator->second;
+    }
+
+    auto componentMask = archetype->GetComponentMask();
+    componentMask.set(componentId);
+    auto targetArchetype = GetOrCreateArchetype(componentMask);
+
+    archetype->_addEdges.emplace(componentId, targetArchetype);
+    targetArchetype->_removeEdges.emplace(componentId, archetype);
+    return targetArchetype;
+}
+
+Archetype* World::GetRemoveEdge(Archetype* archetype, ComponentId componentId)
+{
+    if (auto edgeIterator = archetype->_removeEdges.find(componentId); edgeIterator != archetype->_removeEdges.end())
+    {
+        return edgeIterator->second;
+    }
+
+    auto componentMask = archetype->GetComponentMask();
+    componentMask.reset(componentId);
+    auto targetArchetype = GetOrCreateArchetype(componentMask);
+
+    archetype->_removeEdges.emplace(componentId, targetArchetype);
+    targetArchetype->_addEdges.emplace(componentId, archetype);
+    return targetArchetype;
+}
@@ -0,0 +1,55 @@
+#include <EngineCore/WorldPosition.hpp>
+
+#include <cmath>
+
+std::size_t SectorCoordinateHasher::operator()(const SectorCoordinate& sector) const noexcept
+{
+    auto hash = static_cast<uint64_t>(sector.X) * 0x9e3779b97f4a7c15ull;
+    hash ^= static_cast<uint64_t>(sector.Y) * 0xc2b2ae3d27d4eb4full + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<uint64_t>(sector.Z) * 0x165667b19e3779f9ull + (hash << 6) + (hash >> 2);
+    return static_cast<std::size_t>(hash);
+}
+
+WorldPosition NormalizeWorldPosition(const WorldPosition& position, float sectorSize) noexcept
+{
+    auto normalized = position;
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        auto sectorOffset = std::floor(normalized.Local[axis] / sectorSize);
+        if (sectorOffset == 0.0f)
+        {
+            continue;
+        }
+
+        normalized.Local[axis] -= sectorOffset * sectorSize;
+        // Rounding can land exactly on sectorSize
+        if (normalized.Local[axis] >= sectorSize)
+        {
+            normalized.Local[axis] -= sectorSize;
+            sectorOffset += 1.0f;
+        }
+
+        auto& sector = axis == 0 ? normalized.Sector.X : axis == 1 ? normalized.Sector.Y : normalized.Sector.Z;
+        sector += static_cast<int64_t>(sectorOffset);
+    }
+    return normalized;
+}
+
+WorldPosition OffsetWorldPosition(const WorldPosition& position, const glm::vec3& offset, float sectorSize) noexcept
+{
+    return NormalizeWorldPosition(WorldPosition{ position.Sector, position.Local + offset }, sectorSize);
+}
+
+glm::vec3 GetRelativeSectorOrigin(const SectorCoordinate& sector, const WorldPosition& origin, float sectorSize) noexcept
+{
+    auto size = static_cast<double>(sectorSize);
+    return glm::vec3(
+        static_cast<float>(static_cast<double>(sector.X - origin.Sector.X) * size - static_cast<double>(origin.Local.x)),
+        static_cast<float>(static_cast<double>(sector.Y - origin.Sector.Y) * size - static_cast<double>(origin.Local.y)),
+        static_cast<float>(static_cast<double>(sector.Z - origin.Sector.Z) * size - static_cast<double>(origin.Local.z)));
+}
+
+glm::vec3 GetRelativePosition(const WorldPosition& position, const WorldPosition& origin, float sectorSize) noexcept
+{
+    return GetRelativeSectorOrigin(position.Sector, origin, sectorSize) + position.Local;
+}
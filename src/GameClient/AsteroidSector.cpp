@@ -0,0 +1,231 @@
+#include <GameClient/AsteroidSector.hpp>
+#include <EngineCore/Utilities.hpp>
+
+#include <glad/glad.h>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <unordered_map>
+
+namespace
+{
+    float Random(uint32_t seed, uint32_t index)
+    {
+        auto value = seed + index * 0x9e3779b9u;
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return static_cast<float>(value) / static_cast<float>(UINT32_MAX);
+    }
+
+    // Subdivided icosahedron with seeded bumps and stretch, the stand in until real asteroid meshes exist
+    void CreateAsteroidMesh(
+        uint32_t subdivisionCount,
+        uint32_t seed,
+        std::vector<glm::vec3>& positions,
+        std::vector<uint32_t>& indices)
+    {
+        auto t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+        positions =
+        {
+            { -1.0f, t, 0.0f }, { 1.0f, t, 0.0f }, { -1.0f, -t, 0.0f }, { 1.0f, -t, 0.0f },
+            { 0.0f, -1.0f, t }, { 0.0f, 1.0f, t }, { 0.0f, -1.0f, -t }, { 0.0f, 1.0f, -t },
+            { t, 0.0f, -1.0f }, { t, 0.0f, 1.0f }, { -t, 0.0f, -1.0f }, { -t, 0.0f, 1.0f }
+        };
+        indices =
+        {
+            0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+            1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+            3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+            4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+        };
+        for (auto& position : positions)
+        {
+            position = glm::normalize(position);
+        }
+
+        for (auto subdivision = 0u; subdivision < subdivisionCount; subdivision++)
+        {
+            std::unordered_map<uint64_t, uint32_t> midpoints;
+            auto getMidpoint = [&](uint32_t a, uint32_t b)
+            {
+                auto key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                if (auto midpoint = midpoints.find(key); midpoint != midpoints.end())
+                {
+                    return midpoint->second;
+                }
+
+                positions.push_back(glm::normalize((positions[a] + positions[b]) * 0.5f));
+                return midpoints[key] = static_cast<uint32_t>(positions.size() - 1);
+            };
+
+            std::vector<uint32_t> subdividedIndices;
+            subdividedIndices.reserve(indices.size() * 4);
+            for (auto i = 0u; i < indices.size(); i += 3)
+            {
+                auto a = indices[i];
+                auto b = indices[i + 1];
+                auto c = indices[i + 2];
+                auto ab = getMidpoint(a, b);
+                auto bc = getMidpoint(b, c);
+                auto ca = getMidpoint(c, a);
+                subdividedIndices.insert(subdividedIndices.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+            }
+            indices = std::move(subdividedIndices);
+        }
+
+        auto frequency = glm::vec3(3.0f + 4.0f * Random(seed, 0), 3.0f + 4.0f * Random(seed, 1), 8.0f + 6.0f * Random(seed, 2));
+        auto phase = glm::vec3(Random(seed, 3), Random(seed, 4), Random(seed, 5)) * (2.0f * std::numbers::pi_v<float>);
+        auto stretch = glm::vec3(0.7f + 0.6f * Random(seed, 6), 0.7f + 0.6f * Random(seed, 7), 0.7f + 0.6f * Random(seed, 8));
+        for (auto& position : positions)
+        {
+            auto displacement =
+                0.15f * std::sin(position.x * frequency.x + phase.x) * std::cos(position.y * frequency.y + phase.y) +
+                0.05f * std::sin(position.z * frequency.z + phase.z);
+            position *= stretch * (1.0f + displacement);
+        }
+    }
+}
+
+std::expected<std::unique_ptr<SectorContent>, std::string> AsteroidSectorHandler::LoadSector(const SectorCoordinate& sector)
+{
+    auto seed = static_cast<uint32_t>(SectorCoordinateHasher()(sector));
+
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    CreateAsteroidMesh(3, seed, positions, indices);
+
+    MeshCookSettings cookSettings;
+    cookSettings.Impostor.FramesPerSide = 8;
+    cookSettings.Impostor.FrameResolution = 48;
+
+    auto content = std::make_unique<AsteroidSectorContent>();
+    if (auto cookedMeshResult = CookMesh(positions, indices, cookSettings))
+    {
+        content->Mesh = std::move(cookedMeshResult.value());
+    }
+    else
+    {
+        return std::unexpected(cookedMeshResult.error());
+    }
+
+    content->Vertices.reserve(positions.size());
+    for (auto& position : positions)
+    {
+        auto direction = glm::normalize(position);
+        auto uv = glm::vec2(
+            0.5f + std::atan2(direction.z, direction.x) / (2.0f * std::numbers::pi_v<float>),
+            0.5f + std::asin(direction.y) / std::numbers::pi_v<float>);
+        content->Vertices.push_back({ .Position = position, .Uv = uv });
+    }
+
+    auto asteroidCount = static_cast<uint32_t>(Random(seed, 9) * static_cast<float>(MaxAsteroidsPerSector));
+    content->LocalPositions.reserve(asteroidCount);
+    content->SpinAxes.reserve(asteroidCount);
+    content->SpinSpeeds.reserve(asteroidCount);
+    content->Transforms.Reserve(asteroidCount);
+    for (auto i = 0u; i < asteroidCount; i++)
+    {
+        auto randomIndex = 16 + i * 8;
+        auto localPosition = glm::vec3(Random(seed, randomIndex), Random(seed, randomIndex + 1), Random(seed, randomIndex + 2)) * _sectorSize;
+        auto spinAxis = glm::vec3(Random(seed, randomIndex + 3), Random(seed, randomIndex + 4), Random(seed, randomIndex + 5)) - 0.5f;
+
+        content->LocalPositions.push_back(localPosition);
+        content->SpinAxes.push_back(glm::normalize(spinAxis + glm::vec3(0.0f, 0.01f, 0.0f)));
+        content->SpinSpeeds.push_back(0.2f + Random(seed, randomIndex + 6));
+        content->Transforms.Add(localPosition, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.5f + 1.5f * Random(seed, randomIndex + 7)));
+    }
+    content->Lods.assign(asteroidCount, 0);
+
+    return content;
+}
+
+SectorUploadResult AsteroidSectorHandler::UploadSector(
+    [[maybe_unused]] const SectorCoordinate& sector,
+    SectorContent& content,
+    [[maybe_unused]] uint64_t byteBudget)
+{
+    auto& asteroidSector = static_cast<AsteroidSectorContent&>(content);
+
+    if (asteroidSector.Upload == nullptr)
+    {
+        auto& impostor = asteroidSector.Mesh.Impostor;
+        ImpostorUniforms impostorUniforms =
+        {
+            .CenterAndRadius = glm::vec4(impostor.Center, impostor.Radius),
+            .Parameters = glm::vec4(static_cast<float>(impostor.FramesPerSide), static_cast<float>(impostor.FrameResolution), 0.0f, 0.0f)
+        };
+        auto byteCount =
+            SizeInBytes(asteroidSector.Vertices) +
+            SizeInBytes(asteroidSector.Mesh.Indices) +
+            SizeInBytes(impostor.Texels) +
+            sizeof(ImpostorUniforms);
+
+        // The job takes the CPU side data along, the sector keeps only what LOD selection needs
+        auto upload = std::make_shared<AsteroidSectorUpload>();
+        _resourceLoader.Enqueue(
+            byteCount,
+            [
+                upload,
+                vertices = std::move(asteroidSector.Vertices),
+                indices = std::move(asteroidSector.Mesh.Indices),
+                texels = std::move(impostor.Texels),
+                atlasSize = impostor.GetSize(),
+                impostorUniforms
+            ]
+            (StagingUploader& stagingUploader)
+            {
+                // Written only through the staging ring, so the storage needs no flags at all
+                upload->VertexBuffer = Buffer::Create("Buffer_Vertices_AsteroidSector", SizeInBytes(vertices), GL_ARRAY_BUFFER, 0);
+                upload->IndexBuffer = Buffer::Create("Buffer_Indices_AsteroidSector", SizeInBytes(indices), GL_ELEMENT_ARRAY_BUFFER, 0);
+                upload->ImpostorUniformBuffer = Buffer::Create("Buffer_Uniforms_Impostor", sizeof(ImpostorUniforms), GL_UNIFORM_BUFFER, 0);
+                upload->ImpostorTexture = Texture::Create2D("Texture_Impostor_AsteroidSector", atlasSize, atlasSize, GL_RGBA8);
+
+                stagingUploader.Write(upload->VertexBuffer, 0, std::as_bytes(std::span(vertices)));
+                stagingUploader.Write(upload->IndexBuffer, 0, std::as_bytes(std::span(indices)));
+                stagingUploader.Write(upload->ImpostorUniformBuffer, 0, std::as_bytes(std::span(&impostorUniforms, 1)));
+                stagingUploader.Write(upload->ImpostorTexture, 0, 0, 0, atlasSize, atlasSize, GL_RGBA, GL_UNSIGNED_BYTE, std::as_bytes(std::span(texels)));
+            },
+            [upload]
+            {
+                upload->IsPublished = true;
+            });
+        asteroidSector.Upload = std::move(upload);
+
+        return SectorUploadResult{ .UploadedByteCount = byteCount, .IsComplete = false, .IsWaiting = true };
+    }
+
+    if (!asteroidSector.Upload->IsPublished)
+    {
+        return SectorUploadResult{ .UploadedByteCount = 0, .IsComplete = false, .IsWaiting = true };
+    }
+
+    auto& upload = *asteroidSector.Upload;
+    asteroidSector.VertexBuffer = MakePooled(_bufferPool, std::move(upload.VertexBuffer));
+    asteroidSector.IndexBuffer = MakePooled(_bufferPool, std::move(upload.IndexBuffer));
+    asteroidSector.ImpostorUniformBuffer = MakePooled(_bufferPool, std::move(upload.ImpostorUniformBuffer));
+    asteroidSector.ImpostorTexture = MakePooled(_texturePool, std::move(upload.ImpostorTexture));
+    asteroidSector.Upload.reset();
+
+    return SectorUploadResult{ .UploadedByteCount = 0, .IsComplete = true };
+}
+
+void AsteroidSectorHandler::UnloadSector(
+    [[maybe_unused]] const SectorCoordinate& sector,
+    SectorContent& content)
+{
+    auto& asteroidSector = static_cast<AsteroidSectorContent&>(content);
+    asteroidSector.Upload.reset();
+    asteroidSector.ImpostorTexture.reset();
+    asteroidSector.ImpostorUniformBuffer.reset();
+    asteroidSector.IndexBuffer.reset();
+    asteroidSector.VertexBuffer.reset();
+}
@@ -0,0 +1,36 @@
+#version 460 core
+
+layout (location = 0) out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout(location = 0) out vec3 v_world_position;
+
+struct Vertex
+{
+    float Position[3];
+    float Uv[2];
+};
+
+struct Instance
+{
+    mat4 ModelViewProjection;
+    mat4 Model;
+};
+
+layout(std430, binding = 0) restrict readonly buffer VertexBuffer { Vertex Vertices[]; };
+layout(std430, binding = 1) restrict readonly buffer IndexBuffer { uint Indices[]; };
+layout(std430, binding = 2) restrict readonly buffer InstanceBuffer { Instance Instances[]; };
+layout(std430, binding = 3) restrict readonly buffer InstanceIndexBuffer { uint InstanceIndices[]; };
+
+void main()
+{
+    Vertex vertex = Vertices[Indices[gl_VertexID]];
+    Instance instance = Instances[InstanceIndices[gl_InstanceID + gl_BaseInstance]];
+
+    vec4 position = vec4(vertex.Position[0], vertex.Position[1], vertex.Position[2], 1.0);
+
+    gl_Position = instance.ModelViewProjection * position;
+    v_world_position = (instance.Model * position).xyz;
+}
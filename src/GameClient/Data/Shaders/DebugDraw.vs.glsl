@@ -0,0 +1,41 @@
+#version 460 core
+
+layout (location = 0) out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout(location = 0) flat out vec4 v_color;
+
+struct Vertex
+{
+    float Position[3];
+    uint Color;
+};
+
+layout(std430, binding = 0) restrict readonly buffer VertexBuffer { Vertex Vertices[]; };
+
+layout(std140, binding = 4) uniform DebugDrawUniforms
+{
+    mat4 ViewProjection;
+    uvec4 OverlayFirstVertex;
+};
+
+vec3 SrgbToLinear(vec3 color)
+{
+    return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), greaterThan(color, vec3(0.04045)));
+}
+
+void main()
+{
+    Vertex vertex = Vertices[gl_VertexID];
+    gl_Position = ViewProjection * vec4(vertex.Position[0], vertex.Position[1], vertex.Position[2], 1.0);
+    if (uint(gl_VertexID) >= OverlayFirstVertex.x)
+    {
+        // On the near plane, in front of whatever depth the scene left
+        gl_Position.z = -gl_Position.w;
+    }
+
+    vec4 color = unpackUnorm4x8(vertex.Color);
+    v_color = vec4(SrgbToLinear(color.rgb), color.a);
+}
@@ -0,0 +1,42 @@
+#version 460 core
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D s_source;
+layout(binding = 0, r32f) uniform restrict writeonly image2D i_destination;
+
+layout(location = 0) uniform uint u_source_level;
+layout(location = 1) uniform uint u_is_copy;
+
+void main()
+{
+    ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destinationSize = imageSize(i_destination);
+    if (any(greaterThanEqual(position, destinationSize)))
+    {
+        return;
+    }
+
+    if (u_is_copy != 0u)
+    {
+        imageStore(i_destination, position, vec4(texelFetch(s_source, position, 0).r));
+        return;
+    }
+
+    // Odd sized sources leave a row or column behind that the last texel has to cover as well
+    int sourceLevel = int(u_source_level);
+    ivec2 sourceSize = textureSize(s_source, sourceLevel);
+    ivec2 sourcePosition = position * 2;
+    ivec2 extent = ivec2(2) + ivec2(equal(position, destinationSize - 1)) * (sourceSize & 1);
+
+    float depth = 0.0;
+    for (int y = 0; y < extent.y; y++)
+    {
+        for (int x = 0; x < extent.x; x++)
+        {
+            ivec2 samplePosition = min(sourcePosition + ivec2(x, y), sourceSize - 1);
+            depth = max(depth, texelFetch(s_source, samplePosition, sourceLevel).r);
+        }
+    }
+    imageStore(i_destination, position, vec4(depth));
+}
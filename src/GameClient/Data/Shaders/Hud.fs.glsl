@@ -0,0 +1,42 @@
+#version 460 core
+
+layout(location = 0) in vec2 v_uv;
+layout(location = 1) in vec2 v_local;
+layout(location = 2) flat in vec4 v_color;
+layout(location = 3) flat in uint v_kind;
+layout(location = 4) flat in vec2 v_radii;
+
+layout(location = 0) out vec4 o_color;
+
+layout(binding = 0) uniform sampler2D s_glyph_atlas;
+
+const uint QuadKindGlyph = 1u;
+const uint QuadKindRing = 2u;
+
+void main()
+{
+    float coverage = 1.0;
+    if (v_kind == QuadKindGlyph)
+    {
+        // The outline sits at 0.5, a pixel's worth of distance either side of it fades, whatever the text size
+        float distance = texture(s_glyph_atlas, v_uv).r;
+        coverage = clamp((distance - 0.5) / max(fwidth(distance), 1e-4) + 0.5, 0.0, 1.0);
+    }
+    else if (v_kind == QuadKindRing)
+    {
+        float radius = length(v_local);
+        float pixel = max(fwidth(radius), 1e-4);
+        coverage = clamp((v_radii.y - radius) / pixel + 0.5, 0.0, 1.0);
+        if (v_radii.x > 0.0)
+        {
+            coverage *= clamp((radius - v_radii.x) / pixel + 0.5, 0.0, 1.0);
+        }
+    }
+
+    float alpha = v_color.a * coverage;
+    if (alpha <= 0.0)
+    {
+        discard;
+    }
+    o_color = vec4(v_color.rgb * alpha, alpha);
+}
@@ -0,0 +1,59 @@
+#version 460 core
+
+layout (location = 0) out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout(location = 0) out vec2 v_uv;
+layout(location = 1) out vec2 v_local;
+layout(location = 2) flat out vec4 v_color;
+layout(location = 3) flat out uint v_kind;
+layout(location = 4) flat out vec2 v_radii;
+
+// Must match HudRenderer::Quad
+struct Quad
+{
+    vec2 Position;
+    vec2 Size;
+    vec2 UvMin;
+    vec2 UvMax;
+    uint Color;
+    uint Kind;
+    float InnerRadius;
+    float OuterRadius;
+};
+
+layout(std430, binding = 0) restrict readonly buffer QuadBuffer { Quad Quads[]; };
+
+layout(std140, binding = 3) uniform HudUniforms
+{
+    vec4 ViewportSize;
+};
+
+const vec2 Corners[6] = vec2[](
+    vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
+
+vec3 SrgbToLinear(vec3 color)
+{
+    return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), greaterThan(color, vec3(0.04045)));
+}
+
+void main()
+{
+    Quad quad = Quads[gl_InstanceID + gl_BaseInstance];
+    vec2 corner = Corners[gl_VertexID];
+
+    // Pixels from the top left into clip space, y flipped
+    vec2 position = quad.Position + corner * quad.Size;
+    gl_Position = vec4(position * ViewportSize.zw * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);
+
+    vec4 color = unpackUnorm4x8(quad.Color);
+    v_uv = mix(quad.UvMin, quad.UvMax, corner);
+    v_local = corner * 2.0 - 1.0;
+    // The framebuffer encodes to sRGB again
+    v_color = vec4(SrgbToLinear(color.rgb), color.a);
+    v_kind = quad.Kind;
+    v_radii = vec2(quad.InnerRadius, quad.OuterRadius);
+}
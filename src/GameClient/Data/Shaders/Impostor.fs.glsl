@@ -0,0 +1,97 @@
+#version 460 core
+
+layout(location = 0) in vec2 v_frame_uv;
+layout(location = 1) flat in vec2 v_frame;
+layout(location = 2) flat in mat3 v_object_to_world;
+layout(location = 5) in vec3 v_world_position;
+
+layout(location = 0) out vec4 o_color;
+
+layout(std140, binding = 0) uniform GlobalUniforms
+{
+    mat4 ViewProjection;
+    vec4 CameraPosition;
+    vec4 SunDirection;
+};
+
+layout(std140, binding = 1) uniform ImpostorUniforms
+{
+    vec4 ImpostorCenterAndRadius;
+    vec4 ImpostorParameters;
+};
+
+struct PointLight
+{
+    vec3 Position;
+    float Radius;
+    vec3 Color;
+    float Padding;
+};
+
+layout(std140, binding = 2) uniform ClusterUniforms
+{
+    mat4 View;
+    uvec4 GridSize;
+    vec4 DepthSlicing;
+    vec4 TileSize;
+    uvec4 Capacities;
+};
+
+layout(std430, binding = 4) restrict readonly buffer LightBuffer { PointLight Lights[]; };
+layout(std430, binding = 5) restrict readonly buffer ClusterBuffer { uvec2 ClusterLightRanges[]; };
+layout(std430, binding = 6) restrict readonly buffer LightIndexBuffer { uint LightIndices[]; };
+
+layout(binding = 0) uniform sampler2D s_impostor_atlas;
+
+const vec3 AsteroidAlbedo = vec3(0.45, 0.40, 0.35);
+const float AmbientLight = 0.05;
+
+// Only the lights binned into this fragment's froxel, must match the slicing in the engine's ClusteredLighting
+vec3 ShadeClusteredLights(vec3 position, vec3 normal, vec3 albedo)
+{
+    float viewDepth = -(View * vec4(position, 1.0)).z;
+    uint slice = uint(max(log(viewDepth) * DepthSlicing.x + DepthSlicing.y, 0.0));
+    uvec3 cluster = min(uvec3(uvec2(gl_FragCoord.xy / TileSize.xy), slice), GridSize.xyz - 1u);
+    uvec2 lightRange = ClusterLightRanges[cluster.x + GridSize.x * (cluster.y + GridSize.y * cluster.z)];
+
+    vec3 color = vec3(0.0);
+    for (uint i = 0; i < lightRange.y; i++)
+    {
+        PointLight light = Lights[LightIndices[lightRange.x + i]];
+        vec3 toLight = light.Position - position;
+        float distanceSquared = dot(toLight, toLight);
+        // Inverse square, windowed to reach zero at the radius the light was binned with
+        float window = clamp(1.0 - distanceSquared * distanceSquared / pow(light.Radius, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (distanceSquared + 1.0);
+        color += albedo * light.Color * max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-6))), 0.0) * attenuation;
+    }
+    return color;
+}
+
+vec3 OctahedralDecode(vec2 encoded)
+{
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    float framesPerSide = ImpostorParameters.x;
+    float frameResolution = ImpostorParameters.y;
+
+    // Keep bilinear taps from bleeding into the neighbouring frame
+    vec2 frameUv = clamp(v_frame_uv, vec2(0.5 / frameResolution), vec2(1.0 - 0.5 / frameResolution));
+    vec4 texel = texture(s_impostor_atlas, (v_frame + frameUv) / framesPerSide);
+    if (texel.a < 0.5)
+    {
+        discard;
+    }
+
+    vec3 normal = normalize(v_object_to_world * OctahedralDecode(texel.rg * 2.0 - 1.0));
+    float diffuse = max(dot(normal, SunDirection.xyz), 0.0);
+
+    o_color = vec4(AsteroidAlbedo * (diffuse + AmbientLight) + ShadeClusteredLights(v_world_position, normal, AsteroidAlbedo), 1.0);
+}
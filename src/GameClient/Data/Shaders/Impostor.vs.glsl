@@ -0,0 +1,86 @@
+#version 460 core
+
+layout (location = 0) out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout(location = 0) out vec2 v_frame_uv;
+layout(location = 1) flat out vec2 v_frame;
+layout(location = 2) flat out mat3 v_object_to_world;
+layout(location = 5) out vec3 v_world_position;
+
+struct Instance
+{
+    mat4 ModelViewProjection;
+    mat4 Model;
+};
+
+layout(std430, binding = 2) restrict readonly buffer InstanceBuffer { Instance Instances[]; };
+layout(std430, binding = 3) restrict readonly buffer InstanceIndexBuffer { uint InstanceIndices[]; };
+
+layout(std140, binding = 0) uniform GlobalUniforms
+{
+    mat4 ViewProjection;
+    vec4 CameraPosition;
+    vec4 SunDirection;
+};
+
+layout(std140, binding = 1) uniform ImpostorUniforms
+{
+    vec4 ImpostorCenterAndRadius;
+    vec4 ImpostorParameters;
+};
+
+const vec2 Corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// Must match OctahedralEncode and OctahedralDecode in the engine's impostor baker
+vec2 OctahedralEncode(vec3 direction)
+{
+    vec3 n = direction / (abs(direction.x) + abs(direction.y) + abs(direction.z));
+    if (n.z >= 0.0)
+    {
+        return n.xy;
+    }
+    return (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 OctahedralDecode(vec2 encoded)
+{
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    Instance instance = Instances[InstanceIndices[gl_InstanceID + gl_BaseInstance]];
+
+    mat3 objectToWorld = mat3(instance.Model);
+    vec3 center = (instance.Model * vec4(ImpostorCenterAndRadius.xyz, 1.0)).xyz;
+
+    // Model is rotation and uniform scale, its transpose brings directions back into object space
+    vec3 viewDirection = normalize(transpose(objectToWorld) * (CameraPosition.xyz - center));
+
+    // Pick the baked frame closest to the view direction and place its quad the way the baker projected it
+    float framesPerSide = ImpostorParameters.x;
+    vec2 frame = clamp(floor((OctahedralEncode(viewDirection) * 0.5 + 0.5) * framesPerSide), vec2(0.0), vec2(framesPerSide - 1.0));
+    vec3 frameDirection = OctahedralDecode((frame + 0.5) / framesPerSide * 2.0 - 1.0);
+    vec3 upHint = abs(frameDirection.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(upHint, frameDirection));
+    vec3 up = cross(frameDirection, right);
+
+    vec2 corner = Corners[gl_VertexID];
+    vec3 position = ImpostorCenterAndRadius.xyz + (right * corner.x + up * corner.y) * ImpostorCenterAndRadius.w;
+
+    gl_Position = instance.ModelViewProjection * vec4(position, 1.0);
+    v_frame_uv = corner * 0.5 + 0.5;
+    v_frame = frame;
+    v_object_to_world = objectToWorld;
+    // The quad's surface, close enough to the asteroid's at the distances impostors are drawn at
+    v_world_position = (instance.Model * vec4(position, 1.0)).xyz;
+}
@@ -0,0 +1,94 @@
+#version 460 core
+
+#define MAX_CLUSTER_LIGHT_COUNT 256
+
+layout(local_size_x = 64) in;
+
+struct PointLight
+{
+    vec3 Position;
+    float Radius;
+    vec3 Color;
+    float Padding;
+};
+
+struct ClusterBounds
+{
+    vec4 Min;
+    vec4 Max;
+};
+
+layout(std140, binding = 2) uniform ClusterUniforms
+{
+    mat4 View;
+    uvec4 GridSize;
+    vec4 DepthSlicing;
+    vec4 TileSize;
+    uvec4 Capacities;
+};
+
+layout(std430, binding = 4) restrict readonly buffer LightBuffer { PointLight Lights[]; };
+layout(std430, binding = 5) restrict writeonly buffer ClusterBuffer { uvec2 ClusterLightRanges[]; };
+layout(std430, binding = 6) restrict writeonly buffer LightIndexBuffer { uint LightIndices[]; };
+layout(std430, binding = 7) restrict buffer BinningBuffer
+{
+    uint LightIndexCount;
+    ClusterBounds Bounds[];
+};
+
+shared uint s_light_count;
+shared uint s_light_offset;
+shared uint s_light_indices[MAX_CLUSTER_LIGHT_COUNT];
+
+bool IsSphereInBox(vec3 center, float radius, vec3 boxMin, vec3 boxMax)
+{
+    vec3 offset = center - clamp(center, boxMin, boxMax);
+    return dot(offset, offset) <= radius * radius;
+}
+
+// One group per froxel, its threads test the lights in strides and gather the hits in shared memory,
+// then reserve the froxel's part of the index list with a single atomic
+void main()
+{
+    uint cluster = gl_WorkGroupID.x;
+    uint lightCount = GridSize.w;
+    if (gl_LocalInvocationIndex == 0)
+    {
+        s_light_count = 0;
+    }
+    barrier();
+
+    ClusterBounds bounds = Bounds[cluster];
+    for (uint light = gl_LocalInvocationIndex; light < lightCount; light += gl_WorkGroupSize.x)
+    {
+        vec3 center = (View * vec4(Lights[light].Position, 1.0)).xyz;
+        if (IsSphereInBox(center, Lights[light].Radius, bounds.Min.xyz, bounds.Max.xyz))
+        {
+            uint slot = atomicAdd(s_light_count, 1u);
+            if (slot < MAX_CLUSTER_LIGHT_COUNT)
+            {
+                s_light_indices[slot] = light;
+            }
+        }
+    }
+    barrier();
+
+    uint clusterLightCount = min(s_light_count, MAX_CLUSTER_LIGHT_COUNT);
+    if (gl_LocalInvocationIndex == 0)
+    {
+        uint offset = atomicAdd(LightIndexCount, clusterLightCount);
+        // Past the capacity the froxel goes unlit rather than writing out of bounds
+        s_light_offset = offset + clusterLightCount <= Capacities.x ? offset : Capacities.x;
+        ClusterLightRanges[cluster] = uvec2(s_light_offset, s_light_offset < Capacities.x ? clusterLightCount : 0u);
+    }
+    barrier();
+
+    if (s_light_offset >= Capacities.x)
+    {
+        return;
+    }
+    for (uint i = gl_LocalInvocationIndex; i < clusterLightCount; i += gl_WorkGroupSize.x)
+    {
+        LightIndices[s_light_offset + i] = s_light_indices[i];
+    }
+}
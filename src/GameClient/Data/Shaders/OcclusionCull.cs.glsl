@@ -0,0 +1,150 @@
+#version 460 core
+
+layout(local_size_x = 64) in;
+
+struct Instance
+{
+    mat4 ModelViewProjection;
+    mat4 Model;
+};
+
+struct Draw
+{
+    vec4 BoundingSphere;
+    uint FirstSlot;
+};
+
+struct DrawCommand
+{
+    uint Count;
+    uint InstanceCount;
+    uint First;
+    uint BaseInstance;
+};
+
+layout(std140, binding = 8) uniform CullUniforms
+{
+    mat4 PyramidViewProjection;
+    vec4 FrustumPlanes[6];
+    vec4 PyramidSize;
+    uint Pass;
+    uint Flags;
+    uint SlotOffset;
+    uint SlotCount;
+    uint DrawOffset;
+    uint CommandOffset;
+};
+
+layout(std430, binding = 8) restrict readonly buffer InstanceBuffer { Instance Instances[]; };
+layout(std430, binding = 9) restrict readonly buffer InstanceIndexBuffer { uint InstanceIndices[]; };
+layout(std430, binding = 10) restrict readonly buffer DrawBuffer { Draw Draws[]; };
+layout(std430, binding = 11) restrict readonly buffer SlotDrawBuffer { uint SlotDraws[]; };
+layout(std430, binding = 12) restrict buffer CommandBuffer { DrawCommand Commands[]; };
+layout(std430, binding = 13) restrict writeonly buffer CulledIndexBuffer { uint CulledIndices[]; };
+layout(std430, binding = 14) restrict buffer VisibilityBuffer { uint Visibilities[]; };
+
+layout(binding = 8) uniform sampler2D s_pyramid;
+
+const uint PassEarly = 0u;
+const uint FlagEnabled = 1u;
+const uint FlagOcclusion = 2u;
+
+bool IsInFrustum(vec3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(FrustumPlanes[i].xyz, center) + FrustumPlanes[i].w < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Projects the sphere's box into the pyramid's frame and compares its nearest depth against the farthest
+// depth of the pyramid texels it covers, picking the level where that is at most two by two
+bool IsOccluded(vec3 center, float radius)
+{
+    vec2 minUv = vec2(1.0);
+    vec2 maxUv = vec2(0.0);
+    float nearestDepth = 1.0;
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = PyramidViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0)
+        {
+            // Crosses the camera plane, nothing sensible to test
+            return false;
+        }
+
+        vec3 ndc = clip.xyz / clip.w;
+        minUv = min(minUv, ndc.xy * 0.5 + 0.5);
+        maxUv = max(maxUv, ndc.xy * 0.5 + 0.5);
+        nearestDepth = min(nearestDepth, ndc.z * 0.5 + 0.5);
+    }
+
+    minUv = clamp(minUv, 0.0, 1.0);
+    maxUv = clamp(maxUv, 0.0, 1.0);
+    vec2 extent = (maxUv - minUv) * PyramidSize.xy;
+    int levelCount = int(PyramidSize.z);
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, levelCount - 1);
+
+    ivec2 levelSize = textureSize(s_pyramid, level);
+    ivec2 minTexel = clamp(ivec2(minUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+    ivec2 maxTexel = clamp(ivec2(maxUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+    if (any(greaterThan(maxTexel - minTexel, ivec2(1))) && level < levelCount - 1)
+    {
+        level++;
+        levelSize = textureSize(s_pyramid, level);
+        minTexel = clamp(ivec2(minUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+        maxTexel = clamp(ivec2(maxUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+    }
+
+    float pyramidDepth = max(
+        max(texelFetch(s_pyramid, minTexel, level).r, texelFetch(s_pyramid, ivec2(maxTexel.x, minTexel.y), level).r),
+        max(texelFetch(s_pyramid, ivec2(minTexel.x, maxTexel.y), level).r, texelFetch(s_pyramid, maxTexel, level).r));
+    return nearestDepth > pyramidDepth;
+}
+
+void main()
+{
+    uint slot = gl_GlobalInvocationID.x;
+    if (slot >= SlotCount)
+    {
+        return;
+    }
+
+    // The late pass only looks at what the early pass rejected
+    if (Pass != PassEarly && Visibilities[slot] != 0u)
+    {
+        return;
+    }
+
+    uint drawIndex = SlotDraws[SlotOffset + slot];
+    Draw draw = Draws[DrawOffset + drawIndex];
+    uint instanceIndex = InstanceIndices[SlotOffset + slot];
+    mat4 model = Instances[instanceIndex].Model;
+
+    // Model is rotation and uniform scale
+    vec3 center = (model * vec4(draw.BoundingSphere.xyz, 1.0)).xyz;
+    float radius = draw.BoundingSphere.w * length(model[0].xyz);
+
+    bool isVisible = true;
+    if ((Flags & FlagEnabled) != 0u)
+    {
+        isVisible = IsInFrustum(center, radius) && ((Flags & FlagOcclusion) == 0u || !IsOccluded(center, radius));
+    }
+
+    if (Pass == PassEarly)
+    {
+        Visibilities[slot] = isVisible ? 1u : 0u;
+    }
+
+    if (isVisible)
+    {
+        uint commandIndex = CommandOffset + drawIndex;
+        uint culledIndex = atomicAdd(Commands[commandIndex].InstanceCount, 1u);
+        CulledIndices[Commands[commandIndex].BaseInstance + culledIndex] = instanceIndex;
+    }
+}
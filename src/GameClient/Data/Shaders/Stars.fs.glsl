@@ -0,0 +1,13 @@
+#version 460 core
+
+layout(location = 0) flat in vec3 v_color;
+
+layout(location = 0) out vec4 o_color;
+
+void main()
+{
+    // Gaussian falloff over the point, which is additively blended
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    float falloff = exp(-4.0 * dot(offset, offset));
+    o_color = vec4(v_color * falloff, 0.0);
+}
@@ -0,0 +1,78 @@
+#version 460 core
+
+layout (location = 0) out gl_PerVertex
+{
+    vec4 gl_Position;
+    float gl_PointSize;
+};
+
+layout(location = 0) flat out vec3 v_color;
+
+// Must match PackedStar
+struct Star
+{
+    uint Direction;
+    uint MagnitudeAndColor;
+};
+
+layout(std430, binding = 0) restrict readonly buffer StarBuffer { Star Stars[]; };
+
+layout(std140, binding = 5) uniform StarUniforms
+{
+    mat4 ViewProjection;
+    // x reference magnitude, y limiting magnitude
+    vec4 Parameters;
+};
+
+// Must match StarMinMagnitude, StarMagnitudeRange, StarMinColorIndex and StarColorIndexRange
+const float MinMagnitude = -2.0;
+const float MagnitudeRange = 32.0;
+const float MinColorIndex = -1.0;
+const float ColorIndexRange = 4.0;
+
+// A star of the reference magnitude fills this many pixels across at full brightness
+const float ReferencePointSize = 2.0;
+const float MaxPointSize = 8.0;
+
+vec3 OctahedralDecode(vec2 encoded)
+{
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// B-V color index to a tint, blue-white through to orange-red
+vec3 ColorIndexToColor(float colorIndex)
+{
+    vec3 blue = vec3(0.62, 0.71, 1.0);
+    vec3 white = vec3(1.0, 0.96, 0.92);
+    vec3 red = vec3(1.0, 0.56, 0.32);
+    return colorIndex < 0.6
+        ? mix(blue, white, smoothstep(-0.4, 0.6, colorIndex))
+        : mix(white, red, smoothstep(0.6, 2.0, colorIndex));
+}
+
+void main()
+{
+    Star star = Stars[gl_VertexID];
+    vec3 direction = OctahedralDecode(unpackUnorm2x16(star.Direction) * 2.0 - 1.0);
+    vec2 magnitudeAndColor = unpackUnorm2x16(star.MagnitudeAndColor);
+    float magnitude = MinMagnitude + magnitudeAndColor.x * MagnitudeRange;
+    float colorIndex = MinColorIndex + magnitudeAndColor.y * ColorIndexRange;
+
+    // Directions only, pinned to the far plane behind everything the scene drew
+    gl_Position = ViewProjection * vec4(direction, 0.0);
+    gl_Position.z = gl_Position.w * 0.99999;
+
+    // Flux relative to the reference magnitude, bright stars grow, faint ones keep a pixel and dim instead
+    float flux = pow(10.0, -0.4 * (magnitude - Parameters.x));
+    float pointSize = clamp(ReferencePointSize * sqrt(flux), 1.0, MaxPointSize);
+    float brightness = flux * ReferencePointSize * ReferencePointSize / (pointSize * pointSize);
+    // Fades out towards the limiting magnitude so stars do not pop in as it moves
+    brightness *= clamp(Parameters.y - magnitude, 0.0, 1.0);
+
+    gl_PointSize = pointSize;
+    v_color = ColorIndexToColor(colorIndex) * brightness;
+}
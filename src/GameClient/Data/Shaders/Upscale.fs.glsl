@@ -0,0 +1,29 @@
+#version 460 core
+
+layout(location = 0) in vec2 v_uv;
+
+layout(location = 0) out vec4 o_color;
+
+layout(binding = 0) uniform sampler2D s_source;
+
+layout(location = 0) uniform float u_sharpness;
+
+void main()
+{
+    // Bilinear upscale, sharpened with the scene's neighbours one source texel away
+    vec2 texelSize = 1.0 / vec2(textureSize(s_source, 0));
+    vec3 center = texture(s_source, v_uv).rgb;
+    vec3 north = texture(s_source, v_uv + vec2(0.0, texelSize.y)).rgb;
+    vec3 south = texture(s_source, v_uv - vec2(0.0, texelSize.y)).rgb;
+    vec3 east = texture(s_source, v_uv + vec2(texelSize.x, 0.0)).rgb;
+    vec3 west = texture(s_source, v_uv - vec2(texelSize.x, 0.0)).rgb;
+
+    // Contrast adaptive, neighbourhoods close to black or white sharpen less so edges do not ring
+    vec3 minimum = min(center, min(min(north, south), min(east, west)));
+    vec3 maximum = max(center, max(max(north, south), max(east, west)));
+    vec3 amplitude = sqrt(clamp(min(minimum, 1.0 - maximum) / max(maximum, vec3(1e-5)), 0.0, 1.0));
+    vec3 weight = -amplitude * mix(0.125, 0.2, u_sharpness);
+
+    vec3 color = (center + (north + south + east + west) * weight) / (1.0 + 4.0 * weight);
+    o_color = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
@@ -0,0 +1,77 @@
+#include <GameClient/DynamicLights.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <cmath>
+
+namespace
+{
+    // Spawn volume relative to the camera, which flies towards -z
+    constexpr glm::vec3 SpawnMin = glm::vec3(-150.0f, -80.0f, -400.0f);
+    constexpr glm::vec3 SpawnMax = glm::vec3(150.0f, 80.0f, -20.0f);
+    constexpr float BehindCameraDistance = 20.0f;
+    constexpr float MaxDistance = 500.0f;
+
+    float Random(uint32_t seed, uint32_t index)
+    {
+        auto value = seed + index * 0x9e3779b9u;
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return static_cast<float>(value) / static_cast<float>(UINT32_MAX);
+    }
+}
+
+DynamicLightField::DynamicLightField(uint32_t lightCount, float sectorSize)
+    : _sectorSize(sectorSize),
+      _lights(lightCount),
+      _pointLights(lightCount)
+{
+    for (auto i = 0u; i < lightCount; i++)
+    {
+        Spawn(_lights[i], i, WorldPosition{});
+    }
+}
+
+std::span<const PointLight> DynamicLightField::Update(const WorldPosition& cameraPosition, float time, float deltaTime)
+{
+    for (auto i = 0u; i < _lights.size(); i++)
+    {
+        auto& light = _lights[i];
+        light.Position = OffsetWorldPosition(light.Position, light.Velocity * deltaTime, _sectorSize);
+
+        auto relativePosition = GetRelativePosition(light.Position, cameraPosition, _sectorSize);
+        if (relativePosition.z > BehindCameraDistance || glm::length(relativePosition) > MaxDistance)
+        {
+            Spawn(light, i, cameraPosition);
+            relativePosition = GetRelativePosition(light.Position, cameraPosition, _sectorSize);
+        }
+
+        // Sharp pulses rather than a smooth sine, more like muzzle flashes and blasts
+        auto flicker = std::pow(0.5f + 0.5f * std::sin(time * light.FlickerRate + light.Phase), 4.0f);
+        _pointLights[i] = PointLight
+        {
+            .Position = relativePosition,
+            .Radius = light.Radius,
+            .Color = light.Color * (0.2f + 0.8f * flicker),
+            .Padding = 0.0f
+        };
+    }
+    return _pointLights;
+}
+
+void DynamicLightField::Spawn(Light& light, uint32_t lightIndex, const WorldPosition& cameraPosition)
+{
+    auto seed = lightIndex * 7919u + light.SpawnCount++;
+    auto offset = glm::mix(SpawnMin, SpawnMax, glm::vec3(Random(seed, 0), Random(seed, 1), Random(seed, 2)));
+    light.Position = OffsetWorldPosition(cameraPosition, offset, _sectorSize);
+    light.Velocity = (glm::vec3(Random(seed, 3), Random(seed, 4), Random(seed, 5)) - 0.5f) * 20.0f;
+    // Engine orange to plasma blue
+    light.Color = glm::mix(glm::vec3(1.0f, 0.45f, 0.1f), glm::vec3(0.25f, 0.55f, 1.0f), Random(seed, 6)) * (20.0f + 60.0f * Random(seed, 7));
+    light.Radius = 8.0f + 24.0f * Random(seed, 8);
+    light.FlickerRate = 1.0f + 10.0f * Random(seed, 9);
+    light.Phase = Random(seed, 10) * 6.2831853f;
+}
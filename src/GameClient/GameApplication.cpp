@@ -1,15 +1,61 @@
 #include <GameClient/GameApplication.hpp>
 #include <Engine/Format.hpp>
 #include <Engine/PrimitiveTopology.hpp>
+#include <Engine/RenderGraph.hpp>
 #include <Engine/GraphicsPipelineBuilder.hpp>
-#include <Engine/Utilities.hpp>
+#include <EngineCore/Utilities.hpp>
+#include <Engine/VertexPulling.hpp>
 
 #include <glad/glad.h>
+#include <GLFW/glfw3.h>
 #include <spdlog/spdlog.h>
 
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
 #include <array>
-#include <span>
+#include <chrono>
+#include <cmath>
 #include <format>
+#include <numbers>
+#include <span>
+#include <thread>
+
+namespace
+{
+    constexpr float CameraFieldOfView = std::numbers::pi_v<float> / 3.0f;
+    constexpr uint16_t DefaultServerPort = 27015;
+    constexpr float CameraFarPlane = 1000.0f;
+
+    // Render key ids
+    constexpr uint32_t OpaquePass = 0;
+    constexpr uint32_t DisoccludedPass = 1;
+    constexpr uint32_t AsteroidPipeline = 0;
+    constexpr uint32_t ImpostorPipeline = 1;
+
+    // Uniform location in the upscale shader, and how much it sharpens from 0 to 1
+    constexpr int32_t UpscaleSharpnessLocation = 0;
+    constexpr float UpscaleSharpness = 0.5f;
+
+    // Any TrueType font dropped there replaces the built in one
+    constexpr std::string_view HudFontFilePath = "Data/Fonts/Hud.ttf";
+    constexpr float HudTextSize = 20.0f;
+    constexpr float HudBenchmarkTextSize = 12.0f;
+    constexpr uint32_t HudMaxQuadCount = 65536;
+    // Leaves room for the regular HUD next to the benchmark's glyphs
+    constexpr uint32_t HudReservedQuadCount = 1024;
+
+    // Lights closer than this get their radius drawn
+    constexpr float DebugDrawLightDistance = 48.0f;
+    // Longest step the dynamic lights move by in one frame
+    constexpr float MaxLightDeltaSeconds = 0.1f;
+
+    // Where --star-benchmark writes its synthetic catalog before loading it like any other
+    constexpr std::string_view StarBenchmarkFilePath = "Data/StarBenchmark.bin";
+    constexpr uint32_t StarBenchmarkSeed = 1;
+}
 
 bool GameApplication::Load()
 {
@@ -18,64 +64,860 @@ bool GameApplication::Load()
         return false;
     }
 
-    if (auto graphicsPipelineResult = _device->CreateGraphicsPipelineBuilder("Simple")
+    if (auto graphicsPipelineResult = _device->CreateGraphicsPipelineBuilder("Asteroid")
+        .WithShaders("Data/Shaders/Asteroid.vs.glsl", "Data/Shaders/Asteroid.fs.glsl")
+        .WithPrimitiveTopology(PrimitiveTopology::Triangles)
+        .Build())
+    {
+        _asteroidPipeline = std::move(graphicsPipelineResult.value());
+    }
+    else
+    {
+        spdlog::error("Building graphics pipeline \"{}\" failed. {}", "Asteroid", graphicsPipelineResult.error());
+        return false;
+    }
 
-        .WithShaders("Data/Shaders/SimpleVertexPulling.vs.glsl", "Data/Shaders/Simple.fs.glsl")
+    if (auto graphicsPipelineResult = _device->CreateGraphicsPipelineBuilder("Upscale")
+        .WithShaders("Data/Shaders/Upscale.vs.glsl", "Data/Shaders/Upscale.fs.glsl")
         .WithPrimitiveTopology(PrimitiveTopology::Triangles)
         .Build())
     {
-        _graphicsPipeline = std::move(graphicsPipelineResult.value());
+        _upscalePipeline = std::move(graphicsPipelineResult.value());
     }
     else
     {
-        spdlog::error("Building graphics pipeline \"{}\" failed. {}", "Simple", graphicsPipelineResult.error());
+        spdlog::error("Building graphics pipeline \"{}\" failed. {}", "Upscale", graphicsPipelineResult.error());
         return false;
     }
 
-    _vertices.push_back({.Position = {-0.5f, +0.5f, 0.0f}, .Uv = {0.0f, 1.0f}});
-    _vertices.push_back({.Position = {+0.0f, -0.5f, 0.0f}, .Uv = {0.5f, 0.0f}});
-    _vertices.push_back({.Position = {+0.5f, +0.5f, 0.0f}, .Uv = {1.0f, 1.0f}});
+    if (auto graphicsPipelineResult = _device->CreateGraphicsPipelineBuilder("Impostor")
+        .WithShaders("Data/Shaders/Impostor.vs.glsl", "Data/Shaders/Impostor.fs.glsl")
+        .WithPrimitiveTopology(PrimitiveTopology::Triangles)
+        .Build())
+    {
+        _impostorPipeline = std::move(graphicsPipelineResult.value());
+    }
+    else
+    {
+        spdlog::error("Building graphics pipeline \"{}\" failed. {}", "Impostor", graphicsPipelineResult.error());
+        return false;
+    }
 
-    _vertexBuffer = std::make_unique<Buffer>(Buffer::Create(
-        "Buffer_Vertices_Triangle",
-        SizeInBytes(_vertices),
-        GL_ARRAY_BUFFER,
+    _globalUniformBuffer = std::make_unique<Buffer>(Buffer::Create(
+        "Buffer_Uniforms_Global",
+        sizeof(GlobalUniforms),
+        GL_UNIFORM_BUFFER,
         GL_DYNAMIC_STORAGE_BIT));
-    _vertexBuffer->Write(_vertices.data(), SizeInBytes(_vertices), 0u);
 
-    _indices.push_back(0u);
-    _indices.push_back(1u);
-    _indices.push_back(2u);
+    _instanceBuffer = std::make_unique<Buffer>(Buffer::Create(
+        "Buffer_Instances_Asteroids",
+        sizeof(InstanceData) * MaxInstanceCount * InstanceBufferFrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true));
+    _instanceIndexBuffer = std::make_unique<Buffer>(Buffer::Create(
+        "Buffer_InstanceIndices_Asteroids",
+        sizeof(uint32_t) * MaxInstanceCount * InstanceBufferFrameCount,
+        GL_SHADER_STORAGE_BUFFER,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT,
+        true));
 
-    _indexBuffer = std::make_unique<Buffer>(Buffer::Create(
-        "Buffer_Indices_Triangle",
-        SizeInBytes(_indices),
-        GL_ELEMENT_ARRAY_BARRIER_BIT,
-        GL_DYNAMIC_STORAGE_BIT));
-    _indexBuffer->Write(_indices.data(), SizeInBytes(_indices), 0u);
+    if (auto hiZPyramidResult = HiZPyramid::Create(*_device, "Data/Shaders/HiZBuild.cs.glsl"))
+    {
+        _hiZPyramid.emplace(std::move(hiZPyramidResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating depth pyramid failed. {}", hiZPyramidResult.error());
+        return false;
+    }
+
+    if (auto occlusionCullerResult = OcclusionCuller::Create(*_device, "Data/Shaders/OcclusionCull.cs.glsl", OcclusionCullerSettings
+        {
+            .MaxDrawCount = MaxDrawCount,
+            .MaxSlotCount = MaxInstanceCount,
+            .FrameCount = InstanceBufferFrameCount
+        }))
+    {
+        _occlusionCuller.emplace(std::move(occlusionCullerResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating occlusion culler failed. {}", occlusionCullerResult.error());
+        return false;
+    }
+    _sceneGpuTimer = std::make_unique<GpuTimer>();
+    _unculledSceneGpuTimer = std::make_unique<GpuTimer>();
+
+    SectorStreamerSettings streamerSettings;
+    streamerSettings.SectorSize = SectorSize;
+    streamerSettings.MaxSectorCount = MaxSectorCount;
+    streamerSettings.UploadByteBudgetPerFrame = 256 * 1024;
+    streamerSettings.LoaderThreadCount = std::max(std::thread::hardware_concurrency() / 4, 1u);
+    _taskScheduler = std::make_unique<TaskScheduler>();
+
+    if (auto clusteredLightingResult = ClusteredLighting::Create(*_device, "Data/Shaders/LightBinning.cs.glsl", ClusteredLightingSettings
+        {
+            .MaxLightCount = DynamicLightCount,
+            .UseGpuBinning = GetSettings().UseGpuLightBinning
+        }, _taskScheduler.get()))
+    {
+        _clusteredLighting.emplace(std::move(clusteredLightingResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating clustered lighting failed. {}", clusteredLightingResult.error());
+        return false;
+    }
+    _dynamicLightField = std::make_unique<DynamicLightField>(DynamicLightCount, SectorSize);
+
+    auto glyphAtlasResult = GlyphAtlas::CreateFromFont(HudFontFilePath);
+    if (!glyphAtlasResult)
+    {
+        spdlog::info("Hud: Using the built in font. {}", glyphAtlasResult.error());
+    }
+    if (auto hudRendererResult = HudRenderer::Create(
+        *_device,
+        "Data/Shaders/Hud.vs.glsl",
+        "Data/Shaders/Hud.fs.glsl",
+        glyphAtlasResult ? std::move(glyphAtlasResult.value()) : GlyphAtlas::CreateBuiltIn(),
+        HudRendererSettings
+        {
+            .MaxQuadCount = std::max(HudMaxQuadCount, GetSettings().HudBenchmarkGlyphCount + HudReservedQuadCount),
+            .FrameCount = InstanceBufferFrameCount
+        }))
+    {
+        _hudRenderer.emplace(std::move(hudRendererResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating HUD renderer failed. {}", hudRendererResult.error());
+        return false;
+    }
+    _hudGpuTimer = std::make_unique<GpuTimer>();
 
-    //_graphicsPipeline->UseVertexBufferBinding(_vertexBuffer.get(), 0, 0, sizeof(VertexPositionUv));
-    //_graphicsPipeline->UseIndexBufferBinding(_indexBuffer.get());
+    if (!LoadStars())
+    {
+        return false;
+    }
 
+#ifndef ENGINE_SHIPPING
+    if (auto debugDrawRendererResult = DebugDrawRenderer::Create(
+        *_device,
+        "Data/Shaders/DebugDraw.vs.glsl",
+        "Data/Shaders/DebugDraw.fs.glsl",
+        DebugDrawSettings{ .FrameCount = InstanceBufferFrameCount }))
+    {
+        _debugDrawRenderer.emplace(std::move(debugDrawRendererResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating debug draw renderer failed. {}", debugDrawRendererResult.error());
+        return false;
+    }
+#endif
+
+    _asteroidSectorHandler = std::make_unique<AsteroidSectorHandler>(SectorSize, GetResourceLoader());
+    _sectorStreamer = std::make_unique<SectorStreamer>(*_asteroidSectorHandler, streamerSettings);
+
+    if (auto netClientResult = NetClient::Create())
+    {
+        _netClient.emplace(std::move(netClientResult.value()));
+        _netClient->Connect(NetAddress::Loopback(DefaultServerPort), 0.0);
+    }
+    else
+    {
+        spdlog::warn("Creating network client failed. {}", netClientResult.error());
+    }
+
+    glEnable(GL_DEPTH_TEST);
     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
 
+    BuildRenderGraph();
+    if (auto compileResult = GetRenderGraph().Compile(); !compileResult)
+    {
+        spdlog::error("Compiling render graph failed. {}", compileResult.error());
+        return false;
+    }
+
     return true;
 }
 
+bool GameApplication::LoadStars()
+{
+    auto catalogFilePath = std::string_view(GetSettings().StarCatalogFilePath);
+    if (auto starCount = GetSettings().StarBenchmarkCount; starCount > 0)
+    {
+        auto generateStartTime = std::chrono::steady_clock::now();
+        auto stars = GenerateStars(starCount, StarBenchmarkSeed, _taskScheduler.get());
+        auto writeStartTime = std::chrono::steady_clock::now();
+        if (auto writeResult = WriteStarCatalog(StarBenchmarkFilePath, stars, _taskScheduler.get()); !writeResult)
+        {
+            spdlog::error("Writing star benchmark catalog failed. {}", writeResult.error());
+            return false;
+        }
+        spdlog::info("Stars: Generated {} stars in {:.1f} ms, sorted and wrote them in {:.1f} ms",
+            starCount,
+            std::chrono::duration<double, std::milli>(writeStartTime - generateStartTime).count(),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - writeStartTime).count());
+        catalogFilePath = StarBenchmarkFilePath;
+    }
+
+    auto openStartTime = std::chrono::steady_clock::now();
+    auto catalogResult = StarCatalog::Open(catalogFilePath);
+    if (!catalogResult)
+    {
+        // The catalog is data, not code, the sky just stays empty without it
+        spdlog::info("Stars: No star catalog loaded. {}", catalogResult.error());
+        return true;
+    }
+    auto uploadStartTime = std::chrono::steady_clock::now();
+    if (auto starFieldResult = StarField::Create(
+        *_device,
+        catalogResult.value(),
+        "Data/Shaders/Stars.vs.glsl",
+        "Data/Shaders/Stars.fs.glsl",
+        StarFieldSettings{ .FrameCount = InstanceBufferFrameCount }))
+    {
+        _starField.emplace(std::move(starFieldResult.value()));
+    }
+    else
+    {
+        spdlog::error("Creating star field failed. {}", starFieldResult.error());
+        return false;
+    }
+    // Finishing makes the upload part of the time instead of the first frame's
+    glFinish();
+    auto endTime = std::chrono::steady_clock::now();
+    spdlog::info("Stars: Loaded {} stars from {}, opened in {:.1f} ms, uploaded in {:.1f} ms",
+        _starField->GetStarCount(),
+        catalogFilePath,
+        std::chrono::duration<double, std::milli>(uploadStartTime - openStartTime).count(),
+        std::chrono::duration<double, std::milli>(endTime - uploadStartTime).count());
+    _starGpuTimer = std::make_unique<GpuTimer>();
+    return true;
+}
+
+void GameApplication::BuildRenderGraph()
+{
+    auto& renderGraph = GetRenderGraph();
+    // The scene renders at the dynamic resolution and is upscaled into the backbuffer, the UI draws at full resolution after
+    auto sceneColor = renderGraph.CreateTexture("SceneColor", RenderGraphTextureDescription
+    {
+        .Format = GL_SRGB8_ALPHA8,
+        .FollowsRenderScale = true,
+        .ClearColor = glm::vec4(0.05f, 0.05f, 0.05f, 1.0f)
+    });
+    auto sceneDepth = renderGraph.CreateTexture("SceneDepth", RenderGraphTextureDescription
+    {
+        .Format = GL_DEPTH_COMPONENT32F,
+        .FollowsRenderScale = true
+    });
+    _sceneColor = sceneColor;
+    auto depthPyramid = renderGraph.ImportTexture("DepthPyramid", _hiZPyramid->GetTexture());
+    auto backbuffer = renderGraph.ImportBackbuffer();
+
+    // Early draws are what was visible last frame, their depth then finds what became visible since.
+    // The pyramid is built again at the end so the next frame tests against everything drawn
+    renderGraph.AddPass("Opaque Early", [this](const RenderGraphContext&)
+        {
+            _occlusionCuller->Cull(
+                OcclusionCullPass::Early,
+                OcclusionCullView{ .ViewProjection = _viewProjection, .PyramidViewProjection = _pyramidViewProjection },
+                *_instanceBuffer,
+                *_instanceIndexBuffer,
+                *_hiZPyramid);
+            _renderQueue.Submit(OpaquePass);
+        })
+        .WriteColor(sceneColor, RenderGraphLoad::Clear)
+        .WriteDepth(sceneDepth, RenderGraphLoad::Clear)
+        .Read(depthPyramid);
+    renderGraph.AddPass("Depth Pyramid Early", [this, sceneDepth](const RenderGraphContext& context)
+        {
+            _hiZPyramid->Build(context.GetTexture(sceneDepth));
+        })
+        .Read(sceneDepth)
+        .Write(depthPyramid);
+    renderGraph.AddPass("Opaque Late", [this](const RenderGraphContext&)
+        {
+            _occlusionCuller->Cull(
+                OcclusionCullPass::Late,
+                OcclusionCullView{ .ViewProjection = _viewProjection, .PyramidViewProjection = _viewProjection },
+                *_instanceBuffer,
+                *_instanceIndexBuffer,
+                *_hiZPyramid);
+            _renderQueue.Submit(DisoccludedPass);
+        })
+        .WriteColor(sceneColor)
+        .WriteDepth(sceneDepth)
+        .Read(depthPyramid);
+    renderGraph.AddPass("Depth Pyramid Late", [this, sceneDepth](const RenderGraphContext& context)
+        {
+            _hiZPyramid->Build(context.GetTexture(sceneDepth));
+        })
+        .Read(sceneDepth)
+        .Write(depthPyramid);
+    if (_starField)
+    {
+        // After the pyramid is built so the stars pinned to the far plane never occlude anything
+        renderGraph.AddPass("Stars", [this, sceneColor](const RenderGraphContext& context)
+            {
+                auto& sceneColorTexture = context.GetTexture(sceneColor);
+                _starGpuTimer->Begin();
+                _starField->Draw(
+                    static_cast<uint32_t>(_frameIndex % InstanceBufferFrameCount),
+                    _view,
+                    _projection,
+                    CameraFieldOfView,
+                    sceneColorTexture.GetWidth(),
+                    sceneColorTexture.GetHeight());
+                _starGpuTimer->End();
+            })
+            .WriteColor(sceneColor)
+            .WriteDepth(sceneDepth);
+    }
+#ifndef ENGINE_SHIPPING
+    renderGraph.AddPass("Debug Draw", [this](const RenderGraphContext&)
+        {
+            if (_isDebugDrawVisible)
+            {
+                _debugDrawRenderer->Draw(static_cast<uint32_t>(_frameIndex % InstanceBufferFrameCount), _viewProjection);
+            }
+            else
+            {
+                _debugDrawRenderer->Discard();
+            }
+        })
+        .WriteColor(sceneColor)
+        .WriteDepth(sceneDepth);
+#endif
+    renderGraph.AddPass("Upscale", [this, sceneColor](const RenderGraphContext& context)
+        {
+            _upscalePipeline->Use();
+            _upscalePipeline->BindTexture(context.GetTexture(sceneColor), 0);
+            _upscalePipeline->SetFragmentUniform(UpscaleSharpnessLocation, UpscaleSharpness);
+            _upscalePipeline->DrawArrays(3);
+        })
+        .Read(sceneColor)
+        .WriteColor(backbuffer);
+    renderGraph.AddPass("Hud", [this](const RenderGraphContext&)
+        {
+            _hudGpuTimer->Begin();
+            _hudRenderer->Draw();
+            _hudGpuTimer->End();
+        })
+        .WriteColor(backbuffer);
+}
+
+void GameApplication::BuildHud(uint32_t frame)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    auto viewportWidth = static_cast<uint32_t>(std::max(framebufferWidth, 1));
+    auto viewportHeight = static_cast<uint32_t>(std::max(framebufferHeight, 1));
+    _hudRenderer->Begin(frame, viewportWidth, viewportHeight);
+
+    // Formatted into the stack, the HUD must not allocate every frame
+    std::array<char, 256> text;
+    auto formatResult = std::format_to_n(text.data(), text.size(),
+        "Speed {:.1f} m/s\nSector {} {} {}\nLights {}\nScale {:.2f}",
+        glm::length(_cameraVelocity),
+        _cameraPosition.Sector.X,
+        _cameraPosition.Sector.Y,
+        _cameraPosition.Sector.Z,
+        _clusteredLighting->GetStatistics().LightCount,
+        GetRenderGraph().GetRenderScale());
+    auto textView = std::string_view(text.data(), std::min<size_t>(formatResult.size, text.size()));
+
+    auto margin = glm::vec2(16.0f);
+    auto padding = glm::vec2(8.0f);
+    auto textSize = glm::vec2(_hudRenderer->MeasureText(textView, HudTextSize), 4.0f * HudTextSize);
+    _hudRenderer->AddRectangle(margin, textSize + 2.0f * padding, glm::vec4(0.0f, 0.0f, 0.0f, 0.5f));
+    _hudRenderer->AddText(textView, margin + padding, HudTextSize, glm::vec4(0.6f, 0.9f, 1.0f, 1.0f));
+
+    auto center = glm::vec2(static_cast<float>(viewportWidth), static_cast<float>(viewportHeight)) * 0.5f;
+    _hudRenderer->AddRing(center, 18.0f, 2.0f, glm::vec4(0.6f, 0.9f, 1.0f, 0.8f));
+    _hudRenderer->AddRing(center, 2.0f, 2.0f, glm::vec4(0.6f, 0.9f, 1.0f, 0.8f));
+
+    // Rows of text down the screen until the benchmark's glyph count is reached
+    if (auto benchmarkGlyphCount = GetSettings().HudBenchmarkGlyphCount; benchmarkGlyphCount > 0)
+    {
+        constexpr std::string_view BenchmarkLine = "The quick brown fox jumps over the lazy dog 0123456789 ";
+        auto rowCount = std::max(static_cast<uint32_t>(static_cast<float>(viewportHeight) / HudBenchmarkTextSize), 1u);
+        auto targetGlyphCount = _hudRenderer->GetStatistics().GlyphCount + benchmarkGlyphCount;
+        auto& hudStatistics = _hudRenderer->GetStatistics();
+        for (auto row = 0u; hudStatistics.GlyphCount < targetGlyphCount && hudStatistics.DroppedQuadCount == 0; row++)
+        {
+            auto position = glm::vec2(
+                static_cast<float>((row / rowCount) % 8) * 4.0f,
+                static_cast<float>(row % rowCount) * HudBenchmarkTextSize);
+            auto remainingGlyphCount = targetGlyphCount - hudStatistics.GlyphCount;
+            auto line = BenchmarkLine.substr(0, std::min<size_t>(remainingGlyphCount, BenchmarkLine.size()));
+            _hudRenderer->AddText(line, position, HudBenchmarkTextSize, glm::vec4(1.0f, 1.0f, 1.0f, 0.25f));
+        }
+    }
+
+    auto& hudStatistics = _hudRenderer->GetStatistics();
+    _hudGlyphCount += hudStatistics.GlyphCount;
+    _hudQuadCount += hudStatistics.QuadCount;
+    _hudDroppedQuadCount += hudStatistics.DroppedQuadCount;
+    _hudCpuMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
 void GameApplication::Unload()
 {
-    _graphicsPipeline.reset();
-    _vertexBuffer.reset();
-    _indexBuffer.reset();
+    for (auto& instanceBufferFence : _instanceBufferFences)
+    {
+        if (instanceBufferFence != nullptr)
+        {
+            glDeleteSync(instanceBufferFence);
+            instanceBufferFence = nullptr;
+        }
+    }
+
+    // Sectors own GL resources, so the streamer goes before the context does
+    _sectorStreamer.reset();
+
+    if (_netClient)
+    {
+        _netClient->Disconnect();
+        _netClient.reset();
+    }
+    _asteroidSectorHandler.reset();
+    _renderQueue.Clear();
+    _taskScheduler.reset();
+
+    _instanceIndexBuffer.reset();
+    _instanceBuffer.reset();
+    _unculledSceneGpuTimer.reset();
+    _sceneGpuTimer.reset();
+    _occlusionCuller.reset();
+    _clusteredLighting.reset();
+    _dynamicLightField.reset();
+    _hudGpuTimer.reset();
+    _hudRenderer.reset();
+    _starGpuTimer.reset();
+    _starField.reset();
+#ifndef ENGINE_SHIPPING
+    _debugDrawRenderer.reset();
+#endif
+    GetRenderGraph().Reset();
+    _hiZPyramid.reset();
+    _globalUniformBuffer.reset();
+    _impostorPipeline.reset();
+    _upscalePipeline.reset();
+    _asteroidPipeline.reset();
     Application::Unload();
 }
 
+void GameApplication::Update()
+{
+    Application::Update();
+
+    // Cruise through the belt, speeding up and slowing down so prefetching sees different velocities
+    auto time = static_cast<float>(_frameIndex) / 60.0f;
+    auto speed = 30.0f + 25.0f * std::sin(time * 0.15f);
+    _cameraVelocity = glm::vec3(3.0f * std::sin(time * 0.05f), 2.0f * std::cos(time * 0.07f), -speed);
+    _cameraPosition = OffsetWorldPosition(_cameraPosition, _cameraVelocity / 60.0f, SectorSize);
+
+    _isUnculledFrame = GetSettings().UseOcclusionReferenceFrames && _frameIndex % StatisticsFrameCount == 0;
+    if (_isUnculledFrame)
+    {
+        SkipFrameGpuTiming();
+    }
+
+    _streamerStatistics = _sectorStreamer->Update(_cameraPosition, _cameraVelocity, &GetFrameArena());
+    _uploadedByteCount += _streamerStatistics.UploadedByteCount;
+
+    if (_netClient)
+    {
+        _netClient->Update(time);
+    }
+}
+
 void GameApplication::Render()
 {
     Application::Render();
 
-    _graphicsPipeline->Use();
-    _graphicsPipeline->BindAsShaderStorageBuffer(_vertexBuffer, 0, 0, SizeInBytes(_vertices));
-    _graphicsPipeline->BindAsShaderStorageBuffer(_indexBuffer, 1, 0, SizeInBytes(_indices));
-    _graphicsPipeline->DrawArrays(_vertices.size(), 0u);
+    auto frame = static_cast<uint32_t>(_frameIndex % InstanceBufferFrameCount);
+    if (auto& instanceBufferFence = _instanceBufferFences[frame]; instanceBufferFence != nullptr)
+    {
+        glClientWaitSync(instanceBufferFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(instanceBufferFence);
+        instanceBufferFence = nullptr;
+    }
+    _occlusionCuller->BeginFrame(frame);
+
+    // The camera sits at the origin, sectors are placed relative to it so floats stay precise however far we fly
+    auto viewportWidth = std::max(framebufferWidth, 1);
+    auto viewportHeight = std::max(framebufferHeight, 1);
+    auto aspectRatio = static_cast<float>(viewportWidth) / static_cast<float>(viewportHeight);
+    auto projection = glm::perspective(CameraFieldOfView, aspectRatio, 0.1f, CameraFarPlane);
+    auto view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    auto viewProjection = projection * view;
+    // The previous frame's depth was rendered from elsewhere, positions relative to this frame's camera are moved back there
+    auto cameraOffset = GetRelativePosition(_cameraPosition, _previousCameraPosition, SectorSize);
+    auto pyramidViewProjection = _previousViewProjection * glm::translate(glm::mat4(1.0f), cameraOffset);
+
+    _meshLodSelector.SetProjection(CameraFieldOfView, static_cast<uint32_t>(viewportHeight));
+
+    // Each frame owns MaxInstanceCount instances of the ring, the shaders find them through gl_BaseInstance
+    auto baseInstance = frame * MaxInstanceCount;
+    auto instances = static_cast<InstanceData*>(_instanceBuffer->GetMappedMemory()) + baseInstance;
+    auto instanceIndices = static_cast<uint32_t*>(_instanceIndexBuffer->GetMappedMemory()) + baseInstance;
+    auto time = static_cast<float>(_frameIndex) / 60.0f;
+    auto instanceCount = 0u;
+    MeshLodStatistics frameLodStatistics;
+
+    _sectorDraws.clear();
+    _sectorStreamer->ForEachResidentSector([&](const SectorCoordinate& sector, SectorContent& content)
+    {
+        auto& asteroidSector = static_cast<AsteroidSectorContent&>(content);
+        auto& transforms = asteroidSector.Transforms;
+        auto sectorOrigin = GetRelativeSectorOrigin(sector, _cameraPosition, SectorSize);
+        for (auto i = 0u; i < transforms.GetCount(); i++)
+        {
+            transforms.SetPosition(i, sectorOrigin + asteroidSector.LocalPositions[i]);
+            transforms.SetRotation(i, glm::angleAxis(time * asteroidSector.SpinSpeeds[i], asteroidSector.SpinAxes[i]));
+        }
+
+        auto lodStatistics = _meshLodSelector.Select(asteroidSector.Mesh, transforms, glm::vec3(0.0f), asteroidSector.Lods);
+        transforms.ComputeMatrices(
+            viewProjection,
+            &instances[instanceCount].Model,
+            sizeof(InstanceData),
+            &instances[instanceCount].ModelViewProjection,
+            sizeof(InstanceData));
+
+        // Bucket the sector's instances by level, impostors last, so each level is one instanced draw
+        std::array<uint32_t, MaxMeshLodLevelCount + 1> levelCursors = {};
+        for (auto level = 1u; level <= MaxMeshLodLevelCount; level++)
+        {
+            levelCursors[level] = levelCursors[level - 1] + lodStatistics.LevelInstanceCounts[level - 1];
+        }
+        for (auto i = 0u; i < transforms.GetCount(); i++)
+        {
+            auto bucket = asteroidSector.Lods[i] == MeshLodImpostor ? MaxMeshLodLevelCount : asteroidSector.Lods[i];
+            instanceIndices[instanceCount + levelCursors[bucket]++] = baseInstance + instanceCount + i;
+        }
+
+        auto& sectorDraw = _sectorDraws.emplace_back(SectorDraw
+        {
+            .Sector = &asteroidSector,
+            .FirstInstance = instanceCount,
+            .LodStatistics = lodStatistics,
+            .Distance = glm::length(sectorOrigin + glm::vec3(SectorSize * 0.5f))
+        });
+        sectorDraw.Geometry.Add({ .Type = RenderBindingType::ShaderStorageBuffer, .Index = VertexPullingVertexBufferBinding, .BoundBuffer = asteroidSector.VertexBuffer.get() });
+        sectorDraw.Geometry.Add({ .Type = RenderBindingType::ShaderStorageBuffer, .Index = VertexPullingIndexBufferBinding, .BoundBuffer = asteroidSector.IndexBuffer.get() });
+        sectorDraw.ImpostorMaterial.Add({ .Type = RenderBindingType::Texture, .Index = 0, .BoundTexture = asteroidSector.ImpostorTexture.get() });
+        sectorDraw.ImpostorMaterial.Add({ .Type = RenderBindingType::UniformBuffer, .Index = 1, .BoundBuffer = asteroidSector.ImpostorUniformBuffer.get() });
+        instanceCount += transforms.GetCount();
+
+        for (auto level = 0u; level < MaxMeshLodLevelCount; level++)
+        {
+            frameLodStatistics.LevelInstanceCounts[level] += lodStatistics.LevelInstanceCounts[level];
+        }
+        frameLodStatistics.ImpostorCount += lodStatistics.ImpostorCount;
+        frameLodStatistics.FullDetailTriangleCount += lodStatistics.FullDetailTriangleCount;
+        frameLodStatistics.RenderedTriangleCount += lodStatistics.RenderedTriangleCount;
+    });
+    ReportStatistics(frameLodStatistics);
+
+    GlobalUniforms globalUniforms =
+    {
+        .ViewProjection = viewProjection,
+        .CameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+        .SunDirection = glm::vec4(glm::normalize(glm::vec3(0.4f, 0.6f, 0.7f)), 0.0f)
+    };
+    _globalUniformBuffer->Write(&globalUniforms, sizeof(GlobalUniforms), 0u);
+
+    // Clusters are found from fragment positions, which are in the scene's scaled resolution
+    auto& renderGraph = GetRenderGraph();
+    _clusteredLighting->SetView(view, projection, 0.1f, CameraFarPlane, renderGraph.GetWidth(_sceneColor), renderGraph.GetHeight(_sceneColor));
+    // Clamped so a hitch or a breakpoint does not fling the lights out of range
+    auto lights = _dynamicLightField->Update(_cameraPosition, time, std::min(GetFrameDeltaSeconds(), MaxLightDeltaSeconds));
+    _clusteredLighting->Update(lights);
+    AddDebugLines(lights);
+
+    auto& sceneGpuTimer = _isUnculledFrame ? *_unculledSceneGpuTimer : *_sceneGpuTimer;
+    _occlusionCuller->SetEnabled(!_isUnculledFrame);
+
+    // Frame wide bindings, everything per sector goes through the render queue. Draws find their
+    // instances through the indices culling left behind
+    _asteroidPipeline->BindAsUniformBuffer(*_globalUniformBuffer, 0, 0, sizeof(GlobalUniforms));
+    _asteroidPipeline->BindAsShaderStorageBuffer(*_instanceBuffer, VertexPullingInstanceBufferBinding, 0, _instanceBuffer->GetSize());
+    auto& culledIndexBuffer = _occlusionCuller->GetCulledIndexBuffer();
+    _asteroidPipeline->BindAsShaderStorageBuffer(culledIndexBuffer, VertexPullingInstanceIndexBufferBinding, 0, culledIndexBuffer.GetSize());
+    _clusteredLighting->Bind(*_asteroidPipeline);
+
+    _renderQueue.Clear();
+    for (auto sectorIndex = 0u; sectorIndex < _sectorDraws.size(); sectorIndex++)
+    {
+        auto& sectorDraw = _sectorDraws[sectorIndex];
+        auto& asteroidSector = *sectorDraw.Sector;
+        auto depth = QuantizeRenderDepth(sectorDraw.Distance, CameraFarPlane);
+
+        auto levelStart = 0u;
+        for (auto level = 0u; level < asteroidSector.Mesh.LodLevels.size(); level++)
+        {
+            auto levelInstanceCount = sectorDraw.LodStatistics.LevelInstanceCounts[level];
+            if (levelInstanceCount > 0)
+            {
+                auto& lodLevel = asteroidSector.Mesh.LodLevels[level];
+                AddCulledDraw(
+                    RenderKeyFields{ .Pipeline = AsteroidPipeline, .Geometry = sectorIndex, .Material = 0, .Depth = depth },
+                    RenderItem
+                    {
+                        .Pipeline = _asteroidPipeline.get(),
+                        .Geometry = &sectorDraw.Geometry,
+                        .ElementCount = lodLevel.IndexCount,
+                        .InstanceCount = levelInstanceCount,
+                        .ElementOffset = lodLevel.IndexOffset
+                    },
+                    sectorDraw.FirstInstance + levelStart,
+                    glm::vec4(asteroidSector.Mesh.BoundingSphereCenter, asteroidSector.Mesh.BoundingSphereRadius));
+            }
+            levelStart += levelInstanceCount;
+        }
+
+        auto impostorCount = sectorDraw.LodStatistics.ImpostorCount;
+        if (impostorCount > 0)
+        {
+            auto impostorStart = asteroidSector.Transforms.GetCount() - impostorCount;
+            AddCulledDraw(
+                RenderKeyFields{ .Pipeline = ImpostorPipeline, .Geometry = 0, .Material = sectorIndex, .Depth = depth },
+                RenderItem
+                {
+                    .Pipeline = _impostorPipeline.get(),
+                    .Material = &sectorDraw.ImpostorMaterial,
+                    .ElementCount = 6,
+                    .InstanceCount = impostorCount
+                },
+                sectorDraw.FirstInstance + impostorStart,
+                glm::vec4(asteroidSector.Mesh.Impostor.Center, asteroidSector.Mesh.Impostor.Radius));
+        }
+    }
+    _renderQueue.Sort(_taskScheduler.get());
+
+    BuildHud(frame);
+
+    _viewProjection = viewProjection;
+    _view = view;
+    _projection = projection;
+    _pyramidViewProjection = pyramidViewProjection;
+    sceneGpuTimer.Begin();
+    renderGraph.Execute();
+    sceneGpuTimer.End();
+
+    _previousViewProjection = viewProjection;
+    _previousCameraPosition = _cameraPosition;
+
+    _instanceBufferFences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _frameIndex++;
+}
+
+void GameApplication::AddDebugLines(std::span<const PointLight> lights)
+{
+#ifndef ENGINE_SHIPPING
+    if (!_isDebugDrawVisible)
+    {
+        return;
+    }
+
+    _sectorStreamer->ForEachResidentSector([&](const SectorCoordinate& sector, SectorContent&)
+    {
+        auto sectorOrigin = GetRelativeSectorOrigin(sector, _cameraPosition, SectorSize);
+        auto isCameraSector = sector == _cameraPosition.Sector;
+        DebugDraw::Box(
+            sectorOrigin,
+            sectorOrigin + glm::vec3(SectorSize),
+            isCameraSector ? glm::vec4(1.0f, 0.8f, 0.2f, 1.0f) : glm::vec4(0.3f, 0.6f, 1.0f, 0.5f),
+            isCameraSector ? DebugDrawMode::Overlay : DebugDrawMode::DepthTested);
+    });
+
+    // From the workers, each appends to its own buffer
+    _taskScheduler->ParallelFor(static_cast<uint32_t>(lights.size()), 256, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            auto& light = lights[i];
+            if (glm::length(light.Position) < DebugDrawLightDistance)
+            {
+                DebugDraw::Sphere(light.Position, light.Radius, glm::vec4(1.0f, 0.9f, 0.5f, 0.6f));
+            }
+        }
+    });
+#else
+    static_cast<void>(lights);
+#endif
+}
+
+void GameApplication::OnKeyDown(
+    int32_t key,
+    int32_t modifiers,
+    int32_t scancode)
+{
+    Application::OnKeyDown(key, modifiers, scancode);
+
+#ifndef ENGINE_SHIPPING
+    if (key == GLFW_KEY_F4)
+    {
+        _isDebugDrawVisible = !_isDebugDrawVisible;
+    }
+#endif
+}
+
+void GameApplication::OnFramebufferResized()
+{
+    Application::OnFramebufferResized();
+
+    // The scene depth is reallocated by the next frame, the pyramid of the old one does not match it
+    if (_hiZPyramid)
+    {
+        _hiZPyramid->Invalidate();
+    }
+}
+
+void GameApplication::AddCulledDraw(RenderKeyFields keyFields, const RenderItem& item, uint32_t firstSlot, const glm::vec4& boundingSphere)
+{
+    // The item's counts only describe all of its instances, what survives culling comes from the indirect commands
+    auto draw = _occlusionCuller->AddDraw(firstSlot, item.InstanceCount, item.ElementCount, item.ElementOffset, boundingSphere);
+
+    auto culledItem = item;
+    culledItem.IndirectBuffer = &_occlusionCuller->GetCommandBuffer();
+    culledItem.IndirectOffset = _occlusionCuller->GetCommandOffset(OcclusionCullPass::Early, draw);
+    keyFields.Pass = OpaquePass;
+    _renderQueue.Add(MakeRenderKey(keyFields), culledItem);
+
+    culledItem.IndirectOffset = _occlusionCuller->GetCommandOffset(OcclusionCullPass::Late, draw);
+    keyFields.Pass = DisoccludedPass;
+    _renderQueue.Add(MakeRenderKey(keyFields), culledItem);
+}
+
+void GameApplication::ReportStatistics(const MeshLodStatistics& lodStatistics)
+{
+    _lodRenderedTriangleCount += lodStatistics.RenderedTriangleCount;
+    _lodSavedTriangleCount += lodStatistics.GetSavedTriangleCount();
+    _lodImpostorCount += lodStatistics.ImpostorCount;
+
+    auto frameHeapAllocationCount = GetFrameHeapAllocationCount();
+    _heapAllocationCount += frameHeapAllocationCount;
+    _maxFrameHeapAllocationCount = std::max(_maxFrameHeapAllocationCount, frameHeapAllocationCount);
+    _allocationFreeFrameCount += frameHeapAllocationCount == 0 ? 1 : 0;
+    _maxFrameArenaByteCount = std::max<uint64_t>(_maxFrameArenaByteCount, GetFrameArena().GetPeakByteCount());
+
+    if ((_frameIndex + 1) % StatisticsFrameCount != 0)
+    {
+        return;
+    }
+
+    spdlog::info("Lod: {} triangles drawn and {} saved per frame, {} impostors",
+        _lodRenderedTriangleCount / StatisticsFrameCount,
+        _lodSavedTriangleCount / StatisticsFrameCount,
+        _lodImpostorCount / StatisticsFrameCount);
+    spdlog::info("Streaming: Camera in sector {}_{}_{}, {} sectors resident, {} loading, {} uploading, {} KiB uploaded per frame",
+        _cameraPosition.Sector.X,
+        _cameraPosition.Sector.Y,
+        _cameraPosition.Sector.Z,
+        _streamerStatistics.ResidentSectorCount,
+        _streamerStatistics.PendingLoadCount,
+        _streamerStatistics.PendingUploadCount,
+        _uploadedByteCount / StatisticsFrameCount / 1024);
+    spdlog::info("Memory: {:.1f} heap allocations per frame, at most {}, {} of {} frames without any, frame arena peak {} KiB",
+        static_cast<double>(_heapAllocationCount) / StatisticsFrameCount,
+        _maxFrameHeapAllocationCount,
+        _allocationFreeFrameCount,
+        StatisticsFrameCount,
+        _maxFrameArenaByteCount / 1024);
+
+    auto& cullStatistics = _occlusionCuller->GetStatistics();
+    auto sceneMilliseconds = _sceneGpuTimer->GetMilliseconds().value_or(0.0);
+    if (GetSettings().UseOcclusionReferenceFrames)
+    {
+        auto unculledSceneMilliseconds = _unculledSceneGpuTimer->GetMilliseconds().value_or(sceneMilliseconds);
+        spdlog::info("Occlusion: {} of {} instances culled, {} drawn early and {} late, scene {:.2f} ms GPU, {:.2f} ms saved",
+            cullStatistics.GetCulledInstanceCount(),
+            cullStatistics.TestedInstanceCount,
+            cullStatistics.EarlyInstanceCount,
+            cullStatistics.LateInstanceCount,
+            sceneMilliseconds,
+            unculledSceneMilliseconds - sceneMilliseconds);
+    }
+    else
+    {
+        spdlog::info("Occlusion: {} of {} instances culled, {} drawn early and {} late, scene {:.2f} ms GPU",
+            cullStatistics.GetCulledInstanceCount(),
+            cullStatistics.TestedInstanceCount,
+            cullStatistics.EarlyInstanceCount,
+            cullStatistics.LateInstanceCount,
+            sceneMilliseconds);
+    }
+
+    auto& lightingStatistics = _clusteredLighting->GetStatistics();
+    if (GetSettings().UseGpuLightBinning)
+    {
+        spdlog::info("Lighting: {} lights binned on the GPU into {} clusters",
+            lightingStatistics.LightCount,
+            ClusteredLighting::ClusterCount);
+    }
+    else
+    {
+        spdlog::info("Lighting: {} lights binned on the CPU into {} clusters, {} light indices, at most {} lights per cluster",
+            lightingStatistics.LightCount,
+            ClusteredLighting::ClusterCount,
+            lightingStatistics.LightIndexCount,
+            lightingStatistics.MaxClusterLightCount);
+    }
+
+    spdlog::info("Hud: {} glyphs in {} quads per frame in one draw, {} dropped, {:.3f} ms CPU, {:.3f} ms GPU",
+        _hudGlyphCount / StatisticsFrameCount,
+        _hudQuadCount / StatisticsFrameCount,
+        _hudDroppedQuadCount / StatisticsFrameCount,
+        _hudCpuMilliseconds / StatisticsFrameCount,
+        _hudGpuTimer->GetMilliseconds().value_or(0.0));
+
+    if (_starField)
+    {
+        auto& starStatistics = _starField->GetStatistics();
+        spdlog::info("Stars: {} of {} stars drawn from {} cells, {} skipped as too faint or too dense, {:.3f} ms GPU",
+            starStatistics.DrawnStarCount,
+            _starField->GetStarCount(),
+            starStatistics.VisibleCellCount,
+            starStatistics.SkippedStarCount,
+            _starGpuTimer->GetMilliseconds().value_or(0.0));
+    }
+
+#ifndef ENGINE_SHIPPING
+    if (_isDebugDrawVisible)
+    {
+        auto& debugDrawStatistics = _debugDrawRenderer->GetStatistics();
+        spdlog::info("DebugDraw: {} lines in one draw, {} of them overlaid, {} dropped, from {} threads",
+            debugDrawStatistics.LineCount,
+            debugDrawStatistics.OverlayLineCount,
+            debugDrawStatistics.DroppedLineCount,
+            debugDrawStatistics.ThreadCount);
+    }
+#endif
+
+    if (_netClient && _netClient->GetState() == NetClientState::Connected)
+    {
+        spdlog::info("Network: Client {} has {} entities, {} snapshots received, {:.1f} ms round trip",
+            _netClient->GetServerInfo().ClientId,
+            _netClient->GetSnapshot().size(),
+            _netClient->GetStatistics().ReceivedSnapshotCount,
+            _netClient->GetConnection().GetStatistics().RoundTripTime * 1000.0);
+    }
+
+    _uploadedByteCount = 0;
+    _lodRenderedTriangleCount = 0;
+    _lodSavedTriangleCount = 0;
+    _lodImpostorCount = 0;
+    _heapAllocationCount = 0;
+    _maxFrameHeapAllocationCount = 0;
+    _allocationFreeFrameCount = 0;
+    _maxFrameArenaByteCount = 0;
+    _hudGlyphCount = 0;
+    _hudQuadCount = 0;
+    _hudDroppedQuadCount = 0;
+    _hudCpuMilliseconds = 0.0;
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Engine/Buffer.hpp>
+#include <Engine/ResourceLoader.hpp>
+#include <EngineCore/Memory.hpp>
+#include <EngineCore/MeshCooker.hpp>
+#include <EngineCore/SectorStreamer.hpp>
+#include <Engine/Texture.hpp>
+#include <EngineCore/TransformStore.hpp>
+#include <Engine/VertexPositionUvVP.hpp>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Matches the ImpostorUniforms block in the impostor shaders (std140)
+struct ImpostorUniforms
+{
+    glm::vec4 CenterAndRadius;
+    glm::vec4 Parameters;
+};
+
+// GPU resources of a sector as the resource loader builds them, taken over by the sector once published
+struct AsteroidSectorUpload
+{
+    Buffer VertexBuffer;
+    Buffer IndexBuffer;
+    Buffer ImpostorUniformBuffer;
+    Texture ImpostorTexture;
+    bool IsPublished = false;
+};
+
+// One sector's asteroid belt, every sector gets its own procedural asteroid shape
+struct AsteroidSectorContent final : SectorContent
+{
+    CookedMesh Mesh;
+    std::vector<VertexPositionUvVp> Vertices;
+
+    std::vector<glm::vec3> LocalPositions;
+    std::vector<glm::vec3> SpinAxes;
+    std::vector<float> SpinSpeeds;
+    // Positions are rewritten camera relative every frame from LocalPositions
+    TransformStore Transforms;
+    std::vector<uint8_t> Lods;
+
+    // From the handler's pools, sectors stream in and out all the time
+    PoolPtr<Buffer> VertexBuffer;
+    PoolPtr<Buffer> IndexBuffer;
+    PoolPtr<Buffer> ImpostorUniformBuffer;
+    PoolPtr<Texture> ImpostorTexture;
+    // Shared with the loader's job, which outlives the sector when it unloads mid upload
+    std::shared_ptr<AsteroidSectorUpload> Upload;
+};
+
+class AsteroidSectorHandler final : public SectorStreamingHandler
+{
+public:
+    static constexpr uint32_t MaxAsteroidsPerSector = 128;
+
+    AsteroidSectorHandler(float sectorSize, ResourceLoader& resourceLoader)
+        : _sectorSize(sectorSize),
+          _resourceLoader(resourceLoader)
+    {
+    }
+
+    std::expected<std::unique_ptr<SectorContent>, std::string> LoadSector(const SectorCoordinate& sector) override;
+    SectorUploadResult UploadSector(
+        const SectorCoordinate& sector,
+        SectorContent& content,
+        uint64_t byteBudget) override;
+    void UnloadSector(const SectorCoordinate& sector, SectorContent& content) override;
+
+private:
+    float _sectorSize;
+    ResourceLoader& _resourceLoader;
+    ObjectPool<Buffer> _bufferPool;
+    ObjectPool<Texture> _texturePool;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Engine/ClusteredLighting.hpp>
+#include <EngineCore/WorldPosition.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Drifting, flickering flares standing in for weapons fire, thrusters and explosions until those exist.
+// Lights keep world positions around the camera and respawn ahead of it once it left them behind.
+class DynamicLightField
+{
+public:
+    DynamicLightField(uint32_t lightCount, float sectorSize);
+
+    // Moves and flickers the lights, returned relative to the camera and valid until the next update
+    std::span<const PointLight> Update(const WorldPosition& cameraPosition, float time, float deltaTime);
+
+private:
+    struct Light
+    {
+        WorldPosition Position;
+        glm::vec3 Velocity;
+        glm::vec3 Color;
+        float Radius;
+        float FlickerRate;
+        float Phase;
+        uint32_t SpawnCount;
+    };
+
+    void Spawn(Light& light, uint32_t lightIndex, const WorldPosition& cameraPosition);
+
+    float _sectorSize;
+    std::vector<Light> _lights;
+    std::vector<PointLight> _pointLights;
+};
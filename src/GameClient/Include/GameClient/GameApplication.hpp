@@ -1,30 +1,162 @@
 #pragma once
 
+#include <GameClient/AsteroidSector.hpp>
+#include <GameClient/DynamicLights.hpp>
 #include <Engine/Application.hpp>
 #include <Engine/Buffer.hpp>
+#include <Engine/ClusteredLighting.hpp>
+#include <Engine/DebugDraw.hpp>
 #include <Engine/Device.hpp>
+#include <Engine/GpuTimer.hpp>
 #include <Engine/GraphicsPipeline.hpp>
-#include <Engine/VertexPositionUvVP.hpp>
+#include <Engine/HiZPyramid.hpp>
+#include <Engine/HudRenderer.hpp>
+#include <Engine/OcclusionCuller.hpp>
+#include <Engine/RenderGraph.hpp>
+#include <Engine/RenderQueue.hpp>
+#include <Engine/StarField.hpp>
+#include <EngineCore/MeshLodSelector.hpp>
+#include <EngineCore/SectorStreamer.hpp>
+#include <EngineCore/StarCatalog.hpp>
+#include <EngineCore/NetClient.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/WorldPosition.hpp>
 
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
 #include <vector>
 #include <string>
 #include <string_view>
 #include <expected>
 #include <span>
 #include <memory>
+#include <optional>
+
+struct __GLsync;
 
 class GameApplication final : public Application
 {
+public:
+    using Application::Application;
+
 protected:
     bool Load() override;
     void Unload() override;
+    void Update() override;
     void Render() override;
+    void OnFramebufferResized() override;
+    void OnKeyDown(
+        int32_t key,
+        int32_t modifiers,
+        int32_t scancode) override;
 
 private:
-    std::vector<VertexPositionUvVp> _vertices;
-    std::vector<uint32_t> _indices;
+    static constexpr float SectorSize = 64.0f;
+    static constexpr uint32_t MaxSectorCount = 96;
+    static constexpr uint32_t MaxInstanceCount = MaxSectorCount * AsteroidSectorHandler::MaxAsteroidsPerSector;
+    // One per level and one for the impostors of every sector
+    static constexpr uint32_t MaxDrawCount = MaxSectorCount * (MaxMeshLodLevelCount + 1);
+    // Instance data is written by the CPU while the GPU may still read older frames, so it is ring buffered
+    static constexpr uint32_t InstanceBufferFrameCount = 3;
+    static constexpr uint32_t StatisticsFrameCount = 300;
+    static constexpr uint32_t DynamicLightCount = 2048;
+
+    // Matches the GlobalUniforms block in the asteroid and impostor shaders (std140)
+    struct GlobalUniforms
+    {
+        glm::mat4 ViewProjection;
+        glm::vec4 CameraPosition;
+        glm::vec4 SunDirection;
+    };
+
+    struct SectorDraw
+    {
+        const AsteroidSectorContent* Sector;
+        uint32_t FirstInstance;
+        MeshLodStatistics LodStatistics;
+        float Distance;
+        RenderBindingSet Geometry = {};
+        RenderBindingSet ImpostorMaterial = {};
+    };
+
+    bool LoadStars();
+    void BuildRenderGraph();
+    void BuildHud(uint32_t frame);
+    void AddDebugLines(std::span<const PointLight> lights);
+    void ReportStatistics(const MeshLodStatistics& lodStatistics);
+    void AddCulledDraw(RenderKeyFields keyFields, const RenderItem& item, uint32_t firstSlot, const glm::vec4& boundingSphere);
+
+    std::unique_ptr<Buffer> _globalUniformBuffer;
+    std::unique_ptr<GraphicsPipeline> _asteroidPipeline = {};
+    std::unique_ptr<GraphicsPipeline> _impostorPipeline = {};
+    std::unique_ptr<GraphicsPipeline> _upscalePipeline = {};
+
+    std::unique_ptr<AsteroidSectorHandler> _asteroidSectorHandler;
+    std::unique_ptr<SectorStreamer> _sectorStreamer;
+    SectorStreamerStatistics _streamerStatistics;
+
+    // Optional, the client runs standalone when no server answers
+    std::optional<NetClient> _netClient;
+    MeshLodSelector _meshLodSelector;
+    std::vector<SectorDraw> _sectorDraws;
+    RenderQueue _renderQueue;
+    std::unique_ptr<TaskScheduler> _taskScheduler;
+
+    // The scene renders into render graph textures so its depth can be reduced into the pyramid occlusion culling tests against
+    std::optional<HiZPyramid> _hiZPyramid;
+    std::optional<OcclusionCuller> _occlusionCuller;
+    RenderGraphTexture _sceneColor;
+    // Of the frame the render graph executes
+    glm::mat4 _viewProjection = {};
+    glm::mat4 _view = {};
+    glm::mat4 _projection = {};
+    glm::mat4 _pyramidViewProjection = {};
+    glm::mat4 _previousViewProjection = {};
+    WorldPosition _previousCameraPosition = {};
+    // With UseOcclusionReferenceFrames every StatisticsFrameCount frames one frame renders unculled, timed
+    // separately and not by dynamic resolution, to tell what culling saves
+    std::unique_ptr<GpuTimer> _sceneGpuTimer;
+    std::unique_ptr<GpuTimer> _unculledSceneGpuTimer;
+    bool _isUnculledFrame = false;
+
+    std::optional<ClusteredLighting> _clusteredLighting;
+    std::unique_ptr<DynamicLightField> _dynamicLightField;
+
+    std::optional<HudRenderer> _hudRenderer;
+    std::unique_ptr<GpuTimer> _hudGpuTimer;
+
+    // Optional, there is no sky without a catalog
+    std::optional<StarField> _starField;
+    std::unique_ptr<GpuTimer> _starGpuTimer;
+
+#ifndef ENGINE_SHIPPING
+    // Sector bounds and nearby light radii, toggled with F4
+    std::optional<DebugDrawRenderer> _debugDrawRenderer;
+    bool _isDebugDrawVisible = false;
+#endif
+
+    std::unique_ptr<Buffer> _instanceBuffer;
+    std::unique_ptr<Buffer> _instanceIndexBuffer;
+    std::array<__GLsync*, InstanceBufferFrameCount> _instanceBufferFences = {};
+    uint64_t _frameIndex = 0;
+
+    // Only the streamer and the sector origins see the 64-bit position, everything rendered is camera relative
+    WorldPosition _cameraPosition = {};
+    glm::vec3 _cameraVelocity = {};
 
-    std::unique_ptr<Buffer> _vertexBuffer;
-    std::unique_ptr<Buffer> _indexBuffer;
-    std::unique_ptr<GraphicsPipeline> _graphicsPipeline = {};
-};
\ No newline at end of file
+    uint64_t _uploadedByteCount = 0;
+    uint64_t _lodRenderedTriangleCount = 0;
+    uint64_t _lodSavedTriangleCount = 0;
+    uint64_t _lodImpostorCount = 0;
+    uint64_t _heapAllocationCount = 0;
+    uint64_t _maxFrameHeapAllocationCount = 0;
+    uint64_t _allocationFreeFrameCount = 0;
+    uint64_t _maxFrameArenaByteCount = 0;
+    uint64_t _hudGlyphCount = 0;
+    uint64_t _hudQuadCount = 0;
+    uint64_t _hudDroppedQuadCount = 0;
+    double _hudCpuMilliseconds = 0.0;
+};
@@ -1,10 +1,107 @@
 #include <GameClient/GameApplication.hpp>
+#include <EngineCore/Logging.hpp>
+#include <EngineCore/StarCatalog.hpp>
 
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <string_view>
+
+// GameClient [--diagnostics <production|development|validation>] [--synchronous-uploads] [--cpu-light-binning] [--fixed-resolution] [--frame-budget <milliseconds>] [--hud-benchmark <glyphs>]
+//            [--occlusion-reference] [--star-catalog <path>] [--star-benchmark <stars>] [--convert-star-catalog <csv> <catalog>]
 int32_t main(
-    [[maybe_unused]] int32_t argc,
-    [[maybe_unused]] char* argv[])
+    int32_t argc,
+    char* argv[])
 {
-    GameApplication application;
+    AsyncLogging asyncLogging;
+
+    ApplicationSettings settings;
+    for (auto i = 1; i < argc; i++)
+    {
+        auto option = std::string_view(argv[i]);
+        if (option == "--diagnostics" && i + 1 < argc)
+        {
+            auto parsedLevel = ParseDiagnosticsLevel(argv[++i]);
+            if (!parsedLevel)
+            {
+                spdlog::error("App: Unknown diagnostics level \"{}\"", argv[i]);
+                return 1;
+            }
+            settings.Diagnostics = *parsedLevel;
+        }
+        else if (option == "--synchronous-uploads")
+        {
+            settings.UseResourceLoaderContext = false;
+        }
+        else if (option == "--cpu-light-binning")
+        {
+            settings.UseGpuLightBinning = false;
+        }
+        else if (option == "--fixed-resolution")
+        {
+            settings.UseDynamicResolution = false;
+        }
+        else if (option == "--occlusion-reference")
+        {
+            settings.UseOcclusionReferenceFrames = true;
+        }
+        else if (option == "--frame-budget" && i + 1 < argc)
+        {
+            auto budget = std::string_view(argv[++i]);
+            auto parseResult = std::from_chars(budget.data(), budget.data() + budget.size(), settings.FrameBudgetMilliseconds);
+            if (parseResult.ec != std::errc() || settings.FrameBudgetMilliseconds <= 0.0)
+            {
+                spdlog::error("App: Invalid frame budget \"{}\"", budget);
+                return 1;
+            }
+        }
+        else if (option == "--hud-benchmark" && i + 1 < argc)
+        {
+            auto glyphCount = std::string_view(argv[++i]);
+            auto parseResult = std::from_chars(glyphCount.data(), glyphCount.data() + glyphCount.size(), settings.HudBenchmarkGlyphCount);
+            if (parseResult.ec != std::errc())
+            {
+                spdlog::error("App: Invalid HUD benchmark glyph count \"{}\"", glyphCount);
+                return 1;
+            }
+        }
+        else if (option == "--star-catalog" && i + 1 < argc)
+        {
+            settings.StarCatalogFilePath = argv[++i];
+        }
+        else if (option == "--star-benchmark" && i + 1 < argc)
+        {
+            auto starCount = std::string_view(argv[++i]);
+            auto parseResult = std::from_chars(starCount.data(), starCount.data() + starCount.size(), settings.StarBenchmarkCount);
+            if (parseResult.ec != std::errc() || settings.StarBenchmarkCount == 0)
+            {
+                spdlog::error("App: Invalid star benchmark count \"{}\"", starCount);
+                return 1;
+            }
+        }
+        else if (option == "--convert-star-catalog" && i + 2 < argc)
+        {
+            // Offline, converts a HYG style CSV and exits without opening a window
+            auto csvFilePath = std::string_view(argv[++i]);
+            auto catalogFilePath = std::string_view(argv[++i]);
+            auto starsResult = ReadStarCatalogCsv(csvFilePath);
+            if (!starsResult)
+            {
+                spdlog::error("App: {}", starsResult.error());
+                return 1;
+            }
+            auto writeResult = WriteStarCatalog(catalogFilePath, *starsResult);
+            if (!writeResult)
+            {
+                spdlog::error("App: {}", writeResult.error());
+                return 1;
+            }
+            spdlog::info("App: Converted {} stars from {} into {}", starsResult->size(), csvFilePath, catalogFilePath);
+            return 0;
+        }
+    }
+
+    GameApplication application(settings);
     application.Run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,183 @@
+#include <GameServer/ClientReplication.hpp>
+
+#include <EngineCore/BitStream.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    constexpr float QuantizedStepsPerUnit = static_cast<float>(1u << SnapshotPositionBitCount) / (2.0f * SnapshotPositionRange);
+}
+
+ClientReplication::ClientReplication(uint32_t clientId)
+    : _clientId(clientId)
+{
+    SetFocus(glm::vec3(0.0f));
+}
+
+void ClientReplication::SetFocus(const glm::vec3& position, uint32_t focusEntityId) noexcept
+{
+    auto quantized = QuantizeEntityState(EntityState{ .Id = focusEntityId, .Position = position, .Velocity = glm::vec3(0.0f) });
+    _focusPosition = { quantized.Values[0], quantized.Values[1], quantized.Values[2] };
+    _focusEntityId = focusEntityId;
+}
+
+ClientSnapshotResult ClientReplication::WriteSnapshot(
+    BitWriter& writer,
+    uint32_t maxBitCount,
+    const QuantizedSnapshot& world,
+    const InterestGrid& grid,
+    const InterestSettings& settings,
+    uint64_t tickIndex,
+    float deltaTime)
+{
+    static const QuantizedSnapshot EmptyBaseline;
+
+    // Sets stay valid for a while since entities move little per tick, staggering by client id spreads the rebuilds
+    auto focusCell = grid.GetCellOf(_focusPosition);
+    auto refreshInterval = std::max(settings.RefreshIntervalTicks, 1u);
+    if (focusCell != _focusCell || (tickIndex + _clientId) % refreshInterval == 0)
+    {
+        RefreshRelevantEntities(grid, settings);
+        _focusCell = focusCell;
+    }
+
+    // Entities gone from the world drop out here, which keeps _current and _relevantEntities index aligned
+    _current.clear();
+    _priorities.clear();
+    auto halfDistance = settings.PriorityHalfDistance * QuantizedStepsPerUnit;
+    auto inverseHalfDistanceSquared = 1.0f / std::max(halfDistance * halfDistance, 1.0f);
+    std::erase_if(_relevantEntities, [&](RelevantEntity& relevantEntity)
+    {
+        if (relevantEntity.WorldIndex >= world.size() || world[relevantEntity.WorldIndex].Id != relevantEntity.Id)
+        {
+            auto worldIndex = grid.FindWorldIndex(relevantEntity.Id);
+            if (!worldIndex)
+            {
+                return true;
+            }
+            relevantEntity.WorldIndex = *worldIndex;
+        }
+
+        auto& entity = world[relevantEntity.WorldIndex];
+        auto relevance = entity.Id == _focusEntityId ? settings.FocusEntityRelevance : 1.0f;
+        auto distanceSquared = GetDistanceSquared({ entity.Values[0], entity.Values[1], entity.Values[2] });
+        relevantEntity.Accumulator += deltaTime * relevance / (1.0f + distanceSquared * inverseHalfDistanceSquared);
+        _priorities.push_back(Priority{ .Accumulator = relevantEntity.Accumulator, .EntityIndex = static_cast<uint32_t>(_current.size()) });
+        _current.push_back(entity);
+        return false;
+    });
+
+    // No more entities than this can fit, so only they need to be in order. The rest follows
+    // unordered, only reached when enough entities in front of it are unchanged.
+    auto orderedCount = std::min<size_t>(_priorities.size(), maxBitCount / SnapshotMinEntityBitCount + 1);
+    auto isMoreImportant = [](const Priority& lhs, const Priority& rhs)
+    {
+        return lhs.Accumulator > rhs.Accumulator;
+    };
+    auto orderedEnd = _priorities.begin() + static_cast<std::ptrdiff_t>(orderedCount);
+    std::nth_element(_priorities.begin(), orderedEnd, _priorities.end(), isMoreImportant);
+    std::sort(_priorities.begin(), orderedEnd, isMoreImportant);
+    _priorityOrder.resize(_priorities.size());
+    for (auto i = 0u; i < _priorities.size(); i++)
+    {
+        _priorityOrder[i] = _priorities[i].EntityIndex;
+    }
+
+    ClientSnapshotResult result;
+    auto snapshotId = _nextSnapshotId;
+    auto& baselineSnapshot = _sentSnapshots[_ackedSnapshotId % SnapshotHistorySize];
+    result.HasBaseline = _hasAckedSnapshot &&
+        baselineSnapshot.IsValid &&
+        baselineSnapshot.Id == _ackedSnapshotId &&
+        static_cast<uint16_t>(snapshotId - _ackedSnapshotId) < SnapshotHistorySize;
+
+    auto headerStartBitCount = writer.GetBitCount();
+    writer.WriteBits(snapshotId, 16);
+    writer.WriteBool(result.HasBaseline);
+    if (result.HasBaseline)
+    {
+        writer.WriteBits(_ackedSnapshotId, 16);
+    }
+
+    result.Encode = EncodeSnapshotDelta(
+        writer,
+        result.HasBaseline ? baselineSnapshot.Entities : EmptyBaseline,
+        _current,
+        maxBitCount - std::min(writer.GetBitCount() - headerStartBitCount, maxBitCount),
+        _priorityOrder,
+        _reconstructed);
+    if (writer.IsOverflowed())
+    {
+        return result;
+    }
+
+    for (auto i = 0u; i < result.Encode.UpToDateEntityCount; i++)
+    {
+        _relevantEntities[_priorityOrder[i]].Accumulator = 0.0f;
+    }
+
+    auto& sentSnapshot = _sentSnapshots[snapshotId % SnapshotHistorySize];
+    sentSnapshot.Id = snapshotId;
+    sentSnapshot.IsValid = true;
+    sentSnapshot.Entities.swap(_reconstructed);
+    _nextSnapshotId++;
+    return result;
+}
+
+void ClientReplication::AckSnapshot(uint16_t snapshotId) noexcept
+{
+    if (!_hasAckedSnapshot || IsSequenceNewer(snapshotId, _ackedSnapshotId))
+    {
+        _ackedSnapshotId = snapshotId;
+        _hasAckedSnapshot = true;
+    }
+}
+
+void ClientReplication::RefreshRelevantEntities(const InterestGrid& grid, const InterestSettings& settings)
+{
+    auto& arena = GetThreadArena();
+    ArenaScope arenaScope(arena);
+    std::pmr::vector<InterestGrid::Entry> candidates(&arena);
+    grid.Query(_focusPosition, static_cast<uint32_t>(settings.Radius * QuantizedStepsPerUnit), candidates);
+    if (candidates.size() > settings.MaxRelevantEntityCount)
+    {
+        auto nth = candidates.begin() + settings.MaxRelevantEntityCount;
+        std::nth_element(candidates.begin(), nth, candidates.end(), [this](const InterestGrid::Entry& lhs, const InterestGrid::Entry& rhs)
+        {
+            return GetDistanceSquared(lhs.Position) < GetDistanceSquared(rhs.Position);
+        });
+        candidates.erase(nth, candidates.end());
+    }
+
+    // Ordered by id both, so accumulators carry over in one merge
+    std::sort(candidates.begin(), candidates.end(), [](const InterestGrid::Entry& lhs, const InterestGrid::Entry& rhs)
+    {
+        return lhs.Id < rhs.Id;
+    });
+    _refreshedEntities.clear();
+    auto previous = _relevantEntities.begin();
+    for (auto& candidate : candidates)
+    {
+        while (previous != _relevantEntities.end() && previous->Id < candidate.Id)
+        {
+            ++previous;
+        }
+
+        auto accumulator = previous != _relevantEntities.end() && previous->Id == candidate.Id ? previous->Accumulator : 0.0f;
+        _refreshedEntities.push_back(RelevantEntity{ .Id = candidate.Id, .WorldIndex = candidate.WorldIndex, .Accumulator = accumulator });
+    }
+    _relevantEntities.swap(_refreshedEntities);
+}
+
+float ClientReplication::GetDistanceSquared(const std::array<uint32_t, 3>& position) const noexcept
+{
+    auto distanceSquared = 0.0f;
+    for (auto axis = 0u; axis < 3; axis++)
+    {
+        auto difference = static_cast<float>(position[axis]) - static_cast<float>(_focusPosition[axis]);
+        distanceSquared += difference * difference;
+    }
+    return distanceSquared;
+}
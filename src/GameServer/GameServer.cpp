@@ -0,0 +1,1062 @@
+#include <GameServer/GameServer.hpp>
+
+#include <EngineCore/BitStream.hpp>
+#include <EngineCore/DynamicAabbTree.hpp>
+#include <EngineCore/GravitySimulation.hpp>
+#include <EngineCore/Memory.hpp>
+#include <EngineCore/PatchedConics.hpp>
+#include <EngineCore/Query.hpp>
+#include <EngineCore/SpatialHash.hpp>
+#include <EngineCore/TransformStore.hpp>
+#include <EngineCore/World.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <iterator>
+#include <numeric>
+#include <numbers>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+static_assert(std::atomic<bool>::is_always_lock_free, "RequestStop has to be usable from signal handlers");
+
+namespace
+{
+    // 64 units in quantized position steps
+    constexpr int64_t UpToDateQuantizedDistance = 64 * (1 << SnapshotPositionBitCount) / static_cast<int64_t>(2 * SnapshotPositionRange);
+
+    struct BenchmarkPlanet
+    {
+        double OrbitRadius;
+        double Mass;
+    };
+
+    // The inner solar system and Jupiter in astronomical units and solar masses, with G at 1 a year
+    // takes 2 pi. The asteroid belt lies between Mars and Jupiter
+    constexpr BenchmarkPlanet GravityBenchmarkPlanets[] =
+    {
+        { .OrbitRadius = 0.39, .Mass = 1.7e-7 },
+        { .OrbitRadius = 0.72, .Mass = 2.4e-6 },
+        { .OrbitRadius = 1.0, .Mass = 3.0e-6 },
+        { .OrbitRadius = 1.52, .Mass = 3.2e-7 },
+        { .OrbitRadius = 5.2, .Mass = 9.5e-4 },
+    };
+    // Earth, the moon goes around it
+    constexpr uint32_t GravityBenchmarkMoonParent = 2;
+    constexpr double GravityBenchmarkMinBeltRadius = 2.1;
+    constexpr double GravityBenchmarkMaxBeltRadius = 3.3;
+    // Far heavier than the real belt, so it pulls on itself noticeably
+    constexpr double GravityBenchmarkBeltMass = 1.0e-6;
+    // Little over half a day, the innermost planet takes about 150 steps per orbit
+    constexpr double GravityBenchmarkStepTime = 0.01;
+
+    // Added to and removed from every entity by the ECS benchmark, which moves it between archetypes
+    struct EcsBenchmarkTag
+    {
+        uint32_t Value;
+    };
+
+    // Bodies of the broadphase benchmark are this large, spread out so each overlaps about one
+    // other, and move up to this far per frame, so some leave their fat bounds every frame
+    constexpr float BroadphaseBenchmarkBodyRadius = 1.0f;
+    constexpr float BroadphaseBenchmarkSpacing = 4.0f;
+    constexpr float BroadphaseBenchmarkMaxSpeed = 0.25f;
+
+    double GetNanosecondsPerItem(std::chrono::steady_clock::duration time, uint64_t itemCount)
+    {
+        return std::chrono::duration<double, std::nano>(time).count() / static_cast<double>(std::max<uint64_t>(itemCount, 1));
+    }
+
+    double BenchmarkRandom(uint32_t seed, uint32_t index)
+    {
+        auto value = seed + index * 0x9e3779b9u;
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return static_cast<double>(value) / static_cast<double>(UINT32_MAX);
+    }
+
+    // Prograde, counterclockwise seen from above
+    OrbitState GetCircularOrbit(double radius, double angle)
+    {
+        auto speed = std::sqrt(1.0 / radius);
+        return OrbitState
+        {
+            .Position = glm::dvec3(std::cos(angle), 0.0, -std::sin(angle)) * radius,
+            .Velocity = glm::dvec3(-std::sin(angle), 0.0, -std::cos(angle)) * speed
+        };
+    }
+}
+
+GameServer::GameServer(const GameServerSettings& settings)
+    : _settings(settings),
+      _taskScheduler(settings.WorkerCount),
+      _simulation(_taskScheduler),
+      _interestGrid(settings.Network.Interest.GridCellSize)
+{
+    _settings.TickRate = std::max(_settings.TickRate, 1u);
+    _settings.Network.TickRate = _settings.TickRate;
+    if (_settings.SoakTestClientCount > 0 || _settings.InterestBenchmarkClientCount > 0)
+    {
+        _settings.Network.Port = 0;
+        _settings.Network.MaxClientCount = std::max(_settings.Network.MaxClientCount, _settings.SoakTestClientCount);
+    }
+}
+
+bool GameServer::Run()
+{
+    if (!_settings.ReplayPath.empty())
+    {
+        return RunReplay();
+    }
+    if (_settings.GravityBenchmarkBodyCount > 0)
+    {
+        RunGravityBenchmark();
+        return true;
+    }
+    if (_settings.EcsBenchmarkEntityCount > 0)
+    {
+        RunEcsBenchmark();
+        return true;
+    }
+    if (_settings.BroadphaseBenchmarkBodyCount > 0)
+    {
+        RunBroadphaseBenchmark();
+        return true;
+    }
+    if (_settings.TransformBenchmarkCount > 0)
+    {
+        RunTransformBenchmark();
+        return true;
+    }
+
+    auto isLoadTest = _settings.LoadTestTickCount > 0;
+    if (auto netServerResult = NetServer::Create(_settings.Network, _taskScheduler))
+    {
+        _netServer.emplace(std::move(netServerResult.value()));
+    }
+    else
+    {
+        spdlog::error("GameServer: Starting network failed. {}", netServerResult.error());
+        return false;
+    }
+
+    _simulation.SpawnEntities(_settings.EntityCount, _settings.Seed);
+
+    if (!_settings.RecordPath.empty())
+    {
+        std::vector<std::byte> header;
+        EncodeServerRecordingHeader(ServerRecordingHeader{ _settings.TickRate, _settings.Seed, _settings.EntityCount }, header);
+        if (auto recorderResult = TickRecorder::Create(_settings.RecordPath, header))
+        {
+            _recorder = std::move(recorderResult.value());
+        }
+        else
+        {
+            spdlog::error("GameServer: Starting the recording failed. {}", recorderResult.error());
+            return false;
+        }
+    }
+
+    spdlog::info("GameServer: Simulating {} entities at {} Hz on {} threads{}",
+        _simulation.GetEntityCount(),
+        _settings.TickRate,
+        _taskScheduler.GetWorkerCount() + 1,
+        isLoadTest ? " (load test)" : "");
+    spdlog::info("GameServer: Listening on port {}", _netServer->GetPort());
+
+    auto deltaTime = 1.0f / static_cast<float>(_settings.TickRate);
+    auto reportTickCount = static_cast<uint64_t>(_settings.TickRate) * ReportIntervalSeconds;
+    _tickTimes.reserve(isLoadTest ? _settings.LoadTestTickCount : reportTickCount);
+
+    // Deadlines are computed from the start time and the tick index rather than by adding up
+    // periods, so sleep overshoot and rounding never accumulate into drift
+    auto startTime = Clock::now();
+    if (!ConnectSoakTestClients(0.0))
+    {
+        return false;
+    }
+
+    _benchmarkStatistics.resize(_settings.InterestBenchmarkClientCount);
+    _benchmarkClientFocuses.resize(_settings.InterestBenchmarkClientCount);
+    for (auto i = 0u; i < _settings.InterestBenchmarkClientCount; i++)
+    {
+        _benchmarkClients.emplace_back(i);
+    }
+
+    auto scheduleTickIndex = uint64_t(0);
+    while (!_isStopRequested.load(std::memory_order_relaxed))
+    {
+        auto tickStartTime = Clock::now();
+        auto heapAllocationCount = GetHeapAllocationCount();
+        auto time = std::chrono::duration<double>(tickStartTime - startTime).count();
+        _netServer->ReceivePackets(time);
+        _simulation.Tick(deltaTime);
+        _simulation.GatherSnapshot(_worldSnapshot);
+
+        auto gridStartTime = Clock::now();
+        _interestGrid.Update(_worldSnapshot);
+        _relinkedEntityCount += _interestGrid.GetRelinkedEntityCount();
+        _interestGridTime += Clock::now() - gridStartTime;
+
+        _netServer->SendSnapshots(_worldSnapshot, _interestGrid, _simulation.GetTickIndex(), time, deltaTime);
+        for (auto i = 0u; i < _benchmarkClientFocuses.size(); i++)
+        {
+            _benchmarkClientFocuses[i] = GetTestClientFocus(i, static_cast<uint32_t>(_benchmarkClientFocuses.size()));
+        }
+        ReplicateToBenchmarkClients(deltaTime);
+        auto tickEndTime = Clock::now();
+        RecordTickTime(tickEndTime - tickStartTime, GetHeapAllocationCount() - heapAllocationCount);
+
+        if (_recorder != nullptr)
+        {
+            RecordTick(deltaTime);
+        }
+
+        for (auto i = 0u; i < _soakTestClients.size(); i++)
+        {
+            _soakTestClients[i].SetFocus(GetTestClientFocus(i, static_cast<uint32_t>(_soakTestClients.size())));
+            _soakTestClients[i].Update(time);
+        }
+        _soakTestClientTime += Clock::now() - tickEndTime;
+
+        if (isLoadTest)
+        {
+            if (_simulation.GetTickIndex() >= _settings.LoadTestTickCount)
+            {
+                break;
+            }
+        }
+        else if (_simulation.GetTickIndex() % reportTickCount == 0)
+        {
+            ReportTickTimes(false);
+        }
+
+        scheduleTickIndex++;
+        auto nextTickTime = GetTickDeadline(startTime, scheduleTickIndex);
+        if (tickEndTime > GetTickDeadline(startTime, scheduleTickIndex + MaxCatchUpTickCount))
+        {
+            // Too far behind to catch up, the simulation slows down instead of stalling in a burst of ticks
+            auto behindTickCount = static_cast<uint64_t>((tickEndTime - nextTickTime) * _settings.TickRate / std::chrono::seconds(1));
+            scheduleTickIndex += behindTickCount;
+            _skippedTickCount += behindTickCount;
+            nextTickTime = GetTickDeadline(startTime, scheduleTickIndex);
+        }
+
+        std::this_thread::sleep_until(nextTickTime);
+    }
+
+    ReportTickTimes(isLoadTest);
+    if (!_soakTestClients.empty())
+    {
+        ReportSoakTest(std::chrono::duration<double>(Clock::now() - startTime).count());
+    }
+    if (!_benchmarkClients.empty())
+    {
+        ReportInterestBenchmark();
+    }
+
+    for (auto& soakTestClient : _soakTestClients)
+    {
+        soakTestClient.Disconnect();
+    }
+
+    if (_recorder != nullptr)
+    {
+        auto frameCount = _recorder->GetFrameCount();
+        auto finishResult = _recorder->Finish();
+        _recorder.reset();
+        if (!finishResult)
+        {
+            spdlog::error("GameServer: Finishing the recording failed. {}", finishResult.error());
+            return false;
+        }
+        spdlog::info("GameServer: Recorded {} ticks to {}", frameCount, _settings.RecordPath);
+    }
+    spdlog::info("GameServer: Stopped after {} ticks and {} collisions", _simulation.GetTickIndex(), _simulation.GetCollisionCount());
+    return true;
+}
+
+bool GameServer::RunReplay()
+{
+    auto readerResult = TickRecordingReader::Open(_settings.ReplayPath);
+    if (!readerResult)
+    {
+        spdlog::error("GameServer: Opening the replay failed. {}", readerResult.error());
+        return false;
+    }
+
+    auto& reader = readerResult.value();
+    ServerRecordingHeader header;
+    if (!DecodeServerRecordingHeader(reader.GetHeader(), header) || header.TickRate == 0)
+    {
+        spdlog::error("GameServer: {} has no valid server recording header", _settings.ReplayPath);
+        return false;
+    }
+
+    _settings.TickRate = header.TickRate;
+    _simulation.SpawnEntities(header.EntityCount, header.Seed);
+    spdlog::info("GameServer: Replaying {} with {} entities recorded at {} Hz on {} threads",
+        _settings.ReplayPath,
+        _simulation.GetEntityCount(),
+        _settings.TickRate,
+        _taskScheduler.GetWorkerCount() + 1);
+
+    // Recorded clients come and go with their first focus change, each gets a replication slot
+    std::unordered_map<uint32_t, uint32_t> clientIndices;
+    auto divergedTickCount = uint64_t(0);
+    auto startTime = Clock::now();
+    while (auto frame = reader.ReadNextFrame())
+    {
+        if (_isStopRequested.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        if (!_tickInputCodec.Decode(frame->Input, _tickInput))
+        {
+            spdlog::error("GameServer: Replay input of tick {} is malformed", frame->TickIndex);
+            return false;
+        }
+
+        auto tickStartTime = Clock::now();
+        auto heapAllocationCount = GetHeapAllocationCount();
+        for (auto& focusChange : _tickInput.FocusChanges)
+        {
+            auto [clientIndex, isNew] = clientIndices.try_emplace(focusChange.ClientId, static_cast<uint32_t>(_benchmarkClients.size()));
+            if (isNew)
+            {
+                _benchmarkClients.emplace_back(focusChange.ClientId);
+                _benchmarkClientFocuses.emplace_back();
+                _benchmarkStatistics.emplace_back();
+            }
+            _benchmarkClientFocuses[clientIndex->second] = focusChange.Focus;
+        }
+
+        _simulation.Tick(_tickInput.DeltaTime);
+        _simulation.GatherSnapshot(_worldSnapshot);
+        auto gridStartTime = Clock::now();
+        _interestGrid.Update(_worldSnapshot);
+        _relinkedEntityCount += _interestGrid.GetRelinkedEntityCount();
+        _interestGridTime += Clock::now() - gridStartTime;
+        ReplicateToBenchmarkClients(_tickInput.DeltaTime);
+        RecordTickTime(Clock::now() - tickStartTime, GetHeapAllocationCount() - heapAllocationCount);
+
+        // The first divergent tick is what to bisect for, later ones mostly follow from it
+        if (_simulation.ComputeChecksum() != frame->Checksum || _simulation.GetTickIndex() != frame->TickIndex)
+        {
+            if (divergedTickCount++ == 0)
+            {
+                spdlog::error("GameServer: Replay diverged from the recording at tick {}", frame->TickIndex);
+            }
+        }
+    }
+
+    auto elapsedSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    ReportTickTimes(true);
+    spdlog::info("GameServer: Replayed {} ticks in {:.2f} s, {:.0f} ticks/s, {} diverged",
+        _simulation.GetTickIndex(),
+        elapsedSeconds,
+        static_cast<double>(_simulation.GetTickIndex()) / std::max(elapsedSeconds, 1e-9),
+        divergedTickCount);
+    if (!_benchmarkClients.empty())
+    {
+        ReportInterestBenchmark();
+    }
+
+    return divergedTickCount == 0;
+}
+
+void GameServer::RunGravityBenchmark()
+{
+    auto bodyCount = _settings.GravityBenchmarkBodyCount;
+    auto seed = _settings.Seed;
+
+    // The star and the planets are N-body bodies too, so the whole system keeps its energy
+    GravitySimulation gravity;
+    gravity.Reserve(bodyCount + static_cast<uint32_t>(std::size(GravityBenchmarkPlanets)) + 1);
+    gravity.Add(glm::dvec3(0.0), glm::dvec3(0.0), 1.0);
+    PatchedConics rails;
+    auto star = rails.AddRoot(glm::dvec3(0.0), 1.0);
+    auto moonParent = star;
+    for (auto i = 0u; i < std::size(GravityBenchmarkPlanets); i++)
+    {
+        auto& planet = GravityBenchmarkPlanets[i];
+        auto angle = 2.0 * std::numbers::pi * BenchmarkRandom(seed, i);
+        auto orbit = GetCircularOrbit(planet.OrbitRadius, angle);
+        gravity.Add(orbit.Position, orbit.Velocity, planet.Mass);
+        auto body = rails.AddBody(star, KeplerOrbit{ .SemiMajorAxis = planet.OrbitRadius, .MeanAnomalyAtEpoch = angle }, planet.Mass);
+        moonParent = i == GravityBenchmarkMoonParent ? body : moonParent;
+    }
+    rails.AddBody(moonParent, KeplerOrbit{ .SemiMajorAxis = 0.00257, .Eccentricity = 0.055, .Inclination = 0.09 }, 3.7e-8);
+
+    // Asteroids in N-body, debris on rails crossing the inner planets' orbits
+    for (auto i = 0u; i < bodyCount; i++)
+    {
+        auto randomIndex = 64 + i * 8;
+        auto radius = GravityBenchmarkMinBeltRadius + (GravityBenchmarkMaxBeltRadius - GravityBenchmarkMinBeltRadius) * BenchmarkRandom(seed, randomIndex);
+        auto orbit = GetCircularOrbit(radius, 2.0 * std::numbers::pi * BenchmarkRandom(seed, randomIndex + 1));
+        orbit.Position.y = (BenchmarkRandom(seed, randomIndex + 2) - 0.5) * 0.1 * radius;
+        gravity.Add(orbit.Position, orbit.Velocity, GravityBenchmarkBeltMass / bodyCount);
+
+        rails.AddBody(star, KeplerOrbit
+        {
+            .SemiMajorAxis = 0.6 + 1.2 * BenchmarkRandom(seed, randomIndex + 3),
+            .Eccentricity = 0.5 * BenchmarkRandom(seed, randomIndex + 4),
+            .Inclination = 0.1 * BenchmarkRandom(seed, randomIndex + 5),
+            .LongitudeOfAscendingNode = 2.0 * std::numbers::pi * BenchmarkRandom(seed, randomIndex + 6),
+            .MeanAnomalyAtEpoch = 2.0 * std::numbers::pi * BenchmarkRandom(seed, randomIndex + 7)
+        }, 0.0);
+    }
+
+    spdlog::info("GameServer: Gravity benchmark with {} N-body bodies and {} on rails over {} steps on {} threads, {} kernels",
+        gravity.GetCount(),
+        rails.GetCount(),
+        _settings.LoadTestTickCount,
+        _taskScheduler.GetWorkerCount() + 1,
+        ToString(gravity.GetKernelLevel()));
+
+    // Energy checks cost a force pass each, they stay out of the step times
+    auto energyCheckInterval = std::max<uint64_t>(_settings.LoadTestTickCount / 10, 1);
+    auto initialEnergy = gravity.ComputeEnergy(_taskScheduler);
+    auto drift = 0.0;
+    auto maxDrift = 0.0;
+    GravityStepStatistics statistics;
+    Clock::duration gravityTime = {};
+    Clock::duration railsTime = {};
+    uint64_t handOverCount = 0;
+    uint64_t stepCount = 0;
+    while (stepCount < _settings.LoadTestTickCount && !_isStopRequested.load(std::memory_order_relaxed))
+    {
+        auto stepStartTime = Clock::now();
+        gravity.Step(GravityBenchmarkStepTime, _taskScheduler);
+        gravityTime += Clock::now() - stepStartTime;
+        auto& stepStatistics = gravity.GetStatistics();
+        statistics.TreeMilliseconds += stepStatistics.TreeMilliseconds;
+        statistics.ForceMilliseconds += stepStatistics.ForceMilliseconds;
+        statistics.IntegrateMilliseconds += stepStatistics.IntegrateMilliseconds;
+        statistics.InteractionCount += stepStatistics.InteractionCount;
+        stepCount++;
+
+        auto railsStartTime = Clock::now();
+        handOverCount += rails.Update(static_cast<double>(stepCount) * GravityBenchmarkStepTime, _taskScheduler);
+        railsTime += Clock::now() - railsStartTime;
+
+        if (stepCount % energyCheckInterval == 0 || stepCount == _settings.LoadTestTickCount)
+        {
+            drift = std::abs((gravity.ComputeEnergy(_taskScheduler) - initialEnergy) / initialEnergy);
+            maxDrift = std::max(maxDrift, drift);
+        }
+    }
+
+    auto steps = static_cast<double>(std::max<uint64_t>(stepCount, 1));
+    spdlog::info("GameServer: N-body step {:.2f} ms, tree {:.2f} ms, forces {:.2f} ms, integration {:.2f} ms, {:.0f} interactions per body",
+        std::chrono::duration<double, std::milli>(gravityTime).count() / steps,
+        statistics.TreeMilliseconds / steps,
+        statistics.ForceMilliseconds / steps,
+        statistics.IntegrateMilliseconds / steps,
+        static_cast<double>(statistics.InteractionCount) / steps / static_cast<double>(gravity.GetCount()));
+    spdlog::info("GameServer: Relative energy drift {:.2e} after {} steps, {:.2e} at most",
+        drift,
+        stepCount,
+        maxDrift);
+    spdlog::info("GameServer: Patched conics {:.3f} ms/step, {} sphere of influence hand overs",
+        std::chrono::duration<double, std::milli>(railsTime).count() / steps,
+        handOverCount);
+}
+
+void GameServer::RunEcsBenchmark()
+{
+    auto entityCount = _settings.EcsBenchmarkEntityCount;
+    auto passCount = _settings.LoadTestTickCount;
+    spdlog::info("GameServer: ECS benchmark with {} entities over {} passes on {} threads",
+        entityCount,
+        passCount,
+        _taskScheduler.GetWorkerCount() + 1);
+
+    // The components of the server simulation, in an archetype of their own
+    World world;
+    Query<Body, const OrbitControl> bodies(world);
+    std::vector<Entity> entities(entityCount);
+    auto initialBody = Body{ .Position = glm::vec3(1.0f), .Velocity = glm::vec3(0.0f, 0.0f, 1.0f) };
+    auto initialOrbitControl = OrbitControl{ .TargetRadius = 1.0f, .Gain = 0.5f };
+
+    auto startTime = Clock::now();
+    world.CreateEntities(entityCount, std::span(entities), initialBody, initialOrbitControl);
+    auto batchCreateTime = Clock::now() - startTime;
+
+    startTime = Clock::now();
+    for (auto entity : entities)
+    {
+        world.DestroyEntity(entity);
+    }
+    auto destroyTime = Clock::now() - startTime;
+
+    startTime = Clock::now();
+    for (auto& entity : entities)
+    {
+        entity = world.CreateEntity(initialBody, initialOrbitControl);
+    }
+    auto createTime = Clock::now() - startTime;
+
+    auto integrate = [](Body& body, const OrbitControl& orbitControl)
+    {
+        body.Velocity -= body.Position * (orbitControl.Gain * 0.01f);
+        body.Position += body.Velocity * 0.01f;
+    };
+
+    startTime = Clock::now();
+    for (auto pass = 0u; pass < passCount; pass++)
+    {
+        bodies.ForEach([&integrate]([[maybe_unused]] Entity entity, Body& body, const OrbitControl& orbitControl)
+        {
+            integrate(body, orbitControl);
+        });
+    }
+    auto iterateTime = Clock::now() - startTime;
+
+    startTime = Clock::now();
+    for (auto pass = 0u; pass < passCount; pass++)
+    {
+        bodies.ParallelForEachChunk(_taskScheduler, [&integrate](
+            [[maybe_unused]] std::span<const Entity> chunkEntities,
+            std::span<Body> chunkBodies,
+            std::span<const OrbitControl> chunkOrbitControls)
+        {
+            for (auto i = 0u; i < chunkBodies.size(); i++)
+            {
+                integrate(chunkBodies[i], chunkOrbitControls[i]);
+            }
+        });
+    }
+    auto parallelIterateTime = Clock::now() - startTime;
+
+    // Structural changes move every entity to the archetype with the tag and back, a tenth as
+    // many rounds as there are passes since each one touches the whole entity array
+    auto roundCount = std::max<uint64_t>(passCount / 10, 1);
+    Clock::duration addTime = {};
+    Clock::duration removeTime = {};
+    auto heapAllocationCount = GetHeapAllocationCount();
+    for (auto round = 0u; round < roundCount; round++)
+    {
+        startTime = Clock::now();
+        for (auto entity : entities)
+        {
+            world.AddComponent(entity, EcsBenchmarkTag{ round });
+        }
+        addTime += Clock::now() - startTime;
+
+        startTime = Clock::now();
+        for (auto entity : entities)
+        {
+            world.RemoveComponent<EcsBenchmarkTag>(entity);
+        }
+        removeTime += Clock::now() - startTime;
+    }
+    heapAllocationCount = GetHeapAllocationCount() - heapAllocationCount;
+
+    auto iteratedEntityCount = passCount * entityCount;
+    auto changedEntityCount = roundCount * entityCount;
+    spdlog::info("GameServer: Creating {:.1f} ns/entity batched and {:.1f} ns/entity one at a time, destroying {:.1f} ns/entity",
+        GetNanosecondsPerItem(batchCreateTime, entityCount),
+        GetNanosecondsPerItem(createTime, entityCount),
+        GetNanosecondsPerItem(destroyTime, entityCount));
+    spdlog::info("GameServer: Iterating {:.2f} ns/entity with ForEach and {:.2f} ns/entity with ParallelForEachChunk",
+        GetNanosecondsPerItem(iterateTime, iteratedEntityCount),
+        GetNanosecondsPerItem(parallelIterateTime, iteratedEntityCount));
+    spdlog::info("GameServer: Adding a component {:.1f} ns/entity and removing it {:.1f} ns/entity over {} rounds, {:.3f} heap allocations per change",
+        GetNanosecondsPerItem(addTime, changedEntityCount),
+        GetNanosecondsPerItem(removeTime, changedEntityCount),
+        roundCount,
+        static_cast<double>(heapAllocationCount) / static_cast<double>(std::max<uint64_t>(2 * changedEntityCount, 1)));
+    spdlog::info("GameServer: {} entities in {} archetypes after the benchmark",
+        world.GetEntityCount(),
+        world.GetArchetypes().size());
+}
+
+void GameServer::RunBroadphaseBenchmark()
+{
+    auto frameCount = _settings.LoadTestTickCount;
+    spdlog::info("GameServer: Broadphase benchmark up to {} bodies over {} frames on {} threads",
+        _settings.BroadphaseBenchmarkBodyCount,
+        frameCount,
+        _taskScheduler.GetWorkerCount() + 1);
+
+    for (auto bodyCount = std::min(1000u, _settings.BroadphaseBenchmarkBodyCount); bodyCount > 0;)
+    {
+        // The same density at every count, so pairs per body stay comparable
+        auto extent = BroadphaseBenchmarkSpacing * std::cbrt(static_cast<float>(bodyCount));
+        std::vector<glm::vec3> positions(bodyCount);
+        std::vector<glm::vec3> velocities(bodyCount);
+        for (auto i = 0u; i < bodyCount; i++)
+        {
+            auto randomIndex = i * 6;
+            for (auto axis = 0; axis < 3; axis++)
+            {
+                positions[i][axis] = extent * static_cast<float>(BenchmarkRandom(_settings.Seed, randomIndex + axis));
+                velocities[i][axis] = BroadphaseBenchmarkMaxSpeed * static_cast<float>(2.0 * BenchmarkRandom(_settings.Seed, randomIndex + 3 + axis) - 1.0);
+            }
+        }
+
+        std::vector<uint32_t> userData(bodyCount);
+        std::iota(userData.begin(), userData.end(), 0u);
+        std::vector<Aabb> bounds(bodyCount);
+        auto updateBounds = [&]()
+        {
+            for (auto i = 0u; i < bodyCount; i++)
+            {
+                bounds[i] = Aabb{ .Min = positions[i] - glm::vec3(BroadphaseBenchmarkBodyRadius), .Max = positions[i] + glm::vec3(BroadphaseBenchmarkBodyRadius) };
+            }
+        };
+
+        DynamicAabbTree dynamicAabbTree;
+        SpatialHash spatialHash(2.0f * BroadphaseBenchmarkBodyRadius);
+        std::array<Broadphase*, 2> broadphases = { &dynamicAabbTree, &spatialHash };
+        std::array<std::string_view, 2> broadphaseNames = { "Dynamic AABB tree", "Spatial hash" };
+        std::array<std::vector<int32_t>, 2> proxyIds;
+        std::array<Clock::duration, 2> createTimes = {};
+        std::array<Clock::duration, 2> updateTimes = {};
+        std::array<Clock::duration, 2> findPairsTimes = {};
+        std::array<uint64_t, 2> pairCounts = {};
+        BroadphasePairBuffer pairBuffer(bodyCount);
+
+        updateBounds();
+        for (auto i = 0u; i < broadphases.size(); i++)
+        {
+            proxyIds[i].resize(bodyCount);
+            auto startTime = Clock::now();
+            broadphases[i]->CreateProxies(bounds, userData, proxyIds[i], _taskScheduler);
+            createTimes[i] = Clock::now() - startTime;
+        }
+
+        // Both see the same bodies every frame and have to agree on the pairs
+        auto mismatchedFrameCount = 0u;
+        for (auto frame = 0u; frame < frameCount; frame++)
+        {
+            for (auto i = 0u; i < bodyCount; i++)
+            {
+                positions[i] += velocities[i];
+            }
+            updateBounds();
+
+            std::array<uint32_t, 2> framePairCounts = {};
+            for (auto i = 0u; i < broadphases.size(); i++)
+            {
+                auto startTime = Clock::now();
+                broadphases[i]->UpdateProxies(proxyIds[i], bounds, _taskScheduler);
+                auto updateEndTime = Clock::now();
+                broadphases[i]->FindPairs(pairBuffer, _taskScheduler);
+                while (pairBuffer.HasOverflowed())
+                {
+                    pairBuffer.Resize(2 * pairBuffer.GetCapacity());
+                    broadphases[i]->FindPairs(pairBuffer, _taskScheduler);
+                }
+                updateTimes[i] += updateEndTime - startTime;
+                findPairsTimes[i] += Clock::now() - updateEndTime;
+                framePairCounts[i] = static_cast<uint32_t>(pairBuffer.GetPairs().size());
+                pairCounts[i] += framePairCounts[i];
+            }
+            mismatchedFrameCount += framePairCounts[0] != framePairCounts[1] ? 1 : 0;
+        }
+
+        auto frames = static_cast<double>(std::max<uint64_t>(frameCount, 1));
+        for (auto i = 0u; i < broadphases.size(); i++)
+        {
+            spdlog::info("GameServer: {} with {} bodies, create {:.2f} ms, update {:.3f} ms, find pairs {:.3f} ms, {:.1f} ns/body per frame, {:.0f} pairs",
+                broadphaseNames[i],
+                bodyCount,
+                std::chrono::duration<double, std::milli>(createTimes[i]).count(),
+                std::chrono::duration<double, std::milli>(updateTimes[i]).count() / frames,
+                std::chrono::duration<double, std::milli>(findPairsTimes[i]).count() / frames,
+                GetNanosecondsPerItem(updateTimes[i] + findPairsTimes[i], frameCount * bodyCount),
+                static_cast<double>(pairCounts[i]) / frames);
+        }
+        if (mismatchedFrameCount > 0)
+        {
+            spdlog::error("GameServer: Broadphases disagreed on the pair count in {} frames", mismatchedFrameCount);
+        }
+
+        bodyCount = bodyCount < _settings.BroadphaseBenchmarkBodyCount
+            ? static_cast<uint32_t>(std::min<uint64_t>(uint64_t(bodyCount) * 10, _settings.BroadphaseBenchmarkBodyCount))
+            : 0;
+    }
+}
+
+void GameServer::RunTransformBenchmark()
+{
+    auto transformCount = _settings.TransformBenchmarkCount;
+    auto passCount = _settings.LoadTestTickCount;
+    spdlog::info("GameServer: Transform benchmark with {} transforms over {} passes",
+        transformCount,
+        passCount);
+
+    // The same transforms once as glm values, the way they were composed before the kernels, and
+    // once in the store
+    std::vector<glm::vec3> positions(transformCount);
+    std::vector<glm::quat> rotations(transformCount);
+    std::vector<glm::vec3> scales(transformCount);
+    TransformStore transforms;
+    transforms.Reserve(transformCount);
+    for (auto i = 0u; i < transformCount; i++)
+    {
+        auto random = [this, i](uint32_t value)
+        {
+            return static_cast<float>(2.0 * BenchmarkRandom(_settings.Seed, i * 10 + value) - 1.0);
+        };
+        positions[i] = glm::vec3(random(0), random(1), random(2)) * 1000.0f;
+        rotations[i] = glm::normalize(glm::quat(random(3), random(4), random(5), random(6)));
+        scales[i] = glm::vec3(random(7), random(8), random(9)) * 0.75f + glm::vec3(1.25f);
+        transforms.Add(positions[i], rotations[i], scales[i]);
+    }
+
+    auto viewProjection = glm::perspective(1.0f, 16.0f / 9.0f, 0.1f, 10000.0f) * glm::lookAt(glm::vec3(0.0f, 500.0f, 2000.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    std::vector<glm::mat4> expectedMatrices(transformCount);
+    auto startTime = Clock::now();
+    for (auto pass = 0u; pass < passCount; pass++)
+    {
+        for (auto i = 0u; i < transformCount; i++)
+        {
+            auto model = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(rotations[i]) * glm::scale(glm::mat4(1.0f), scales[i]);
+            expectedMatrices[i] = viewProjection * model;
+        }
+    }
+    auto glmNanoseconds = GetNanosecondsPerItem(Clock::now() - startTime, passCount * transformCount);
+    spdlog::info("GameServer: glm {:.2f} ns/transform", glmNanoseconds);
+
+    std::vector<glm::mat4> matrices(transformCount);
+    auto computeMatrices = [&](TaskScheduler* taskScheduler)
+    {
+        std::fill(matrices.begin(), matrices.end(), glm::mat4(0.0f));
+        auto computeStartTime = Clock::now();
+        for (auto pass = 0u; pass < passCount; pass++)
+        {
+            transforms.ComputeMatrices(viewProjection, matrices.data(), sizeof(glm::mat4), taskScheduler);
+        }
+        return GetNanosecondsPerItem(Clock::now() - computeStartTime, passCount * transformCount);
+    };
+
+    // Relative to the largest element of each matrix, the kernels multiply in another order than glm
+    auto getLargestDifference = [&]()
+    {
+        auto largestDifference = 0.0f;
+        for (auto i = 0u; i < transformCount; i++)
+        {
+            auto difference = 0.0f;
+            auto magnitude = 1.0f;
+            for (auto column = 0; column < 4; column++)
+            {
+                for (auto row = 0; row < 4; row++)
+                {
+                    difference = std::max(difference, std::abs(matrices[i][column][row] - expectedMatrices[i][column][row]));
+                    magnitude = std::max(magnitude, std::abs(expectedMatrices[i][column][row]));
+                }
+            }
+            largestDifference = std::max(largestDifference, difference / magnitude);
+        }
+        return largestDifference;
+    };
+
+    for (auto kernelLevel : { TransformKernelLevel::Scalar, TransformKernelLevel::Sse2, TransformKernelLevel::Avx2, TransformKernelLevel::Neon })
+    {
+        if (!IsTransformKernelLevelSupported(kernelLevel))
+        {
+            spdlog::info("GameServer: {} kernels are not supported on this CPU", ToString(kernelLevel));
+            continue;
+        }
+
+        transforms.SetKernelLevel(kernelLevel);
+        auto nanoseconds = computeMatrices(nullptr);
+        spdlog::info("GameServer: {} kernels {:.2f} ns/transform, {:.2f}x glm, {:.1e} relative difference to glm at most",
+            ToString(kernelLevel),
+            nanoseconds,
+            glmNanoseconds / nanoseconds,
+            getLargestDifference());
+    }
+
+    transforms.SetKernelLevel(GetSupportedTransformKernelLevel());
+    auto nanoseconds = computeMatrices(&_taskScheduler);
+    spdlog::info("GameServer: {} kernels on {} threads {:.2f} ns/transform, {:.2f}x glm",
+        ToString(transforms.GetKernelLevel()),
+        _taskScheduler.GetWorkerCount() + 1,
+        nanoseconds,
+        glmNanoseconds / nanoseconds);
+}
+
+void GameServer::RecordTick(float deltaTime)
+{
+    _tickInput.DeltaTime = deltaTime;
+    _tickInput.FocusChanges = _netServer->GetFocusChanges();
+    _encodedTickInput.clear();
+    _tickInputCodec.Encode(_tickInput, _encodedTickInput);
+    _recorder->RecordTick(_simulation.GetTickIndex(), _encodedTickInput, _simulation.ComputeChecksum());
+    if (_recorder->HasFailed())
+    {
+        // Keep serving, the recording stays readable up to the last tick that reached the file
+        spdlog::error("GameServer: Stopped recording at tick {}. {}", _simulation.GetTickIndex(), _recorder->Finish().error());
+        _recorder.reset();
+    }
+}
+
+GameServer::Clock::time_point GameServer::GetTickDeadline(Clock::time_point startTime, uint64_t tickIndex) const noexcept
+{
+    auto elapsed = std::chrono::nanoseconds(static_cast<int64_t>(tickIndex * 1'000'000'000ull / _settings.TickRate));
+    return startTime + std::chrono::duration_cast<Clock::duration>(elapsed);
+}
+
+void GameServer::RecordTickTime(Clock::duration tickTime, uint64_t heapAllocationCount)
+{
+    _heapAllocationCount += heapAllocationCount;
+    _allocationFreeTickCount += heapAllocationCount == 0 ? 1 : 0;
+    auto tickTimeMilliseconds = std::chrono::duration<double, std::milli>(tickTime).count();
+    _tickTimes.push_back(tickTimeMilliseconds);
+    _totalTickTime += tickTime;
+    if (tickTimeMilliseconds > 1000.0 / static_cast<double>(_settings.TickRate))
+    {
+        _overBudgetTickCount++;
+    }
+}
+
+void GameServer::ReportTickTimes(bool isLoadTest)
+{
+    if (_tickTimes.empty())
+    {
+        return;
+    }
+
+    auto tickCount = _tickTimes.size();
+    auto percentiles = ComputePercentiles(_tickTimes);
+    spdlog::info("GameServer: {} {} ticks, tick time p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, p99.9 {:.3f} ms, max {:.3f} ms",
+        isLoadTest ? "Load test over" : "Last",
+        tickCount,
+        percentiles.P50,
+        percentiles.P90,
+        percentiles.P99,
+        percentiles.P999,
+        percentiles.Max);
+    spdlog::info("GameServer: Budget {:.3f} ms, {} ticks over budget, {} ticks skipped",
+        1000.0 / static_cast<double>(_settings.TickRate),
+        _overBudgetTickCount,
+        _skippedTickCount);
+    spdlog::info("GameServer: {:.1f} heap allocations per tick, {} ticks without any",
+        static_cast<double>(_heapAllocationCount) / static_cast<double>(tickCount),
+        _allocationFreeTickCount);
+
+    std::string liveHeap;
+    for (auto tag = 0u; tag < static_cast<uint32_t>(MemoryTag::Count); tag++)
+    {
+        auto memoryTag = static_cast<MemoryTag>(tag);
+        if (auto statistics = GetMemoryTagStatistics(memoryTag); statistics.LiveAllocationCount > 0)
+        {
+            std::format_to(std::back_inserter(liveHeap), "{}{} {} KiB",
+                liveHeap.empty() ? "" : ", ",
+                GetMemoryTagName(memoryTag),
+                statistics.LiveByteCount / 1024);
+        }
+    }
+    spdlog::info("GameServer: Live heap {}", liveHeap);
+
+    _tickTimes.clear();
+    _heapAllocationCount = 0;
+    _allocationFreeTickCount = 0;
+    _overBudgetTickCount = 0;
+    _skippedTickCount = 0;
+}
+
+bool GameServer::ConnectSoakTestClients(double time)
+{
+    _soakTestClients.reserve(_settings.SoakTestClientCount);
+    for (auto i = 0u; i < _settings.SoakTestClientCount; i++)
+    {
+        auto clientResult = NetClient::Create();
+        if (!clientResult)
+        {
+            spdlog::error("GameServer: Creating soak test client {} failed. {}", i, clientResult.error());
+            return false;
+        }
+
+        _soakTestClients.push_back(std::move(clientResult.value()));
+        _soakTestClients.back().Connect(NetAddress::Loopback(_netServer->GetPort()), time);
+    }
+
+    return true;
+}
+
+void GameServer::ReportSoakTest(double elapsedSeconds)
+{
+    auto clientCount = static_cast<double>(_soakTestClients.size());
+    auto statistics = _netServer->GetStatistics();
+    auto connectedClientCount = 0u;
+    auto sentByteCount = uint64_t(0);
+    auto droppedSnapshotCount = uint64_t(0);
+    auto lostPacketCount = uint64_t(0);
+    auto upToDateEntityCount = uint64_t(0);
+    auto heldEntityCount = uint64_t(0);
+    for (auto& soakTestClient : _soakTestClients)
+    {
+        connectedClientCount += soakTestClient.GetState() == NetClientState::Connected ? 1 : 0;
+        sentByteCount += soakTestClient.GetStatistics().SentByteCount;
+        droppedSnapshotCount += soakTestClient.GetStatistics().DroppedSnapshotCount;
+        lostPacketCount += soakTestClient.GetConnection().GetStatistics().LostPacketCount;
+
+        // How much of what the client holds matches the latest world
+        auto& clientSnapshot = soakTestClient.GetSnapshot();
+        heldEntityCount += clientSnapshot.size();
+        for (auto& entity : clientSnapshot)
+        {
+            auto worldEntity = std::lower_bound(_worldSnapshot.begin(), _worldSnapshot.end(), entity.Id, [](const QuantizedEntityState& entityState, uint32_t id)
+            {
+                return entityState.Id < id;
+            });
+            if (worldEntity == _worldSnapshot.end() || worldEntity->Id != entity.Id)
+            {
+                continue;
+            }
+
+            auto isUpToDate = true;
+            for (auto axis = 0u; axis < 3; axis++)
+            {
+                auto difference = static_cast<int64_t>(worldEntity->Values[axis]) - static_cast<int64_t>(entity.Values[axis]);
+                isUpToDate = isUpToDate && std::abs(difference) <= UpToDateQuantizedDistance;
+            }
+            if (isUpToDate)
+            {
+                upToDateEntityCount++;
+            }
+        }
+    }
+
+    auto snapshotCount = static_cast<double>(std::max<uint64_t>(statistics.SentSnapshotCount, 1));
+    spdlog::info("GameServer: Soak test with {} of {} clients connected over {:.1f} s",
+        connectedClientCount,
+        _soakTestClients.size(),
+        elapsedSeconds);
+    spdlog::info("GameServer: Per client {:.0f} B/s down, {:.0f} B/s up, {:.1f} snapshots/s, {:.1f} of {:.1f} relevant entities and {:.1f} bits/entity per snapshot",
+        static_cast<double>(statistics.SentByteCount) / elapsedSeconds / clientCount,
+        static_cast<double>(sentByteCount) / elapsedSeconds / clientCount,
+        static_cast<double>(statistics.SentSnapshotCount) / elapsedSeconds / clientCount,
+        static_cast<double>(statistics.SentEntityCount) / snapshotCount,
+        static_cast<double>(statistics.RelevantEntityCount) / snapshotCount,
+        static_cast<double>(statistics.SentByteCount * 8) / static_cast<double>(std::max<uint64_t>(statistics.SentEntityCount, 1)));
+    spdlog::info("GameServer: Per client CPU {:.3f} ms/s on the server and {:.3f} ms/s on the client",
+        std::chrono::duration<double, std::milli>(_totalTickTime).count() / elapsedSeconds / clientCount,
+        std::chrono::duration<double, std::milli>(_soakTestClientTime).count() / elapsedSeconds / clientCount);
+    spdlog::info("GameServer: {} entity updates deferred by bandwidth, {} snapshots without baseline, {} dropped, {} packets lost, {:.1f}% of entities held by clients within 64 units",
+        statistics.DeferredEntityCount,
+        statistics.SnapshotsWithoutBaselineCount,
+        droppedSnapshotCount,
+        lostPacketCount,
+        100.0 * static_cast<double>(upToDateEntityCount) / static_cast<double>(std::max<uint64_t>(heldEntityCount, 1)));
+}
+
+void GameServer::ReplicateToBenchmarkClients(float deltaTime)
+{
+    if (_benchmarkClients.empty())
+    {
+        return;
+    }
+
+    auto startTime = Clock::now();
+    auto clientCount = static_cast<uint32_t>(_benchmarkClients.size());
+    auto snapshotSize = std::clamp<uint32_t>(_settings.Network.BandwidthBytesPerSecond / _settings.TickRate, 16u, MaxNetPacketSize);
+    _taskScheduler.ParallelFor(clientCount, 8, [&](uint32_t begin, uint32_t end)
+    {
+        std::array<std::byte, MaxNetPacketSize> packet;
+        for (auto i = begin; i < end; i++)
+        {
+            auto& focus = _benchmarkClientFocuses[i];
+            auto& client = _benchmarkClients[i];
+            client.SetFocus(focus.Position, focus.EntityId);
+
+            BitWriter writer(std::span(packet.data(), snapshotSize));
+            auto snapshotResult = client.WriteSnapshot(
+                writer,
+                writer.GetRemainingBitCount() - 8,
+                _worldSnapshot,
+                _interestGrid,
+                _settings.Network.Interest,
+                _simulation.GetTickIndex(),
+                deltaTime);
+            writer.Flush();
+
+            client.AckSnapshot(client.GetLastSnapshotId());
+            AccumulateSnapshotStatistics(_benchmarkStatistics[i], snapshotResult, writer.GetByteCount(), client.GetRelevantEntityCount());
+        }
+    });
+    _benchmarkReplicationTime += Clock::now() - startTime;
+}
+
+void GameServer::ReportInterestBenchmark()
+{
+    NetServerStatistics statistics;
+    for (auto& clientStatistics : _benchmarkStatistics)
+    {
+        statistics.SentByteCount += clientStatistics.SentByteCount;
+        statistics.SentSnapshotCount += clientStatistics.SentSnapshotCount;
+        statistics.SentEntityCount += clientStatistics.SentEntityCount;
+        statistics.DeferredEntityCount += clientStatistics.DeferredEntityCount;
+        statistics.RelevantEntityCount += clientStatistics.RelevantEntityCount;
+    }
+
+    auto tickCount = static_cast<double>(std::max<uint64_t>(_simulation.GetTickIndex(), 1));
+    auto snapshotCount = static_cast<double>(std::max<uint64_t>(statistics.SentSnapshotCount, 1));
+    auto replicationMilliseconds = std::chrono::duration<double, std::milli>(_benchmarkReplicationTime).count();
+    spdlog::info("GameServer: Interest benchmark with {} clients and {} entities over {} ticks",
+        _benchmarkClients.size(),
+        _worldSnapshot.size(),
+        _simulation.GetTickIndex());
+    spdlog::info("GameServer: Interest grid {:.3f} ms/tick with {:.0f} entities changing cells per tick",
+        std::chrono::duration<double, std::milli>(_interestGridTime).count() / tickCount,
+        static_cast<double>(_relinkedEntityCount) / tickCount);
+    spdlog::info("GameServer: Replication {:.3f} ms/tick, {:.2f} us per client snapshot",
+        replicationMilliseconds / tickCount,
+        1000.0 * replicationMilliseconds / snapshotCount);
+    spdlog::info("GameServer: Per snapshot {:.1f} relevant entities, {:.1f} sent, {:.1f} deferred, {:.0f} bytes",
+        static_cast<double>(statistics.RelevantEntityCount) / snapshotCount,
+        static_cast<double>(statistics.SentEntityCount) / snapshotCount,
+        static_cast<double>(statistics.DeferredEntityCount) / snapshotCount,
+        static_cast<double>(statistics.SentByteCount) / snapshotCount);
+}
+
+NetClientFocus GameServer::GetTestClientFocus(uint32_t clientIndex, uint32_t clientCount) const noexcept
+{
+    // Test clients ride along with entities spread evenly over the world
+    if (_worldSnapshot.empty())
+    {
+        return NetClientFocus{};
+    }
+
+    auto& entity = _worldSnapshot[static_cast<uint64_t>(clientIndex) * _worldSnapshot.size() / std::max(clientCount, 1u)];
+    return NetClientFocus{ .Position = DequantizeEntityState(entity).Position, .EntityId = entity.Id };
+}
+
+TickTimePercentiles GameServer::ComputePercentiles(std::vector<double>& tickTimes)
+{
+    std::sort(tickTimes.begin(), tickTimes.end());
+
+    // Nearest rank, so every reported value is a tick time that actually happened
+    auto getPercentile = [&tickTimes](double percentile)
+    {
+        auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(tickTimes.size())));
+        return tickTimes[std::clamp<size_t>(rank, 1, tickTimes.size()) - 1];
+    };
+
+    return TickTimePercentiles
+    {
+        .P50 = getPercentile(50.0),
+        .P90 = getPercentile(90.0),
+        .P99 = getPercentile(99.0),
+        .P999 = getPercentile(99.9),
+        .Max = tickTimes.back()
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <GameServer/InterestGrid.hpp>
+#include <EngineCore/NetClient.hpp>
+#include <EngineCore/Snapshot.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class BitWriter;
+
+struct InterestSettings
+{
+    // Entities further away from a client's focus are not replicated to it at all
+    float Radius = 500.0f;
+    // The nearest ones win when more entities are in range
+    uint32_t MaxRelevantEntityCount = 1024;
+    // Distance at which an entity's priority has dropped to half
+    float PriorityHalfDistance = 100.0f;
+    // Priority multiplier for the entity the client controls
+    float FocusEntityRelevance = 16.0f;
+    // Relevant sets are rebuilt this often, staggered across clients, and whenever a client changes grid cells
+    uint32_t RefreshIntervalTicks = 8;
+    float GridCellSize = 256.0f;
+};
+
+struct ClientSnapshotResult
+{
+    SnapshotEncodeResult Encode;
+    bool HasBaseline = false;
+};
+
+// Everything the server tracks to replicate the world to one client: the interest set around
+// the client's focus, a priority accumulator per relevant entity and the snapshots sent to it.
+// Accumulators grow every tick by distance and relevance and are reset once the client holds the
+// entity's current state, so entities the budget keeps cutting eventually win over near ones.
+class ClientReplication
+{
+public:
+    static constexpr uint32_t InvalidEntityId = UINT32_MAX;
+
+    explicit ClientReplication(uint32_t clientId);
+
+    // focusEntityId is the entity the client controls, if any
+    void SetFocus(const glm::vec3& position, uint32_t focusEntityId = InvalidEntityId) noexcept;
+
+    // Writes snapshot id, baseline id and the delta of the client's relevant entities within maxBitCount
+    ClientSnapshotResult WriteSnapshot(
+        BitWriter& writer,
+        uint32_t maxBitCount,
+        const QuantizedSnapshot& world,
+        const InterestGrid& grid,
+        const InterestSettings& settings,
+        uint64_t tickIndex,
+        float deltaTime);
+
+    // The newest acked snapshot becomes the baseline for everything sent from then on
+    void AckSnapshot(uint16_t snapshotId) noexcept;
+
+    uint16_t GetLastSnapshotId() const noexcept
+    {
+        return static_cast<uint16_t>(_nextSnapshotId - 1);
+    }
+
+    uint32_t GetRelevantEntityCount() const noexcept
+    {
+        return static_cast<uint32_t>(_relevantEntities.size());
+    }
+
+private:
+    struct SentSnapshot
+    {
+        uint16_t Id = 0;
+        bool IsValid = false;
+        QuantizedSnapshot Entities;
+    };
+
+    struct RelevantEntity
+    {
+        uint32_t Id = 0;
+        // Stays valid until entities are created or destroyed, checked against the world before use
+        uint32_t WorldIndex = 0;
+        float Accumulator = 0.0f;
+    };
+
+    struct Priority
+    {
+        float Accumulator;
+        uint32_t EntityIndex;
+    };
+
+    void RefreshRelevantEntities(const InterestGrid& grid, const InterestSettings& settings);
+    float GetDistanceSquared(const std::array<uint32_t, 3>& position) const noexcept;
+
+    uint32_t _clientId = 0;
+    std::array<uint32_t, 3> _focusPosition = {};
+    uint32_t _focusEntityId = InvalidEntityId;
+    uint32_t _focusCell = UINT32_MAX;
+
+    // Ordered by id
+    std::vector<RelevantEntity> _relevantEntities;
+
+    std::array<SentSnapshot, SnapshotHistorySize> _sentSnapshots = {};
+    uint16_t _nextSnapshotId = 0;
+    uint16_t _ackedSnapshotId = 0;
+    bool _hasAckedSnapshot = false;
+
+    // Scratch kept around to not allocate per snapshot
+    QuantizedSnapshot _current;
+    QuantizedSnapshot _reconstructed;
+    std::vector<Priority> _priorities;
+    std::vector<uint32_t> _priorityOrder;
+    std::vector<RelevantEntity> _refreshedEntities;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <GameServer/ClientReplication.hpp>
+#include <GameServer/InterestGrid.hpp>
+#include <GameServer/NetServer.hpp>
+#include <GameServer/ServerSimulation.hpp>
+#include <GameServer/ServerTickInput.hpp>
+#include <EngineCore/NetClient.hpp>
+#include <EngineCore/Snapshot.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/TickRecording.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct GameServerSettings
+{
+    uint32_t TickRate = 30;
+    // 0 picks hardware_concurrency - 1, the tick thread always participates
+    uint32_t WorkerCount = 0;
+    uint32_t EntityCount = 1024;
+    uint32_t Seed = 1;
+    // Stops after this many ticks and reports tick time percentiles, 0 runs until RequestStop
+    uint64_t LoadTestTickCount = 0;
+    NetServerSettings Network;
+    // Clients connected over loopback from inside the server process, needs LoadTestTickCount
+    uint32_t SoakTestClientCount = 0;
+    // Replicates to this many clients each following an entity, without sockets and with every
+    // snapshot acked right away, which isolates the cost of interest management and encoding
+    uint32_t InterestBenchmarkClientCount = 0;
+    // Records every tick's input and state checksum while running
+    std::string RecordPath;
+    // Replays a recording as fast as possible instead of running, recorded clients are replicated
+    // to like interest benchmark clients
+    std::string ReplayPath;
+    // Steps an asteroid belt of this many N-body bodies, and as many bodies on rails, for
+    // LoadTestTickCount steps instead of running, and reports step times and energy drift
+    uint32_t GravityBenchmarkBodyCount = 0;
+    // Creates this many ECS entities and runs LoadTestTickCount iteration passes over them instead
+    // of running, and reports creation, iteration, structural change and destruction times
+    uint32_t EcsBenchmarkEntityCount = 0;
+    // Moves 1k, 10k and so on up to this many bodies through each broadphase for LoadTestTickCount
+    // frames instead of running, and reports update and pair finding times
+    uint32_t BroadphaseBenchmarkBodyCount = 0;
+    // Composes this many transform matrices LoadTestTickCount times with glm and with every SIMD
+    // kernel level the CPU supports instead of running, and reports the speedup over glm
+    uint32_t TransformBenchmarkCount = 0;
+};
+
+struct TickTimePercentiles
+{
+    double P50 = 0.0;
+    double P90 = 0.0;
+    double P99 = 0.0;
+    double P999 = 0.0;
+    double Max = 0.0;
+};
+
+class GameServer
+{
+public:
+    explicit GameServer(const GameServerSettings& settings);
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // False when the server could not start or a replay diverged from its recording
+    bool Run();
+
+    // Safe to call from other threads and from signal handlers
+    void RequestStop() noexcept
+    {
+        _isStopRequested.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Ticks falling further behind than this are dropped instead of being caught up in a burst
+    static constexpr uint64_t MaxCatchUpTickCount = 5;
+    static constexpr uint32_t ReportIntervalSeconds = 10;
+
+    bool RunReplay();
+    void RunGravityBenchmark();
+    void RunEcsBenchmark();
+    void RunBroadphaseBenchmark();
+    void RunTransformBenchmark();
+    void RecordTick(float deltaTime);
+    Clock::time_point GetTickDeadline(Clock::time_point startTime, uint64_t tickIndex) const noexcept;
+    void RecordTickTime(Clock::duration tickTime, uint64_t heapAllocationCount);
+    void ReportTickTimes(bool isLoadTest);
+    bool ConnectSoakTestClients(double time);
+    void ReportSoakTest(double elapsedSeconds);
+    void ReplicateToBenchmarkClients(float deltaTime);
+    void ReportInterestBenchmark();
+    NetClientFocus GetTestClientFocus(uint32_t clientIndex, uint32_t clientCount) const noexcept;
+
+    static TickTimePercentiles ComputePercentiles(std::vector<double>& tickTimes);
+
+    GameServerSettings _settings;
+    TaskScheduler _taskScheduler;
+    ServerSimulation _simulation;
+    std::optional<NetServer> _netServer;
+    QuantizedSnapshot _worldSnapshot;
+    InterestGrid _interestGrid;
+    std::atomic<bool> _isStopRequested = false;
+
+    std::vector<NetClient> _soakTestClients;
+    // Time the soak test clients spent receiving and acking, kept apart from the tick times
+    Clock::duration _soakTestClientTime = {};
+    Clock::duration _totalTickTime = {};
+
+    std::vector<ClientReplication> _benchmarkClients;
+    // One each per benchmark client, they are replicated in parallel
+    std::vector<NetClientFocus> _benchmarkClientFocuses;
+    std::vector<NetServerStatistics> _benchmarkStatistics;
+    Clock::duration _interestGridTime = {};
+    Clock::duration _benchmarkReplicationTime = {};
+    uint64_t _relinkedEntityCount = 0;
+
+    std::unique_ptr<TickRecorder> _recorder;
+    ServerTickInputCodec _tickInputCodec;
+    ServerTickInput _tickInput;
+    std::vector<std::byte> _encodedTickInput;
+
+    // Milliseconds spent simulating per tick since the last report
+    std::vector<double> _tickTimes;
+    uint64_t _overBudgetTickCount = 0;
+    uint64_t _skippedTickCount = 0;
+    uint64_t _heapAllocationCount = 0;
+    uint64_t _allocationFreeTickCount = 0;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <EngineCore/Snapshot.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+// Uniform grid over quantized snapshot positions, which spans the whole replicated range with
+// a fixed number of cells. Entities are only relinked when they cross into another cell, cell
+// entries carry positions so queries never touch the world itself.
+class InterestGrid
+{
+public:
+    struct Entry
+    {
+        uint32_t Id;
+        uint32_t WorldIndex;
+        std::array<uint32_t, 3> Position;
+    };
+
+    // cellSize is rounded up to a power of two number of quantized position steps
+    explicit InterestGrid(float cellSize);
+
+    void Update(const QuantizedSnapshot& world);
+
+    // Appends the entries of entities within radius quantized steps of center
+    void Query(
+        const std::array<uint32_t, 3>& center,
+        uint32_t radius,
+        std::pmr::vector<Entry>& entries) const;
+
+    uint32_t GetCellOf(const std::array<uint32_t, 3>& position) const noexcept;
+
+    // Index into the world of the last Update, nullopt for entities which are not part of it
+    std::optional<uint32_t> FindWorldIndex(uint32_t id) const noexcept
+    {
+        if (id >= _entities.size() || _entities[id].Cell == InvalidCell)
+        {
+            return std::nullopt;
+        }
+
+        return _entities[id].WorldIndex;
+    }
+
+    // Entities that changed cells in the last Update, the part that is not free
+    uint32_t GetRelinkedEntityCount() const noexcept
+    {
+        return _relinkedEntityCount;
+    }
+
+private:
+    static constexpr uint32_t InvalidCell = UINT32_MAX;
+    static constexpr uint32_t MinCellCapacity = 16;
+
+    struct EntityRecord
+    {
+        uint32_t Cell = InvalidCell;
+        uint32_t Slot = 0;
+        uint32_t WorldIndex = 0;
+        uint32_t LastUpdate = 0;
+    };
+
+    void Link(uint32_t id, uint32_t cell);
+    void Unlink(uint32_t id);
+
+    uint32_t _cellShift = 0;
+    uint32_t _cellsPerAxis = 0;
+    // x fastest
+    std::vector<std::vector<Entry>> _cells;
+    // Indexed by entity id, ids are dense entity indices
+    std::vector<EntityRecord> _entities;
+    uint32_t _updateIndex = 0;
+    uint32_t _relinkedEntityCount = 0;
+};
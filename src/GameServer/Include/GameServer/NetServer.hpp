@@ -0,0 +1,144 @@
+#pragma once
+
+#include <GameServer/ClientReplication.hpp>
+#include <GameServer/InterestGrid.hpp>
+#include <EngineCore/NetClient.hpp>
+#include <EngineCore/NetConnection.hpp>
+#include <EngineCore/Snapshot.hpp>
+#include <EngineCore/UdpSocket.hpp>
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TaskScheduler;
+
+struct NetServerSettings
+{
+    // 0 binds an ephemeral port
+    uint16_t Port = 27015;
+    uint32_t MaxClientCount = 128;
+    uint32_t TickRate = 30;
+    // Per client, snapshots shrink to whatever the budget leaves room for
+    uint32_t BandwidthBytesPerSecond = 32 * 1024;
+    double TimeoutSeconds = 5.0;
+    InterestSettings Interest;
+};
+
+struct NetServerStatistics
+{
+    uint64_t SentByteCount = 0;
+    uint64_t ReceivedByteCount = 0;
+    uint64_t SentSnapshotCount = 0;
+    uint64_t SentEntityCount = 0;
+    // Changed entities the bandwidth budget pushed to later snapshots
+    uint64_t DeferredEntityCount = 0;
+    uint64_t SnapshotsWithoutBaselineCount = 0;
+    // Summed per snapshot, divide by SentSnapshotCount for the average interest set size
+    uint64_t RelevantEntityCount = 0;
+};
+
+// Adds one client's snapshot to the statistics
+void AccumulateSnapshotStatistics(
+    NetServerStatistics& statistics,
+    const ClientSnapshotResult& snapshotResult,
+    uint32_t byteCount,
+    uint32_t relevantEntityCount) noexcept;
+
+struct NetClientFocusChange
+{
+    uint32_t ClientId = 0;
+    NetClientFocus Focus;
+};
+
+class NetServer
+{
+public:
+    static std::expected<NetServer, std::string> Create(const NetServerSettings& settings, TaskScheduler& taskScheduler);
+
+    // Accepts connections, processes acks and drops clients which timed out
+    void ReceivePackets(double time);
+
+    // Client focus updates of the last ReceivePackets, the player input of this tick
+    const std::vector<NetClientFocusChange>& GetFocusChanges() const noexcept
+    {
+        return _focusChanges;
+    }
+
+    // Sends every client the entities around its focus, delta encoded against the last snapshot it
+    // acked and most important first. Clients are encoded in parallel, each within its bandwidth
+    // budget. grid has to be updated with world.
+    void SendSnapshots(
+        const QuantizedSnapshot& world,
+        const InterestGrid& grid,
+        uint64_t tickIndex,
+        double time,
+        double deltaTime);
+
+    uint16_t GetPort() const noexcept
+    {
+        return _socket.GetPort();
+    }
+
+    uint32_t GetClientCount() const noexcept
+    {
+        return static_cast<uint32_t>(_clients.size());
+    }
+
+    // Accumulated over all clients since the last ResetStatistics
+    NetServerStatistics GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+private:
+    NetServer(const NetServerSettings& settings, TaskScheduler& taskScheduler, UdpSocket socket);
+
+    static constexpr uint32_t PacketSnapshotBufferSize = 1024;
+    // Below this the client waits for its budget to refill rather than getting a tiny snapshot
+    static constexpr uint32_t MinSnapshotPacketSize = 128;
+
+    struct Client
+    {
+        NetAddress Address;
+        uint32_t ClientId = 0;
+        double LastReceiveTime = 0.0;
+        NetConnection Connection;
+        ClientReplication Replication;
+        NetClientFocus Focus;
+        // Packet sequence + 1 and the snapshot it carried, per sequence buffer slot
+        std::array<std::pair<uint32_t, uint16_t>, PacketSnapshotBufferSize> PacketSnapshots = {};
+
+        double BandwidthTokens = 0.0;
+        NetServerStatistics Statistics;
+
+        explicit Client(uint32_t clientId)
+            : ClientId(clientId),
+              Replication(clientId)
+        {
+        }
+    };
+
+    void ProcessPacket(const NetAddress& address, std::span<const std::byte> packet, double time);
+    void AcceptClient(const NetAddress& address, double time);
+    void SendSnapshot(
+        Client& client,
+        const QuantizedSnapshot& world,
+        const InterestGrid& grid,
+        uint64_t tickIndex,
+        double time,
+        float deltaTime);
+    void SendControlPacket(const NetAddress& address, NetPacketType packetType) const;
+
+    NetServerSettings _settings;
+    TaskScheduler* _taskScheduler = nullptr;
+    UdpSocket _socket;
+    std::vector<std::unique_ptr<Client>> _clients;
+    std::unordered_map<NetAddress, Client*, NetAddressHasher> _clientsByAddress;
+    uint32_t _nextClientId = 1;
+    NetServerStatistics _statistics;
+    std::vector<NetClientFocusChange> _focusChanges;
+};
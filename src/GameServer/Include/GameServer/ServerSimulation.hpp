@@ -0,0 +1,75 @@
+#pragma once
+
+#include <EngineCore/Broadphase.hpp>
+#include <EngineCore/Query.hpp>
+#include <EngineCore/Snapshot.hpp>
+#include <EngineCore/SpatialHash.hpp>
+#include <EngineCore/World.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class TaskScheduler;
+
+struct Body
+{
+    glm::vec3 Position;
+    glm::vec3 Velocity;
+};
+
+// Ships thrust along their orbit's radius to hold it, which keeps the simulation bounded however long it runs
+struct OrbitControl
+{
+    float TargetRadius;
+    float Gain;
+};
+
+// The authoritative world, everything here is deterministic for a given seed and tick count
+class ServerSimulation
+{
+public:
+    explicit ServerSimulation(TaskScheduler& taskScheduler);
+
+    void SpawnEntities(uint32_t count, uint32_t seed);
+    void Tick(float deltaTime);
+    // Quantized state of every entity, ordered by id, as replicated to clients
+    void GatherSnapshot(QuantizedSnapshot& snapshot);
+    // Hash over the exact body state, equal across runs exactly when they stayed deterministic
+    uint64_t ComputeChecksum();
+
+    uint64_t GetEntityCount() const noexcept
+    {
+        return _world.GetEntityCount();
+    }
+
+    uint64_t GetTickIndex() const noexcept
+    {
+        return _tickIndex;
+    }
+
+    // Ships that bounced off each other since the start
+    uint64_t GetCollisionCount() const noexcept
+    {
+        return _collisionCount;
+    }
+
+private:
+    void ResolveCollisions();
+
+    TaskScheduler& _taskScheduler;
+    World _world;
+    Query<Body, const OrbitControl> _bodies;
+    uint64_t _tickIndex = 0;
+
+    // Every body moves every tick and all share one size, which suits a grid rebuilt per tick
+    SpatialHash _broadphase;
+    BroadphasePairBuffer _collisionPairs;
+    std::vector<BroadphasePair> _sortedCollisionPairs;
+    // Indexed by entity index
+    std::vector<Entity> _entities;
+    std::vector<int32_t> _proxyIds;
+    std::vector<Aabb> _colliderBounds;
+    uint64_t _collisionCount = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <GameServer/NetServer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// What a recording needs to reproduce a server session
+struct ServerRecordingHeader
+{
+    uint32_t TickRate = 0;
+    uint32_t Seed = 0;
+    uint32_t EntityCount = 0;
+};
+
+void EncodeServerRecordingHeader(const ServerRecordingHeader& header, std::vector<std::byte>& bytes);
+bool DecodeServerRecordingHeader(std::span<const std::byte> bytes, ServerRecordingHeader& header);
+
+// Everything that went into one server tick from outside
+struct ServerTickInput
+{
+    float DeltaTime = 0.0f;
+    std::vector<NetClientFocusChange> FocusChanges;
+};
+
+// Delta encodes tick inputs against the previous ones, so a tick without player input takes two
+// bytes. Encoding and decoding must see the same sequence of ticks.
+class ServerTickInputCodec
+{
+public:
+    void Encode(const ServerTickInput& input, std::vector<std::byte>& bytes);
+    // False for malformed input
+    bool Decode(std::span<const std::byte> bytes, ServerTickInput& input);
+
+private:
+    uint32_t _previousDeltaTimeBits = 0;
+    // Quantized like snapshot positions, per client id
+    std::unordered_map<uint32_t, std::array<uint32_t, 3>> _previousFocusPositions;
+};
@@ -0,0 +1,127 @@
+#include <GameServer/InterestGrid.hpp>
+
+#include <algorithm>
+#include <bit>
+
+InterestGrid::InterestGrid(float cellSize)
+{
+    auto quantizedCellSize = cellSize * static_cast<float>(1u << SnapshotPositionBitCount) / (2.0f * SnapshotPositionRange);
+    _cellShift = std::clamp(static_cast<uint32_t>(std::bit_width(static_cast<uint32_t>(std::max(quantizedCellSize, 1.0f)) - 1)), 1u, SnapshotPositionBitCount - 1);
+    _cellsPerAxis = 1u << (SnapshotPositionBitCount - _cellShift);
+    _cells.resize(static_cast<size_t>(_cellsPerAxis) * _cellsPerAxis * _cellsPerAxis);
+}
+
+void InterestGrid::Update(const QuantizedSnapshot& world)
+{
+    _updateIndex++;
+    _relinkedEntityCount = 0;
+
+    for (auto worldIndex = 0u; worldIndex < world.size(); worldIndex++)
+    {
+        auto& entity = world[worldIndex];
+        if (entity.Id >= _entities.size())
+        {
+            _entities.resize(std::max<size_t>(entity.Id + 1, _entities.size() * 2));
+        }
+
+        std::array<uint32_t, 3> position = { entity.Values[0], entity.Values[1], entity.Values[2] };
+        auto cell = GetCellOf(position);
+        auto& record = _entities[entity.Id];
+        record.WorldIndex = worldIndex;
+        record.LastUpdate = _updateIndex;
+        if (record.Cell != cell)
+        {
+            Unlink(entity.Id);
+            Link(entity.Id, cell);
+            _relinkedEntityCount++;
+        }
+
+        auto& entry = _cells[cell][record.Slot];
+        entry.WorldIndex = worldIndex;
+        entry.Position = position;
+    }
+
+    // Anything not touched above is gone from the world
+    for (auto id = 0u; id < _entities.size(); id++)
+    {
+        if (_entities[id].Cell != InvalidCell && _entities[id].LastUpdate != _updateIndex)
+        {
+            Unlink(id);
+        }
+    }
+}
+
+void InterestGrid::Query(
+    const std::array<uint32_t, 3>& center,
+    uint32_t radius,
+    std::pmr::vector<Entry>& entries) const
+{
+    std::array<uint32_t, 3> minCell;
+    std::array<uint32_t, 3> maxCell;
+    for (auto axis = 0u; axis < 3; axis++)
+    {
+        minCell[axis] = (center[axis] > radius ? center[axis] - radius : 0) >> _cellShift;
+        maxCell[axis] = std::min((center[axis] + radius) >> _cellShift, _cellsPerAxis - 1);
+    }
+
+    auto radiusSquared = static_cast<float>(radius) * static_cast<float>(radius);
+    for (auto z = minCell[2]; z <= maxCell[2]; z++)
+    {
+        for (auto y = minCell[1]; y <= maxCell[1]; y++)
+        {
+            for (auto x = minCell[0]; x <= maxCell[0]; x++)
+            {
+                for (auto& entry : _cells[(z * _cellsPerAxis + y) * _cellsPerAxis + x])
+                {
+                    auto distanceSquared = 0.0f;
+                    for (auto axis = 0u; axis < 3; axis++)
+                    {
+                        auto difference = static_cast<float>(entry.Position[axis]) - static_cast<float>(center[axis]);
+                        distanceSquared += difference * difference;
+                    }
+
+                    if (distanceSquared <= radiusSquared)
+                    {
+                        entries.push_back(entry);
+                    }
+                }
+            }
+        }
+    }
+}
+
+uint32_t InterestGrid::GetCellOf(const std::array<uint32_t, 3>& position) const noexcept
+{
+    auto x = std::min(position[0] >> _cellShift, _cellsPerAxis - 1);
+    auto y = std::min(position[1] >> _cellShift, _cellsPerAxis - 1);
+    auto z = std::min(position[2] >> _cellShift, _cellsPerAxis - 1);
+    return (z * _cellsPerAxis + y) * _cellsPerAxis + x;
+}
+
+void InterestGrid::Link(uint32_t id, uint32_t cell)
+{
+    // Cells keep their capacity when entities leave, starting them bigger skips the first few regrowths
+    auto& cellEntries = _cells[cell];
+    if (cellEntries.capacity() == 0)
+    {
+        cellEntries.reserve(MinCellCapacity);
+    }
+    _entities[id].Cell = cell;
+    _entities[id].Slot = static_cast<uint32_t>(cellEntries.size());
+    cellEntries.push_back(Entry{ .Id = id, .WorldIndex = 0, .Position = {} });
+}
+
+void InterestGrid::Unlink(uint32_t id)
+{
+    auto& record = _entities[id];
+    if (record.Cell == InvalidCell)
+    {
+        return;
+    }
+
+    auto& cellEntries = _cells[record.Cell];
+    cellEntries[record.Slot] = cellEntries.back();
+    _entities[cellEntries[record.Slot].Id].Slot = record.Slot;
+    cellEntries.pop_back();
+    record.Cell = InvalidCell;
+}
@@ -1,8 +1,214 @@
+#include <GameServer/GameServer.hpp>
+#include <EngineCore/Logging.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <csignal>
 #include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    GameServer* gServer = nullptr;
+
+    constexpr uint32_t DefaultLoadTestSeconds = 30;
+    constexpr uint64_t DefaultGravityBenchmarkStepCount = 20;
+    constexpr uint64_t DefaultEcsBenchmarkPassCount = 100;
+    constexpr uint64_t DefaultBroadphaseBenchmarkFrameCount = 20;
+    constexpr uint64_t DefaultTransformBenchmarkPassCount = 50;
+    // Bodies are counted in 32 bits, the benchmark adds its star and planets on top
+    constexpr uint64_t MaxGravityBenchmarkBodyCount = UINT32_MAX - 8;
+
+    void HandleStopSignal([[maybe_unused]] int32_t signal)
+    {
+        if (gServer != nullptr)
+        {
+            gServer->RequestStop();
+        }
+    }
+
+    template <typename T>
+    std::expected<T, std::string> ParseNumber(std::string_view option, std::string_view value)
+    {
+        T number = {};
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (error != std::errc() || end != value.data() + value.size())
+        {
+            return std::unexpected(std::format("Option {} expects a number but got \"{}\"", option, value));
+        }
+
+        return number;
+    }
+
+    // GameServer [--tick-rate <hz>] [--workers <count>] [--entities <count>] [--seed <seed>]
+    //            [--port <port>] [--max-clients <count>] [--bandwidth <bytes per second per client>]
+    //            [--load-test <entity count>] [--soak-test <client count>] [--interest-benchmark <client count>]
+    //            [--ticks <count>] [--record <path>] [--replay <path>] [--gravity-benchmark <body count>]
+    //            [--ecs-benchmark <entity count>] [--broadphase-benchmark <body count>]
+    //            [--transform-benchmark <transform count>]
+    std::expected<GameServerSettings, std::string> ParseSettings(int32_t argc, char* argv[])
+    {
+        GameServerSettings settings;
+        auto isLoadTest = false;
+
+        for (auto i = 1; i < argc; i++)
+        {
+            auto option = std::string_view(argv[i]);
+            if (i + 1 >= argc)
+            {
+                return std::unexpected(std::format("Option {} is missing its value", option));
+            }
+
+            auto value = std::string_view(argv[++i]);
+            if (option == "--record")
+            {
+                settings.RecordPath = value;
+                continue;
+            }
+            if (option == "--replay")
+            {
+                settings.ReplayPath = value;
+                continue;
+            }
+
+            auto number = ParseNumber<uint64_t>(option, value);
+            if (!number)
+            {
+                return std::unexpected(number.error());
+            }
+
+            // Only the tick count is kept in 64 bits and the port in 16, larger values would wrap
+            auto maxNumber = option == "--ticks" ? UINT64_MAX : option == "--port" ? uint64_t(UINT16_MAX) : uint64_t(UINT32_MAX);
+            if (number.value() > maxNumber)
+            {
+                return std::unexpected(std::format("Option {} expects at most {} but got {}", option, maxNumber, value));
+            }
+
+            if (option == "--tick-rate")
+            {
+                settings.TickRate = std::max(static_cast<uint32_t>(number.value()), 1u);
+            }
+            else if (option == "--workers")
+            {
+                settings.WorkerCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--entities")
+            {
+                settings.EntityCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--seed")
+            {
+                settings.Seed = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--port")
+            {
+                settings.Network.Port = static_cast<uint16_t>(number.value());
+            }
+            else if (option == "--max-clients")
+            {
+                settings.Network.MaxClientCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--bandwidth")
+            {
+                settings.Network.BandwidthBytesPerSecond = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--soak-test")
+            {
+                settings.SoakTestClientCount = static_cast<uint32_t>(number.value());
+                isLoadTest = true;
+            }
+            else if (option == "--interest-benchmark")
+            {
+                settings.InterestBenchmarkClientCount = static_cast<uint32_t>(number.value());
+                isLoadTest = true;
+            }
+            else if (option == "--load-test")
+            {
+                settings.EntityCount = static_cast<uint32_t>(number.value());
+                isLoadTest = true;
+            }
+            else if (option == "--ticks")
+            {
+                settings.LoadTestTickCount = number.value();
+                isLoadTest = true;
+            }
+            else if (option == "--gravity-benchmark")
+            {
+                if (number.value() > MaxGravityBenchmarkBodyCount)
+                {
+                    return std::unexpected(std::format("Option {} expects at most {} bodies but got {}", option, MaxGravityBenchmarkBodyCount, value));
+                }
+                settings.GravityBenchmarkBodyCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--ecs-benchmark")
+            {
+                settings.EcsBenchmarkEntityCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--broadphase-benchmark")
+            {
+                settings.BroadphaseBenchmarkBodyCount = static_cast<uint32_t>(number.value());
+            }
+            else if (option == "--transform-benchmark")
+            {
+                settings.TransformBenchmarkCount = static_cast<uint32_t>(number.value());
+            }
+            else
+            {
+                return std::unexpected(std::format("Unknown option {} {}", option, value));
+            }
+        }
+
+        if (isLoadTest && settings.LoadTestTickCount == 0)
+        {
+            settings.LoadTestTickCount = static_cast<uint64_t>(settings.TickRate) * DefaultLoadTestSeconds;
+        }
+        // A million bodies take their time per step
+        if (settings.GravityBenchmarkBodyCount > 0 && settings.LoadTestTickCount == 0)
+        {
+            settings.LoadTestTickCount = DefaultGravityBenchmarkStepCount;
+        }
+        if (settings.EcsBenchmarkEntityCount > 0 && settings.LoadTestTickCount == 0)
+        {
+            settings.LoadTestTickCount = DefaultEcsBenchmarkPassCount;
+        }
+        if (settings.BroadphaseBenchmarkBodyCount > 0 && settings.LoadTestTickCount == 0)
+        {
+            settings.LoadTestTickCount = DefaultBroadphaseBenchmarkFrameCount;
+        }
+        if (settings.TransformBenchmarkCount > 0 && settings.LoadTestTickCount == 0)
+        {
+            settings.LoadTestTickCount = DefaultTransformBenchmarkPassCount;
+        }
+
+        return settings;
+    }
+}
 
 int32_t main(
-    [[maybe_unused]] int32_t argc,
-    [[maybe_unused]] char* argv[])
+    int32_t argc,
+    char* argv[])
 {
-    return 0;
+    AsyncLogging asyncLogging;
+
+    auto settingsResult = ParseSettings(argc, argv);
+    if (!settingsResult)
+    {
+        spdlog::error("GameServer: {}", settingsResult.error());
+        return 1;
+    }
+
+    GameServer server(settingsResult.value());
+    gServer = &server;
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    auto hasRun = server.Run();
+
+    gServer = nullptr;
+    return hasRun ? 0 : 1;
 }
@@ -0,0 +1,268 @@
+#include <GameServer/NetServer.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+
+void AccumulateSnapshotStatistics(
+    NetServerStatistics& statistics,
+    const ClientSnapshotResult& snapshotResult,
+    uint32_t byteCount,
+    uint32_t relevantEntityCount) noexcept
+{
+    statistics.SentByteCount += byteCount;
+    statistics.SentSnapshotCount++;
+    statistics.SentEntityCount += snapshotResult.Encode.WrittenEntityCount;
+    statistics.DeferredEntityCount += snapshotResult.Encode.SkippedEntityCount;
+    statistics.SnapshotsWithoutBaselineCount += snapshotResult.HasBaseline ? 0 : 1;
+    statistics.RelevantEntityCount += relevantEntityCount;
+}
+
+std::expected<NetServer, std::string> NetServer::Create(const NetServerSettings& settings, TaskScheduler& taskScheduler)
+{
+    auto socketResult = UdpSocket::Create(settings.Port);
+    if (!socketResult)
+    {
+        return std::unexpected(socketResult.error());
+    }
+
+    return NetServer(settings, taskScheduler, std::move(socketResult.value()));
+}
+
+NetServer::NetServer(const NetServerSettings& settings, TaskScheduler& taskScheduler, UdpSocket socket)
+    : _settings(settings),
+      _taskScheduler(&taskScheduler),
+      _socket(std::move(socket))
+{
+}
+
+void NetServer::ReceivePackets(double time)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Network);
+
+    _focusChanges.clear();
+    std::array<std::byte, MaxNetPacketSize> packet;
+    NetAddress address;
+    while (auto packetSize = _socket.Receive(packet, address))
+    {
+        _statistics.ReceivedByteCount += *packetSize;
+        ProcessPacket(address, std::span(packet.data(), *packetSize), time);
+    }
+
+    std::erase_if(_clients, [this, time](const std::unique_ptr<Client>& client)
+    {
+        if (time - client->LastReceiveTime < _settings.TimeoutSeconds)
+        {
+            return false;
+        }
+
+        spdlog::info("NetServer: Client {} timed out", client->ClientId);
+        _clientsByAddress.erase(client->Address);
+        return true;
+    });
+}
+
+void NetServer::SendSnapshots(
+    const QuantizedSnapshot& world,
+    const InterestGrid& grid,
+    uint64_t tickIndex,
+    double time,
+    double deltaTime)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Network);
+
+    auto maxBandwidthTokens = 2.0 * MaxNetPacketSize;
+    _taskScheduler->ParallelFor(static_cast<uint32_t>(_clients.size()), 4, [&](uint32_t begin, uint32_t end)
+    {
+        for (auto i = begin; i < end; i++)
+        {
+            auto& client = *_clients[i];
+            client.BandwidthTokens = std::min(client.BandwidthTokens + _settings.BandwidthBytesPerSecond * deltaTime, maxBandwidthTokens);
+            if (client.BandwidthTokens >= MinSnapshotPacketSize)
+            {
+                SendSnapshot(client, world, grid, tickIndex, time, static_cast<float>(deltaTime));
+            }
+        }
+    });
+}
+
+NetServerStatistics NetServer::GetStatistics() const noexcept
+{
+    auto statistics = _statistics;
+    for (auto& client : _clients)
+    {
+        statistics.SentByteCount += client->Statistics.SentByteCount;
+        statistics.SentSnapshotCount += client->Statistics.SentSnapshotCount;
+        statistics.SentEntityCount += client->Statistics.SentEntityCount;
+        statistics.DeferredEntityCount += client->Statistics.DeferredEntityCount;
+        statistics.SnapshotsWithoutBaselineCount += client->Statistics.SnapshotsWithoutBaselineCount;
+        statistics.RelevantEntityCount += client->Statistics.RelevantEntityCount;
+    }
+    return statistics;
+}
+
+void NetServer::ResetStatistics() noexcept
+{
+    _statistics = {};
+    for (auto& client : _clients)
+    {
+        client->Statistics = {};
+    }
+}
+
+void NetServer::ProcessPacket(const NetAddress& address, std::span<const std::byte> packet, double time)
+{
+    BitReader reader(packet);
+    auto packetType = ReadNetPacketPrefix(reader);
+    if (!packetType)
+    {
+        return;
+    }
+
+    auto clientIterator = _clientsByAddress.find(address);
+    auto client = clientIterator != _clientsByAddress.end() ? clientIterator->second : nullptr;
+    if (client != nullptr)
+    {
+        client->LastReceiveTime = time;
+    }
+
+    switch (*packetType)
+    {
+        case NetPacketType::ConnectRequest:
+            if (client != nullptr)
+            {
+                // Our accept got lost
+                SendControlPacket(address, NetPacketType::ConnectAccept);
+            }
+            else
+            {
+                AcceptClient(address, time);
+            }
+            break;
+        case NetPacketType::Data:
+            if (client == nullptr || !client->Connection.ReadPacketHeader(reader, time))
+            {
+                break;
+            }
+
+            if (auto focus = ReadNetClientFocus(reader); !reader.IsOverflowed() &&
+                (focus.Position != client->Focus.Position || focus.EntityId != client->Focus.EntityId))
+            {
+                client->Focus = focus;
+                client->Replication.SetFocus(focus.Position, focus.EntityId);
+                _focusChanges.push_back(NetClientFocusChange{ .ClientId = client->ClientId, .Focus = focus });
+            }
+
+            for (auto sequence : client->Connection.GetAckedSequences())
+            {
+                auto [packetSequence, snapshotId] = client->PacketSnapshots[sequence % PacketSnapshotBufferSize];
+                if (packetSequence == sequence + 1u)
+                {
+                    client->Replication.AckSnapshot(snapshotId);
+                }
+            }
+            client->Connection.ClearAckedSequences();
+            break;
+        case NetPacketType::Disconnect:
+            if (client != nullptr)
+            {
+                spdlog::info("NetServer: Client {} disconnected", client->ClientId);
+                _clientsByAddress.erase(address);
+                std::erase_if(_clients, [client](const std::unique_ptr<Client>& other)
+                {
+                    return other.get() == client;
+                });
+            }
+            break;
+        case NetPacketType::ConnectAccept:
+            break;
+    }
+}
+
+void NetServer::AcceptClient(const NetAddress& address, double time)
+{
+    if (_clients.size() >= _settings.MaxClientCount)
+    {
+        SendControlPacket(address, NetPacketType::Disconnect);
+        return;
+    }
+
+    auto client = std::make_unique<Client>(_nextClientId++);
+    client->Address = address;
+    client->BandwidthTokens = MaxNetPacketSize;
+
+    std::array<std::byte, 16> serverInfoMessage;
+    BitWriter writer(serverInfoMessage);
+    WriteNetServerInfo(writer, NetServerInfo{ client->ClientId, _settings.TickRate });
+    writer.Flush();
+    client->Connection.SendReliable(std::span(serverInfoMessage.data(), writer.GetByteCount()));
+    client->LastReceiveTime = time;
+
+    _clientsByAddress[address] = client.get();
+    _clients.push_back(std::move(client));
+    SendControlPacket(address, NetPacketType::ConnectAccept);
+}
+
+void NetServer::SendSnapshot(
+    Client& client,
+    const QuantizedSnapshot& world,
+    const InterestGrid& grid,
+    uint64_t tickIndex,
+    double time,
+    float deltaTime)
+{
+    std::array<std::byte, MaxNetPacketSize> packet;
+    auto packetSize = std::min<uint32_t>(MaxNetPacketSize, static_cast<uint32_t>(client.BandwidthTokens));
+    BitWriter writer(std::span(packet.data(), packetSize));
+    WriteNetPacketPrefix(writer, NetPacketType::Data);
+    auto sequence = client.Connection.WritePacketHeader(writer, time);
+
+    // Leaves the last byte for the terminator and flush padding. Resent reliable messages can leave
+    // less room than that, the packet then carries them alone
+    auto hasSnapshotRoom = writer.GetRemainingBitCount() > 8;
+    writer.WriteBool(hasSnapshotRoom);
+    if (!hasSnapshotRoom)
+    {
+        writer.Flush();
+        if (!writer.IsOverflowed())
+        {
+            _socket.Send(client.Address, std::span(packet.data(), writer.GetByteCount()));
+            client.BandwidthTokens -= writer.GetByteCount();
+            client.Statistics.SentByteCount += writer.GetByteCount();
+        }
+        return;
+    }
+
+    auto snapshotResult = client.Replication.WriteSnapshot(
+        writer,
+        writer.GetRemainingBitCount() - 8,
+        world,
+        grid,
+        _settings.Interest,
+        tickIndex,
+        deltaTime);
+    writer.Flush();
+    if (writer.IsOverflowed())
+    {
+        spdlog::error("NetServer: Snapshot for client {} overflowed its packet", client.ClientId);
+        return;
+    }
+
+    client.PacketSnapshots[sequence % PacketSnapshotBufferSize] = { sequence + 1u, client.Replication.GetLastSnapshotId() };
+
+    _socket.Send(client.Address, std::span(packet.data(), writer.GetByteCount()));
+    client.BandwidthTokens -= writer.GetByteCount();
+    AccumulateSnapshotStatistics(client.Statistics, snapshotResult, writer.GetByteCount(), client.Replication.GetRelevantEntityCount());
+}
+
+void NetServer::SendControlPacket(const NetAddress& address, NetPacketType packetType) const
+{
+    std::array<std::byte, 8> packet;
+    BitWriter writer(packet);
+    WriteNetPacketPrefix(writer, packetType);
+    writer.Flush();
+    _socket.Send(address, std::span(packet.data(), writer.GetByteCount()));
+}
@@ -0,0 +1,227 @@
+#include <GameServer/ServerSimulation.hpp>
+#include <EngineCore/TaskScheduler.hpp>
+#include <EngineCore/Memory.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+    constexpr float GravitationalParameter = 4.0e6f;
+    constexpr float MinOrbitRadius = 200.0f;
+    constexpr float MaxOrbitRadius = 5000.0f;
+    constexpr float ShipRadius = 2.0f;
+    // Ships are sparse, cells a few ships wide hold most of them in a single cell
+    constexpr float CollisionCellSize = 8.0f * ShipRadius;
+
+    Aabb GetShipBounds(const glm::vec3& position) noexcept
+    {
+        return Aabb{ .Min = position - glm::vec3(ShipRadius), .Max = position + glm::vec3(ShipRadius) };
+    }
+
+    uint64_t MixChecksum(uint64_t checksum, uint64_t value) noexcept
+    {
+        checksum = (checksum ^ value) * 0xBF58476D1CE4E5B9ull;
+        return checksum ^ (checksum >> 31);
+    }
+
+    float Random(uint32_t seed, uint32_t index)
+    {
+        auto value = seed + index * 0x9e3779b9u;
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return static_cast<float>(value) / static_cast<float>(UINT32_MAX);
+    }
+}
+
+ServerSimulation::ServerSimulation(TaskScheduler& taskScheduler)
+    : _taskScheduler(taskScheduler),
+      _bodies(_world),
+      _broadphase(CollisionCellSize),
+      _collisionPairs(0)
+{
+}
+
+void ServerSimulation::SpawnEntities(uint32_t count, uint32_t seed)
+{
+    std::vector<Entity> entities(count);
+    _world.CreateEntities(count, std::span(entities), Body{}, OrbitControl{});
+
+    for (auto i = 0u; i < count; i++)
+    {
+        // Roughly circular orbits in a thick disc around the origin
+        auto randomIndex = i * 4;
+        auto radius = MinOrbitRadius + (MaxOrbitRadius - MinOrbitRadius) * Random(seed, randomIndex);
+        auto angle = 2.0f * std::numbers::pi_v<float> * Random(seed, randomIndex + 1);
+        auto height = (Random(seed, randomIndex + 2) - 0.5f) * 0.1f * radius;
+        auto radial = glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+        auto tangent = glm::vec3(-radial.z, 0.0f, radial.x);
+        auto orbitSpeed = std::sqrt(GravitationalParameter / radius);
+
+        auto body = _world.GetComponent<Body>(entities[i]);
+        body->Position = radial * radius + glm::vec3(0.0f, height, 0.0f);
+        body->Velocity = tangent * orbitSpeed * (0.9f + 0.2f * Random(seed, randomIndex + 3));
+
+        auto orbitControl = _world.GetComponent<OrbitControl>(entities[i]);
+        orbitControl->TargetRadius = radius;
+        orbitControl->Gain = 0.5f;
+    }
+
+    auto entityIndexCount = entities.empty() ? _entities.size() : std::max<size_t>(_entities.size(), entities.back().Index + 1);
+    _entities.resize(entityIndexCount);
+    _proxyIds.resize(entityIndexCount);
+    _colliderBounds.resize(entityIndexCount);
+
+    std::vector<Aabb> bounds(count);
+    std::vector<uint32_t> userData(count);
+    std::vector<int32_t> proxyIds(count);
+    for (auto i = 0u; i < count; i++)
+    {
+        _entities[entities[i].Index] = entities[i];
+        bounds[i] = GetShipBounds(_world.GetComponent<Body>(entities[i])->Position);
+        userData[i] = entities[i].Index;
+    }
+    _broadphase.CreateProxies(bounds, userData, proxyIds, _taskScheduler);
+    for (auto i = 0u; i < count; i++)
+    {
+        _proxyIds[entities[i].Index] = proxyIds[i];
+        _colliderBounds[entities[i].Index] = bounds[i];
+    }
+    _collisionPairs.Resize(std::max(_collisionPairs.GetCapacity(), static_cast<uint32_t>(_entities.size())));
+}
+
+void ServerSimulation::Tick(float deltaTime)
+{
+    MemoryTagScope memoryTagScope(MemoryTag::Simulation);
+
+    _bodies.ParallelForEachChunk(_taskScheduler, [this, deltaTime](
+        std::span<const Entity> entities,
+        std::span<Body> bodies,
+        std::span<const OrbitControl> orbitControls)
+    {
+        for (auto i = 0u; i < bodies.size(); i++)
+        {
+            auto& body = bodies[i];
+            auto distance = std::max(glm::length(body.Position), 1.0f);
+            auto direction = body.Position / distance;
+
+            auto gravity = -direction * (GravitationalParameter / (distance * distance));
+            auto radialSpeed = glm::dot(body.Velocity, direction);
+            auto radiusError = orbitControls[i].TargetRadius - distance;
+            auto thrust = direction * (orbitControls[i].Gain * (radiusError * orbitControls[i].Gain - radialSpeed));
+
+            // Semi-implicit Euler, stable enough for orbits at server tick rates
+            body.Velocity += (gravity + thrust) * deltaTime;
+            body.Position += body.Velocity * deltaTime;
+            _colliderBounds[entities[i].Index] = GetShipBounds(body.Position);
+        }
+    });
+
+    _broadphase.UpdateProxies(_proxyIds, _colliderBounds, _taskScheduler);
+    ResolveCollisions();
+    _tickIndex++;
+}
+
+void ServerSimulation::ResolveCollisions()
+{
+    _broadphase.FindPairs(_collisionPairs, _taskScheduler);
+    while (_collisionPairs.HasOverflowed())
+    {
+        _collisionPairs.Resize(2 * _collisionPairs.GetCapacity());
+        _broadphase.FindPairs(_collisionPairs, _taskScheduler);
+    }
+
+    // Workers find pairs in any order, responding in sorted order keeps ticks deterministic
+    auto pairs = _collisionPairs.GetPairs();
+    _sortedCollisionPairs.resize(pairs.size());
+    std::transform(pairs.begin(), pairs.end(), _sortedCollisionPairs.begin(), [](const BroadphasePair& pair)
+    {
+        return BroadphasePair{ .UserDataA = std::min(pair.UserDataA, pair.UserDataB), .UserDataB = std::max(pair.UserDataA, pair.UserDataB) };
+    });
+    std::sort(_sortedCollisionPairs.begin(), _sortedCollisionPairs.end(), [](const BroadphasePair& lhs, const BroadphasePair& rhs)
+    {
+        return lhs.UserDataA != rhs.UserDataA ? lhs.UserDataA < rhs.UserDataA : lhs.UserDataB < rhs.UserDataB;
+    });
+
+    for (auto& pair : _sortedCollisionPairs)
+    {
+        auto bodyA = _world.GetComponent<Body>(_entities[pair.UserDataA]);
+        auto bodyB = _world.GetComponent<Body>(_entities[pair.UserDataB]);
+        auto offset = bodyB->Position - bodyA->Position;
+        auto distanceSquared = glm::dot(offset, offset);
+        if (distanceSquared >= 4.0f * ShipRadius * ShipRadius || distanceSquared == 0.0f)
+        {
+            continue;
+        }
+
+        // Ships of equal mass bounce elastically by swapping their velocities along the normal
+        auto normal = offset / std::sqrt(distanceSquared);
+        auto approachSpeed = glm::dot(bodyB->Velocity - bodyA->Velocity, normal);
+        if (approachSpeed >= 0.0f)
+        {
+            continue;
+        }
+
+        bodyA->Velocity += normal * approachSpeed;
+        bodyB->Velocity -= normal * approachSpeed;
+        _collisionCount++;
+    }
+}
+
+void ServerSimulation::GatherSnapshot(QuantizedSnapshot& snapshot)
+{
+    snapshot.clear();
+    snapshot.reserve(_world.GetEntityCount());
+    _bodies.ForEach([&snapshot](Entity entity, const Body& body, [[maybe_unused]] const OrbitControl& orbitControl)
+    {
+        snapshot.push_back(QuantizeEntityState(EntityState{ entity.Index, body.Position, body.Velocity }));
+    });
+
+    // Chunks hold entities in creation order, so this only sorts once entities were destroyed and reused
+    auto isOrderedById = [](const QuantizedEntityState& lhs, const QuantizedEntityState& rhs)
+    {
+        return lhs.Id < rhs.Id;
+    };
+    if (!std::is_sorted(snapshot.begin(), snapshot.end(), isOrderedById))
+    {
+        std::sort(snapshot.begin(), snapshot.end(), isOrderedById);
+    }
+}
+
+uint64_t ServerSimulation::ComputeChecksum()
+{
+    // Word wise multiply xorshift, much faster than byte wise FNV over a few MB of bodies per tick
+    auto checksum = uint64_t(0x9E3779B97F4A7C15);
+    _bodies.ForEachChunk([&checksum](
+        std::span<const Entity> entities,
+        std::span<const Body> bodies,
+        [[maybe_unused]] std::span<const OrbitControl> orbitControls)
+    {
+        for (auto i = 0u; i < bodies.size(); i++)
+        {
+            auto& body = bodies[i];
+            std::array<uint32_t, 6> words =
+            {
+                std::bit_cast<uint32_t>(body.Position.x), std::bit_cast<uint32_t>(body.Position.y), std::bit_cast<uint32_t>(body.Position.z),
+                std::bit_cast<uint32_t>(body.Velocity.x), std::bit_cast<uint32_t>(body.Velocity.y), std::bit_cast<uint32_t>(body.Velocity.z)
+            };
+
+            checksum = MixChecksum(checksum, entities[i].Index);
+            for (auto word = 0u; word < words.size(); word += 2)
+            {
+                checksum = MixChecksum(checksum, (static_cast<uint64_t>(words[word]) << 32) | words[word + 1]);
+            }
+        }
+    });
+    return checksum;
+}
@@ -0,0 +1,96 @@
+#include <GameServer/ServerTickInput.hpp>
+#include <EngineCore/TickRecording.hpp>
+
+#include <bit>
+
+void EncodeServerRecordingHeader(const ServerRecordingHeader& header, std::vector<std::byte>& bytes)
+{
+    AppendVarint(bytes, header.TickRate);
+    AppendVarint(bytes, header.Seed);
+    AppendVarint(bytes, header.EntityCount);
+}
+
+bool DecodeServerRecordingHeader(std::span<const std::byte> bytes, ServerRecordingHeader& header)
+{
+    auto offset = size_t(0);
+    auto tickRate = ReadVarint(bytes, offset);
+    auto seed = ReadVarint(bytes, offset);
+    auto entityCount = ReadVarint(bytes, offset);
+    if (!tickRate || !seed || !entityCount)
+    {
+        return false;
+    }
+
+    header.TickRate = static_cast<uint32_t>(*tickRate);
+    header.Seed = static_cast<uint32_t>(*seed);
+    header.EntityCount = static_cast<uint32_t>(*entityCount);
+    return true;
+}
+
+void ServerTickInputCodec::Encode(const ServerTickInput& input, std::vector<std::byte>& bytes)
+{
+    auto deltaTimeBits = std::bit_cast<uint32_t>(input.DeltaTime);
+    AppendSignedVarint(bytes, static_cast<int64_t>(deltaTimeBits) - static_cast<int64_t>(_previousDeltaTimeBits));
+    _previousDeltaTimeBits = deltaTimeBits;
+
+    AppendVarint(bytes, input.FocusChanges.size());
+    for (auto& focusChange : input.FocusChanges)
+    {
+        auto quantized = QuantizeEntityState(EntityState{ .Id = 0, .Position = focusChange.Focus.Position, .Velocity = glm::vec3(0.0f) });
+        auto& previousPosition = _previousFocusPositions[focusChange.ClientId];
+        AppendVarint(bytes, focusChange.ClientId);
+        AppendVarint(bytes, static_cast<uint64_t>(focusChange.Focus.EntityId) + 1);
+        for (auto axis = 0u; axis < 3; axis++)
+        {
+            AppendSignedVarint(bytes, static_cast<int64_t>(quantized.Values[axis]) - static_cast<int64_t>(previousPosition[axis]));
+            previousPosition[axis] = quantized.Values[axis];
+        }
+    }
+}
+
+bool ServerTickInputCodec::Decode(std::span<const std::byte> bytes, ServerTickInput& input)
+{
+    input.FocusChanges.clear();
+
+    auto offset = size_t(0);
+    auto deltaTimeBitsDelta = ReadSignedVarint(bytes, offset);
+    auto focusChangeCount = ReadVarint(bytes, offset);
+    if (!deltaTimeBitsDelta || !focusChangeCount || *focusChangeCount > bytes.size())
+    {
+        return false;
+    }
+
+    _previousDeltaTimeBits = static_cast<uint32_t>(_previousDeltaTimeBits + *deltaTimeBitsDelta);
+    input.DeltaTime = std::bit_cast<float>(_previousDeltaTimeBits);
+
+    for (auto i = 0u; i < *focusChangeCount; i++)
+    {
+        auto clientId = ReadVarint(bytes, offset);
+        auto entityId = ReadVarint(bytes, offset);
+        if (!clientId || !entityId)
+        {
+            return false;
+        }
+
+        auto& previousPosition = _previousFocusPositions[static_cast<uint32_t>(*clientId)];
+        QuantizedEntityState quantized = { .Id = 0, .Values = {} };
+        for (auto axis = 0u; axis < 3; axis++)
+        {
+            auto positionDelta = ReadSignedVarint(bytes, offset);
+            if (!positionDelta)
+            {
+                return false;
+            }
+            previousPosition[axis] = static_cast<uint32_t>(previousPosition[axis] + *positionDelta);
+            quantized.Values[axis] = previousPosition[axis];
+        }
+
+        input.FocusChanges.push_back(NetClientFocusChange
+        {
+            .ClientId = static_cast<uint32_t>(*clientId),
+            .Focus = NetClientFocus{ .Position = DequantizeEntityState(quantized).Position, .EntityId = static_cast<uint32_t>(*entityId - 1) }
+        });
+    }
+
+    return offset == bytes.size();
+}